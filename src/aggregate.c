@@ -32,30 +32,30 @@ getAggregates(PGconn *c, int *n)
 	PGresult		*res;
 	int				i;
 
-	logNoise("aggregate: server version: %d", PQserverVersion(c));
+	logNoise("aggregate: server version: %d", getServerVersion(c));
 
-	if (PQserverVersion(c) >= 110000)
+	if (getServerVersion(c) >= 110000)
 	{
-		query = psprintf("SELECT p.oid, n.nspname, p.proname, pg_get_function_arguments(p.oid) AS aggargs, aggtransfn, aggtranstype::regtype, aggtransspace, aggfinalfn, aggfinalextra, aggfinalmodify, agginitval, aggmtransfn, aggminvtransfn, aggmtranstype::regtype, aggmtransspace, aggmfinalfn, aggmfinalextra, aggmfinalmodify, aggminitval, aggsortop::regoperator, proparallel, (aggkind = 'h') AS hypothetical, obj_description(p.oid, 'pg_proc') AS description, pg_get_userbyid(p.proowner) AS aggowner FROM pg_proc p INNER JOIN pg_namespace n ON (n.oid = p.pronamespace) INNER JOIN pg_aggregate a ON (aggfnoid = p.oid) WHERE n.nspname !~ '^pg_' AND n.nspname <> 'information_schema' %s%s AND NOT EXISTS(SELECT 1 FROM pg_depend d WHERE p.oid = d.objid AND d.deptype = 'e') ORDER BY n.nspname, p.proname, pg_get_function_arguments(p.oid)", include_schema_str, exclude_schema_str);
+		query = psprintf("SELECT p.oid, n.nspname, p.proname, pg_get_function_arguments(p.oid) AS aggargs, aggtransfn, aggtranstype::regtype, aggtransspace, aggfinalfn, aggfinalextra, aggfinalmodify, agginitval, aggmtransfn, aggminvtransfn, aggmtranstype::regtype, aggmtransspace, aggmfinalfn, aggmfinalextra, aggmfinalmodify, aggminitval, aggsortop::regoperator, proparallel, (aggkind = 'h') AS hypothetical, pg_get_userbyid(p.proowner) AS aggowner FROM pg_proc p INNER JOIN pg_namespace n ON (n.oid = p.pronamespace) INNER JOIN pg_aggregate a ON (aggfnoid = p.oid) WHERE n.nspname !~ '^pg_' AND n.nspname <> 'information_schema' %s%s AND NOT EXISTS(SELECT 1 FROM pg_depend d WHERE p.oid = d.objid AND d.deptype = 'e') ORDER BY n.nspname, p.proname, pg_get_function_arguments(p.oid)", include_schema_str, exclude_schema_str);
 	}
-	else if (PQserverVersion(c) >= 90600)	/* parallel is new in 9.6 */
+	else if (getServerVersion(c) >= 90600)	/* parallel is new in 9.6 */
 	{
-		query = psprintf("SELECT p.oid, n.nspname, p.proname, pg_get_function_arguments(p.oid) AS aggargs, aggtransfn, aggtranstype::regtype, aggtransspace, aggfinalfn, aggfinalextra, 'n' AS aggfinalmodify, agginitval, aggmtransfn, aggminvtransfn, aggmtranstype::regtype, aggmtransspace, aggmfinalfn, aggmfinalextra, 'n' AS aggmfinalmodify, aggminitval, aggsortop::regoperator, proparallel, (aggkind = 'h') AS hypothetical, obj_description(p.oid, 'pg_proc') AS description, pg_get_userbyid(p.proowner) AS aggowner FROM pg_proc p INNER JOIN pg_namespace n ON (n.oid = p.pronamespace) INNER JOIN pg_aggregate a ON (aggfnoid = p.oid) WHERE n.nspname !~ '^pg_' AND n.nspname <> 'information_schema' %s%s AND NOT EXISTS(SELECT 1 FROM pg_depend d WHERE p.oid = d.objid AND d.deptype = 'e') ORDER BY n.nspname, p.proname, pg_get_function_arguments(p.oid)", include_schema_str, exclude_schema_str);
+		query = psprintf("SELECT p.oid, n.nspname, p.proname, pg_get_function_arguments(p.oid) AS aggargs, aggtransfn, aggtranstype::regtype, aggtransspace, aggfinalfn, aggfinalextra, 'n' AS aggfinalmodify, agginitval, aggmtransfn, aggminvtransfn, aggmtranstype::regtype, aggmtransspace, aggmfinalfn, aggmfinalextra, 'n' AS aggmfinalmodify, aggminitval, aggsortop::regoperator, proparallel, (aggkind = 'h') AS hypothetical, pg_get_userbyid(p.proowner) AS aggowner FROM pg_proc p INNER JOIN pg_namespace n ON (n.oid = p.pronamespace) INNER JOIN pg_aggregate a ON (aggfnoid = p.oid) WHERE n.nspname !~ '^pg_' AND n.nspname <> 'information_schema' %s%s AND NOT EXISTS(SELECT 1 FROM pg_depend d WHERE p.oid = d.objid AND d.deptype = 'e') ORDER BY n.nspname, p.proname, pg_get_function_arguments(p.oid)", include_schema_str, exclude_schema_str);
 	}
-	else if (PQserverVersion(c) >= 90400)
+	else if (getServerVersion(c) >= 90400)
 	{
-		query = psprintf("SELECT p.oid, n.nspname, p.proname, pg_get_function_arguments(p.oid) AS aggargs, aggtransfn, aggtranstype::regtype, aggtransspace, aggfinalfn, aggfinalextra, 'n' AS aggfinalmodify, agginitval, aggmtransfn, aggminvtransfn, aggmtranstype::regtype, aggmtransspace, aggmfinalfn, aggmfinalextra, 'n' AS aggmfinalmodify, aggminitval, aggsortop::regoperator, 'n' AS proparallel, (aggkind = 'h') AS hypothetical, obj_description(p.oid, 'pg_proc') AS description, pg_get_userbyid(p.proowner) AS aggowner FROM pg_proc p INNER JOIN pg_namespace n ON (n.oid = p.pronamespace) INNER JOIN pg_aggregate a ON (aggfnoid = p.oid) WHERE n.nspname !~ '^pg_' AND n.nspname <> 'information_schema' %s%s AND NOT EXISTS(SELECT 1 FROM pg_depend d WHERE p.oid = d.objid AND d.deptype = 'e') ORDER BY n.nspname, p.proname, pg_get_function_arguments(p.oid)", include_schema_str, exclude_schema_str);
+		query = psprintf("SELECT p.oid, n.nspname, p.proname, pg_get_function_arguments(p.oid) AS aggargs, aggtransfn, aggtranstype::regtype, aggtransspace, aggfinalfn, aggfinalextra, 'n' AS aggfinalmodify, agginitval, aggmtransfn, aggminvtransfn, aggmtranstype::regtype, aggmtransspace, aggmfinalfn, aggmfinalextra, 'n' AS aggmfinalmodify, aggminitval, aggsortop::regoperator, 'n' AS proparallel, (aggkind = 'h') AS hypothetical, pg_get_userbyid(p.proowner) AS aggowner FROM pg_proc p INNER JOIN pg_namespace n ON (n.oid = p.pronamespace) INNER JOIN pg_aggregate a ON (aggfnoid = p.oid) WHERE n.nspname !~ '^pg_' AND n.nspname <> 'information_schema' %s%s AND NOT EXISTS(SELECT 1 FROM pg_depend d WHERE p.oid = d.objid AND d.deptype = 'e') ORDER BY n.nspname, p.proname, pg_get_function_arguments(p.oid)", include_schema_str, exclude_schema_str);
 	}
-	else if (PQserverVersion(c) >= 90100)	/* extension support */
+	else if (getServerVersion(c) >= 90100)	/* extension support */
 	{
-		query = psprintf("SELECT p.oid, n.nspname, p.proname, pg_get_function_arguments(p.oid) AS aggargs, aggtransfn, aggtranstype::regtype, NULL AS aggtransspace, aggfinalfn, false AS aggfinalextra, 'n' AS aggfinalmodify, agginitval, NULL AS aggmtransfn, NULL AS aggminvtransfn, NULL AS aggmtranstype, NULL AS aggmtransspace, NULL AS aggmfinalfn, false AS aggmfinalextra, 'n' AS aggmfinalmodify, NULL AS aggminitval, aggsortop::regoperator, 'n' AS proparallel, false AS hypothetical, obj_description(p.oid, 'pg_proc') AS description, pg_get_userbyid(p.proowner) AS aggowner FROM pg_proc p INNER JOIN pg_namespace n ON (n.oid = p.pronamespace) INNER JOIN pg_aggregate a ON (aggfnoid = p.oid) WHERE n.nspname !~ '^pg_' AND n.nspname <> 'information_schema' %s%s AND NOT EXISTS(SELECT 1 FROM pg_depend d WHERE p.oid = d.objid AND d.deptype = 'e') ORDER BY n.nspname, p.proname, pg_get_function_arguments(p.oid)", include_schema_str, exclude_schema_str);
+		query = psprintf("SELECT p.oid, n.nspname, p.proname, pg_get_function_arguments(p.oid) AS aggargs, aggtransfn, aggtranstype::regtype, NULL AS aggtransspace, aggfinalfn, false AS aggfinalextra, 'n' AS aggfinalmodify, agginitval, NULL AS aggmtransfn, NULL AS aggminvtransfn, NULL AS aggmtranstype, NULL AS aggmtransspace, NULL AS aggmfinalfn, false AS aggmfinalextra, 'n' AS aggmfinalmodify, NULL AS aggminitval, aggsortop::regoperator, 'n' AS proparallel, false AS hypothetical, pg_get_userbyid(p.proowner) AS aggowner FROM pg_proc p INNER JOIN pg_namespace n ON (n.oid = p.pronamespace) INNER JOIN pg_aggregate a ON (aggfnoid = p.oid) WHERE n.nspname !~ '^pg_' AND n.nspname <> 'information_schema' %s%s AND NOT EXISTS(SELECT 1 FROM pg_depend d WHERE p.oid = d.objid AND d.deptype = 'e') ORDER BY n.nspname, p.proname, pg_get_function_arguments(p.oid)", include_schema_str, exclude_schema_str);
 	}
 	else
 	{
-		query = psprintf("SELECT p.oid, n.nspname, p.proname, pg_get_function_arguments(p.oid) AS aggargs, aggtransfn, aggtranstype::regtype, NULL AS aggtransspace, aggfinalfn, false AS aggfinalextra, 'n' AS aggfinalmodify, agginitval, NULL AS aggmtransfn, NULL AS aggminvtransfn, NULL AS aggmtranstype, NULL AS aggmtransspace, NULL AS aggmfinalfn, false AS aggmfinalextra, 'n' AS aggmfinalmodify, NULL AS aggminitval, aggsortop::regoperator, 'n' AS proparallel, false AS hypothetical, obj_description(p.oid, 'pg_proc') AS description, pg_get_userbyid(p.proowner) AS aggowner FROM pg_proc p INNER JOIN pg_namespace n ON (n.oid = p.pronamespace) INNER JOIN pg_aggregate a ON (aggfnoid = p.oid) WHERE n.nspname !~ '^pg_' AND n.nspname <> 'information_schema' %s%s ORDER BY n.nspname, p.proname, pg_get_function_arguments(p.oid)", include_schema_str, exclude_schema_str);
+		query = psprintf("SELECT p.oid, n.nspname, p.proname, pg_get_function_arguments(p.oid) AS aggargs, aggtransfn, aggtranstype::regtype, NULL AS aggtransspace, aggfinalfn, false AS aggfinalextra, 'n' AS aggfinalmodify, agginitval, NULL AS aggmtransfn, NULL AS aggminvtransfn, NULL AS aggmtranstype, NULL AS aggmtransspace, NULL AS aggmfinalfn, false AS aggmfinalextra, 'n' AS aggmfinalmodify, NULL AS aggminitval, aggsortop::regoperator, 'n' AS proparallel, false AS hypothetical, pg_get_userbyid(p.proowner) AS aggowner FROM pg_proc p INNER JOIN pg_namespace n ON (n.oid = p.pronamespace) INNER JOIN pg_aggregate a ON (aggfnoid = p.oid) WHERE n.nspname !~ '^pg_' AND n.nspname <> 'information_schema' %s%s ORDER BY n.nspname, p.proname, pg_get_function_arguments(p.oid)", include_schema_str, exclude_schema_str);
 	}
 
-	res = PQexec(c, query);
+	res = execQuery(c, query);
 
 	pfree(query);
 
@@ -70,7 +70,7 @@ getAggregates(PGconn *c, int *n)
 
 	*n = PQntuples(res);
 	if (*n > 0)
-		a = (PQLAggregate *) malloc(*n * sizeof(PQLAggregate));
+		a = (PQLAggregate *) arenaAlloc(*n * sizeof(PQLAggregate));
 	else
 		a = NULL;
 
@@ -78,24 +78,22 @@ getAggregates(PGconn *c, int *n)
 
 	for (i = 0; i < *n; i++)
 	{
-		char	*withoutescape;
-
 		a[i].obj.oid = strtoul(PQgetvalue(res, i, PQfnumber(res, "oid")), NULL, 10);
-		a[i].obj.schemaname = strdup(PQgetvalue(res, i, PQfnumber(res, "nspname")));
-		a[i].obj.objectname = strdup(PQgetvalue(res, i, PQfnumber(res, "proname")));
-		a[i].arguments = strdup(PQgetvalue(res, i, PQfnumber(res, "aggargs")));
-		a[i].sfunc  = strdup(PQgetvalue(res, i, PQfnumber(res, "aggtransfn")));
-		a[i].stype  = strdup(PQgetvalue(res, i, PQfnumber(res, "aggtranstype")));
+		a[i].obj.schemaname = internName(PQgetvalue(res, i, PQfnumber(res, "nspname")));
+		a[i].obj.objectname = internName(PQgetvalue(res, i, PQfnumber(res, "proname")));
+		a[i].arguments = arenaStrdup(PQgetvalue(res, i, PQfnumber(res, "aggargs")));
+		a[i].sfunc  = arenaStrdup(PQgetvalue(res, i, PQfnumber(res, "aggtransfn")));
+		a[i].stype  = arenaStrdup(PQgetvalue(res, i, PQfnumber(res, "aggtranstype")));
 
 		if (PQgetisnull(res, i, PQfnumber(res, "aggtransspace")))
 			a[i].sspace = NULL;
 		else
-			a[i].sspace  = strdup(PQgetvalue(res, i, PQfnumber(res, "aggtransspace")));
+			a[i].sspace  = arenaStrdup(PQgetvalue(res, i, PQfnumber(res, "aggtransspace")));
 
 		if (PQgetisnull(res, i, PQfnumber(res, "aggfinalfn")))
 			a[i].finalfunc = NULL;
 		else
-			a[i].finalfunc  = strdup(PQgetvalue(res, i, PQfnumber(res, "aggfinalfn")));
+			a[i].finalfunc  = arenaStrdup(PQgetvalue(res, i, PQfnumber(res, "aggfinalfn")));
 
 		a[i].finalfuncextra = (PQgetvalue(res, i, PQfnumber(res,
 										  "aggfinalextra"))[0] == 't');
@@ -105,32 +103,32 @@ getAggregates(PGconn *c, int *n)
 		if (PQgetisnull(res, i, PQfnumber(res, "agginitval")))
 			a[i].initcond = NULL;
 		else
-			a[i].initcond  = strdup(PQgetvalue(res, i, PQfnumber(res, "agginitval")));
+			a[i].initcond  = arenaStrdup(PQgetvalue(res, i, PQfnumber(res, "agginitval")));
 
 		if (PQgetisnull(res, i, PQfnumber(res, "aggmtransfn")))
 			a[i].msfunc = NULL;
 		else
-			a[i].msfunc  = strdup(PQgetvalue(res, i, PQfnumber(res, "aggmtransfn")));
+			a[i].msfunc  = arenaStrdup(PQgetvalue(res, i, PQfnumber(res, "aggmtransfn")));
 
 		if (PQgetisnull(res, i, PQfnumber(res, "aggminvtransfn")))
 			a[i].minvfunc = NULL;
 		else
-			a[i].minvfunc  = strdup(PQgetvalue(res, i, PQfnumber(res, "aggminvtransfn")));
+			a[i].minvfunc  = arenaStrdup(PQgetvalue(res, i, PQfnumber(res, "aggminvtransfn")));
 
 		if (PQgetisnull(res, i, PQfnumber(res, "aggmtranstype")))
 			a[i].mstype = NULL;
 		else
-			a[i].mstype  = strdup(PQgetvalue(res, i, PQfnumber(res, "aggmtranstype")));
+			a[i].mstype  = arenaStrdup(PQgetvalue(res, i, PQfnumber(res, "aggmtranstype")));
 
 		if (PQgetisnull(res, i, PQfnumber(res, "aggmtransspace")))
 			a[i].msspace = NULL;
 		else
-			a[i].msspace  = strdup(PQgetvalue(res, i, PQfnumber(res, "aggmtransspace")));
+			a[i].msspace  = arenaStrdup(PQgetvalue(res, i, PQfnumber(res, "aggmtransspace")));
 
 		if (PQgetisnull(res, i, PQfnumber(res, "aggmfinalfn")))
 			a[i].mfinalfunc = NULL;
 		else
-			a[i].mfinalfunc  = strdup(PQgetvalue(res, i, PQfnumber(res, "aggmfinalfn")));
+			a[i].mfinalfunc  = arenaStrdup(PQgetvalue(res, i, PQfnumber(res, "aggmfinalfn")));
 
 		a[i].mfinalfuncextra = (PQgetvalue(res, i, PQfnumber(res,
 										   "aggmfinalextra"))[0] == 't');
@@ -141,39 +139,25 @@ getAggregates(PGconn *c, int *n)
 		if (PQgetisnull(res, i, PQfnumber(res, "aggminitval")))
 			a[i].minitcond = NULL;
 		else
-			a[i].minitcond  = strdup(PQgetvalue(res, i, PQfnumber(res, "aggminitval")));
+			a[i].minitcond  = arenaStrdup(PQgetvalue(res, i, PQfnumber(res, "aggminitval")));
 
 		if (PQgetisnull(res, i, PQfnumber(res, "aggsortop")))
 			a[i].sortop = NULL;
 		else
-			a[i].sortop  = strdup(PQgetvalue(res, i, PQfnumber(res, "aggsortop")));
+			a[i].sortop  = arenaStrdup(PQgetvalue(res, i, PQfnumber(res, "aggsortop")));
 
 		a[i].parallel = PQgetvalue(res, i, PQfnumber(res, "proparallel"))[0];
 		a[i].hypothetical = (PQgetvalue(res, i, PQfnumber(res,
 										"hypothetical"))[0] == 't');
 
-		if (PQgetisnull(res, i, PQfnumber(res, "description")))
-			a[i].comment = NULL;
-		else
-		{
-			withoutescape = PQgetvalue(res, i, PQfnumber(res, "description"));
-			a[i].comment = PQescapeLiteral(c, withoutescape, strlen(withoutescape));
-			if (a[i].comment == NULL)
-			{
-				logError("escaping comment failed: %s", PQerrorMessage(c));
-				PQclear(res);
-				PQfinish(c);
-				/* XXX leak another connection? */
-				exit(EXIT_FAILURE);
-			}
-		}
+		a[i].comment = getComment(PGQ_CLASS_PROC, a[i].obj.oid, 0);
 
-		a[i].owner = strdup(PQgetvalue(res, i, PQfnumber(res, "aggowner")));
+		a[i].owner = internName(PQgetvalue(res, i, PQfnumber(res, "aggowner")));
 
 		/*
 		 * Security labels are not assigned here (see getAggregateSecurityLabels),
 		 * but default values are essential to avoid having trouble in
-		 * freeAggregates.
+		 * the dump routines.
 		 */
 		a[i].nseclabels = 0;
 		a[i].seclabels = NULL;
@@ -211,139 +195,46 @@ compareAggregates(PQLAggregate *a, PQLAggregate *b)
 }
 
 void
-getAggregateSecurityLabels(PGconn *c, PQLAggregate *a)
+getAggregateSecurityLabels(PGconn *c, PQLAggregate *a, int n)
 {
-	char		*query;
-	PGresult	*res;
 	int			i;
 
-	if (PQserverVersion(c) < 90100)
-	{
-		logWarning("ignoring security labels because server does not support it");
+	if (n == 0)
 		return;
-	}
 
-	query = psprintf("SELECT provider, label FROM pg_seclabel s INNER JOIN pg_class c ON (s.classoid = c.oid) WHERE c.relname = 'pg_aggregate' AND s.objoid = %u ORDER BY provider",
-			 a->obj.oid);
-
-	res = PQexec(c, query);
-
-	pfree(query);
-
-	if (PQresultStatus(res) != PGRES_TUPLES_OK)
+	if (getServerVersion(c) < 90100)
 	{
-		logError("query failed: %s", PQresultErrorMessage(res));
-		PQclear(res);
-		PQfinish(c);
-		/* XXX leak another connection? */
-		exit(EXIT_FAILURE);
-	}
-
-	a->nseclabels = PQntuples(res);
-	if (a->nseclabels > 0)
-		a->seclabels = (PQLSecLabel *) malloc(a->nseclabels * sizeof(PQLSecLabel));
-	else
-		a->seclabels = NULL;
-
-	logDebug("number of security labels in aggregate \"%s\".\"%s\"(%s): %d",
-			 a->obj.schemaname, a->obj.objectname, a->arguments, a->nseclabels);
-
-	for (i = 0; i < a->nseclabels; i++)
-	{
-		char	*withoutescape;
-
-		a->seclabels[i].provider = strdup(PQgetvalue(res, i, PQfnumber(res,
-										  "provider")));
-		withoutescape = PQgetvalue(res, i, PQfnumber(res, "label"));
-		a->seclabels[i].label = PQescapeLiteral(c, withoutescape,
-												strlen(withoutescape));
-		if (a->seclabels[i].label == NULL)
-		{
-			logError("escaping label failed: %s", PQerrorMessage(c));
-			PQclear(res);
-			PQfinish(c);
-			/* XXX leak another connection? */
-			exit(EXIT_FAILURE);
-		}
+		logWarning("ignoring security labels because server does not support it");
+		return;
 	}
 
-	PQclear(res);
-}
-
-void
-freeAggregates(PQLAggregate *a, int n)
-{
-	if (n > 0)
+	for (i = 0; i < n; i++)
 	{
-		int	i;
+		a[i].nseclabels = getObjectSecurityLabels(c, PGQ_CLASS_PROC,
+							  a[i].obj.oid, 0, &a[i].seclabels);
 
-		for (i = 0; i < n; i++)
-		{
-			int	j;
-
-			free(a[i].obj.schemaname);
-			free(a[i].obj.objectname);
-			free(a[i].arguments);
-			free(a[i].sfunc);
-			free(a[i].stype);
-			if (a[i].sspace)
-				free(a[i].sspace);
-			if (a[i].finalfunc)
-				free(a[i].finalfunc);
-			if (a[i].initcond)
-				free(a[i].initcond);
-			if (a[i].msfunc)
-				free(a[i].msfunc);
-			if (a[i].minvfunc)
-				free(a[i].minvfunc);
-			if (a[i].mstype)
-				free(a[i].mstype);
-			if (a[i].msspace)
-				free(a[i].msspace);
-			if (a[i].mfinalfunc)
-				free(a[i].mfinalfunc);
-			if (a[i].minitcond)
-				free(a[i].minitcond);
-			if (a[i].sortop)
-				free(a[i].sortop);
-			if (a[i].comment)
-				PQfreemem(a[i].comment);
-			free(a[i].owner);
-
-			/* security labels */
-			for (j = 0; j < a[i].nseclabels; j++)
-			{
-				free(a[i].seclabels[j].provider);
-				PQfreemem(a[i].seclabels[j].label);
-			}
-
-			if (a[i].seclabels)
-				free(a[i].seclabels);
-		}
-
-		free(a);
+		logDebug("number of security labels in aggregate \"%s\".\"%s\"(%s): %d",
+				 a[i].obj.schemaname, a[i].obj.objectname, a[i].arguments,
+				 a[i].nseclabels);
 	}
 }
 
 void
 dumpDropAggregate(FILE *output, PQLAggregate *a)
 {
-	char	*schema = formatObjectIdentifier(a->obj.schemaname);
-	char	*aggname = formatObjectIdentifier(a->obj.objectname);
+	char	*schema = quotedName(a->obj.schemaname);
+	char	*aggname = quotedName(a->obj.objectname);
 
 	fprintf(output, "\n\n");
 	fprintf(output, "DROP AGGREGATE %s.%s(%s);",
 			schema, aggname, a->arguments);
-
-	free(schema);
-	free(aggname);
 }
 
 void
 dumpCreateAggregate(FILE *output, PQLAggregate *a)
 {
-	char	*schema = formatObjectIdentifier(a->obj.schemaname);
-	char	*aggname = formatObjectIdentifier(a->obj.objectname);
+	char	*schema = quotedName(a->obj.schemaname);
+	char	*aggname = quotedName(a->obj.objectname);
 
 	fprintf(output, "\n\n");
 	fprintf(output, "CREATE AGGREGATE %s.%s(%s) (",
@@ -409,18 +300,15 @@ dumpCreateAggregate(FILE *output, PQLAggregate *a)
 		;
 
 	fprintf(output, ");");
-
-	free(schema);
-	free(aggname);
 }
 
 void
 dumpAlterAggregate(FILE *output, PQLAggregate *a, PQLAggregate *b)
 {
-	char	*schema1 = formatObjectIdentifier(a->obj.schemaname);
-	char	*aggname1 = formatObjectIdentifier(a->obj.objectname);
-	char	*schema2 = formatObjectIdentifier(b->obj.schemaname);
-	char	*aggname2 = formatObjectIdentifier(b->obj.objectname);
+	char	*schema1 = quotedName(a->obj.schemaname);
+	char	*aggname1 = quotedName(a->obj.objectname);
+	char	*schema2 = quotedName(b->obj.schemaname);
+	char	*aggname2 = quotedName(b->obj.objectname);
 
 	/* comment */
 	if (options.comment)
@@ -430,8 +318,10 @@ dumpAlterAggregate(FILE *output, PQLAggregate *a, PQLAggregate *b)
 				 strcmp(a->comment, b->comment) != 0))
 		{
 			fprintf(output, "\n\n");
-			fprintf(output, "COMMENT ON AGGREGATE %s.%s(%s) IS %s;",
-					schema2, aggname2, b->arguments, b->comment);
+			fprintf(output, "COMMENT ON AGGREGATE %s.%s(%s) IS ",
+					schema2, aggname2, b->arguments);
+			printComment(output, b->comment);
+			fprintf(output, ";");
 		}
 		else if (a->comment != NULL && b->comment == NULL)
 		{
@@ -546,7 +436,7 @@ dumpAlterAggregate(FILE *output, PQLAggregate *a, PQLAggregate *b)
 	{
 		if (strcmp(a->owner, b->owner) != 0)
 		{
-			char	*owner = formatObjectIdentifier(b->owner);
+			char	*owner = quotedName(b->owner);
 
 			fprintf(output, "\n\n");
 			fprintf(output, "ALTER AGGREGATE %s.%s(%s) OWNER TO %s;",
@@ -554,13 +444,6 @@ dumpAlterAggregate(FILE *output, PQLAggregate *a, PQLAggregate *b)
 					aggname2,
 					b->arguments,
 					owner);
-
-			free(owner);
 		}
 	}
-
-	free(schema1);
-	free(aggname1);
-	free(schema2);
-	free(aggname2);
 }
@@ -9,7 +9,9 @@
 #ifndef AGGREGATE_H
 #define	AGGREGATE_H
 
+#include "comment.h"
 #include "common.h"
+#include "seclabel.h"
 
 typedef struct PQLAggregate
 {
@@ -44,12 +46,11 @@ typedef struct PQLAggregate
 
 PQLAggregate *getAggregates(PGconn *c, int *n);
 int compareAggregates(PQLAggregate *a, PQLAggregate *b);
-void getAggregateSecurityLabels(PGconn *c, PQLAggregate *a);
+void getAggregateSecurityLabels(PGconn *c, PQLAggregate *a, int n);
 
 void dumpDropAggregate(FILE *output, PQLAggregate *a);
 void dumpCreateAggregate(FILE *output, PQLAggregate *a);
 void dumpAlterAggregate(FILE *output, PQLAggregate *a, PQLAggregate *b);
 
-void freeAggregates(PQLAggregate *a, int n);
 
 #endif	/* AGGREGATE_H */
@@ -24,17 +24,17 @@ getAccessMethods(PGconn *c, int *n)
 	PGresult			*res;
 	int					i;
 
-	logNoise("am: server version: %d", PQserverVersion(c));
+	logNoise("am: server version: %d", getServerVersion(c));
 
 	/* bail out if we do not support it */
-	if (PQserverVersion(c) < 90600)
+	if (getServerVersion(c) < 90600)
 	{
 		logWarning("ignoring access method because server does not support it");
 		return NULL;
 	}
 
-	res = PQexec(c,
-				 "SELECT a.oid, a.amname, a.amtype, a.amhandler AS handleroid, n.nspname AS handlernspname, p.proname AS handlername, obj_description(a.oid, 'pg_am') AS description FROM pg_am a INNER JOIN pg_proc p ON (a.amhandler = p.oid) INNER JOIN pg_namespace n ON (p.pronamespace = n.oid) ORDER BY a.amname");
+	res = execQuery(c,
+				 "SELECT a.oid, a.amname, a.amtype, a.amhandler AS handleroid, n.nspname AS handlernspname, p.proname AS handlername FROM pg_am a INNER JOIN pg_proc p ON (a.amhandler = p.oid) INNER JOIN pg_namespace n ON (p.pronamespace = n.oid) ORDER BY a.amname");
 
 	if (PQresultStatus(res) != PGRES_TUPLES_OK)
 	{
@@ -47,7 +47,7 @@ getAccessMethods(PGconn *c, int *n)
 
 	*n = PQntuples(res);
 	if (*n > 0)
-		a = (PQLAccessMethod *) malloc(*n * sizeof(PQLAccessMethod));
+		a = (PQLAccessMethod *) arenaAlloc(*n * sizeof(PQLAccessMethod));
 	else
 		a = NULL;
 
@@ -55,33 +55,17 @@ getAccessMethods(PGconn *c, int *n)
 
 	for (i = 0; i < *n; i++)
 	{
-		char	*withoutescape;
-
 		a[i].oid = strtoul(PQgetvalue(res, i, PQfnumber(res, "oid")), NULL, 10);
-		a[i].amname = strdup(PQgetvalue(res, i, PQfnumber(res, "amname")));
+		a[i].amname = arenaStrdup(PQgetvalue(res, i, PQfnumber(res, "amname")));
 		a[i].amtype = PQgetvalue(res, i, PQfnumber(res, "amtype"))[0];
 		a[i].handler.oid = strtoul(PQgetvalue(res, i, PQfnumber(res, "handleroid")),
 								   NULL, 10);
-		a[i].handler.schemaname = strdup(PQgetvalue(res, i, PQfnumber(res,
+		a[i].handler.schemaname = internName(PQgetvalue(res, i, PQfnumber(res,
 										 "handlernspname")));
-		a[i].handler.objectname = strdup(PQgetvalue(res, i, PQfnumber(res,
+		a[i].handler.objectname = internName(PQgetvalue(res, i, PQfnumber(res,
 										 "handlername")));
 
-		if (PQgetisnull(res, i, PQfnumber(res, "description")))
-			a[i].comment = NULL;
-		else
-		{
-			withoutescape = PQgetvalue(res, i, PQfnumber(res, "description"));
-			a[i].comment = PQescapeLiteral(c, withoutescape, strlen(withoutescape));
-			if (a[i].comment == NULL)
-			{
-				logError("escaping comment failed: %s", PQerrorMessage(c));
-				PQclear(res);
-				PQfinish(c);
-				/* XXX leak another connection? */
-				exit(EXIT_FAILURE);
-			}
-		}
+		a[i].comment = getComment(PGQ_CLASS_AM, a[i].oid, 0);
 
 		logDebug("access method \"%s\"", a[i].amname);
 	}
@@ -91,28 +75,6 @@ getAccessMethods(PGconn *c, int *n)
 	return a;
 }
 
-void
-freeAccessMethods(PQLAccessMethod *a, int n)
-{
-	if (n > 0)
-	{
-		int	i;
-
-		for (i = 0; i < n; i++)
-		{
-			free(a[i].amname);
-			if (a[i].handler.schemaname)
-				free(a[i].handler.schemaname);
-			if (a[i].handler.objectname)
-				free(a[i].handler.objectname);
-			if (a[i].comment)
-				PQfreemem(a[i].comment);
-		}
-
-		free(a);
-	}
-}
-
 void
 dumpDropAccessMethod(FILE *output, PQLAccessMethod *a)
 {
@@ -151,8 +113,9 @@ dumpCreateAccessMethod(FILE *output, PQLAccessMethod *a)
 	if (options.comment && a->comment != NULL)
 	{
 		fprintf(output, "\n\n");
-		fprintf(output, "COMMENT ON ACCESS METHOD %s IS %s;", amname,
-				a->comment);
+		fprintf(output, "COMMENT ON ACCESS METHOD %s IS ", amname);
+		printComment(output, a->comment);
+		fprintf(output, ";");
 	}
 
 	free(amname);
@@ -182,9 +145,10 @@ dumpAlterAccessMethod(FILE *output, PQLAccessMethod *a, PQLAccessMethod *b)
 				 strcmp(a->comment, b->comment) != 0))
 		{
 			fprintf(output, "\n\n");
-			fprintf(output, "COMMENT ON ACCESS METHOD %s IS %s;",
-					b->amname,
-					b->comment);
+			fprintf(output, "COMMENT ON ACCESS METHOD %s IS ",
+					b->amname);
+			printComment(output, b->comment);
+			fprintf(output, ";");
 		}
 		else if (a->comment != NULL && b->comment == NULL)
 		{
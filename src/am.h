@@ -9,6 +9,7 @@
 #ifndef ACCESSMETHOD_H
 #define ACCESSMETHOD_H
 
+#include "comment.h"
 #include "common.h"
 
 enum PQLAccessMethodType
@@ -34,7 +35,6 @@ void dumpCreateAccessMethod(FILE *output, PQLAccessMethod *a);
 void dumpAlterAccessMethod(FILE *output, PQLAccessMethod *a,
 						   PQLAccessMethod *b);
 
-void freeAccessMethods(PQLAccessMethod *a, int n);
 
 #endif	/* ACCESSMETHOD_H */
 
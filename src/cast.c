@@ -41,20 +41,20 @@ getCasts(PGconn *c, int *n)
 	PGresult	*res;
 	int			i;
 
-	logNoise("cast: server version: %d", PQserverVersion(c));
+	logNoise("cast: server version: %d", getServerVersion(c));
 
-	if (PQserverVersion(c) >= 90100)	/* extension support */
+	if (getServerVersion(c) >= 90100)	/* extension support */
 	{
-		query = psprintf("SELECT c.oid, format_type(c.castsource, t.typtypmod) as source, format_type(c.casttarget, u.typtypmod) as target, castmethod, quote_ident(n.nspname) || '.' || quote_ident(f.proname) || '(' || pg_get_function_arguments(f.oid) || ')' as funcname, castcontext, obj_description(c.oid, 'pg_cast') AS description FROM pg_cast c LEFT JOIN pg_type t ON (c.castsource = t.oid) LEFT JOIN pg_type u ON (c.casttarget = u.oid) LEFT JOIN pg_proc f ON (c.castfunc = f.oid) LEFT JOIN pg_namespace n ON (f.pronamespace = n.oid) WHERE c.oid >= %u AND NOT EXISTS(SELECT 1 FROM pg_depend d WHERE c.oid = d.objid AND d.deptype = 'e') ORDER BY source, target",
+		query = psprintf("SELECT c.oid, format_type(c.castsource, t.typtypmod) as source, format_type(c.casttarget, u.typtypmod) as target, castmethod, quote_ident(n.nspname) || '.' || quote_ident(f.proname) || '(' || pg_get_function_arguments(f.oid) || ')' as funcname, castcontext FROM pg_cast c LEFT JOIN pg_type t ON (c.castsource = t.oid) LEFT JOIN pg_type u ON (c.casttarget = u.oid) LEFT JOIN pg_proc f ON (c.castfunc = f.oid) LEFT JOIN pg_namespace n ON (f.pronamespace = n.oid) WHERE c.oid >= %u AND NOT EXISTS(SELECT 1 FROM pg_depend d WHERE c.oid = d.objid AND d.deptype = 'e') ORDER BY source, target",
 						  PGQ_FIRST_USER_OID);
 	}
 	else
 	{
-		query = psprintf("SELECT c.oid, format_type(c.castsource, t.typtypmod) as source, format_type(c.casttarget, u.typtypmod) as target, castmethod, quote_ident(n.nspname) || '.' || quote_ident(f.proname) || '(' || pg_get_function_arguments(f.oid) || ')' as funcname, castcontext, obj_description(c.oid, 'pg_cast') AS description FROM pg_cast c LEFT JOIN pg_type t ON (c.castsource = t.oid) LEFT JOIN pg_type u ON (c.casttarget = u.oid) LEFT JOIN pg_proc f ON (c.castfunc = f.oid) LEFT JOIN pg_namespace n ON (f.pronamespace = n.oid) WHERE c.oid >= %u ORDER BY source, target",
+		query = psprintf("SELECT c.oid, format_type(c.castsource, t.typtypmod) as source, format_type(c.casttarget, u.typtypmod) as target, castmethod, quote_ident(n.nspname) || '.' || quote_ident(f.proname) || '(' || pg_get_function_arguments(f.oid) || ')' as funcname, castcontext FROM pg_cast c LEFT JOIN pg_type t ON (c.castsource = t.oid) LEFT JOIN pg_type u ON (c.casttarget = u.oid) LEFT JOIN pg_proc f ON (c.castfunc = f.oid) LEFT JOIN pg_namespace n ON (f.pronamespace = n.oid) WHERE c.oid >= %u ORDER BY source, target",
 						  PGQ_FIRST_USER_OID);
 	}
 
-	res = PQexec(c, query);
+	res = execQuery(c, query);
 
 	pfree(query);
 
@@ -69,7 +69,7 @@ getCasts(PGconn *c, int *n)
 
 	*n = PQntuples(res);
 	if (*n > 0)
-		d = (PQLCast *) malloc(*n * sizeof(PQLCast));
+		d = (PQLCast *) arenaAlloc(*n * sizeof(PQLCast));
 	else
 		d = NULL;
 
@@ -77,30 +77,14 @@ getCasts(PGconn *c, int *n)
 
 	for (i = 0; i < *n; i++)
 	{
-		char	*withoutescape;
-
 		d[i].oid = strtoul(PQgetvalue(res, i, PQfnumber(res, "oid")), NULL, 10);
-		d[i].source = strdup(PQgetvalue(res, i, PQfnumber(res, "source")));
-		d[i].target = strdup(PQgetvalue(res, i, PQfnumber(res, "target")));
+		d[i].source = arenaStrdup(PQgetvalue(res, i, PQfnumber(res, "source")));
+		d[i].target = arenaStrdup(PQgetvalue(res, i, PQfnumber(res, "target")));
 		d[i].method = PQgetvalue(res, i, PQfnumber(res, "castmethod"))[0];
-		d[i].funcname = strdup(PQgetvalue(res, i, PQfnumber(res, "funcname")));
+		d[i].funcname = arenaStrdup(PQgetvalue(res, i, PQfnumber(res, "funcname")));
 		d[i].context = PQgetvalue(res, i, PQfnumber(res, "castcontext"))[0];
 
-		if (PQgetisnull(res, i, PQfnumber(res, "description")))
-			d[i].comment = NULL;
-		else
-		{
-			withoutescape = PQgetvalue(res, i, PQfnumber(res, "description"));
-			d[i].comment = PQescapeLiteral(c, withoutescape, strlen(withoutescape));
-			if (d[i].comment == NULL)
-			{
-				logError("escaping comment failed: %s", PQerrorMessage(c));
-				PQclear(res);
-				PQfinish(c);
-				/* XXX leak another connection? */
-				exit(EXIT_FAILURE);
-			}
-		}
+		d[i].comment = getComment(PGQ_CLASS_CAST, d[i].oid, 0);
 
 		logDebug("cast \"%s\" as \"%s\" ; method: %c ; context: %c", d[i].source,
 				 d[i].target, d[i].method, d[i].context);
@@ -111,26 +95,6 @@ getCasts(PGconn *c, int *n)
 	return d;
 }
 
-void
-freeCasts(PQLCast *c, int n)
-{
-	if (n > 0)
-	{
-		int	i;
-
-		for (i = 0; i < n; i++)
-		{
-			free(c[i].source);
-			free(c[i].target);
-			free(c[i].funcname);
-			if (c[i].comment)
-				PQfreemem(c[i].comment);
-		}
-
-		free(c);
-	}
-}
-
 void
 dumpCreateCast(FILE *output, PQLCast *c)
 {
@@ -171,10 +135,11 @@ dumpCreateCast(FILE *output, PQLCast *c)
 	if (options.comment && c->comment != NULL)
 	{
 		fprintf(output, "\n\n");
-		fprintf(output, "COMMENT ON CAST (%s AS %s) IS %s;",
+		fprintf(output, "COMMENT ON CAST (%s AS %s) IS ",
 				c->source,
-				c->target,
-				c->comment);
+				c->target);
+		printComment(output, c->comment);
+		fprintf(output, ";");
 	}
 }
 
@@ -211,10 +176,11 @@ dumpAlterCast(FILE *output, PQLCast *a, PQLCast *b)
 				 strcmp(a->comment, b->comment) != 0))
 		{
 			fprintf(output, "\n\n");
-			fprintf(output, "COMMENT ON CAST (%s AS %s) IS %s;",
+			fprintf(output, "COMMENT ON CAST (%s AS %s) IS ",
 					b->source,
-					b->target,
-					b->comment);
+					b->target);
+			printComment(output, b->comment);
+			fprintf(output, ";");
 		}
 		else if (a->comment != NULL && b->comment == NULL)
 		{
@@ -9,6 +9,7 @@
 #ifndef CAST_H
 #define CAST_H
 
+#include "comment.h"
 #include "common.h"
 
 enum PQLCastMethod
@@ -45,6 +46,5 @@ void dumpDropCast(FILE *output, PQLCast *c);
 void dumpCreateCast(FILE *output, PQLCast *c);
 void dumpAlterCast(FILE *output, PQLCast *a, PQLCast *b);
 
-void freeCasts(PQLCast *c, int n);
 
 #endif	/* CAST_H */
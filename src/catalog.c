@@ -0,0 +1,1017 @@
+/*----------------------------------------------------------------------
+ *
+ * pgquarrel -- comparing database schemas
+ *
+ * catalog.c
+ *     Dump and read catalog files
+ *
+ * A catalog file stores the result of every catalog query executed against a
+ * server. It is created with --dump-catalog and it can replace the source or
+ * the target connection. Objects are loaded by the same routines; instead of
+ * sending a query to the server, the result is looked up in the file. Hence,
+ * the file must be dumped using the same object and filter options.
+ *
+ * An open catalog file is handled as a connection (PGconn *) so routines that
+ * fetch objects don't need to know where the results come from. It is never
+ * passed to libpq.
+ *
+ * Copyright (c) 2015-2020, Euler Taveira
+ *
+ * ---------------------------------------------------------------------
+ */
+#include "catalog.h"
+
+#include <errno.h>
+#include <unistd.h>
+
+
+typedef struct PQLCatalogEntry
+{
+	char	*query;
+	char	*result;	/* serialized result */
+	size_t	len;
+} PQLCatalogEntry;
+
+/*
+ * Open catalog files and catalog dumps. Fan-out workers open and close them
+ * while other workers look up their connections (see isCatalogFile) so both
+ * lists are protected by catalogslock. An item is allocated apart from the
+ * list; its address does not change when the list grows.
+ */
+#if defined(_WINDOWS)
+static SRWLOCK	catalogslock = SRWLOCK_INIT;
+#else
+static pthread_mutex_t	catalogslock = PTHREAD_MUTEX_INITIALIZER;
+#endif
+
+/* open catalog files */
+static PQLCatalogFile **catalogfiles = NULL;
+static int ncatalogfiles = 0;
+
+/*
+ * Results of a connection that will be written into a catalog file. Each
+ * connection is used by one thread at a time so entries are not protected.
+ */
+typedef struct PQLCatalogDump
+{
+	PGconn			*conn;
+	PQLCatalogEntry	*entries;
+	int				nentries;
+} PQLCatalogDump;
+
+static PQLCatalogDump **catalogdumps = NULL;
+static int ncatalogdumps = 0;
+
+static void lockCatalogs(void);
+static void unlockCatalogs(void);
+static PQLCatalogFile *getCatalogFile(PGconn *c);
+static PQLCatalogDump *getCatalogDump(PGconn *c);
+static PGresult *findCatalogResult(PQLCatalogFile *cf, const char *query);
+static bool equalResults(PGresult *a, PGresult *b);
+static char *buildFingerprintQuery(int version);
+static uint32 readUint32(PQLCatalogFile *cf, size_t *off);
+static char *readString(PQLCatalogFile *cf, size_t *off);
+static void appendData(char **buf, size_t *len, size_t *size, const void *p,
+					   size_t n);
+static void appendUint32(char **buf, size_t *len, size_t *size, uint32 v);
+static void writeData(FILE *fp, const char *path, const void *p, size_t n);
+static int compareCatalogEntries(const void *a, const void *b);
+
+
+static void
+lockCatalogs(void)
+{
+#if defined(_WINDOWS)
+	AcquireSRWLockExclusive(&catalogslock);
+#else
+	pthread_mutex_lock(&catalogslock);
+#endif
+}
+
+static void
+unlockCatalogs(void)
+{
+#if defined(_WINDOWS)
+	ReleaseSRWLockExclusive(&catalogslock);
+#else
+	pthread_mutex_unlock(&catalogslock);
+#endif
+}
+
+static PQLCatalogFile *
+getCatalogFile(PGconn *c)
+{
+	PQLCatalogFile	*cf = NULL;
+	int				i;
+
+	lockCatalogs();
+	for (i = 0; i < ncatalogfiles; i++)
+	{
+		if ((PGconn *) catalogfiles[i] == c)
+		{
+			cf = catalogfiles[i];
+			break;
+		}
+	}
+	unlockCatalogs();
+
+	return cf;
+}
+
+bool
+isCatalogFile(PGconn *c)
+{
+	return (getCatalogFile(c) != NULL);
+}
+
+/*
+ * A catalog cache is a catalog file with a fallback connection (see
+ * openCatalogCache).
+ */
+bool
+isCatalogCache(PGconn *c)
+{
+	PQLCatalogFile	*cf = getCatalogFile(c);
+
+	return (cf != NULL && cf->fallback != NULL);
+}
+
+static uint32
+readUint32(PQLCatalogFile *cf, size_t *off)
+{
+	uint32	v;
+
+	if (*off + sizeof(uint32) > cf->len)
+	{
+		logError("catalog file \"%s\" is corrupted", cf->path);
+		exit(EXIT_FAILURE);
+	}
+
+	/* data is not aligned */
+	memcpy(&v, cf->data + *off, sizeof(uint32));
+	*off += sizeof(uint32);
+
+	return v;
+}
+
+static char *
+readString(PQLCatalogFile *cf, size_t *off)
+{
+	char	*s;
+	char	*end;
+
+	if (*off >= cf->len)
+	{
+		logError("catalog file \"%s\" is corrupted", cf->path);
+		exit(EXIT_FAILURE);
+	}
+
+	s = cf->data + *off;
+	end = memchr(s, '\0', cf->len - *off);
+	if (end == NULL)
+	{
+		logError("catalog file \"%s\" is corrupted", cf->path);
+		exit(EXIT_FAILURE);
+	}
+	*off += (end - s) + 1;
+
+	return s;
+}
+
+/*
+ * Load a catalog file. The file is read at once; results are decoded on
+ * demand. Returns a handle that is used as a connection.
+ */
+PGconn *
+openCatalogFile(const char *path)
+{
+	PQLCatalogFile	*cf;
+	FILE			*fp;
+	long			len;
+	size_t			off;
+
+	fp = fopen(path, "rb");
+	if (fp == NULL)
+	{
+		logError("could not open catalog file \"%s\": %s", path, strerror(errno));
+		exit(EXIT_FAILURE);
+	}
+
+	if (fseek(fp, 0L, SEEK_END) != 0 || (len = ftell(fp)) < 0 ||
+			fseek(fp, 0L, SEEK_SET) != 0)
+	{
+		logError("could not seek catalog file \"%s\": %s", path, strerror(errno));
+		exit(EXIT_FAILURE);
+	}
+
+	cf = (PQLCatalogFile *) malloc(sizeof(PQLCatalogFile));
+	if (cf == NULL)
+	{
+		logError("could not allocate memory");
+		exit(EXIT_FAILURE);
+	}
+
+	cf->path = strdup(path);
+	cf->fallback = NULL;
+	cf->len = (size_t) len;
+	cf->data = (char *) malloc(cf->len + 1);
+	if (cf->data == NULL)
+	{
+		logError("could not allocate memory");
+		exit(EXIT_FAILURE);
+	}
+
+	if (fread(cf->data, 1, cf->len, fp) != cf->len)
+	{
+		logError("could not read catalog file \"%s\"", path);
+		exit(EXIT_FAILURE);
+	}
+	fclose(fp);
+
+	if (cf->len < sizeof(PQLCatalogHeader) ||
+			memcmp(cf->data, PGQ_CATALOG_MAGIC, 8) != 0)
+	{
+		logError("\"%s\" is not a catalog file", path);
+		exit(EXIT_FAILURE);
+	}
+
+	off = 8;
+	memcpy(cf->header.magic, cf->data, 8);
+	cf->header.version = readUint32(cf, &off);
+	cf->header.byteorder = readUint32(cf, &off);
+	cf->header.serverversion = readUint32(cf, &off);
+	cf->header.nqueries = readUint32(cf, &off);
+	cf->header.indexoffset = readUint32(cf, &off);
+	cf->serverversion = readString(cf, &off);
+
+	if (cf->header.byteorder != PGQ_CATALOG_BYTE_ORDER)
+	{
+		logError("catalog file \"%s\" was dumped on a machine with a different byte order",
+				 path);
+		exit(EXIT_FAILURE);
+	}
+	if (cf->header.version != PGQ_CATALOG_VERSION)
+	{
+		logError("catalog file \"%s\" has version %u (requires %d)", path,
+				 cf->header.version, PGQ_CATALOG_VERSION);
+		exit(EXIT_FAILURE);
+	}
+	if ((size_t) cf->header.indexoffset + (size_t) cf->header.nqueries * 2 *
+			sizeof(uint32) != cf->len)
+	{
+		logError("catalog file \"%s\" is corrupted", path);
+		exit(EXIT_FAILURE);
+	}
+
+	lockCatalogs();
+	catalogfiles = (PQLCatalogFile **) realloc(catalogfiles,
+				   (ncatalogfiles + 1) * sizeof(PQLCatalogFile *));
+	if (catalogfiles == NULL)
+	{
+		logError("could not allocate memory");
+		exit(EXIT_FAILURE);
+	}
+	catalogfiles[ncatalogfiles++] = cf;
+	unlockCatalogs();
+
+	logDebug("catalog file \"%s\": %u queries (server version %s)", path,
+			 cf->header.nqueries, cf->serverversion);
+
+	return (PGconn *) cf;
+}
+
+void
+closeCatalogFile(PGconn *c)
+{
+	PQLCatalogFile	*cf = getCatalogFile(c);
+	int				i, j;
+
+	if (cf == NULL)
+		return;
+
+	lockCatalogs();
+	for (i = 0, j = 0; i < ncatalogfiles; i++)
+	{
+		if (catalogfiles[i] != cf)
+			catalogfiles[j++] = catalogfiles[i];
+	}
+	ncatalogfiles = j;
+	unlockCatalogs();
+
+	if (cf->fallback)
+	{
+		PQfinish(cf->fallback);
+#if defined(_WINDOWS)
+		DeleteCriticalSection(&cf->lock);
+#else
+		pthread_mutex_destroy(&cf->lock);
+#endif
+	}
+
+	free(cf->path);
+	free(cf->data);
+	free(cf);
+}
+
+/*
+ * Queries that are not in the catalog file are executed by the fallback
+ * connection. It is closed by closeCatalogFile. Since a catalog file can be
+ * shared by worker threads, the fallback connection is used by one thread at
+ * a time.
+ */
+void
+setCatalogFallback(PGconn *c, PGconn *fallback)
+{
+	PQLCatalogFile	*cf = getCatalogFile(c);
+
+	cf->fallback = fallback;
+#if defined(_WINDOWS)
+	InitializeCriticalSection(&cf->lock);
+#else
+	pthread_mutex_init(&cf->lock, NULL);
+#endif
+}
+
+int
+getCatalogServerVersion(PGconn *c)
+{
+	PQLCatalogFile	*cf = getCatalogFile(c);
+
+	return (cf) ? (int) cf->header.serverversion : 0;
+}
+
+const char *
+getCatalogServerVersionString(PGconn *c)
+{
+	PQLCatalogFile	*cf = getCatalogFile(c);
+
+	return (cf) ? cf->serverversion : NULL;
+}
+
+/*
+ * Look up the query result in the catalog file. It is a fatal error if the
+ * query is not found and there is no fallback connection; the file was
+ * probably dumped using other options or another pgquarrel version. If
+ * 'cached' is false, a catalog cache (a catalog file with a fallback
+ * connection) asks the server without looking up the query; its result is
+ * not covered by the catalog change markers (see buildFingerprintQuery).
+ */
+PGresult *
+readCatalogResult(PGconn *c, const char *query, bool cached)
+{
+	PQLCatalogFile	*cf = getCatalogFile(c);
+	PGresult		*res = NULL;
+
+	if (cf->fallback == NULL || cached)
+		res = findCatalogResult(cf, query);
+	if (res != NULL)
+		return res;
+
+	if (cf->fallback)
+	{
+		logDebug("query was not found in catalog file \"%s\"; asking the server",
+				 cf->path);
+#if defined(_WINDOWS)
+		EnterCriticalSection(&cf->lock);
+		res = PQexec(cf->fallback, query);
+		LeaveCriticalSection(&cf->lock);
+#else
+		pthread_mutex_lock(&cf->lock);
+		res = PQexec(cf->fallback, query);
+		pthread_mutex_unlock(&cf->lock);
+#endif
+		return res;
+	}
+
+	logError("query was not found in catalog file \"%s\" (was it dumped using the same options?)",
+			 cf->path);
+	logDebug("query: %s", query);
+	exit(EXIT_FAILURE);
+}
+
+/*
+ * The index is sorted by query so a binary search is used. Return NULL if the
+ * query is not found.
+ */
+static PGresult *
+findCatalogResult(PQLCatalogFile *cf, const char *query)
+{
+	PGresult		*res;
+	PGresAttDesc	*attrs;
+	size_t			off = 0;
+	uint32			ntuples, nfields;
+	int				low, high;
+	int				i, j;
+	bool			found = false;
+
+	low = 0;
+	high = (int) cf->header.nqueries - 1;
+	while (low <= high)
+	{
+		int		mid = low + (high - low) / 2;
+		size_t	qoff;
+		int		r;
+
+		qoff = cf->header.indexoffset + mid * 2 * sizeof(uint32);
+		off = readUint32(cf, &qoff);
+		r = strcmp(query, readString(cf, &off));
+		if (r == 0)
+		{
+			off = readUint32(cf, &qoff);
+			found = true;
+			break;
+		}
+		else if (r < 0)
+			high = mid - 1;
+		else
+			low = mid + 1;
+	}
+
+	if (!found)
+		return NULL;
+
+	ntuples = readUint32(cf, &off);
+	nfields = readUint32(cf, &off);
+
+	res = PQmakeEmptyPGresult(NULL, PGRES_TUPLES_OK);
+	if (res == NULL)
+	{
+		logError("out of memory");
+		exit(EXIT_FAILURE);
+	}
+
+	attrs = (PGresAttDesc *) malloc((nfields > 0 ? nfields : 1) * sizeof(PGresAttDesc));
+	if (attrs == NULL)
+	{
+		logError("could not allocate memory");
+		exit(EXIT_FAILURE);
+	}
+	memset(attrs, 0, (nfields > 0 ? nfields : 1) * sizeof(PGresAttDesc));
+
+	for (i = 0; i < nfields; i++)
+	{
+		attrs[i].name = readString(cf, &off);
+		attrs[i].typlen = -1;
+		attrs[i].atttypmod = -1;
+	}
+
+	if (!PQsetResultAttrs(res, nfields, attrs))
+	{
+		logError("out of memory");
+		exit(EXIT_FAILURE);
+	}
+	free(attrs);
+
+	for (i = 0; i < ntuples; i++)
+	{
+		for (j = 0; j < nfields; j++)
+		{
+			uint32	vlen = readUint32(cf, &off);
+
+			/* NULL value */
+			if (vlen == (uint32) -1)
+			{
+				if (!PQsetvalue(res, i, j, NULL, -1))
+				{
+					logError("out of memory");
+					exit(EXIT_FAILURE);
+				}
+				continue;
+			}
+
+			if (off + vlen + 1 > cf->len)
+			{
+				logError("catalog file \"%s\" is corrupted", cf->path);
+				exit(EXIT_FAILURE);
+			}
+
+			if (!PQsetvalue(res, i, j, cf->data + off, (int) vlen))
+			{
+				logError("out of memory");
+				exit(EXIT_FAILURE);
+			}
+			off += vlen + 1;
+		}
+	}
+
+	return res;
+}
+
+static void
+appendData(char **buf, size_t *len, size_t *size, const void *p, size_t n)
+{
+	if (*len + n > *size)
+	{
+		while (*len + n > *size)
+			*size = (*size > 0) ? *size * 2 : 1024;
+
+		*buf = (char *) realloc(*buf, *size);
+		if (*buf == NULL)
+		{
+			logError("could not allocate memory");
+			exit(EXIT_FAILURE);
+		}
+	}
+
+	memcpy(*buf + *len, p, n);
+	*len += n;
+}
+
+static void
+appendUint32(char **buf, size_t *len, size_t *size, uint32 v)
+{
+	appendData(buf, len, size, &v, sizeof(uint32));
+}
+
+static PQLCatalogDump *
+getCatalogDump(PGconn *c)
+{
+	PQLCatalogDump	*d = NULL;
+	int				i;
+
+	lockCatalogs();
+	for (i = 0; i < ncatalogdumps; i++)
+	{
+		if (catalogdumps[i]->conn == c)
+		{
+			d = catalogdumps[i];
+			break;
+		}
+	}
+	unlockCatalogs();
+
+	return d;
+}
+
+bool
+isCatalogDump(PGconn *c)
+{
+	return (getCatalogDump(c) != NULL);
+}
+
+/*
+ * Every query result of connection 'c' will be kept (see recordCatalogResult)
+ * until endCatalogDump is called. It must be called before the connection is
+ * used by more than one thread.
+ */
+void
+startCatalogDump(PGconn *c)
+{
+	PQLCatalogDump	*d;
+
+	if (isCatalogDump(c))
+		return;
+
+	d = (PQLCatalogDump *) malloc(sizeof(PQLCatalogDump));
+	if (d == NULL)
+	{
+		logError("could not allocate memory");
+		exit(EXIT_FAILURE);
+	}
+	d->conn = c;
+	d->entries = NULL;
+	d->nentries = 0;
+
+	lockCatalogs();
+	catalogdumps = (PQLCatalogDump **) realloc(catalogdumps,
+				   (ncatalogdumps + 1) * sizeof(PQLCatalogDump *));
+	if (catalogdumps == NULL)
+	{
+		logError("could not allocate memory");
+		exit(EXIT_FAILURE);
+	}
+	catalogdumps[ncatalogdumps++] = d;
+	unlockCatalogs();
+}
+
+void
+endCatalogDump(PGconn *c)
+{
+	PQLCatalogDump	*d = getCatalogDump(c);
+	int				i, j;
+
+	if (d == NULL)
+		return;
+
+	/* remove it from the list */
+	lockCatalogs();
+	for (i = 0, j = 0; i < ncatalogdumps; i++)
+	{
+		if (catalogdumps[i] != d)
+			catalogdumps[j++] = catalogdumps[i];
+	}
+	ncatalogdumps = j;
+	unlockCatalogs();
+
+	for (i = 0; i < d->nentries; i++)
+	{
+		free(d->entries[i].query);
+		free(d->entries[i].result);
+	}
+	if (d->entries)
+		free(d->entries);
+	free(d);
+}
+
+void
+recordCatalogResult(PGconn *c, const char *query, PGresult *res)
+{
+	PQLCatalogDump	*d;
+	PQLCatalogEntry	*e;
+	size_t			size = 0;
+	int				ntuples, nfields;
+	int				i, j;
+
+	if (PQresultStatus(res) != PGRES_TUPLES_OK)
+		return;
+
+	d = getCatalogDump(c);
+	if (d == NULL)
+		return;
+
+	d->entries = (PQLCatalogEntry *) realloc(d->entries,
+				 (d->nentries + 1) * sizeof(PQLCatalogEntry));
+	if (d->entries == NULL)
+	{
+		logError("could not allocate memory");
+		exit(EXIT_FAILURE);
+	}
+
+	e = &d->entries[d->nentries++];
+	e->query = strdup(query);
+	e->result = NULL;
+	e->len = 0;
+
+	ntuples = PQntuples(res);
+	nfields = PQnfields(res);
+
+	appendUint32(&e->result, &e->len, &size, (uint32) ntuples);
+	appendUint32(&e->result, &e->len, &size, (uint32) nfields);
+	for (j = 0; j < nfields; j++)
+		appendData(&e->result, &e->len, &size, PQfname(res, j),
+				   strlen(PQfname(res, j)) + 1);
+
+	for (i = 0; i < ntuples; i++)
+	{
+		for (j = 0; j < nfields; j++)
+		{
+			if (PQgetisnull(res, i, j))
+			{
+				appendUint32(&e->result, &e->len, &size, (uint32) -1);
+				continue;
+			}
+
+			appendUint32(&e->result, &e->len, &size,
+						 (uint32) PQgetlength(res, i, j));
+			appendData(&e->result, &e->len, &size, PQgetvalue(res, i, j),
+					   PQgetlength(res, i, j) + 1);
+		}
+	}
+}
+
+static void
+writeData(FILE *fp, const char *path, const void *p, size_t n)
+{
+	if (fwrite(p, 1, n, fp) != n)
+	{
+		logError("could not write catalog file \"%s\": %s", path, strerror(errno));
+		exit(EXIT_FAILURE);
+	}
+}
+
+static int
+compareCatalogEntries(const void *a, const void *b)
+{
+	return strcmp(((PQLCatalogEntry *) a)->query, ((PQLCatalogEntry *) b)->query);
+}
+
+/*
+ * Write every result recorded for connection 'c' into a catalog file. Queries
+ * that were executed more than once are stored only once. The file is written
+ * under a temporary name and then renamed so a reader never sees a partial
+ * file.
+ */
+void
+writeCatalogDump(PGconn *c, const char *path)
+{
+	PQLCatalogDump	*d = getCatalogDump(c);
+	FILE		*fp;
+	char		*tmppath;
+	const char	*serverversion;
+	uint32		*index;
+	uint32		v;
+	size_t		off;
+	int			n;
+	int			i;
+
+	qsort(d->entries, d->nentries, sizeof(PQLCatalogEntry),
+		  compareCatalogEntries);
+
+	index = (uint32 *) malloc((d->nentries > 0 ? d->nentries : 1) * 2 *
+							  sizeof(uint32));
+	if (index == NULL)
+	{
+		logError("could not allocate memory");
+		exit(EXIT_FAILURE);
+	}
+
+	tmppath = psprintf("%s.tmp", path);
+
+	fp = fopen(tmppath, "wb");
+	if (fp == NULL)
+	{
+		logError("could not open catalog file \"%s\": %s", tmppath,
+				 strerror(errno));
+		exit(EXIT_FAILURE);
+	}
+
+	serverversion = PQparameterStatus(c, "server_version");
+	if (serverversion == NULL)
+		serverversion = "unknown";
+
+	/* header */
+	writeData(fp, tmppath, PGQ_CATALOG_MAGIC, 8);
+	v = PGQ_CATALOG_VERSION;
+	writeData(fp, tmppath, &v, sizeof(uint32));
+	v = PGQ_CATALOG_BYTE_ORDER;
+	writeData(fp, tmppath, &v, sizeof(uint32));
+	v = (uint32) PQserverVersion(c);
+	writeData(fp, tmppath, &v, sizeof(uint32));
+
+	/* the same query could be executed more than once */
+	n = 0;
+	for (i = 0; i < d->nentries; i++)
+	{
+		if (i > 0 && strcmp(d->entries[i].query, d->entries[i - 1].query) == 0)
+			continue;
+		n++;
+	}
+
+	off = 8 + 5 * sizeof(uint32) + strlen(serverversion) + 1;
+	v = (uint32) n;
+	writeData(fp, tmppath, &v, sizeof(uint32));
+
+	/* compute index offset */
+	n = 0;
+	for (i = 0; i < d->nentries; i++)
+	{
+		if (i > 0 && strcmp(d->entries[i].query, d->entries[i - 1].query) == 0)
+			continue;
+
+		index[2 * n] = (uint32) off;
+		off += strlen(d->entries[i].query) + 1;
+		index[2 * n + 1] = (uint32) off;
+		off += d->entries[i].len;
+		n++;
+
+		if (off > 0xFFFFFFFF)
+		{
+			logError("catalog file \"%s\" is too large", path);
+			exit(EXIT_FAILURE);
+		}
+	}
+
+	v = (uint32) off;
+	writeData(fp, tmppath, &v, sizeof(uint32));
+	writeData(fp, tmppath, serverversion, strlen(serverversion) + 1);
+
+	/* results */
+	for (i = 0; i < d->nentries; i++)
+	{
+		if (i > 0 && strcmp(d->entries[i].query, d->entries[i - 1].query) == 0)
+			continue;
+
+		writeData(fp, tmppath, d->entries[i].query, strlen(d->entries[i].query) + 1);
+		writeData(fp, tmppath, d->entries[i].result, d->entries[i].len);
+	}
+
+	/* index */
+	writeData(fp, tmppath, index, n * 2 * sizeof(uint32));
+
+	if (fclose(fp) != 0)
+	{
+		logError("could not close catalog file \"%s\": %s", tmppath,
+				 strerror(errno));
+		exit(EXIT_FAILURE);
+	}
+
+#if defined(_WINDOWS)
+	/* rename does not replace an existing file */
+	unlink(path);
+#endif
+	if (rename(tmppath, path) != 0)
+	{
+		logError("could not rename catalog file \"%s\" to \"%s\": %s", tmppath,
+				 path, strerror(errno));
+		exit(EXIT_FAILURE);
+	}
+
+	logDebug("catalog file \"%s\": %d queries", path, n);
+
+	pfree(tmppath);
+	free(index);
+}
+
+/*
+ * Two results are equal if they have the same fields and values.
+ */
+static bool
+equalResults(PGresult *a, PGresult *b)
+{
+	int		i, j;
+
+	if (PQntuples(a) != PQntuples(b) || PQnfields(a) != PQnfields(b))
+		return false;
+
+	for (i = 0; i < PQntuples(a); i++)
+	{
+		for (j = 0; j < PQnfields(a); j++)
+		{
+			if (PQgetisnull(a, i, j) != PQgetisnull(b, i, j))
+				return false;
+			if (strcmp(PQgetvalue(a, i, j), PQgetvalue(b, i, j)) != 0)
+				return false;
+		}
+	}
+
+	return true;
+}
+
+/*
+ * Build a query that returns a change marker for each catalog that objects
+ * are loaded from: the number of rows and a hash of the row versions (ctid
+ * and xmin). A hash does not depend on the order of transaction ids, which
+ * wraps around. A
+ * DDL command inserts, updates or deletes catalog rows so at least one marker
+ * moves. pg_authid is not readable by everyone; roles use the number of rows
+ * and a hash of oid and name of pg_roles instead. pg_subscription is not
+ * readable by everyone either; subscriptions are never read from the cache
+ * (see execServerQuery). Sequence parameters are stored in the sequence
+ * itself before 10 and table sizes are updated in place; they are not read
+ * from the cache either.
+ */
+static char *
+buildFingerprintQuery(int version)
+{
+	/* catalogs and the first version that has it (0 = all versions) */
+	const struct
+	{
+		const char	*name;
+		int			version;
+	}			catalogs[] =
+	{
+		{"pg_namespace", 0},
+		{"pg_tablespace", 0},
+		{"pg_class", 0},
+		{"pg_attribute", 0},
+		{"pg_attrdef", 0},
+		{"pg_constraint", 0},
+		{"pg_index", 0},
+		{"pg_inherits", 0},
+		{"pg_depend", 0},
+		{"pg_proc", 0},
+		{"pg_aggregate", 0},
+		{"pg_type", 0},
+		{"pg_enum", 0},
+		{"pg_cast", 0},
+		{"pg_conversion", 0},
+		{"pg_language", 0},
+		{"pg_operator", 0},
+		{"pg_opclass", 0},
+		{"pg_opfamily", 0},
+		{"pg_amop", 0},
+		{"pg_amproc", 0},
+		{"pg_am", 0},
+		{"pg_trigger", 0},
+		{"pg_rewrite", 0},
+		{"pg_description", 0},
+		{"pg_shdescription", 0},
+		{"pg_foreign_data_wrapper", 0},
+		{"pg_foreign_server", 0},
+		{"pg_user_mapping", 0},
+		{"pg_ts_config", 0},
+		{"pg_ts_config_map", 0},
+		{"pg_ts_dict", 0},
+		{"pg_ts_parser", 0},
+		{"pg_ts_template", 0},
+		{"pg_collation", 90100},
+		{"pg_extension", 90100},
+		{"pg_foreign_table", 90100},
+		{"pg_seclabel", 90100},
+		{"pg_shseclabel", 90200},
+		{"pg_range", 90200},
+		{"pg_event_trigger", 90300},
+		{"pg_policy", 90500},
+		{"pg_transform", 90500},
+		{"pg_partitioned_table", 100000},
+		{"pg_publication", 100000},
+		{"pg_publication_rel", 100000},
+		{"pg_sequence", 100000},
+		{"pg_statistic_ext", 100000},
+		{NULL, 0}
+	};
+	char		*query = NULL;
+	char		*tmp;
+	int			i;
+
+	for (i = 0; catalogs[i].name != NULL; i++)
+	{
+		if (version < catalogs[i].version)
+			continue;
+
+		tmp = psprintf("%s%sSELECT '%s' AS catalog, count(*) AS rows, md5(string_agg(ctid::text || ':' || xmin::text, ',' ORDER BY ctid)) AS marker FROM pg_catalog.%s",
+					   query ? query : "", query ? " UNION ALL " : "",
+					   catalogs[i].name, catalogs[i].name);
+		if (query)
+			pfree(query);
+		query = tmp;
+	}
+
+	/* a renamed role changes the owner of objects */
+	tmp = psprintf("%s UNION ALL SELECT 'pg_roles' AS catalog, count(*) AS rows, md5(string_agg(oid::text || ':' || rolname, ',' ORDER BY oid)) AS marker FROM pg_catalog.pg_roles",
+				   query);
+	pfree(query);
+	query = tmp;
+
+	return query;
+}
+
+/*
+ * Use the catalog cache of the database that 'c' is connected to. The cache
+ * is a catalog file whose name is derived from the connection. It is valid if
+ * the catalog change markers (see buildFingerprintQuery) did not move since
+ * it was written. In this case, return the cache; queries that are not in it
+ * are executed by 'c'. Otherwise, return 'c' and record its results; call
+ * writeCatalogDump(c, *path) to refresh the cache.
+ *
+ * It must be called inside the transaction that will fetch the objects.
+ */
+PGconn *
+openCatalogCache(PGconn *c, const char *dir, char **path)
+{
+	PGconn		*cache;
+	PGresult	*res;
+	PGresult	*cached;
+	char		*query;
+	char		*key;
+	uint32		h1 = 2166136261u;	/* FNV-1a */
+	uint32		h2 = 0;
+	char		*p;
+
+	/* same database, same cache */
+	key = psprintf("%s:%s:%s:%s", PQhost(c) ? PQhost(c) : "",
+				   PQport(c) ? PQport(c) : "", PQdb(c) ? PQdb(c) : "",
+				   PQuser(c) ? PQuser(c) : "");
+	for (p = key; *p != '\0'; p++)
+	{
+		h1 = (h1 ^ (unsigned char) *p) * 16777619u;
+		h2 = h2 * 31 + (unsigned char) *p;
+	}
+	*path = psprintf("%s/pgquarrel-%08x%08x.catalog", dir, h1, h2);
+	pfree(key);
+
+	query = buildFingerprintQuery(PQserverVersion(c));
+	res = PQexec(c, query);
+	if (PQresultStatus(res) != PGRES_TUPLES_OK)
+	{
+		logError("query failed: %s", PQresultErrorMessage(res));
+		PQclear(res);
+		PQfinish(c);
+		/* XXX leak another connection? */
+		exit(EXIT_FAILURE);
+	}
+
+	if (access(*path, R_OK) == 0)
+	{
+		cache = openCatalogFile(*path);
+		cached = findCatalogResult(getCatalogFile(cache), query);
+
+		if (cached != NULL && getCatalogServerVersion(cache) == PQserverVersion(c) &&
+				equalResults(res, cached))
+		{
+			logDebug("catalog cache \"%s\" is up to date", *path);
+
+			PQclear(cached);
+			PQclear(res);
+			pfree(query);
+
+			setCatalogFallback(cache, c);
+
+			return cache;
+		}
+
+		if (cached != NULL)
+			PQclear(cached);
+		closeCatalogFile(cache);
+	}
+
+	logDebug("catalog cache \"%s\" will be refreshed", *path);
+
+	startCatalogDump(c);
+	recordCatalogResult(c, query, res);
+
+	PQclear(res);
+	pfree(query);
+
+	return c;
+}
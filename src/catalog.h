@@ -0,0 +1,80 @@
+/*----------------------------------------------------------------------
+ *
+ * pgquarrel -- comparing database schemas
+ *
+ * Copyright (c) 2015-2020, Euler Taveira
+ *
+ * ---------------------------------------------------------------------
+ */
+#ifndef CATALOG_H
+#define CATALOG_H
+
+#include "common.h"
+
+#if defined(_WINDOWS)
+#include <windows.h>
+#else
+#include <pthread.h>
+#endif
+
+#define PGQ_CATALOG_MAGIC		"PGQCATLG"
+#define PGQ_CATALOG_VERSION		1
+#define PGQ_CATALOG_BYTE_ORDER	0x01020304
+
+/*
+ * Catalog file layout. All integers are uint32 in the byte order of the
+ * machine that dumped the file; all offsets are relative to the beginning of
+ * the file. Nothing needs to be parsed to load it; results are decoded when
+ * a query is looked up.
+ *
+ *	header		magic, format version, byte order, server version number,
+ *				number of queries, index offset, server version string
+ *	results		query string, number of tuples, number of fields, field
+ *				names, values (length or -1 for NULL followed by value)
+ *	index		(query offset, result offset) pairs sorted by query
+ */
+typedef struct PQLCatalogHeader
+{
+	char	magic[8];
+	uint32	version;
+	uint32	byteorder;
+	uint32	serverversion;
+	uint32	nqueries;
+	uint32	indexoffset;
+} PQLCatalogHeader;
+
+typedef struct PQLCatalogFile
+{
+	char		*path;
+	char		*data;		/* file contents */
+	size_t		len;
+	PQLCatalogHeader	header;
+	char		*serverversion;	/* points into data */
+
+	/* execute queries that are not in the file (see setCatalogFallback) */
+	PGconn		*fallback;
+#if defined(_WINDOWS)
+	CRITICAL_SECTION	lock;
+#else
+	pthread_mutex_t		lock;
+#endif
+} PQLCatalogFile;
+
+PGconn *openCatalogFile(const char *path);
+void closeCatalogFile(PGconn *c);
+bool isCatalogFile(PGconn *c);
+bool isCatalogCache(PGconn *c);
+void setCatalogFallback(PGconn *c, PGconn *fallback);
+PGresult *readCatalogResult(PGconn *c, const char *query, bool cached);
+int getCatalogServerVersion(PGconn *c);
+const char *getCatalogServerVersionString(PGconn *c);
+
+void startCatalogDump(PGconn *c);
+void endCatalogDump(PGconn *c);
+bool isCatalogDump(PGconn *c);
+void recordCatalogResult(PGconn *c, const char *query, PGresult *res);
+void writeCatalogDump(PGconn *c, const char *path);
+
+PGconn *openCatalogCache(PGconn *c, const char *dir, char **path);
+
+#endif	/* CATALOG_H */
@@ -35,26 +35,26 @@ getCollations(PGconn *c, int *n)
 	PGresult		*res;
 	int				i;
 
-	logNoise("collation: server version: %d", PQserverVersion(c));
+	logNoise("collation: server version: %d", getServerVersion(c));
 
 	/* bail out if we do not support it */
-	if (PQserverVersion(c) < 90100)
+	if (getServerVersion(c) < 90100)
 	{
 		logWarning("ignoring collations because server does not support it");
 		return NULL;
 	}
-	else if (PQserverVersion(c) >= 100000)
+	else if (getServerVersion(c) >= 100000)
 	{
-		query = psprintf("SELECT c.oid, n.nspname, collname, pg_encoding_to_char(collencoding) AS collencoding, collcollate, collctype, collprovider, pg_get_userbyid(collowner) AS collowner, obj_description(c.oid, 'pg_collation') AS description FROM pg_collation c INNER JOIN pg_namespace n ON (c.collnamespace = n.oid) WHERE c.oid >= %u %s%s AND NOT EXISTS(SELECT 1 FROM pg_depend d WHERE c.oid = d.objid AND d.deptype = 'e') ORDER BY n.nspname, collname",
+		query = psprintf("SELECT c.oid, n.nspname, collname, pg_encoding_to_char(collencoding) AS collencoding, collcollate, collctype, collprovider, pg_get_userbyid(collowner) AS collowner FROM pg_collation c INNER JOIN pg_namespace n ON (c.collnamespace = n.oid) WHERE c.oid >= %u %s%s AND NOT EXISTS(SELECT 1 FROM pg_depend d WHERE c.oid = d.objid AND d.deptype = 'e') ORDER BY n.nspname, collname",
 						  PGQ_FIRST_USER_OID, include_schema_str, exclude_schema_str);
 	}
 	else
 	{
-		query = psprintf("SELECT c.oid, n.nspname, collname, pg_encoding_to_char(collencoding) AS collencoding, collcollate, collctype, NULL AS collprovider, pg_get_userbyid(collowner) AS collowner, obj_description(c.oid, 'pg_collation') AS description FROM pg_collation c INNER JOIN pg_namespace n ON (c.collnamespace = n.oid) WHERE c.oid >= %u %s%s AND NOT EXISTS(SELECT 1 FROM pg_depend d WHERE c.oid = d.objid AND d.deptype = 'e') ORDER BY n.nspname, collname",
+		query = psprintf("SELECT c.oid, n.nspname, collname, pg_encoding_to_char(collencoding) AS collencoding, collcollate, collctype, NULL AS collprovider, pg_get_userbyid(collowner) AS collowner FROM pg_collation c INNER JOIN pg_namespace n ON (c.collnamespace = n.oid) WHERE c.oid >= %u %s%s AND NOT EXISTS(SELECT 1 FROM pg_depend d WHERE c.oid = d.objid AND d.deptype = 'e') ORDER BY n.nspname, collname",
 						  PGQ_FIRST_USER_OID, include_schema_str, exclude_schema_str);
 	}
 
-	res = PQexec(c, query);
+	res = execQuery(c, query);
 
 	pfree(query);
 
@@ -69,7 +69,7 @@ getCollations(PGconn *c, int *n)
 
 	*n = PQntuples(res);
 	if (*n > 0)
-		d = (PQLCollation *) malloc(*n * sizeof(PQLCollation));
+		d = (PQLCollation *) arenaAlloc(*n * sizeof(PQLCollation));
 	else
 		d = NULL;
 
@@ -77,37 +77,21 @@ getCollations(PGconn *c, int *n)
 
 	for (i = 0; i < *n; i++)
 	{
-		char	*withoutescape;
-
 		d[i].obj.oid = strtoul(PQgetvalue(res, i, PQfnumber(res, "oid")), NULL, 10);
-		d[i].obj.schemaname = strdup(PQgetvalue(res, i, PQfnumber(res, "nspname")));
-		d[i].obj.objectname = strdup(PQgetvalue(res, i, PQfnumber(res, "collname")));
-		d[i].encoding = strdup(PQgetvalue(res, i, PQfnumber(res, "collencoding")));
-		d[i].collate = strdup(PQgetvalue(res, i, PQfnumber(res, "collcollate")));
-		d[i].ctype = strdup(PQgetvalue(res, i, PQfnumber(res, "collctype")));
+		d[i].obj.schemaname = internName(PQgetvalue(res, i, PQfnumber(res, "nspname")));
+		d[i].obj.objectname = internName(PQgetvalue(res, i, PQfnumber(res, "collname")));
+		d[i].encoding = arenaStrdup(PQgetvalue(res, i, PQfnumber(res, "collencoding")));
+		d[i].collate = arenaStrdup(PQgetvalue(res, i, PQfnumber(res, "collcollate")));
+		d[i].ctype = arenaStrdup(PQgetvalue(res, i, PQfnumber(res, "collctype")));
 
 		if (PQgetisnull(res, i, PQfnumber(res, "collprovider")))
 			d[i].provider = NULL;
 		else
-			d[i].provider = strdup(PQgetvalue(res, i, PQfnumber(res, "collprovider")));
+			d[i].provider = arenaStrdup(PQgetvalue(res, i, PQfnumber(res, "collprovider")));
 
-		if (PQgetisnull(res, i, PQfnumber(res, "description")))
-			d[i].comment = NULL;
-		else
-		{
-			withoutescape = PQgetvalue(res, i, PQfnumber(res, "description"));
-			d[i].comment = PQescapeLiteral(c, withoutescape, strlen(withoutescape));
-			if (d[i].comment == NULL)
-			{
-				logError("escaping comment failed: %s", PQerrorMessage(c));
-				PQclear(res);
-				PQfinish(c);
-				/* XXX leak another connection? */
-				exit(EXIT_FAILURE);
-			}
-		}
+		d[i].comment = getComment(PGQ_CLASS_COLLATION, d[i].obj.oid, 0);
 
-		d[i].owner = strdup(PQgetvalue(res, i, PQfnumber(res, "collowner")));
+		d[i].owner = internName(PQgetvalue(res, i, PQfnumber(res, "collowner")));
 
 		logDebug("collation \"%s\".\"%s\"", d[i].obj.schemaname, d[i].obj.objectname);
 	}
@@ -117,36 +101,11 @@ getCollations(PGconn *c, int *n)
 	return d;
 }
 
-void
-freeCollations(PQLCollation *c, int n)
-{
-	if (n > 0)
-	{
-		int	i;
-
-		for (i = 0; i < n; i++)
-		{
-			free(c[i].obj.schemaname);
-			free(c[i].obj.objectname);
-			free(c[i].encoding);
-			free(c[i].collate);
-			free(c[i].ctype);
-			if (c[i].provider)
-				free(c[i].provider);
-			if (c[i].comment)
-				PQfreemem(c[i].comment);
-			free(c[i].owner);
-		}
-
-		free(c);
-	}
-}
-
 void
 dumpCreateCollation(FILE *output, PQLCollation *c)
 {
-	char	*schema = formatObjectIdentifier(c->obj.schemaname);
-	char	*collname = formatObjectIdentifier(c->obj.objectname);
+	char	*schema = quotedName(c->obj.schemaname);
+	char	*collname = quotedName(c->obj.objectname);
 
 	/*
 	 * All pg_conversion columns are not null, specifying collate and ctype are
@@ -177,49 +136,43 @@ dumpCreateCollation(FILE *output, PQLCollation *c)
 	if (options.comment && c->comment != NULL)
 	{
 		fprintf(output, "\n\n");
-		fprintf(output, "COMMENT ON COLLATION %s.%s IS %s;",
+		fprintf(output, "COMMENT ON COLLATION %s.%s IS ",
 				schema,
-				collname,
-				c->comment);
+				collname);
+		printComment(output, c->comment);
+		fprintf(output, ";");
 	}
 
 	/* owner */
 	if (options.owner)
 	{
-		char	*owner = formatObjectIdentifier(c->owner);
+		char	*owner = quotedName(c->owner);
 
 		fprintf(output, "\n\n");
 		fprintf(output, "ALTER COLLATION %s.%s OWNER TO %s;",
 				schema,
 				collname,
 				owner);
-
-		free(owner);
 	}
 
-	free(schema);
-	free(collname);
 }
 
 void
 dumpDropCollation(FILE *output, PQLCollation *c)
 {
-	char	*schema = formatObjectIdentifier(c->obj.schemaname);
-	char	*collname = formatObjectIdentifier(c->obj.objectname);
+	char	*schema = quotedName(c->obj.schemaname);
+	char	*collname = quotedName(c->obj.objectname);
 
 	fprintf(output, "\n\n");
 	fprintf(output, "DROP COLLATION %s.%s;",
 			schema, collname);
-
-	free(schema);
-	free(collname);
 }
 
 void
 dumpAlterCollation(FILE *output, PQLCollation *a, PQLCollation *b)
 {
-	char	*schema2 = formatObjectIdentifier(b->obj.schemaname);
-	char	*collname2 = formatObjectIdentifier(b->obj.objectname);
+	char	*schema2 = quotedName(b->obj.schemaname);
+	char	*collname2 = quotedName(b->obj.objectname);
 
 	/* comment */
 	if (options.comment)
@@ -229,10 +182,11 @@ dumpAlterCollation(FILE *output, PQLCollation *a, PQLCollation *b)
 				 strcmp(a->comment, b->comment) != 0))
 		{
 			fprintf(output, "\n\n");
-			fprintf(output, "COMMENT ON COLLATION %s.%s IS %s;",
+			fprintf(output, "COMMENT ON COLLATION %s.%s IS ",
 					schema2,
-					collname2,
-					b->comment);
+					collname2);
+			printComment(output, b->comment);
+			fprintf(output, ";");
 		}
 		else if (a->comment != NULL && b->comment == NULL)
 		{
@@ -248,18 +202,13 @@ dumpAlterCollation(FILE *output, PQLCollation *a, PQLCollation *b)
 	{
 		if (strcmp(a->owner, b->owner) != 0)
 		{
-			char	*owner = formatObjectIdentifier(b->owner);
+			char	*owner = quotedName(b->owner);
 
 			fprintf(output, "\n\n");
 			fprintf(output, "ALTER COLLATION %s.%s OWNER TO %s;",
 					schema2,
 					collname2,
 					owner);
-
-			free(owner);
 		}
 	}
-
-	free(schema2);
-	free(collname2);
 }
@@ -9,6 +9,7 @@
 #ifndef COLLATION_H
 #define COLLATION_H
 
+#include "comment.h"
 #include "common.h"
 #include "privileges.h"
 
@@ -31,6 +32,5 @@ void dumpDropCollation(FILE *output, PQLCollation *c);
 void dumpCreateCollation(FILE *output, PQLCollation *c);
 void dumpAlterCollation(FILE *output, PQLCollation *a, PQLCollation *b);
 
-void freeCollations(PQLCollation *c, int n);
 
 #endif	/* COLLATION_H */
@@ -0,0 +1,220 @@
+/*----------------------------------------------------------------------
+ *
+ * pgquarrel -- comparing database schemas
+ *
+ * comment.c
+ *     Load comments of all objects
+ *
+ * pg_description and pg_shdescription are loaded once per server instead of
+ * calling obj_description for each object. The fetch routines look up the
+ * comment of an object in the comments of the server that they are loading
+ * (see setCurrentComments). Comments are stored as they are in the catalog;
+ * they are quoted only when a command is printed.
+ *
+ * Copyright (c) 2015-2020, Euler Taveira
+ *
+ * ---------------------------------------------------------------------
+ */
+#include "comment.h"
+
+
+static int compareComments(const void *a, const void *b);
+static size_t quoteComment(char *dst, const char *comment);
+
+/* comments of the server that this thread is loading (see getComment) */
+static PGQ_THREAD_LOCAL PQLComments *currentcomments = NULL;
+
+static int
+compareComments(const void *a, const void *b)
+{
+	const PQLComment	*x = (const PQLComment *) a;
+	const PQLComment	*y = (const PQLComment *) b;
+
+	if (x->classoid != y->classoid)
+		return (x->classoid < y->classoid) ? -1 : 1;
+	if (x->objoid != y->objoid)
+		return (x->objoid < y->objoid) ? -1 : 1;
+	if (x->objsubid != y->objsubid)
+		return (x->objsubid < y->objsubid) ? -1 : 1;
+
+	return 0;
+}
+
+void
+getComments(PGconn *c, PQLComments *d)
+{
+	char		*query;
+	PGresult	*res;
+	int			i;
+
+	query = psprintf("SELECT classoid, objoid, objsubid, description FROM pg_description UNION ALL SELECT classoid, objoid, 0 AS objsubid, description FROM pg_shdescription ORDER BY 1, 2, 3");
+
+	res = execQuery(c, query);
+
+	pfree(query);
+
+	if (PQresultStatus(res) != PGRES_TUPLES_OK)
+	{
+		logError("query failed: %s", PQresultErrorMessage(res));
+		PQclear(res);
+		PQfinish(c);
+		/* XXX leak another connection? */
+		exit(EXIT_FAILURE);
+	}
+
+	d->res = res;
+	d->nitems = PQntuples(res);
+	if (d->nitems > 0)
+	{
+		d->items = (PQLComment *) malloc(d->nitems * sizeof(PQLComment));
+		if (d->items == NULL)
+		{
+			logError("could not allocate memory");
+			exit(EXIT_FAILURE);
+		}
+	}
+	else
+		d->items = NULL;
+
+	for (i = 0; i < d->nitems; i++)
+	{
+		PQLComment	*x = &d->items[i];
+
+		x->classoid = strtoul(PQgetvalue(res, i, PQfnumber(res, "classoid")), NULL, 10);
+		x->objoid = strtoul(PQgetvalue(res, i, PQfnumber(res, "objoid")), NULL, 10);
+		x->objsubid = atoi(PQgetvalue(res, i, PQfnumber(res, "objsubid")));
+		x->description = PQgetvalue(res, i, PQfnumber(res, "description"));
+	}
+
+	/* ORDER BY uses the same order but do not rely on it */
+	qsort(d->items, d->nitems, sizeof(PQLComment), compareComments);
+
+	logDebug("number of comments in server: %d", d->nitems);
+}
+
+void
+freeComments(PQLComments *d)
+{
+	if (d->items)
+		free(d->items);
+	if (d->res)
+		PQclear(d->res);
+	d->items = NULL;
+	d->res = NULL;
+	d->nitems = 0;
+}
+
+/*
+ * Objects loaded by this thread use comments 'd' until other comments are
+ * set. NULL means that comments are not compared.
+ */
+void
+setCurrentComments(PQLComments *d)
+{
+	currentcomments = d;
+}
+
+/*
+ * Return the comment of an object or NULL if it does not have one. A column
+ * is (pg_class, table, column number); other objects use objsubid 0.
+ */
+char *
+getComment(Oid classoid, Oid objoid, int objsubid)
+{
+	PQLComment	key;
+	PQLComment	*x;
+
+	if (currentcomments == NULL || currentcomments->nitems == 0)
+		return NULL;
+
+	key.classoid = classoid;
+	key.objoid = objoid;
+	key.objsubid = objsubid;
+
+	x = (PQLComment *) bsearch(&key, currentcomments->items,
+							   currentcomments->nitems, sizeof(PQLComment),
+							   compareComments);
+
+	return (x) ? x->description : NULL;
+}
+
+/*
+ * Quote comment the same way escapeLiteral does. If dst is NULL, only the
+ * length is returned.
+ */
+static size_t
+quoteComment(char *dst, const char *comment)
+{
+	const char	*s;
+	size_t		len = 2;
+	bool		backslash = false;
+
+	for (s = comment; *s; s++)
+	{
+		if (*s == '\\')
+			backslash = true;
+		if (*s == '\'' || *s == '\\')
+			len++;
+		len++;
+	}
+	if (backslash)
+		len += 2;
+
+	if (dst == NULL)
+		return len;
+
+	if (backslash)
+	{
+		*dst++ = ' ';
+		*dst++ = 'E';
+	}
+	*dst++ = '\'';
+	for (s = comment; *s; s++)
+	{
+		if (*s == '\'' || *s == '\\')
+			*dst++ = *s;
+		*dst++ = *s;
+	}
+	*dst++ = '\'';
+	*dst = '\0';
+
+	return len;
+}
+
+/*
+ * Print comment as a string literal (see quoteComment). Comments are quoted
+ * only if a command is printed; most of them are equal in both servers.
+ */
+void
+printComment(FILE *output, const char *comment)
+{
+	const char	*s;
+
+	if (strchr(comment, '\\') != NULL)
+		fputs(" E", output);
+	fputc('\'', output);
+	for (s = comment; *s; s++)
+	{
+		if (*s == '\'' || *s == '\\')
+			fputc(*s, output);
+		fputc(*s, output);
+	}
+	fputc('\'', output);
+}
+
+/* same as printComment but the result is allocated */
+char *
+formatComment(const char *comment)
+{
+	char	*ret;
+
+	ret = (char *) malloc(quoteComment(NULL, comment) + 1);
+	if (ret == NULL)
+	{
+		logError("could not allocate memory");
+		exit(EXIT_FAILURE);
+	}
+	quoteComment(ret, comment);
+
+	return ret;
+}
@@ -0,0 +1,39 @@
+/*----------------------------------------------------------------------
+ *
+ * pgquarrel -- comparing database schemas
+ *
+ * Copyright (c) 2015-2020, Euler Taveira
+ *
+ * ---------------------------------------------------------------------
+ */
+#ifndef COMMENT_H
+#define COMMENT_H
+
+#include "common.h"
+#include "depend.h"
+
+/* description of object (classoid, objoid, objsubid) */
+typedef struct PQLComment
+{
+	Oid		classoid;
+	Oid		objoid;
+	int		objsubid;		/* column number or 0 */
+	char	*description;	/* not escaped; points into res */
+} PQLComment;
+
+/* comments of one server sorted by (classoid, objoid, objsubid) */
+typedef struct PQLComments
+{
+	PGresult	*res;
+	PQLComment	*items;
+	int			nitems;
+} PQLComments;
+
+void getComments(PGconn *c, PQLComments *d);
+void freeComments(PQLComments *d);
+void setCurrentComments(PQLComments *d);
+char *getComment(Oid classoid, Oid objoid, int objsubid);
+void printComment(FILE *output, const char *comment);
+char *formatComment(const char *comment);
+
+#endif	/* COMMENT_H */
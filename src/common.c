@@ -12,23 +12,12 @@
  * ---------------------------------------------------------------------
  */
 #include "common.h"
+#include "catalog.h"
+#include "ident.h"
 
-
-#if PG_VERSION_NUM >= 90600
-#include "common/keywords.h"
-#else
-#include "parser/keywords.h"
-#endif
-
-#if PG_VERSION_NUM < 90600
-#define	PG_KEYWORD(a,b,c) {a,0,c},
-
-const ScanKeyword PQLScanKeywords[] =
-{
-#include "parser/kwlist.h"
-};
-
-const int NumPQLScanKeywords = lengthof(PQLScanKeywords);
+#if !defined(_WINDOWS)
+#include <sys/time.h>
+#include <time.h>
 #endif
 
 
@@ -41,11 +30,88 @@ static const char *logLevelTag[] =
 	"NOISE"
 };
 
+/* arena that receives catalog objects loaded by this thread */
+static PGQ_THREAD_LOCAL PQLArena *currentarena = NULL;
 
-static stringListCell *intersectWithSortedLists(stringListCell *a,
-		stringListCell *b, bool withvalue, bool changed);
-static stringListCell *setDifferenceWithSortedLists(stringListCell *a,
-		stringListCell *b, bool withvalue);
+/* table that receives object names loaded by this thread */
+static PGQ_THREAD_LOCAL PQLNameTable *currentnames = NULL;
+
+
+static int compareOptions(const void *a, const void *b);
+static bool equalOptions(PQLOption *a, PQLOption *b);
+static PQLOptionSet *copyOptionSet(PQLOption **items, int n, bool withvalue);
+static int compareInternedNames(const char *a, const char *b);
+static uint32 hashName(const char *s);
+static void growNameTable(PQLNameTable *t);
+static int compareNameEntries(const void *a, const void *b);
+static PGresult **execQueryList(PGconn *c, char **queries, int n, bool cached);
+static void *arenaReserve(PQLArena *a, size_t size, bool aligned);
+static void logJSON(enum PQLLogLevel level, const char *msg);
+
+/*
+ * Write a JSON log line: timestamp (UTC, milliseconds), level and message.
+ * The line is built in memory and written at once so lines from different
+ * threads are not interleaved.
+ */
+static void
+logJSON(enum PQLLogLevel level, const char *msg)
+{
+	char		line[4096];
+	char		ts[32];
+	size_t		len;
+	const char	*p;
+#if defined(_WINDOWS)
+	SYSTEMTIME	st;
+
+	GetSystemTime(&st);
+	snprintf(ts, sizeof(ts), "%04d-%02d-%02dT%02d:%02d:%02d.%03dZ",
+			 st.wYear, st.wMonth, st.wDay, st.wHour, st.wMinute, st.wSecond,
+			 st.wMilliseconds);
+#else
+	struct timeval	tv;
+	struct tm		tm;
+
+	gettimeofday(&tv, NULL);
+	gmtime_r(&tv.tv_sec, &tm);
+	len = strftime(ts, sizeof(ts), "%Y-%m-%dT%H:%M:%S", &tm);
+	snprintf(ts + len, sizeof(ts) - len, ".%03dZ", (int) (tv.tv_usec / 1000));
+#endif
+
+	len = snprintf(line, sizeof(line), "{\"ts\":\"%s\",\"level\":\"%s\",\"msg\":\"",
+				   ts, logLevelTag[level]);
+
+	/* escape the message; leave room for the longest escape and the end */
+	for (p = msg; *p && len < sizeof(line) - 10; p++)
+	{
+		unsigned char	c = (unsigned char) *p;
+
+		if (c == '"' || c == '\\')
+		{
+			line[len++] = '\\';
+			line[len++] = c;
+		}
+		else if (c == '\n')
+		{
+			line[len++] = '\\';
+			line[len++] = 'n';
+		}
+		else if (c == '\t')
+		{
+			line[len++] = '\\';
+			line[len++] = 't';
+		}
+		else if (c < 0x20)
+			len += snprintf(line + len, sizeof(line) - len, "\\u%04x", c);
+		else
+			line[len++] = c;
+	}
+	line[len++] = '"';
+	line[len++] = '}';
+	line[len++] = '\n';
+	line[len] = '\0';
+
+	fputs(line, stderr);
+}
 
 void
 logGeneric(enum PQLLogLevel level, const char *fmt, ...)
@@ -53,24 +119,50 @@ logGeneric(enum PQLLogLevel level, const char *fmt, ...)
 	char		buf[2048];
 	va_list		ap;
 
+	/* the log macros already checked it but direct callers might not */
+	if (level > loglevel)
+		return;
+
 	va_start(ap, fmt);
 	vsnprintf(buf, sizeof(buf), fmt, ap);
 	va_end(ap);
 
-	if (level <= loglevel)
+	if (logformat == PGQ_LOG_JSON)
+		logJSON(level, buf);
+	else
 		fprintf(stderr, "%s %s\n", logLevelTag[level], buf);
 }
 
+/*
+ * Compare interned names (see internName). Equal names are the same string.
+ * Names interned after the last sortNameTable do not have an ordinal yet.
+ */
+static int
+compareInternedNames(const char *a, const char *b)
+{
+	uint32	x, y;
+
+	if (a == b)
+		return 0;
+
+	x = ((const PQLName *) (a - offsetof(PQLName, str)))->ordinal;
+	y = ((const PQLName *) (b - offsetof(PQLName, str)))->ordinal;
+	if (x == PGQ_NAME_UNSORTED || y == PGQ_NAME_UNSORTED)
+		return strcmp(a, b);
+
+	return (x < y) ? -1 : 1;
+}
+
 int
 compareRelations(PQLObject *a, PQLObject *b)
 {
 	int		c;
 
-	c = strcmp(a->schemaname, b->schemaname);
+	c = compareInternedNames(a->schemaname, b->schemaname);
 
 	/* compare relation names iif schema names are equal */
 	if (c == 0)
-		c = strcmp(a->objectname, b->objectname);
+		c = compareInternedNames(a->objectname, b->objectname);
 
 	return c;
 }
@@ -80,13 +172,13 @@ compareNamesAndRelations(PQLObject *a, PQLObject *b, char *aname, char *bname)
 {
 	int		c;
 
-	c = strcmp(a->schemaname, b->schemaname);
+	c = compareInternedNames(a->schemaname, b->schemaname);
 
 	/* compare relation names iif schema names are equal */
 	if (c == 0)
 	{
 		/* compare trigger/rule names iif schema.relation names are equal */
-		c = strcmp(a->objectname, b->objectname);
+		c = compareInternedNames(a->objectname, b->objectname);
 		if (c == 0)
 			c = strcmp(aname, bname);
 	}
@@ -94,154 +186,704 @@ compareNamesAndRelations(PQLObject *a, PQLObject *b, char *aname, char *bname)
 	return c;
 }
 
-#if PG_VERSION_NUM < 90600
 /*
- * This function was copied from postgres source code because it is not
- * available in a library. This is true for version 9.5 or prior.
+ * Quote an identifier iif necessary. For quoting, consider the SQL rules and
+ * also the list of PostgreSQL keywords. Those keywords come from PostgreSQL
+ * version that pgquarrel was compiled with. Ensure that pgquarrel is compiled
+ * with the latest PostgreSQL version to ensure that we don't have problems
+ * with strings that become keywords. Returns an allocated string.
  */
-const ScanKeyword *
-ScanKeywordLookup(const char *text,
-				  const ScanKeyword *keywords,
-				  int num_keywords)
+char *
+formatObjectIdentifier(char *s)
 {
-	size_t		len;
-	int			i;
-	char		word[NAMEDATALEN];
-	const ScanKeyword *low;
-	const ScanKeyword *high;
+	char	*ret;
+	size_t	len;
 
-	len = strlen(text);
-	/* We assume all keywords are shorter than NAMEDATALEN. */
-	if (len >= NAMEDATALEN)
-		return NULL;
+	if (!identifierNeedsQuotes(s, &len))
+	{
+		/* no quotes needed */
+		ret = strdup(s);
+	}
+	else
+	{
+		ret = malloc((len + 1) * sizeof(char));
+		if (ret == NULL)
+		{
+			logError("could not allocate memory");
+			exit(EXIT_FAILURE);
+		}
 
-	/*
-	 * Apply an ASCII-only downcasing.  We must not use tolower() since it may
-	 * produce the wrong translation in some locales (eg, Turkish).
-	 */
-	for (i = 0; i < len; i++)
+		quoteIdentifier(s, ret);
+	}
+
+	return ret;
+}
+
+/*
+ * Build an oid array literal (e.g. '{16384,16390}'::oid[]) from a list of
+ * oids. It is used to fetch properties from several objects using a single
+ * query. Returns an allocated string.
+ */
+char *
+buildOidArray(Oid *oids, int n)
+{
+	char	*ret;
+	size_t	len;
+	size_t	pos = 0;
+	int		i;
+
+	/* oid has at most 10 digits plus separator; also quotes, braces and cast */
+	len = n * 11 + 16;
+	ret = (char *) malloc(len * sizeof(char));
+	if (ret == NULL)
 	{
-		char		ch = text[i];
+		logError("could not allocate memory");
+		exit(EXIT_FAILURE);
+	}
+
+	pos += snprintf(ret + pos, len - pos, "'{");
+	for (i = 0; i < n; i++)
+		pos += snprintf(ret + pos, len - pos, (i == 0) ? "%u" : ",%u", oids[i]);
+	snprintf(ret + pos, len - pos, "}'::oid[]");
+
+	return ret;
+}
 
-		if (ch >= 'A' && ch <= 'Z')
-			ch += 'a' - 'A';
-		word[i] = ch;
+#ifdef LIBPQ_HAS_PIPELINING
+/*
+ * Send queries in pipeline mode. Queries are sent in batches of
+ * PGQ_PIPELINE_DEPTH; each batch is synced and drained before the next one is
+ * sent so neither side blocks on a full socket buffer.
+ */
+static void
+execPipelinedQueries(PGconn *c, char **queries, PGresult **res, int n)
+{
+	PGresult	*sync;
+	int			i, j;
+
+	if (PQenterPipelineMode(c) != 1)
+	{
+		logError("could not enter pipeline mode: %s", PQerrorMessage(c));
+		PQfinish(c);
+		/* XXX leak another connection? */
+		exit(EXIT_FAILURE);
 	}
-	word[len] = '\0';
 
-	/*
-	 * Now do a binary search using plain strcmp() comparison.
-	 */
-	low = keywords;
-	high = keywords + (num_keywords - 1);
-	while (low <= high)
+	for (i = 0; i < n; i += PGQ_PIPELINE_DEPTH)
 	{
-		const ScanKeyword *middle;
-		int			difference;
+		int		end = (i + PGQ_PIPELINE_DEPTH < n) ? i + PGQ_PIPELINE_DEPTH : n;
 
-		middle = low + (high - low) / 2;
-		difference = strcmp(middle->name, word);
-		if (difference == 0)
-			return middle;
-		else if (difference < 0)
-			low = middle + 1;
-		else
-			high = middle - 1;
+		for (j = i; j < end; j++)
+		{
+			if (PQsendQueryParams(c, queries[j], 0, NULL, NULL, NULL, NULL, 0) != 1)
+			{
+				logError("could not send query: %s", PQerrorMessage(c));
+				PQfinish(c);
+				/* XXX leak another connection? */
+				exit(EXIT_FAILURE);
+			}
+		}
+
+		if (PQpipelineSync(c) != 1)
+		{
+			logError("could not send pipeline sync: %s", PQerrorMessage(c));
+			PQfinish(c);
+			/* XXX leak another connection? */
+			exit(EXIT_FAILURE);
+		}
+
+		for (j = i; j < end; j++)
+		{
+			res[j] = PQgetResult(c);
+			if (PQresultStatus(res[j]) != PGRES_TUPLES_OK)
+			{
+				logError("query failed: %s", PQresultErrorMessage(res[j]));
+				PQclear(res[j]);
+				PQfinish(c);
+				/* XXX leak another connection? */
+				exit(EXIT_FAILURE);
+			}
+
+			recordCatalogResult(c, queries[j], res[j]);
+
+			/* each query result is terminated by a NULL */
+			if (PQgetResult(c) != NULL)
+			{
+				logError("unexpected result in pipeline mode");
+				PQfinish(c);
+				/* XXX leak another connection? */
+				exit(EXIT_FAILURE);
+			}
+		}
+
+		sync = PQgetResult(c);
+		if (PQresultStatus(sync) != PGRES_PIPELINE_SYNC)
+		{
+			logError("unexpected result in pipeline mode: %s", PQresultErrorMessage(sync));
+			PQclear(sync);
+			PQfinish(c);
+			/* XXX leak another connection? */
+			exit(EXIT_FAILURE);
+		}
+		PQclear(sync);
 	}
 
-	return NULL;
+	if (PQexitPipelineMode(c) != 1)
+	{
+		logError("could not exit pipeline mode: %s", PQerrorMessage(c));
+		PQfinish(c);
+		/* XXX leak another connection? */
+		exit(EXIT_FAILURE);
+	}
 }
-#endif		/* <= 9.5 */
+#endif
 
 /*
- * Quote an identifier iif necessary. For quoting, consider the SQL rules and
- * also the list of PostgreSQL keywords. Those keywords come from PostgreSQL
- * version that pgquarrel was compiled with. Ensure that pgquarrel is compiled
- * with the latest PostgreSQL version to ensure that we don't have problems
- * with strings that become keywords. Returns an allocated string.
+ * Execute 'n' queries and return their results in the same order. Every
+ * query must return tuples; otherwise, it is a fatal error. Query strings
+ * (allocated by psprintf) and the query array are released.
+ *
+ * If --pipeline is set and both libpq and server support it (14 or later),
+ * queries are sent using pipeline mode. Hence, we wait for one round trip per
+ * batch instead of one per query.
  */
-char *
-formatObjectIdentifier(char *s)
+PGresult **
+execQueries(PGconn *c, char **queries, int n)
 {
-	bool	need_quotes = false;
+	return execQueryList(c, queries, n, true);
+}
 
-	char	*p;
-	char	*ret;
-	int		i = 0;
+/*
+ * Same as execQueries but a catalog cache sends the queries to the server
+ * (see execServerQuery).
+ */
+PGresult **
+execServerQueries(PGconn *c, char **queries, int n)
+{
+	return execQueryList(c, queries, n, false);
+}
 
-	/* different rule for first character */
-	if (!((s[0] >= 'a' && s[0] <= 'z') || s[0] == '_'))
-		need_quotes = true;
+static PGresult **
+execQueryList(PGconn *c, char **queries, int n, bool cached)
+{
+	PGresult	**res;
+	int			i;
+
+	res = (PGresult **) malloc(n * sizeof(PGresult *));
+	if (res == NULL)
+	{
+		logError("could not allocate memory");
+		exit(EXIT_FAILURE);
+	}
+
+#ifdef LIBPQ_HAS_PIPELINING
+	if (options.pipeline && !isCatalogFile(c) && PQserverVersion(c) >= 140000)
+	{
+		logDebug("sending %d queries in pipeline mode", n);
+		execPipelinedQueries(c, queries, res, n);
+	}
 	else
+#endif
 	{
-		/* otherwise check the entire string */
-		for (p = s; *p; p++)
+		for (i = 0; i < n; i++)
 		{
-			if (!((*p >= 'a' && *p <= 'z')
-					|| (*p >= '0' && *p <= '9')
-					|| (*p == '_')))
+			if (cached)
+				res[i] = execQuery(c, queries[i]);
+			else
+				res[i] = execServerQuery(c, queries[i]);
+			if (PQresultStatus(res[i]) != PGRES_TUPLES_OK)
 			{
-				need_quotes = true;
-				break;
+				logError("query failed: %s", PQresultErrorMessage(res[i]));
+				PQclear(res[i]);
+				PQfinish(c);
+				/* XXX leak another connection? */
+				exit(EXIT_FAILURE);
 			}
 		}
 	}
 
-	if (!need_quotes)
+	for (i = 0; i < n; i++)
+		pfree(queries[i]);
+	free(queries);
+
+	return res;
+}
+
+/*
+ * Execute a catalog query. If 'c' is a catalog file, the result is read from
+ * it. If 'c' is being dumped into a catalog file, the result is recorded.
+ */
+PGresult *
+execQuery(PGconn *c, const char *query)
+{
+	PGresult	*res;
+
+	if (isCatalogFile(c))
+		return readCatalogResult(c, query, true);
+
+	res = PQexec(c, query);
+	recordCatalogResult(c, query, res);
+
+	return res;
+}
+
+/*
+ * Same as execQuery but a catalog cache always sends the query to the server.
+ * It is used by queries whose results are not covered by the catalog change
+ * markers (see buildFingerprintQuery). A catalog file without a server
+ * returns the recorded result.
+ */
+PGresult *
+execServerQuery(PGconn *c, const char *query)
+{
+	PGresult	*res;
+
+	if (isCatalogFile(c))
+		return readCatalogResult(c, query, false);
+
+	res = PQexec(c, query);
+	recordCatalogResult(c, query, res);
+
+	return res;
+}
+
+int
+getServerVersion(PGconn *c)
+{
+	if (isCatalogFile(c))
+		return getCatalogServerVersion(c);
+
+	return PQserverVersion(c);
+}
+
+const char *
+getServerVersionString(PGconn *c)
+{
+	if (isCatalogFile(c))
+		return getCatalogServerVersionString(c);
+
+	return PQparameterStatus(c, "server_version");
+}
+
+/*
+ * Same as PQescapeLiteral but it also works for catalog files. The result is
+ * allocated in the current arena. A catalog file does not know the server
+ * encoding so the string is not validated; it was already returned by the
+ * server.
+ */
+char *
+escapeLiteral(PGconn *c, const char *str, size_t len)
+{
+	char		*ret;
+	char		*p;
+	size_t		i;
+	int			nquotes = 0;
+	int			nbackslashes = 0;
+
+	if (!isCatalogFile(c))
 	{
-#if PG_VERSION_NUM >= 120000
-		int kwnum = ScanKeywordLookup(s, &ScanKeywords);
+		char	*tmp;
 
-		if (kwnum >= 0 && ScanKeywordCategories[kwnum] != UNRESERVED_KEYWORD)
-			need_quotes = true;
-#elif PG_VERSION_NUM >= 90600
-		const ScanKeyword *keyword = ScanKeywordLookup(s,
-									 ScanKeywords,
-									 NumScanKeywords);
+		tmp = PQescapeLiteral(c, str, len);
+		if (tmp == NULL)
+			return NULL;
+		ret = arenaStrdup(tmp);
+		PQfreemem(tmp);
 
-		if (keyword != NULL && keyword->category != UNRESERVED_KEYWORD)
-			need_quotes = true;
-#else
-		const ScanKeyword *keyword = ScanKeywordLookup(s,
-									 PQLScanKeywords,
-									 NumPQLScanKeywords);
+		return ret;
+	}
 
-		if (keyword != NULL && keyword->category != UNRESERVED_KEYWORD)
-			need_quotes = true;
-#endif
+	/* same as PQescapeLiteral */
+	for (i = 0; i < len && str[i] != '\0'; i++)
+	{
+		if (str[i] == '\'')
+			nquotes++;
+		else if (str[i] == '\\')
+			nbackslashes++;
 	}
 
-	if (!need_quotes)
+	ret = p = (char *) arenaAlloc(i + nquotes + nbackslashes + 5);
+
+	if (nbackslashes > 0)
 	{
-		/* no quotes needed */
-		ret = strdup(s);
+		*p++ = ' ';
+		*p++ = 'E';
 	}
-	else
+	*p++ = '\'';
+	for (len = i, i = 0; i < len; i++)
 	{
-		/*
-		 * Maximum length for identifiers is NAMEDATALEN (64 bytes by default
-		 * including trailing zero byte).
-		 * */
-		ret = malloc(NAMEDATALEN * sizeof(char));
-		if (ret == NULL)
+		if (str[i] == '\'' || str[i] == '\\')
+			*p++ = str[i];
+		*p++ = str[i];
+	}
+	*p++ = '\'';
+	*p = '\0';
+
+	return ret;
+}
+
+/*
+ * Catalog objects loaded by this thread (see arenaAlloc) belong to arena 'a'
+ * until another arena is set.
+ */
+void
+setCurrentArena(PQLArena *a)
+{
+	currentarena = a;
+}
+
+/*
+ * Reserve 'size' bytes in arena 'a'. A new block is allocated if the current
+ * one is full; each new block is twice as large as the previous one (up to
+ * PGQ_ARENA_MAX_BLOCK_SIZE) so a large catalog needs only a few blocks.
+ * Strings are not aligned so they are packed together.
+ */
+static void *
+arenaReserve(PQLArena *a, size_t size, bool aligned)
+{
+	PQLArenaBlock	*b;
+	size_t			start;
+
+	b = a->blocks;
+	start = (b == NULL) ? 0 : b->used;
+	if (aligned)
+		start = MAXALIGN(start);
+
+	if (b == NULL || start + size > b->size)
+	{
+		PQLArenaBlock	*nb;
+		size_t			blksize;
+
+		if (b == NULL)
+			blksize = PGQ_ARENA_BLOCK_SIZE;
+		else if (b->size < PGQ_ARENA_MAX_BLOCK_SIZE)
+			blksize = b->size * 2;
+		else
+			blksize = PGQ_ARENA_MAX_BLOCK_SIZE;
+		if (blksize < size)
+			blksize = size;
+
+		nb = (PQLArenaBlock *) malloc(MAXALIGN(sizeof(PQLArenaBlock)) + blksize);
+		if (nb == NULL)
 		{
 			logError("could not allocate memory");
 			exit(EXIT_FAILURE);
 		}
+		nb->size = blksize;
+		nb->used = 0;
+		nb->next = b;
+		a->blocks = b = nb;
+		start = 0;
+	}
+
+	b->used = start + size;
+
+	return (char *) b + MAXALIGN(sizeof(PQLArenaBlock)) + start;
+}
+
+/*
+ * Allocate memory for a catalog object in the current arena. It must not be
+ * freed; it is released by resetArena.
+ */
+void *
+arenaAlloc(size_t size)
+{
+	if (currentarena == NULL)
+	{
+		logError("no memory arena for catalog objects");
+		exit(EXIT_FAILURE);
+	}
+
+	return arenaReserve(currentarena, size, true);
+}
+
+char *
+arenaStrdup(const char *s)
+{
+	size_t	len = strlen(s) + 1;
+	char	*ret;
+
+	if (currentarena == NULL)
+	{
+		logError("no memory arena for catalog objects");
+		exit(EXIT_FAILURE);
+	}
+
+	ret = (char *) arenaReserve(currentarena, len, false);
+	memcpy(ret, s, len);
+
+	return ret;
+}
+
+/*
+ * Release all objects of arena 'a'. The newest block (the largest one) is
+ * kept for the next objects.
+ */
+void
+resetArena(PQLArena *a)
+{
+	PQLArenaBlock	*b;
+
+	if (a->blocks == NULL)
+		return;
 
-		ret[i++] = '\"';
-		for (p = s; *p; p++)
+	b = a->blocks->next;
+	while (b != NULL)
+	{
+		PQLArenaBlock	*next = b->next;
+
+		free(b);
+		b = next;
+	}
+
+	a->blocks->next = NULL;
+	a->blocks->used = 0;
+}
+
+void
+freeArena(PQLArena *a)
+{
+	resetArena(a);
+	if (a->blocks != NULL)
+		free(a->blocks);
+	a->blocks = NULL;
+}
+
+void
+initNameTable(PQLNameTable *t)
+{
+	if (t->initialized)
+		return;
+
+	t->nbuckets = 1024;
+	t->buckets = (PQLName **) calloc(t->nbuckets, sizeof(PQLName *));
+	t->maxnames = t->nbuckets / 2;
+	t->names = (PQLName **) malloc(t->maxnames * sizeof(PQLName *));
+	if (t->buckets == NULL || t->names == NULL)
+	{
+		logError("could not allocate memory");
+		exit(EXIT_FAILURE);
+	}
+	t->nnames = t->nsorted = 0;
+	t->storage.blocks = NULL;
+#if defined(_WINDOWS)
+	InitializeCriticalSection(&t->lock);
+#else
+	pthread_mutex_init(&t->lock, NULL);
+#endif
+	t->initialized = true;
+}
+
+/*
+ * Object names loaded by this thread (see internName) belong to table 't'
+ * until another table is set.
+ */
+void
+setCurrentNameTable(PQLNameTable *t)
+{
+	currentnames = t;
+}
+
+/* FNV-1a */
+static uint32
+hashName(const char *s)
+{
+	uint32	h = 2166136261U;
+
+	while (*s != '\0')
+	{
+		h ^= (unsigned char) *s++;
+		h *= 16777619U;
+	}
+
+	return h;
+}
+
+/*
+ * Double the number of buckets. It is called with the table lock held.
+ */
+static void
+growNameTable(PQLNameTable *t)
+{
+	PQLName		**buckets;
+	uint32		nbuckets = t->nbuckets * 2;
+	uint32		i;
+
+	buckets = (PQLName **) calloc(nbuckets, sizeof(PQLName *));
+	t->names = (PQLName **) realloc(t->names, (nbuckets / 2) * sizeof(PQLName *));
+	if (buckets == NULL || t->names == NULL)
+	{
+		logError("could not allocate memory");
+		exit(EXIT_FAILURE);
+	}
+
+	for (i = 0; i < t->nnames; i++)
+	{
+		uint32	j = t->names[i]->hash & (nbuckets - 1);
+
+		while (buckets[j] != NULL)
+			j = (j + 1) & (nbuckets - 1);
+		buckets[j] = t->names[i];
+	}
+
+	free(t->buckets);
+	t->buckets = buckets;
+	t->nbuckets = nbuckets;
+	t->maxnames = nbuckets / 2;
+}
+
+/*
+ * Return the interned copy of name 's' from the current name table. Both
+ * servers are fetched at the same time so the table is protected by a lock.
+ * The returned string must not be modified or freed.
+ */
+char *
+internName(const char *s)
+{
+	PQLNameTable	*t = currentnames;
+	PQLName			*n;
+	uint32			h;
+	uint32			i;
+	size_t			len;
+
+	if (t == NULL)
+	{
+		logError("no name table for catalog objects");
+		exit(EXIT_FAILURE);
+	}
+
+	h = hashName(s);
+
+#if defined(_WINDOWS)
+	EnterCriticalSection(&t->lock);
+#else
+	pthread_mutex_lock(&t->lock);
+#endif
+
+	for (i = h & (t->nbuckets - 1); t->buckets[i] != NULL;
+			i = (i + 1) & (t->nbuckets - 1))
+	{
+		n = t->buckets[i];
+		if (n->hash == h && strcmp(n->str, s) == 0)
 		{
-			/* per SQL99, if quote is found, add another quote */
-			if (*p == '\"')
-				ret[i++] = '\"';
-			ret[i++] = *p;
+#if defined(_WINDOWS)
+			LeaveCriticalSection(&t->lock);
+#else
+			pthread_mutex_unlock(&t->lock);
+#endif
+			return n->str;
 		}
-		ret[i++] = '\"';
-		ret[i] = '\0';
 	}
 
-	return ret;
+	len = strlen(s);
+	n = (PQLName *) arenaReserve(&t->storage, offsetof(PQLName, str) + len + 1,
+								 true);
+	n->ordinal = PGQ_NAME_UNSORTED;
+	n->hash = h;
+	memcpy(n->str, s, len + 1);
+	if (identifierNeedsQuotes(s, &len))
+	{
+		n->quoted = (char *) arenaReserve(&t->storage, len + 1, false);
+		quoteIdentifier(s, n->quoted);
+	}
+	else
+		n->quoted = n->str;
+
+	t->buckets[i] = n;
+	t->names[t->nnames++] = n;
+	if (t->nnames >= t->maxnames)
+		growNameTable(t);
+
+#if defined(_WINDOWS)
+	LeaveCriticalSection(&t->lock);
+#else
+	pthread_mutex_unlock(&t->lock);
+#endif
+
+	return n->str;
+}
+
+/*
+ * Same as formatObjectIdentifier but for interned names (see internName). The
+ * quoted form was computed when the name was interned; it must not be
+ * modified or freed.
+ */
+char *
+quotedName(const char *s)
+{
+	return ((const PQLName *) (s - offsetof(PQLName, str)))->quoted;
+}
+
+static int
+compareNameEntries(const void *a, const void *b)
+{
+	return strcmp((*(PQLName **) a)->str, (*(PQLName **) b)->str);
+}
+
+/*
+ * Assign ordinals to names interned after the last call. New names are sorted
+ * and merged with the names that were already sorted. It must not run while
+ * another thread is interning names into 't'.
+ */
+void
+sortNameTable(PQLNameTable *t)
+{
+	PQLName		**merged;
+	uint32		i, j, k;
+
+	if (t->nsorted == t->nnames)
+		return;
+
+	qsort(t->names + t->nsorted, t->nnames - t->nsorted, sizeof(PQLName *),
+		  compareNameEntries);
+
+	merged = (PQLName **) malloc(t->nnames * sizeof(PQLName *));
+	if (merged == NULL)
+	{
+		logError("could not allocate memory");
+		exit(EXIT_FAILURE);
+	}
+
+	i = 0;
+	j = t->nsorted;
+	k = 0;
+	while (i < t->nsorted && j < t->nnames)
+	{
+		if (strcmp(t->names[i]->str, t->names[j]->str) < 0)
+			merged[k++] = t->names[i++];
+		else
+			merged[k++] = t->names[j++];
+	}
+	while (i < t->nsorted)
+		merged[k++] = t->names[i++];
+	while (j < t->nnames)
+		merged[k++] = t->names[j++];
+
+	for (k = 0; k < t->nnames; k++)
+	{
+		merged[k]->ordinal = k;
+		t->names[k] = merged[k];
+	}
+	t->nsorted = t->nnames;
+
+	free(merged);
+}
+
+void
+freeNameTable(PQLNameTable *t)
+{
+	if (!t->initialized)
+		return;
+
+	freeArena(&t->storage);
+	free(t->buckets);
+	free(t->names);
+#if defined(_WINDOWS)
+	DeleteCriticalSection(&t->lock);
+#else
+	pthread_mutex_destroy(&t->lock);
+#endif
+	t->initialized = false;
 }
 
 void
@@ -249,7 +891,7 @@ appendStringList(stringList *sl, const char *s)
 {
 	stringListCell	*cell;
 
-	cell = (stringListCell *) malloc(strlen(s) + 1);
+	cell = (stringListCell *) malloc(sizeof(stringListCell));
 
 	cell->next = NULL;
 	cell->value = strdup(s);
@@ -320,261 +962,182 @@ freeStringList(stringList *sl)
 	free(sl);
 }
 
+static int
+compareOptions(const void *a, const void *b)
+{
+	const PQLOption	*x = (const PQLOption *) a;
+	const PQLOption	*y = (const PQLOption *) b;
+	int				r;
+
+	r = strcmp(x->key, y->key);
+	if (r != 0)
+		return r;
+
+	/* same key: an option without value first */
+	if (x->value == NULL || y->value == NULL)
+		return (x->value != NULL) - (y->value != NULL);
+
+	return strcmp(x->value, y->value);
+}
+
+static bool
+equalOptions(PQLOption *a, PQLOption *b)
+{
+	if (a->value == NULL || b->value == NULL)
+		return (a->value == b->value);
+
+	return (strcmp(a->value, b->value) == 0);
+}
+
 /*
- * Build an ordered linked list from a comma-separated string. If there is no
- * options return NULL.
+ * Build a set from a comma-separated string of options (key or key=value).
+ * The string is copied once and split in place; each item points to its key
+ * and value. If there are no options, the set is empty.
  */
-stringList *
-buildStringList(char *options)
+PQLOptionSet *
+buildOptionSet(const char *options)
 {
-	stringList		*sl;
-	stringListCell	*x;
-	char			*tmp;
-	char			*p;
-
+	PQLOptionSet	*s;
+	const char		*p;
 	char			*item;
 	char			*nextitem;
+	int				n;
 
-	sl = (stringList *) malloc(sizeof(stringList));
-	sl->head = sl->tail = NULL;
+	s = (PQLOptionSet *) malloc(sizeof(PQLOptionSet));
+	if (s == NULL)
+	{
+		logError("could not allocate memory");
+		exit(EXIT_FAILURE);
+	}
+	s->data = NULL;
+	s->items = NULL;
+	s->nitems = 0;
 
 	/* no options, bail out */
 	if (options == NULL)
 	{
 		logDebug("options is empty");
-		return sl;
+		return s;
 	}
 
-	tmp = strdup(options);
-	p = tmp;
+	/* one item per comma */
+	n = 1;
+	for (p = options; *p; p++)
+	{
+		if (*p == ',')
+			n++;
+	}
+
+	s->data = strdup(options);
+	s->items = (PQLOption *) malloc(n * sizeof(PQLOption));
+	if (s->data == NULL || s->items == NULL)
+	{
+		logError("could not allocate memory");
+		exit(EXIT_FAILURE);
+	}
 
-	for (item = p; item; item = nextitem)
+	for (item = s->data; item; item = nextitem)
 	{
-		stringListCell	*sc;
+		char	*value;
 
 		nextitem = strchr(item, ',');
 		if (nextitem)
 			*nextitem++ = '\0';
 
 		/* left trim */
-		while (isspace(*item))
+		while (isspace((unsigned char) *item))
 			item++;
 
-		sc = (stringListCell *) malloc(sizeof(stringListCell));
-		sc->value = strdup(item);
-		sc->next = NULL;
+		value = strchr(item, '=');
+		if (value)
+			*value++ = '\0';
 
-		logNoise("option: \"%s\"", item);
-
-		/* add stringListCell to stringList in order */
-		if (sl->tail)
-		{
-			stringListCell	*cur = sl->head;
+		s->items[s->nitems].key = item;
+		s->items[s->nitems].value = value;
+		s->nitems++;
 
-			if (strcmp(cur->value, sc->value) > 0)
-			{
-				sc->next = cur;
-				sl->head = sc;
-			}
-			else
-			{
-				while (cur != NULL)
-				{
-					if (cur == sl->tail)
-					{
-						cur->next = sc;
-						sl->tail = sc;
-						break;
-					}
-
-					if (strcmp(cur->value, sc->value) < 0 &&
-							strcmp(cur->next->value, sc->value) >= 0)
-					{
-						sc->next = cur->next;
-						cur->next = sc;
-						break;
-					}
-
-					cur = cur->next;
-				}
-			}
-		}
-		else
-		{
-			sl->head = sc;
-			sl->tail = sc;
-		}
+		logNoise("option: \"%s\"", item);
 	}
 
-	/* check the order */
-	for (x = sl->head; x; x = x->next)
-		logNoise("options in order: \"%s\"", x->value);
-
-	free(tmp);
+	qsort(s->items, s->nitems, sizeof(PQLOption), compareOptions);
 
-	return sl;
+	return s;
 }
 
 /*
- * Return a linked list of stringListCell that contains elements from 'a' that
- * is also in 'b'. If 'withvalue' is true, then strings are built with values
- * from 'b' else the list will contain only the options.
+ * Build a set that owns a copy of the n items. If 'withvalue' is false, only
+ * keys are copied.
  */
-static stringListCell *
-intersectWithSortedLists(stringListCell *a, stringListCell *b, bool withvalue,
-						 bool changed)
+static PQLOptionSet *
+copyOptionSet(PQLOption **items, int n, bool withvalue)
 {
-	stringListCell	*t;
-	char			*c, *d;
-	char			*tmpa, *tmpb;
-
-	/* end of linked list */
-	if (a == NULL || b == NULL)
-		return NULL;
-
-	/*
-	 * If same option and value, call recursively incrementing both lists. We
-	 * don't want to include option that doesn't change the value unless
-	 * 'changed' is false.
-	 */
-	if (changed && strcmp(a->value, b->value) == 0)
-		return intersectWithSortedLists(a->next, b->next, withvalue, changed);
-
-	/* both string lists are not NULL */
-	tmpa = strdup(a->value);
-	tmpb = strdup(b->value);
-	c = strtok(tmpa, "=");
-	d = strtok(tmpb, "=");
+	PQLOptionSet	*s;
+	size_t			len = 0;
+	char			*p;
+	int				i;
 
-	/* advance "smaller" string list and call recursively */
-	if (strcmp(c, d) < 0)
+	for (i = 0; i < n; i++)
 	{
-		/* avoid leaking temporary variables */
-		free(tmpa);
-		free(tmpb);
-
-		return intersectWithSortedLists(a->next, b, withvalue, changed);
+		len += strlen(items[i]->key) + 1;
+		if (withvalue && items[i]->value)
+			len += strlen(items[i]->value) + 1;
 	}
 
-	if (strcmp(c, d) > 0)
+	s = (PQLOptionSet *) malloc(sizeof(PQLOptionSet));
+	if (s == NULL)
 	{
-		/* avoid leaking temporary variables */
-		free(tmpa);
-		free(tmpb);
-
-		return intersectWithSortedLists(a, b->next, withvalue, changed);
+		logError("could not allocate memory");
+		exit(EXIT_FAILURE);
 	}
-
-	/*
-	 * If both options/values are equal, add it only if 'changed' is false.
-	 * Same option and different values, add it.
-	 */
-	t = (stringListCell *) malloc(sizeof(stringListCell));
-	if (withvalue)
-		t->value = strdup(b->value);
-	else
-		t->value = strdup(d);
-
-	/* avoid leaking temporary variables */
-	free(tmpa);
-	free(tmpb);
-
-	/* advance both string lists and call recursively */
-	t->next = intersectWithSortedLists(a->next, b->next, withvalue, changed);
-
-	return t;
-}
-
-/*
- * Given two sorted linked lists (A, B), produce another linked list that is
- * the result of 'A minus B' i.e. elements that are only presented in A. If
- * there aren't elements, return NULL.
- */
-static stringListCell *
-setDifferenceWithSortedLists(stringListCell *a, stringListCell *b,
-							 bool withvalue)
-{
-	stringListCell	*t;
-	char			*c, *d;
-	char			*tmpa, *tmpb;
-
-	/* end of list */
-	if (a == NULL)
-		return NULL;
-
-	/* latter list is NULL then transverse former list and build a linked list */
-	if (b == NULL)
+	s->data = (char *) malloc(len);
+	s->items = (PQLOption *) malloc(n * sizeof(PQLOption));
+	if (s->data == NULL || s->items == NULL)
 	{
-		t = (stringListCell *) malloc(sizeof(stringListCell));
-
-		if (withvalue)
-			t->value = strdup(a->value);
-		else
-		{
-			/* use a temporary variable because strtok() "destroy" the original string */
-			tmpa = strdup(a->value);
-			c = strtok(tmpa, "=");
-			t->value = strdup(c);
-			free(tmpa);
-		}
-
-		t->next = setDifferenceWithSortedLists(a->next, b, withvalue);
-
-		return t;
+		logError("could not allocate memory");
+		exit(EXIT_FAILURE);
 	}
+	s->nitems = n;
 
-	/* both string list are not NULL */
-	tmpa = strdup(a->value);
-	tmpb = strdup(b->value);
-	c = strtok(tmpa, "=");
-	d = strtok(tmpb, "=");
-
-	/* advance latter list and call recursively */
-	if (strcmp(c, d) > 0)
+	p = s->data;
+	for (i = 0; i < n; i++)
 	{
-		/* avoid leaking temporary variables */
-		free(tmpa);
-		free(tmpb);
+		s->items[i].key = p;
+		strcpy(p, items[i]->key);
+		p += strlen(p) + 1;
 
-		return setDifferenceWithSortedLists(a, b->next, withvalue);
-	}
-
-	/* advance both string lists and call recursively */
-	if (strcmp(c, d) == 0)
-	{
-		/* avoid leaking temporary variables */
-		free(tmpa);
-		free(tmpb);
-
-		return setDifferenceWithSortedLists(a->next, b->next, withvalue);
+		if (withvalue && items[i]->value)
+		{
+			s->items[i].value = p;
+			strcpy(p, items[i]->value);
+			p += strlen(p) + 1;
+		}
+		else
+			s->items[i].value = NULL;
 	}
 
-	/* executed only if A value is not in B */
-	t = (stringListCell *) malloc(sizeof(stringListCell));
-	if (withvalue)
-		t->value = strdup(a->value);
-	else
-		t->value = strdup(c);
-
-	/* avoid leaking temporary variables */
-	free(tmpa);
-	free(tmpb);
-
-	t->next = setDifferenceWithSortedLists(a->next, b, withvalue);
-
-	return t;
+	return s;
 }
 
 /*
- * Return a linked list that contains elements according to specified set
- * operation (setop). If there aren't options, return NULL.
+ * Return a set that contains options according to specified set operation
+ * (setop). Both sets are sorted by key so they are merged in one pass.
+ *
+ * PGQ_INTERSECT: options of 'b' whose keys are also in 'a'. If 'changed' is
+ * true, options that have the same value in both sets are excluded.
+ * PGQ_SETDIFFERENCE: options of 'a' whose keys are not in 'b'.
+ *
+ * If 'withvalue' is true, values are kept else the set will contain only the
+ * keys. If there aren't options, return NULL.
  */
-stringList *
-setOperationOptions(char *a, char *b, int setop, bool withvalue, bool changed)
+PQLOptionSet *
+setOperationOptions(const char *a, const char *b, int setop, bool withvalue,
+					bool changed)
 {
-	stringList		*first, *second;
-	stringList		*ret = NULL;
-	stringListCell	*headitem = NULL;
+	PQLOptionSet	*first, *second;
+	PQLOptionSet	*ret = NULL;
+	PQLOption		**items;
+	int				n = 0;
+	int				i, j;
 
 	logNoise("options: set operation %d", setop);
 
@@ -586,107 +1149,124 @@ setOperationOptions(char *a, char *b, int setop, bool withvalue, bool changed)
 	if (setop == PGQ_INTERSECT && b == NULL)
 		return NULL;
 
-	first = buildStringList(a);
-	second = buildStringList(b);
+	first = buildOptionSet(a);
+	second = buildOptionSet(b);
 
-	if (setop == PGQ_INTERSECT)
-		headitem = intersectWithSortedLists(first->head, second->head, withvalue,
-											changed);
-	else if (setop == PGQ_SETDIFFERENCE)
-		headitem = setDifferenceWithSortedLists(first->head, second->head, withvalue);
-	else
-		logError("set operation not supported");
+	/* the result is at most as large as the first set */
+	items = (PQLOption **) malloc((first->nitems + 1) * sizeof(PQLOption *));
+	if (items == NULL)
+	{
+		logError("could not allocate memory");
+		exit(EXIT_FAILURE);
+	}
 
-	/* build a linked list */
-	if (headitem)
+	i = j = 0;
+	if (setop == PGQ_INTERSECT)
 	{
-		stringListCell	*p;
+		while (i < first->nitems && j < second->nitems)
+		{
+			int		r = strcmp(first->items[i].key, second->items[j].key);
 
-		ret = (stringList *) malloc(sizeof(stringList));
+			if (r < 0)
+				i++;
+			else if (r > 0)
+				j++;
+			else
+			{
+				if (!changed || !equalOptions(&first->items[i], &second->items[j]))
+					items[n++] = &second->items[j];
+				i++;
+				j++;
+			}
+		}
+	}
+	else if (setop == PGQ_SETDIFFERENCE)
+	{
+		while (i < first->nitems)
+		{
+			int		r = 1;
 
-		/* linked list head */
-		ret->head = headitem;
+			if (j < second->nitems)
+				r = strcmp(second->items[j].key, first->items[i].key);
 
-		/* find linked list tail */
-		p = headitem;
-		while (p->next)
-			p = p->next;
-		ret->tail = p;
+			if (r < 0)
+				j++;
+			else if (r == 0)
+			{
+				i++;
+				j++;
+			}
+			else
+				items[n++] = &first->items[i++];
+		}
 	}
+	else
+		logError("set operation not supported");
 
-	/* free temporary lists */
-	if (first)
-		freeStringList(first);
-	if (second)
-		freeStringList(second);
+	if (n > 0)
+		ret = copyOptionSet(items, n, withvalue);
+
+	free(items);
+	freeOptionSet(first);
+	freeOptionSet(second);
 
 	return ret;
 }
 
 /*
- * Return an allocated string that contains comma-separated options. Return
- * NULL if linked list is NULL.
+ * Return an allocated string that contains comma-separated options (e.g.
+ * 'a=10, b=20, c=30' or 'a, b, c'). Return NULL if set is NULL.
  */
 char *
-printOptions(stringList *sl)
+printOptions(PQLOptionSet *s)
 {
-	char			*list = NULL;
-	stringListCell	*p;
-	bool			firstitem = true;
-
-	if (sl)
-	{
-		size_t	listlen;
-		size_t	n = 0;
+	char	*list;
+	char	*p;
+	size_t	len = 1;
+	int		i;
 
-		/* allocate memory for at list one parameter (based on autovac parameters) */
-		listlen = 40;
-		list = (char *) malloc(listlen * sizeof(char));
+	if (s == NULL)
+		return NULL;
 
-		/* build a list like 'a=10, b=20, c=30' or 'a, b, c' */
-		for (p = sl->head; p; p = p->next)
-		{
-			size_t	newlen;
-
-			/*
-			 * String space including new option and separator. Don't forget
-			 * the null-character.
-			 */
-			newlen = n + strlen(p->value) + 2 + 1;
-			if (newlen > listlen)
-			{
-				logNoise("allocate more memory (was %d ; is %d)", listlen, newlen);
-
-				listlen = newlen;
-				list = (char *) realloc(list, listlen);
-				if (list == NULL)
-				{
-					logError("could not allocate memory");
-					exit(EXIT_FAILURE);
-				}
-			}
+	for (i = 0; i < s->nitems; i++)
+	{
+		/* separator */
+		len += strlen(s->items[i].key) + 2;
+		if (s->items[i].value)
+			len += strlen(s->items[i].value) + 1;
+	}
 
-			if (firstitem)
-				firstitem = false;
-			else
-			{
-				/*
-				 * If it is not the first item, add comma and space before it.
-				 * Copy 3 characters from destination to source, although only
-				 * 2 (comma and space) will be added to list. Don't forget the
-				 * null-character.
-				 */
-				strncpy(list + n, ", ", 3);
-				n += 2;
-			}
+	list = (char *) malloc(len);
+	if (list == NULL)
+	{
+		logError("could not allocate memory");
+		exit(EXIT_FAILURE);
+	}
 
-			strcpy(list + n, p->value);
-			n += strlen(p->value);
-		}
+	p = list;
+	*p = '\0';
+	for (i = 0; i < s->nitems; i++)
+	{
+		if (i > 0)
+			p += sprintf(p, ", ");
+		if (s->items[i].value)
+			p += sprintf(p, "%s=%s", s->items[i].key, s->items[i].value);
+		else
+			p += sprintf(p, "%s", s->items[i].key);
 	}
 
-	if (list)
-		logNoise("options: %s", list);
+	logNoise("options: %s", list);
 
 	return list;
 }
+
+void
+freeOptionSet(PQLOptionSet *s)
+{
+	if (s == NULL)
+		return;
+
+	free(s->data);
+	free(s->items);
+	free(s);
+}
@@ -17,6 +17,12 @@
 #include <c.h>			/* bool, true, false */
 #include <postgres_fe.h>
 
+#if defined(_WINDOWS)
+#include <windows.h>
+#else
+#include <pthread.h>
+#endif
+
 #if defined(_WINDOWS)
 #define	strcasecmp	_stricmp
 #define	snprintf	_snprintf
@@ -31,26 +37,55 @@
 
 #define	PGQMAXPATH			300
 
+/* variables that each worker thread has its own copy */
+#if defined(_MSC_VER)
+#define	PGQ_THREAD_LOCAL	__declspec(thread)
+#else
+#define	PGQ_THREAD_LOCAL	__thread
+#endif
+
+/* size of the first block of a memory arena and the maximum block size */
+#define	PGQ_ARENA_BLOCK_SIZE		(64 * 1024)
+#define	PGQ_ARENA_MAX_BLOCK_SIZE	(8 * 1024 * 1024)
+
+/* maximum number of queries sent before a pipeline sync */
+#define	PGQ_PIPELINE_DEPTH	100
+
+/*
+ * Check the level before calling logGeneric so arguments are neither
+ * evaluated nor formatted when the message would not be printed.
+ */
 #define logFatal(...) do { \
-	logGeneric(PGQ_FATAL, __VA_ARGS__); \
+	if (PGQ_FATAL <= loglevel) \
+		logGeneric(PGQ_FATAL, __VA_ARGS__); \
 	} while (0)
 
 #define logError(...) do { \
-	logGeneric(PGQ_ERROR, __VA_ARGS__); \
+	if (PGQ_ERROR <= loglevel) \
+		logGeneric(PGQ_ERROR, __VA_ARGS__); \
 	} while (0)
 
 #define logWarning(...) do { \
-	logGeneric(PGQ_WARNING, __VA_ARGS__); \
+	if (PGQ_WARNING <= loglevel) \
+		logGeneric(PGQ_WARNING, __VA_ARGS__); \
 	} while (0)
 
 #define logDebug(...) do { \
-	logGeneric(PGQ_DEBUG, __VA_ARGS__); \
+	if (PGQ_DEBUG <= loglevel) \
+		logGeneric(PGQ_DEBUG, __VA_ARGS__); \
 	} while (0)
 
 #define logNoise(...) do { \
-	logGeneric(PGQ_NOISE, __VA_ARGS__); \
+	if (PGQ_NOISE <= loglevel) \
+		logGeneric(PGQ_NOISE, __VA_ARGS__); \
 	} while (0)
 
+enum PQLLogFormat
+{
+	PGQ_LOG_TEXT = 0,
+	PGQ_LOG_JSON = 1		/* one JSON object per line with a timestamp */
+};
+
 typedef struct QuarrelGeneralOptions
 {
 	char			*output;
@@ -63,6 +98,17 @@ typedef struct QuarrelGeneralOptions
 	bool			privileges;
 	bool			securitylabels;
 	bool			singletxn;
+	bool			pipeline;
+	int				jobs;
+	int				statementtimeout;
+	int				locktimeout;
+	enum PQLLogFormat	logformat;
+	int				outputbuffersize;	/* KB (see PQLOutputBuffer) */
+	bool			dependencyorder;
+	bool			online;			/* avoid long locks on the target */
+	bool			annotatecost;	/* see formatCommandCost */
+	int				costthreshold;	/* MB; 0 disables */
+	bool			schemagrants;	/* see findSchemaGrants */
 
 	/* select objects */
 	bool			accessmethod;
@@ -98,6 +144,11 @@ typedef struct QuarrelGeneralOptions
 	/* filter options */
 	char			*include_schema;
 	char			*exclude_schema;
+
+	/* dump catalog into this file */
+	char			*dumpcatalog;
+	char			*cachedir;		/* catalog caches */
+	char			*paralleldir;	/* see writeOutputWaves */
 } QuarrelGeneralOptions;
 
 typedef struct QuarrelDatabaseOptions
@@ -109,13 +160,26 @@ typedef struct QuarrelDatabaseOptions
 	char			*dbname;
 	bool			istarget;
 	bool			promptpassword;
+	char			*catalog;		/* read objects from this catalog file */
 } QuarrelDatabaseOptions;
 
+/* a [target.NAME] section */
+typedef struct QuarrelTargetOptions
+{
+	char					*name;
+	char					*output;	/* default: NAME.sql */
+	QuarrelDatabaseOptions	db;
+} QuarrelTargetOptions;
+
 typedef struct QuarrelOptions
 {
 	QuarrelGeneralOptions	general;
 	QuarrelDatabaseOptions	source;
 	QuarrelDatabaseOptions	target;
+
+	/* compare source with each of these targets */
+	QuarrelTargetOptions	*targets;
+	int						ntargets;
 } QuarrelOptions;
 
 typedef struct PQLSecLabel
@@ -124,6 +188,13 @@ typedef struct PQLSecLabel
 	char	*label;
 } PQLSecLabel;
 
+/*
+ * Object names loaded by the getters (schemaname and objectname of PQLObject)
+ * are interned (see internName): each distinct name is stored once and is
+ * preceded by its position in strcmp order and its quoted form. Hence,
+ * comparing two names is an integer comparison and quoting a name (see
+ * quotedName) does not allocate memory.
+ */
 typedef struct PQLObject
 {
 	Oid		oid;
@@ -138,6 +209,7 @@ typedef struct PQLAttribute
 	bool		attnotnull;
 	char		*atttypname;
 	char		*attdefexpr;
+	bool		attdefvolatile;	/* default calls a volatile function */
 	char		*attcollation;
 	int			attstattarget;
 	char		*attstorage;
@@ -176,8 +248,10 @@ enum PQLSetOperation
 };
 
 extern enum PQLLogLevel loglevel;
-extern int pgversion1;
-extern int pgversion2;
+extern enum PQLLogFormat logformat;
+extern PGQ_THREAD_LOCAL int pgversion1;
+extern PGQ_THREAD_LOCAL int pgversion2;
+extern PGQ_THREAD_LOCAL int costexceeded;
 
 extern QuarrelGeneralOptions options;
 
@@ -196,17 +270,102 @@ typedef struct stringList
 	stringListCell	*tail;
 } stringList;
 
+/*
+ * Options (e.g. reloptions or FDW options) sorted by key. The option string
+ * is split in place; a key and its value point into data.
+ */
+typedef struct PQLOption
+{
+	char	*key;
+	char	*value;		/* NULL if the option has no value */
+} PQLOption;
+
+typedef struct PQLOptionSet
+{
+	char		*data;
+	PQLOption	*items;
+	int			nitems;
+} PQLOptionSet;
+
+/*
+ * Memory arena. Catalog objects loaded from a server are carved out of a few
+ * large blocks instead of being allocated one by one; all of them are released
+ * at once by resetArena.
+ */
+typedef struct PQLArenaBlock
+{
+	struct PQLArenaBlock	*next;
+	size_t					size;	/* usable bytes */
+	size_t					used;
+} PQLArenaBlock;
+
+typedef struct PQLArena
+{
+	PQLArenaBlock	*blocks;	/* block being filled comes first */
+} PQLArena;
+
+/* ordinal of a name interned after the last sortNameTable */
+#define	PGQ_NAME_UNSORTED	0xFFFFFFFF
+
+typedef struct PQLName
+{
+	uint32	ordinal;	/* position in strcmp order */
+	uint32	hash;
+	char	*quoted;	/* see formatObjectIdentifier; it can point to str */
+	char	str[1];		/* VARIABLE LENGTH ARRAY */
+} PQLName;
+
+/*
+ * Table of interned names. Both servers of a comparison share one table so a
+ * name has the same ordinal on both sides.
+ */
+typedef struct PQLNameTable
+{
+	PQLName		**buckets;	/* open addressing; nbuckets is a power of 2 */
+	uint32		nbuckets;
+	PQLName		**names;	/* names [0, nsorted) are in strcmp order */
+	uint32		nnames;
+	uint32		nsorted;
+	uint32		maxnames;
+	PQLArena	storage;
+	bool		initialized;
+#if defined(_WINDOWS)
+	CRITICAL_SECTION	lock;
+#else
+	pthread_mutex_t		lock;
+#endif
+} PQLNameTable;
 
 int compareRelations(PQLObject *a, PQLObject *b);
 int compareNamesAndRelations(PQLObject *a, PQLObject *b, char *aname,
 							 char *bname);
 char *formatObjectIdentifier(char *s);
+char *buildOidArray(Oid *oids, int n);
+PGresult **execQueries(PGconn *c, char **queries, int n);
+PGresult **execServerQueries(PGconn *c, char **queries, int n);
+PGresult *execQuery(PGconn *c, const char *query);
+PGresult *execServerQuery(PGconn *c, const char *query);
+int getServerVersion(PGconn *c);
+const char *getServerVersionString(PGconn *c);
+char *escapeLiteral(PGconn *c, const char *str, size_t len);
+void setCurrentArena(PQLArena *a);
+void *arenaAlloc(size_t size);
+char *arenaStrdup(const char *s);
+void resetArena(PQLArena *a);
+void freeArena(PQLArena *a);
+void initNameTable(PQLNameTable *t);
+void setCurrentNameTable(PQLNameTable *t);
+char *internName(const char *s);
+char *quotedName(const char *s);
+void sortNameTable(PQLNameTable *t);
+void freeNameTable(PQLNameTable *t);
 void logGeneric(enum PQLLogLevel level, const char *fmt, ...);
 
-stringList *buildStringList(char *options);
-stringList *setOperationOptions(char *a, char *b, int kind, bool withvalue,
-								bool changed);
-char *printOptions(stringList *sl);
+PQLOptionSet *buildOptionSet(const char *options);
+PQLOptionSet *setOperationOptions(const char *a, const char *b, int kind,
+								  bool withvalue, bool changed);
+char *printOptions(PQLOptionSet *s);
+void freeOptionSet(PQLOptionSet *s);
 
 void appendStringList(stringList *sl, const char *s);
 void appendAllStringList(stringList *sl, char *s, const char *d);
@@ -9,6 +9,7 @@
 #ifndef CONVERSION_H
 #define	CONVERSION_H
 
+#include "comment.h"
 #include "common.h"
 
 typedef struct PQLConversion
@@ -29,6 +30,5 @@ void dumpDropConversion(FILE *output, PQLConversion *c);
 void dumpCreateConversion(FILE *output, PQLConversion *c);
 void dumpAlterConversion(FILE *output, PQLConversion *a, PQLConversion *b);
 
-void freeConversions(PQLConversion *c, int n);
 
 #endif	/* CONVERSION_H */
@@ -0,0 +1,552 @@
+/*----------------------------------------------------------------------
+ *
+ * pgquarrel -- comparing database schemas
+ *
+ * depend.c
+ *     Order commands by object dependencies
+ *
+ * pg_depend is loaded once per server. Dependencies of objects that are
+ * printed as part of another object (view rules, column defaults,
+ * constraints, composite and array types) are moved to that object. The
+ * segments of an output buffer (see markOutputBuffer) are the nodes of a
+ * graph: a segment that creates or alters an object comes after the
+ * segments of the objects it depends on and a segment that drops an object
+ * comes before them. The graph is sorted topologically; segments that are not
+ * related keep the order they were printed. Each segment is also assigned a
+ * wave: the length of the longest dependency chain that ends at it. Segments
+ * of the same wave do not depend on each other. Segments that are not marked
+ * with an object (e.g. schema-wide privileges) have no dependencies; they are
+ * written after all other segments, in a wave of their own.
+ *
+ * Foreign keys are not dependencies of the table (a table and its foreign
+ * keys are created in different buffers) but adding or dropping a table
+ * with foreign keys locks the referenced tables. Hence, in the post buffer,
+ * tables that a foreign key connects are not in the same wave.
+ *
+ * Copyright (c) 2015-2020, Euler Taveira
+ *
+ * ---------------------------------------------------------------------
+ */
+#include "depend.h"
+
+
+/* edges of the segment graph */
+typedef struct PQLSegmentEdges
+{
+	int		*from;
+	int		*to;
+	int		n;
+	int		max;
+} PQLSegmentEdges;
+
+static int compareDependencies(const void *a, const void *b);
+static int compareSegmentKeys(PQLOutputSegment *a, PQLOutputSegment *b);
+static int compareSegmentIndexes(const void *a, const void *b);
+static int findDependency(PQLDependency *deps, int ndeps, Oid classid,
+						  Oid objid);
+static int findSegment(PQLOutputSegment *segs, int *bykey, int n,
+					   PQLOutputSegment *key);
+static void addDependencyEdges(PQLSegmentEdges *e, PQLOutputSegment *segs,
+							   int *bykey, int n, int i, bool drop,
+							   PQLDependency *deps, int ndeps);
+static void addEdge(PQLSegmentEdges *e, int from, int to);
+static void pushSegment(int *heap, int *n, int v);
+static int popSegment(int *heap, int *n);
+
+/* segments sorted by key (see sortOutputBuffer) */
+static PGQ_THREAD_LOCAL PQLOutputSegment *sortsegments = NULL;
+
+static int
+compareDependencies(const void *a, const void *b)
+{
+	const PQLDependency	*x = (const PQLDependency *) a;
+	const PQLDependency	*y = (const PQLDependency *) b;
+
+	if (x->classid != y->classid)
+		return (x->classid < y->classid) ? -1 : 1;
+	if (x->objid != y->objid)
+		return (x->objid < y->objid) ? -1 : 1;
+
+	return 0;
+}
+
+void
+getDependencies(PGconn *c, PQLDependencies *d)
+{
+	char		*query;
+	PGresult	*res;
+	int			i;
+
+	query = psprintf("WITH m (classid, objid, nclassid, nobjid) AS (SELECT 'pg_rewrite'::regclass::oid, r.oid, 'pg_class'::regclass::oid, r.ev_class FROM pg_rewrite r WHERE r.rulename = '_RETURN' UNION ALL SELECT 'pg_attrdef'::regclass::oid, a.oid, 'pg_class'::regclass::oid, a.adrelid FROM pg_attrdef a UNION ALL SELECT 'pg_constraint'::regclass::oid, o.oid, CASE WHEN o.conrelid <> 0 THEN 'pg_class'::regclass::oid ELSE 'pg_type'::regclass::oid END, CASE WHEN o.conrelid <> 0 THEN o.conrelid ELSE o.contypid END FROM pg_constraint o WHERE o.contype <> 'f' UNION ALL SELECT 'pg_type'::regclass::oid, t.oid, 'pg_class'::regclass::oid, t.typrelid FROM pg_type t INNER JOIN pg_class c ON (c.oid = t.typrelid) WHERE c.relkind <> 'c' UNION ALL SELECT 'pg_class'::regclass::oid, c.oid, 'pg_type'::regclass::oid, c.reltype FROM pg_class c WHERE c.relkind = 'c' UNION ALL SELECT 'pg_type'::regclass::oid, t.oid, 'pg_type'::regclass::oid, t.typelem FROM pg_type t INNER JOIN pg_type e ON (e.oid = t.typelem AND e.typarray = t.oid)) SELECT DISTINCT coalesce(x.nclassid, d.classid) AS classid, coalesce(x.nobjid, d.objid) AS objid, coalesce(y.nclassid, d.refclassid) AS refclassid, coalesce(y.nobjid, d.refobjid) AS refobjid FROM pg_depend d LEFT JOIN m x ON (x.classid = d.classid AND x.objid = d.objid) LEFT JOIN m y ON (y.classid = d.refclassid AND y.objid = d.refobjid) WHERE d.deptype IN ('n', 'a') AND d.objid >= %u AND d.refobjid >= %u AND NOT (d.deptype = 'a' AND d.classid = 'pg_class'::regclass AND d.refobjsubid <> 0 AND EXISTS(SELECT 1 FROM pg_class s WHERE s.oid = d.objid AND s.relkind = 'S')) ORDER BY 1, 2",
+					 PGQ_FIRST_USER_OID, PGQ_FIRST_USER_OID);
+
+	res = execQuery(c, query);
+
+	pfree(query);
+
+	if (PQresultStatus(res) != PGRES_TUPLES_OK)
+	{
+		logError("query failed: %s", PQresultErrorMessage(res));
+		PQclear(res);
+		PQfinish(c);
+		/* XXX leak another connection? */
+		exit(EXIT_FAILURE);
+	}
+
+	d->ndeps = 0;
+	if (PQntuples(res) > 0)
+		d->deps = (PQLDependency *) malloc(PQntuples(res) * sizeof(PQLDependency));
+	else
+		d->deps = NULL;
+
+	for (i = 0; i < PQntuples(res); i++)
+	{
+		PQLDependency	*x = &d->deps[d->ndeps];
+
+		x->classid = strtoul(PQgetvalue(res, i, PQfnumber(res, "classid")), NULL, 10);
+		x->objid = strtoul(PQgetvalue(res, i, PQfnumber(res, "objid")), NULL, 10);
+		x->refclassid = strtoul(PQgetvalue(res, i, PQfnumber(res, "refclassid")),
+								NULL, 10);
+		x->refobjid = strtoul(PQgetvalue(res, i, PQfnumber(res, "refobjid")),
+							  NULL, 10);
+
+		/* a view depends on itself through its rule */
+		if (x->classid == x->refclassid && x->objid == x->refobjid)
+			continue;
+
+		d->ndeps++;
+	}
+
+	PQclear(res);
+
+	/* ORDER BY uses the same order but do not rely on it */
+	qsort(d->deps, d->ndeps, sizeof(PQLDependency), compareDependencies);
+
+	/* tables connected by foreign keys */
+	query = psprintf("SELECT DISTINCT conrelid, confrelid FROM pg_constraint WHERE contype = 'f' AND conrelid <> confrelid AND conrelid >= %u ORDER BY 1, 2",
+					 PGQ_FIRST_USER_OID);
+
+	res = execQuery(c, query);
+
+	pfree(query);
+
+	if (PQresultStatus(res) != PGRES_TUPLES_OK)
+	{
+		logError("query failed: %s", PQresultErrorMessage(res));
+		PQclear(res);
+		PQfinish(c);
+		/* XXX leak another connection? */
+		exit(EXIT_FAILURE);
+	}
+
+	d->nfkeys = PQntuples(res);
+	if (d->nfkeys > 0)
+		d->fkeys = (PQLDependency *) malloc(d->nfkeys * sizeof(PQLDependency));
+	else
+		d->fkeys = NULL;
+
+	for (i = 0; i < d->nfkeys; i++)
+	{
+		PQLDependency	*x = &d->fkeys[i];
+
+		x->classid = PGQ_CLASS_CLASS;
+		x->objid = strtoul(PQgetvalue(res, i, PQfnumber(res, "conrelid")), NULL, 10);
+		x->refclassid = PGQ_CLASS_CLASS;
+		x->refobjid = strtoul(PQgetvalue(res, i, PQfnumber(res, "confrelid")),
+							  NULL, 10);
+	}
+
+	PQclear(res);
+
+	qsort(d->fkeys, d->nfkeys, sizeof(PQLDependency), compareDependencies);
+
+	logDebug("%d dependencies and %d foreign keys loaded", d->ndeps, d->nfkeys);
+}
+
+void
+freeDependencies(PQLDependencies *d)
+{
+	if (d->deps)
+		free(d->deps);
+	if (d->fkeys)
+		free(d->fkeys);
+	d->deps = NULL;
+	d->ndeps = 0;
+	d->fkeys = NULL;
+	d->nfkeys = 0;
+}
+
+static int
+compareSegmentKeys(PQLOutputSegment *a, PQLOutputSegment *b)
+{
+	if (a->server != b->server)
+		return (a->server < b->server) ? -1 : 1;
+	if (a->classid != b->classid)
+		return (a->classid < b->classid) ? -1 : 1;
+	if (a->objid != b->objid)
+		return (a->objid < b->objid) ? -1 : 1;
+
+	return 0;
+}
+
+static int
+compareSegmentIndexes(const void *a, const void *b)
+{
+	int		x = *(const int *) a;
+	int		y = *(const int *) b;
+	int		c;
+
+	c = compareSegmentKeys(&sortsegments[x], &sortsegments[y]);
+	if (c != 0)
+		return c;
+
+	return x - y;
+}
+
+/*
+ * Return the first dependency of (classid, objid) or -1.
+ */
+static int
+findDependency(PQLDependency *deps, int ndeps, Oid classid, Oid objid)
+{
+	int		low = 0;
+	int		high = ndeps;
+
+	while (low < high)
+	{
+		int		mid = low + (high - low) / 2;
+
+		if (deps[mid].classid < classid ||
+				(deps[mid].classid == classid && deps[mid].objid < objid))
+			low = mid + 1;
+		else
+			high = mid;
+	}
+
+	if (low < ndeps && deps[low].classid == classid && deps[low].objid == objid)
+		return low;
+
+	return -1;
+}
+
+/*
+ * Return the position (in bykey) of the first segment whose key is key.
+ */
+static int
+findSegment(PQLOutputSegment *segs, int *bykey, int n, PQLOutputSegment *key)
+{
+	int		low = 0;
+	int		high = n;
+
+	while (low < high)
+	{
+		int		mid = low + (high - low) / 2;
+
+		if (compareSegmentKeys(&segs[bykey[mid]], key) < 0)
+			low = mid + 1;
+		else
+			high = mid;
+	}
+
+	return low;
+}
+
+/*
+ * Add edges between segment bykey[i] and the segments of the objects it
+ * depends on (deps). If drop is true, a server 1 segment comes before the
+ * objects it depends on; server 2 segments are always created after them.
+ */
+static void
+addDependencyEdges(PQLSegmentEdges *e, PQLOutputSegment *segs, int *bykey,
+				   int n, int i, bool drop, PQLDependency *deps, int ndeps)
+{
+	PQLOutputSegment	*s = &segs[bykey[i]];
+	int					x;
+	int					j;
+
+	x = findDependency(deps, ndeps, s->classid, s->objid);
+	for (; x >= 0 && x < ndeps && deps[x].classid == s->classid &&
+		 deps[x].objid == s->objid; x++)
+	{
+		PQLOutputSegment	key;
+
+		key.server = s->server;
+		key.classid = deps[x].refclassid;
+		key.objid = deps[x].refobjid;
+
+		for (j = findSegment(segs, bykey, n, &key);
+			 j < n && compareSegmentKeys(&segs[bykey[j]], &key) == 0; j++)
+		{
+			/*
+			 * drop an object before the objects it depends on; server 2
+			 * segments of post (e.g. foreign keys of new tables) are not
+			 * drops
+			 */
+			if (drop && s->server == 1)
+				addEdge(e, bykey[i], bykey[j]);
+			else
+				addEdge(e, bykey[j], bykey[i]);
+		}
+	}
+}
+
+static void
+addEdge(PQLSegmentEdges *e, int from, int to)
+{
+	if (e->n == e->max)
+	{
+		e->max = (e->max > 0) ? e->max * 2 : 64;
+		e->from = (int *) realloc(e->from, e->max * sizeof(int));
+		e->to = (int *) realloc(e->to, e->max * sizeof(int));
+		if (e->from == NULL || e->to == NULL)
+		{
+			logError("could not allocate memory for dependencies");
+			exit(EXIT_FAILURE);
+		}
+	}
+
+	e->from[e->n] = from;
+	e->to[e->n] = to;
+	e->n++;
+}
+
+/*
+ * Min-heap of segment numbers. The segment that was printed first among
+ * those whose dependencies are satisfied is the next one.
+ */
+static void
+pushSegment(int *heap, int *n, int v)
+{
+	int		i = (*n)++;
+
+	while (i > 0 && heap[(i - 1) / 2] > v)
+	{
+		heap[i] = heap[(i - 1) / 2];
+		i = (i - 1) / 2;
+	}
+	heap[i] = v;
+}
+
+static int
+popSegment(int *heap, int *n)
+{
+	int		top = heap[0];
+	int		v = heap[--(*n)];
+	int		i = 0;
+
+	for (;;)
+	{
+		int		c = 2 * i + 1;
+
+		if (c >= *n)
+			break;
+		if (c + 1 < *n && heap[c + 1] < heap[c])
+			c++;
+		if (heap[c] >= v)
+			break;
+		heap[i] = heap[c];
+		i = c;
+	}
+	if (*n > 0)
+		heap[i] = v;
+
+	return top;
+}
+
+/*
+ * Sort the segments of b by dependencies. Objects of server 1 use
+ * dependencies d1 and those of server 2 use d2. If drop is true, an object of
+ * server 1 comes before the objects it depends on; objects of server 2 are
+ * always created after them. Returns the number of waves.
+ */
+int
+sortOutputBuffer(PQLOutputBuffer *b, bool drop, PQLDependencies *d1,
+				 PQLDependencies *d2)
+{
+	PQLOutputSegment	*segs = b->segments;
+	PQLOutputSegment	*sorted;
+	int			n = b->nsegments;
+	int			*bykey;
+	PQLSegmentEdges	edges = {NULL, NULL, 0, 0};
+	int			*first;			/* edges of segment i: first[i] .. first[i + 1] */
+	int			*adj;
+	int			*indegree;
+	int			*heap;
+	int			nheap = 0;
+	bool		*done;
+	size_t		size;
+	int			nsorted = 0;
+	int			nwaves = 0;
+	int			i, j, k;
+
+	size = flushOutputBuffer(b);
+
+	if (n <= 1)
+		return (n == 1 && segs[0].len > 0) ? 1 : 0;
+
+	/* segments sorted by key to find the segments of an object */
+	bykey = (int *) malloc(n * sizeof(int));
+	if (bykey == NULL)
+	{
+		logError("could not allocate memory for dependencies");
+		exit(EXIT_FAILURE);
+	}
+	for (i = 0; i < n; i++)
+		bykey[i] = i;
+	sortsegments = segs;
+	qsort(bykey, n, sizeof(int), compareSegmentIndexes);
+	sortsegments = NULL;
+
+	for (i = 0; i < n; i++)
+	{
+		PQLOutputSegment	*s = &segs[bykey[i]];
+		PQLDependencies		*d = (s->server == 1) ? d1 : d2;
+
+		if (s->classid == InvalidOid)
+			continue;
+
+		/* segments of the same object keep their order */
+		if (i > 0 && compareSegmentKeys(&segs[bykey[i - 1]], s) == 0)
+			addEdge(&edges, bykey[i - 1], bykey[i]);
+
+		addDependencyEdges(&edges, segs, bykey, n, i, drop, d->deps, d->ndeps);
+		if (drop)
+			addDependencyEdges(&edges, segs, bykey, n, i, drop, d->fkeys,
+							   d->nfkeys);
+	}
+
+	/* adjacency lists */
+	first = (int *) calloc(n + 1, sizeof(int));
+	indegree = (int *) calloc(n, sizeof(int));
+	adj = (int *) malloc((edges.n > 0 ? edges.n : 1) * sizeof(int));
+	if (first == NULL || indegree == NULL || adj == NULL)
+	{
+		logError("could not allocate memory for dependencies");
+		exit(EXIT_FAILURE);
+	}
+	for (k = 0; k < edges.n; k++)
+	{
+		first[edges.from[k] + 1]++;
+		indegree[edges.to[k]]++;
+	}
+	for (i = 0; i < n; i++)
+		first[i + 1] += first[i];
+	{
+		int		*pos = (int *) malloc(n * sizeof(int));
+
+		if (pos == NULL)
+		{
+			logError("could not allocate memory for dependencies");
+			exit(EXIT_FAILURE);
+		}
+
+		memcpy(pos, first, n * sizeof(int));
+		for (k = 0; k < edges.n; k++)
+			adj[pos[edges.from[k]]++] = edges.to[k];
+		free(pos);
+	}
+
+	/* Kahn's algorithm; ties are broken by the printed order */
+	if (b->maxsegments < n + 1)
+		b->maxsegments = n + 1;
+	sorted = (PQLOutputSegment *) malloc(b->maxsegments * sizeof(PQLOutputSegment));
+	heap = (int *) malloc(n * sizeof(int));
+	done = (bool *) calloc(n, sizeof(bool));
+	if (sorted == NULL || heap == NULL || done == NULL)
+	{
+		logError("could not allocate memory for dependencies");
+		exit(EXIT_FAILURE);
+	}
+
+	/* unmarked segments are written at the end (see below) */
+	for (i = 0; i < n; i++)
+	{
+		segs[i].wave = 0;
+		if (indegree[i] == 0 && segs[i].classid != InvalidOid)
+			pushSegment(heap, &nheap, i);
+	}
+
+	while (nheap > 0)
+	{
+		i = popSegment(heap, &nheap);
+
+		done[i] = true;
+		sorted[nsorted++] = segs[i];
+		if (segs[i].len > 0 && segs[i].wave + 1 > nwaves)
+			nwaves = segs[i].wave + 1;
+
+		for (k = first[i]; k < first[i + 1]; k++)
+		{
+			j = adj[k];
+
+			/* an empty segment does not start a new wave */
+			if (segs[j].wave < segs[i].wave + (segs[i].len > 0 ? 1 : 0))
+				segs[j].wave = segs[i].wave + (segs[i].len > 0 ? 1 : 0);
+			if (--indegree[j] == 0)
+				pushSegment(heap, &nheap, j);
+		}
+	}
+
+	/*
+	 * circular dependencies: keep the printed order of what is left. Each
+	 * segment has its own wave; e.g. tables whose foreign keys reference each
+	 * other must not lock each other at the same time.
+	 */
+	for (i = 0, k = 0; i < n; i++)
+	{
+		if (done[i] || segs[i].classid == InvalidOid)
+			continue;
+		segs[i].wave = nwaves;
+		sorted[nsorted++] = segs[i];
+		if (segs[i].len > 0)
+			nwaves++;
+		k++;
+	}
+	if (k > 0)
+		logWarning("could not order %d commands by dependencies (circular dependency)",
+				   k);
+
+	/* unmarked segments are applied after all the others */
+	for (i = 0, k = 0; i < n; i++)
+	{
+		if (segs[i].classid != InvalidOid)
+			continue;
+		segs[i].wave = nwaves;
+		sorted[nsorted++] = segs[i];
+		if (segs[i].len > 0)
+			k++;
+	}
+	if (k > 0)
+		nwaves++;
+
+	logDebug("%d commands, %d dependencies, %d waves", n, edges.n, nwaves);
+
+	/*
+	 * The last segment is the one that flushOutputBuffer extends; commands
+	 * printed after sorting go into a new segment.
+	 */
+	sorted[nsorted].offset = size;
+	sorted[nsorted].len = 0;
+	sorted[nsorted].classid = InvalidOid;
+	sorted[nsorted].objid = InvalidOid;
+	sorted[nsorted].server = 0;
+	sorted[nsorted].wave = nwaves;
+	nsorted++;
+
+	free(b->segments);
+	b->segments = sorted;
+	b->nsegments = nsorted;
+
+	free(bykey);
+	if (edges.from)
+		free(edges.from);
+	if (edges.to)
+		free(edges.to);
+	free(first);
+	free(adj);
+	free(indegree);
+	free(heap);
+	free(done);
+
+	return nwaves;
+}
@@ -0,0 +1,72 @@
+/*----------------------------------------------------------------------
+ *
+ * pgquarrel -- comparing database schemas
+ *
+ * Copyright (c) 2015-2020, Euler Taveira
+ *
+ * ---------------------------------------------------------------------
+ */
+#ifndef DEPEND_H
+#define DEPEND_H
+
+#include "common.h"
+#include "output.h"
+
+/*
+ * Catalogs of the objects that are marked in the output buffers. Same as
+ * XRelationId in catalog/pg_*.h; these values do not change across versions.
+ */
+#define	PGQ_CLASS_TYPE					1247
+#define	PGQ_CLASS_PROC					1255
+#define	PGQ_CLASS_CLASS					1259
+#define	PGQ_CLASS_FOREIGN_SERVER		1417
+#define	PGQ_CLASS_USER_MAPPING			1418
+#define	PGQ_CLASS_AM					2601
+#define	PGQ_CLASS_CAST					2605
+#define	PGQ_CLASS_CONSTRAINT			2606
+#define	PGQ_CLASS_CONVERSION			2607
+#define	PGQ_CLASS_LANGUAGE				2612
+#define	PGQ_CLASS_NAMESPACE				2615
+#define	PGQ_CLASS_OPCLASS				2616
+#define	PGQ_CLASS_OPERATOR				2617
+#define	PGQ_CLASS_REWRITE				2618
+#define	PGQ_CLASS_TRIGGER				2620
+#define	PGQ_CLASS_OPFAMILY				2753
+#define	PGQ_CLASS_FOREIGN_DATA_WRAPPER	2328
+#define	PGQ_CLASS_EXTENSION				3079
+#define	PGQ_CLASS_POLICY				3256
+#define	PGQ_CLASS_STATISTIC_EXT			3381
+#define	PGQ_CLASS_COLLATION				3456
+#define	PGQ_CLASS_EVENT_TRIGGER			3466
+#define	PGQ_CLASS_TRANSFORM				3576
+#define	PGQ_CLASS_TS_DICT				3600
+#define	PGQ_CLASS_TS_PARSER				3601
+#define	PGQ_CLASS_TS_CONFIG				3602
+#define	PGQ_CLASS_TS_TEMPLATE			3764
+#define	PGQ_CLASS_SUBSCRIPTION			6100
+#define	PGQ_CLASS_PUBLICATION			6104
+
+/* object (classid, objid) depends on object (refclassid, refobjid) */
+typedef struct PQLDependency
+{
+	Oid		classid;
+	Oid		objid;
+	Oid		refclassid;
+	Oid		refobjid;
+} PQLDependency;
+
+/* dependencies of one server sorted by (classid, objid) */
+typedef struct PQLDependencies
+{
+	PQLDependency	*deps;
+	int				ndeps;
+	PQLDependency	*fkeys;		/* table depends on table it references */
+	int				nfkeys;
+} PQLDependencies;
+
+void getDependencies(PGconn *c, PQLDependencies *d);
+void freeDependencies(PQLDependencies *d);
+int sortOutputBuffer(PQLOutputBuffer *b, bool drop, PQLDependencies *d1,
+					 PQLDependencies *d2);
+
+#endif	/* DEPEND_H */
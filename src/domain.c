@@ -37,23 +37,23 @@ getDomains(PGconn *c, int *n)
 	PGresult		*res;
 	int				i;
 
-	logNoise("domain: server version: %d", PQserverVersion(c));
+	logNoise("domain: server version: %d", getServerVersion(c));
 
-	if (PQserverVersion(c) >= 90200)		/* support for privileges on data types */
+	if (getServerVersion(c) >= 90200)		/* support for privileges on data types */
 	{
-		query = psprintf("SELECT t.oid, n.nspname, t.typname, format_type(t.typbasetype, t.typtypmod) as domaindef, t.typnotnull, CASE WHEN t.typcollation <> u.typcollation THEN '\"' || p.nspname || '\".\"' || l.collname || '\"' ELSE NULL END AS typcollation, pg_get_expr(t.typdefaultbin, 'pg_type'::regclass) AS typdefault, obj_description(t.oid, 'pg_type') AS description, pg_get_userbyid(t.typowner) AS typowner, t.typacl FROM pg_type t INNER JOIN pg_namespace n ON (t.typnamespace = n.oid) LEFT JOIN pg_type u ON (t.typbasetype = u.oid) LEFT JOIN pg_collation l ON (t.typcollation = l.oid) LEFT JOIN pg_namespace p ON (l.collnamespace = p.oid) WHERE t.typtype = 'd' AND n.nspname !~ '^pg_' AND n.nspname <> 'information_schema' AND NOT EXISTS(SELECT 1 FROM pg_depend d WHERE t.oid = d.objid AND d.deptype = 'e') ORDER BY n.nspname, t.typname");
+		query = psprintf("SELECT t.oid, n.nspname, t.typname, format_type(t.typbasetype, t.typtypmod) as domaindef, t.typnotnull, CASE WHEN t.typcollation <> u.typcollation THEN '\"' || p.nspname || '\".\"' || l.collname || '\"' ELSE NULL END AS typcollation, pg_get_expr(t.typdefaultbin, 'pg_type'::regclass) AS typdefault, pg_get_userbyid(t.typowner) AS typowner, t.typacl FROM pg_type t INNER JOIN pg_namespace n ON (t.typnamespace = n.oid) LEFT JOIN pg_type u ON (t.typbasetype = u.oid) LEFT JOIN pg_collation l ON (t.typcollation = l.oid) LEFT JOIN pg_namespace p ON (l.collnamespace = p.oid) WHERE t.typtype = 'd' AND n.nspname !~ '^pg_' AND n.nspname <> 'information_schema' AND NOT EXISTS(SELECT 1 FROM pg_depend d WHERE t.oid = d.objid AND d.deptype = 'e') ORDER BY n.nspname, t.typname");
 	}
-	else if (PQserverVersion(c) >= 90100)	/* extension support */
+	else if (getServerVersion(c) >= 90100)	/* extension support */
 	{
 		/* typcollation is new in 9.1 */
-		query = psprintf("SELECT t.oid, n.nspname, t.typname, format_type(t.typbasetype, t.typtypmod) as domaindef, t.typnotnull, CASE WHEN t.typcollation <> u.typcollation THEN '\"' || p.nspname || '\".\"' || l.collname || '\"' ELSE NULL END AS typcollation, pg_get_expr(t.typdefaultbin, 'pg_type'::regclass) AS typdefault, obj_description(t.oid, 'pg_type') AS description, pg_get_userbyid(t.typowner) AS typowner, NULL AS typacl FROM pg_type t INNER JOIN pg_namespace n ON (t.typnamespace = n.oid) LEFT JOIN pg_type u ON (t.typbasetype = u.oid) LEFT JOIN pg_collation l ON (t.typcollation = l.oid) LEFT JOIN pg_namespace p ON (l.collnamespace = p.oid) WHERE t.typtype = 'd' AND n.nspname !~ '^pg_' AND n.nspname <> 'information_schema' %s%s AND NOT EXISTS(SELECT 1 FROM pg_depend d WHERE t.oid = d.objid AND d.deptype = 'e') ORDER BY n.nspname, t.typname", include_schema_str, exclude_schema_str);
+		query = psprintf("SELECT t.oid, n.nspname, t.typname, format_type(t.typbasetype, t.typtypmod) as domaindef, t.typnotnull, CASE WHEN t.typcollation <> u.typcollation THEN '\"' || p.nspname || '\".\"' || l.collname || '\"' ELSE NULL END AS typcollation, pg_get_expr(t.typdefaultbin, 'pg_type'::regclass) AS typdefault, pg_get_userbyid(t.typowner) AS typowner, NULL AS typacl FROM pg_type t INNER JOIN pg_namespace n ON (t.typnamespace = n.oid) LEFT JOIN pg_type u ON (t.typbasetype = u.oid) LEFT JOIN pg_collation l ON (t.typcollation = l.oid) LEFT JOIN pg_namespace p ON (l.collnamespace = p.oid) WHERE t.typtype = 'd' AND n.nspname !~ '^pg_' AND n.nspname <> 'information_schema' %s%s AND NOT EXISTS(SELECT 1 FROM pg_depend d WHERE t.oid = d.objid AND d.deptype = 'e') ORDER BY n.nspname, t.typname", include_schema_str, exclude_schema_str);
 	}
 	else
 	{
-		query = psprintf("SELECT t.oid, n.nspname, t.typname, format_type(t.typbasetype, t.typtypmod) as domaindef, t.typnotnull, NULL AS typcollation, pg_get_expr(t.typdefaultbin, 'pg_type'::regclass) AS typdefault, obj_description(t.oid, 'pg_type') AS description, pg_get_userbyid(t.typowner) AS typowner, NULL AS typacl FROM pg_type t INNER JOIN pg_namespace n ON (t.typnamespace = n.oid) WHERE t.typtype = 'd' AND n.nspname !~ '^pg_' AND n.nspname <> 'information_schema' %s%s ORDER BY n.nspname, t.typname", include_schema_str, exclude_schema_str);
+		query = psprintf("SELECT t.oid, n.nspname, t.typname, format_type(t.typbasetype, t.typtypmod) as domaindef, t.typnotnull, NULL AS typcollation, pg_get_expr(t.typdefaultbin, 'pg_type'::regclass) AS typdefault, pg_get_userbyid(t.typowner) AS typowner, NULL AS typacl FROM pg_type t INNER JOIN pg_namespace n ON (t.typnamespace = n.oid) WHERE t.typtype = 'd' AND n.nspname !~ '^pg_' AND n.nspname <> 'information_schema' %s%s ORDER BY n.nspname, t.typname", include_schema_str, exclude_schema_str);
 	}
 
-	res = PQexec(c, query);
+	res = execQuery(c, query);
 
 	pfree(query);
 
@@ -68,7 +68,7 @@ getDomains(PGconn *c, int *n)
 
 	*n = PQntuples(res);
 	if (*n > 0)
-		d = (PQLDomain *) malloc(*n * sizeof(PQLDomain));
+		d = (PQLDomain *) arenaAlloc(*n * sizeof(PQLDomain));
 	else
 		d = NULL;
 
@@ -76,49 +76,33 @@ getDomains(PGconn *c, int *n)
 
 	for (i = 0; i < *n; i++)
 	{
-		char	*withoutescape;
-
 		d[i].obj.oid = strtoul(PQgetvalue(res, i, PQfnumber(res, "oid")), NULL, 10);
-		d[i].obj.schemaname = strdup(PQgetvalue(res, i, PQfnumber(res, "nspname")));
-		d[i].obj.objectname = strdup(PQgetvalue(res, i, PQfnumber(res, "typname")));
-		d[i].domaindef = strdup(PQgetvalue(res, i, PQfnumber(res, "domaindef")));
+		d[i].obj.schemaname = internName(PQgetvalue(res, i, PQfnumber(res, "nspname")));
+		d[i].obj.objectname = internName(PQgetvalue(res, i, PQfnumber(res, "typname")));
+		d[i].domaindef = arenaStrdup(PQgetvalue(res, i, PQfnumber(res, "domaindef")));
 		d[i].notnull = (PQgetvalue(res, i, PQfnumber(res, "typnotnull"))[0] == 't');
 
 		if (PQgetisnull(res, i, PQfnumber(res, "typcollation")))
 			d[i].collation = NULL;
 		else
-			d[i].collation = strdup(PQgetvalue(res, i, PQfnumber(res, "typcollation")));
+			d[i].collation = arenaStrdup(PQgetvalue(res, i, PQfnumber(res, "typcollation")));
 
 		if (PQgetisnull(res, i, PQfnumber(res, "typdefault")))
 			d[i].ddefault = NULL;
 		else
-			d[i].ddefault = strdup(PQgetvalue(res, i, PQfnumber(res, "typdefault")));
-		if (PQgetisnull(res, i, PQfnumber(res, "description")))
-			d[i].comment = NULL;
-		else
-		{
-			withoutescape = PQgetvalue(res, i, PQfnumber(res, "description"));
-			d[i].comment = PQescapeLiteral(c, withoutescape, strlen(withoutescape));
-			if (d[i].comment == NULL)
-			{
-				logError("escaping comment failed: %s", PQerrorMessage(c));
-				PQclear(res);
-				PQfinish(c);
-				/* XXX leak another connection? */
-				exit(EXIT_FAILURE);
-			}
-		}
+			d[i].ddefault = arenaStrdup(PQgetvalue(res, i, PQfnumber(res, "typdefault")));
+		d[i].comment = getComment(PGQ_CLASS_TYPE, d[i].obj.oid, 0);
 
-		d[i].owner = strdup(PQgetvalue(res, i, PQfnumber(res, "typowner")));
+		d[i].owner = internName(PQgetvalue(res, i, PQfnumber(res, "typowner")));
 		if (PQgetisnull(res, i, PQfnumber(res, "typacl")))
 			d[i].acl = NULL;
 		else
-			d[i].acl = strdup(PQgetvalue(res, i, PQfnumber(res, "typacl")));
+			d[i].acl = arenaStrdup(PQgetvalue(res, i, PQfnumber(res, "typacl")));
 
 		/*
 		 * These values are not assigned here (see getDomainConstraints), but
 		 * default values are essential to avoid having trouble in
-		 * freeDomains.
+		 * the dump routines.
 		 */
 		d[i].ncheck = 0;
 		d[i].check = NULL;
@@ -126,7 +110,7 @@ getDomains(PGconn *c, int *n)
 		/*
 		 * Security labels are not assigned here (see getDomainSecurityLabels),
 		 * but default values are essential to avoid having trouble in
-		 * freeDomains.
+		 * the dump routines.
 		 */
 		d[i].nseclabels = 0;
 		d[i].seclabels = NULL;
@@ -140,165 +124,78 @@ getDomains(PGconn *c, int *n)
 }
 
 void
-getDomainConstraints(PGconn *c, PQLDomain *d)
+getDomainConstraints(PGconn *c, PQLDomain *d, int n)
 {
-	char		*query;
-	PGresult	*res;
-	int			i;
+	char		**queries;
+	PGresult	**res;
+	int			i, j;
 
-	if (PQserverVersion(c) >= 90100)
-	{
-		query = psprintf("SELECT conname, pg_get_constraintdef(oid) AS condef, convalidated FROM pg_constraint WHERE contypid = %u ORDER BY conname",
-						  d->obj.oid);
-	}
-	else
+	if (n == 0)
+		return;
+
+	queries = (char **) malloc(n * sizeof(char *));
+	for (i = 0; i < n; i++)
 	{
-		query = psprintf("SELECT conname, pg_get_constraintdef(oid) AS condef, true AS convalidated FROM pg_constraint WHERE contypid = %u ORDER BY conname",
-						  d->obj.oid);
+		if (getServerVersion(c) >= 90100)
+		{
+			queries[i] = psprintf("SELECT conname, pg_get_constraintdef(oid) AS condef, convalidated FROM pg_constraint WHERE contypid = %u ORDER BY conname",
+							  d[i].obj.oid);
+		}
+		else
+		{
+			queries[i] = psprintf("SELECT conname, pg_get_constraintdef(oid) AS condef, true AS convalidated FROM pg_constraint WHERE contypid = %u ORDER BY conname",
+							  d[i].obj.oid);
+		}
 	}
 
-	res = PQexec(c, query);
+	res = execQueries(c, queries, n);
 
-	pfree(query);
-
-	if (PQresultStatus(res) != PGRES_TUPLES_OK)
+	for (i = 0; i < n; i++)
 	{
-		logError("query failed: %s", PQresultErrorMessage(res));
-		PQclear(res);
-		PQfinish(c);
-		/* XXX leak another connection? */
-		exit(EXIT_FAILURE);
-	}
+		d[i].ncheck = PQntuples(res[i]);
+		if (d[i].ncheck > 0)
+			d[i].check = (PQLConstraint *) arenaAlloc(d[i].ncheck * sizeof(PQLConstraint));
+		else
+			d[i].check = NULL;
 
-	d->ncheck = PQntuples(res);
-	if (d->ncheck > 0)
-		d->check = (PQLConstraint *) malloc(d->ncheck * sizeof(PQLConstraint));
-	else
-		d->check = NULL;
+		logDebug("number of check constraints in domain \"%s\".\"%s\": %d",
+				 d[i].obj.schemaname, d[i].obj.objectname, d[i].ncheck);
 
-	logDebug("number of check constraints in domain \"%s\".\"%s\": %d",
-			 d->obj.schemaname, d->obj.objectname, d->ncheck);
+		for (j = 0; j < d[i].ncheck; j++)
+		{
+			d[i].check[j].conname = arenaStrdup(PQgetvalue(res[i], j, PQfnumber(res[i], "conname")));
+			d[i].check[j].condef = arenaStrdup(PQgetvalue(res[i], j, PQfnumber(res[i], "condef")));
+			d[i].check[j].convalidated = (PQgetvalue(res[i], j, PQfnumber(res[i],
+												   "convalidated"))[0] == 't');
+		}
 
-	for (i = 0; i < d->ncheck; i++)
-	{
-		d->check[i].conname = strdup(PQgetvalue(res, i, PQfnumber(res, "conname")));
-		d->check[i].condef = strdup(PQgetvalue(res, i, PQfnumber(res, "condef")));
-		d->check[i].convalidated = (PQgetvalue(res, i, PQfnumber(res,
-											   "convalidated"))[0] == 't');
+		PQclear(res[i]);
 	}
 
-	PQclear(res);
+	free(res);
 }
 
 void
-getDomainSecurityLabels(PGconn *c, PQLDomain *d)
+getDomainSecurityLabels(PGconn *c, PQLDomain *d, int n)
 {
-	char		*query;
-	PGresult	*res;
 	int			i;
 
-	if (PQserverVersion(c) < 90100)
-	{
-		logWarning("ignoring security labels because server does not support it");
+	if (n == 0)
 		return;
-	}
-
-	/*
-	 * Don't bother to check the kind of type because can't be duplicated oids
-	 * in the same catalog.
-	 */
-	query = psprintf("SELECT provider, label FROM pg_seclabel s INNER JOIN pg_class c ON (s.classoid = c.oid) WHERE c.relname = 'pg_type' AND s.objoid = %u ORDER BY provider",
-			 d->obj.oid);
-
-	res = PQexec(c, query);
-
-	pfree(query);
 
-	if (PQresultStatus(res) != PGRES_TUPLES_OK)
-	{
-		logError("query failed: %s", PQresultErrorMessage(res));
-		PQclear(res);
-		PQfinish(c);
-		/* XXX leak another connection? */
-		exit(EXIT_FAILURE);
-	}
-
-	d->nseclabels = PQntuples(res);
-	if (d->nseclabels > 0)
-		d->seclabels = (PQLSecLabel *) malloc(d->nseclabels * sizeof(PQLSecLabel));
-	else
-		d->seclabels = NULL;
-
-	logDebug("number of security labels in domain \"%s\".\"%s\": %d",
-			 d->obj.schemaname, d->obj.objectname, d->nseclabels);
-
-	for (i = 0; i < d->nseclabels; i++)
+	if (getServerVersion(c) < 90100)
 	{
-		char	*withoutescape;
-
-		d->seclabels[i].provider = strdup(PQgetvalue(res, i, PQfnumber(res,
-										  "provider")));
-		withoutescape = PQgetvalue(res, i, PQfnumber(res, "label"));
-		d->seclabels[i].label = PQescapeLiteral(c, withoutescape,
-												strlen(withoutescape));
-		if (d->seclabels[i].label == NULL)
-		{
-			logError("escaping label failed: %s", PQerrorMessage(c));
-			PQclear(res);
-			PQfinish(c);
-			/* XXX leak another connection? */
-			exit(EXIT_FAILURE);
-		}
+		logWarning("ignoring security labels because server does not support it");
+		return;
 	}
 
-	PQclear(res);
-}
-
-void
-freeDomains(PQLDomain *d, int n)
-{
-	if (n > 0)
+	for (i = 0; i < n; i++)
 	{
-		int	i;
-
-		for (i = 0; i < n; i++)
-		{
-			int	j;
-
-			free(d[i].obj.schemaname);
-			free(d[i].obj.objectname);
-			free(d[i].domaindef);
-			if (d[i].collation)
-				free(d[i].collation);
-			if (d[i].ddefault)
-				free(d[i].ddefault);
-			if (d[i].comment)
-				PQfreemem(d[i].comment);
-			free(d[i].owner);
-			if (d[i].acl)
-				free(d[i].acl);
-
-			for (j = 0 ; j < d[i].ncheck; j++)
-			{
-				free(d[i].check[j].conname);
-				free(d[i].check[j].condef);
-			}
-
-			if (d[i].check)
-				free(d[i].check);
-
-			/* security labels */
-			for (j = 0; j < d[i].nseclabels; j++)
-			{
-				free(d[i].seclabels[j].provider);
-				PQfreemem(d[i].seclabels[j].label);
-			}
-
-			if (d[i].seclabels)
-				free(d[i].seclabels);
-		}
+		d[i].nseclabels = getObjectSecurityLabels(c, PGQ_CLASS_TYPE,
+							  d[i].obj.oid, 0, &d[i].seclabels);
 
-		free(d);
+		logDebug("number of security labels in domain \"%s\".\"%s\": %d",
+				 d[i].obj.schemaname, d[i].obj.objectname, d[i].nseclabels);
 	}
 }
 
@@ -306,8 +203,8 @@ void
 dumpCreateDomain(FILE *output, PQLDomain *d)
 {
 	int		i;
-	char	*schema = formatObjectIdentifier(d->obj.schemaname);
-	char	*domname = formatObjectIdentifier(d->obj.objectname);
+	char	*schema = quotedName(d->obj.schemaname);
+	char	*domname = quotedName(d->obj.objectname);
 
 
 	fprintf(output, "\n\n");
@@ -340,10 +237,11 @@ dumpCreateDomain(FILE *output, PQLDomain *d)
 	if (options.comment && d->comment != NULL)
 	{
 		fprintf(output, "\n\n");
-		fprintf(output, "COMMENT ON DOMAIN %s.%s IS %s;",
+		fprintf(output, "COMMENT ON DOMAIN %s.%s IS ",
 				schema,
-				domname,
-				d->comment);
+				domname);
+		printComment(output, d->comment);
+		fprintf(output, ";");
 	}
 
 	/* security labels */
@@ -363,15 +261,13 @@ dumpCreateDomain(FILE *output, PQLDomain *d)
 	/* owner */
 	if (options.owner)
 	{
-		char	*owner = formatObjectIdentifier(d->owner);
+		char	*owner = quotedName(d->owner);
 
 		fprintf(output, "\n\n");
 		fprintf(output, "ALTER DOMAIN %s.%s OWNER TO %s;",
 				schema,
 				domname,
 				owner);
-
-		free(owner);
 	}
 
 	/* privileges */
@@ -379,31 +275,25 @@ dumpCreateDomain(FILE *output, PQLDomain *d)
 	if (options.privileges)
 		dumpGrantAndRevoke(output, PGQ_DOMAIN, &d->obj, &d->obj, NULL, d->acl, NULL,
 						   NULL);
-
-	free(schema);
-	free(domname);
 }
 
 void
 dumpDropDomain(FILE *output, PQLDomain *d)
 {
-	char	*schema = formatObjectIdentifier(d->obj.schemaname);
-	char	*domname = formatObjectIdentifier(d->obj.objectname);
+	char	*schema = quotedName(d->obj.schemaname);
+	char	*domname = quotedName(d->obj.objectname);
 
 	fprintf(output, "\n\n");
 	fprintf(output, "DROP DOMAIN %s.%s;", schema, domname);
-
-	free(schema);
-	free(domname);
 }
 
 void
 dumpAlterDomain(FILE *output, PQLDomain *a, PQLDomain *b)
 {
-	char	*schema1 = formatObjectIdentifier(a->obj.schemaname);
-	char	*domname1 = formatObjectIdentifier(a->obj.objectname);
-	char	*schema2 = formatObjectIdentifier(b->obj.schemaname);
-	char	*domname2 = formatObjectIdentifier(b->obj.objectname);
+	char	*schema1 = quotedName(a->obj.schemaname);
+	char	*domname1 = quotedName(a->obj.objectname);
+	char	*schema2 = quotedName(b->obj.schemaname);
+	char	*domname2 = quotedName(b->obj.objectname);
 
 	if ((a->ddefault == NULL && b->ddefault != NULL) ||
 			(a->ddefault != NULL && b->ddefault == NULL) ||
@@ -442,10 +332,11 @@ dumpAlterDomain(FILE *output, PQLDomain *a, PQLDomain *b)
 				 strcmp(a->comment, b->comment) != 0))
 		{
 			fprintf(output, "\n\n");
-			fprintf(output, "COMMENT ON DOMAIN %s.%s IS %s;",
+			fprintf(output, "COMMENT ON DOMAIN %s.%s IS ",
 					schema2,
-					domname2,
-					b->comment);
+					domname2);
+			printComment(output, b->comment);
+			fprintf(output, ";");
 		}
 		else if (a->comment != NULL && b->comment == NULL)
 		{
@@ -554,15 +445,13 @@ dumpAlterDomain(FILE *output, PQLDomain *a, PQLDomain *b)
 	{
 		if (strcmp(a->owner, b->owner) != 0)
 		{
-			char	*owner = formatObjectIdentifier(b->owner);
+			char	*owner = quotedName(b->owner);
 
 			fprintf(output, "\n\n");
 			fprintf(output, "ALTER DOMAIN %s.%s OWNER TO %s;",
 					schema2,
 					domname2,
 					owner);
-
-			free(owner);
 		}
 	}
 
@@ -573,9 +462,4 @@ dumpAlterDomain(FILE *output, PQLDomain *a, PQLDomain *b)
 			dumpGrantAndRevoke(output, PGQ_DOMAIN, &a->obj, &b->obj, a->acl, b->acl, NULL,
 							   NULL);
 	}
-
-	free(schema1);
-	free(domname1);
-	free(schema2);
-	free(domname2);
 }
@@ -9,8 +9,10 @@
 #ifndef DOMAIN_H
 #define DOMAIN_H
 
+#include "comment.h"
 #include "common.h"
 #include "privileges.h"
+#include "seclabel.h"
 
 typedef struct PQLDomain
 {
@@ -33,13 +35,12 @@ typedef struct PQLDomain
 } PQLDomain;
 
 PQLDomain *getDomains(PGconn *c, int *n);
-void getDomainConstraints(PGconn *c, PQLDomain *d);
-void getDomainSecurityLabels(PGconn *c, PQLDomain *d);
+void getDomainConstraints(PGconn *c, PQLDomain *d, int n);
+void getDomainSecurityLabels(PGconn *c, PQLDomain *d, int n);
 
 void dumpDropDomain(FILE *output, PQLDomain *d);
 void dumpCreateDomain(FILE *output, PQLDomain *d);
 void dumpAlterDomain(FILE *output, PQLDomain *a, PQLDomain *b);
 
-void freeDomains(PQLDomain *d, int n);
 
 #endif	/* DOMAIN_H */
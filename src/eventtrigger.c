@@ -26,17 +26,17 @@ getEventTriggers(PGconn *c, int *n)
 	PGresult	*res;
 	int			i;
 
-	logNoise("event trigger: server version: %d", PQserverVersion(c));
+	logNoise("event trigger: server version: %d", getServerVersion(c));
 
 	/* bail out if we do not support it */
-	if (PQserverVersion(c) < 90300)
+	if (getServerVersion(c) < 90300)
 	{
 		logWarning("ignoring event triggers because server does not support it");
 		return NULL;
 	}
 
-	res = PQexec(c,
-				 "SELECT e.oid, e.evtname, e.evtevent, p.proname AS funcname, e.evtenabled, e.evttags, obj_description(e.oid, 'pg_event_trigger') AS description, pg_get_userbyid(e.evtowner) AS evtowner FROM pg_event_trigger e INNER JOIN pg_proc p ON (evtfoid = p.oid) WHERE NOT EXISTS(SELECT 1 FROM pg_depend d WHERE e.oid = d.objid AND d.deptype = 'e') ORDER BY evtname");
+	res = execQuery(c,
+				 "SELECT e.oid, e.evtname, e.evtevent, p.proname AS funcname, e.evtenabled, e.evttags, pg_get_userbyid(e.evtowner) AS evtowner FROM pg_event_trigger e INNER JOIN pg_proc p ON (evtfoid = p.oid) WHERE NOT EXISTS(SELECT 1 FROM pg_depend d WHERE e.oid = d.objid AND d.deptype = 'e') ORDER BY evtname");
 
 	if (PQresultStatus(res) != PGRES_TUPLES_OK)
 	{
@@ -49,7 +49,7 @@ getEventTriggers(PGconn *c, int *n)
 
 	*n = PQntuples(res);
 	if (*n > 0)
-		e = (PQLEventTrigger *) malloc(*n * sizeof(PQLEventTrigger));
+		e = (PQLEventTrigger *) arenaAlloc(*n * sizeof(PQLEventTrigger));
 	else
 		e = NULL;
 
@@ -57,39 +57,23 @@ getEventTriggers(PGconn *c, int *n)
 
 	for (i = 0; i < *n; i++)
 	{
-		char	*withoutescape;
-
 		e[i].oid = strtoul(PQgetvalue(res, i, PQfnumber(res, "oid")), NULL, 10);
-		e[i].trgname = strdup(PQgetvalue(res, i, PQfnumber(res, "evtname")));
-		e[i].event = strdup(PQgetvalue(res, i, PQfnumber(res, "evtevent")));
+		e[i].trgname = arenaStrdup(PQgetvalue(res, i, PQfnumber(res, "evtname")));
+		e[i].event = arenaStrdup(PQgetvalue(res, i, PQfnumber(res, "evtevent")));
 		if (PQgetisnull(res, i, PQfnumber(res, "evttags")))
 			e[i].tags = NULL;
 		else
-			e[i].tags = strdup(PQgetvalue(res, i, PQfnumber(res, "evttags")));
-		e[i].functionname = strdup(PQgetvalue(res, i, PQfnumber(res, "funcname")));
+			e[i].tags = arenaStrdup(PQgetvalue(res, i, PQfnumber(res, "evttags")));
+		e[i].functionname = arenaStrdup(PQgetvalue(res, i, PQfnumber(res, "funcname")));
 		e[i].enabled = PQgetvalue(res, i, PQfnumber(res, "evtenabled"))[0];
-		if (PQgetisnull(res, i, PQfnumber(res, "description")))
-			e[i].comment = NULL;
-		else
-		{
-			withoutescape = PQgetvalue(res, i, PQfnumber(res, "description"));
-			e[i].comment = PQescapeLiteral(c, withoutescape, strlen(withoutescape));
-			if (e[i].comment == NULL)
-			{
-				logError("escaping comment failed: %s", PQerrorMessage(c));
-				PQclear(res);
-				PQfinish(c);
-				/* XXX leak another connection? */
-				exit(EXIT_FAILURE);
-			}
-		}
+		e[i].comment = getComment(PGQ_CLASS_EVENT_TRIGGER, e[i].oid, 0);
 
-		e[i].owner = strdup(PQgetvalue(res, i, PQfnumber(res, "evtowner")));
+		e[i].owner = internName(PQgetvalue(res, i, PQfnumber(res, "evtowner")));
 
 		/*
 		 * Security labels are not assigned here (see
 		 * getEventTriggerSecurityLabels), but default values are essential to
-		 * avoid having trouble in freeEventTriggers.
+		 * avoid having trouble in the dump routines.
 		 */
 		e[i].nseclabels = 0;
 		e[i].seclabels = NULL;
@@ -103,97 +87,26 @@ getEventTriggers(PGconn *c, int *n)
 }
 
 void
-getEventTriggerSecurityLabels(PGconn *c, PQLEventTrigger *e)
+getEventTriggerSecurityLabels(PGconn *c, PQLEventTrigger *e, int n)
 {
-	char		*query;
-	PGresult	*res;
 	int			i;
 
-	if (PQserverVersion(c) < 90100)
-	{
-		logWarning("ignoring security labels because server does not support it");
+	if (n == 0)
 		return;
-	}
-
-	query = psprintf("SELECT provider, label FROM pg_seclabel s INNER JOIN pg_class c ON (s.classoid = c.oid) WHERE c.relname = 'pg_event_trigger' AND s.objoid = %u ORDER BY provider",
-			 e->oid);
-
-	res = PQexec(c, query);
-
-	pfree(query);
-
-	if (PQresultStatus(res) != PGRES_TUPLES_OK)
-	{
-		logError("query failed: %s", PQresultErrorMessage(res));
-		PQclear(res);
-		PQfinish(c);
-		/* XXX leak another connection? */
-		exit(EXIT_FAILURE);
-	}
 
-	e->nseclabels = PQntuples(res);
-	if (e->nseclabels > 0)
-		e->seclabels = (PQLSecLabel *) malloc(e->nseclabels * sizeof(PQLSecLabel));
-	else
-		e->seclabels = NULL;
-
-	logDebug("number of security labels in event trigger \"%s\": %d", e->trgname,
-			 e->nseclabels);
-
-	for (i = 0; i < e->nseclabels; i++)
+	if (getServerVersion(c) < 90100)
 	{
-		char	*withoutescape;
-
-		e->seclabels[i].provider = strdup(PQgetvalue(res, i, PQfnumber(res,
-										  "provider")));
-		withoutescape = PQgetvalue(res, i, PQfnumber(res, "label"));
-		e->seclabels[i].label = PQescapeLiteral(c, withoutescape,
-												strlen(withoutescape));
-		if (e->seclabels[i].label == NULL)
-		{
-			logError("escaping label failed: %s", PQerrorMessage(c));
-			PQclear(res);
-			PQfinish(c);
-			/* XXX leak another connection? */
-			exit(EXIT_FAILURE);
-		}
+		logWarning("ignoring security labels because server does not support it");
+		return;
 	}
 
-	PQclear(res);
-}
-
-void
-freeEventTriggers(PQLEventTrigger *e, int n)
-{
-	if (n > 0)
+	for (i = 0; i < n; i++)
 	{
-		int	i;
-
-		for (i = 0; i < n; i++)
-		{
-			int	j;
-
-			free(e[i].trgname);
-			free(e[i].event);
-			if (e[i].tags)
-				free(e[i].tags);
-			free(e[i].functionname);
-			if (e[i].comment)
-				PQfreemem(e[i].comment);
-			free(e[i].owner);
-
-			/* security labels */
-			for (j = 0; j < e[i].nseclabels; j++)
-			{
-				free(e[i].seclabels[j].provider);
-				PQfreemem(e[i].seclabels[j].label);
-			}
+		e[i].nseclabels = getObjectSecurityLabels(c, PGQ_CLASS_EVENT_TRIGGER,
+							  e[i].oid, 0, &e[i].seclabels);
 
-			if (e[i].seclabels)
-				free(e[i].seclabels);
-		}
-
-		free(e);
+		logDebug("number of security labels in event trigger \"%s\": %d", e[i].trgname,
+				 e[i].nseclabels);
 	}
 }
 
@@ -240,7 +153,9 @@ dumpCreateEventTrigger(FILE *output, PQLEventTrigger *e)
 	if (options.comment && e->comment != NULL)
 	{
 		fprintf(output, "\n\n");
-		fprintf(output, "COMMENT ON EVENT TRIGGER %s IS %s;", evtname, e->comment);
+		fprintf(output, "COMMENT ON EVENT TRIGGER %s IS ", evtname);
+		printComment(output, e->comment);
+		fprintf(output, ";");
 	}
 
 	/* security labels */
@@ -261,14 +176,12 @@ dumpCreateEventTrigger(FILE *output, PQLEventTrigger *e)
 	/* owner */
 	if (options.owner)
 	{
-		char	*owner = formatObjectIdentifier(e->owner);
+		char	*owner = quotedName(e->owner);
 
 		fprintf(output, "\n\n");
 		fprintf(output, "ALTER EVENT TRIGGER %s OWNER TO %s;",
 				evtname,
-				e->owner);
-
-		free(owner);
+				owner);
 	}
 
 	free(evtname);
@@ -329,7 +242,9 @@ dumpAlterEventTrigger(FILE *output, PQLEventTrigger *a, PQLEventTrigger *b)
 				 strcmp(a->comment, b->comment) != 0))
 		{
 			fprintf(output, "\n\n");
-			fprintf(output, "COMMENT ON EVENT TRIGGER %s IS %s;", evtname2, b->comment);
+			fprintf(output, "COMMENT ON EVENT TRIGGER %s IS ", evtname2);
+			printComment(output, b->comment);
+			fprintf(output, ";");
 		}
 		else if (a->comment != NULL && b->comment == NULL)
 		{
@@ -427,14 +342,12 @@ dumpAlterEventTrigger(FILE *output, PQLEventTrigger *a, PQLEventTrigger *b)
 	{
 		if (strcmp(a->owner, b->owner) != 0)
 		{
-			char	*owner = formatObjectIdentifier(b->owner);
+			char	*owner = quotedName(b->owner);
 
 			fprintf(output, "\n\n");
 			fprintf(output, "ALTER EVENT TRIGGER %s OWNER TO %s;",
 					evtname2,
 					owner);
-
-			free(owner);
 		}
 	}
 
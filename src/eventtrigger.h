@@ -9,7 +9,9 @@
 #ifndef EVENTTRIGGER_H
 #define EVENTTRIGGER_H
 
+#include "comment.h"
 #include "common.h"
+#include "seclabel.h"
 
 typedef struct PQLEventTrigger
 {
@@ -28,13 +30,12 @@ typedef struct PQLEventTrigger
 } PQLEventTrigger;
 
 PQLEventTrigger *getEventTriggers(PGconn *c, int *n);
-void getEventTriggerSecurityLabels(PGconn *c, PQLEventTrigger *e);
+void getEventTriggerSecurityLabels(PGconn *c, PQLEventTrigger *e, int n);
 
 void dumpDropEventTrigger(FILE *output, PQLEventTrigger *e);
 void dumpCreateEventTrigger(FILE *output, PQLEventTrigger *e);
 void dumpAlterEventTrigger(FILE *output, PQLEventTrigger *a,
 						   PQLEventTrigger *b);
 
-void freeEventTriggers(PQLEventTrigger *e, int n);
 
 #endif	/* EVENTTRIGGER_H */
@@ -32,17 +32,17 @@ getExtensions(PGconn *c, int *n)
 	PGresult		*res;
 	int				i;
 
-	logNoise("extension: server version: %d", PQserverVersion(c));
+	logNoise("extension: server version: %d", getServerVersion(c));
 
 	/* bail out if we do not support it */
-	if (PQserverVersion(c) < 90100)
+	if (getServerVersion(c) < 90100)
 	{
 		logWarning("ignoring extensions because server does not support it");
 		return NULL;
 	}
 
-	res = PQexec(c,
-				 "SELECT e.oid, extname AS extensionname, nspname, extversion AS version, extrelocatable, obj_description(e.oid, 'pg_extension') AS description FROM pg_extension e LEFT JOIN pg_namespace n ON (e.extnamespace = n.oid) ORDER BY extname");
+	res = execQuery(c,
+				 "SELECT e.oid, extname AS extensionname, nspname, extversion AS version, extrelocatable FROM pg_extension e LEFT JOIN pg_namespace n ON (e.extnamespace = n.oid) ORDER BY extname");
 
 	if (PQresultStatus(res) != PGRES_TUPLES_OK)
 	{
@@ -55,7 +55,7 @@ getExtensions(PGconn *c, int *n)
 
 	*n = PQntuples(res);
 	if (*n > 0)
-		e = (PQLExtension *) malloc(*n * sizeof(PQLExtension));
+		e = (PQLExtension *) arenaAlloc(*n * sizeof(PQLExtension));
 	else
 		e = NULL;
 
@@ -63,30 +63,14 @@ getExtensions(PGconn *c, int *n)
 
 	for (i = 0; i < *n; i++)
 	{
-		char	*withoutescape;
-
 		e[i].oid = strtoul(PQgetvalue(res, i, PQfnumber(res, "oid")), NULL, 10);
-		e[i].extensionname = strdup(PQgetvalue(res, i, PQfnumber(res,
+		e[i].extensionname = arenaStrdup(PQgetvalue(res, i, PQfnumber(res,
 											   "extensionname")));
-		e[i].schemaname = strdup(PQgetvalue(res, i, PQfnumber(res, "nspname")));
-		e[i].version = strdup(PQgetvalue(res, i, PQfnumber(res, "version")));
+		e[i].schemaname = internName(PQgetvalue(res, i, PQfnumber(res, "nspname")));
+		e[i].version = arenaStrdup(PQgetvalue(res, i, PQfnumber(res, "version")));
 		e[i].relocatable = (PQgetvalue(res, i, PQfnumber(res,
 									   "extrelocatable"))[0] == 't');
-		if (PQgetisnull(res, i, PQfnumber(res, "description")))
-			e[i].comment = NULL;
-		else
-		{
-			withoutescape = PQgetvalue(res, i, PQfnumber(res, "description"));
-			e[i].comment = PQescapeLiteral(c, withoutescape, strlen(withoutescape));
-			if (e[i].comment == NULL)
-			{
-				logError("escaping comment failed: %s", PQerrorMessage(c));
-				PQclear(res);
-				PQfinish(c);
-				/* XXX leak another connection? */
-				exit(EXIT_FAILURE);
-			}
-		}
+		e[i].comment = getComment(PGQ_CLASS_EXTENSION, e[i].oid, 0);
 
 		logDebug("extension \"%s\"", e[i].extensionname);
 	}
@@ -96,26 +80,6 @@ getExtensions(PGconn *c, int *n)
 	return e;
 }
 
-void
-freeExtensions(PQLExtension *e, int n)
-{
-	if (n > 0)
-	{
-		int	i;
-
-		for (i = 0; i < n; i++)
-		{
-			free(e[i].extensionname);
-			free(e[i].schemaname);
-			free(e[i].version);
-			if (e[i].comment)
-				PQfreemem(e[i].comment);
-		}
-
-		free(e);
-	}
-}
-
 void
 dumpDropExtension(FILE *output, PQLExtension *e)
 {
@@ -146,7 +110,9 @@ dumpCreateExtension(FILE *output, PQLExtension *e)
 	if (options.comment && e->comment != NULL)
 	{
 		fprintf(output, "\n\n");
-		fprintf(output, "COMMENT ON EXTENSION %s IS %s;", extname, e->comment);
+		fprintf(output, "COMMENT ON EXTENSION %s IS ", extname);
+		printComment(output, e->comment);
+		fprintf(output, ";");
 	}
 
 	free(extname);
@@ -177,7 +143,9 @@ dumpAlterExtension(FILE *output, PQLExtension *a, PQLExtension *b)
 				 strcmp(a->comment, b->comment) != 0))
 		{
 			fprintf(output, "\n\n");
-			fprintf(output, "COMMENT ON EXTENSION %s IS %s;", extname2, b->comment);
+			fprintf(output, "COMMENT ON EXTENSION %s IS ", extname2);
+			printComment(output, b->comment);
+			fprintf(output, ";");
 		}
 		else if (a->comment != NULL && b->comment == NULL)
 		{
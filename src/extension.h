@@ -9,6 +9,7 @@
 #ifndef EXTENSION_H
 #define EXTENSION_H
 
+#include "comment.h"
 #include "common.h"
 
 typedef struct PQLExtension
@@ -26,6 +27,5 @@ void dumpDropExtension(FILE *output, PQLExtension *e);
 void dumpCreateExtension(FILE *output, PQLExtension *e);
 void dumpAlterExtension(FILE *output, PQLExtension *a, PQLExtension *b);
 
-void freeExtensions(PQLExtension *e, int n);
 
 #endif	/* EXTENSION_H */
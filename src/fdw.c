@@ -26,14 +26,14 @@ getForeignDataWrappers(PGconn *c, int *n)
 	PGresult				*res;
 	int						i;
 
-	logNoise("fdw: server version: %d", PQserverVersion(c));
+	logNoise("fdw: server version: %d", getServerVersion(c));
 
-	if (PQserverVersion(c) >= 90100)	/* extension support */
-		res = PQexec(c,
-					 "SELECT f.oid, f.fdwname, f.fdwhandler, f.fdwvalidator, m.nspname AS handlernspname, h.oid AS handleroid, h.proname AS handlername, n.nspname AS validatornspname, v.oid AS validatoroid, v.proname AS validatorname, array_to_string(f.fdwoptions, ', ') AS options, obj_description(f.oid, 'pg_foreign_data_wrapper') AS description, pg_get_userbyid(f.fdwowner) AS fdwowner, f.fdwacl FROM pg_foreign_data_wrapper f LEFT JOIN (pg_proc h INNER JOIN pg_namespace m ON (m.oid = h.pronamespace)) ON (h.oid = f.fdwhandler) LEFT JOIN (pg_proc v INNER JOIN pg_namespace n ON (n.oid = v.pronamespace)) ON (v.oid = f.fdwvalidator) WHERE NOT EXISTS(SELECT 1 FROM pg_depend d WHERE f.oid = d.objid AND d.deptype = 'e') ORDER BY fdwname");
+	if (getServerVersion(c) >= 90100)	/* extension support */
+		res = execQuery(c,
+					 "SELECT f.oid, f.fdwname, f.fdwhandler, f.fdwvalidator, m.nspname AS handlernspname, h.oid AS handleroid, h.proname AS handlername, n.nspname AS validatornspname, v.oid AS validatoroid, v.proname AS validatorname, array_to_string(f.fdwoptions, ', ') AS options, pg_get_userbyid(f.fdwowner) AS fdwowner, f.fdwacl FROM pg_foreign_data_wrapper f LEFT JOIN (pg_proc h INNER JOIN pg_namespace m ON (m.oid = h.pronamespace)) ON (h.oid = f.fdwhandler) LEFT JOIN (pg_proc v INNER JOIN pg_namespace n ON (n.oid = v.pronamespace)) ON (v.oid = f.fdwvalidator) WHERE NOT EXISTS(SELECT 1 FROM pg_depend d WHERE f.oid = d.objid AND d.deptype = 'e') ORDER BY fdwname");
 	else
-		res = PQexec(c,
-					 "SELECT f.oid, f.fdwname, 0 AS fdwhandler, f.fdwvalidator, NULL AS handlernspname, 0 AS handleroid, NULL AS handlername, n.nspname AS validatornspname, v.oid AS validatoroid, v.proname AS validatorname, array_to_string(f.fdwoptions, ', ') AS options, obj_description(f.oid, 'pg_foreign_data_wrapper') AS description, pg_get_userbyid(f.fdwowner) AS fdwowner, f.fdwacl FROM pg_foreign_data_wrapper f LEFT JOIN (pg_proc v INNER JOIN pg_namespace n ON (n.oid = v.pronamespace)) ON (v.oid = f.fdwvalidator) ORDER BY fdwname");
+		res = execQuery(c,
+					 "SELECT f.oid, f.fdwname, 0 AS fdwhandler, f.fdwvalidator, NULL AS handlernspname, 0 AS handleroid, NULL AS handlername, n.nspname AS validatornspname, v.oid AS validatoroid, v.proname AS validatorname, array_to_string(f.fdwoptions, ', ') AS options, pg_get_userbyid(f.fdwowner) AS fdwowner, f.fdwacl FROM pg_foreign_data_wrapper f LEFT JOIN (pg_proc v INNER JOIN pg_namespace n ON (n.oid = v.pronamespace)) ON (v.oid = f.fdwvalidator) ORDER BY fdwname");
 
 	if (PQresultStatus(res) != PGRES_TUPLES_OK)
 	{
@@ -46,7 +46,7 @@ getForeignDataWrappers(PGconn *c, int *n)
 
 	*n = PQntuples(res);
 	if (*n > 0)
-		f = (PQLForeignDataWrapper *) malloc(*n * sizeof(PQLForeignDataWrapper));
+		f = (PQLForeignDataWrapper *) arenaAlloc(*n * sizeof(PQLForeignDataWrapper));
 	else
 		f = NULL;
 
@@ -54,18 +54,16 @@ getForeignDataWrappers(PGconn *c, int *n)
 
 	for (i = 0; i < *n; i++)
 	{
-		char	*withoutescape;
-
 		f[i].oid = strtoul(PQgetvalue(res, i, PQfnumber(res, "oid")), NULL, 10);
-		f[i].fdwname = strdup(PQgetvalue(res, i, PQfnumber(res, "fdwname")));
+		f[i].fdwname = arenaStrdup(PQgetvalue(res, i, PQfnumber(res, "fdwname")));
 		/* handler */
 		if (strcmp(PQgetvalue(res, i, PQfnumber(res, "fdwhandler")), "0") != 0)
 		{
 			f[i].handler.oid = strtoul(PQgetvalue(res, i, PQfnumber(res, "handleroid")),
 									   NULL, 10);
-			f[i].handler.schemaname = strdup(PQgetvalue(res, i, PQfnumber(res,
+			f[i].handler.schemaname = internName(PQgetvalue(res, i, PQfnumber(res,
 											 "handlernspname")));
-			f[i].handler.objectname = strdup(PQgetvalue(res, i, PQfnumber(res,
+			f[i].handler.objectname = internName(PQgetvalue(res, i, PQfnumber(res,
 											 "handlername")));
 		}
 		else
@@ -78,9 +76,9 @@ getForeignDataWrappers(PGconn *c, int *n)
 		{
 			f[i].validator.oid = strtoul(PQgetvalue(res, i, PQfnumber(res, "validatoroid")),
 										 NULL, 10);
-			f[i].validator.schemaname = strdup(PQgetvalue(res, i, PQfnumber(res,
+			f[i].validator.schemaname = internName(PQgetvalue(res, i, PQfnumber(res,
 											   "validatornspname")));
-			f[i].validator.objectname = strdup(PQgetvalue(res, i, PQfnumber(res,
+			f[i].validator.objectname = internName(PQgetvalue(res, i, PQfnumber(res,
 											   "validatorname")));
 		}
 		else
@@ -92,29 +90,15 @@ getForeignDataWrappers(PGconn *c, int *n)
 		if (PQgetisnull(res, i, PQfnumber(res, "options")))
 			f[i].options = NULL;
 		else
-			f[i].options = strdup(PQgetvalue(res, i, PQfnumber(res, "options")));
+			f[i].options = arenaStrdup(PQgetvalue(res, i, PQfnumber(res, "options")));
 
-		f[i].owner = strdup(PQgetvalue(res, i, PQfnumber(res, "fdwowner")));
+		f[i].owner = internName(PQgetvalue(res, i, PQfnumber(res, "fdwowner")));
 		if (PQgetisnull(res, i, PQfnumber(res, "fdwacl")))
 			f[i].acl = NULL;
 		else
-			f[i].acl = strdup(PQgetvalue(res, i, PQfnumber(res, "fdwacl")));
+			f[i].acl = arenaStrdup(PQgetvalue(res, i, PQfnumber(res, "fdwacl")));
 
-		if (PQgetisnull(res, i, PQfnumber(res, "description")))
-			f[i].comment = NULL;
-		else
-		{
-			withoutescape = PQgetvalue(res, i, PQfnumber(res, "description"));
-			f[i].comment = PQescapeLiteral(c, withoutescape, strlen(withoutescape));
-			if (f[i].comment == NULL)
-			{
-				logError("escaping comment failed: %s", PQerrorMessage(c));
-				PQclear(res);
-				PQfinish(c);
-				/* XXX leak another connection? */
-				exit(EXIT_FAILURE);
-			}
-		}
+		f[i].comment = getComment(PGQ_CLASS_FOREIGN_DATA_WRAPPER, f[i].oid, 0);
 
 		logDebug("foreign data wrapper \"%s\"", f[i].fdwname);
 	}
@@ -124,37 +108,6 @@ getForeignDataWrappers(PGconn *c, int *n)
 	return f;
 }
 
-void
-freeForeignDataWrappers(PQLForeignDataWrapper *f, int n)
-{
-	if (n > 0)
-	{
-		int	i;
-
-		for (i = 0; i < n; i++)
-		{
-			free(f[i].fdwname);
-			if (f[i].handler.schemaname)
-				free(f[i].handler.schemaname);
-			if (f[i].handler.objectname)
-				free(f[i].handler.objectname);
-			if (f[i].validator.schemaname)
-				free(f[i].validator.schemaname);
-			if (f[i].validator.objectname)
-				free(f[i].validator.objectname);
-			free(f[i].owner);
-			if (f[i].options)
-				free(f[i].options);
-			if (f[i].acl)
-				free(f[i].acl);
-			if (f[i].comment)
-				PQfreemem(f[i].comment);
-		}
-
-		free(f);
-	}
-}
-
 void
 dumpDropForeignDataWrapper(FILE *output, PQLForeignDataWrapper *f)
 {
@@ -183,30 +136,27 @@ dumpCreateForeignDataWrapper(FILE *output, PQLForeignDataWrapper *f)
 
 	if (f->options)
 	{
-		stringList		*sl;
-		stringListCell	*cell;
+		PQLOptionSet	*sl;
+		int				k;
 		bool			first = true;
 
-		sl = buildStringList(f->options);
+		sl = buildOptionSet(f->options);
 		fprintf(output, " OPTIONS (");
-		for (cell = sl->head; cell; cell = cell->next)
+		for (k = 0; k < sl->nitems; k++)
 		{
-			char	*str;
-
-			str = strchr(cell->value, '=');
-			*str++ = '\0';
+			PQLOption	*opt = &sl->items[k];
 
 			if (first)
 			{
-				fprintf(output, "%s '%s'", cell->value, str);
+				fprintf(output, "%s '%s'", opt->key, opt->value);
 				first = false;
 			}
 			else
-				fprintf(output, ", %s '%s'", cell->value, str);
+				fprintf(output, ", %s '%s'", opt->key, opt->value);
 		}
 		fprintf(output, ")");
 
-		freeStringList(sl);
+		freeOptionSet(sl);
 	}
 
 	fprintf(output, ";");
@@ -215,20 +165,19 @@ dumpCreateForeignDataWrapper(FILE *output, PQLForeignDataWrapper *f)
 	if (options.comment && f->comment != NULL)
 	{
 		fprintf(output, "\n\n");
-		fprintf(output, "COMMENT ON FOREIGN DATA WRAPPER %s IS %s;", fdwname,
-				f->comment);
+		fprintf(output, "COMMENT ON FOREIGN DATA WRAPPER %s IS ", fdwname);
+		printComment(output, f->comment);
+		fprintf(output, ";");
 	}
 
 	/* owner */
 	if (options.owner)
 	{
-		char	*owner = formatObjectIdentifier(f->owner);
+		char	*owner = quotedName(f->owner);
 
 		fprintf(output, "\n\n");
 		fprintf(output, "ALTER FOREIGN DATA WRAPPER %s OWNER TO %s;", fdwname,
 				owner);
-
-		free(owner);
 	}
 
 	/* privileges */
@@ -297,64 +246,58 @@ dumpAlterForeignDataWrapper(FILE *output, PQLForeignDataWrapper *a,
 	/* options */
 	if (a->options == NULL && b->options != NULL)
 	{
-		stringList		*sl;
-		stringListCell	*cell;
+		PQLOptionSet	*sl;
+		int				k;
 		bool			first = true;
 
-		sl = buildStringList(b->options);
+		sl = buildOptionSet(b->options);
 		fprintf(output, "\n\n");
 		fprintf(output, "ALTER FOREIGN DATA WRAPPER %s OPTIONS (", fdwname2);
-		for (cell = sl->head; cell; cell = cell->next)
+		for (k = 0; k < sl->nitems; k++)
 		{
-			char	*str;
-
-			str = strchr(cell->value, '=');
-			*str++ = '\0';
+			PQLOption	*opt = &sl->items[k];
 
 			if (first)
 			{
-				fprintf(output, "ADD %s '%s'", cell->value, str);
+				fprintf(output, "ADD %s '%s'", opt->key, opt->value);
 				first = false;
 			}
 			else
-				fprintf(output, ", ADD %s '%s'", cell->value, str);
+				fprintf(output, ", ADD %s '%s'", opt->key, opt->value);
 		}
 		fprintf(output, ");");
 
-		freeStringList(sl);
+		freeOptionSet(sl);
 	}
 	else if (a->options != NULL && b->options == NULL)
 	{
-		stringList		*sl;
-		stringListCell	*cell;
+		PQLOptionSet	*sl;
+		int				k;
 		bool			first = true;
 
-		sl = buildStringList(a->options);
+		sl = buildOptionSet(a->options);
 		fprintf(output, "\n\n");
 		fprintf(output, "ALTER FOREIGN DATA WRAPPER %s OPTIONS (", fdwname1);
-		for (cell = sl->head; cell; cell = cell->next)
+		for (k = 0; k < sl->nitems; k++)
 		{
-			char	*str;
-
-			str = strchr(cell->value, '=');
-			*str = '\0';
+			PQLOption	*opt = &sl->items[k];
 
 			if (first)
 			{
-				fprintf(output, "DROP %s", cell->value);
+				fprintf(output, "DROP %s", opt->key);
 				first = false;
 			}
 			else
-				fprintf(output, ", DROP %s", cell->value);
+				fprintf(output, ", DROP %s", opt->key);
 		}
 		fprintf(output, ");");
 
-		freeStringList(sl);
+		freeOptionSet(sl);
 	}
 	else if (a->options != NULL && b->options != NULL &&
 			 strcmp(a->options, b->options) != 0)
 	{
-		stringList	*rlist, *ilist, *slist;
+		PQLOptionSet	*rlist, *ilist, *slist;
 		bool		first = true;
 
 		/* reset options that are only presented in the first set */
@@ -362,23 +305,23 @@ dumpAlterForeignDataWrapper(FILE *output, PQLForeignDataWrapper *a,
 									true);
 		if (rlist)
 		{
-			stringListCell	*cell;
+			int				k;
 
 			fprintf(output, "\n\n");
 			fprintf(output, "ALTER FOREIGN DATA WRAPPER %s OPTIONS (", fdwname2);
-			for (cell = rlist->head; cell; cell = cell->next)
+			for (k = 0; k < rlist->nitems; k++)
 			{
 				if (first)
 				{
-					fprintf(output, " DROP %s", cell->value);
+					fprintf(output, " DROP %s", rlist->items[k].key);
 					first = false;
 				}
 				else
-					fprintf(output, ", DROP %s", cell->value);
+					fprintf(output, ", DROP %s", rlist->items[k].key);
 			}
 			fprintf(output, ");");
 
-			freeStringList(rlist);
+			freeOptionSet(rlist);
 		}
 
 		/*
@@ -388,28 +331,25 @@ dumpAlterForeignDataWrapper(FILE *output, PQLForeignDataWrapper *a,
 		ilist = setOperationOptions(a->options, b->options, PGQ_INTERSECT, true, true);
 		if (ilist)
 		{
-			stringListCell	*cell;
+			int				k;
 
 			fprintf(output, "\n\n");
 			fprintf(output, "ALTER FOREIGN DATA WRAPPER %s OPTIONS (", fdwname2);
-			for (cell = ilist->head; cell; cell = cell->next)
+			for (k = 0; k < ilist->nitems; k++)
 			{
-				char	*str;
-
-				str = strchr(cell->value, '=');
-				*str++ = '\0';
+				PQLOption	*opt = &ilist->items[k];
 
 				if (first)
 				{
-					fprintf(output, " SET %s '%s'", cell->value, str);
+					fprintf(output, " SET %s '%s'", opt->key, opt->value);
 					first = false;
 				}
 				else
-					fprintf(output, ", SET %s '%s'", cell->value, str);
+					fprintf(output, ", SET %s '%s'", opt->key, opt->value);
 			}
 			fprintf(output, ");");
 
-			freeStringList(ilist);
+			freeOptionSet(ilist);
 		}
 
 		/*
@@ -419,29 +359,26 @@ dumpAlterForeignDataWrapper(FILE *output, PQLForeignDataWrapper *a,
 									true);
 		if (slist)
 		{
-			stringListCell	*cell;
+			int				k;
 			bool			first = true;
 
 			fprintf(output, "\n\n");
 			fprintf(output, "ALTER FOREIGN DATA WRAPPER %s OPTIONS (", fdwname2);
-			for (cell = slist->head; cell; cell = cell->next)
+			for (k = 0; k < slist->nitems; k++)
 			{
-				char	*str;
-
-				str = strchr(cell->value, '=');
-				*str++ = '\0';
+				PQLOption	*opt = &slist->items[k];
 
 				if (first)
 				{
-					fprintf(output, "ADD %s '%s'", cell->value, str);
+					fprintf(output, "ADD %s '%s'", opt->key, opt->value);
 					first = false;
 				}
 				else
-					fprintf(output, ", ADD %s '%s'", cell->value, str);
+					fprintf(output, ", ADD %s '%s'", opt->key, opt->value);
 			}
 			fprintf(output, ");");
 
-			freeStringList(slist);
+			freeOptionSet(slist);
 		}
 	}
 
@@ -453,8 +390,9 @@ dumpAlterForeignDataWrapper(FILE *output, PQLForeignDataWrapper *a,
 				 strcmp(a->comment, b->comment) != 0))
 		{
 			fprintf(output, "\n\n");
-			fprintf(output, "COMMENT ON FOREIGN DATA WRAPPER %s IS %s;", fdwname2,
-					b->comment);
+			fprintf(output, "COMMENT ON FOREIGN DATA WRAPPER %s IS ", fdwname2);
+			printComment(output, b->comment);
+			fprintf(output, ";");
 		}
 		else if (a->comment != NULL && b->comment == NULL)
 		{
@@ -468,13 +406,11 @@ dumpAlterForeignDataWrapper(FILE *output, PQLForeignDataWrapper *a,
 	{
 		if (strcmp(a->owner, b->owner) != 0)
 		{
-			char	*owner = formatObjectIdentifier(b->owner);
+			char	*owner = quotedName(b->owner);
 
 			fprintf(output, "\n\n");
 			fprintf(output, "ALTER FOREIGN DATA WRAPPER %s OWNER TO %s;", fdwname2,
 					owner);
-
-			free(owner);
 		}
 	}
 
@@ -9,6 +9,7 @@
 #ifndef FDW_H
 #define FDW_H
 
+#include "comment.h"
 #include "common.h"
 #include "privileges.h"
 
@@ -32,6 +33,5 @@ void dumpCreateForeignDataWrapper(FILE *output, PQLForeignDataWrapper *f);
 void dumpAlterForeignDataWrapper(FILE *output, PQLForeignDataWrapper *a,
 								 PQLForeignDataWrapper *b);
 
-void freeForeignDataWrappers(PQLForeignDataWrapper *f, int n);
 
 #endif	/* FDW_H */
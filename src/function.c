@@ -40,9 +40,9 @@ getProcFunctions(PGconn *c, int *n, char t)
 	int			i;
 
 	if (t == 'f')
-		logNoise("function: server version: %d", PQserverVersion(c));
+		logNoise("function: server version: %d", getServerVersion(c));
 	else if (t == 'p')
-		logNoise("procedure: server version: %d", PQserverVersion(c));
+		logNoise("procedure: server version: %d", getServerVersion(c));
 	else
 	{
 		logError("type is not a function/procedure");
@@ -50,32 +50,32 @@ getProcFunctions(PGconn *c, int *n, char t)
 	}
 
 	/* prokind is new in 11 */
-	if (PQserverVersion(c) >= 110000)
+	if (getServerVersion(c) >= 110000)
 	{
 		if (t == 'f')
-			query = psprintf("SELECT p.oid, nspname, proname, proretset, prosrc, pg_get_function_arguments(p.oid) as funcargs, pg_get_function_identity_arguments(p.oid) as funciargs, pg_get_function_result(p.oid) as funcresult, prokind, provolatile, proisstrict, prosecdef, proleakproof, array_to_string(proconfig, ',') AS proconfig, proparallel, procost, prorows, (SELECT lanname FROM pg_language WHERE oid = prolang) AS lanname, obj_description(p.oid, 'pg_proc') AS description, pg_get_userbyid(proowner) AS proowner, proacl FROM pg_proc p INNER JOIN pg_namespace n ON (n.oid = p.pronamespace) WHERE prokind IN ('f', 'w') AND n.nspname !~ '^pg_' AND n.nspname <> 'information_schema' %s%s AND NOT EXISTS(SELECT 1 FROM pg_depend d WHERE p.oid = d.objid AND d.deptype = 'e') ORDER BY nspname, proname, pg_get_function_identity_arguments(p.oid)", include_schema_str, exclude_schema_str);
+			query = psprintf("SELECT p.oid, nspname, proname, proretset, prosrc, pg_get_function_arguments(p.oid) as funcargs, pg_get_function_identity_arguments(p.oid) as funciargs, pg_get_function_result(p.oid) as funcresult, prokind, provolatile, proisstrict, prosecdef, proleakproof, array_to_string(proconfig, ',') AS proconfig, proparallel, procost, prorows, (SELECT lanname FROM pg_language WHERE oid = prolang) AS lanname, pg_get_userbyid(proowner) AS proowner, proacl FROM pg_proc p INNER JOIN pg_namespace n ON (n.oid = p.pronamespace) WHERE prokind IN ('f', 'w') AND n.nspname !~ '^pg_' AND n.nspname <> 'information_schema' %s%s AND NOT EXISTS(SELECT 1 FROM pg_depend d WHERE p.oid = d.objid AND d.deptype = 'e') ORDER BY nspname, proname, pg_get_function_identity_arguments(p.oid)", include_schema_str, exclude_schema_str);
 		else if (t == 'p')
-			query = psprintf("SELECT p.oid, nspname, proname, proretset, prosrc, pg_get_function_arguments(p.oid) as funcargs, pg_get_function_identity_arguments(p.oid) as funciargs, pg_get_function_result(p.oid) as funcresult, prokind, provolatile, proisstrict, prosecdef, proleakproof, array_to_string(proconfig, ',') AS proconfig, proparallel, procost, prorows, (SELECT lanname FROM pg_language WHERE oid = prolang) AS lanname, obj_description(p.oid, 'pg_proc') AS description, pg_get_userbyid(proowner) AS proowner, proacl FROM pg_proc p INNER JOIN pg_namespace n ON (n.oid = p.pronamespace) WHERE prokind = 'p' AND n.nspname !~ '^pg_' AND n.nspname <> 'information_schema' %s%s AND NOT EXISTS(SELECT 1 FROM pg_depend d WHERE p.oid = d.objid AND d.deptype = 'e') ORDER BY nspname, proname, pg_get_function_identity_arguments(p.oid)", include_schema_str, exclude_schema_str);
+			query = psprintf("SELECT p.oid, nspname, proname, proretset, prosrc, pg_get_function_arguments(p.oid) as funcargs, pg_get_function_identity_arguments(p.oid) as funciargs, pg_get_function_result(p.oid) as funcresult, prokind, provolatile, proisstrict, prosecdef, proleakproof, array_to_string(proconfig, ',') AS proconfig, proparallel, procost, prorows, (SELECT lanname FROM pg_language WHERE oid = prolang) AS lanname, pg_get_userbyid(proowner) AS proowner, proacl FROM pg_proc p INNER JOIN pg_namespace n ON (n.oid = p.pronamespace) WHERE prokind = 'p' AND n.nspname !~ '^pg_' AND n.nspname <> 'information_schema' %s%s AND NOT EXISTS(SELECT 1 FROM pg_depend d WHERE p.oid = d.objid AND d.deptype = 'e') ORDER BY nspname, proname, pg_get_function_identity_arguments(p.oid)", include_schema_str, exclude_schema_str);
 	}
 	/* parallel is new in 9.6 ('u'nsafe is the default) */
-	else if (PQserverVersion(c) >= 90600)
+	else if (getServerVersion(c) >= 90600)
 	{
-		query = psprintf("SELECT p.oid, nspname, proname, proretset, prosrc, pg_get_function_arguments(p.oid) as funcargs, pg_get_function_identity_arguments(p.oid) as funciargs, pg_get_function_result(p.oid) as funcresult, CASE WHEN proisagg THEN 'a' WHEN proiswindow THEN 'w' ELSE 'f' END AS prokind, provolatile, proisstrict, prosecdef, proleakproof, array_to_string(proconfig, ',') AS proconfig, proparallel, procost, prorows, (SELECT lanname FROM pg_language WHERE oid = prolang) AS lanname, obj_description(p.oid, 'pg_proc') AS description, pg_get_userbyid(proowner) AS proowner, proacl FROM pg_proc p INNER JOIN pg_namespace n ON (n.oid = p.pronamespace) WHERE n.nspname !~ '^pg_' AND n.nspname <> 'information_schema' %s%s AND NOT EXISTS(SELECT 1 FROM pg_depend d WHERE p.oid = d.objid AND d.deptype = 'e') ORDER BY nspname, proname, pg_get_function_identity_arguments(p.oid)", include_schema_str, exclude_schema_str);
+		query = psprintf("SELECT p.oid, nspname, proname, proretset, prosrc, pg_get_function_arguments(p.oid) as funcargs, pg_get_function_identity_arguments(p.oid) as funciargs, pg_get_function_result(p.oid) as funcresult, CASE WHEN proisagg THEN 'a' WHEN proiswindow THEN 'w' ELSE 'f' END AS prokind, provolatile, proisstrict, prosecdef, proleakproof, array_to_string(proconfig, ',') AS proconfig, proparallel, procost, prorows, (SELECT lanname FROM pg_language WHERE oid = prolang) AS lanname, pg_get_userbyid(proowner) AS proowner, proacl FROM pg_proc p INNER JOIN pg_namespace n ON (n.oid = p.pronamespace) WHERE n.nspname !~ '^pg_' AND n.nspname <> 'information_schema' %s%s AND NOT EXISTS(SELECT 1 FROM pg_depend d WHERE p.oid = d.objid AND d.deptype = 'e') ORDER BY nspname, proname, pg_get_function_identity_arguments(p.oid)", include_schema_str, exclude_schema_str);
 	}
-	else if (PQserverVersion(c) >= 90200)	/* proleakproof is new in 9.2 */
+	else if (getServerVersion(c) >= 90200)	/* proleakproof is new in 9.2 */
 	{
-		query = psprintf("SELECT p.oid, nspname, proname, proretset, prosrc, pg_get_function_arguments(p.oid) as funcargs, pg_get_function_identity_arguments(p.oid) as funciargs, pg_get_function_result(p.oid) as funcresult, CASE WHEN proisagg THEN 'a' WHEN proiswindow THEN 'w' ELSE 'f' END AS prokind, provolatile, proisstrict, prosecdef, proleakproof, array_to_string(proconfig, ',') AS proconfig, 'u' AS proparallel, procost, prorows, (SELECT lanname FROM pg_language WHERE oid = prolang) AS lanname, obj_description(p.oid, 'pg_proc') AS description, pg_get_userbyid(proowner) AS proowner, proacl FROM pg_proc p INNER JOIN pg_namespace n ON (n.oid = p.pronamespace) WHERE n.nspname !~ '^pg_' AND n.nspname <> 'information_schema' %s%s AND NOT EXISTS(SELECT 1 FROM pg_depend d WHERE p.oid = d.objid AND d.deptype = 'e') ORDER BY nspname, proname, pg_get_function_identity_arguments(p.oid)", include_schema_str, exclude_schema_str);
+		query = psprintf("SELECT p.oid, nspname, proname, proretset, prosrc, pg_get_function_arguments(p.oid) as funcargs, pg_get_function_identity_arguments(p.oid) as funciargs, pg_get_function_result(p.oid) as funcresult, CASE WHEN proisagg THEN 'a' WHEN proiswindow THEN 'w' ELSE 'f' END AS prokind, provolatile, proisstrict, prosecdef, proleakproof, array_to_string(proconfig, ',') AS proconfig, 'u' AS proparallel, procost, prorows, (SELECT lanname FROM pg_language WHERE oid = prolang) AS lanname, pg_get_userbyid(proowner) AS proowner, proacl FROM pg_proc p INNER JOIN pg_namespace n ON (n.oid = p.pronamespace) WHERE n.nspname !~ '^pg_' AND n.nspname <> 'information_schema' %s%s AND NOT EXISTS(SELECT 1 FROM pg_depend d WHERE p.oid = d.objid AND d.deptype = 'e') ORDER BY nspname, proname, pg_get_function_identity_arguments(p.oid)", include_schema_str, exclude_schema_str);
 	}
-	else if (PQserverVersion(c) >= 90100)	/* extension support */
+	else if (getServerVersion(c) >= 90100)	/* extension support */
 	{
-		query = psprintf("SELECT p.oid, nspname, proname, proretset, prosrc, pg_get_function_arguments(p.oid) as funcargs, pg_get_function_identity_arguments(p.oid) as funciargs, pg_get_function_result(p.oid) as funcresult, CASE WHEN proisagg THEN 'a' WHEN proiswindow THEN 'w' ELSE 'f' END AS prokind, provolatile, proisstrict, prosecdef, false AS proleakproof, array_to_string(proconfig, ',') AS proconfig, 'u' AS proparallel, procost, prorows, (SELECT lanname FROM pg_language WHERE oid = prolang) AS lanname, obj_description(p.oid, 'pg_proc') AS description, pg_get_userbyid(proowner) AS proowner, proacl FROM pg_proc p INNER JOIN pg_namespace n ON (n.oid = p.pronamespace) WHERE n.nspname !~ '^pg_' AND n.nspname <> 'information_schema' %s%s AND NOT EXISTS(SELECT 1 FROM pg_depend d WHERE p.oid = d.objid AND d.deptype = 'e') ORDER BY nspname, proname, pg_get_function_identity_arguments(p.oid)", include_schema_str, exclude_schema_str);
+		query = psprintf("SELECT p.oid, nspname, proname, proretset, prosrc, pg_get_function_arguments(p.oid) as funcargs, pg_get_function_identity_arguments(p.oid) as funciargs, pg_get_function_result(p.oid) as funcresult, CASE WHEN proisagg THEN 'a' WHEN proiswindow THEN 'w' ELSE 'f' END AS prokind, provolatile, proisstrict, prosecdef, false AS proleakproof, array_to_string(proconfig, ',') AS proconfig, 'u' AS proparallel, procost, prorows, (SELECT lanname FROM pg_language WHERE oid = prolang) AS lanname, pg_get_userbyid(proowner) AS proowner, proacl FROM pg_proc p INNER JOIN pg_namespace n ON (n.oid = p.pronamespace) WHERE n.nspname !~ '^pg_' AND n.nspname <> 'information_schema' %s%s AND NOT EXISTS(SELECT 1 FROM pg_depend d WHERE p.oid = d.objid AND d.deptype = 'e') ORDER BY nspname, proname, pg_get_function_identity_arguments(p.oid)", include_schema_str, exclude_schema_str);
 	}
 	else
 	{
-		query = psprintf("SELECT p.oid, nspname, proname, proretset, prosrc, pg_get_function_arguments(p.oid) as funcargs, pg_get_function_identity_arguments(p.oid) as funciargs, pg_get_function_result(p.oid) as funcresult, CASE WHEN proisagg THEN 'a' WHEN proiswindow THEN 'w' ELSE 'f' END AS prokind, NULL AS prokind, provolatile, proisstrict, prosecdef, false AS proleakproof, array_to_string(proconfig, ',') AS proconfig, 'u' AS proparallel, procost, prorows, (SELECT lanname FROM pg_language WHERE oid = prolang) AS lanname, obj_description(p.oid, 'pg_proc') AS description, pg_get_userbyid(proowner) AS proowner, proacl FROM pg_proc p INNER JOIN pg_namespace n ON (n.oid = p.pronamespace) WHERE n.nspname !~ '^pg_' AND n.nspname <> 'information_schema' %s%s ORDER BY nspname, proname, pg_get_function_identity_arguments(p.oid)", include_schema_str, exclude_schema_str);
+		query = psprintf("SELECT p.oid, nspname, proname, proretset, prosrc, pg_get_function_arguments(p.oid) as funcargs, pg_get_function_identity_arguments(p.oid) as funciargs, pg_get_function_result(p.oid) as funcresult, CASE WHEN proisagg THEN 'a' WHEN proiswindow THEN 'w' ELSE 'f' END AS prokind, NULL AS prokind, provolatile, proisstrict, prosecdef, false AS proleakproof, array_to_string(proconfig, ',') AS proconfig, 'u' AS proparallel, procost, prorows, (SELECT lanname FROM pg_language WHERE oid = prolang) AS lanname, pg_get_userbyid(proowner) AS proowner, proacl FROM pg_proc p INNER JOIN pg_namespace n ON (n.oid = p.pronamespace) WHERE n.nspname !~ '^pg_' AND n.nspname <> 'information_schema' %s%s ORDER BY nspname, proname, pg_get_function_identity_arguments(p.oid)", include_schema_str, exclude_schema_str);
 	}
 
-	res = PQexec(c, query);
+	res = execQuery(c, query);
 
 	pfree(query);
 
@@ -90,7 +90,7 @@ getProcFunctions(PGconn *c, int *n, char t)
 
 	*n = PQntuples(res);
 	if (*n > 0)
-		f = (PQLFunction *) malloc(*n * sizeof(PQLFunction));
+		f = (PQLFunction *) arenaAlloc(*n * sizeof(PQLFunction));
 	else
 		f = NULL;
 
@@ -101,55 +101,39 @@ getProcFunctions(PGconn *c, int *n, char t)
 
 	for (i = 0; i < *n; i++)
 	{
-		char	*withoutescape;
-
 		f[i].obj.oid = strtoul(PQgetvalue(res, i, PQfnumber(res, "oid")), NULL, 10);
-		f[i].obj.schemaname = strdup(PQgetvalue(res, i, PQfnumber(res, "nspname")));
-		f[i].obj.objectname = strdup(PQgetvalue(res, i, PQfnumber(res, "proname")));
-		f[i].arguments = strdup(PQgetvalue(res, i, PQfnumber(res, "funcargs")));
-		f[i].iarguments = strdup(PQgetvalue(res, i, PQfnumber(res,
+		f[i].obj.schemaname = internName(PQgetvalue(res, i, PQfnumber(res, "nspname")));
+		f[i].obj.objectname = internName(PQgetvalue(res, i, PQfnumber(res, "proname")));
+		f[i].arguments = arenaStrdup(PQgetvalue(res, i, PQfnumber(res, "funcargs")));
+		f[i].iarguments = arenaStrdup(PQgetvalue(res, i, PQfnumber(res,
 											"funciargs")));	/* don't print defaults */
-		f[i].body = strdup(PQgetvalue(res, i, PQfnumber(res, "prosrc")));
-		f[i].returntype = strdup(PQgetvalue(res, i, PQfnumber(res, "funcresult")));
-		f[i].language = strdup(PQgetvalue(res, i, PQfnumber(res, "lanname")));
+		f[i].body = arenaStrdup(PQgetvalue(res, i, PQfnumber(res, "prosrc")));
+		f[i].returntype = arenaStrdup(PQgetvalue(res, i, PQfnumber(res, "funcresult")));
+		f[i].language = arenaStrdup(PQgetvalue(res, i, PQfnumber(res, "lanname")));
 		f[i].kind = PQgetvalue(res, i, PQfnumber(res, "prokind"))[0];
 		f[i].funcvolatile = PQgetvalue(res, i, PQfnumber(res, "provolatile"))[0];
 		f[i].isstrict = (PQgetvalue(res, i, PQfnumber(res, "proisstrict"))[0] == 't');
 		f[i].secdefiner = (PQgetvalue(res, i, PQfnumber(res, "prosecdef"))[0] == 't');
 		f[i].leakproof = (PQgetvalue(res, i, PQfnumber(res, "proleakproof"))[0] == 't');
 		f[i].parallel = PQgetvalue(res, i, PQfnumber(res, "proparallel"))[0];
-		f[i].cost = strdup(PQgetvalue(res, i, PQfnumber(res, "procost")));
-		f[i].rows = strdup(PQgetvalue(res, i, PQfnumber(res, "prorows")));
+		f[i].cost = arenaStrdup(PQgetvalue(res, i, PQfnumber(res, "procost")));
+		f[i].rows = arenaStrdup(PQgetvalue(res, i, PQfnumber(res, "prorows")));
 		if (PQgetisnull(res, i, PQfnumber(res, "proconfig")))
 			f[i].configparams = NULL;
 		else
-			f[i].configparams = strdup(PQgetvalue(res, i, PQfnumber(res, "proconfig")));
-		if (PQgetisnull(res, i, PQfnumber(res, "description")))
-			f[i].comment = NULL;
-		else
-		{
-			withoutescape = PQgetvalue(res, i, PQfnumber(res, "description"));
-			f[i].comment = PQescapeLiteral(c, withoutescape, strlen(withoutescape));
-			if (f[i].comment == NULL)
-			{
-				logError("escaping comment failed: %s", PQerrorMessage(c));
-				PQclear(res);
-				PQfinish(c);
-				/* XXX leak another connection? */
-				exit(EXIT_FAILURE);
-			}
-		}
+			f[i].configparams = arenaStrdup(PQgetvalue(res, i, PQfnumber(res, "proconfig")));
+		f[i].comment = getComment(PGQ_CLASS_PROC, f[i].obj.oid, 0);
 
-		f[i].owner = strdup(PQgetvalue(res, i, PQfnumber(res, "proowner")));
+		f[i].owner = internName(PQgetvalue(res, i, PQfnumber(res, "proowner")));
 		if (PQgetisnull(res, i, PQfnumber(res, "proacl")))
 			f[i].acl = NULL;
 		else
-			f[i].acl = strdup(PQgetvalue(res, i, PQfnumber(res, "proacl")));
+			f[i].acl = arenaStrdup(PQgetvalue(res, i, PQfnumber(res, "proacl")));
 
 		/*
 		 * Security labels are not assigned here (see getFunctionSecurityLabels),
 		 * but default values are essential to avoid having trouble in
-		 * freeFunctions.
+		 * the dump routines.
 		 */
 		f[i].nseclabels = 0;
 		f[i].seclabels = NULL;
@@ -189,117 +173,40 @@ compareFunctions(PQLFunction *a, PQLFunction *b)
 }
 
 void
-getProcFunctionSecurityLabels(PGconn *c, PQLFunction *f, char t)
+getProcFunctionSecurityLabels(PGconn *c, PQLFunction *f, int n, char t)
 {
-	char		*query;
-	PGresult	*res;
 	int			i;
 
-	if (PQserverVersion(c) < 90100)
-	{
-		logWarning("ignoring security labels because server does not support it");
+	if (n == 0)
 		return;
-	}
-
-	query = psprintf("SELECT provider, label FROM pg_seclabel s INNER JOIN pg_class c ON (s.classoid = c.oid) WHERE c.relname = 'pg_proc' AND s.objoid = %u ORDER BY provider",
-			 f->obj.oid);
-
-	res = PQexec(c, query);
-
-	pfree(query);
-
-	if (PQresultStatus(res) != PGRES_TUPLES_OK)
-	{
-		logError("query failed: %s", PQresultErrorMessage(res));
-		PQclear(res);
-		PQfinish(c);
-		/* XXX leak another connection? */
-		exit(EXIT_FAILURE);
-	}
-
-	f->nseclabels = PQntuples(res);
-	if (f->nseclabels > 0)
-		f->seclabels = (PQLSecLabel *) malloc(f->nseclabels * sizeof(PQLSecLabel));
-	else
-		f->seclabels = NULL;
 
-	if (t == 'f')
-		logDebug("number of security labels in function \"%s\".\"%s\"(%s): %d",
-				 f->obj.schemaname, f->obj.objectname, f->arguments, f->nseclabels);
-	else
-		logDebug("number of security labels in procedure \"%s\".\"%s\"(%s): %d",
-				 f->obj.schemaname, f->obj.objectname, f->arguments, f->nseclabels);
-
-	for (i = 0; i < f->nseclabels; i++)
+	if (getServerVersion(c) < 90100)
 	{
-		char	*withoutescape;
-
-		f->seclabels[i].provider = strdup(PQgetvalue(res, i, PQfnumber(res,
-										  "provider")));
-		withoutescape = PQgetvalue(res, i, PQfnumber(res, "label"));
-		f->seclabels[i].label = PQescapeLiteral(c, withoutescape,
-												strlen(withoutescape));
-		if (f->seclabels[i].label == NULL)
-		{
-			logError("escaping label failed: %s", PQerrorMessage(c));
-			PQclear(res);
-			PQfinish(c);
-			/* XXX leak another connection? */
-			exit(EXIT_FAILURE);
-		}
+		logWarning("ignoring security labels because server does not support it");
+		return;
 	}
 
-	PQclear(res);
-}
-
-void
-freeFunctions(PQLFunction *f, int n)
-{
-	if (n > 0)
+	for (i = 0; i < n; i++)
 	{
-		int	i;
+		f[i].nseclabels = getObjectSecurityLabels(c, PGQ_CLASS_PROC,
+							  f[i].obj.oid, 0, &f[i].seclabels);
 
-		for (i = 0; i < n; i++)
-		{
-			int	j;
-
-			free(f[i].obj.schemaname);
-			free(f[i].obj.objectname);
-			free(f[i].arguments);
-			free(f[i].iarguments);
-			free(f[i].body);
-			free(f[i].returntype);
-			free(f[i].language);
-			free(f[i].cost);
-			free(f[i].rows);
-			if (f[i].configparams)
-				free(f[i].configparams);
-			if (f[i].comment)
-				PQfreemem(f[i].comment);
-			free(f[i].owner);
-			if (f[i].acl)
-				free(f[i].acl);
-
-			/* security labels */
-			for (j = 0; j < f[i].nseclabels; j++)
-			{
-				free(f[i].seclabels[j].provider);
-				PQfreemem(f[i].seclabels[j].label);
-			}
-
-			if (f[i].seclabels)
-				free(f[i].seclabels);
-		}
-
-		free(f);
+		if (t == 'f')
+			logDebug("number of security labels in function \"%s\".\"%s\"(%s): %d",
+					 f[i].obj.schemaname, f[i].obj.objectname, f[i].arguments,
+					 f[i].nseclabels);
+		else
+			logDebug("number of security labels in procedure \"%s\".\"%s\"(%s): %d",
+					 f[i].obj.schemaname, f[i].obj.objectname, f[i].arguments,
+					 f[i].nseclabels);
 	}
 }
 
 void
 dumpDropProcFunction(FILE *output, PQLFunction *f, char t)
 {
-	char	*schema = formatObjectIdentifier(f->obj.schemaname);
-	char	*funcname = formatObjectIdentifier(f->obj.objectname);
+	char	*schema = quotedName(f->obj.schemaname);
+	char	*funcname = quotedName(f->obj.objectname);
 	char	*kind;
 
 	if (t == 'f')
@@ -320,15 +227,13 @@ dumpDropProcFunction(FILE *output, PQLFunction *f, char t)
 			f->iarguments);
 
 	free(kind);
-	free(schema);
-	free(funcname);
 }
 
 void
 dumpCreateProcFunction(FILE *output, PQLFunction *f, bool orreplace, char t)
 {
-	char	*schema = formatObjectIdentifier(f->obj.schemaname);
-	char	*funcname = formatObjectIdentifier(f->obj.objectname);
+	char	*schema = quotedName(f->obj.schemaname);
+	char	*funcname = quotedName(f->obj.objectname);
 	char	*kind;
 
 	if (t == 'f')
@@ -403,29 +308,27 @@ dumpCreateProcFunction(FILE *output, PQLFunction *f, bool orreplace, char t)
 
 	if (f->configparams != NULL)
 	{
-		stringList		*sl;
-		stringListCell	*cell;
+		PQLOptionSet	*sl;
+		int				k;
 
-		sl = buildStringList(f->configparams);
-		for (cell = sl->head; cell; cell = cell->next)
+		sl = buildOptionSet(f->configparams);
+		for (k = 0; k < sl->nitems; k++)
 		{
-			char	*str;
+			PQLOption	*opt = &sl->items[k];
 
-			str = strchr(cell->value, '=');
-			if (str == NULL)
+			if (opt->value == NULL)
 				continue;
-			*str++ = '\0';
 
-			fprintf(output, " SET %s TO ", cell->value);
+			fprintf(output, " SET %s TO ", opt->key);
 
-			if (strcasecmp(cell->value, "DateStyle") == 0 ||
-					strcasecmp(cell->value, "search_path") == 0)
-				fprintf(output, "%s", str);
+			if (strcasecmp(opt->key, "DateStyle") == 0 ||
+					strcasecmp(opt->key, "search_path") == 0)
+				fprintf(output, "%s", opt->value);
 			else
-				fprintf(output, "'%s'", str);
+				fprintf(output, "'%s'", opt->value);
 		}
 
-		freeStringList(sl);
+		freeOptionSet(sl);
 	}
 
 	fprintf(output, "\nAS $$%s$$;", f->body);
@@ -434,12 +337,13 @@ dumpCreateProcFunction(FILE *output, PQLFunction *f, bool orreplace, char t)
 	if (options.comment && f->comment != NULL)
 	{
 		fprintf(output, "\n\n");
-		fprintf(output, "COMMENT ON %s %s.%s(%s) IS %s;",
+		fprintf(output, "COMMENT ON %s %s.%s(%s) IS ",
 				kind,
 				schema,
 				funcname,
-				f->iarguments,
-				f->comment);
+				f->iarguments);
+		printComment(output, f->comment);
+		fprintf(output, ";");
 	}
 
 	/* security labels */
@@ -463,7 +367,7 @@ dumpCreateProcFunction(FILE *output, PQLFunction *f, bool orreplace, char t)
 	/* owner */
 	if (options.owner)
 	{
-		char	*owner = formatObjectIdentifier(f->owner);
+		char	*owner = quotedName(f->owner);
 
 		fprintf(output, "\n\n");
 		fprintf(output, "ALTER %s %s.%s(%s) OWNER TO %s;",
@@ -472,8 +376,6 @@ dumpCreateProcFunction(FILE *output, PQLFunction *f, bool orreplace, char t)
 				funcname,
 				f->iarguments,
 				owner);
-
-		free(owner);
 	}
 
 	/* privileges */
@@ -489,17 +391,15 @@ dumpCreateProcFunction(FILE *output, PQLFunction *f, bool orreplace, char t)
 	}
 
 	free(kind);
-	free(schema);
-	free(funcname);
 }
 
 void
 dumpAlterProcFunction(FILE *output, PQLFunction *a, PQLFunction *b, char t)
 {
-	char	*schema1 = formatObjectIdentifier(a->obj.schemaname);
-	char	*funcname1 = formatObjectIdentifier(a->obj.objectname);
-	char	*schema2 = formatObjectIdentifier(b->obj.schemaname);
-	char	*funcname2 = formatObjectIdentifier(b->obj.objectname);
+	char	*schema1 = quotedName(a->obj.schemaname);
+	char	*funcname1 = quotedName(a->obj.objectname);
+	char	*schema2 = quotedName(b->obj.schemaname);
+	char	*funcname2 = quotedName(b->obj.objectname);
 	char	*kind;
 
 	bool	printalter = true;
@@ -648,7 +548,7 @@ dumpAlterProcFunction(FILE *output, PQLFunction *a, PQLFunction *b, char t)
 	}
 	else if (a->configparams == NULL && b->configparams != NULL)
 	{
-		stringList	*sl;
+		PQLOptionSet	*sl;
 
 		if (printalter)
 		{
@@ -658,36 +558,34 @@ dumpAlterProcFunction(FILE *output, PQLFunction *a, PQLFunction *b, char t)
 		}
 		printalter = false;
 
-		sl = buildStringList(b->configparams);
+		sl = buildOptionSet(b->configparams);
 		if (sl)
 		{
-			stringListCell	*cell;
+			int				k;
 
-			for (cell = sl->head; cell; cell = cell->next)
+			for (k = 0; k < sl->nitems; k++)
 			{
-				char	*str;
+				PQLOption	*opt = &sl->items[k];
 
-				str = strchr(cell->value, '=');
-				if (str == NULL)
+				if (opt->value == NULL)
 					continue;
-				*str++ = '\0';
 
-				fprintf(output, " SET %s TO ", cell->value);
+				fprintf(output, " SET %s TO ", opt->key);
 
-				if (strcasecmp(cell->value, "DateStyle") == 0 ||
-						strcasecmp(cell->value, "search_path") == 0)
-					fprintf(output, "%s", str);
+				if (strcasecmp(opt->key, "DateStyle") == 0 ||
+						strcasecmp(opt->key, "search_path") == 0)
+					fprintf(output, "%s", opt->value);
 				else
-					fprintf(output, "'%s'", str);
+					fprintf(output, "'%s'", opt->value);
 			}
 
-			freeStringList(sl);
+			freeOptionSet(sl);
 		}
 	}
 	else if (a->configparams != NULL && b->configparams != NULL &&
 			 strcmp(a->configparams, b->configparams) != 0)
 	{
-		stringList	*rlist, *ilist, *slist;
+		PQLOptionSet	*rlist, *ilist, *slist;
 
 		if (printalter)
 		{
@@ -704,12 +602,12 @@ dumpAlterProcFunction(FILE *output, PQLFunction *a, PQLFunction *b, char t)
 									false, true);
 		if (rlist)
 		{
-			stringListCell	*cell;
+			int				k;
 
-			for (cell = rlist->head; cell; cell = cell->next)
-				fprintf(output, " RESET %s", cell->value);
+			for (k = 0; k < rlist->nitems; k++)
+				fprintf(output, " RESET %s", rlist->items[k].key);
 
-			freeStringList(rlist);
+			freeOptionSet(rlist);
 		}
 
 		/*
@@ -720,27 +618,25 @@ dumpAlterProcFunction(FILE *output, PQLFunction *a, PQLFunction *b, char t)
 									true, true);
 		if (ilist)
 		{
-			stringListCell	*cell;
+			int				k;
 
-			for (cell = ilist->head; cell; cell = cell->next)
+			for (k = 0; k < ilist->nitems; k++)
 			{
-				char	*str;
+				PQLOption	*opt = &ilist->items[k];
 
-				str = strchr(cell->value, '=');
-				if (str == NULL)
+				if (opt->value == NULL)
 					continue;
-				*str++ = '\0';
 
-				fprintf(output, " SET %s TO ", cell->value);
+				fprintf(output, " SET %s TO ", opt->key);
 
-				if (strcasecmp(cell->value, "DateStyle") == 0 ||
-						strcasecmp(cell->value, "search_path") == 0)
-					fprintf(output, "%s", str);
+				if (strcasecmp(opt->key, "DateStyle") == 0 ||
+						strcasecmp(opt->key, "search_path") == 0)
+					fprintf(output, "%s", opt->value);
 				else
-					fprintf(output, "'%s'", str);
+					fprintf(output, "'%s'", opt->value);
 			}
 
-			freeStringList(ilist);
+			freeOptionSet(ilist);
 		}
 
 		/*
@@ -750,27 +646,25 @@ dumpAlterProcFunction(FILE *output, PQLFunction *a, PQLFunction *b, char t)
 									true, true);
 		if (slist)
 		{
-			stringListCell	*cell;
+			int				k;
 
-			for (cell = slist->head; cell; cell = cell->next)
+			for (k = 0; k < slist->nitems; k++)
 			{
-				char	*str;
+				PQLOption	*opt = &slist->items[k];
 
-				str = strchr(cell->value, '=');
-				if (str == NULL)
+				if (opt->value == NULL)
 					continue;
-				*str++ = '\0';
 
-				fprintf(output, " SET %s TO ", cell->value);
+				fprintf(output, " SET %s TO ", opt->key);
 
-				if (strcasecmp(cell->value, "DateStyle") == 0 ||
-						strcasecmp(cell->value, "search_path") == 0)
-					fprintf(output, "%s", str);
+				if (strcasecmp(opt->key, "DateStyle") == 0 ||
+						strcasecmp(opt->key, "search_path") == 0)
+					fprintf(output, "%s", opt->value);
 				else
-					fprintf(output, "'%s'", str);
+					fprintf(output, "'%s'", opt->value);
 			}
 
-			freeStringList(slist);
+			freeOptionSet(slist);
 		}
 	}
 
@@ -793,8 +687,10 @@ dumpAlterProcFunction(FILE *output, PQLFunction *a, PQLFunction *b, char t)
 				 strcmp(a->comment, b->comment) != 0))
 		{
 			fprintf(output, "\n\n");
-			fprintf(output, "COMMENT ON %s %s.%s(%s) IS %s;",
-					kind, schema2, funcname2, b->iarguments, b->comment);
+			fprintf(output, "COMMENT ON %s %s.%s(%s) IS ",
+					kind, schema2, funcname2, b->iarguments);
+			printComment(output, b->comment);
+			fprintf(output, ";");
 		}
 		else if (a->comment != NULL && b->comment == NULL)
 		{
@@ -891,13 +787,11 @@ dumpAlterProcFunction(FILE *output, PQLFunction *a, PQLFunction *b, char t)
 	{
 		if (strcmp(a->owner, b->owner) != 0)
 		{
-			char	*owner = formatObjectIdentifier(b->owner);
+			char	*owner = quotedName(b->owner);
 
 			fprintf(output, "\n\n");
 			fprintf(output, "ALTER %s %s.%s(%s) OWNER TO %s;",
 					kind, schema2, funcname2, b->iarguments, owner);
-
-			free(owner);
 		}
 	}
 
@@ -916,10 +810,6 @@ dumpAlterProcFunction(FILE *output, PQLFunction *a, PQLFunction *b, char t)
 	}
 
 	free(kind);
-	free(schema1);
-	free(funcname1);
-	free(schema2);
-	free(funcname2);
 }
 
 PQLFunction *
@@ -935,15 +825,15 @@ getProcedures(PGconn *c, int *n)
 }
 
 void
-getFunctionSecurityLabels(PGconn *c, PQLFunction *f)
+getFunctionSecurityLabels(PGconn *c, PQLFunction *f, int n)
 {
-	getProcFunctionSecurityLabels(c, f, 'f');
+	getProcFunctionSecurityLabels(c, f, n, 'f');
 }
 
 void
-getProcedureSecurityLabels(PGconn *c, PQLFunction *f)
+getProcedureSecurityLabels(PGconn *c, PQLFunction *f, int n)
 {
-	getProcFunctionSecurityLabels(c, f, 'p');
+	getProcFunctionSecurityLabels(c, f, n, 'p');
 }
 
 void
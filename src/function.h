@@ -9,8 +9,10 @@
 #ifndef FUNCTION_H
 #define FUNCTION_H
 
+#include "comment.h"
 #include "common.h"
 #include "privileges.h"
+#include "seclabel.h"
 
 typedef struct PQLFunction
 {
@@ -43,9 +45,9 @@ PQLFunction *getFunctions(PGconn *c, int *n);
 PQLFunction *getProcedures(PGconn *c, int *n);
 PQLFunction *getProcFunctions(PGconn *c, int *n, char t);
 int compareFunctions(PQLFunction *a, PQLFunction *b);
-void getFunctionSecurityLabels(PGconn *c, PQLFunction *f);
-void getProcedureSecurityLabels(PGconn *c, PQLFunction *f);
-void getProcFunctionSecurityLabels(PGconn *c, PQLFunction *f, char t);
+void getFunctionSecurityLabels(PGconn *c, PQLFunction *f, int n);
+void getProcedureSecurityLabels(PGconn *c, PQLFunction *f, int n);
+void getProcFunctionSecurityLabels(PGconn *c, PQLFunction *f, int n, char t);
 
 void dumpDropFunction(FILE *output, PQLFunction *f);
 void dumpCreateFunction(FILE *output, PQLFunction *f, bool orreplace);
@@ -61,6 +63,5 @@ void dumpCreateProcFunction(FILE *output, PQLFunction *f, bool orreplace,
 void dumpAlterProcFunction(FILE *output, PQLFunction *a, PQLFunction *b,
 						   char t);
 
-void freeFunctions(PQLFunction *f, int n);
 
 #endif	/* FUNCTION_H */
@@ -0,0 +1,276 @@
+/*----------------------------------------------------------------------
+ *
+ * pgquarrel -- comparing database schemas
+ *
+ * genkwtable.c
+ *     Generate the keyword and character class tables used to quote
+ *     identifiers (see ident.c)
+ *
+ * Keywords come from the PostgreSQL version that pgquarrel is compiled with.
+ * They are stored in a perfect hash table: keywords are distributed into
+ * buckets and, for each bucket, a seed (displacement) is searched such that
+ * kwHash maps every keyword of the bucket to a free slot. Hence, a lookup is
+ * two hashes and one string comparison.
+ *
+ * Usage: genkwtable OUTPUT
+ *
+ * Copyright (c) 2015-2020, Euler Taveira
+ *
+ * ---------------------------------------------------------------------
+ */
+#include "postgres_fe.h"
+
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#if PG_VERSION_NUM >= 90600
+#include "common/keywords.h"
+#else
+#include "parser/keywords.h"
+#endif
+
+#include "kwhash.h"
+
+typedef struct Keyword
+{
+	const char	*name;
+	int			category;
+} Keyword;
+
+/* barelabel (14 or later) is ignored */
+#define	PG_KEYWORD(kwname, value, category, ...) {kwname, category},
+
+static const Keyword keywords[] =
+{
+#include "parser/kwlist.h"
+};
+
+#define	NUM_KEYWORDS	((int) lengthof(keywords))
+
+/* give up a table size after so many displacements */
+#define	MAX_DISPLACEMENT	65535
+
+static int	nbuckets;
+static int	nslots;
+static int	*bucketof;		/* bucket of each keyword */
+static int	*bucketsize;
+static int	*displacement;	/* per bucket */
+static int	*slots;			/* keyword of each slot or -1 */
+
+static int
+compareBucketSize(const void *a, const void *b)
+{
+	int		x = *(const int *) a;
+	int		y = *(const int *) b;
+
+	if (bucketsize[x] != bucketsize[y])
+		return bucketsize[y] - bucketsize[x];
+
+	return x - y;
+}
+
+/*
+ * Try to place every keyword of bucket 'b' using displacement 'd'.
+ */
+static bool
+placeBucket(int b, int d)
+{
+	int		placed[NUM_KEYWORDS];
+	int		nplaced = 0;
+	int		i, j;
+
+	for (i = 0; i < NUM_KEYWORDS; i++)
+	{
+		int		s;
+
+		if (bucketof[i] != b)
+			continue;
+
+		s = kwHash(keywords[i].name, strlen(keywords[i].name), d) & (nslots - 1);
+		for (j = 0; j < nplaced; j++)
+			if (placed[j] == s)
+				break;
+		if (slots[s] >= 0 || j < nplaced)
+		{
+			/* undo */
+			for (j = 0; j < nplaced; j++)
+				slots[placed[j]] = -1;
+			return false;
+		}
+
+		slots[s] = i;
+		placed[nplaced++] = s;
+	}
+
+	return true;
+}
+
+static bool
+buildTable(void)
+{
+	int		*order;
+	int		i;
+
+	bucketof = (int *) malloc(NUM_KEYWORDS * sizeof(int));
+	bucketsize = (int *) calloc(nbuckets, sizeof(int));
+	displacement = (int *) calloc(nbuckets, sizeof(int));
+	slots = (int *) malloc(nslots * sizeof(int));
+	order = (int *) malloc(nbuckets * sizeof(int));
+	if (bucketof == NULL || bucketsize == NULL || displacement == NULL ||
+			slots == NULL || order == NULL)
+	{
+		fprintf(stderr, "genkwtable: out of memory\n");
+		exit(EXIT_FAILURE);
+	}
+
+	for (i = 0; i < nslots; i++)
+		slots[i] = -1;
+
+	for (i = 0; i < NUM_KEYWORDS; i++)
+	{
+		bucketof[i] = kwHash(keywords[i].name, strlen(keywords[i].name),
+							 0) & (nbuckets - 1);
+		bucketsize[bucketof[i]]++;
+	}
+
+	/* largest buckets first while most slots are free */
+	for (i = 0; i < nbuckets; i++)
+		order[i] = i;
+	qsort(order, nbuckets, sizeof(int), compareBucketSize);
+
+	for (i = 0; i < nbuckets && bucketsize[order[i]] > 0; i++)
+	{
+		int		d;
+
+		for (d = 1; d <= MAX_DISPLACEMENT; d++)
+		{
+			if (placeBucket(order[i], d))
+				break;
+		}
+		if (d > MAX_DISPLACEMENT)
+		{
+			free(bucketof);
+			free(bucketsize);
+			free(displacement);
+			free(slots);
+			free(order);
+			return false;
+		}
+		displacement[order[i]] = d;
+	}
+
+	free(order);
+
+	return true;
+}
+
+static void
+writeTable(FILE *fp)
+{
+	int		maxlen = 0;
+	int		i;
+
+	for (i = 0; i < NUM_KEYWORDS; i++)
+	{
+		if ((int) strlen(keywords[i].name) > maxlen)
+			maxlen = strlen(keywords[i].name);
+	}
+
+	fprintf(fp, "/* generated by genkwtable from parser/kwlist.h; do not edit */\n");
+	fprintf(fp, "#ifndef KWTABLE_H\n#define KWTABLE_H\n\n");
+	fprintf(fp, "#define\tPGQ_NUM_KEYWORDS\t\t%d\n", NUM_KEYWORDS);
+	fprintf(fp, "#define\tPGQ_KEYWORD_MAX_LEN\t\t%d\n", maxlen);
+	fprintf(fp, "#define\tPGQ_KEYWORD_BUCKETS\t\t%d\n", nbuckets);
+	fprintf(fp, "#define\tPGQ_KEYWORD_SLOTS\t\t%d\n\n", nslots);
+
+	/* kwlist.h is in ASCII order */
+	fprintf(fp, "static const char *const PQLKeywordNames[PGQ_NUM_KEYWORDS] =\n{\n");
+	for (i = 0; i < NUM_KEYWORDS; i++)
+		fprintf(fp, "\t\"%s\",\n", keywords[i].name);
+	fprintf(fp, "};\n\n");
+
+	/* only unreserved keywords can be used as identifiers without quotes */
+	fprintf(fp, "static const bool PQLKeywordNeedsQuotes[PGQ_NUM_KEYWORDS] =\n{\n");
+	for (i = 0; i < NUM_KEYWORDS; i++)
+		fprintf(fp, "\t%s,\n", keywords[i].category != UNRESERVED_KEYWORD ?
+				"true" : "false");
+	fprintf(fp, "};\n\n");
+
+	fprintf(fp, "static const uint16 PQLKeywordDisplacements[PGQ_KEYWORD_BUCKETS] =\n{\n");
+	for (i = 0; i < nbuckets; i++)
+		fprintf(fp, "%s%d,%s", (i % 12 == 0) ? "\t" : " ", displacement[i],
+				(i % 12 == 11 || i == nbuckets - 1) ? "\n" : "");
+	fprintf(fp, "};\n\n");
+
+	fprintf(fp, "static const int16 PQLKeywordSlots[PGQ_KEYWORD_SLOTS] =\n{\n");
+	for (i = 0; i < nslots; i++)
+		fprintf(fp, "%s%d,%s", (i % 12 == 0) ? "\t" : " ", slots[i],
+				(i % 12 == 11 || i == nslots - 1) ? "\n" : "");
+	fprintf(fp, "};\n\n");
+
+	fprintf(fp, "static const uint8 PQLIdentCharClass[256] =\n{\n");
+	for (i = 0; i < 256; i++)
+	{
+		int		c = 0;
+
+		if ((i >= 'a' && i <= 'z') || i == '_')
+			c = PGQ_IDENT_FIRST | PGQ_IDENT_REST;
+		else if (i >= '0' && i <= '9')
+			c = PGQ_IDENT_REST;
+
+		fprintf(fp, "%s%d,%s", (i % 16 == 0) ? "\t" : " ", c,
+				(i % 16 == 15) ? "\n" : "");
+	}
+	fprintf(fp, "};\n\n");
+
+	fprintf(fp, "#endif\t/* KWTABLE_H */\n");
+}
+
+int
+main(int argc, char *argv[])
+{
+	FILE	*fp;
+
+	if (argc != 2)
+	{
+		fprintf(stderr, "usage: genkwtable OUTPUT\n");
+		exit(EXIT_FAILURE);
+	}
+
+	/* about 4 keywords per bucket and a load factor of at most 0.5 */
+	for (nbuckets = 1; nbuckets * 4 < NUM_KEYWORDS; nbuckets *= 2)
+		;
+	for (nslots = 1; nslots < 2 * NUM_KEYWORDS; nslots *= 2)
+		;
+
+	while (!buildTable())
+	{
+		if (nslots >= 65536)
+		{
+			fprintf(stderr, "genkwtable: could not build keyword table\n");
+			exit(EXIT_FAILURE);
+		}
+		nslots *= 2;
+	}
+
+	fp = fopen(argv[1], "w");
+	if (fp == NULL)
+	{
+		fprintf(stderr, "genkwtable: could not open \"%s\": %s\n", argv[1],
+				strerror(errno));
+		exit(EXIT_FAILURE);
+	}
+
+	writeTable(fp);
+
+	if (fclose(fp) != 0)
+	{
+		fprintf(stderr, "genkwtable: could not close \"%s\": %s\n", argv[1],
+				strerror(errno));
+		exit(EXIT_FAILURE);
+	}
+
+	return 0;
+}
@@ -0,0 +1,82 @@
+/*----------------------------------------------------------------------
+ *
+ * pgquarrel -- comparing database schemas
+ *
+ * ident.c
+ *     Decide whether an identifier needs quotes
+ *
+ * The keyword table and the character classes are generated by genkwtable
+ * from the PostgreSQL version that pgquarrel is compiled with.
+ *
+ * Copyright (c) 2015-2020, Euler Taveira
+ *
+ * ---------------------------------------------------------------------
+ */
+#include "ident.h"
+#include "kwhash.h"
+#include "kwtable.h"
+
+/*
+ * Return true if identifier 's' needs quotes. For quoting, consider the SQL
+ * rules and also the list of PostgreSQL keywords. The identifier is classified
+ * in a single pass: each character only updates the class and the number of
+ * double quotes. If 'len' is not NULL, it receives the length of the output
+ * (without the trailing zero byte) of formatObjectIdentifier.
+ */
+bool
+identifierNeedsQuotes(const char *s, size_t *len)
+{
+	const unsigned char	*p = (const unsigned char *) s;
+	unsigned int		plain;
+	size_t				n;
+	size_t				nquotes = 0;
+	bool				quote;
+
+	/* different rule for first character */
+	plain = PQLIdentCharClass[p[0]] & PGQ_IDENT_FIRST;
+	for (n = 0; p[n] != '\0'; n++)
+	{
+		plain &= PQLIdentCharClass[p[n]] >> 1;
+		nquotes += (p[n] == '"');
+	}
+
+	quote = !plain;
+	if (plain && n <= PGQ_KEYWORD_MAX_LEN)
+	{
+		uint32	b = kwHash(s, n, 0) & (PGQ_KEYWORD_BUCKETS - 1);
+		int		k;
+
+		k = PQLKeywordSlots[kwHash(s, n, PQLKeywordDisplacements[b]) &
+											  (PGQ_KEYWORD_SLOTS - 1)];
+		if (k >= 0 && PQLKeywordNeedsQuotes[k] &&
+				strcmp(PQLKeywordNames[k], s) == 0)
+			quote = true;
+	}
+
+	if (len)
+		*len = quote ? n + nquotes + 2 : n;
+
+	return quote;
+}
+
+/*
+ * Write the quoted form of 's' into 'ret'. It must have room for the length
+ * returned by identifierNeedsQuotes plus the trailing zero byte.
+ */
+void
+quoteIdentifier(const char *s, char *ret)
+{
+	const char	*p;
+	int			i = 0;
+
+	ret[i++] = '\"';
+	for (p = s; *p; p++)
+	{
+		/* per SQL99, if quote is found, add another quote */
+		if (*p == '\"')
+			ret[i++] = '\"';
+		ret[i++] = *p;
+	}
+	ret[i++] = '\"';
+	ret[i] = '\0';
+}
@@ -0,0 +1,17 @@
+/*----------------------------------------------------------------------
+ *
+ * pgquarrel -- comparing database schemas
+ *
+ * Copyright (c) 2015-2020, Euler Taveira
+ *
+ * ---------------------------------------------------------------------
+ */
+#ifndef IDENT_H
+#define IDENT_H
+
+#include "common.h"
+
+bool identifierNeedsQuotes(const char *s, size_t *len);
+void quoteIdentifier(const char *s, char *ret);
+
+#endif	/* IDENT_H */
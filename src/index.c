@@ -33,11 +33,11 @@ getIndexes(PGconn *c, int *n)
 	PGresult	*res;
 	int			k;
 
-	logNoise("index: server version: %d", PQserverVersion(c));
+	logNoise("index: server version: %d", getServerVersion(c));
 
-	query = psprintf("SELECT c.oid, n.nspname, c.relname, t.spcname AS tablespacename, pg_get_indexdef(c.oid) AS indexdef, array_to_string(c.reloptions, ', ') AS reloptions, obj_description(c.oid, 'pg_class') AS description FROM pg_class c INNER JOIN pg_namespace n ON (c.relnamespace = n.oid) INNER JOIN pg_index i ON (i.indexrelid = c.oid) LEFT JOIN pg_tablespace t ON (c.reltablespace = t.oid) WHERE relkind = 'i' AND nspname !~ '^pg_' AND nspname <> 'information_schema' %s%s AND NOT indisprimary ORDER BY nspname, relname", include_schema_str, exclude_schema_str);
+	query = psprintf("SELECT c.oid, n.nspname, c.relname, t.spcname AS tablespacename, pg_get_indexdef(c.oid) AS indexdef, array_to_string(c.reloptions, ', ') AS reloptions FROM pg_class c INNER JOIN pg_namespace n ON (c.relnamespace = n.oid) INNER JOIN pg_index i ON (i.indexrelid = c.oid) LEFT JOIN pg_tablespace t ON (c.reltablespace = t.oid) WHERE relkind = 'i' AND nspname !~ '^pg_' AND nspname <> 'information_schema' %s%s AND NOT indisprimary ORDER BY nspname, relname", include_schema_str, exclude_schema_str);
 
-	res = PQexec(c, query);
+	res = execQuery(c, query);
 
 	pfree(query);
 
@@ -52,7 +52,7 @@ getIndexes(PGconn *c, int *n)
 
 	*n = PQntuples(res);
 	if (*n > 0)
-		i = (PQLIndex *) malloc(*n * sizeof(PQLIndex));
+		i = (PQLIndex *) arenaAlloc(*n * sizeof(PQLIndex));
 	else
 		i = NULL;
 
@@ -60,36 +60,20 @@ getIndexes(PGconn *c, int *n)
 
 	for (k = 0; k < *n; k++)
 	{
-		char	*withoutescape;
-
 		i[k].obj.oid = strtoul(PQgetvalue(res, k, PQfnumber(res, "oid")), NULL, 10);
-		i[k].obj.schemaname = strdup(PQgetvalue(res, k, PQfnumber(res, "nspname")));
-		i[k].obj.objectname = strdup(PQgetvalue(res, k, PQfnumber(res, "relname")));
+		i[k].obj.schemaname = internName(PQgetvalue(res, k, PQfnumber(res, "nspname")));
+		i[k].obj.objectname = internName(PQgetvalue(res, k, PQfnumber(res, "relname")));
 		if (PQgetisnull(res, k, PQfnumber(res, "tablespacename")))
 			i[k].tbspcname = NULL;
 		else
-			i[k].tbspcname = strdup(PQgetvalue(res, k, PQfnumber(res, "tablespacename")));
+			i[k].tbspcname = arenaStrdup(PQgetvalue(res, k, PQfnumber(res, "tablespacename")));
 		/* FIXME don't load it only iff index will be DROPped */
-		i[k].indexdef = strdup(PQgetvalue(res, k, PQfnumber(res, "indexdef")));
+		i[k].indexdef = arenaStrdup(PQgetvalue(res, k, PQfnumber(res, "indexdef")));
 		if (PQgetisnull(res, k, PQfnumber(res, "reloptions")))
 			i[k].reloptions = NULL;
 		else
-			i[k].reloptions = strdup(PQgetvalue(res, k, PQfnumber(res, "reloptions")));
-		if (PQgetisnull(res, k, PQfnumber(res, "description")))
-			i[k].comment = NULL;
-		else
-		{
-			withoutescape = PQgetvalue(res, k, PQfnumber(res, "description"));
-			i[k].comment = PQescapeLiteral(c, withoutescape, strlen(withoutescape));
-			if (i[k].comment == NULL)
-			{
-				logError("escaping comment failed: %s", PQerrorMessage(c));
-				PQclear(res);
-				PQfinish(c);
-				/* XXX leak another connection? */
-				exit(EXIT_FAILURE);
-			}
-		}
+			i[k].reloptions = arenaStrdup(PQgetvalue(res, k, PQfnumber(res, "reloptions")));
+		i[k].comment = getComment(PGQ_CLASS_CLASS, i[k].obj.oid, 0);
 
 		logDebug("index \"%s\".\"%s\"", i[k].obj.schemaname, i[k].obj.objectname);
 	}
@@ -99,71 +83,57 @@ getIndexes(PGconn *c, int *n)
 	return i;
 }
 
-void
-freeIndexes(PQLIndex *i, int n)
-{
-	if (n > 0)
-	{
-		int	j;
-
-		for (j = 0; j < n; j++)
-		{
-			free(i[j].obj.schemaname);
-			free(i[j].obj.objectname);
-			if (i[j].tbspcname)
-				free(i[j].tbspcname);
-			free(i[j].indexdef);
-			if (i[j].reloptions)
-				free(i[j].reloptions);
-			if (i[j].comment)
-				PQfreemem(i[j].comment);
-		}
-
-		free(i);
-	}
-}
-
 void
 dumpDropIndex(FILE *output, PQLIndex *i)
 {
-	char	*schema = formatObjectIdentifier(i->obj.schemaname);
-	char	*idxname = formatObjectIdentifier(i->obj.objectname);
+	char	*schema = quotedName(i->obj.schemaname);
+	char	*idxname = quotedName(i->obj.objectname);
 
 	fprintf(output, "\n\n");
-	fprintf(output, "DROP INDEX %s.%s;", schema, idxname);
-
-	free(schema);
-	free(idxname);
+	fprintf(output, "DROP INDEX %s%s.%s;", (options.online) ? "CONCURRENTLY " : "",
+			schema, idxname);
 }
 
 void
 dumpCreateIndex(FILE *output, PQLIndex *i)
 {
-	char	*schema = formatObjectIdentifier(i->obj.schemaname);
-	char	*idxname = formatObjectIdentifier(i->obj.objectname);
+	char	*schema = quotedName(i->obj.schemaname);
+	char	*idxname = quotedName(i->obj.objectname);
 
 	fprintf(output, "\n\n");
-	fprintf(output, "%s;", i->indexdef);
+
+	/*
+	 * online: build the index without blocking writes. indexdef starts with
+	 * CREATE [UNIQUE] INDEX.
+	 */
+	if (options.online && strstr(i->indexdef, " INDEX ") != NULL)
+	{
+		char	*p = strstr(i->indexdef, " INDEX ") + strlen(" INDEX ");
+
+		fprintf(output, "%.*sCONCURRENTLY %s;", (int) (p - i->indexdef),
+				i->indexdef, p);
+	}
+	else
+		fprintf(output, "%s;", i->indexdef);
 
 	/* comment */
 	if (options.comment && i->comment != NULL)
 	{
 		fprintf(output, "\n\n");
-		fprintf(output, "COMMENT ON INDEX %s.%s IS %s;",
-				schema, idxname, i->comment);
+		fprintf(output, "COMMENT ON INDEX %s.%s IS ",
+				schema, idxname);
+		printComment(output, i->comment);
+		fprintf(output, ";");
 	}
-
-	free(schema);
-	free(idxname);
 }
 
 void
 dumpAlterIndex(FILE *output, PQLIndex *a, PQLIndex *b)
 {
-	char	*schema1 = formatObjectIdentifier(a->obj.schemaname);
-	char	*idxname1 = formatObjectIdentifier(a->obj.objectname);
-	char	*schema2 = formatObjectIdentifier(b->obj.schemaname);
-	char	*idxname2 = formatObjectIdentifier(b->obj.objectname);
+	char	*schema1 = quotedName(a->obj.schemaname);
+	char	*idxname1 = quotedName(a->obj.objectname);
+	char	*schema2 = quotedName(b->obj.schemaname);
+	char	*idxname2 = quotedName(b->obj.objectname);
 
 	if (compareRelations(&a->obj, &b->obj) != 0)
 	{
@@ -202,7 +172,7 @@ dumpAlterIndex(FILE *output, PQLIndex *a, PQLIndex *b)
 	}
 	else if (a->reloptions != NULL && b->reloptions == NULL)
 	{
-		stringList	*rlist;
+		PQLOptionSet	*rlist;
 
 		/* reset all options */
 		rlist = setOperationOptions(a->reloptions, b->reloptions, PGQ_SETDIFFERENCE,
@@ -217,13 +187,13 @@ dumpAlterIndex(FILE *output, PQLIndex *a, PQLIndex *b)
 					schema2, idxname2, resetlist);
 
 			free(resetlist);
-			freeStringList(rlist);
+			freeOptionSet(rlist);
 		}
 	}
 	else if (a->reloptions != NULL && b->reloptions != NULL &&
 			 strcmp(a->reloptions, b->reloptions) != 0)
 	{
-		stringList	*rlist, *ilist, *slist;
+		PQLOptionSet	*rlist, *ilist, *slist;
 
 		/* reset options that are only presented in the first set */
 		rlist = setOperationOptions(a->reloptions, b->reloptions, PGQ_SETDIFFERENCE,
@@ -238,7 +208,7 @@ dumpAlterIndex(FILE *output, PQLIndex *a, PQLIndex *b)
 					schema2, idxname2, resetlist);
 
 			free(resetlist);
-			freeStringList(rlist);
+			freeOptionSet(rlist);
 		}
 
 		/*
@@ -257,7 +227,7 @@ dumpAlterIndex(FILE *output, PQLIndex *a, PQLIndex *b)
 					schema2, idxname2, setlist);
 
 			free(setlist);
-			freeStringList(ilist);
+			freeOptionSet(ilist);
 		}
 
 		/*
@@ -275,7 +245,7 @@ dumpAlterIndex(FILE *output, PQLIndex *a, PQLIndex *b)
 					schema2, idxname2, setlist);
 
 			free(setlist);
-			freeStringList(slist);
+			freeOptionSet(slist);
 		}
 	}
 
@@ -287,8 +257,10 @@ dumpAlterIndex(FILE *output, PQLIndex *a, PQLIndex *b)
 				 strcmp(a->comment, b->comment) != 0))
 		{
 			fprintf(output, "\n\n");
-			fprintf(output, "COMMENT ON INDEX %s.%s IS %s;",
-					schema2, idxname2, b->comment);
+			fprintf(output, "COMMENT ON INDEX %s.%s IS ",
+					schema2, idxname2);
+			printComment(output, b->comment);
+			fprintf(output, ";");
 		}
 		else if (a->comment != NULL && b->comment == NULL)
 		{
@@ -297,9 +269,4 @@ dumpAlterIndex(FILE *output, PQLIndex *a, PQLIndex *b)
 					schema2, idxname2);
 		}
 	}
-
-	free(schema1);
-	free(idxname1);
-	free(schema2);
-	free(idxname2);
 }
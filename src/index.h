@@ -9,6 +9,7 @@
 #ifndef INDEX_H
 #define INDEX_H
 
+#include "comment.h"
 #include "common.h"
 
 typedef struct PQLIndex
@@ -29,6 +30,5 @@ void dumpDropIndex(FILE *output, PQLIndex *i);
 void dumpCreateIndex(FILE *output, PQLIndex *i);
 void dumpAlterIndex(FILE *output, PQLIndex *a, PQLIndex *b);
 
-void freeIndexes(PQLIndex *i, int n);
 
 #endif	/* INDEX_H */
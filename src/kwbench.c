@@ -0,0 +1,126 @@
+/*----------------------------------------------------------------------
+ *
+ * pgquarrel -- comparing database schemas
+ *
+ * kwbench.c
+ *     Microbenchmark of identifier quoting
+ *
+ * Compare identifierNeedsQuotes with the previous classification: check the
+ * identifier char by char and then binary search the keyword list (that is
+ * what ScanKeywordLookup does up to 11).
+ *
+ * Usage: kwbench [LOOPS]
+ *
+ * Copyright (c) 2015-2020, Euler Taveira
+ *
+ * ---------------------------------------------------------------------
+ */
+#include <time.h>
+
+#include "ident.h"
+#include "kwhash.h"
+#include "kwtable.h"
+
+/* identifiers that are not keywords */
+static const char *const names[] =
+{
+	"customer", "customer_id", "order_line_42", "_tmp", "x", "inventory",
+	"pg_stat_user_tables", "t1234567890", "Customer", "order line",
+	"a\"b", "1abc", "product_category_description_and_other_things"
+};
+
+static int
+compareKeyword(const void *a, const void *b)
+{
+	return strcmp((const char *) a, *(const char *const *) b);
+}
+
+/* previous implementation */
+static bool
+searchNeedsQuotes(const char *s)
+{
+	const char			*p;
+	const char *const	*k;
+
+	if (!((s[0] >= 'a' && s[0] <= 'z') || s[0] == '_'))
+		return true;
+
+	for (p = s; *p; p++)
+	{
+		if (!((*p >= 'a' && *p <= 'z')
+				|| (*p >= '0' && *p <= '9')
+				|| (*p == '_')))
+			return true;
+	}
+
+	k = bsearch(s, PQLKeywordNames, PGQ_NUM_KEYWORDS, sizeof(char *),
+				compareKeyword);
+
+	return (k != NULL && PQLKeywordNeedsQuotes[k - PQLKeywordNames]);
+}
+
+static double
+elapsed(clock_t start)
+{
+	return (double) (clock() - start) / CLOCKS_PER_SEC;
+}
+
+int
+main(int argc, char *argv[])
+{
+	const char	**idents;
+	int			nidents;
+	long		loops = 2000;
+	long		l;
+	int			i;
+	int			n1 = 0;
+	int			n2 = 0;
+	clock_t		start;
+	double		t1, t2;
+
+	if (argc > 1)
+		loops = atol(argv[1]);
+
+	/* all keywords plus some ordinary names */
+	nidents = PGQ_NUM_KEYWORDS + (int) lengthof(names);
+	idents = (const char **) malloc(nidents * sizeof(char *));
+	for (i = 0; i < PGQ_NUM_KEYWORDS; i++)
+		idents[i] = PQLKeywordNames[i];
+	for (i = 0; i < (int) lengthof(names); i++)
+		idents[PGQ_NUM_KEYWORDS + i] = names[i];
+
+	/* both must agree */
+	for (i = 0; i < nidents; i++)
+	{
+		if (searchNeedsQuotes(idents[i]) != identifierNeedsQuotes(idents[i], NULL))
+		{
+			fprintf(stderr, "kwbench: mismatch for \"%s\"\n", idents[i]);
+			exit(EXIT_FAILURE);
+		}
+	}
+
+	start = clock();
+	for (l = 0; l < loops; l++)
+		for (i = 0; i < nidents; i++)
+			n1 += searchNeedsQuotes(idents[i]);
+	t1 = elapsed(start);
+
+	start = clock();
+	for (l = 0; l < loops; l++)
+		for (i = 0; i < nidents; i++)
+			n2 += identifierNeedsQuotes(idents[i], NULL);
+	t2 = elapsed(start);
+
+	printf("%ld x %d identifiers (%d need quotes)\n", loops, nidents,
+		   n2 / (int) (loops > 0 ? loops : 1));
+	printf("char loop + binary search: %8.2f ns/identifier\n",
+		   t1 * 1e9 / ((double) loops * nidents));
+	printf("perfect hash + classes:    %8.2f ns/identifier\n",
+		   t2 * 1e9 / ((double) loops * nidents));
+	if (n1 != n2)
+		return EXIT_FAILURE;
+
+	free(idents);
+
+	return 0;
+}
@@ -0,0 +1,41 @@
+/*----------------------------------------------------------------------
+ *
+ * pgquarrel -- comparing database schemas
+ *
+ * Copyright (c) 2015-2020, Euler Taveira
+ *
+ * ---------------------------------------------------------------------
+ */
+#ifndef KWHASH_H
+#define KWHASH_H
+
+/* character classes of PQLIdentCharClass (see genkwtable.c) */
+#define	PGQ_IDENT_FIRST		0x01	/* a-z and _ */
+#define	PGQ_IDENT_REST		0x02	/* a-z, 0-9 and _ */
+
+/*
+ * Hash function of the keyword table. genkwtable searches seeds that map every
+ * keyword to its own slot; the same function must be used to look them up.
+ */
+static inline uint32
+kwHash(const char *s, size_t len, uint32 seed)
+{
+	uint32		h = 2166136261U ^ (seed * 0x9E3779B9U);
+	size_t		i;
+
+	/* FNV-1a */
+	for (i = 0; i < len; i++)
+	{
+		h ^= (unsigned char) s[i];
+		h *= 16777619U;
+	}
+
+	/* mix high bits into the low bits that are used as slot number */
+	h ^= h >> 16;
+	h *= 0x85EBCA6BU;
+	h ^= h >> 13;
+
+	return h;
+}
+
+#endif	/* KWHASH_H */
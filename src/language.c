@@ -30,17 +30,17 @@ getLanguages(PGconn *c, int *n)
 	PGresult	*res;
 	int			i;
 
-	logNoise("language: server version: %d", PQserverVersion(c));
+	logNoise("language: server version: %d", getServerVersion(c));
 
-	if (PQserverVersion(c) >= 90100)	/* extension support */
+	if (getServerVersion(c) >= 90100)	/* extension support */
 	{
-		res = PQexec(c,
-					 "SELECT l.oid, lanname AS languagename, lanpltrusted AS trusted, p1.oid AS calloid, p1.pronamespace::regnamespace AS callnsp, p1.proname AS callname, p2.oid AS inlineoid, p2.pronamespace::regnamespace AS inlinensp, p2.proname AS inlinename, p3.oid AS validatoroid, p3.pronamespace::regnamespace AS validatornsp, p3.proname AS validatorname, obj_description(l.oid, 'pg_language') AS description, pg_get_userbyid(lanowner) AS lanowner, lanacl FROM pg_language l LEFT JOIN pg_proc p1 ON (p1.oid = lanplcallfoid) LEFT JOIN pg_proc p2 ON (p2.oid = laninline) LEFT JOIN pg_proc p3 ON (p3.oid = lanvalidator) WHERE lanispl AND NOT EXISTS(SELECT 1 FROM pg_depend d WHERE l.oid = d.objid AND d.deptype = 'e') ORDER BY lanname");
+		res = execQuery(c,
+					 "SELECT l.oid, lanname AS languagename, lanpltrusted AS trusted, p1.oid AS calloid, p1.pronamespace::regnamespace AS callnsp, p1.proname AS callname, p2.oid AS inlineoid, p2.pronamespace::regnamespace AS inlinensp, p2.proname AS inlinename, p3.oid AS validatoroid, p3.pronamespace::regnamespace AS validatornsp, p3.proname AS validatorname, pg_get_userbyid(lanowner) AS lanowner, lanacl FROM pg_language l LEFT JOIN pg_proc p1 ON (p1.oid = lanplcallfoid) LEFT JOIN pg_proc p2 ON (p2.oid = laninline) LEFT JOIN pg_proc p3 ON (p3.oid = lanvalidator) WHERE lanispl AND NOT EXISTS(SELECT 1 FROM pg_depend d WHERE l.oid = d.objid AND d.deptype = 'e') ORDER BY lanname");
 	}
 	else
 	{
-		res = PQexec(c,
-					 "SELECT l.oid, lanname AS languagename, lanpltrusted AS trusted, p1.oid AS calloid, p1.pronamespace::regnamespace AS callnsp, p1.proname AS callfunc, p2.oid AS inlineoid, p2.pronamespace::regnamespace AS inlinensp, p2.proname AS inlinefunc, p3.oid AS validatoroid, p3.pronamespace::regnamespace AS validatornsp, p3.proname AS validatorfunc, obj_description(l.oid, 'pg_language') AS description, pg_get_userbyid(lanowner) AS lanowner, lanacl FROM pg_language l LEFT JOIN pg_proc p1 ON (p1.oid = lanplcallfoid) LEFT JOIN pg_proc p2 ON (p2.oid = laninline) LEFT JOIN pg_proc p3 ON (p3.oid = lanvalidator) WHERE lanispl ORDER BY lanname");
+		res = execQuery(c,
+					 "SELECT l.oid, lanname AS languagename, lanpltrusted AS trusted, p1.oid AS calloid, p1.pronamespace::regnamespace AS callnsp, p1.proname AS callfunc, p2.oid AS inlineoid, p2.pronamespace::regnamespace AS inlinensp, p2.proname AS inlinefunc, p3.oid AS validatoroid, p3.pronamespace::regnamespace AS validatornsp, p3.proname AS validatorfunc, pg_get_userbyid(lanowner) AS lanowner, lanacl FROM pg_language l LEFT JOIN pg_proc p1 ON (p1.oid = lanplcallfoid) LEFT JOIN pg_proc p2 ON (p2.oid = laninline) LEFT JOIN pg_proc p3 ON (p3.oid = lanvalidator) WHERE lanispl ORDER BY lanname");
 	}
 
 	if (PQresultStatus(res) != PGRES_TUPLES_OK)
@@ -54,7 +54,7 @@ getLanguages(PGconn *c, int *n)
 
 	*n = PQntuples(res);
 	if (*n > 0)
-		l = (PQLLanguage *) malloc(*n * sizeof(PQLLanguage));
+		l = (PQLLanguage *) arenaAlloc(*n * sizeof(PQLLanguage));
 	else
 		l = NULL;
 
@@ -62,10 +62,8 @@ getLanguages(PGconn *c, int *n)
 
 	for (i = 0; i < *n; i++)
 	{
-		char	*withoutescape;
-
 		l[i].oid = strtoul(PQgetvalue(res, i, PQfnumber(res, "oid")), NULL, 10);
-		l[i].languagename = strdup(PQgetvalue(res, i, PQfnumber(res, "languagename")));
+		l[i].languagename = arenaStrdup(PQgetvalue(res, i, PQfnumber(res, "languagename")));
 		l[i].trusted = (PQgetvalue(res, i, PQfnumber(res, "trusted"))[0] == 't');
 
 		if (PQgetisnull(res, i, PQfnumber(res, "callname")))
@@ -77,8 +75,8 @@ getLanguages(PGconn *c, int *n)
 		else
 		{
 			l[i].callfunc.oid = strtoul(PQgetvalue(res, i, PQfnumber(res, "calloid")), NULL, 10);
-			l[i].callfunc.schemaname = strdup(PQgetvalue(res, i, PQfnumber(res, "callnsp")));
-			l[i].callfunc.objectname = strdup(PQgetvalue(res, i, PQfnumber(res, "callname")));
+			l[i].callfunc.schemaname = internName(PQgetvalue(res, i, PQfnumber(res, "callnsp")));
+			l[i].callfunc.objectname = internName(PQgetvalue(res, i, PQfnumber(res, "callname")));
 		}
 		if (PQgetisnull(res, i, PQfnumber(res, "inlinename")))
 		{
@@ -89,8 +87,8 @@ getLanguages(PGconn *c, int *n)
 		else
 		{
 			l[i].inlinefunc.oid = strtoul(PQgetvalue(res, i, PQfnumber(res, "inlineoid")), NULL, 10);
-			l[i].inlinefunc.schemaname = strdup(PQgetvalue(res, i, PQfnumber(res, "inlinensp")));
-			l[i].inlinefunc.objectname = strdup(PQgetvalue(res, i, PQfnumber(res, "inlinename")));
+			l[i].inlinefunc.schemaname = internName(PQgetvalue(res, i, PQfnumber(res, "inlinensp")));
+			l[i].inlinefunc.objectname = internName(PQgetvalue(res, i, PQfnumber(res, "inlinename")));
 		}
 		if (PQgetisnull(res, i, PQfnumber(res, "validatorname")))
 		{
@@ -101,36 +99,22 @@ getLanguages(PGconn *c, int *n)
 		else
 		{
 			l[i].validatorfunc.oid = strtoul(PQgetvalue(res, i, PQfnumber(res, "validatoroid")), NULL, 10);
-			l[i].validatorfunc.schemaname = strdup(PQgetvalue(res, i, PQfnumber(res, "validatornsp")));
-			l[i].validatorfunc.objectname = strdup(PQgetvalue(res, i, PQfnumber(res, "validatorname")));
+			l[i].validatorfunc.schemaname = internName(PQgetvalue(res, i, PQfnumber(res, "validatornsp")));
+			l[i].validatorfunc.objectname = internName(PQgetvalue(res, i, PQfnumber(res, "validatorname")));
 		}
 
-		if (PQgetisnull(res, i, PQfnumber(res, "description")))
-			l[i].comment = NULL;
-		else
-		{
-			withoutescape = PQgetvalue(res, i, PQfnumber(res, "description"));
-			l[i].comment = PQescapeLiteral(c, withoutescape, strlen(withoutescape));
-			if (l[i].comment == NULL)
-			{
-				logError("escaping comment failed: %s", PQerrorMessage(c));
-				PQclear(res);
-				PQfinish(c);
-				/* XXX leak another connection? */
-				exit(EXIT_FAILURE);
-			}
-		}
+		l[i].comment = getComment(PGQ_CLASS_LANGUAGE, l[i].oid, 0);
 
-		l[i].owner = strdup(PQgetvalue(res, i, PQfnumber(res, "lanowner")));
+		l[i].owner = internName(PQgetvalue(res, i, PQfnumber(res, "lanowner")));
 		if (PQgetisnull(res, i, PQfnumber(res, "lanacl")))
 			l[i].acl = NULL;
 		else
-			l[i].acl = strdup(PQgetvalue(res, i, PQfnumber(res, "lanacl")));
+			l[i].acl = arenaStrdup(PQgetvalue(res, i, PQfnumber(res, "lanacl")));
 
 		/*
 		 * Security labels are not assigned here (see
 		 * getLanguageSecurityLabels), but default values are essential to
-		 * avoid having trouble in freeLanguages.
+		 * avoid having trouble in the dump routines.
 		 */
 		l[i].nseclabels = 0;
 		l[i].seclabels = NULL;
@@ -144,106 +128,26 @@ getLanguages(PGconn *c, int *n)
 }
 
 void
-getLanguageSecurityLabels(PGconn *c, PQLLanguage *l)
+getLanguageSecurityLabels(PGconn *c, PQLLanguage *l, int n)
 {
-	char		*query;
-	PGresult	*res;
 	int			i;
 
-	if (PQserverVersion(c) < 90100)
-	{
-		logWarning("ignoring security labels because server does not support it");
+	if (n == 0)
 		return;
-	}
-
-	query = psprintf("SELECT provider, label FROM pg_seclabel s INNER JOIN pg_class c ON (s.classoid = c.oid) WHERE c.relname = 'pg_language' AND s.objoid = %u ORDER BY provider", l->oid);
 
-	res = PQexec(c, query);
-
-	pfree(query);
-
-	if (PQresultStatus(res) != PGRES_TUPLES_OK)
+	if (getServerVersion(c) < 90100)
 	{
-		logError("query failed: %s", PQresultErrorMessage(res));
-		PQclear(res);
-		PQfinish(c);
-		/* XXX leak another connection? */
-		exit(EXIT_FAILURE);
-	}
-
-	l->nseclabels = PQntuples(res);
-	if (l->nseclabels > 0)
-		l->seclabels = (PQLSecLabel *) malloc(l->nseclabels * sizeof(PQLSecLabel));
-	else
-		l->seclabels = NULL;
-
-	logDebug("number of security labels in language \"%s\": %d", l->languagename,
-			 l->nseclabels);
-
-	for (i = 0; i < l->nseclabels; i++)
-	{
-		char	*withoutescape;
-
-		l->seclabels[i].provider = strdup(PQgetvalue(res, i, PQfnumber(res,
-										  "provider")));
-		withoutescape = PQgetvalue(res, i, PQfnumber(res, "label"));
-		l->seclabels[i].label = PQescapeLiteral(c, withoutescape,
-												strlen(withoutescape));
-		if (l->seclabels[i].label == NULL)
-		{
-			logError("escaping label failed: %s", PQerrorMessage(c));
-			PQclear(res);
-			PQfinish(c);
-			/* XXX leak another connection? */
-			exit(EXIT_FAILURE);
-		}
+		logWarning("ignoring security labels because server does not support it");
+		return;
 	}
 
-	PQclear(res);
-}
-
-void
-freeLanguages(PQLLanguage *l, int n)
-{
-	if (n > 0)
+	for (i = 0; i < n; i++)
 	{
-		int	i;
-
-		for (i = 0; i < n; i++)
-		{
-			int	j;
-
-			free(l[i].languagename);
-			if (l[i].callfunc.schemaname)
-				free(l[i].callfunc.schemaname);
-			if (l[i].callfunc.objectname)
-				free(l[i].callfunc.objectname);
-			if (l[i].inlinefunc.schemaname)
-				free(l[i].inlinefunc.schemaname);
-			if (l[i].inlinefunc.objectname)
-				free(l[i].inlinefunc.objectname);
-			if (l[i].validatorfunc.schemaname)
-				free(l[i].validatorfunc.schemaname);
-			if (l[i].validatorfunc.objectname)
-				free(l[i].validatorfunc.objectname);
-			if (l[i].comment)
-				PQfreemem(l[i].comment);
-			free(l[i].owner);
-			if (l[i].acl)
-				free(l[i].acl);
-
-			/* security labels */
-			for (j = 0; j < l[i].nseclabels; j++)
-			{
-				free(l[i].seclabels[j].provider);
-				PQfreemem(l[i].seclabels[j].label);
-			}
-
-			if (l[i].seclabels)
-				free(l[i].seclabels);
-		}
+		l[i].nseclabels = getObjectSecurityLabels(c, PGQ_CLASS_LANGUAGE,
+							  l[i].oid, 0, &l[i].seclabels);
 
-		free(l);
+		logDebug("number of security labels in language \"%s\": %d", l[i].languagename,
+				 l[i].nseclabels);
 	}
 }
 
@@ -272,24 +176,17 @@ dumpCreateLanguage(FILE *output, PQLLanguage *l)
 
 	if (hasparams)
 	{
-		n1 = formatObjectIdentifier(l->callfunc.schemaname);
-		o1 = formatObjectIdentifier(l->callfunc.objectname);
-		n2 = formatObjectIdentifier(l->inlinefunc.schemaname);
-		o2 = formatObjectIdentifier(l->inlinefunc.objectname);
-		n3 = formatObjectIdentifier(l->validatorfunc.schemaname);
-		o3 = formatObjectIdentifier(l->validatorfunc.objectname);
+		n1 = quotedName(l->callfunc.schemaname);
+		o1 = quotedName(l->callfunc.objectname);
+		n2 = quotedName(l->inlinefunc.schemaname);
+		o2 = quotedName(l->inlinefunc.objectname);
+		n3 = quotedName(l->validatorfunc.schemaname);
+		o3 = quotedName(l->validatorfunc.objectname);
 
 		fprintf(output, "CREATE %sPROCEDURAL LANGUAGE %s", l->trusted ? "TRUSTED" : "", langname);
-		fprintf(output, " HANDLER %s.%s", l->callfunc.schemaname, l->callfunc.objectname);
-		fprintf(output, " INLINE %s.%s", l->inlinefunc.schemaname, l->inlinefunc.objectname);
-		fprintf(output, " VALIDATOR %s.%s", l->validatorfunc.schemaname, l->validatorfunc.objectname);
-
-		free(n1);
-		free(o1);
-		free(n2);
-		free(o2);
-		free(n3);
-		free(o3);
+		fprintf(output, " HANDLER %s.%s", n1, o1);
+		fprintf(output, " INLINE %s.%s", n2, o2);
+		fprintf(output, " VALIDATOR %s.%s", n3, o3);
 	}
 	else
 	{
@@ -302,7 +199,9 @@ dumpCreateLanguage(FILE *output, PQLLanguage *l)
 	if (options.comment && l->comment != NULL)
 	{
 		fprintf(output, "\n\n");
-		fprintf(output, "COMMENT ON LANGUAGE %s IS %s;", langname, l->comment);
+		fprintf(output, "COMMENT ON LANGUAGE %s IS ", langname);
+		printComment(output, l->comment);
+		fprintf(output, ";");
 	}
 
 	/* security labels */
@@ -323,14 +222,12 @@ dumpCreateLanguage(FILE *output, PQLLanguage *l)
 	/* owner */
 	if (options.owner)
 	{
-		char	*owner = formatObjectIdentifier(l->owner);
+		char	*owner = quotedName(l->owner);
 
 		fprintf(output, "\n\n");
 		fprintf(output, "ALTER LANGUAGE %s OWNER TO %s;",
 				langname,
 				owner);
-
-		free(owner);
 	}
 
 	/* privileges */
@@ -368,7 +265,9 @@ dumpAlterLanguage(FILE *output, PQLLanguage *a, PQLLanguage *b)
 				 strcmp(a->comment, b->comment) != 0))
 		{
 			fprintf(output, "\n\n");
-			fprintf(output, "COMMENT ON LANGUAGE %s IS %s;", langname2, b->comment);
+			fprintf(output, "COMMENT ON LANGUAGE %s IS ", langname2);
+			printComment(output, b->comment);
+			fprintf(output, ";");
 		}
 		else if (a->comment != NULL && b->comment == NULL)
 		{
@@ -468,14 +367,12 @@ dumpAlterLanguage(FILE *output, PQLLanguage *a, PQLLanguage *b)
 	{
 		if (strcmp(a->owner, b->owner) != 0)
 		{
-			char	*owner = formatObjectIdentifier(b->owner);
+			char	*owner = quotedName(b->owner);
 
 			fprintf(output, "\n\n");
 			fprintf(output, "ALTER LANGUAGE %s OWNER TO %s;",
 					langname2,
 					owner);
-
-			free(owner);
 		}
 	}
 
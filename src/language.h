@@ -9,8 +9,10 @@
 #ifndef LANGUAGE_H
 #define LANGUAGE_H
 
+#include "comment.h"
 #include "common.h"
 #include "privileges.h"
+#include "seclabel.h"
 
 typedef struct PQLLanguage
 {
@@ -30,12 +32,11 @@ typedef struct PQLLanguage
 } PQLLanguage;
 
 PQLLanguage *getLanguages(PGconn *c, int *n);
-void getLanguageSecurityLabels(PGconn *c, PQLLanguage *l);
+void getLanguageSecurityLabels(PGconn *c, PQLLanguage *l, int n);
 
 void dumpDropLanguage(FILE *output, PQLLanguage *l);
 void dumpCreateLanguage(FILE *output, PQLLanguage *l);
 void dumpAlterLanguage(FILE *output, PQLLanguage *a, PQLLanguage *b);
 
-void freeLanguages(PQLLanguage *l, int n);
 
 #endif	/* LANGUAGE_H */
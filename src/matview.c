@@ -44,18 +44,18 @@ getMaterializedViews(PGconn *c, int *n)
 	PGresult				*res;
 	int						i;
 
-	logNoise("materialized view: server version: %d", PQserverVersion(c));
+	logNoise("materialized view: server version: %d", getServerVersion(c));
 
 	/* bail out if we do not support it */
-	if (PQserverVersion(c) < 90300)
+	if (getServerVersion(c) < 90300)
 	{
 		logWarning("ignoring materialized views because server does not support it");
 		return NULL;
 	}
 
-	query = psprintf("SELECT c.oid, n.nspname, c.relname, t.spcname AS tablespacename, pg_get_viewdef(c.oid) AS viewdef, array_to_string(c.reloptions, ', ') AS reloptions, relispopulated, obj_description(c.oid, 'pg_class') AS description, pg_get_userbyid(c.relowner) AS relowner FROM pg_class c INNER JOIN pg_namespace n ON (c.relnamespace = n.oid) LEFT JOIN pg_tablespace t ON (c.reltablespace = t.oid) WHERE relkind = 'm' AND nspname !~ '^pg_' AND nspname <> 'information_schema' %s%s AND NOT EXISTS(SELECT 1 FROM pg_depend d WHERE c.oid = d.objid AND d.deptype = 'e') ORDER BY nspname, relname", include_schema_str, exclude_schema_str);
+	query = psprintf("SELECT c.oid, n.nspname, c.relname, t.spcname AS tablespacename, pg_get_viewdef(c.oid) AS viewdef, array_to_string(c.reloptions, ', ') AS reloptions, relispopulated, pg_get_userbyid(c.relowner) AS relowner FROM pg_class c INNER JOIN pg_namespace n ON (c.relnamespace = n.oid) LEFT JOIN pg_tablespace t ON (c.reltablespace = t.oid) WHERE relkind = 'm' AND nspname !~ '^pg_' AND nspname <> 'information_schema' %s%s AND NOT EXISTS(SELECT 1 FROM pg_depend d WHERE c.oid = d.objid AND d.deptype = 'e') ORDER BY nspname, relname", include_schema_str, exclude_schema_str);
 
-	res = PQexec(c, query);
+	res = execQuery(c, query);
 
 	pfree(query);
 
@@ -70,7 +70,7 @@ getMaterializedViews(PGconn *c, int *n)
 
 	*n = PQntuples(res);
 	if (*n > 0)
-		v = (PQLMaterializedView *) malloc(*n * sizeof(PQLMaterializedView));
+		v = (PQLMaterializedView *) arenaAlloc(*n * sizeof(PQLMaterializedView));
 	else
 		v = NULL;
 
@@ -78,52 +78,37 @@ getMaterializedViews(PGconn *c, int *n)
 
 	for (i = 0; i < *n; i++)
 	{
-		char	*withoutescape;
 		int		len;
 
 		v[i].obj.oid = strtoul(PQgetvalue(res, i, PQfnumber(res, "oid")), NULL, 10);
-		v[i].obj.schemaname = strdup(PQgetvalue(res, i, PQfnumber(res, "nspname")));
-		v[i].obj.objectname = strdup(PQgetvalue(res, i, PQfnumber(res, "relname")));
+		v[i].obj.schemaname = internName(PQgetvalue(res, i, PQfnumber(res, "nspname")));
+		v[i].obj.objectname = internName(PQgetvalue(res, i, PQfnumber(res, "relname")));
 		if (PQgetisnull(res, i, PQfnumber(res, "tablespacename")))
 			v[i].tbspcname = NULL;
 		else
-			v[i].tbspcname = strdup(PQgetvalue(res, i, PQfnumber(res, "tablespacename")));
+			v[i].tbspcname = arenaStrdup(PQgetvalue(res, i, PQfnumber(res, "tablespacename")));
 		v[i].populated = (PQgetvalue(res, i, PQfnumber(res,
 									 "relispopulated"))[0] == 't');
 
 		/* FIXME don't load it only iff view will be DROPped */
 		len = PQgetlength(res, i, PQfnumber(res, "viewdef"));
 		/* allocate only len because semicolon will be stripped */
-		v[i].viewdef = (char *) malloc(len * sizeof(char));
+		v[i].viewdef = (char *) arenaAlloc(len * sizeof(char));
 		strncpy(v[i].viewdef, PQgetvalue(res, i, PQfnumber(res, "viewdef")), len - 1);
 		v[i].viewdef[len - 1] = '\0';
 
 		if (PQgetisnull(res, i, PQfnumber(res, "reloptions")))
 			v[i].reloptions = NULL;
 		else
-			v[i].reloptions = strdup(PQgetvalue(res, i, PQfnumber(res, "reloptions")));
-		if (PQgetisnull(res, i, PQfnumber(res, "description")))
-			v[i].comment = NULL;
-		else
-		{
-			withoutescape = PQgetvalue(res, i, PQfnumber(res, "description"));
-			v[i].comment = PQescapeLiteral(c, withoutescape, strlen(withoutescape));
-			if (v[i].comment == NULL)
-			{
-				logError("escaping comment failed: %s", PQerrorMessage(c));
-				PQclear(res);
-				PQfinish(c);
-				/* XXX leak another connection? */
-				exit(EXIT_FAILURE);
-			}
-		}
+			v[i].reloptions = arenaStrdup(PQgetvalue(res, i, PQfnumber(res, "reloptions")));
+		v[i].comment = getComment(PGQ_CLASS_CLASS, v[i].obj.oid, 0);
 
-		v[i].owner = strdup(PQgetvalue(res, i, PQfnumber(res, "relowner")));
+		v[i].owner = internName(PQgetvalue(res, i, PQfnumber(res, "relowner")));
 
 		/*
 		 * Security labels are not assigned here (see
 		 * getMaterializedViewSecurityLabels), but default values are essential
-		 * to avoid having trouble in freeMaterializedViews.
+		 * to avoid having trouble in the dump routines.
 		 */
 		v[i].nseclabels = 0;
 		v[i].seclabels = NULL;
@@ -134,7 +119,7 @@ getMaterializedViews(PGconn *c, int *n)
 		/*
 		 * These values are not assigned here (see
 		 * getMaterializedViewAttributes), but default values are essential to
-		 * avoid having trouble in freeMaterializedViews.
+		 * avoid having trouble in the dump routines.
 		 */
 		v[i].nattributes = 0;
 		v[i].attributes = NULL;
@@ -153,220 +138,130 @@ getMaterializedViews(PGconn *c, int *n)
 }
 
 void
-getMaterializedViewAttributes(PGconn *c, PQLMaterializedView *v)
+getMaterializedViewAttributes(PGconn *c, PQLMaterializedView *v, int n)
 {
-	char		*query;
-	PGresult	*res;
-	int			i;
+	char		**queries;
+	PGresult	**res;
+	int			i, j;
 
-	/* FIXME attcollation (9.1)? */
-	query = psprintf("SELECT a.attnum, a.attname, a.attstattarget, a.attstorage, CASE WHEN t.typstorage <> a.attstorage THEN FALSE ELSE TRUE END AS defstorage, array_to_string(attoptions, ', ') AS attoptions FROM pg_attribute a LEFT JOIN pg_type t ON (a.atttypid = t.oid) WHERE a.attrelid = %u AND a.attnum > 0 AND attisdropped IS FALSE ORDER BY a.attname",
-					  v->obj.oid);
+	if (n == 0)
+		return;
 
-	res = PQexec(c, query);
+	/* FIXME attcollation (9.1)? */
+	queries = (char **) malloc(n * sizeof(char *));
+	for (i = 0; i < n; i++)
+		queries[i] = psprintf("SELECT a.attnum, a.attname, a.attstattarget, a.attstorage, CASE WHEN t.typstorage <> a.attstorage THEN FALSE ELSE TRUE END AS defstorage, array_to_string(attoptions, ', ') AS attoptions FROM pg_attribute a LEFT JOIN pg_type t ON (a.atttypid = t.oid) WHERE a.attrelid = %u AND a.attnum > 0 AND attisdropped IS FALSE ORDER BY a.attname",
+						  v[i].obj.oid);
 
-	pfree(query);
+	res = execQueries(c, queries, n);
 
-	if (PQresultStatus(res) != PGRES_TUPLES_OK)
+	for (i = 0; i < n; i++)
 	{
-		logError("query failed: %s", PQresultErrorMessage(res));
-		PQclear(res);
-		PQfinish(c);
-		/* XXX leak another connection? */
-		exit(EXIT_FAILURE);
-	}
-
-	v->nattributes = PQntuples(res);
-	if (v->nattributes > 0)
-		v->attributes = (PQLAttribute *) malloc(v->nattributes * sizeof(PQLAttribute));
-	else
-		v->attributes = NULL;
+		v[i].nattributes = PQntuples(res[i]);
+		if (v[i].nattributes > 0)
+			v[i].attributes = (PQLAttribute *) arenaAlloc(v[i].nattributes * sizeof(PQLAttribute));
+		else
+			v[i].attributes = NULL;
 
-	logDebug("number of attributes in materialized view \"%s\".\"%s\": %d",
-			 v->obj.schemaname, v->obj.objectname, v->nattributes);
+		logDebug("number of attributes in materialized view \"%s\".\"%s\": %d",
+				 v[i].obj.schemaname, v[i].obj.objectname, v[i].nattributes);
 
-	for (i = 0; i < v->nattributes; i++)
-	{
-		char	storage;
-
-		v->attributes[i].attnum = strtoul(PQgetvalue(res, i, PQfnumber(res, "attnum")),
-										  NULL, 10);
-		v->attributes[i].attname = strdup(PQgetvalue(res, i, PQfnumber(res,
-										  "attname")));
-
-		/* those fields are not used in materialized views */
-		v->attributes[i].attnotnull = false;
-		v->attributes[i].atttypname = NULL;
-		v->attributes[i].attdefexpr = NULL;
-		v->attributes[i].attcollation = NULL;
-		v->attributes[i].comment = NULL;
-
-		/* statistics target */
-		v->attributes[i].attstattarget = atoi(PQgetvalue(res, i, PQfnumber(res,
-											  "attstattarget")));
-
-		/* storage */
-		storage = PQgetvalue(res, i, PQfnumber(res, "attstorage"))[0];
-		switch (storage)
+		for (j = 0; j < v[i].nattributes; j++)
 		{
-			case 'p':
-				v->attributes[i].attstorage = strdup("PLAIN");
-				break;
-			case 'e':
-				v->attributes[i].attstorage = strdup("EXTERNAL");
-				break;
-			case 'm':
-				v->attributes[i].attstorage = strdup("MAIN");
-				break;
-			case 'x':
-				v->attributes[i].attstorage = strdup("EXTENDED");
-				break;
-			default:
-				v->attributes[i].attstorage = NULL;
-				break;
+			char	storage;
+
+			v[i].attributes[j].attnum = strtoul(PQgetvalue(res[i], j, PQfnumber(res[i], "attnum")),
+											  NULL, 10);
+			v[i].attributes[j].attname = arenaStrdup(PQgetvalue(res[i], j, PQfnumber(res[i],
+											  "attname")));
+
+			/* those fields are not used in materialized views */
+			v[i].attributes[j].attnotnull = false;
+			v[i].attributes[j].atttypname = NULL;
+			v[i].attributes[j].attdefexpr = NULL;
+			v[i].attributes[j].attcollation = NULL;
+			v[i].attributes[j].comment = NULL;
+
+			/* statistics target */
+			v[i].attributes[j].attstattarget = atoi(PQgetvalue(res[i], j, PQfnumber(res[i],
+												  "attstattarget")));
+
+			/* storage */
+			storage = PQgetvalue(res[i], j, PQfnumber(res[i], "attstorage"))[0];
+			switch (storage)
+			{
+				case 'p':
+					v[i].attributes[j].attstorage = arenaStrdup("PLAIN");
+					break;
+				case 'e':
+					v[i].attributes[j].attstorage = arenaStrdup("EXTERNAL");
+					break;
+				case 'm':
+					v[i].attributes[j].attstorage = arenaStrdup("MAIN");
+					break;
+				case 'x':
+					v[i].attributes[j].attstorage = arenaStrdup("EXTENDED");
+					break;
+				default:
+					v[i].attributes[j].attstorage = NULL;
+					break;
+			}
+			v[i].attributes[j].defstorage = (PQgetvalue(res[i], j, PQfnumber(res[i],
+										   "defstorage"))[0] == 't');
+
+			/* attribute options */
+			if (PQgetisnull(res[i], j, PQfnumber(res[i], "attoptions")))
+				v[i].attributes[j].attoptions = NULL;
+			else
+				v[i].attributes[j].attoptions = arenaStrdup(PQgetvalue(res[i], j, PQfnumber(res[i],
+													 "attoptions")));
 		}
-		v->attributes[i].defstorage = (PQgetvalue(res, i, PQfnumber(res,
-									   "defstorage"))[0] == 't');
 
-		/* attribute options */
-		if (PQgetisnull(res, i, PQfnumber(res, "attoptions")))
-			v->attributes[i].attoptions = NULL;
-		else
-			v->attributes[i].attoptions = strdup(PQgetvalue(res, i, PQfnumber(res,
-												 "attoptions")));
+		PQclear(res[i]);
 	}
 
-	PQclear(res);
+	free(res);
 }
 
 void
-getMaterializedViewSecurityLabels(PGconn *c, PQLMaterializedView *v)
+getMaterializedViewSecurityLabels(PGconn *c, PQLMaterializedView *v, int n)
 {
-	char		*query;
-	PGresult	*res;
 	int			i;
 
-	if (PQserverVersion(c) < 90100)
-	{
-		logWarning("ignoring security labels because server does not support it");
+	if (n == 0)
 		return;
-	}
 
-	query = psprintf("SELECT provider, label FROM pg_seclabel s INNER JOIN pg_class c ON (s.classoid = c.oid) WHERE c.relname = 'pg_class' AND s.objoid = %u ORDER BY provider",
-			 v->obj.oid);
-
-	res = PQexec(c, query);
-
-	pfree(query);
-
-	if (PQresultStatus(res) != PGRES_TUPLES_OK)
+	if (getServerVersion(c) < 90100)
 	{
-		logError("query failed: %s", PQresultErrorMessage(res));
-		PQclear(res);
-		PQfinish(c);
-		/* XXX leak another connection? */
-		exit(EXIT_FAILURE);
-	}
-
-	v->nseclabels = PQntuples(res);
-	if (v->nseclabels > 0)
-		v->seclabels = (PQLSecLabel *) malloc(v->nseclabels * sizeof(PQLSecLabel));
-	else
-		v->seclabels = NULL;
-
-	logDebug("number of security labels in materialized view \"%s\".\"%s\": %d",
-			 v->obj.schemaname, v->obj.objectname, v->nseclabels);
-
-	for (i = 0; i < v->nseclabels; i++)
-	{
-		char	*withoutescape;
-
-		v->seclabels[i].provider = strdup(PQgetvalue(res, i, PQfnumber(res,
-										  "provider")));
-		withoutescape = PQgetvalue(res, i, PQfnumber(res, "label"));
-		v->seclabels[i].label = PQescapeLiteral(c, withoutescape,
-												strlen(withoutescape));
-		if (v->seclabels[i].label == NULL)
-		{
-			logError("escaping label failed: %s", PQerrorMessage(c));
-			PQclear(res);
-			PQfinish(c);
-			/* XXX leak another connection? */
-			exit(EXIT_FAILURE);
-		}
+		logWarning("ignoring security labels because server does not support it");
+		return;
 	}
 
-	PQclear(res);
-}
-
-void
-freeMaterializedViews(PQLMaterializedView *v, int n)
-{
-	if (n > 0)
+	for (i = 0; i < n; i++)
 	{
-		int	i;
-
-		for (i = 0; i < n; i++)
-		{
-			int	j;
+		v[i].nseclabels = getObjectSecurityLabels(c, PGQ_CLASS_CLASS,
+							  v[i].obj.oid, 0, &v[i].seclabels);
 
-			free(v[i].obj.schemaname);
-			free(v[i].obj.objectname);
-			if (v[i].tbspcname)
-				free(v[i].tbspcname);
-			free(v[i].viewdef);
-			if (v[i].reloptions)
-				free(v[i].reloptions);
-			if (v[i].comment)
-				PQfreemem(v[i].comment);
-			free(v[i].owner);
-
-			/* security labels */
-			for (j = 0; j < v[i].nseclabels; j++)
-			{
-				free(v[i].seclabels[j].provider);
-				PQfreemem(v[i].seclabels[j].label);
-			}
-
-			if (v[i].seclabels)
-				free(v[i].seclabels);
-
-			/* attributes */
-			for (j = 0; j < v[i].nattributes; j++)
-			{
-				free(v[i].attributes[j].attname);
-				if (v[i].attributes[j].attstorage)
-					free(v[i].attributes[j].attstorage);
-				if (v[i].attributes[j].attoptions)
-					free(v[i].attributes[j].attoptions);
-			}
-
-			if (v[i].attributes)
-				free(v[i].attributes);
-		}
-
-		free(v);
+		logDebug("number of security labels in materialized view \"%s\".\"%s\": %d",
+				 v[i].obj.schemaname, v[i].obj.objectname, v[i].nseclabels);
 	}
 }
 
 void
 dumpDropMaterializedView(FILE *output, PQLMaterializedView *v)
 {
-	char	*schema = formatObjectIdentifier(v->obj.schemaname);
-	char	*matvname = formatObjectIdentifier(v->obj.objectname);
+	char	*schema = quotedName(v->obj.schemaname);
+	char	*matvname = quotedName(v->obj.objectname);
 
 	fprintf(output, "\n\n");
 	fprintf(output, "DROP MATERIALIZED VIEW %s.%s;", schema, matvname);
-
-	free(schema);
-	free(matvname);
 }
 
 void
 dumpCreateMaterializedView(FILE *output, PQLMaterializedView *v)
 {
-	char	*schema = formatObjectIdentifier(v->obj.schemaname);
-	char	*matvname = formatObjectIdentifier(v->obj.objectname);
+	char	*schema = quotedName(v->obj.schemaname);
+	char	*matvname = quotedName(v->obj.objectname);
 
 	int	i;
 
@@ -399,8 +294,9 @@ dumpCreateMaterializedView(FILE *output, PQLMaterializedView *v)
 	if (options.comment && v->comment != NULL)
 	{
 		fprintf(output, "\n\n");
-		fprintf(output, "COMMENT ON MATERIALIZED VIEW %s.%s IS %s;", schema, matvname,
-				v->comment);
+		fprintf(output, "COMMENT ON MATERIALIZED VIEW %s.%s IS ", schema, matvname);
+		printComment(output, v->comment);
+		fprintf(output, ";");
 	}
 
 	/* security labels */
@@ -420,25 +316,21 @@ dumpCreateMaterializedView(FILE *output, PQLMaterializedView *v)
 	/* owner */
 	if (options.owner)
 	{
-		char	*owner = formatObjectIdentifier(v->owner);
+		char	*owner = quotedName(v->owner);
 
 		fprintf(output, "\n\n");
 		fprintf(output, "ALTER MATERIALIZED VIEW %s.%s OWNER TO %s;", schema, matvname,
 				owner);
-
-		free(owner);
 	}
 
-	free(schema);
-	free(matvname);
 }
 
 static void
 dumpAlterColumnSetStatistics(FILE *output, PQLMaterializedView *a, int i,
 							 bool force)
 {
-	char	*schema = formatObjectIdentifier(a->obj.schemaname);
-	char	*matvname = formatObjectIdentifier(a->obj.objectname);
+	char	*schema = quotedName(a->obj.schemaname);
+	char	*matvname = quotedName(a->obj.objectname);
 
 	if (a->attributes[i].attstattarget != -1 || force)
 	{
@@ -450,17 +342,14 @@ dumpAlterColumnSetStatistics(FILE *output, PQLMaterializedView *a, int i,
 				a->attributes[i].attname,
 				a->attributes[i].attstattarget);
 	}
-
-	free(schema);
-	free(matvname);
 }
 
 static void
 dumpAlterColumnSetStorage(FILE *output, PQLMaterializedView *a, int i,
 						  bool force)
 {
-	char	*schema = formatObjectIdentifier(a->obj.schemaname);
-	char	*matvname = formatObjectIdentifier(a->obj.objectname);
+	char	*schema = quotedName(a->obj.schemaname);
+	char	*matvname = quotedName(a->obj.objectname);
 
 	if (!a->attributes[i].defstorage || force)
 	{
@@ -471,9 +360,6 @@ dumpAlterColumnSetStorage(FILE *output, PQLMaterializedView *a, int i,
 				a->attributes[i].attname,
 				a->attributes[i].attstorage);
 	}
-
-	free(schema);
-	free(matvname);
 }
 
 /*
@@ -483,8 +369,8 @@ static void
 dumpAlterColumnSetOptions(FILE *output, PQLMaterializedView *a,
 						  PQLMaterializedView *b, int i)
 {
-	char	*schema2 = formatObjectIdentifier(b->obj.schemaname);
-	char	*matvname2 = formatObjectIdentifier(b->obj.objectname);
+	char	*schema2 = quotedName(b->obj.schemaname);
+	char	*matvname2 = quotedName(b->obj.objectname);
 
 	if (a->attributes[i].attoptions == NULL && b->attributes[i].attoptions != NULL)
 	{
@@ -498,7 +384,7 @@ dumpAlterColumnSetOptions(FILE *output, PQLMaterializedView *a,
 	else if (a->attributes[i].attoptions != NULL &&
 			 b->attributes[i].attoptions == NULL)
 	{
-		stringList	*rlist;
+		PQLOptionSet	*rlist;
 
 		/* reset all options */
 		rlist = setOperationOptions(a->attributes[i].attoptions,
@@ -517,14 +403,14 @@ dumpAlterColumnSetOptions(FILE *output, PQLMaterializedView *a,
 					resetlist);
 
 			free(resetlist);
-			freeStringList(rlist);
+			freeOptionSet(rlist);
 		}
 	}
 	else if (a->attributes[i].attoptions != NULL &&
 			 b->attributes[i].attoptions != NULL &&
 			 strcmp(a->attributes[i].attoptions, b->attributes[i].attoptions) != 0)
 	{
-		stringList	*rlist, *ilist, *slist;
+		PQLOptionSet	*rlist, *ilist, *slist;
 
 		/* reset options that are only presented in the first set */
 		rlist = setOperationOptions(a->attributes[i].attoptions,
@@ -543,7 +429,7 @@ dumpAlterColumnSetOptions(FILE *output, PQLMaterializedView *a,
 					resetlist);
 
 			free(resetlist);
-			freeStringList(rlist);
+			freeOptionSet(rlist);
 		}
 
 		/*
@@ -565,7 +451,7 @@ dumpAlterColumnSetOptions(FILE *output, PQLMaterializedView *a,
 					setlist);
 
 			free(setlist);
-			freeStringList(ilist);
+			freeOptionSet(ilist);
 		}
 
 		/*
@@ -586,22 +472,19 @@ dumpAlterColumnSetOptions(FILE *output, PQLMaterializedView *a,
 					setlist);
 
 			free(setlist);
-			freeStringList(slist);
+			freeOptionSet(slist);
 		}
 	}
-
-	free(schema2);
-	free(matvname2);
 }
 
 void
 dumpAlterMaterializedView(FILE *output, PQLMaterializedView *a,
 						  PQLMaterializedView *b)
 {
-	char	*schema1 = formatObjectIdentifier(a->obj.schemaname);
-	char	*matvname1 = formatObjectIdentifier(a->obj.objectname);
-	char	*schema2 = formatObjectIdentifier(b->obj.schemaname);
-	char	*matvname2 = formatObjectIdentifier(b->obj.objectname);
+	char	*schema1 = quotedName(a->obj.schemaname);
+	char	*matvname1 = quotedName(a->obj.objectname);
+	char	*schema2 = quotedName(b->obj.schemaname);
+	char	*matvname2 = quotedName(b->obj.objectname);
 
 	int i;
 
@@ -631,7 +514,7 @@ dumpAlterMaterializedView(FILE *output, PQLMaterializedView *a,
 	}
 	else if (a->reloptions != NULL && b->reloptions == NULL)
 	{
-		stringList	*rlist;
+		PQLOptionSet	*rlist;
 
 		rlist = setOperationOptions(a->reloptions, b->reloptions, PGQ_SETDIFFERENCE,
 									false, true);
@@ -647,13 +530,13 @@ dumpAlterMaterializedView(FILE *output, PQLMaterializedView *a,
 					resetlist);
 
 			free(resetlist);
-			freeStringList(rlist);
+			freeOptionSet(rlist);
 		}
 	}
 	else if (a->reloptions != NULL && b->reloptions != NULL &&
 			 strcmp(a->reloptions, b->reloptions) != 0)
 	{
-		stringList	*rlist, *ilist, *slist;
+		PQLOptionSet	*rlist, *ilist, *slist;
 
 		/* reset options that are only presented in the first set */
 		rlist = setOperationOptions(a->reloptions, b->reloptions, PGQ_SETDIFFERENCE,
@@ -670,7 +553,7 @@ dumpAlterMaterializedView(FILE *output, PQLMaterializedView *a,
 					resetlist);
 
 			free(resetlist);
-			freeStringList(rlist);
+			freeOptionSet(rlist);
 		}
 
 		/*
@@ -691,7 +574,7 @@ dumpAlterMaterializedView(FILE *output, PQLMaterializedView *a,
 					setlist);
 
 			free(setlist);
-			freeStringList(ilist);
+			freeOptionSet(ilist);
 		}
 
 		/*
@@ -711,7 +594,7 @@ dumpAlterMaterializedView(FILE *output, PQLMaterializedView *a,
 					setlist);
 
 			free(setlist);
-			freeStringList(slist);
+			freeOptionSet(slist);
 		}
 	}
 
@@ -723,10 +606,11 @@ dumpAlterMaterializedView(FILE *output, PQLMaterializedView *a,
 				 strcmp(a->comment, b->comment) != 0))
 		{
 			fprintf(output, "\n\n");
-			fprintf(output, "COMMENT ON MATERIALIZED VIEW %s.%s IS %s;",
+			fprintf(output, "COMMENT ON MATERIALIZED VIEW %s.%s IS ",
 					schema2,
-					matvname2,
-					b->comment);
+					matvname2);
+			printComment(output, b->comment);
+			fprintf(output, ";");
 		}
 		else if (a->comment != NULL && b->comment == NULL)
 		{
@@ -831,20 +715,13 @@ dumpAlterMaterializedView(FILE *output, PQLMaterializedView *a,
 	{
 		if (strcmp(a->owner, b->owner) != 0)
 		{
-			char	*owner = formatObjectIdentifier(b->owner);
+			char	*owner = quotedName(b->owner);
 
 			fprintf(output, "\n\n");
 			fprintf(output, "ALTER MATERIALIZED VIEW %s.%s OWNER TO %s;",
 					schema2,
 					matvname2,
 					owner);
-
-			free(owner);
 		}
 	}
-
-	free(schema1);
-	free(matvname1);
-	free(schema2);
-	free(matvname2);
 }
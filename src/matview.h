@@ -9,7 +9,9 @@
 #ifndef MATVIEW_H
 #define MATVIEW_H
 
+#include "comment.h"
 #include "common.h"
+#include "seclabel.h"
 
 typedef struct PQLMaterializedView
 {
@@ -33,14 +35,13 @@ typedef struct PQLMaterializedView
 } PQLMaterializedView;
 
 PQLMaterializedView *getMaterializedViews(PGconn *c, int *n);
-void getMaterializedViewAttributes(PGconn *c, PQLMaterializedView *v);
-void getMaterializedViewSecurityLabels(PGconn *c, PQLMaterializedView *v);
+void getMaterializedViewAttributes(PGconn *c, PQLMaterializedView *v, int n);
+void getMaterializedViewSecurityLabels(PGconn *c, PQLMaterializedView *v, int n);
 
 void dumpDropMaterializedView(FILE *output, PQLMaterializedView *v);
 void dumpCreateMaterializedView(FILE *output, PQLMaterializedView *v);
 void dumpAlterMaterializedView(FILE *output, PQLMaterializedView *a,
 							   PQLMaterializedView *b);
 
-void freeMaterializedViews(PQLMaterializedView *v, int n);
 
 #endif	/* MATVIEW_H */
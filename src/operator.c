@@ -50,11 +50,11 @@ getOperators(PGconn *c, int *n)
 	PGresult		*res;
 	int				i;
 
-	logNoise("operator: server version: %d", PQserverVersion(c));
+	logNoise("operator: server version: %d", getServerVersion(c));
 
-	query = psprintf("SELECT o.oid, n.nspname, o.oprname, oprcode::regprocedure, oprleft::regtype, oprright::regtype, oprcom::regoperator, oprnegate::regoperator, oprrest::regprocedure, oprjoin::regprocedure, oprcanhash, oprcanmerge, obj_description(o.oid, 'pg_operator') AS description, pg_get_userbyid(o.oprowner) AS oprowner FROM pg_operator o INNER JOIN pg_namespace n ON (o.oprnamespace = n.oid) WHERE o.oid >= %u %s%s AND NOT EXISTS(SELECT 1 FROM pg_depend d WHERE o.oid = d.objid AND deptype = 'e') ORDER BY n.nspname, o.oprname, o.oprleft, o.oprright", PGQ_FIRST_USER_OID, include_schema_str, exclude_schema_str);
+	query = psprintf("SELECT o.oid, n.nspname, o.oprname, oprcode::regprocedure, oprleft::regtype, oprright::regtype, oprcom::regoperator, oprnegate::regoperator, oprrest::regprocedure, oprjoin::regprocedure, oprcanhash, oprcanmerge, pg_get_userbyid(o.oprowner) AS oprowner FROM pg_operator o INNER JOIN pg_namespace n ON (o.oprnamespace = n.oid) WHERE o.oid >= %u %s%s AND NOT EXISTS(SELECT 1 FROM pg_depend d WHERE o.oid = d.objid AND deptype = 'e') ORDER BY n.nspname, o.oprname, o.oprleft, o.oprright", PGQ_FIRST_USER_OID, include_schema_str, exclude_schema_str);
 
-	res = PQexec(c, query);
+	res = execQuery(c, query);
 
 	pfree(query);
 
@@ -69,7 +69,7 @@ getOperators(PGconn *c, int *n)
 
 	*n = PQntuples(res);
 	if (*n > 0)
-		o = (PQLOperator *) malloc(*n * sizeof(PQLOperator));
+		o = (PQLOperator *) arenaAlloc(*n * sizeof(PQLOperator));
 	else
 		o = NULL;
 
@@ -77,63 +77,47 @@ getOperators(PGconn *c, int *n)
 
 	for (i = 0; i < *n; i++)
 	{
-		char	*withoutescape;
-
 		o[i].obj.oid = strtoul(PQgetvalue(res, i, PQfnumber(res, "oid")), NULL, 10);
-		o[i].obj.schemaname = strdup(PQgetvalue(res, i, PQfnumber(res, "nspname")));
-		o[i].obj.objectname = strdup(PQgetvalue(res, i, PQfnumber(res, "oprname")));
-		o[i].procedure = strdup(PQgetvalue(res, i, PQfnumber(res, "oprcode")));
+		o[i].obj.schemaname = internName(PQgetvalue(res, i, PQfnumber(res, "nspname")));
+		o[i].obj.objectname = internName(PQgetvalue(res, i, PQfnumber(res, "oprname")));
+		o[i].procedure = arenaStrdup(PQgetvalue(res, i, PQfnumber(res, "oprcode")));
 
 		if (PQgetisnull(res, i, PQfnumber(res, "oprleft")))
 			o[i].lefttype = NULL;
 		else
-			o[i].lefttype  = strdup(PQgetvalue(res, i, PQfnumber(res, "oprleft")));
+			o[i].lefttype  = arenaStrdup(PQgetvalue(res, i, PQfnumber(res, "oprleft")));
 
 		if (PQgetisnull(res, i, PQfnumber(res, "oprright")))
 			o[i].righttype = NULL;
 		else
-			o[i].righttype  = strdup(PQgetvalue(res, i, PQfnumber(res, "oprright")));
+			o[i].righttype  = arenaStrdup(PQgetvalue(res, i, PQfnumber(res, "oprright")));
 
 		if (strcmp(PQgetvalue(res, i, PQfnumber(res, "oprcom")), "0") == 0)
 			o[i].commutator = NULL;
 		else
-			o[i].commutator  = strdup(PQgetvalue(res, i, PQfnumber(res, "oprcom")));
+			o[i].commutator  = arenaStrdup(PQgetvalue(res, i, PQfnumber(res, "oprcom")));
 
 		if (strcmp(PQgetvalue(res, i, PQfnumber(res, "oprnegate")), "0") == 0)
 			o[i].negator = NULL;
 		else
-			o[i].negator  = strdup(PQgetvalue(res, i, PQfnumber(res, "oprnegate")));
+			o[i].negator  = arenaStrdup(PQgetvalue(res, i, PQfnumber(res, "oprnegate")));
 
 		if (strcmp(PQgetvalue(res, i, PQfnumber(res, "oprrest")), "-") == 0)
 			o[i].restriction = NULL;
 		else
-			o[i].restriction  = strdup(PQgetvalue(res, i, PQfnumber(res, "oprrest")));
+			o[i].restriction  = arenaStrdup(PQgetvalue(res, i, PQfnumber(res, "oprrest")));
 
 		if (strcmp(PQgetvalue(res, i, PQfnumber(res, "oprjoin")), "-") == 0)
 			o[i].join = NULL;
 		else
-			o[i].join  = strdup(PQgetvalue(res, i, PQfnumber(res, "oprjoin")));
+			o[i].join  = arenaStrdup(PQgetvalue(res, i, PQfnumber(res, "oprjoin")));
 
 		o[i].canhash = (PQgetvalue(res, i, PQfnumber(res, "oprcanhash"))[0] == 't');
 		o[i].canmerge = (PQgetvalue(res, i, PQfnumber(res, "oprcanmerge"))[0] == 't');
 
-		if (PQgetisnull(res, i, PQfnumber(res, "description")))
-			o[i].comment = NULL;
-		else
-		{
-			withoutescape = PQgetvalue(res, i, PQfnumber(res, "description"));
-			o[i].comment = PQescapeLiteral(c, withoutescape, strlen(withoutescape));
-			if (o[i].comment == NULL)
-			{
-				logError("escaping comment failed: %s", PQerrorMessage(c));
-				PQclear(res);
-				PQfinish(c);
-				/* XXX leak another connection? */
-				exit(EXIT_FAILURE);
-			}
-		}
+		o[i].comment = getComment(PGQ_CLASS_OPERATOR, o[i].obj.oid, 0);
 
-		o[i].owner = strdup(PQgetvalue(res, i, PQfnumber(res, "oprowner")));
+		o[i].owner = internName(PQgetvalue(res, i, PQfnumber(res, "oprowner")));
 
 		if (o[i].lefttype != NULL && o[i].righttype != NULL)
 			logDebug("operator \"%s\".%s(%s, %s)", o[i].obj.schemaname,
@@ -159,11 +143,11 @@ getOperatorClasses(PGconn *c, int *n)
 	PGresult			*res;
 	int					i;
 
-	logNoise("operator class: server version: %d", PQserverVersion(c));
+	logNoise("operator class: server version: %d", getServerVersion(c));
 
-	query = psprintf("SELECT c.oid, n.nspname AS opcnspname, c.opcname, c.opcdefault, c.opcintype::regtype, a.amname, o.nspname AS opfnspname, f.opfname, CASE WHEN c.opckeytype = 0 THEN NULL ELSE c.opckeytype::regtype END AS storage, obj_description(c.oid, 'pg_opclass') AS description, pg_get_userbyid(c.opcowner) AS opcowner FROM pg_opclass c INNER JOIN pg_namespace n ON (c.opcnamespace = n.oid) INNER JOIN pg_am a ON (c.opcmethod = a.oid) LEFT JOIN (pg_opfamily f INNER JOIN pg_namespace o ON (f.opfnamespace = o.oid)) ON (c.opcfamily = f.oid) WHERE c.oid >= %u %s%s AND NOT EXISTS(SELECT 1 FROM pg_depend d WHERE c.oid = d.objid AND deptype = 'e') ORDER BY c.opcnamespace, c.opcname", PGQ_FIRST_USER_OID, include_schema_str, exclude_schema_str);
+	query = psprintf("SELECT c.oid, n.nspname AS opcnspname, c.opcname, c.opcdefault, c.opcintype::regtype, a.amname, o.nspname AS opfnspname, f.opfname, CASE WHEN c.opckeytype = 0 THEN NULL ELSE c.opckeytype::regtype END AS storage, pg_get_userbyid(c.opcowner) AS opcowner FROM pg_opclass c INNER JOIN pg_namespace n ON (c.opcnamespace = n.oid) INNER JOIN pg_am a ON (c.opcmethod = a.oid) LEFT JOIN (pg_opfamily f INNER JOIN pg_namespace o ON (f.opfnamespace = o.oid)) ON (c.opcfamily = f.oid) WHERE c.oid >= %u %s%s AND NOT EXISTS(SELECT 1 FROM pg_depend d WHERE c.oid = d.objid AND deptype = 'e') ORDER BY c.opcnamespace, c.opcname", PGQ_FIRST_USER_OID, include_schema_str, exclude_schema_str);
 
-	res = PQexec(c, query);
+	res = execQuery(c, query);
 
 	pfree(query);
 
@@ -178,7 +162,7 @@ getOperatorClasses(PGconn *c, int *n)
 
 	*n = PQntuples(res);
 	if (*n > 0)
-		d = (PQLOperatorClass *) malloc(*n * sizeof(PQLOperatorClass));
+		d = (PQLOperatorClass *) arenaAlloc(*n * sizeof(PQLOperatorClass));
 	else
 		d = NULL;
 
@@ -186,15 +170,13 @@ getOperatorClasses(PGconn *c, int *n)
 
 	for (i = 0; i < *n; i++)
 	{
-		char	*withoutescape;
-
 		d[i].obj.oid = strtoul(PQgetvalue(res, i, PQfnumber(res, "oid")), NULL, 10);
-		d[i].obj.schemaname = strdup(PQgetvalue(res, i, PQfnumber(res, "opcnspname")));
-		d[i].obj.objectname = strdup(PQgetvalue(res, i, PQfnumber(res, "opcname")));
+		d[i].obj.schemaname = internName(PQgetvalue(res, i, PQfnumber(res, "opcnspname")));
+		d[i].obj.objectname = internName(PQgetvalue(res, i, PQfnumber(res, "opcname")));
 		d[i].defaultopclass = (PQgetvalue(res, i, PQfnumber(res,
 										  "opcdefault"))[0] == 't');
-		d[i].intype = strdup(PQgetvalue(res, i, PQfnumber(res, "opcintype")));
-		d[i].accessmethod = strdup(PQgetvalue(res, i, PQfnumber(res, "amname")));
+		d[i].intype = arenaStrdup(PQgetvalue(res, i, PQfnumber(res, "opcintype")));
+		d[i].accessmethod = arenaStrdup(PQgetvalue(res, i, PQfnumber(res, "amname")));
 		if (PQgetisnull(res, i, PQfnumber(res, "opfname")))
 		{
 			d[i].family.schemaname = NULL;
@@ -202,42 +184,28 @@ getOperatorClasses(PGconn *c, int *n)
 		}
 		else
 		{
-			d[i].family.schemaname = strdup(PQgetvalue(res, i, PQfnumber(res,
+			d[i].family.schemaname = internName(PQgetvalue(res, i, PQfnumber(res,
 											"opfnspname")));
-			d[i].family.objectname = strdup(PQgetvalue(res, i, PQfnumber(res, "opfname")));
+			d[i].family.objectname = internName(PQgetvalue(res, i, PQfnumber(res, "opfname")));
 		}
 		if (PQgetisnull(res, i, PQfnumber(res, "storage")))
 			d[i].storagetype = NULL;
 		else
-			d[i].storagetype = strdup(PQgetvalue(res, i, PQfnumber(res, "storage")));
+			d[i].storagetype = arenaStrdup(PQgetvalue(res, i, PQfnumber(res, "storage")));
 
 		/*
 		 * These values are not assigned here (see getOpFuncAttributes), but
 		 * default values are essential to avoid having trouble in
-		 * freeOperatorClasses.
+		 * the dump routines.
 		 */
 		d[i].opandfunc.noperators = 0;
 		d[i].opandfunc.operators = NULL;
 		d[i].opandfunc.nfunctions = 0;
 		d[i].opandfunc.functions = NULL;
 
-		if (PQgetisnull(res, i, PQfnumber(res, "description")))
-			d[i].comment = NULL;
-		else
-		{
-			withoutescape = PQgetvalue(res, i, PQfnumber(res, "description"));
-			d[i].comment = PQescapeLiteral(c, withoutescape, strlen(withoutescape));
-			if (d[i].comment == NULL)
-			{
-				logError("escaping comment failed: %s", PQerrorMessage(c));
-				PQclear(res);
-				PQfinish(c);
-				/* XXX leak another connection? */
-				exit(EXIT_FAILURE);
-			}
-		}
+		d[i].comment = getComment(PGQ_CLASS_OPCLASS, d[i].obj.oid, 0);
 
-		d[i].owner = strdup(PQgetvalue(res, i, PQfnumber(res, "opcowner")));
+		d[i].owner = internName(PQgetvalue(res, i, PQfnumber(res, "opcowner")));
 	}
 
 	PQclear(res);
@@ -253,11 +221,11 @@ getOperatorFamilies(PGconn *c, int *n)
 	PGresult			*res;
 	int					i;
 
-	logNoise("operator family: server version: %d", PQserverVersion(c));
+	logNoise("operator family: server version: %d", getServerVersion(c));
 
-	query = psprintf("SELECT f.oid, n.nspname AS opfnspname, f.opfname, a.amname, obj_description(f.oid, 'pg_opfamily') AS description, pg_get_userbyid(f.opfowner) AS opfowner FROM pg_opfamily f INNER JOIN pg_namespace n ON (f.opfnamespace = n.oid) INNER JOIN pg_am a ON (f.opfmethod = a.oid) WHERE f.oid >= %u %s%s AND NOT EXISTS(SELECT 1 FROM pg_depend d WHERE f.oid = d.objid AND deptype = 'e') ORDER BY opfnspname, f.opfname", PGQ_FIRST_USER_OID, include_schema_str, exclude_schema_str);
+	query = psprintf("SELECT f.oid, n.nspname AS opfnspname, f.opfname, a.amname, pg_get_userbyid(f.opfowner) AS opfowner FROM pg_opfamily f INNER JOIN pg_namespace n ON (f.opfnamespace = n.oid) INNER JOIN pg_am a ON (f.opfmethod = a.oid) WHERE f.oid >= %u %s%s AND NOT EXISTS(SELECT 1 FROM pg_depend d WHERE f.oid = d.objid AND deptype = 'e') ORDER BY opfnspname, f.opfname", PGQ_FIRST_USER_OID, include_schema_str, exclude_schema_str);
 
-	res = PQexec(c, query);
+	res = execQuery(c, query);
 
 	pfree(query);
 
@@ -272,7 +240,7 @@ getOperatorFamilies(PGconn *c, int *n)
 
 	*n = PQntuples(res);
 	if (*n > 0)
-		f = (PQLOperatorFamily *) malloc(*n * sizeof(PQLOperatorFamily));
+		f = (PQLOperatorFamily *) arenaAlloc(*n * sizeof(PQLOperatorFamily));
 	else
 		f = NULL;
 
@@ -280,40 +248,24 @@ getOperatorFamilies(PGconn *c, int *n)
 
 	for (i = 0; i < *n; i++)
 	{
-		char	*withoutescape;
-
 		f[i].obj.oid = strtoul(PQgetvalue(res, i, PQfnumber(res, "oid")), NULL, 10);
-		f[i].obj.schemaname = strdup(PQgetvalue(res, i, PQfnumber(res, "opfnspname")));
-		f[i].obj.objectname = strdup(PQgetvalue(res, i, PQfnumber(res, "opfname")));
-		f[i].accessmethod = strdup(PQgetvalue(res, i, PQfnumber(res, "amname")));
+		f[i].obj.schemaname = internName(PQgetvalue(res, i, PQfnumber(res, "opfnspname")));
+		f[i].obj.objectname = internName(PQgetvalue(res, i, PQfnumber(res, "opfname")));
+		f[i].accessmethod = arenaStrdup(PQgetvalue(res, i, PQfnumber(res, "amname")));
 
 		/*
 		 * These values are not assigned here (see getOpFuncAttributes), but
 		 * default values are essential to avoid having trouble in
-		 * freeOperatorFamilies.
+		 * the dump routines.
 		 */
 		f[i].opandfunc.noperators = 0;
 		f[i].opandfunc.operators = NULL;
 		f[i].opandfunc.nfunctions = 0;
 		f[i].opandfunc.functions = NULL;
 
-		if (PQgetisnull(res, i, PQfnumber(res, "description")))
-			f[i].comment = NULL;
-		else
-		{
-			withoutescape = PQgetvalue(res, i, PQfnumber(res, "description"));
-			f[i].comment = PQescapeLiteral(c, withoutescape, strlen(withoutescape));
-			if (f[i].comment == NULL)
-			{
-				logError("escaping comment failed: %s", PQerrorMessage(c));
-				PQclear(res);
-				PQfinish(c);
-				/* XXX leak another connection? */
-				exit(EXIT_FAILURE);
-			}
-		}
+		f[i].comment = getComment(PGQ_CLASS_OPFAMILY, f[i].obj.oid, 0);
 
-		f[i].owner = strdup(PQgetvalue(res, i, PQfnumber(res, "opfowner")));
+		f[i].owner = internName(PQgetvalue(res, i, PQfnumber(res, "opfowner")));
 	}
 
 	PQclear(res);
@@ -324,30 +276,22 @@ getOperatorFamilies(PGconn *c, int *n)
 void
 getOpFuncAttributes(PGconn *c, Oid o, PQLOpAndFunc *d)
 {
-	char		*query;
-	PGresult	*res;
+	char		**queries;
+	PGresult	**res;
 	int			i;
 
-	/* Operators */
-
-	query = psprintf("SELECT amopopr::regoperator, amopstrategy, f.oid AS opfoid, n.nspname AS opfnspname, f.opfname FROM pg_amop a LEFT JOIN (pg_opfamily f INNER JOIN pg_namespace n ON (f.opfnamespace = n.oid)) ON (a.amopsortfamily = f.oid) WHERE a.amopfamily = %u", o);
+	/* operators and functions are sent together (see execQueries) */
+	queries = (char **) malloc(2 * sizeof(char *));
+	queries[0] = psprintf("SELECT amopopr::regoperator, amopstrategy, f.oid AS opfoid, n.nspname AS opfnspname, f.opfname FROM pg_amop a LEFT JOIN (pg_opfamily f INNER JOIN pg_namespace n ON (f.opfnamespace = n.oid)) ON (a.amopsortfamily = f.oid) WHERE a.amopfamily = %u", o);
+	queries[1] = psprintf("SELECT amproc::regprocedure, amprocnum FROM pg_amproc WHERE amprocfamily = %u", o);
 
-	res = PQexec(c, query);
+	res = execQueries(c, queries, 2);
 
-	pfree(query);
-
-	if (PQresultStatus(res) != PGRES_TUPLES_OK)
-	{
-		logError("query failed: %s", PQresultErrorMessage(res));
-		PQclear(res);
-		PQfinish(c);
-		/* XXX leak another connection? */
-		exit(EXIT_FAILURE);
-	}
+	/* Operators */
 
-	d->noperators = PQntuples(res);
+	d->noperators = PQntuples(res[0]);
 	if (d->noperators > 0)
-		d->operators = (PQLOpOperators *) malloc(d->noperators * sizeof(
+		d->operators = (PQLOpOperators *) arenaAlloc(d->noperators * sizeof(
 						   PQLOpOperators));
 	else
 		d->operators = NULL;
@@ -356,11 +300,11 @@ getOpFuncAttributes(PGconn *c, Oid o, PQLOpAndFunc *d)
 
 	for (i = 0; i < d->noperators; i++)
 	{
-		d->operators[i].strategy = strtoul(PQgetvalue(res, i, PQfnumber(res,
+		d->operators[i].strategy = strtoul(PQgetvalue(res[0], i, PQfnumber(res[0],
 										   "amopstrategy")),
 										   NULL, 10);
-		d->operators[i].oprname = strdup(PQgetvalue(res, i, PQfnumber(res, "amopopr")));
-		if (PQgetisnull(res, i, PQfnumber(res, "opfname")))
+		d->operators[i].oprname = arenaStrdup(PQgetvalue(res[0], i, PQfnumber(res[0], "amopopr")));
+		if (PQgetisnull(res[0], i, PQfnumber(res[0], "opfname")))
 		{
 			d->operators[i].sortfamily.oid = 0;
 			d->operators[i].sortfamily.schemaname = NULL;
@@ -368,41 +312,26 @@ getOpFuncAttributes(PGconn *c, Oid o, PQLOpAndFunc *d)
 		}
 		else
 		{
-			d->operators[i].sortfamily.oid = strtoul(PQgetvalue(res, i, PQfnumber(res,
+			d->operators[i].sortfamily.oid = strtoul(PQgetvalue(res[0], i, PQfnumber(res[0],
 											 "opfoid")), NULL, 10);
-			d->operators[i].sortfamily.schemaname = strdup(PQgetvalue(res, i, PQfnumber(res,
+			d->operators[i].sortfamily.schemaname = internName(PQgetvalue(res[0], i, PQfnumber(res[0],
 													"opfnspname")));
-			d->operators[i].sortfamily.objectname = strdup(PQgetvalue(res, i, PQfnumber(res,
+			d->operators[i].sortfamily.objectname = internName(PQgetvalue(res[0], i, PQfnumber(res[0],
 													"opfname")));
 		}
 
-		logDebug("operator: \"%s\".\"%s\" ; strategy %d",
+		logDebug("operator: \"%s\" ; strategy %d",
 				 d->operators[i].oprname,
 				 d->operators[i].strategy);
 	}
 
-	PQclear(res);
+	PQclear(res[0]);
 
 	/* Functions */
 
-	query = psprintf("SELECT amproc::regprocedure, amprocnum FROM pg_amop WHERE amopfamily = %u", o);
-
-	res = PQexec(c, query);
-
-	pfree(query);
-
-	if (PQresultStatus(res) != PGRES_TUPLES_OK)
-	{
-		logError("query failed: %s", PQresultErrorMessage(res));
-		PQclear(res);
-		PQfinish(c);
-		/* XXX leak another connection? */
-		exit(EXIT_FAILURE);
-	}
-
-	d->nfunctions = PQntuples(res);
+	d->nfunctions = PQntuples(res[1]);
 	if (d->nfunctions > 0)
-		d->functions = (PQLOpFunctions *) malloc(d->nfunctions * sizeof(
+		d->functions = (PQLOpFunctions *) arenaAlloc(d->nfunctions * sizeof(
 						   PQLOpFunctions));
 	else
 		d->functions = NULL;
@@ -411,17 +340,19 @@ getOpFuncAttributes(PGconn *c, Oid o, PQLOpAndFunc *d)
 
 	for (i = 0; i < d->nfunctions; i++)
 	{
-		d->functions[i].support = strtoul(PQgetvalue(res, i, PQfnumber(res,
+		d->functions[i].support = strtoul(PQgetvalue(res[1], i, PQfnumber(res[1],
 										  "amprocnum")),
 										  NULL, 10);
-		d->functions[i].funcname = strdup(PQgetvalue(res, i, PQfnumber(res, "amproc")));
+		d->functions[i].funcname = arenaStrdup(PQgetvalue(res[1], i, PQfnumber(res[1], "amproc")));
 
 		logDebug("function: \"%s\" ; support %d",
 				 d->functions[i].funcname,
 				 d->functions[i].support);
 	}
 
-	PQclear(res);
+	PQclear(res[1]);
+
+	free(res);
 }
 
 int
@@ -444,126 +375,10 @@ compareOperators(PQLOperator *a, PQLOperator *b)
 	return c;
 }
 
-void
-freeOperators(PQLOperator *o, int n)
-{
-	if (n > 0)
-	{
-		int	i;
-
-		for (i = 0; i < n; i++)
-		{
-			free(o[i].obj.schemaname);
-			free(o[i].obj.objectname);
-			free(o[i].procedure);
-			if (o[i].lefttype)
-				free(o[i].lefttype);
-			if (o[i].righttype)
-				free(o[i].righttype);
-			if (o[i].commutator)
-				free(o[i].commutator);
-			if (o[i].negator)
-				free(o[i].negator);
-			if (o[i].restriction)
-				free(o[i].restriction);
-			if (o[i].join)
-				free(o[i].join);
-			if (o[i].comment)
-				PQfreemem(o[i].comment);
-			free(o[i].owner);
-		}
-
-		free(o);
-	}
-}
-
-void
-freeOperatorClasses(PQLOperatorClass *c, int n)
-{
-	if (n > 0)
-	{
-		int	i;
-
-		for (i = 0; i < n; i++)
-		{
-			int	j;
-
-			free(c[i].obj.schemaname);
-			free(c[i].obj.objectname);
-			free(c[i].intype);
-			free(c[i].accessmethod);
-			if (c[i].family.schemaname)
-				free(c[i].family.schemaname);
-			if (c[i].family.objectname)
-				free(c[i].family.objectname);
-			if (c[i].storagetype)
-				free(c[i].storagetype);
-
-			/* operators */
-			for (j = 0; j < c[i].opandfunc.noperators; j++)
-			{
-				free(c[i].opandfunc.operators[j].oprname);
-				if (c[i].opandfunc.operators[j].sortfamily.schemaname)
-					free(c[i].opandfunc.operators[j].sortfamily.schemaname);
-				if (c[i].opandfunc.operators[j].sortfamily.objectname)
-					free(c[i].opandfunc.operators[j].sortfamily.objectname);
-			}
-
-			/* functions */
-			for (j = 0; j < c[i].opandfunc.nfunctions; j++)
-				free(c[i].opandfunc.functions[j].funcname);
-
-			if (c[i].comment)
-				PQfreemem(c[i].comment);
-			free(c[i].owner);
-		}
-
-		free(c);
-	}
-}
-
-void
-freeOperatorFamilies(PQLOperatorFamily *f, int n)
-{
-	if (n > 0)
-	{
-		int	i;
-
-		for (i = 0; i < n; i++)
-		{
-			int	j;
-
-			free(f[i].obj.schemaname);
-			free(f[i].obj.objectname);
-			free(f[i].accessmethod);
-
-			/* operators */
-			for (j = 0; j < f[i].opandfunc.noperators; j++)
-			{
-				free(f[i].opandfunc.operators[j].oprname);
-				if (f[i].opandfunc.operators[j].sortfamily.schemaname)
-					free(f[i].opandfunc.operators[j].sortfamily.schemaname);
-				if (f[i].opandfunc.operators[j].sortfamily.objectname)
-					free(f[i].opandfunc.operators[j].sortfamily.objectname);
-			}
-
-			/* functions */
-			for (j = 0; j < f[i].opandfunc.nfunctions; j++)
-				free(f[i].opandfunc.functions[j].funcname);
-
-			if (f[i].comment)
-				PQfreemem(f[i].comment);
-			free(f[i].owner);
-		}
-
-		free(f);
-	}
-}
-
 void
 dumpDropOperator(FILE *output, PQLOperator *o)
 {
-	char	*schema = formatObjectIdentifier(o->obj.schemaname);
+	char	*schema = quotedName(o->obj.schemaname);
 	char	*oprname = o->obj.objectname;
 
 	fprintf(output, "\n\n");
@@ -571,42 +386,34 @@ dumpDropOperator(FILE *output, PQLOperator *o)
 			schema, oprname,
 			(o->lefttype) ? o->lefttype : "NONE",
 			(o->righttype) ? o->righttype : "NONE");
-
-	free(schema);
 }
 
 void
 dumpDropOperatorClass(FILE *output, PQLOperatorClass *c)
 {
-	char	*schema = formatObjectIdentifier(c->obj.schemaname);
-	char	*opcname = formatObjectIdentifier(c->obj.objectname);
+	char	*schema = quotedName(c->obj.schemaname);
+	char	*opcname = quotedName(c->obj.objectname);
 
 	fprintf(output, "\n\n");
 	fprintf(output, "DROP OPERATOR CLASS %s.%s USING %s;", schema, opcname,
 			c->accessmethod);
-
-	free(schema);
-	free(opcname);
 }
 
 void
 dumpDropOperatorFamily(FILE *output, PQLOperatorFamily *f)
 {
-	char	*schema = formatObjectIdentifier(f->obj.schemaname);
-	char	*opfname = formatObjectIdentifier(f->obj.objectname);
+	char	*schema = quotedName(f->obj.schemaname);
+	char	*opfname = quotedName(f->obj.objectname);
 
 	fprintf(output, "\n\n");
 	fprintf(output, "DROP OPERATOR FAMILY %s.%s USING %s;", schema, opfname,
 			f->accessmethod);
-
-	free(schema);
-	free(opfname);
 }
 
 void
 dumpCreateOperator(FILE *output, PQLOperator *o)
 {
-	char	*schema = formatObjectIdentifier(o->obj.schemaname);
+	char	*schema = quotedName(o->obj.schemaname);
 	char	*oprname = o->obj.objectname;
 
 	fprintf(output, "\n\n");
@@ -636,18 +443,19 @@ dumpCreateOperator(FILE *output, PQLOperator *o)
 		if (o->comment != NULL)
 		{
 			fprintf(output, "\n\n");
-			fprintf(output, "COMMENT ON OPERATOR %s.%s(%s,%s) IS %s;",
+			fprintf(output, "COMMENT ON OPERATOR %s.%s(%s,%s) IS ",
 					schema, oprname,
 					(o->lefttype) ? o->lefttype : "NONE",
-					(o->righttype) ? o->righttype : "NONE",
-					o->comment);
+					(o->righttype) ? o->righttype : "NONE");
+			printComment(output, o->comment);
+			fprintf(output, ";");
 		}
 	}
 
 	/* owner */
 	if (options.owner)
 	{
-		char	*owner = formatObjectIdentifier(o->owner);
+		char	*owner = quotedName(o->owner);
 
 		fprintf(output, "\n\n");
 		fprintf(output, "ALTER OPERATOR %s.%s(%s,%s) OWNER TO %s;",
@@ -655,18 +463,15 @@ dumpCreateOperator(FILE *output, PQLOperator *o)
 				(o->lefttype) ? o->lefttype : "NONE",
 				(o->righttype) ? o->righttype : "NONE",
 				owner);
-
-		free(owner);
 	}
 
-	free(schema);
 }
 
 void
 dumpCreateOperatorClass(FILE *output, PQLOperatorClass *c)
 {
-	char	*schema = formatObjectIdentifier(c->obj.schemaname);
-	char	*opcname = formatObjectIdentifier(c->obj.objectname);
+	char	*schema = quotedName(c->obj.schemaname);
+	char	*opcname = quotedName(c->obj.objectname);
 	char	*fschema = NULL;
 	char	*opfname = NULL;
 	bool	comma = false;
@@ -736,29 +541,26 @@ dumpCreateOperatorClass(FILE *output, PQLOperatorClass *c)
 		if (c->comment != NULL)
 		{
 			fprintf(output, "\n\n");
-			fprintf(output, "COMMENT ON OPERATOR CLASS %s.%s USING %s IS %s;",
+			fprintf(output, "COMMENT ON OPERATOR CLASS %s.%s USING %s IS ",
 					schema, opcname,
-					c->accessmethod,
-					c->comment);
+					c->accessmethod);
+			printComment(output, c->comment);
+			fprintf(output, ";");
 		}
 	}
 
 	/* owner */
 	if (options.owner)
 	{
-		char	*owner = formatObjectIdentifier(c->owner);
+		char	*owner = quotedName(c->owner);
 
 		fprintf(output, "\n\n");
 		fprintf(output, "ALTER OPERATOR CLASS %s.%s USING %s OWNER TO %s;",
 				schema, opcname,
 				c->accessmethod,
 				owner);
-
-		free(owner);
 	}
 
-	free(schema);
-	free(opcname);
 	if (fschema)
 		free(fschema);
 	if (opfname)
@@ -768,8 +570,8 @@ dumpCreateOperatorClass(FILE *output, PQLOperatorClass *c)
 void
 dumpCreateOperatorFamily(FILE *output, PQLOperatorFamily *f)
 {
-	char	*schema = formatObjectIdentifier(f->obj.schemaname);
-	char	*opfname = formatObjectIdentifier(f->obj.objectname);
+	char	*schema = quotedName(f->obj.schemaname);
+	char	*opfname = quotedName(f->obj.objectname);
 
 	fprintf(output, "\n\n");
 	fprintf(output, "CREATE OPERATOR FAMILY %s.%s USING %s;", schema, opfname,
@@ -781,35 +583,32 @@ dumpCreateOperatorFamily(FILE *output, PQLOperatorFamily *f)
 		if (f->comment != NULL)
 		{
 			fprintf(output, "\n\n");
-			fprintf(output, "COMMENT ON OPERATOR FAMILY %s.%s USING %s IS %s;",
+			fprintf(output, "COMMENT ON OPERATOR FAMILY %s.%s USING %s IS ",
 					schema, opfname,
-					f->accessmethod,
-					f->comment);
+					f->accessmethod);
+			printComment(output, f->comment);
+			fprintf(output, ";");
 		}
 	}
 
 	/* owner */
 	if (options.owner)
 	{
-		char	*owner = formatObjectIdentifier(f->owner);
+		char	*owner = quotedName(f->owner);
 
 		fprintf(output, "\n\n");
 		fprintf(output, "ALTER OPERATOR FAMILY %s.%s USING %s OWNER TO %s;",
 				schema, opfname,
 				f->accessmethod,
 				owner);
-
-		free(owner);
 	}
 
-	free(schema);
-	free(opfname);
 }
 
 void
 dumpAlterOperator(FILE *output, PQLOperator *a, PQLOperator *b)
 {
-	char	*schema2 = formatObjectIdentifier(b->obj.schemaname);
+	char	*schema2 = quotedName(b->obj.schemaname);
 	char	*oprname2 = b->obj.objectname;
 	char	*r = NULL;
 	char	*j = NULL;
@@ -883,7 +682,7 @@ dumpAlterOperator(FILE *output, PQLOperator *a, PQLOperator *b)
 	{
 		if (strcmp(a->owner, b->owner) != 0)
 		{
-			char	*owner = formatObjectIdentifier(b->owner);
+			char	*owner = quotedName(b->owner);
 
 			fprintf(output, "\n\n");
 			fprintf(output, "ALTER OPERATOR %s.%s(%s,%s) OWNER TO %s;",
@@ -892,19 +691,15 @@ dumpAlterOperator(FILE *output, PQLOperator *a, PQLOperator *b)
 					(b->lefttype) ? b->lefttype : "NONE",
 					(b->righttype) ? b->righttype : "NONE",
 					owner);
-
-			free(owner);
 		}
 	}
-
-	free(schema2);
 }
 
 static void
 dumpAddOperatorOpFamily(FILE *output, PQLOperatorFamily *f, int i)
 {
-	char	*schema = formatObjectIdentifier(f->obj.schemaname);
-	char	*opfname = formatObjectIdentifier(f->obj.objectname);
+	char	*schema = quotedName(f->obj.schemaname);
+	char	*opfname = quotedName(f->obj.objectname);
 	char	*tmps = NULL;
 	char	*tmpo = NULL;
 
@@ -925,64 +720,50 @@ dumpAddOperatorOpFamily(FILE *output, PQLOperatorFamily *f, int i)
 		free(tmps);
 	if (tmpo)
 		free(tmpo);
-
-	free(schema);
-	free(opfname);
 }
 
 static void
 dumpRemoveOperatorOpFamily(FILE *output, PQLOperatorFamily *f, int i)
 {
-	char	*schema = formatObjectIdentifier(f->obj.schemaname);
-	char	*opfname = formatObjectIdentifier(f->obj.objectname);
+	char	*schema = quotedName(f->obj.schemaname);
+	char	*opfname = quotedName(f->obj.objectname);
 
 	fprintf(output, "\n\n");
 	fprintf(output, "ALTER OPERATOR FAMILY %s.%s USING %s DROP OPERATOR %d;",
 			schema, opfname, f->accessmethod,
 			f->opandfunc.operators[i].strategy);
-
-	free(schema);
-	free(opfname);
 }
 
 static void
 dumpAddFunctionOpFamily(FILE *output, PQLOperatorFamily *f, int i)
 {
-	char	*schema = formatObjectIdentifier(f->obj.schemaname);
-	char	*opfname = formatObjectIdentifier(f->obj.objectname);
+	char	*schema = quotedName(f->obj.schemaname);
+	char	*opfname = quotedName(f->obj.objectname);
 
 	fprintf(output, "\n\n");
 	fprintf(output, "ALTER OPERATOR FAMILY %s.%s USING %s ADD FUNCTION %d %s;",
 			schema, opfname, f->accessmethod,
 			f->opandfunc.functions[i].support,
 			f->opandfunc.functions[i].funcname);
-
-	free(schema);
-	free(opfname);
 }
 
 static void
 dumpRemoveFunctionOpFamily(FILE *output, PQLOperatorFamily *f, int i)
 {
-	char	*schema = formatObjectIdentifier(f->obj.schemaname);
-	char	*opfname = formatObjectIdentifier(f->obj.objectname);
+	char	*schema = quotedName(f->obj.schemaname);
+	char	*opfname = quotedName(f->obj.objectname);
 
 	fprintf(output, "\n\n");
 	fprintf(output, "ALTER OPERATOR FAMILY %s.%s USING %s DROP FUNCTION %d;",
 			schema, opfname, f->accessmethod,
 			f->opandfunc.functions[i].support);
-
-	free(schema);
-	free(opfname);
 }
 
 void
 dumpAlterOperatorClass(FILE *output, PQLOperatorClass *a, PQLOperatorClass *b)
 {
-	char	*schema1 = formatObjectIdentifier(a->obj.schemaname);
-	char	*opcname1 = formatObjectIdentifier(a->obj.objectname);
-	char	*schema2 = formatObjectIdentifier(b->obj.schemaname);
-	char	*opcname2 = formatObjectIdentifier(b->obj.objectname);
+	char	*schema2 = quotedName(b->obj.schemaname);
+	char	*opcname2 = quotedName(b->obj.objectname);
 
 	/* comment */
 	if (options.comment)
@@ -1013,7 +794,7 @@ dumpAlterOperatorClass(FILE *output, PQLOperatorClass *a, PQLOperatorClass *b)
 	{
 		if (strcmp(a->owner, b->owner) != 0)
 		{
-			char	*owner = formatObjectIdentifier(b->owner);
+			char	*owner = quotedName(b->owner);
 
 			fprintf(output, "\n\n");
 			fprintf(output, "ALTER OPERATOR CLASS %s.%s USING %s OWNER TO %s;",
@@ -1021,25 +802,16 @@ dumpAlterOperatorClass(FILE *output, PQLOperatorClass *a, PQLOperatorClass *b)
 					opcname2,
 					b->accessmethod,
 					owner);
-
-			free(owner);
 		}
 	}
-
-	free(schema1);
-	free(opcname1);
-	free(schema2);
-	free(opcname2);
 }
 
 void
 dumpAlterOperatorFamily(FILE *output, PQLOperatorFamily *a,
 						PQLOperatorFamily *b)
 {
-	char	*schema1 = formatObjectIdentifier(a->obj.schemaname);
-	char	*opfname1 = formatObjectIdentifier(a->obj.objectname);
-	char	*schema2 = formatObjectIdentifier(b->obj.schemaname);
-	char	*opfname2 = formatObjectIdentifier(b->obj.objectname);
+	char	*schema2 = quotedName(b->obj.schemaname);
+	char	*opfname2 = quotedName(b->obj.objectname);
 
 	int		i, j;
 
@@ -1171,7 +943,7 @@ dumpAlterOperatorFamily(FILE *output, PQLOperatorFamily *a,
 	{
 		if (strcmp(a->owner, b->owner) != 0)
 		{
-			char	*owner = formatObjectIdentifier(b->owner);
+			char	*owner = quotedName(b->owner);
 
 			fprintf(output, "\n\n");
 			fprintf(output, "ALTER OPERATOR CLASS %s.%s USING %s OWNER TO %s;",
@@ -1179,13 +951,6 @@ dumpAlterOperatorFamily(FILE *output, PQLOperatorFamily *a,
 					opfname2,
 					b->accessmethod,
 					owner);
-
-			free(owner);
 		}
 	}
-
-	free(schema1);
-	free(opfname1);
-	free(schema2);
-	free(opfname2);
 }
@@ -9,6 +9,7 @@
 #ifndef OPERATOR_H
 #define	OPERATOR_H
 
+#include "comment.h"
 #include "common.h"
 
 typedef struct PQLOpOperators
@@ -95,8 +96,5 @@ void dumpAlterOperatorClass(FILE *output, PQLOperatorClass *a,
 void dumpAlterOperatorFamily(FILE *output, PQLOperatorFamily *a,
 							 PQLOperatorFamily *b);
 
-void freeOperators(PQLOperator *o, int n);
-void freeOperatorClasses(PQLOperatorClass *c, int n);
-void freeOperatorFamilies(PQLOperatorFamily *f, int n);
 
 #endif	/* OPERATOR_H */
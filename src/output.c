@@ -0,0 +1,696 @@
+/*----------------------------------------------------------------------
+ *
+ * pgquarrel -- comparing database schemas
+ *
+ * output.c
+ *     Buffers that hold commands until they are written into the output
+ *
+ * Commands stay in memory while a buffer is smaller than output-buffer-size
+ * and the final merge is a single writev (one vector per run of segments that
+ * are still in the order they were written). Larger buffers are moved into a
+ * temporary file that is copied with sendfile where available. Platforms
+ * without fopencookie or funopen use a temporary file from the start.
+ *
+ * Sorted buffers can also be written as waves (see writeOutputWaves): one
+ * file per segment and a manifest that says which files can run at the same
+ * time.
+ *
+ * Copyright (c) 2015-2020, Euler Taveira
+ *
+ * ---------------------------------------------------------------------
+ */
+#if defined(__linux__) && !defined(_GNU_SOURCE)
+#define	_GNU_SOURCE				/* fopencookie */
+#endif
+
+#include "output.h"
+
+#include <errno.h>
+#include <sys/stat.h>
+#if defined(_WINDOWS)
+#include <direct.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/uio.h>
+#endif
+#if defined(__linux__)
+#include <sys/sendfile.h>
+#endif
+
+#if defined(__GLIBC__) || defined(__APPLE__) || defined(__FreeBSD__) || \
+	defined(__NetBSD__) || defined(__OpenBSD__) || defined(__DragonFly__)
+#define	PGQ_MEMORY_STREAM
+#endif
+
+/* size of the first memory block of a buffer */
+#define	PGQ_OUTPUT_BLOCK_SIZE	8192
+
+/* vectors per writev; IOV_MAX is at least 1024 on Linux and the BSDs */
+#define	PGQ_OUTPUT_MAX_IOV		1024
+
+/* segment file of writeOutputWaves */
+typedef struct PQLWaveFile
+{
+	int					wave;
+	int					seq;		/* sorted order */
+	PQLOutputBuffer		*buffer;
+	PQLOutputSegment	*segment;
+} PQLWaveFile;
+
+#ifdef PGQ_MEMORY_STREAM
+static void writeAll(int fd, const char *buf, size_t len, const char *path);
+static void writevAll(int fd, struct iovec *iov, int cnt);
+static void spillOutputBuffer(PQLOutputBuffer *b);
+static void appendToBuffer(PQLOutputBuffer *b, const char *buf, size_t len);
+static void copyToDescriptor(PQLOutputBuffer *b, size_t off, size_t len,
+							 int fd);
+#if defined(__GLIBC__)
+static ssize_t streamWrite(void *cookie, const char *buf, size_t len);
+#else
+static int streamWrite(void *cookie, const char *buf, int len);
+#endif
+#endif
+static void copySegment(PQLOutputBuffer *b, PQLOutputSegment *s, FILE *out);
+static int compareWaveFiles(const void *a, const void *b);
+
+#ifdef PGQ_MEMORY_STREAM
+/*
+ * Write len bytes into fd. A short write is not an error.
+ */
+static void
+writeAll(int fd, const char *buf, size_t len, const char *path)
+{
+	while (len > 0)
+	{
+		ssize_t		n;
+
+		n = write(fd, buf, len);
+		if (n < 0)
+		{
+			if (errno == EINTR)
+				continue;
+			logError("could not write to \"%s\": %s", path, strerror(errno));
+			exit(EXIT_FAILURE);
+		}
+
+		buf += n;
+		len -= n;
+	}
+}
+
+static void
+writevAll(int fd, struct iovec *iov, int cnt)
+{
+	while (cnt > 0)
+	{
+		ssize_t		n;
+
+		n = writev(fd, iov, cnt);
+		if (n < 0)
+		{
+			if (errno == EINTR)
+				continue;
+			logError("could not write to output file: %s", strerror(errno));
+			exit(EXIT_FAILURE);
+		}
+
+		/* skip what was written */
+		while (cnt > 0 && (size_t) n >= iov->iov_len)
+		{
+			n -= iov->iov_len;
+			iov++;
+			cnt--;
+		}
+		if (cnt > 0)
+		{
+			iov->iov_base = (char *) iov->iov_base + n;
+			iov->iov_len -= n;
+		}
+	}
+}
+
+/*
+ * Move the buffer contents into its temporary file. Nobody else opens that
+ * file; remove it right away so it does not outlive pgquarrel.
+ */
+static void
+spillOutputBuffer(PQLOutputBuffer *b)
+{
+	b->fd = open(b->path, O_RDWR | O_CREAT | O_TRUNC, 0600);
+	if (b->fd < 0)
+	{
+		logError("could not open temporary file \"%s\": %s", b->path,
+				 strerror(errno));
+		exit(EXIT_FAILURE);
+	}
+
+	if (unlink(b->path))
+	{
+		logError("could not remove temporary file \"%s\": %s", b->path,
+				 strerror(errno));
+		exit(EXIT_FAILURE);
+	}
+
+	logDebug("%s: %zu bytes moved to temporary file", b->path, b->len);
+
+	writeAll(b->fd, b->data, b->len, b->path);
+
+	free(b->data);
+	b->data = NULL;
+	b->len = b->size = 0;
+}
+
+static void
+appendToBuffer(PQLOutputBuffer *b, const char *buf, size_t len)
+{
+	if (b->fd < 0 && b->len + len > (size_t) options.outputbuffersize * 1024)
+		spillOutputBuffer(b);
+
+	b->total += len;
+
+	if (b->fd >= 0)
+	{
+		writeAll(b->fd, buf, len, b->path);
+		return;
+	}
+
+	if (b->len + len > b->size)
+	{
+		size_t	newsize = (b->size > 0) ? b->size : PGQ_OUTPUT_BLOCK_SIZE;
+
+		while (newsize < b->len + len)
+			newsize *= 2;
+
+		b->data = (char *) realloc(b->data, newsize);
+		if (b->data == NULL)
+		{
+			logError("could not allocate memory for output buffer");
+			exit(EXIT_FAILURE);
+		}
+		b->size = newsize;
+	}
+
+	memcpy(b->data + b->len, buf, len);
+	b->len += len;
+}
+
+#if defined(__GLIBC__)
+static ssize_t
+streamWrite(void *cookie, const char *buf, size_t len)
+{
+	appendToBuffer((PQLOutputBuffer *) cookie, buf, len);
+
+	return len;
+}
+#else
+static int
+streamWrite(void *cookie, const char *buf, int len)
+{
+	appendToBuffer((PQLOutputBuffer *) cookie, buf, len);
+
+	return len;
+}
+#endif
+
+/*
+ * Write len bytes of the temporary file, starting at off, into fd. The kernel
+ * copies them if it can; otherwise, they are read in chunks.
+ */
+static void
+copyToDescriptor(PQLOutputBuffer *b, size_t off, size_t len, int fd)
+{
+	char	buf[65536];
+	off_t	pos = off;
+	off_t	end = off + len;
+
+#if defined(__linux__)
+	while (pos < end)
+	{
+		ssize_t		n;
+
+		n = sendfile(fd, b->fd, &pos, end - pos);
+		if (n < 0)
+		{
+			if (errno == EINTR)
+				continue;
+			/* output does not support it (e.g. append mode); copy the rest */
+			if (errno == EINVAL || errno == ENOSYS)
+				break;
+			logError("could not copy temporary file \"%s\": %s", b->path,
+					 strerror(errno));
+			exit(EXIT_FAILURE);
+		}
+		if (n == 0)
+			break;
+	}
+#endif
+
+	while (pos < end)
+	{
+		ssize_t		n;
+
+		n = pread(b->fd, buf, Min(sizeof(buf), (size_t) (end - pos)), pos);
+		if (n < 0)
+		{
+			if (errno == EINTR)
+				continue;
+			logError("could not read temporary file \"%s\": %s", b->path,
+					 strerror(errno));
+			exit(EXIT_FAILURE);
+		}
+		if (n == 0)
+			break;
+
+		writeAll(fd, buf, n, "output file");
+		pos += n;
+	}
+}
+#endif	/* PGQ_MEMORY_STREAM */
+
+/*
+ * Append the commands of segment s to out.
+ */
+static void
+copySegment(PQLOutputBuffer *b, PQLOutputSegment *s, FILE *out)
+{
+	char	buf[65536];
+	size_t	off = s->offset;
+	size_t	end = s->offset + s->len;
+
+#ifdef PGQ_MEMORY_STREAM
+	if (b->fd < 0)
+	{
+		if (s->len > 0 && fwrite(b->data + s->offset, 1, s->len, out) != s->len)
+		{
+			logError("could not write output buffer: %s", strerror(errno));
+			exit(EXIT_FAILURE);
+		}
+		return;
+	}
+#else
+	if (fseek(b->fp, off, SEEK_SET) != 0)
+	{
+		logError("could not seek temporary file \"%s\": %s", b->path,
+				 strerror(errno));
+		exit(EXIT_FAILURE);
+	}
+#endif
+
+	while (off < end)
+	{
+		size_t	n = Min(sizeof(buf), end - off);
+
+#ifdef PGQ_MEMORY_STREAM
+		ssize_t	r = pread(b->fd, buf, n, off);
+
+		if (r < 0 && errno == EINTR)
+			continue;
+		if (r <= 0)
+		{
+			logError("could not read temporary file \"%s\": %s", b->path,
+					 (r < 0) ? strerror(errno) : "unexpected end of file");
+			exit(EXIT_FAILURE);
+		}
+		n = r;
+#else
+		if (fread(buf, 1, n, b->fp) != n)
+		{
+			logError("error while reading temporary file \"%s\": %s", b->path,
+					 strerror(errno));
+			exit(EXIT_FAILURE);
+		}
+#endif
+
+		if (fwrite(buf, 1, n, out) != n)
+		{
+			logError("could not write output buffer: %s", strerror(errno));
+			exit(EXIT_FAILURE);
+		}
+		off += n;
+	}
+}
+
+/*
+ * Prepare an empty buffer. path is the temporary file used when the buffer
+ * does not fit in memory.
+ */
+void
+openOutputBuffer(PQLOutputBuffer *b, const char *path)
+{
+	memset(b, 0, sizeof(PQLOutputBuffer));
+	strncpy(b->path, path, PGQMAXPATH - 1);
+	b->fd = -1;
+
+	/* commands that are not printed after a markOutputBuffer */
+	b->maxsegments = 64;
+	b->segments = (PQLOutputSegment *) calloc(b->maxsegments,
+											  sizeof(PQLOutputSegment));
+	if (b->segments == NULL)
+	{
+		logError("could not allocate memory for output buffer");
+		exit(EXIT_FAILURE);
+	}
+	b->nsegments = 1;
+
+#ifdef PGQ_MEMORY_STREAM
+#if defined(__GLIBC__)
+	{
+		cookie_io_functions_t	funcs = {NULL, streamWrite, NULL, NULL};
+
+		b->fp = fopencookie(b, "w", funcs);
+	}
+#else
+	b->fp = funopen(b, NULL, streamWrite, NULL, NULL);
+#endif
+	if (b->fp == NULL)
+	{
+		logError("could not open output buffer: %s", strerror(errno));
+		exit(EXIT_FAILURE);
+	}
+#else
+	b->fp = fopen(b->path, "w+");
+	if (b->fp == NULL)
+	{
+		logError("could not open temporary file \"%s\": %s", b->path,
+				 strerror(errno));
+		exit(EXIT_FAILURE);
+	}
+#endif
+}
+
+void
+closeOutputBuffer(PQLOutputBuffer *b)
+{
+	fclose(b->fp);
+	b->fp = NULL;
+
+	free(b->segments);
+	b->segments = NULL;
+	b->nsegments = 0;
+
+#ifdef PGQ_MEMORY_STREAM
+	if (b->data)
+		free(b->data);
+	if (b->fd >= 0)
+		close(b->fd);
+	b->data = NULL;
+	b->fd = -1;
+#else
+	if (unlink(b->path))
+	{
+		logError("could not remove temporary file \"%s\": %s", b->path,
+				 strerror(errno));
+		exit(EXIT_FAILURE);
+	}
+#endif
+}
+
+/*
+ * Make everything that was printed into the buffer part of it and close the
+ * last segment. Returns the buffer size.
+ */
+size_t
+flushOutputBuffer(PQLOutputBuffer *b)
+{
+	PQLOutputSegment	*last = &b->segments[b->nsegments - 1];
+	size_t				size;
+
+	fflush(b->fp);
+
+#ifdef PGQ_MEMORY_STREAM
+	size = b->total;
+#else
+	/* copySegment moves the file position */
+	fseek(b->fp, 0, SEEK_END);
+	size = ftell(b->fp);
+#endif
+
+	last->len = size - last->offset;
+
+	return size;
+}
+
+/*
+ * Commands printed from now on belong to object objid (of catalog classid) of
+ * that server. An empty segment is reused.
+ */
+void
+markOutputBuffer(PQLOutputBuffer *b, int server, Oid classid, Oid objid)
+{
+	PQLOutputSegment	*s;
+	size_t				size;
+
+	size = flushOutputBuffer(b);
+
+	s = &b->segments[b->nsegments - 1];
+	if (s->len > 0)
+	{
+		if (b->nsegments == b->maxsegments)
+		{
+			b->maxsegments *= 2;
+			b->segments = (PQLOutputSegment *) realloc(b->segments,
+						  b->maxsegments * sizeof(PQLOutputSegment));
+			if (b->segments == NULL)
+			{
+				logError("could not allocate memory for output buffer");
+				exit(EXIT_FAILURE);
+			}
+		}
+		s = &b->segments[b->nsegments++];
+	}
+
+	s->offset = size;
+	s->len = 0;
+	s->classid = classid;
+	s->objid = objid;
+	s->server = server;
+	s->wave = 0;
+}
+
+bool
+isEmptyOutputBuffer(PQLOutputBuffer *b)
+{
+	return (flushOutputBuffer(b) == 0);
+}
+
+/*
+ * Append the segments of b to out, in order.
+ */
+void
+appendOutputBuffer(PQLOutputBuffer *b, PQLOutputBuffer *out)
+{
+	int		i;
+
+	flushOutputBuffer(b);
+
+	for (i = 0; i < b->nsegments; i++)
+	{
+		PQLOutputSegment	*s = &b->segments[i];
+
+		if (s->len == 0)
+			continue;
+
+		markOutputBuffer(out, s->server, s->classid, s->objid);
+		copySegment(b, s, out->fp);
+	}
+}
+
+/*
+ * Write the segments of pre and then those of post into out. Anything that
+ * was printed into out before is flushed first.
+ */
+void
+writeOutputBuffers(PQLOutputBuffer *pre, PQLOutputBuffer *post, FILE *out)
+{
+	PQLOutputBuffer	*bufs[2];
+	int				i, j;
+#ifdef PGQ_MEMORY_STREAM
+	struct iovec	iov[PGQ_OUTPUT_MAX_IOV];
+	int				n = 0;
+	int				fd;
+#endif
+
+	bufs[0] = pre;
+	bufs[1] = post;
+	flushOutputBuffer(pre);
+	flushOutputBuffer(post);
+
+#ifdef PGQ_MEMORY_STREAM
+	if (fflush(out) != 0)
+	{
+		logError("could not write to output file: %s", strerror(errno));
+		exit(EXIT_FAILURE);
+	}
+	fd = fileno(out);
+
+	for (i = 0; i < 2; i++)
+	{
+		PQLOutputBuffer	*b = bufs[i];
+
+		for (j = 0; j < b->nsegments; j++)
+		{
+			PQLOutputSegment	*s = &b->segments[j];
+
+			if (s->len == 0)
+				continue;
+
+			if (b->fd >= 0)
+			{
+				writevAll(fd, iov, n);
+				n = 0;
+				copyToDescriptor(b, s->offset, s->len, fd);
+			}
+			/* segments that are still in order are written as one vector */
+			else if (n > 0 && (char *) iov[n - 1].iov_base + iov[n - 1].iov_len ==
+					 b->data + s->offset)
+				iov[n - 1].iov_len += s->len;
+			else
+			{
+				if (n == PGQ_OUTPUT_MAX_IOV)
+				{
+					writevAll(fd, iov, n);
+					n = 0;
+				}
+				iov[n].iov_base = b->data + s->offset;
+				iov[n].iov_len = s->len;
+				n++;
+			}
+		}
+	}
+
+	writevAll(fd, iov, n);
+#else
+	for (i = 0; i < 2; i++)
+		for (j = 0; j < bufs[i]->nsegments; j++)
+			copySegment(bufs[i], &bufs[i]->segments[j], out);
+#endif
+}
+
+/*
+ * Create directory dir unless it exists.
+ */
+void
+createOutputDirectory(const char *dir)
+{
+#if defined(_WINDOWS)
+	if (_mkdir(dir) != 0 && errno != EEXIST)
+#else
+	if (mkdir(dir, 0700) != 0 && errno != EEXIST)
+#endif
+	{
+		logError("could not create directory \"%s\": %s", dir, strerror(errno));
+		exit(EXIT_FAILURE);
+	}
+}
+
+static int
+compareWaveFiles(const void *a, const void *b)
+{
+	const PQLWaveFile	*x = (const PQLWaveFile *) a;
+	const PQLWaveFile	*y = (const PQLWaveFile *) b;
+
+	if (x->wave != y->wave)
+		return x->wave - y->wave;
+
+	return x->seq - y->seq;
+}
+
+/*
+ * Write each segment of pre and post into its own file in directory dir.
+ * Waves are numbered from 1; pre has npre waves and the waves of post follow
+ * them. Segments of the same wave do not depend on each other. The manifest
+ * lists one file per line (wave, tab, file name) ordered by wave.
+ */
+void
+writeOutputWaves(PQLOutputBuffer *pre, int npre, PQLOutputBuffer *post,
+				 const char *dir)
+{
+	PQLOutputBuffer	*bufs[2];
+	int				base[2];
+	PQLWaveFile		*files;
+	int				nfiles = 0;
+	FILE			*manifest;
+	char			path[PGQMAXPATH];
+	int				i, j;
+
+	bufs[0] = pre;
+	bufs[1] = post;
+	base[0] = 1;
+	base[1] = npre + 1;
+	flushOutputBuffer(pre);
+	flushOutputBuffer(post);
+
+	createOutputDirectory(dir);
+
+	files = (PQLWaveFile *) malloc((pre->nsegments + post->nsegments) *
+								   sizeof(PQLWaveFile));
+	if (files == NULL)
+	{
+		logError("could not allocate memory for output buffer");
+		exit(EXIT_FAILURE);
+	}
+
+	for (i = 0; i < 2; i++)
+	{
+		for (j = 0; j < bufs[i]->nsegments; j++)
+		{
+			if (bufs[i]->segments[j].len == 0)
+				continue;
+
+			files[nfiles].wave = base[i] + bufs[i]->segments[j].wave;
+			files[nfiles].seq = nfiles;
+			files[nfiles].buffer = bufs[i];
+			files[nfiles].segment = &bufs[i]->segments[j];
+			nfiles++;
+		}
+	}
+
+	qsort(files, nfiles, sizeof(PQLWaveFile), compareWaveFiles);
+
+	snprintf(path, PGQMAXPATH, "%s/manifest", dir);
+	manifest = fopen(path, "w");
+	if (manifest == NULL)
+	{
+		logError("could not open output file \"%s\": %s", path, strerror(errno));
+		exit(EXIT_FAILURE);
+	}
+
+	for (i = 0; i < nfiles; i++)
+	{
+		FILE	*fp;
+
+		snprintf(path, PGQMAXPATH, "%s/%04d.%06d.sql", dir, files[i].wave, i + 1);
+		fp = fopen(path, "w");
+		if (fp == NULL)
+		{
+			logError("could not open output file \"%s\": %s", path,
+					 strerror(errno));
+			exit(EXIT_FAILURE);
+		}
+
+		copySegment(files[i].buffer, files[i].segment, fp);
+		fprintf(fp, "\n");
+
+		if (fclose(fp) != 0)
+		{
+			logError("could not close output file \"%s\": %s", path,
+					 strerror(errno));
+			exit(EXIT_FAILURE);
+		}
+
+		fprintf(manifest, "%d\t%04d.%06d.sql\n", files[i].wave, files[i].wave,
+				i + 1);
+	}
+
+	if (fclose(manifest) != 0)
+	{
+		logError("could not close output file \"%s/manifest\": %s", dir,
+				 strerror(errno));
+		exit(EXIT_FAILURE);
+	}
+
+	logDebug("%d files written into \"%s\"", nfiles, dir);
+
+	free(files);
+}
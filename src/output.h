@@ -0,0 +1,64 @@
+/*----------------------------------------------------------------------
+ *
+ * pgquarrel -- comparing database schemas
+ *
+ * Copyright (c) 2015-2020, Euler Taveira
+ *
+ * ---------------------------------------------------------------------
+ */
+#ifndef OUTPUT_H
+#define OUTPUT_H
+
+#include "common.h"
+
+/*
+ * Commands of one object. The dump routines do not know which object they
+ * are printing; markOutputBuffer starts a new segment before each object.
+ * Segments are written in array order (see sortOutputBuffer).
+ */
+typedef struct PQLOutputSegment
+{
+	size_t	offset;
+	size_t	len;
+	Oid		classid;	/* catalog of objid or InvalidOid */
+	Oid		objid;
+	int		server;		/* objid belongs to server 1 or 2 */
+	int		wave;		/* see sortOutputBuffer */
+} PQLOutputSegment;
+
+/*
+ * Commands are written into two buffers (pre and post) until the end of the
+ * comparison; then both are written, in that order, into the output file.
+ * The dump routines write into fp, a stream that appends to data. A buffer
+ * that grows larger than output-buffer-size is moved into a temporary file
+ * (fd) and subsequent commands are appended to that file. Platforms without
+ * custom streams (see output.c) always use the temporary file.
+ */
+typedef struct PQLOutputBuffer
+{
+	FILE	*fp;				/* stream used by the dump routines */
+	char	path[PGQMAXPATH];	/* temporary file */
+	char	*data;				/* contents while in memory */
+	size_t	len;
+	size_t	size;
+	size_t	total;				/* bytes written into this buffer */
+	int		fd;					/* temporary file after spilling or -1 */
+
+	PQLOutputSegment	*segments;
+	int					nsegments;
+	int					maxsegments;
+} PQLOutputBuffer;
+
+void openOutputBuffer(PQLOutputBuffer *b, const char *path);
+void closeOutputBuffer(PQLOutputBuffer *b);
+size_t flushOutputBuffer(PQLOutputBuffer *b);
+void markOutputBuffer(PQLOutputBuffer *b, int server, Oid classid, Oid objid);
+bool isEmptyOutputBuffer(PQLOutputBuffer *b);
+void appendOutputBuffer(PQLOutputBuffer *b, PQLOutputBuffer *out);
+void writeOutputBuffers(PQLOutputBuffer *pre, PQLOutputBuffer *post,
+						FILE *out);
+void createOutputDirectory(const char *dir);
+void writeOutputWaves(PQLOutputBuffer *pre, int npre, PQLOutputBuffer *post,
+					  const char *dir);
+
+#endif	/* OUTPUT_H */
@@ -30,11 +30,11 @@ getPolicies(PGconn *c, int *n)
 	PGresult	*res;
 	int			i;
 
-	logNoise("policy: server version: %d", PQserverVersion(c));
+	logNoise("policy: server version: %d", getServerVersion(c));
 
-	query = psprintf("SELECT p.oid, p.polname, p.polrelid, n.nspname AS polnamespace, c.relname AS poltabname, p.polcmd, p.polpermissive, CASE WHEN p.polroles = '{0}' THEN NULL ELSE pg_catalog.array_to_string(ARRAY(SELECT pg_catalog.quote_ident(rolname) from pg_catalog.pg_roles WHERE oid = ANY(p.polroles)), ', ') END AS polroles, pg_catalog.pg_get_expr(p.polqual, p.polrelid) AS polqual, pg_catalog.pg_get_expr(p.polwithcheck, p.polrelid) AS polwithcheck, d.description AS description FROM pg_policy p INNER JOIN pg_class c ON (p.polrelid = c.oid) INNER JOIN pg_namespace n ON (c.relnamespace = n.oid) LEFT JOIN pg_description d ON (p.oid = d.objoid) WHERE TRUE %s%s ORDER BY p.polname", include_schema_str, exclude_schema_str);
+	query = psprintf("SELECT p.oid, p.polname, p.polrelid, n.nspname AS polnamespace, c.relname AS poltabname, p.polcmd, p.polpermissive, CASE WHEN p.polroles = '{0}' THEN NULL ELSE pg_catalog.array_to_string(ARRAY(SELECT pg_catalog.quote_ident(rolname) from pg_catalog.pg_roles WHERE oid = ANY(p.polroles)), ', ') END AS polroles, pg_catalog.pg_get_expr(p.polqual, p.polrelid) AS polqual, pg_catalog.pg_get_expr(p.polwithcheck, p.polrelid) AS polwithcheck FROM pg_policy p INNER JOIN pg_class c ON (p.polrelid = c.oid) INNER JOIN pg_namespace n ON (c.relnamespace = n.oid) WHERE TRUE %s%s ORDER BY p.polname", include_schema_str, exclude_schema_str);
 
-	res = PQexec(c, query);
+	res = execQuery(c, query);
 
 	pfree(query);
 
@@ -49,7 +49,7 @@ getPolicies(PGconn *c, int *n)
 
 	*n = PQntuples(res);
 	if (*n > 0)
-		p = (PQLPolicy *) malloc(*n * sizeof(PQLPolicy));
+		p = (PQLPolicy *) arenaAlloc(*n * sizeof(PQLPolicy));
 	else
 		p = NULL;
 
@@ -57,15 +57,13 @@ getPolicies(PGconn *c, int *n)
 
 	for (i = 0; i < *n; i++)
 	{
-		char	*withoutescape;
-
 		p[i].oid = strtoul(PQgetvalue(res, i, PQfnumber(res, "oid")), NULL, 10);
-		p[i].polname = strdup(PQgetvalue(res, i, PQfnumber(res, "polname")));
+		p[i].polname = arenaStrdup(PQgetvalue(res, i, PQfnumber(res, "polname")));
 		p[i].table.oid = strtoul(PQgetvalue(res, i, PQfnumber(res, "polrelid")), NULL,
 								 10);
-		p[i].table.schemaname = strdup(PQgetvalue(res, i, PQfnumber(res,
+		p[i].table.schemaname = internName(PQgetvalue(res, i, PQfnumber(res,
 									   "polnamespace")));
-		p[i].table.objectname = strdup(PQgetvalue(res, i, PQfnumber(res,
+		p[i].table.objectname = internName(PQgetvalue(res, i, PQfnumber(res,
 									   "poltabname")));
 		p[i].cmd = PQgetvalue(res, i, PQfnumber(res, "polcmd"))[0];
 		p[i].permissive = (PQgetvalue(res, i, PQfnumber(res,
@@ -73,30 +71,16 @@ getPolicies(PGconn *c, int *n)
 		if (PQgetisnull(res, i, PQfnumber(res, "polroles")))
 			p[i].roles = NULL;
 		else
-			p[i].roles = strdup(PQgetvalue(res, i, PQfnumber(res, "polroles")));
+			p[i].roles = arenaStrdup(PQgetvalue(res, i, PQfnumber(res, "polroles")));
 		if (PQgetisnull(res, i, PQfnumber(res, "polqual")))
 			p[i].qual = NULL;
 		else
-			p[i].qual = strdup(PQgetvalue(res, i, PQfnumber(res, "polqual")));
+			p[i].qual = arenaStrdup(PQgetvalue(res, i, PQfnumber(res, "polqual")));
 		if (PQgetisnull(res, i, PQfnumber(res, "polwithcheck")))
 			p[i].withcheck = NULL;
 		else
-			p[i].withcheck = strdup(PQgetvalue(res, i, PQfnumber(res, "polwithcheck")));
-		if (PQgetisnull(res, i, PQfnumber(res, "description")))
-			p[i].comment = NULL;
-		else
-		{
-			withoutescape = PQgetvalue(res, i, PQfnumber(res, "description"));
-			p[i].comment = PQescapeLiteral(c, withoutescape, strlen(withoutescape));
-			if (p[i].comment == NULL)
-			{
-				logError("escaping comment failed: %s", PQerrorMessage(c));
-				PQclear(res);
-				PQfinish(c);
-				/* XXX leak another connection? */
-				exit(EXIT_FAILURE);
-			}
-		}
+			p[i].withcheck = arenaStrdup(PQgetvalue(res, i, PQfnumber(res, "polwithcheck")));
+		p[i].comment = getComment(PGQ_CLASS_POLICY, p[i].oid, 0);
 
 		logDebug("policy \"%s\" on \"%s\".\"%s\"", p[i].polname, p[i].table.schemaname,
 				 p[i].table.objectname);
@@ -107,35 +91,12 @@ getPolicies(PGconn *c, int *n)
 	return p;
 }
 
-void
-freePolicies(PQLPolicy *p, int n)
-{
-	if (n > 0)
-	{
-		int	i;
-
-		for (i = 0; i < n; i++)
-		{
-			free(p[i].polname);
-			free(p[i].table.schemaname);
-			free(p[i].table.objectname);
-			free(p[i].roles);
-			free(p[i].qual);
-			free(p[i].withcheck);
-			if (p[i].comment)
-				PQfreemem(p[i].comment);
-		}
-
-		free(p);
-	}
-}
-
 void
 dumpCreatePolicy(FILE *output, PQLPolicy *p)
 {
 	char	*polname = formatObjectIdentifier(p->polname);
-	char	*schema = formatObjectIdentifier(p->table.schemaname);
-	char	*tabname = formatObjectIdentifier(p->table.objectname);
+	char	*schema = quotedName(p->table.schemaname);
+	char	*tabname = quotedName(p->table.objectname);
 	char	*cmd = NULL;
 
 	if (p->cmd == '*')
@@ -153,8 +114,6 @@ dumpCreatePolicy(FILE *output, PQLPolicy *p)
 		logError("bogus value in pg_policy.polcmd (%c) in policy %s", p->cmd,
 				 p->polname);
 		free(polname);
-		free(schema);
-		free(tabname);
 		free(cmd);
 		exit(EXIT_FAILURE);
 	}
@@ -179,13 +138,13 @@ dumpCreatePolicy(FILE *output, PQLPolicy *p)
 	if (options.comment && p->comment != NULL)
 	{
 		fprintf(output, "\n\n");
-		fprintf(output, "COMMENT ON POLICY %s ON %s.%s IS %s;", polname, schema,
-				tabname, p->comment);
+		fprintf(output, "COMMENT ON POLICY %s ON %s.%s IS ", polname, schema,
+				tabname);
+		printComment(output, p->comment);
+		fprintf(output, ";");
 	}
 
 	free(polname);
-	free(schema);
-	free(tabname);
 	free(cmd);
 }
 
@@ -193,15 +152,13 @@ void
 dumpDropPolicy(FILE *output, PQLPolicy *t)
 {
 	char	*polname = formatObjectIdentifier(t->polname);
-	char	*schema = formatObjectIdentifier(t->table.schemaname);
-	char	*tabname = formatObjectIdentifier(t->table.objectname);
+	char	*schema = quotedName(t->table.schemaname);
+	char	*tabname = quotedName(t->table.objectname);
 
 	fprintf(output, "\n\n");
 	fprintf(output, "DROP POLICY %s ON %s.%s;", polname, schema, tabname);
 
 	free(polname);
-	free(schema);
-	free(tabname);
 }
 
 void
@@ -209,8 +166,8 @@ dumpAlterPolicy(FILE *output, PQLPolicy *a, PQLPolicy *b)
 {
 	char	*polname1 = formatObjectIdentifier(a->polname);
 	char	*polname2 = formatObjectIdentifier(b->polname);
-	char	*schema2 = formatObjectIdentifier(b->table.schemaname);
-	char	*tabname2 = formatObjectIdentifier(b->table.objectname);
+	char	*schema2 = quotedName(b->table.schemaname);
+	char	*tabname2 = quotedName(b->table.objectname);
 	bool	first = true;
 
 	if ((a->roles == NULL && b->roles != NULL) ||
@@ -272,8 +229,10 @@ dumpAlterPolicy(FILE *output, PQLPolicy *a, PQLPolicy *b)
 				 strcmp(a->comment, b->comment) != 0))
 		{
 			fprintf(output, "\n\n");
-			fprintf(output, "COMMENT ON POLICY %s ON %s.%s IS %s;", polname2, schema2,
-					tabname2, b->comment);
+			fprintf(output, "COMMENT ON POLICY %s ON %s.%s IS ", polname2, schema2,
+					tabname2);
+			printComment(output, b->comment);
+			fprintf(output, ";");
 		}
 		else if (a->comment != NULL && b->comment == NULL)
 		{
@@ -285,6 +244,4 @@ dumpAlterPolicy(FILE *output, PQLPolicy *a, PQLPolicy *b)
 
 	free(polname1);
 	free(polname2);
-	free(schema2);
-	free(tabname2);
 }
@@ -9,6 +9,7 @@
 #ifndef POLICY_H
 #define POLICY_H
 
+#include "comment.h"
 #include "common.h"
 
 typedef struct PQLPolicy
@@ -30,7 +31,6 @@ void dumpDropPolicy(FILE *output, PQLPolicy *p);
 void dumpCreatePolicy(FILE *output, PQLPolicy *p);
 void dumpAlterPolicy(FILE *output, PQLPolicy *a, PQLPolicy *b);
 
-void freePolicies(PQLPolicy *t, int n);
 
 #endif	/* POLICY_H */
 
@@ -18,6 +18,7 @@
  * GRANT ON FOREIGN DATA WRAPPER
  * GRANT ON FOREIGN SERVER
  * GRANT ON TABLESPACE
+ * GRANT ON ALL { TABLES | SEQUENCES | FUNCTIONS } IN SCHEMA
  *
  * REVOKE ON TABLE
  * REVOKE (columns) ON TABLE
@@ -31,6 +32,7 @@
  * REVOKE ON FOREIGN DATA WRAPPER
  * REVOKE ON FOREIGN SERVER
  * REVOKE ON TABLESPACE
+ * REVOKE ON ALL { TABLES | SEQUENCES | FUNCTIONS } IN SCHEMA
  * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
  *
  * Copyright (c) 2015-2020, Euler Taveira
@@ -40,197 +42,137 @@
 #include "privileges.h"
 
 
+/* privilege letters of aclitem in bit order (see ACL_ALL_RIGHTS_STR) */
+static const char PGQ_ACL_RIGHTS[] = "arwdDxtXUCTcsAm";
+
+static const char *const PGQ_ACL_KEYWORDS[] =
+{
+	"INSERT",			/* a */
+	"SELECT",			/* r */
+	"UPDATE",			/* w */
+	"DELETE",			/* d */
+	"TRUNCATE",			/* D */
+	"REFERENCES",		/* x */
+	"TRIGGER",			/* t */
+	"EXECUTE",			/* X */
+	"USAGE",			/* U */
+	"CREATE",			/* C */
+	"TEMPORARY",		/* T */
+	"CONNECT",			/* c */
+	"SET",				/* s */
+	"ALTER SYSTEM",		/* A */
+	"MAINTAIN"			/* m */
+};
+
+#define	PGQ_ACL_NRIGHTS		((int) sizeof(PGQ_ACL_RIGHTS) - 1)
+
+/* a schema-wide command must replace at least this many object commands */
+#define	PGQ_SCHEMA_GRANT_MIN	2
+
+/* privileges of one grantee in the objects of one schema */
+typedef struct PQLGranteeCounts
+{
+	char		*grantee;
+	int			has[PGQ_ACL_NRIGHTS];		/* source objects with privilege i */
+	int			opts[PGQ_ACL_NRIGHTS];		/* ... WITH GRANT OPTION */
+	int			grant[PGQ_ACL_NRIGHTS];		/* objects that gain privilege i */
+	int			revoke[PGQ_ACL_NRIGHTS];	/* objects that lose privilege i */
+} PQLGranteeCounts;
+
+/*
+ * Schema-wide commands of the kind of objects that is being compared. The
+ * object commands of these privileges are not printed (see
+ * dumpPrivilegeChanges).
+ */
+static PGQ_THREAD_LOCAL PQLSchemaGrant *schemagrants = NULL;
+static PGQ_THREAD_LOCAL int nschemagrants = 0;
+static PGQ_THREAD_LOCAL int schemagranttype = -1;
+
+static int compareACLItems(const void *a, const void *b);
+static int compareSchemaGrants(const void *a, const void *b);
+static void dumpPrivilegeChanges(FILE *output, int objecttype, PQLObject *a,
+								 PQLObject *b, PQLACLItem *x, PQLACLItem *y,
+								 char *args, char *cols);
+
+
 /*
  * We do not check for privilege correctness. We assume that the object accepts
  * all privileges informed. This function returns a allocated string that is a
  * list of the described privileges.
  */
 char *
-formatPrivileges(char *s, char *cols)
+formatPrivileges(uint32 privs, char *cols)
 {
-#define	MAX_KEYWORD_LEN		10	/* maximum keyword length */
-
 	char	*ret, *ptr;
-	size_t	len;
-	size_t	collen = 0;
-	size_t	coltotallen = 0;
-	bool	first_item = true;
+	size_t	len = 1;
 	int		i;
 
-	if (s == NULL)
+	if (privs == 0)
 		return NULL;
 
-	len = strlen(s);
-	if (cols)
+	for (i = 0; PGQ_ACL_RIGHTS[i] != '\0'; i++)
 	{
-		collen = strlen(cols);
-		coltotallen = collen + 3;	/* 3 => space + parentheses */
+		if (privs & (1 << i))
+		{
+			len += strlen(PGQ_ACL_KEYWORDS[i]) + 2;
+			if (cols)
+				len += strlen(cols) + 3;	/* 3 => space + parentheses */
+		}
 	}
 
-	ret = (char *) malloc(((len * MAX_KEYWORD_LEN + (len - 1) * 2) + coltotallen) *
-						  sizeof(char));
+	ret = (char *) malloc(len * sizeof(char));
+	if (ret == NULL)
+	{
+		logError("could not allocate memory");
+		exit(EXIT_FAILURE);
+	}
 	ret[0] = '\0';
 	ptr = ret;
 
-	for (i = 0; i < len; i++)
+	for (i = 0; PGQ_ACL_RIGHTS[i] != '\0'; i++)
 	{
-		if (first_item)
-			first_item = false;
-		else
-		{
-			strncpy(ptr, ", ", 3);
-			ptr += 2;
-		}
+		if ((privs & (1 << i)) == 0)
+			continue;
 
-		switch (s[i])
-		{
-			case 'r':	/* SELECT */
-				strncpy(ptr, "SELECT", 7);
-				ptr += 6;
-				break;
-			case 'U':	/* USAGE */
-				strncpy(ptr, "USAGE", 6);
-				ptr += 5;
-				break;
-			case 'a':	/* INSERT */
-				strncpy(ptr, "INSERT", 7);
-				ptr += 6;
-				break;
-			case 'x':	/* REFERENCES */
-				strncpy(ptr, "REFERENCES", 11);
-				ptr += 10;
-				break;
-			case 'd':	/* DELETE */
-				strncpy(ptr, "DELETE", 7);
-				ptr += 6;
-				break;
-			case 't':	/* TRIGGER */
-				strncpy(ptr, "TRIGGER", 8);
-				ptr += 7;
-				break;
-			case 'D':	/* TRUNCATE */
-				strncpy(ptr, "TRUNCATE", 9);
-				ptr += 8;
-				break;
-			case 'w':	/* UPDATE */
-				strncpy(ptr, "UPDATE", 7);
-				ptr += 6;
-				break;
-			case 'X':	/* EXECUTE */
-				strncpy(ptr, "EXECUTE", 8);
-				ptr += 7;
-				break;
-			case 'C':	/* CREATE */
-				strncpy(ptr, "CREATE", 7);
-				ptr += 6;
-				break;
-			case 'c':	/* CONNECT */
-				strncpy(ptr, "CONNECT", 8);
-				ptr += 7;
-				break;
-			case 'T':	/* TEMPORARY */
-				strncpy(ptr, "TEMPORARY", 10);
-				ptr += 9;
-				break;
-		}
+		if (ptr != ret)
+			ptr += sprintf(ptr, ", ");
 
-		if (collen > 0)
-		{
-			strncpy(ptr, " (", 3);
-			ptr += 2;
-			strncpy(ptr, cols, collen);
-			ptr += collen;
-			strncpy(ptr, ")", 2);
-			ptr += 1;
-		}
-	}
+		ptr += sprintf(ptr, "%s", PGQ_ACL_KEYWORDS[i]);
 
-	*ptr = '\0';
+		if (cols)
+			ptr += sprintf(ptr, " (%s)", cols);
+	}
 
 	logNoise("privileges: %s", ret);
 
 	return ret;
 }
 
-aclItem *
-splitACLItem(char *a)
+static int
+compareACLItems(const void *a, const void *b)
 {
-	aclItem	*ai;
+	const PQLACLItem	*x = (const PQLACLItem *) a;
+	const PQLACLItem	*y = (const PQLACLItem *) b;
 
-	char	*ptr;
-	char	*nextptr;
-	size_t	len;
-
-	/* protect against null input */
-	if (a == NULL)
-		return NULL;
-
-	ai = (aclItem *) malloc(sizeof(aclItem));
-	ai->next = NULL;
-
-	ptr = a;
-
-	/* grantee */
-	nextptr = strchr(ptr, '=');
-	if (nextptr)
-		*nextptr++ = '\0';
-	len = strlen(ptr);
-	/* if len is zero then grantee is PUBLIC */
-	if (len == 0)
-	{
-		ai->grantee = (char *) malloc(7 * sizeof(char));
-		strcpy(ai->grantee, "PUBLIC");
-		ai->grantee[6] = '\0';
-	}
-	else
-	{
-		ai->grantee = (char *) malloc((len + 1) * sizeof(char));
-		strncpy(ai->grantee, ptr, len + 1);
-	}
-
-	ptr = nextptr;
-
-	/* privileges */
-	nextptr = strchr(ptr, '/');
-	if (nextptr)
-		*nextptr++ = '\0';
-	len = strlen(ptr);
-	ai->privileges = (char *) malloc((len + 1) * sizeof(char));
-	strncpy(ai->privileges, ptr, len + 1);
-
-	ptr = nextptr;
-
-	/* grantor */
-	len = strlen(ptr);
-	ai->grantor = (char *) malloc((len + 1) * sizeof(char));
-	strncpy(ai->grantor, ptr, len + 1);
-
-	logNoise("grantee: %s ; grantor: %s ; privileges: %s", ai->grantee, ai->grantor,
-			 ai->privileges);
-
-	return ai;
+	return strcmp(x->grantee, y->grantee);
 }
 
-void
-freeACLItem(aclItem *ai)
-{
-	free(ai->grantee);
-	free(ai->privileges);
-	free(ai->grantor);
-	free(ai);
-}
-
-aclList *
+/*
+ * Parse an aclitem array (e.g. {=r/postgres,bob=ar*w/postgres}) into an
+ * array sorted by grantee. Items of the same grantee (from different
+ * grantors) are merged. The ACL string is copied once; grantee and grantor
+ * point into that copy.
+ */
+PQLACL *
 buildACL(char *acl)
 {
-	aclList	*al;
-	aclItem *x;
-	char	*tmp;
+	PQLACL	*al;
 	char	*p;
-
 	char	*item;
 	char	*nextitem;
 	size_t	len;
+	int		n;
+	int		i, j;
 
 	if (acl == NULL)
 	{
@@ -241,192 +183,135 @@ buildACL(char *acl)
 
 	len = strlen(acl);
 
-	/* use a temporary variable to avoid changing the original acl */
-	tmp = strdup(acl);
-	p = tmp;
-
-	/*
-	 * Let's strip Postgres array delimiters { }
-	 * The } character is removed first because we'll increment the pointer
-	 * above.
-	 */
-	if (tmp[len - 1] != '}')	/* can't happen */
+	/* Let's strip Postgres array delimiters { } */
+	if (len < 2 || acl[0] != '{' || acl[len - 1] != '}')	/* can't happen */
 	{
-		logWarning("mal formed ACL \"%s\" (last character is \"%c\")", tmp,
-				   tmp[len - 1]);
-
-		/* avoid leaking temp variable */
-		free(tmp);
-
+		logWarning("mal formed ACL \"%s\"", acl);
 		return NULL;
 	}
-	p[len - 1] = '\0';
 
-	if (tmp[0] != '{')	/* can't happen */
+	/* one item per comma */
+	n = 1;
+	for (p = acl; *p; p++)
 	{
-		logWarning("mal formed ACL \"%s\" (first character is \"%c\")", tmp, tmp[0]);
-
-		/* avoid leaking temp variable */
-		free(tmp);
+		if (*p == ',')
+			n++;
+	}
 
-		return NULL;
+	al = (PQLACL *) malloc(sizeof(PQLACL));
+	if (al == NULL)
+	{
+		logError("could not allocate memory");
+		exit(EXIT_FAILURE);
+	}
+	al->data = strdup(acl);
+	al->items = (PQLACLItem *) malloc(n * sizeof(PQLACLItem));
+	al->nitems = 0;
+	if (al->data == NULL || al->items == NULL)
+	{
+		logError("could not allocate memory");
+		exit(EXIT_FAILURE);
 	}
-	p++;
 
-	al = (aclList *) malloc(sizeof(aclList));
-	al->head = al->tail = NULL;
+	al->data[len - 1] = '\0';
 
-	for (item = p; item; item = nextitem)
+	for (item = al->data + 1; item; item = nextitem)
 	{
-		aclItem		*ai;
+		PQLACLItem	*ai = &al->items[al->nitems];
+		char		*privs;
+		char		*grantor;
 
 		nextitem = strchr(item, ',');
 		if (nextitem)
 			*nextitem++ = '\0';
 
+		/* empty array */
+		if (*item == '\0')
+			continue;
+
 		logNoise("ACL item: %s", item);
 
-		ai = splitACLItem(item);
+		privs = strchr(item, '=');
+		if (privs == NULL)
+		{
+			logWarning("mal formed ACL item \"%s\"", item);
+			continue;
+		}
+		*privs++ = '\0';
+
+		grantor = strchr(privs, '/');
+		if (grantor)
+			*grantor++ = '\0';
 
-		/* add aclItem to aclList in order */
-		if (al->tail)
+		/* if grantee is empty then it is PUBLIC */
+		ai->grantee = (*item == '\0') ? "PUBLIC" : item;
+		ai->grantor = (grantor) ? grantor : "";
+		ai->privs = ai->grantopts = 0;
+
+		for (p = privs; *p; p++)
 		{
-			aclItem	*cur = al->head;
+			char	*r;
 
-			if (strcmp(cur->grantee, ai->grantee) > 0)
+			/* grant option of the previous privilege */
+			if (*p == '*')
 			{
-				ai->next = cur;
-				al->head = ai;
+				if (p > privs && (r = strchr(PGQ_ACL_RIGHTS, p[-1])) != NULL)
+					ai->grantopts |= 1 << (r - PGQ_ACL_RIGHTS);
+				continue;
 			}
-			else
+
+			r = strchr(PGQ_ACL_RIGHTS, *p);
+			if (r == NULL)
 			{
-				while (cur != NULL)
-				{
-					if (cur == al->tail)
-					{
-						cur->next = ai;
-						al->tail = ai;
-						break;
-					}
-
-					if (strcmp(cur->grantee, ai->grantee) < 0 &&
-							strcmp(cur->next->grantee, ai->grantee) >= 0)
-					{
-						ai->next = cur->next;
-						cur->next = ai;
-						break;
-					}
-
-					cur = cur->next;
-				}
+				logWarning("unknown privilege \"%c\" in ACL item of \"%s\"", *p,
+						   ai->grantee);
+				continue;
 			}
+			ai->privs |= 1 << (r - PGQ_ACL_RIGHTS);
 		}
-		else
-		{
-			al->head = ai;
-			al->tail = ai;
-		}
+
+		logNoise("grantee: %s ; grantor: %s ; privileges: %x ; grant options: %x",
+				 ai->grantee, ai->grantor, ai->privs, ai->grantopts);
+
+		al->nitems++;
 	}
 
-	/* check the order */
-	for (x = al->head; x; x = x->next)
-		logNoise("grantee: %s ; privs: %s", x->grantee, x->privileges);
+	qsort(al->items, al->nitems, sizeof(PQLACLItem), compareACLItems);
 
-	free(tmp);
+	/* merge items of the same grantee */
+	for (i = 0, j = 0; i < al->nitems; i++)
+	{
+		if (j > 0 && strcmp(al->items[j - 1].grantee, al->items[i].grantee) == 0)
+		{
+			al->items[j - 1].privs |= al->items[i].privs;
+			al->items[j - 1].grantopts |= al->items[i].grantopts;
+		}
+		else
+			al->items[j++] = al->items[i];
+	}
+	al->nitems = j;
 
 	return al;
 }
 
 void
-freeACL(aclList *al)
+freeACL(PQLACL *al)
 {
-	aclItem	*ai, *tmp;
-
 	if (al == NULL)
 		return;
 
-	/* use tmp because ai is freed at each iteration */
-	ai = al->head;
-	tmp = ai->next;
-	while (ai)
-	{
-		freeACLItem(ai);
-		ai = tmp;
-		if (tmp)
-			tmp = tmp->next;
-	}
-
+	free(al->data);
+	free(al->items);
 	free(al);
 }
 
 /*
- * Return an allocated string that contains characters available in string a
- * but not in b.
+ * GRANT privs (a bitmask) to grantee. If grantoption is true, grantee can
+ * grant these privileges to others.
  */
-char *
-diffPrivileges(char *a, char *b)
-{
-#define	MAX_ACL_LEN		16
-
-	char	*r;
-	char	*tmpa, *tmpb, *tmpr;
-
-	tmpa = a;
-	tmpb = b;
-
-	r = (char *) malloc((MAX_ACL_LEN + 1) * sizeof(char));
-	tmpr = r;
-	r[0] = '\0';
-
-	if (b == NULL)
-		strncpy(r, a, MAX_ACL_LEN);
-	else if (tmpa != NULL)
-	{
-		while (*tmpa != '\0')
-		{
-			bool	notfound = true;
-
-			while (*tmpb != '\0')
-			{
-				if (*tmpa == *tmpb)
-				{
-					notfound = false;
-					break;
-				}
-
-				tmpb++;
-			}
-
-			if (notfound)
-				*tmpr++ = *tmpa;
-
-			tmpa++;
-			tmpb = b;	/* start again */
-		}
-
-		/* string must be null-terminated because we don't store its length */
-		*tmpr = '\0';
-	}
-
-	/* if there is no differences, then return NULL */
-	if (r[0] == '\0')
-	{
-		free(r);
-		r = NULL;
-	}
-
-	if (r)
-		logNoise("a: %s ; b: %s ; difference: \"%s\"", a, b, r);
-	else
-		logNoise("a: %s ; b: %s ; difference: nothing", a, b);
-
-	return r;
-}
-
 void
-dumpGrant(FILE *output, int objecttype, PQLObject *a, char *privs,
-		  char *grantee,
-		  char *args, char *cols)
+dumpGrant(FILE *output, int objecttype, PQLObject *a, uint32 privs,
+		  bool grantoption, char *grantee, char *args, char *cols)
 {
 	char	*schema;
 	char	*objname;
@@ -435,7 +320,7 @@ dumpGrant(FILE *output, int objecttype, PQLObject *a, char *privs,
 	char	*p;
 
 	/* nothing to be done */
-	if (privs == NULL)
+	if (privs == 0)
 		return;
 
 	schema = NULL;
@@ -499,29 +384,32 @@ dumpGrant(FILE *output, int objecttype, PQLObject *a, char *privs,
 		/* there are some objects that are not schema-qualified */
 		schema = formatObjectIdentifier(a->schemaname);
 
-		fprintf(output, " %s.%s(%s) TO %s;",
+		fprintf(output, " %s.%s(%s) TO %s%s;",
 				schema,
 				objname,
 				args,
-				owner);
+				owner,
+				(grantoption) ? " WITH GRANT OPTION" : "");
 	}
 	else if (objecttype == PGQ_DATABASE || objecttype == PGQ_FOREIGN_DATA_WRAPPER ||
 			 objecttype == PGQ_FOREIGN_SERVER || objecttype == PGQ_LANGUAGE ||
 			 objecttype == PGQ_SCHEMA || objecttype == PGQ_TABLESPACE)
 	{
 		/* there are some objects that are not schema-qualified */
-		fprintf(output, " %s TO %s;",
+		fprintf(output, " %s TO %s%s;",
 				objname,
-				owner);
+				owner,
+				(grantoption) ? " WITH GRANT OPTION" : "");
 	}
 	else
 	{
 		schema = formatObjectIdentifier(a->schemaname);
 
-		fprintf(output, " %s.%s TO %s;",
+		fprintf(output, " %s.%s TO %s%s;",
 				schema,
 				objname,
-				owner);
+				owner,
+				(grantoption) ? " WITH GRANT OPTION" : "");
 	}
 
 	free(p);
@@ -531,9 +419,13 @@ dumpGrant(FILE *output, int objecttype, PQLObject *a, char *privs,
 	free(owner);
 }
 
+/*
+ * REVOKE privs (a bitmask) from grantee. If grantoption is true, only the
+ * grant option is revoked.
+ */
 void
-dumpRevoke(FILE *output, int objecttype, PQLObject *a, char *privs,
-		   char *grantee, char *args, char *cols)
+dumpRevoke(FILE *output, int objecttype, PQLObject *a, uint32 privs,
+		   bool grantoption, char *grantee, char *args, char *cols)
 {
 	char	*schema;
 	char	*objname;
@@ -542,7 +434,7 @@ dumpRevoke(FILE *output, int objecttype, PQLObject *a, char *privs,
 	char	*p;
 
 	/* nothing to be done */
-	if (privs == NULL)
+	if (privs == 0)
 		return;
 
 	schema = NULL;
@@ -555,7 +447,7 @@ dumpRevoke(FILE *output, int objecttype, PQLObject *a, char *privs,
 	p = formatPrivileges(privs, cols);
 
 	fprintf(output, "\n\n");
-	fprintf(output, "REVOKE %s", p);
+	fprintf(output, "REVOKE %s%s", (grantoption) ? "GRANT OPTION FOR " : "", p);
 	fprintf(output, " ON ");
 
 	switch (objecttype)
@@ -637,90 +529,499 @@ dumpRevoke(FILE *output, int objecttype, PQLObject *a, char *privs,
 	free(owner);
 }
 
+/*
+ * Print the commands that change the privileges of grantee x (server 1) into
+ * those of grantee y (server 2). Either of them can be NULL. Revoking a
+ * privilege also revokes its grant option. Privileges that are changed by a
+ * schema-wide command are skipped.
+ */
+static void
+dumpPrivilegeChanges(FILE *output, int objecttype, PQLObject *a, PQLObject *b,
+					 PQLACLItem *x, PQLACLItem *y, char *args, char *cols)
+{
+	uint32		privsa = (x) ? x->privs : 0;
+	uint32		privsb = (y) ? y->privs : 0;
+	uint32		optsa = (x) ? x->grantopts : 0;
+	uint32		optsb = (y) ? y->grantopts : 0;
+	char		*grantee = (x) ? x->grantee : y->grantee;
+	uint32		revoke = privsa & ~privsb;
+	uint32		grant = privsb & ~privsa & ~optsb;
+	uint32		grantopts = optsb & ~optsa;
+
+	if (objecttype != PGQ_FUNCTION && objecttype != PGQ_PROCEDURE)
+		args = NULL;
+
+	if (nschemagrants > 0 && objecttype == schemagranttype && cols == NULL)
+	{
+		PQLSchemaGrant	key;
+		PQLSchemaGrant	*sg;
+
+		key.schema = b->schemaname;
+		key.grantee = grantee;
+		sg = (PQLSchemaGrant *) bsearch(&key, schemagrants, nschemagrants,
+										sizeof(PQLSchemaGrant),
+										compareSchemaGrants);
+		if (sg)
+		{
+			revoke &= ~sg->revoke;
+			grant &= ~sg->grant;
+			grantopts &= ~sg->grantopts;
+		}
+	}
+
+	dumpRevoke(output, objecttype, a, revoke, false, grantee, args, cols);
+	dumpRevoke(output, objecttype, a, optsa & ~optsb & privsb, true, grantee,
+			   args, cols);
+	dumpGrant(output, objecttype, b, grant, false, grantee, args, cols);
+	dumpGrant(output, objecttype, b, grantopts, true, grantee, args, cols);
+}
+
 void
 dumpGrantAndRevoke(FILE *output, int objecttype, PQLObject *a, PQLObject *b,
 				   char *acla, char *aclb, char *args, char *cols)
 {
-	aclList		*ala;
-	aclList		*alb;
-	aclItem		*tmpa = NULL;
-	aclItem		*tmpb = NULL;
+	PQLACL	*ala;
+	PQLACL	*alb;
+	int		na = 0;
+	int		nb = 0;
+	int		i, j;
+
+	/* nothing changed; there is no need to parse them */
+	if (acla == NULL && aclb == NULL)
+		return;
+	if (acla != NULL && aclb != NULL && strcmp(acla, aclb) == 0)
+		return;
 
 	ala = buildACL(acla);
 	alb = buildACL(aclb);
 
 	if (ala)
-		tmpa = ala->head;
+		na = ala->nitems;
 	if (alb)
-		tmpb = alb->head;
+		nb = alb->nitems;
 
-	/* loop until both lists ended */
-	while (tmpa != NULL || tmpb != NULL)
+	/* both arrays are sorted by grantee; walk them once */
+	i = j = 0;
+	while (i < na || j < nb)
 	{
-		/* End of aclList ala. Print GRANT for aclList alb until its end. */
-		if (tmpa == NULL)
+		int		r;
+
+		if (i == na)
+			r = 1;
+		else if (j == nb)
+			r = -1;
+		else
+			r = strcmp(ala->items[i].grantee, alb->items[j].grantee);
+
+		if (r == 0)
 		{
-			logDebug("grant to %s: server2 (end)", tmpb->grantee);
+			logDebug("grant/revoke %s: server1 server2", ala->items[i].grantee);
 
-			dumpGrant(output, objecttype, b, tmpb->privileges, tmpb->grantee,
-					  ((objecttype == PGQ_FUNCTION ||
-						objecttype == PGQ_PROCEDURE) ? args : NULL), cols);
-			tmpb = tmpb->next;
+			dumpPrivilegeChanges(output, objecttype, a, b, &ala->items[i],
+								 &alb->items[j], args, cols);
+			i++;
+			j++;
 		}
-		/* End of aclList alb. Print REVOKE for aclList ala until its end. */
-		else if (tmpb == NULL)
+		else if (r < 0)
 		{
-			logDebug("revoke from %s: server1 (end)", tmpa->grantee);
+			logDebug("revoke from %s: server1", ala->items[i].grantee);
 
-			dumpRevoke(output, objecttype, a, tmpa->privileges, tmpa->grantee,
-					   ((objecttype == PGQ_FUNCTION ||
-						 objecttype == PGQ_PROCEDURE) ? args : NULL), cols);
-			tmpa = tmpa->next;
+			dumpPrivilegeChanges(output, objecttype, a, b, &ala->items[i], NULL,
+								 args, cols);
+			i++;
 		}
-		else if (strcmp(tmpa->grantee, tmpb->grantee) == 0)
+		else
 		{
-			char	*privs;
-
-			logDebug("grant/revoke %s: server1 server2", tmpa->grantee);
-
-			privs = diffPrivileges(tmpa->privileges, tmpb->privileges);
-			dumpRevoke(output, objecttype, a, privs, tmpa->grantee,
-					   ((objecttype == PGQ_FUNCTION ||
-						 objecttype == PGQ_PROCEDURE) ? args : NULL), cols);
-			if (privs)
-				free(privs);
-
-			privs = diffPrivileges(tmpb->privileges, tmpa->privileges);
-			dumpGrant(output, objecttype, b, privs, tmpb->grantee,
-					  ((objecttype == PGQ_FUNCTION ||
-						objecttype == PGQ_PROCEDURE) ? args : NULL), cols);
-			if (privs)
-				free(privs);
-
-			tmpa = tmpa->next;
-			tmpb = tmpb->next;
+			logDebug("grant to %s: server2", alb->items[j].grantee);
+
+			dumpPrivilegeChanges(output, objecttype, a, b, NULL, &alb->items[j],
+								 args, cols);
+			j++;
 		}
-		else if (strcmp(tmpa->grantee, tmpb->grantee) < 0)
+	}
+
+	/* free temporary arrays */
+	freeACL(ala);
+	freeACL(alb);
+}
+
+static int
+compareSchemaGrants(const void *a, const void *b)
+{
+	const PQLSchemaGrant	*x = (const PQLSchemaGrant *) a;
+	const PQLSchemaGrant	*y = (const PQLSchemaGrant *) b;
+	int						c;
+
+	c = strcmp(x->schema, y->schema);
+	if (c == 0)
+		c = strcmp(x->grantee, y->grantee);
+
+	return c;
+}
+
+static PQLACLItem *
+findACLItem(PQLACL *al, char *grantee)
+{
+	PQLACLItem	key;
+
+	if (al == NULL)
+		return NULL;
+
+	key.grantee = grantee;
+
+	return (PQLACLItem *) bsearch(&key, al->items, al->nitems,
+								  sizeof(PQLACLItem), compareACLItems);
+}
+
+static PQLGranteeCounts *
+getGranteeCounts(PQLGranteeCounts **counts, int *n, char *grantee)
+{
+	PQLGranteeCounts	*gc;
+	int					i;
+
+	for (i = 0; i < *n; i++)
+	{
+		if (strcmp((*counts)[i].grantee, grantee) == 0)
+			return &(*counts)[i];
+	}
+
+	*counts = (PQLGranteeCounts *) realloc(*counts,
+										   (*n + 1) * sizeof(PQLGranteeCounts));
+	if (*counts == NULL)
+	{
+		logError("could not allocate memory");
+		exit(EXIT_FAILURE);
+	}
+
+	gc = &(*counts)[(*n)++];
+	memset(gc, 0, sizeof(PQLGranteeCounts));
+	gc->grantee = strdup(grantee);
+
+	return gc;
+}
+
+/*
+ * Number of objects of schema in the result of the query of
+ * getSchemaObjectCounts.
+ */
+static int
+countSchemaObjects(PGresult *res, char *schema)
+{
+	int		i;
+
+	for (i = 0; i < PQntuples(res); i++)
+	{
+		if (strcmp(PQgetvalue(res, i, 0), schema) == 0)
+			return atoi(PQgetvalue(res, i, 1));
+	}
+
+	return 0;
+}
+
+/*
+ * Objects per schema that a GRANT ON ALL ... IN SCHEMA of this kind changes.
+ * It does not depend on the compared objects so it is also recorded while
+ * dumping a catalog.
+ */
+static PGresult *
+getSchemaObjectCounts(PGconn *c, int objecttype)
+{
+	char		*query;
+	PGresult	*res;
+
+	if (objecttype == PGQ_TABLE)
+		query = psprintf("SELECT n.nspname, count(*) FROM pg_class c INNER JOIN pg_namespace n ON (c.relnamespace = n.oid) WHERE c.relkind IN ('r', 'p', 'v', 'm', 'f') GROUP BY n.nspname ORDER BY n.nspname");
+	else if (objecttype == PGQ_SEQUENCE)
+		query = psprintf("SELECT n.nspname, count(*) FROM pg_class c INNER JOIN pg_namespace n ON (c.relnamespace = n.oid) WHERE c.relkind = 'S' GROUP BY n.nspname ORDER BY n.nspname");
+	/* procedures are not functions since 11 */
+	else if (getServerVersion(c) >= 110000)
+		query = psprintf("SELECT n.nspname, count(*) FROM pg_proc p INNER JOIN pg_namespace n ON (p.pronamespace = n.oid) WHERE p.prokind <> 'p' GROUP BY n.nspname ORDER BY n.nspname");
+	else
+		query = psprintf("SELECT n.nspname, count(*) FROM pg_proc p INNER JOIN pg_namespace n ON (p.pronamespace = n.oid) GROUP BY n.nspname ORDER BY n.nspname");
+
+	res = execQuery(c, query);
+
+	pfree(query);
+
+	if (PQresultStatus(res) != PGRES_TUPLES_OK)
+	{
+		logError("query failed: %s", PQresultErrorMessage(res));
+		PQclear(res);
+		PQfinish(c);
+		/* XXX leak another connection? */
+		exit(EXIT_FAILURE);
+	}
+
+	return res;
+}
+
+/*
+ * Find the privileges that change in the same way in every object of schema.
+ * a[i] (server 1) and b[i] (server 2) are the same object; objects
+ * [first, last) belong to schema. counts1 and counts2 are the results of
+ * getSchemaObjectCounts.
+ */
+static void
+findGrantsOfSchema(int objecttype, PQLPrivilegeObject *a, PQLPrivilegeObject *b,
+				   int first, int last, PGresult *counts1, PGresult *counts2)
+{
+	PQLGranteeCounts	*counts = NULL;
+	int					ncounts = 0;
+	char				*schema;
+	int					n1 = 0;		/* objects of server 1 */
+	int					n2 = 0;		/* objects of server 2 */
+	int					nfound = 0;
+	int					i, j, k;
+
+	schema = (b[first].obj) ? b[first].obj->schemaname : a[first].obj->schemaname;
+
+	for (i = first; i < last; i++)
+	{
+		PQLACL	*ala = NULL;
+		PQLACL	*alb = NULL;
+
+		if (a[i].obj)
+		{
+			ala = buildACL(a[i].acl);
+			n1++;
+		}
+
+		if (b[i].obj)
+		{
+			/* default privileges are not stored; do not guess them */
+			if (b[i].acl == NULL)
+			{
+				logDebug("schema \"%s\": object \"%s\" has default privileges",
+						 schema, b[i].obj->objectname);
+				freeACL(ala);
+				goto done;
+			}
+
+			alb = buildACL(b[i].acl);
+			n2++;
+		}
+
+		for (j = 0; alb && j < alb->nitems; j++)
+		{
+			PQLACLItem			*y = &alb->items[j];
+			PQLACLItem			*x = findACLItem(ala, y->grantee);
+			PQLGranteeCounts	*gc = getGranteeCounts(&counts, &ncounts,
+													   y->grantee);
+
+			for (k = 0; k < PGQ_ACL_NRIGHTS; k++)
+			{
+				if ((y->privs & (1 << k)) == 0)
+					continue;
+
+				gc->has[k]++;
+				if (y->grantopts & (1 << k))
+					gc->opts[k]++;
+				if (x == NULL || (x->privs & (1 << k)) == 0)
+					gc->grant[k]++;
+			}
+		}
+
+		/* an object that is dropped does not need REVOKE */
+		for (j = 0; ala && b[i].obj && j < ala->nitems; j++)
 		{
-			logDebug("revoke from %s: server1", tmpa->grantee);
+			PQLACLItem			*x = &ala->items[j];
+			PQLACLItem			*y = findACLItem(alb, x->grantee);
+			PQLGranteeCounts	*gc = getGranteeCounts(&counts, &ncounts,
+													   x->grantee);
 
-			dumpRevoke(output, objecttype, a, tmpa->privileges, tmpa->grantee,
-					   ((objecttype == PGQ_FUNCTION ||
-						 objecttype == PGQ_PROCEDURE) ? args : NULL), cols);
-			tmpa = tmpa->next;
+			for (k = 0; k < PGQ_ACL_NRIGHTS; k++)
+			{
+				if ((x->privs & (1 << k)) && (y == NULL || (y->privs & (1 << k)) == 0))
+					gc->revoke[k]++;
+			}
+		}
+
+		freeACL(ala);
+		freeACL(alb);
+	}
+
+	/* every object of server 2 must have a privilege to GRANT it */
+	for (i = 0; i < ncounts; i++)
+	{
+		PQLGranteeCounts	*gc = &counts[i];
+		PQLSchemaGrant		sg;
+
+		sg.grant = sg.grantopts = sg.revoke = 0;
+		for (k = 0; k < PGQ_ACL_NRIGHTS; k++)
+		{
+			if (gc->has[k] == n2 && gc->grant[k] >= PGQ_SCHEMA_GRANT_MIN)
+			{
+				sg.grant |= 1 << k;
+				if (gc->opts[k] == n2)
+					sg.grantopts |= 1 << k;
+			}
+			else if (gc->has[k] == 0 && gc->revoke[k] >= PGQ_SCHEMA_GRANT_MIN)
+				sg.revoke |= 1 << k;
 		}
-		else if (strcmp(tmpa->grantee, tmpb->grantee) > 0)
+
+		if (sg.grant == 0 && sg.revoke == 0)
+			continue;
+
+		/*
+		 * Objects that are not compared (another kind such as views,
+		 * extension members or filtered objects) would also be changed.
+		 */
+		if (nfound == 0 && (countSchemaObjects(counts1, schema) != n1 ||
+							countSchemaObjects(counts2, schema) != n2))
 		{
-			logDebug("grant to %s: server2", tmpb->grantee);
+			logDebug("schema \"%s\": there are objects that are not compared",
+					 schema);
+			goto done;
+		}
 
-			dumpGrant(output, objecttype, b, tmpb->privileges, tmpb->grantee,
-					  ((objecttype == PGQ_FUNCTION ||
-						objecttype == PGQ_PROCEDURE) ? args : NULL), cols);
-			tmpb = tmpb->next;
+		logDebug("schema \"%s\": grant %x (grant option %x) revoke %x to %s",
+				 schema, sg.grant, sg.grantopts, sg.revoke, gc->grantee);
+
+		sg.schema = strdup(schema);
+		sg.grantee = strdup(gc->grantee);
+
+		schemagrants = (PQLSchemaGrant *) realloc(schemagrants,
+												  (nschemagrants + 1) * sizeof(PQLSchemaGrant));
+		if (schemagrants == NULL)
+		{
+			logError("could not allocate memory");
+			exit(EXIT_FAILURE);
 		}
+		schemagrants[nschemagrants++] = sg;
+		nfound++;
 	}
 
-	/* free temporary lists */
-	freeACL(ala);
-	freeACL(alb);
+done:
+	for (i = 0; i < ncounts; i++)
+		free(counts[i].grantee);
+	if (counts)
+		free(counts);
+}
+
+/*
+ * Replace the commands that change the same privilege of every object of a
+ * schema with GRANT / REVOKE ... ON ALL ... IN SCHEMA. Only tables, sequences
+ * and functions are supported. a[i] (server 1) and b[i] (server 2) are the
+ * same object and the objects are grouped by schema. The object commands
+ * that are printed until resetSchemaGrants skip those privileges.
+ *
+ * A privilege is granted only if every object of the schema has it at the
+ * end; objects of other kinds or objects that are not compared (views,
+ * extension members, filtered objects) disable it. Hence, an object never
+ * has a privilege that it should not have. Column privileges and changes of
+ * grant options alone are printed per object.
+ */
+void
+findSchemaGrants(PGconn *c1, PGconn *c2, int objecttype, PQLPrivilegeObject *a,
+				 PQLPrivilegeObject *b, int n)
+{
+	PGresult	*counts1;
+	PGresult	*counts2;
+	int			first, last;
+
+	resetSchemaGrants();
+
+	counts1 = getSchemaObjectCounts(c1, objecttype);
+	counts2 = getSchemaObjectCounts(c2, objecttype);
+
+	for (first = 0; first < n; first = last)
+	{
+		char	*schema;
+
+		schema = (b[first].obj) ? b[first].obj->schemaname : a[first].obj->schemaname;
+
+		for (last = first + 1; last < n; last++)
+		{
+			char	*s = (b[last].obj) ? b[last].obj->schemaname : a[last].obj->schemaname;
+
+			if (strcmp(s, schema) != 0)
+				break;
+		}
+
+		findGrantsOfSchema(objecttype, a, b, first, last, counts1, counts2);
+	}
+
+	PQclear(counts1);
+	PQclear(counts2);
+
+	if (nschemagrants > 0)
+	{
+		qsort(schemagrants, nschemagrants, sizeof(PQLSchemaGrant),
+			  compareSchemaGrants);
+		schemagranttype = objecttype;
+	}
+}
+
+void
+dumpSchemaGrants(FILE *output)
+{
+	const char	*kind;
+	int			i;
+
+	if (schemagranttype == PGQ_TABLE)
+		kind = "TABLES";
+	else if (schemagranttype == PGQ_SEQUENCE)
+		kind = "SEQUENCES";
+	else
+		kind = "FUNCTIONS";
+
+	for (i = 0; i < nschemagrants; i++)
+	{
+		PQLSchemaGrant	*sg = &schemagrants[i];
+		char			*schema;
+		char			*grantee;
+		char			*p;
+
+		schema = formatObjectIdentifier(sg->schema);
+		if (strcmp(sg->grantee, "PUBLIC") == 0)
+			grantee = strdup(sg->grantee);
+		else
+			grantee = formatObjectIdentifier(sg->grantee);
+
+		if (sg->revoke)
+		{
+			p = formatPrivileges(sg->revoke, NULL);
+			fprintf(output, "\n\n");
+			fprintf(output, "REVOKE %s ON ALL %s IN SCHEMA %s FROM %s;", p, kind,
+					schema, grantee);
+			free(p);
+		}
+		if (sg->grant & ~sg->grantopts)
+		{
+			p = formatPrivileges(sg->grant & ~sg->grantopts, NULL);
+			fprintf(output, "\n\n");
+			fprintf(output, "GRANT %s ON ALL %s IN SCHEMA %s TO %s;", p, kind,
+					schema, grantee);
+			free(p);
+		}
+		if (sg->grantopts)
+		{
+			p = formatPrivileges(sg->grantopts, NULL);
+			fprintf(output, "\n\n");
+			fprintf(output, "GRANT %s ON ALL %s IN SCHEMA %s TO %s WITH GRANT OPTION;",
+					p, kind, schema, grantee);
+			free(p);
+		}
+
+		free(schema);
+		free(grantee);
+	}
+}
+
+void
+resetSchemaGrants(void)
+{
+	int		i;
+
+	for (i = 0; i < nschemagrants; i++)
+	{
+		free(schemagrants[i].schema);
+		free(schemagrants[i].grantee);
+	}
+	if (schemagrants)
+		free(schemagrants);
+
+	schemagrants = NULL;
+	nschemagrants = 0;
+	schemagranttype = -1;
 }
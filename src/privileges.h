@@ -11,19 +11,45 @@
 
 #include "common.h"
 
-typedef struct aclItem
+/*
+ * Privileges of one grantee. Bit i of privs and grantopts is the privilege
+ * letter i of aclitem (see privileges.c).
+ */
+typedef struct PQLACLItem
+{
+	char		*grantee;		/* role name or PUBLIC */
+	char		*grantor;
+	uint32		privs;
+	uint32		grantopts;		/* privileges WITH GRANT OPTION */
+} PQLACLItem;
+
+/* parsed aclitem array sorted by grantee (see buildACL) */
+typedef struct PQLACL
 {
-	struct aclItem	*next;
-	char			*grantee;
-	char			*grantor;
-	char			*privileges;
-} aclItem;
+	char		*data;
+	PQLACLItem	*items;
+	int			nitems;
+} PQLACL;
 
-typedef struct aclList
+/*
+ * An object and its ACL as given to findSchemaGrants. obj is NULL if the
+ * object does not exist in that server.
+ */
+typedef struct PQLPrivilegeObject
 {
-	aclItem		*head;
-	aclItem		*tail;
-} aclList;
+	PQLObject	*obj;
+	char		*acl;
+} PQLPrivilegeObject;
+
+/* GRANT / REVOKE ... ON ALL ... IN SCHEMA (see findSchemaGrants) */
+typedef struct PQLSchemaGrant
+{
+	char		*schema;
+	char		*grantee;
+	uint32		grant;
+	uint32		grantopts;		/* part of grant WITH GRANT OPTION */
+	uint32		revoke;
+} PQLSchemaGrant;
 
 enum PQLObjectType
 {
@@ -42,20 +68,22 @@ enum PQLObjectType
 };
 
 
-char *formatPrivileges(char *s, char *cols);
-char *diffPrivileges(char *a, char *b);
+char *formatPrivileges(uint32 privs, char *cols);
 
-aclItem *splitACLItem(char *a);
-aclList *buildACL(char *acl);
-void freeACLItem(aclItem *ai);
-void freeACL(aclList *al);
+PQLACL *buildACL(char *acl);
+void freeACL(PQLACL *al);
 
-void dumpGrant(FILE *output, int objecttype, PQLObject *a, char *privs,
-			   char *grantee, char *args, char *cols);
-void dumpRevoke(FILE *output, int objecttype, PQLObject *a, char *privs,
-				char *grantee, char *args, char *cols);
+void dumpGrant(FILE *output, int objecttype, PQLObject *a, uint32 privs,
+			   bool grantoption, char *grantee, char *args, char *cols);
+void dumpRevoke(FILE *output, int objecttype, PQLObject *a, uint32 privs,
+				bool grantoption, char *grantee, char *args, char *cols);
 void dumpGrantAndRevoke(FILE *output, int objecttype, PQLObject *a,
 						PQLObject *b,
 						char *acla, char *aclb, char *args, char *cols);
 
+void findSchemaGrants(PGconn *c1, PGconn *c2, int objecttype,
+					  PQLPrivilegeObject *a, PQLPrivilegeObject *b, int n);
+void dumpSchemaGrants(FILE *output);
+void resetSchemaGrants(void);
+
 #endif	/* PRIVILEGES_H */
@@ -36,24 +36,24 @@ getPublications(PGconn *c, int *n)
 	PGresult	*res;
 	int			i;
 
-	logNoise("publication: server version: %d", PQserverVersion(c));
+	logNoise("publication: server version: %d", getServerVersion(c));
 
 	/* bail out if we do not support it */
-	if (PQserverVersion(c) < 100000)
+	if (getServerVersion(c) < 100000)
 	{
 		logWarning("ignoring publications because server does not support it");
 		return NULL;
 	}
 
-	if (PQserverVersion(c) >= 110000)
+	if (getServerVersion(c) >= 110000)
 	{
-		res = PQexec(c,
-					 "SELECT p.oid, pubname, puballtables, pubinsert, pubupdate, pubdelete, pubtruncate, obj_description(p.oid, 'pg_publication') AS description, pg_get_userbyid(pubowner) AS pubowner FROM pg_publication p ORDER BY pubname");
+		res = execQuery(c,
+					 "SELECT p.oid, pubname, puballtables, pubinsert, pubupdate, pubdelete, pubtruncate, pg_get_userbyid(pubowner) AS pubowner FROM pg_publication p ORDER BY pubname");
 	}
-	else if (PQserverVersion(c) >= 100000)
+	else if (getServerVersion(c) >= 100000)
 	{
-		res = PQexec(c,
-					 "SELECT p.oid, pubname, puballtables, pubinsert, pubupdate, pubdelete, false AS pubtruncate, obj_description(p.oid, 'pg_publication') AS description, pg_get_userbyid(pubowner) AS pubowner FROM pg_publication p ORDER BY pubname");
+		res = execQuery(c,
+					 "SELECT p.oid, pubname, puballtables, pubinsert, pubupdate, pubdelete, false AS pubtruncate, pg_get_userbyid(pubowner) AS pubowner FROM pg_publication p ORDER BY pubname");
 	}
 
 	if (PQresultStatus(res) != PGRES_TUPLES_OK)
@@ -67,7 +67,7 @@ getPublications(PGconn *c, int *n)
 
 	*n = PQntuples(res);
 	if (*n > 0)
-		p = (PQLPublication *) malloc(*n * sizeof(PQLPublication));
+		p = (PQLPublication *) arenaAlloc(*n * sizeof(PQLPublication));
 	else
 		p = NULL;
 
@@ -75,38 +75,22 @@ getPublications(PGconn *c, int *n)
 
 	for (i = 0; i < *n; i++)
 	{
-		char	*withoutescape;
-
 		p[i].oid = strtoul(PQgetvalue(res, i, PQfnumber(res, "oid")), NULL, 10);
-		p[i].pubname = strdup(PQgetvalue(res, i, PQfnumber(res, "pubname")));
+		p[i].pubname = arenaStrdup(PQgetvalue(res, i, PQfnumber(res, "pubname")));
 		p[i].alltables = (PQgetvalue(res, i, PQfnumber(res, "puballtables"))[0] == 't');
 		p[i].pubinsert = (PQgetvalue(res, i, PQfnumber(res, "pubinsert"))[0] == 't');
 		p[i].pubupdate = (PQgetvalue(res, i, PQfnumber(res, "pubupdate"))[0] == 't');
 		p[i].pubdelete = (PQgetvalue(res, i, PQfnumber(res, "pubdelete"))[0] == 't');
 		p[i].pubtruncate = (PQgetvalue(res, i, PQfnumber(res,
 									   "pubtruncate"))[0] == 't');
-		if (PQgetisnull(res, i, PQfnumber(res, "description")))
-			p[i].comment = NULL;
-		else
-		{
-			withoutescape = PQgetvalue(res, i, PQfnumber(res, "description"));
-			p[i].comment = PQescapeLiteral(c, withoutescape, strlen(withoutescape));
-			if (p[i].comment == NULL)
-			{
-				logError("escaping comment failed: %s", PQerrorMessage(c));
-				PQclear(res);
-				PQfinish(c);
-				/* XXX leak another connection? */
-				exit(EXIT_FAILURE);
-			}
-		}
+		p[i].comment = getComment(PGQ_CLASS_PUBLICATION, p[i].oid, 0);
 
-		p[i].owner = strdup(PQgetvalue(res, i, PQfnumber(res, "pubowner")));
+		p[i].owner = internName(PQgetvalue(res, i, PQfnumber(res, "pubowner")));
 
 		/*
 		 * These values are not assigned here (see getPublicationTables), but
 		 * defaults values are essential to avoid having trouble in
-		 * freePublications.
+		 * the dump routines.
 		 */
 		p[i].ntables = 0;
 		p[i].tables = NULL;
@@ -114,7 +98,7 @@ getPublications(PGconn *c, int *n)
 		/*
 		 * Security labels are not assigned here (see getPublicationSecurityLabels),
 		 * but default values are essential to avoid having trouble in
-		 * freePublications.
+		 * the dump routines.
 		 */
 		p[i].nseclabels = 0;
 		p[i].seclabels = NULL;
@@ -128,141 +112,70 @@ getPublications(PGconn *c, int *n)
 }
 
 void
-getPublicationTables(PGconn *c, PQLPublication *p)
+getPublicationTables(PGconn *c, PQLPublication *p, int n)
 {
-	char		*query;
-	PGresult	*res;
-	int			i;
+	char		**queries;
+	PGresult	**res;
+	int			i, j;
 
-	query = psprintf("SELECT n.nspname, c.relname FROM pg_class c INNER JOIN pg_namespace n ON (c.relnamespace = n.oid) INNER JOIN pg_publication_rel pr ON (c.oid = pr.prrelid) WHERE pr.prpubid = %u ORDER BY n.nspname, c.relname",
-					  p->oid);
+	if (n == 0)
+		return;
 
-	res = PQexec(c, query);
+	queries = (char **) malloc(n * sizeof(char *));
+	for (i = 0; i < n; i++)
+		queries[i] = psprintf("SELECT n.nspname, c.relname FROM pg_class c INNER JOIN pg_namespace n ON (c.relnamespace = n.oid) INNER JOIN pg_publication_rel pr ON (c.oid = pr.prrelid) WHERE pr.prpubid = %u ORDER BY n.nspname, c.relname",
+						  p[i].oid);
 
-	pfree(query);
+	res = execQueries(c, queries, n);
 
-	if (PQresultStatus(res) != PGRES_TUPLES_OK)
+	for (i = 0; i < n; i++)
 	{
-		logError("query failed: %s", PQresultErrorMessage(res));
-		PQclear(res);
-		PQfinish(c);
-		/* XXX leak another connection? */
-		exit(EXIT_FAILURE);
-	}
+		p[i].ntables = PQntuples(res[i]);
+		if (p[i].ntables > 0)
+			p[i].tables = (PQLObject *) arenaAlloc(p[i].ntables * sizeof(PQLObject));
+		else
+			p[i].tables = NULL;
 
-	p->ntables = PQntuples(res);
-	if (p->ntables > 0)
-		p->tables = (PQLObject *) malloc(p->ntables * sizeof(PQLObject));
-	else
-		p->tables = NULL;
+		logDebug("number of tables in publication \"%s\": %d", p[i].pubname, p[i].ntables);
 
-	logDebug("number of tables in publication \"%s\": %d", p->pubname, p->ntables);
+		for (j = 0; j < p[i].ntables; j++)
+		{
+			p[i].tables[j].schemaname = internName(PQgetvalue(res[i], j, PQfnumber(res[i],
+											 "nspname")));
+			p[i].tables[j].objectname = internName(PQgetvalue(res[i], j, PQfnumber(res[i],
+											 "relname")));
 
-	for (i = 0; i < p->ntables; i++)
-	{
-		p->tables[i].schemaname = strdup(PQgetvalue(res, i, PQfnumber(res,
-										 "nspname")));
-		p->tables[i].objectname = strdup(PQgetvalue(res, i, PQfnumber(res,
-										 "relname")));
+			logDebug("table \"%s\".\"%s\" in publication \"%s\"", p[i].tables[j].schemaname,
+					 p[i].tables[j].objectname, p[i].pubname);
+		}
 
-		logDebug("table \"%s\".\"%s\" in publication \"%s\"", p->tables[i].schemaname,
-				 p->tables[i].objectname, p->pubname);
+		PQclear(res[i]);
 	}
 
-	PQclear(res);
+	free(res);
 }
 
 void
-getPublicationSecurityLabels(PGconn *c, PQLPublication *p)
+getPublicationSecurityLabels(PGconn *c, PQLPublication *p, int n)
 {
-	char		*query;
-	PGresult	*res;
 	int			i;
 
-	query = psprintf("SELECT provider, label FROM pg_seclabel s INNER JOIN pg_class c ON (s.classoid = c.oid) WHERE c.relname = 'pg_publication' AND s.objoid = %u ORDER BY provider", p->oid);
+	if (n == 0)
+		return;
 
-	res = PQexec(c, query);
-
-	pfree(query);
-
-	if (PQresultStatus(res) != PGRES_TUPLES_OK)
+	if (getServerVersion(c) < 90100)
 	{
-		logError("query failed: %s", PQresultErrorMessage(res));
-		PQclear(res);
-		PQfinish(c);
-		/* XXX leak another connection? */
-		exit(EXIT_FAILURE);
+		logWarning("ignoring security labels because server does not support it");
+		return;
 	}
 
-	p->nseclabels = PQntuples(res);
-	if (p->nseclabels > 0)
-		p->seclabels = (PQLSecLabel *) malloc(p->nseclabels * sizeof(PQLSecLabel));
-	else
-		p->seclabels = NULL;
-
-	logDebug("number of security labels in publication \"%s\": %d", p->pubname,
-			 p->nseclabels);
-
-	for (i = 0; i < p->nseclabels; i++)
+	for (i = 0; i < n; i++)
 	{
-		char	*withoutescape;
-
-		p->seclabels[i].provider = strdup(PQgetvalue(res, i, PQfnumber(res,
-										  "provider")));
-		withoutescape = PQgetvalue(res, i, PQfnumber(res, "label"));
-		p->seclabels[i].label = PQescapeLiteral(c, withoutescape,
-												strlen(withoutescape));
-		if (p->seclabels[i].label == NULL)
-		{
-			logError("escaping label failed: %s", PQerrorMessage(c));
-			PQclear(res);
-			PQfinish(c);
-			/* XXX leak another connection? */
-			exit(EXIT_FAILURE);
-		}
-	}
-
-	PQclear(res);
-}
-
-void
-freePublications(PQLPublication *p, int n)
-{
-	if (n > 0)
-	{
-		int	i;
+		p[i].nseclabels = getObjectSecurityLabels(c, PGQ_CLASS_PUBLICATION,
+							  p[i].oid, 0, &p[i].seclabels);
 
-		for (i = 0; i < n; i++)
-		{
-			int	j;
-
-			free(p[i].pubname);
-			if (p[i].comment)
-				PQfreemem(p[i].comment);
-			free(p[i].owner);
-
-			/* tables */
-			for (j = 0; j < p[i].ntables; j++)
-			{
-				free(p[i].tables[j].schemaname);
-				free(p[i].tables[j].objectname);
-			}
-
-			if (p[i].tables)
-				free(p[i].tables);
-
-			/* security labels */
-			for (j = 0; j < p[i].nseclabels; j++)
-			{
-				free(p[i].seclabels[j].provider);
-				PQfreemem(p[i].seclabels[j].label);
-			}
-
-			if (p[i].seclabels)
-				free(p[i].seclabels);
-		}
-
-		free(p);
+		logDebug("number of security labels in publication \"%s\": %d", p[i].pubname,
+				 p[i].nseclabels);
 	}
 }
 
@@ -324,13 +237,11 @@ dumpCreatePublication(FILE *output, PQLPublication *p)
 
 		for (i = 0; i < p->ntables; i++)
 		{
-			char	*schemaname = formatObjectIdentifier(p->tables[i].schemaname);
-			char	*tablename = formatObjectIdentifier(p->tables[i].objectname);
+			char	*schemaname = quotedName(p->tables[i].schemaname);
+			char	*tablename = quotedName(p->tables[i].objectname);
 			fprintf(output, "\n\n");
 			fprintf(output, "ALTER PUBLICATION %s ADD TABLE ONLY %s.%s;", publicationname,
 					schemaname, tablename);
-			free(schemaname);
-			free(tablename);
 		}
 	}
 
@@ -338,8 +249,9 @@ dumpCreatePublication(FILE *output, PQLPublication *p)
 	if (options.comment && p->comment != NULL)
 	{
 		fprintf(output, "\n\n");
-		fprintf(output, "COMMENT ON PUBLICATION %s IS %s;", publicationname,
-				p->comment);
+		fprintf(output, "COMMENT ON PUBLICATION %s IS ", publicationname);
+		printComment(output, p->comment);
+		fprintf(output, ";");
 	}
 
 	/* security labels */
@@ -360,12 +272,10 @@ dumpCreatePublication(FILE *output, PQLPublication *p)
 	/* owner */
 	if (options.owner)
 	{
-		char	*owner = formatObjectIdentifier(p->owner);
+		char	*owner = quotedName(p->owner);
 
 		fprintf(output, "\n\n");
 		fprintf(output, "ALTER PUBLICATION %s OWNER TO %s;", publicationname, owner);
-
-		free(owner);
 	}
 
 	free(publicationname);
@@ -443,8 +353,9 @@ dumpAlterPublication(FILE *output, PQLPublication *a, PQLPublication *b)
 				 strcmp(a->comment, b->comment) != 0))
 		{
 			fprintf(output, "\n\n");
-			fprintf(output, "COMMENT ON PUBLICATION %s IS %s;", publicationname2,
-					b->comment);
+			fprintf(output, "COMMENT ON PUBLICATION %s IS ", publicationname2);
+			printComment(output, b->comment);
+			fprintf(output, ";");
 		}
 		else if (a->comment != NULL && b->comment == NULL)
 		{
@@ -544,12 +455,10 @@ dumpAlterPublication(FILE *output, PQLPublication *a, PQLPublication *b)
 	{
 		if (strcmp(a->owner, b->owner) != 0)
 		{
-			char	*owner = formatObjectIdentifier(b->owner);
+			char	*owner = quotedName(b->owner);
 
 			fprintf(output, "\n\n");
 			fprintf(output, "ALTER PUBLICATION %s OWNER TO %s;", publicationname2, owner);
-
-			free(owner);
 		}
 	}
 
@@ -561,30 +470,26 @@ static void
 dumpAddTable(FILE *output, PQLPublication *p, int i)
 {
 	char	*publicationname = formatObjectIdentifier(p->pubname);
-	char	*schemaname = formatObjectIdentifier(p->tables[i].schemaname);
-	char	*tablename = formatObjectIdentifier(p->tables[i].objectname);
+	char	*schemaname = quotedName(p->tables[i].schemaname);
+	char	*tablename = quotedName(p->tables[i].objectname);
 
 	fprintf(output, "\n\n");
 	fprintf(output, "ALTER PUBLICATION %s ADD TABLE ONLY %s.%s;", publicationname,
 			schemaname, tablename);
 
 	free(publicationname);
-	free(schemaname);
-	free(tablename);
 }
 
 static void
 dumpRemoveTable(FILE *output, PQLPublication *p, int i)
 {
 	char	*publicationname = formatObjectIdentifier(p->pubname);
-	char	*schemaname = formatObjectIdentifier(p->tables[i].schemaname);
-	char	*tablename = formatObjectIdentifier(p->tables[i].objectname);
+	char	*schemaname = quotedName(p->tables[i].schemaname);
+	char	*tablename = quotedName(p->tables[i].objectname);
 
 	fprintf(output, "\n\n");
 	fprintf(output, "ALTER PUBLICATION %s DROP TABLE ONLY %s.%s;", publicationname,
 			schemaname, tablename);
 
 	free(publicationname);
-	free(schemaname);
-	free(tablename);
 }
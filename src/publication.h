@@ -9,7 +9,9 @@
 #ifndef PUBLICATION_H
 #define PUBLICATION_H
 
+#include "comment.h"
 #include "common.h"
+#include "seclabel.h"
 
 typedef struct PQLPublication
 {
@@ -31,14 +33,13 @@ typedef struct PQLPublication
 } PQLPublication;
 
 PQLPublication *getPublications(PGconn *c, int *n);
-void getPublicationTables(PGconn *c, PQLPublication *p);
-void getPublicationSecurityLabels(PGconn *c, PQLPublication *s);
+void getPublicationTables(PGconn *c, PQLPublication *p, int n);
+void getPublicationSecurityLabels(PGconn *c, PQLPublication *s, int n);
 
 void dumpDropPublication(FILE *output, PQLPublication *s);
 void dumpCreatePublication(FILE *output, PQLPublication *s);
 void dumpAlterPublication(FILE *output, PQLPublication *a, PQLPublication *b);
 
-void freePublications(PQLPublication *s, int n);
 
 #endif	/* PUBLICATION_H */
 
@@ -63,6 +63,7 @@
 
 #include "quarrel.h"
 #include "common.h"
+#include "catalog.h"
 
 #include "am.h"
 #include "aggregate.h"
@@ -101,10 +102,15 @@
 
 /* global variables */
 enum PQLLogLevel	loglevel = PGQ_ERROR;
-int					pgversion1;
-int					pgversion2;
-PGconn				*conn1;
-PGconn				*conn2;
+enum PQLLogFormat	logformat = PGQ_LOG_TEXT;
+PGQ_THREAD_LOCAL int	pgversion1;
+PGQ_THREAD_LOCAL int	pgversion2;
+PGQ_THREAD_LOCAL int	costexceeded;	/* commands over cost-threshold */
+PGQ_THREAD_LOCAL PGconn	*conn1;
+PGQ_THREAD_LOCAL PGconn	*conn2;
+PGQ_THREAD_LOCAL PQLArena	arena1;		/* catalog objects of each server */
+PGQ_THREAD_LOCAL PQLArena	arena2;
+PGQ_THREAD_LOCAL PQLNameTable	nametable;	/* object names of both servers */
 
 QuarrelGeneralOptions		options;	/* general options */
 
@@ -112,7 +118,7 @@ QuarrelGeneralOptions		options;	/* general options */
 char *include_schema_str;
 char *exclude_schema_str;
 
-PQLStatistic		qstat = {0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+PGQ_THREAD_LOCAL PQLStatistic	qstat = {0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
 							 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
 							 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
 							 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
@@ -123,22 +129,139 @@ PQLStatistic		qstat = {0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
 					  };
 
 FILE				*fout;			/* output file */
-FILE				*fpre, *fpost;	/* temporary files */
-
-char				prepath[PGQMAXPATH];
-char				postpath[PGQMAXPATH];
+PGQ_THREAD_LOCAL FILE	*fpre, *fpost;	/* streams of bpre and bpost */
+PGQ_THREAD_LOCAL PQLOutputBuffer	*bpre, *bpost;
+
+static PQLOutputBuffer	outpre;
+static PQLOutputBuffer	outpost;
+
+/* dependencies of each server (see writeChanges) */
+static PQLDependencies	depend1 = {NULL, 0, NULL, 0};
+static PQLDependencies	depend2 = {NULL, 0, NULL, 0};
+
+/* comments of each server and the ones this thread compares (see main) */
+static PQLComments	comments1 = {NULL, NULL, 0};
+static PQLComments	comments2 = {NULL, NULL, 0};
+static PGQ_THREAD_LOCAL PQLComments	*curcomments1 = NULL;
+static PGQ_THREAD_LOCAL PQLComments	*curcomments2 = NULL;
+
+/* security labels of each server and the ones this thread compares */
+static PQLSecLabels	seclabels1 = {NULL, NULL, 0};
+static PQLSecLabels	seclabels2 = {NULL, NULL, 0};
+static PGQ_THREAD_LOCAL PQLSecLabels	*curseclabels1 = NULL;
+static PGQ_THREAD_LOCAL PQLSecLabels	*curseclabels2 = NULL;
+
+/* comparison steps in dependency order (see main) */
+static QuarrelStep	*steps = NULL;
+static int			nsteps = 0;
+static int			nextstep = 0;	/* next step to be run by a worker */
+
+/* fan-out targets (see runTargets) */
+static QuarrelTarget	*targets = NULL;
+static int			ntargets = 0;
+static int			nexttarget = 0;	/* next target to be compared by a worker */
+static PGconn		*fanoutsource = NULL;
+
+/* protect nextstep and nexttarget */
+#if defined(_WINDOWS)
+static CRITICAL_SECTION	worklock;
+#else
+static pthread_mutex_t	worklock = PTHREAD_MUTEX_INITIALIZER;
+#endif
 
 
 static int compareMajorVersion(int a, int b);
 static bool parseBoolean(const char *key, const char *s);
+static int parseInteger(const char *key, const char *s, int min, int max);
+static enum PQLLogFormat parseLogFormat(const char *key, const char *s);
 static void help(void);
 static void loadConfig(const char *c, QuarrelOptions *o);
 static PGconn *connectDatabase(QuarrelDatabaseOptions opt);
-
-static void mergeTempFiles(FILE *pre, FILE *post, FILE *output);
-static FILE *openTempFile(char *p);
-static void closeTempFile(FILE *fp, char *p);
-static bool isEmptyFile(char *p);
+static void closeConnection(PGconn *c);
+static PGconn *cloneConnection(PGconn *c);
+static void beginSnapshotTransaction(PGconn *c, const char *snapshot);
+static void setTransactionParameter(PGconn *c, const char *name, int value);
+static char *exportSnapshot(PGconn *c);
+
+static void addStep(void (*run) (void));
+static void runSteps(PGconn *c1, PGconn *c2);
+static void runWorker(QuarrelWorker *w);
+#if defined(_WINDOWS)
+static unsigned __stdcall workerThread(void *arg);
+#else
+static void *workerThread(void *arg);
+#endif
+static void runTargets(PGconn *source, QuarrelTargetOptions *t, int n);
+static void runTargetWorker(void);
+#if defined(_WINDOWS)
+static unsigned __stdcall targetThread(void *arg);
+#else
+static void *targetThread(void *arg);
+#endif
+static void compareTarget(int n);
+static void writeChanges(FILE *output, const char *dir, PQLOutputBuffer *pre,
+						 PQLOutputBuffer *post, PQLDependencies *d1,
+						 PQLDependencies *d2);
+static void addStatistics(PQLStatistic *a, PQLStatistic *b);
+static void printSummary(void);
+
+static void collectTables(PQLTable *a, int na, bool alla, PQLTable *b, int nb,
+						  bool allb, PQLTable ***ca, int *nca, PQLTable ***cb,
+						  int *ncb);
+static int compareRelationObjects(void *a, void *b);
+static int compareFunctionObjects(void *a, void *b);
+static void findObjectSchemaGrants(int objecttype, void *a, int na, void *b,
+								   int nb, size_t size, size_t acloffset,
+								   int (*compare) (void *a, void *b));
+
+static void fetchObjects(void (*fetch) (QuarrelFetch *f), QuarrelFetch *f1,
+						 QuarrelFetch *f2);
+#if defined(_WINDOWS)
+static unsigned __stdcall fetchThread(void *arg);
+#else
+static void *fetchThread(void *arg);
+#endif
+static void fetchAccessMethods(QuarrelFetch *f);
+static void fetchAggregates(QuarrelFetch *f);
+static void fetchCasts(QuarrelFetch *f);
+static void fetchCollations(QuarrelFetch *f);
+static void fetchConversions(QuarrelFetch *f);
+static void fetchDomains(QuarrelFetch *f);
+static void fetchEventTriggers(QuarrelFetch *f);
+static void fetchExtensions(QuarrelFetch *f);
+static void fetchForeignDataWrappers(QuarrelFetch *f);
+static void fetchForeignServers(QuarrelFetch *f);
+static void fetchFunctions(QuarrelFetch *f);
+static void fetchIndexes(QuarrelFetch *f);
+static void fetchLanguages(QuarrelFetch *f);
+static void fetchMaterializedViews(QuarrelFetch *f);
+static void fetchOperators(QuarrelFetch *f);
+static void fetchOperatorFamilies(QuarrelFetch *f);
+static void fetchOperatorClasses(QuarrelFetch *f);
+static void fetchProcedures(QuarrelFetch *f);
+static void fetchPublications(QuarrelFetch *f);
+static void fetchPolicies(QuarrelFetch *f);
+static void fetchRules(QuarrelFetch *f);
+static void fetchSchemas(QuarrelFetch *f);
+static void fetchSequences(QuarrelFetch *f);
+static void fetchStatistics(QuarrelFetch *f);
+static void fetchSubscriptions(QuarrelFetch *f);
+static void fetchTextSearchConfigs(QuarrelFetch *f);
+static void fetchTextSearchDicts(QuarrelFetch *f);
+static void fetchTextSearchParsers(QuarrelFetch *f);
+static void fetchTextSearchTemplates(QuarrelFetch *f);
+static void fetchTransforms(QuarrelFetch *f);
+static void fetchTriggers(QuarrelFetch *f);
+static void fetchBaseTypes(QuarrelFetch *f);
+static void fetchCompositeTypes(QuarrelFetch *f);
+static void fetchEnumTypes(QuarrelFetch *f);
+static void fetchRangeTypes(QuarrelFetch *f);
+static void fetchUserMappings(QuarrelFetch *f);
+static void fetchViews(QuarrelFetch *f);
+static void fetchForeignTables(QuarrelFetch *f);
+static void fetchForeignTableDetails(QuarrelFetch *f);
+static void fetchTables(QuarrelFetch *f);
+static void fetchTableDetails(QuarrelFetch *f);
 
 static void quarrelAccessMethods();
 static void quarrelAggregates();
@@ -213,6 +336,36 @@ parseBoolean(const char *key, const char *s)
 	return ret;
 }
 
+static int
+parseInteger(const char *key, const char *s, int min, int max)
+{
+	char	*end;
+	long	ret;
+
+	errno = 0;
+	ret = strtol(s, &end, 10);
+	if (errno != 0 || *end != '\0' || ret < min || ret > max)
+	{
+		logError("invalid value for option \"%s\": %s (must be between %d and %d)",
+				 key, s, min, max);
+		exit(EXIT_FAILURE);
+	}
+
+	return (int) ret;
+}
+
+static enum PQLLogFormat
+parseLogFormat(const char *key, const char *s)
+{
+	if (strcmp(s, "text") == 0)
+		return PGQ_LOG_TEXT;
+	else if (strcmp(s, "json") == 0)
+		return PGQ_LOG_JSON;
+
+	logError("invalid value for option \"%s\": %s (must be text or json)", key, s);
+	exit(EXIT_FAILURE);
+}
+
 static void
 help(void)
 {
@@ -224,10 +377,34 @@ help(void)
 	printf("Usage:\n");
 	printf("  %s [OPTION]...\n", PGQ_NAME);
 	printf("\nOptions:\n");
+	printf("      --annotate-cost=BOOL      annotate ALTER TABLE with its estimated cost (default: %s)\n",
+		   (opts.general.annotatecost) ? "true" : "false");
+	printf("      --cache-directory=DIR     reuse catalog caches stored in this directory\n");
 	printf("  -c, --config=FILENAME         configuration file\n");
+	printf("      --cost-threshold=MB       fail if an ALTER TABLE touches more than MB, 0 disables (default: %d)\n",
+		   opts.general.costthreshold);
+	printf("      --dependency-order=BOOL   order changes by object dependencies (default: %s)\n",
+		   (opts.general.dependencyorder) ? "true" : "false");
+	printf("      --dump-catalog=FILENAME   dump source catalog into this file, then exit\n");
 	printf("  -f, --file=FILENAME           receive changes into this file, - for stdout (default: stdout)\n");
 	printf("      --ignore-version          ignore version check\n");
+	printf("  -j, --jobs=NUM                use this many connections per server (default: %d)\n",
+		   opts.general.jobs);
+	printf("      --parallel-directory=DIR  also write changes as waves of independent files into this directory\n");
+	printf("      --pipeline=BOOL           use pipeline mode to fetch catalog objects (default: %s)\n",
+		   (opts.general.pipeline) ? "true" : "false");
+	printf("      --log-format=FORMAT       log format: text or json (default: %s)\n",
+		   (opts.general.logformat == PGQ_LOG_JSON) ? "json" : "text");
+	printf("      --lock-timeout=MS         abort a catalog query that waits longer than MS for a lock, 0 disables (default: %d)\n",
+		   opts.general.locktimeout);
+	printf("      --online                  avoid commands that hold long locks on the target\n");
+	printf("      --output-buffer-size=KB   keep up to KB of changes in memory before using temp-directory (default: %d)\n",
+		   opts.general.outputbuffersize);
+	printf("      --schema-grants=BOOL      use GRANT ON ALL ... IN SCHEMA for privileges of every object of a schema (default: %s)\n",
+		   (opts.general.schemagrants) ? "true" : "false");
 	printf("  -s, --summary                 print a summary of changes\n");
+	printf("      --statement-timeout=MS    abort a catalog query that takes longer than MS, 0 disables (default: %d)\n",
+		   opts.general.statementtimeout);
 	printf("  -t, --single-transaction      execute as a single transaction\n");
 	printf("      --temp-directory=DIR      use as temporary file area (default: \"%s\")\n",
 		   (opts.general.tmpdir) ? opts.general.tmpdir : "");
@@ -308,12 +485,14 @@ help(void)
 	printf("      --source-port=PORT        server port\n");
 	printf("      --source-username=NAME    user name\n");
 	printf("      --source-no-password      never prompt for password\n");
+	printf("      --source-catalog=FILENAME read source from this catalog file\n");
 	printf("\nTarget options:\n");
 	printf("      --target-dbname=DBNAME    database name or connection string\n");
 	printf("      --target-host=HOSTNAME    server host or socket directory\n");
 	printf("      --target-port=PORT        server port\n");
 	printf("      --target-username=NAME    user name\n");
 	printf("      --target-no-password      never prompt for password\n");
+	printf("      --target-catalog=FILENAME read target from this catalog file\n");
 	printf("\n");
 	printf("  --help                        show this help, then exit\n");
 	printf("  --version                     output version information, then exit\n");
@@ -340,6 +519,17 @@ loadConfig(const char *cf, QuarrelOptions *options)
 	options->general.owner = false;				/* general - owner */
 	options->general.privileges = false;		/* general - privileges */
 	options->general.singletxn = false;			/* general - single-transaction */
+	options->general.pipeline = false;			/* general - pipeline */
+	options->general.jobs = 1;					/* general - jobs */
+	options->general.statementtimeout = 0;		/* general - statement-timeout */
+	options->general.locktimeout = 0;			/* general - lock-timeout */
+	options->general.logformat = PGQ_LOG_TEXT;	/* general - log-format */
+	options->general.outputbuffersize = 16384;	/* general - output-buffer-size */
+	options->general.dependencyorder = false;	/* general - dependency-order */
+	options->general.online = false;			/* general - online */
+	options->general.annotatecost = false;		/* general - annotate-cost */
+	options->general.costthreshold = 0;			/* general - cost-threshold */
+	options->general.schemagrants = false;		/* general - schema-grants */
 
 	options->general.accessmethod = false;		/* general - access method */
 	options->general.aggregate = false;			/* general - aggregate */
@@ -373,6 +563,9 @@ loadConfig(const char *cf, QuarrelOptions *options)
 
 	options->general.include_schema = NULL;		/* general - include schemas that match pattern */
 	options->general.exclude_schema = NULL;		/* general - exclude schemas that match pattern */
+	options->general.dumpcatalog = NULL;		/* general - dump-catalog */
+	options->general.cachedir = NULL;			/* general - cache-directory */
+	options->general.paralleldir = NULL;		/* general - parallel-directory */
 
 	options->source.host = NULL;				/* source - host */
 	options->source.port = NULL;				/* source - port */
@@ -380,6 +573,7 @@ loadConfig(const char *cf, QuarrelOptions *options)
 	options->source.password = NULL;			/* source - password */
 	options->source.dbname = NULL;				/* source - dbname */
 	options->source.promptpassword = true;		/* source - prompt for password */
+	options->source.catalog = NULL;				/* source - catalog file */
 
 	options->target.host = NULL;				/* target - host */
 	options->target.port = NULL;				/* target - port */
@@ -387,6 +581,10 @@ loadConfig(const char *cf, QuarrelOptions *options)
 	options->target.password = NULL;			/* target - password */
 	options->target.dbname = NULL;				/* target - dbname */
 	options->target.promptpassword = true;		/* source - prompt for password */
+	options->target.catalog = NULL;				/* target - catalog file */
+
+	options->targets = NULL;					/* [target.NAME] sections */
+	options->ntargets = 0;
 
 	/* if there is no config file, bail out */
 	if (cf == NULL)
@@ -481,6 +679,66 @@ loadConfig(const char *cf, QuarrelOptions *options)
 										 mini_file_get_value(config,
 												 "general", "single-transaction"));
 
+		if (mini_file_get_value(config, "general", "pipeline") != NULL)
+			options->general.pipeline = parseBoolean("pipeline",
+										mini_file_get_value(config,
+												"general", "pipeline"));
+
+		if (mini_file_get_value(config, "general", "jobs") != NULL)
+			options->general.jobs = parseInteger("jobs",
+												 mini_file_get_value(config,
+														 "general", "jobs"),
+												 1, PGQ_MAX_JOBS);
+
+		if (mini_file_get_value(config, "general", "statement-timeout") != NULL)
+			options->general.statementtimeout = parseInteger("statement-timeout",
+												mini_file_get_value(config,
+														"general", "statement-timeout"),
+												0, INT_MAX);
+
+		if (mini_file_get_value(config, "general", "lock-timeout") != NULL)
+			options->general.locktimeout = parseInteger("lock-timeout",
+										   mini_file_get_value(config,
+												   "general", "lock-timeout"),
+										   0, INT_MAX);
+
+		if (mini_file_get_value(config, "general", "online") != NULL)
+			options->general.online = parseBoolean("online",
+									  mini_file_get_value(config,
+											  "general", "online"));
+
+		if (mini_file_get_value(config, "general", "annotate-cost") != NULL)
+			options->general.annotatecost = parseBoolean("annotate-cost",
+											mini_file_get_value(config,
+													"general", "annotate-cost"));
+
+		if (mini_file_get_value(config, "general", "cost-threshold") != NULL)
+			options->general.costthreshold = parseInteger("cost-threshold",
+											 mini_file_get_value(config,
+													 "general", "cost-threshold"),
+											 0, INT_MAX);
+
+		if (mini_file_get_value(config, "general", "schema-grants") != NULL)
+			options->general.schemagrants = parseBoolean("schema-grants",
+											mini_file_get_value(config,
+													"general", "schema-grants"));
+
+		if (mini_file_get_value(config, "general", "dependency-order") != NULL)
+			options->general.dependencyorder = parseBoolean("dependency-order",
+											   mini_file_get_value(config,
+													   "general", "dependency-order"));
+
+		if (mini_file_get_value(config, "general", "output-buffer-size") != NULL)
+			options->general.outputbuffersize = parseInteger("output-buffer-size",
+												mini_file_get_value(config,
+														"general", "output-buffer-size"),
+												0, INT_MAX / 1024);
+
+		if (mini_file_get_value(config, "general", "log-format") != NULL)
+			options->general.logformat = parseLogFormat("log-format",
+										 mini_file_get_value(config,
+												 "general", "log-format"));
+
 		/*
 		 * select objects that will be compared
 		 */
@@ -623,6 +881,18 @@ loadConfig(const char *cf, QuarrelOptions *options)
 		if (tmp != NULL)
 			options->general.exclude_schema = strdup(tmp);
 
+		tmp = mini_file_get_value(config, "general", "dump-catalog");
+		if (tmp != NULL)
+			options->general.dumpcatalog = strdup(tmp);
+
+		tmp = mini_file_get_value(config, "general", "cache-directory");
+		if (tmp != NULL)
+			options->general.cachedir = strdup(tmp);
+
+		tmp = mini_file_get_value(config, "general", "parallel-directory");
+		if (tmp != NULL)
+			options->general.paralleldir = strdup(tmp);
+
 		/* source options */
 		tmp = mini_file_get_value(config, "source", "host");
 		if (tmp != NULL)
@@ -679,6 +949,10 @@ loadConfig(const char *cf, QuarrelOptions *options)
 			options->source.promptpassword = !parseBoolean("no-password",
 											 mini_file_get_value(config, "source", "no-password"));
 
+		tmp = mini_file_get_value(config, "source", "catalog");
+		if (tmp != NULL)
+			options->source.catalog = strdup(tmp);
+
 
 		/* target options */
 		tmp = mini_file_get_value(config, "target", "host");
@@ -735,6 +1009,62 @@ loadConfig(const char *cf, QuarrelOptions *options)
 		if (tmp != NULL)
 			options->target.promptpassword = !parseBoolean("no-password",
 											 mini_file_get_value(config, "target", "no-password"));
+
+		tmp = mini_file_get_value(config, "target", "catalog");
+		if (tmp != NULL)
+			options->target.catalog = strdup(tmp);
+
+		/* fan-out targets */
+		for (sec = config->section; sec != NULL; sec = sec->next)
+		{
+			QuarrelTargetOptions	*t;
+
+			if (strncmp(sec->name, PGQ_TARGET_PREFIX, strlen(PGQ_TARGET_PREFIX)) != 0)
+				continue;
+
+			options->targets = (QuarrelTargetOptions *) realloc(options->targets,
+							   (options->ntargets + 1) * sizeof(QuarrelTargetOptions));
+			if (options->targets == NULL)
+			{
+				logError("could not allocate memory");
+				exit(EXIT_FAILURE);
+			}
+
+			t = &options->targets[options->ntargets++];
+			memset(t, 0, sizeof(QuarrelTargetOptions));
+			t->name = strdup(sec->name + strlen(PGQ_TARGET_PREFIX));
+			t->db.istarget = true;
+
+			if (t->name[0] == '\0')
+			{
+				logError("target section \"%s\" does not have a name", sec->name);
+				exit(EXIT_FAILURE);
+			}
+
+			for (secdata = sec->data; secdata != NULL; secdata = secdata->next)
+			{
+				if (strcmp(secdata->key, "host") == 0)
+					t->db.host = strdup(secdata->value);
+				else if (strcmp(secdata->key, "port") == 0)
+					t->db.port = strdup(secdata->value);
+				else if (strcmp(secdata->key, "user") == 0)
+					t->db.username = strdup(secdata->value);
+				else if (strcmp(secdata->key, "password") == 0)
+					t->db.password = strdup(secdata->value);
+				else if (strcmp(secdata->key, "dbname") == 0)
+					t->db.dbname = strdup(secdata->value);
+				else if (strcmp(secdata->key, "catalog") == 0)
+					t->db.catalog = strdup(secdata->value);
+				else if (strcmp(secdata->key, "output") == 0)
+					t->output = strdup(secdata->value);
+				else
+					logWarning("unrecognized option \"%s\" in section \"%s\"",
+							   secdata->key, sec->name);
+			}
+
+			if (t->output == NULL)
+				t->output = psprintf("%s.sql", t->name);
+		}
 	}
 	else
 	{
@@ -753,8 +1083,15 @@ connectDatabase(QuarrelDatabaseOptions opt)
 	char		*prompt_password = NULL;
 
 #define NUMBER_OF_PARAMS	7
-	const char **keywords = malloc(NUMBER_OF_PARAMS * sizeof(*keywords));
-	const char **values = malloc(NUMBER_OF_PARAMS * sizeof(*values));
+	const char **keywords;
+	const char **values;
+
+	/* a catalog file replaces the connection */
+	if (opt.catalog != NULL)
+		return openCatalogFile(opt.catalog);
+
+	keywords = malloc(NUMBER_OF_PARAMS * sizeof(*keywords));
+	values = malloc(NUMBER_OF_PARAMS * sizeof(*values));
 
 	keywords[0] = "host";
 	values[0] = opt.host;
@@ -835,6 +1172,988 @@ connectDatabase(QuarrelDatabaseOptions opt)
 	return conn;
 }
 
+static void
+closeConnection(PGconn *c)
+{
+	if (isCatalogFile(c))
+		closeCatalogFile(c);
+	else
+	{
+		endCatalogDump(c);
+		PQfinish(c);
+	}
+}
+
+/*
+ * Open another connection using the same parameters (including a password
+ * that was prompted) of an established connection.
+ */
+static PGconn *
+cloneConnection(PGconn *c)
+{
+	PGconn				*conn;
+	PQconninfoOption	*conninfo;
+	PQconninfoOption	*opt;
+	const char			**keywords;
+	const char			**values;
+	int					n = 0;
+
+	conninfo = PQconninfo(c);
+	if (conninfo == NULL)
+	{
+		logError("out of memory");
+		exit(EXIT_FAILURE);
+	}
+
+	for (opt = conninfo; opt->keyword != NULL; opt++)
+		n++;
+
+	keywords = malloc((n + 1) * sizeof(*keywords));
+	values = malloc((n + 1) * sizeof(*values));
+
+	n = 0;
+	for (opt = conninfo; opt->keyword != NULL; opt++)
+	{
+		if (opt->val == NULL || opt->val[0] == '\0')
+			continue;
+		keywords[n] = opt->keyword;
+		values[n] = opt->val;
+		n++;
+	}
+	keywords[n] = values[n] = NULL;
+
+	conn = PQconnectdbParams(keywords, values, 0);
+
+	free(keywords);
+	free(values);
+	PQconninfoFree(conninfo);
+
+	if (conn == NULL)
+	{
+		logError("out of memory");
+		exit(EXIT_FAILURE);
+	}
+
+	if (PQstatus(conn) == CONNECTION_BAD)
+	{
+		logError("connection to database \"%s\" failed: %s", PQdb(c),
+				 PQerrorMessage(conn));
+		PQfinish(conn);
+		exit(EXIT_FAILURE);
+	}
+
+	return conn;
+}
+
+/*
+ * Start a read-only repeatable read transaction. All catalog queries executed
+ * by this connection will see the same snapshot. If snapshot is informed, the
+ * transaction uses that (exported) snapshot. Catalog queries are also limited
+ * by statement-timeout and lock-timeout so a concurrent DDL does not hold us
+ * indefinitely.
+ */
+static void
+beginSnapshotTransaction(PGconn *c, const char *snapshot)
+{
+	PGresult	*res;
+	char		*query;
+
+	/* catalog file is already a snapshot */
+	if (isCatalogFile(c))
+		return;
+
+	res = PQexec(c, "BEGIN ISOLATION LEVEL REPEATABLE READ READ ONLY");
+	if (PQresultStatus(res) != PGRES_COMMAND_OK)
+	{
+		logError("could not start transaction: %s", PQresultErrorMessage(res));
+		PQclear(res);
+		PQfinish(c);
+		/* XXX leak another connection? */
+		exit(EXIT_FAILURE);
+	}
+	PQclear(res);
+
+	/* it must be executed before any query */
+	if (snapshot != NULL)
+	{
+		query = psprintf("SET TRANSACTION SNAPSHOT '%s'", snapshot);
+		res = PQexec(c, query);
+		pfree(query);
+
+		if (PQresultStatus(res) != PGRES_COMMAND_OK)
+		{
+			logError("could not import snapshot \"%s\": %s", snapshot,
+					 PQresultErrorMessage(res));
+			PQclear(res);
+			PQfinish(c);
+			/* XXX leak another connection? */
+			exit(EXIT_FAILURE);
+		}
+		PQclear(res);
+	}
+
+	if (options.statementtimeout > 0)
+		setTransactionParameter(c, "statement_timeout", options.statementtimeout);
+
+	/* lock_timeout is new in 9.3 */
+	if (options.locktimeout > 0)
+	{
+		if (PQserverVersion(c) >= 90300)
+			setTransactionParameter(c, "lock_timeout", options.locktimeout);
+		else
+			logWarning("ignoring lock-timeout because server does not support it");
+	}
+}
+
+/*
+ * Set a parameter (in milliseconds) until the end of the current transaction.
+ */
+static void
+setTransactionParameter(PGconn *c, const char *name, int value)
+{
+	PGresult	*res;
+	char		*query;
+
+	query = psprintf("SET LOCAL %s = %d", name, value);
+	res = PQexec(c, query);
+	pfree(query);
+
+	if (PQresultStatus(res) != PGRES_COMMAND_OK)
+	{
+		logError("could not set %s: %s", name, PQresultErrorMessage(res));
+		PQclear(res);
+		PQfinish(c);
+		/* XXX leak another connection? */
+		exit(EXIT_FAILURE);
+	}
+	PQclear(res);
+
+	logDebug("%s: %d ms", name, value);
+}
+
+/*
+ * Export the snapshot of the current transaction. It is valid until the
+ * transaction ends. Returns an allocated string.
+ */
+static char *
+exportSnapshot(PGconn *c)
+{
+	PGresult	*res;
+	char		*snapshot;
+
+	res = PQexec(c, "SELECT pg_export_snapshot()");
+	if (PQresultStatus(res) != PGRES_TUPLES_OK)
+	{
+		logError("could not export snapshot: %s", PQresultErrorMessage(res));
+		PQclear(res);
+		PQfinish(c);
+		/* XXX leak another connection? */
+		exit(EXIT_FAILURE);
+	}
+
+	snapshot = strdup(PQgetvalue(res, 0, 0));
+
+	logDebug("snapshot exported: %s", snapshot);
+
+	PQclear(res);
+
+	return snapshot;
+}
+
+/*
+ * Append a comparison step. Steps are run in the same order they are added
+ * (unless --jobs is greater than 1).
+ */
+static void
+addStep(void (*run) (void))
+{
+	steps = (QuarrelStep *) realloc(steps, (nsteps + 1) * sizeof(QuarrelStep));
+	if (steps == NULL)
+	{
+		logError("could not allocate memory");
+		exit(EXIT_FAILURE);
+	}
+
+	memset(&steps[nsteps], 0, sizeof(QuarrelStep));
+	steps[nsteps].run = run;
+	nsteps++;
+}
+
+/*
+ * Run all comparison steps. Commands are written into fpre and fpost.
+ *
+ * With --jobs, each worker has its own connections, all of them sharing the
+ * same snapshot that c1 and c2 exported, and takes the next step that was not
+ * run yet. A step writes its commands into its own output buffers. When all
+ * steps are done, those buffers are appended to fpre and fpost in the step
+ * order. Hence, the output is the same as running the steps one after the
+ * other.
+ */
+static void
+runSteps(PGconn *c1, PGconn *c2)
+{
+	QuarrelWorker	*workers;
+	char			*snapshot1;
+	char			*snapshot2;
+	int				nworkers;
+	int				i;
+#if defined(_WINDOWS)
+	HANDLE			*threads;
+#else
+	pthread_t		*threads;
+#endif
+
+	/* both sides use the same connection while dumping a catalog */
+	if (c1 == c2)
+	{
+		for (i = 0; i < nsteps; i++)
+			steps[i].run();
+		return;
+	}
+
+	/* results of cloned connections are not recorded */
+	if (options.jobs > 1 && (isCatalogDump(c1) || isCatalogDump(c2)))
+	{
+		logDebug("ignoring jobs because catalog cache will be refreshed");
+		options.jobs = 1;
+	}
+
+	/* snapshot export is new in 9.2 */
+	if (options.jobs > 1 && ((!isCatalogFile(c1) && PQserverVersion(c1) < 90200) ||
+							 (!isCatalogFile(c2) && PQserverVersion(c2) < 90200)))
+	{
+		logWarning("ignoring jobs because server does not support snapshot export");
+		options.jobs = 1;
+	}
+	if (options.jobs > 1 && !PQisthreadsafe())
+	{
+		logWarning("ignoring jobs because libpq is not thread-safe");
+		options.jobs = 1;
+	}
+
+	if (options.jobs <= 1 || nsteps <= 1)
+	{
+		for (i = 0; i < nsteps; i++)
+			steps[i].run();
+		return;
+	}
+
+	nworkers = (options.jobs < nsteps) ? options.jobs : nsteps;
+
+	logDebug("running %d steps using %d workers", nsteps, nworkers);
+
+	for (i = 0; i < nsteps; i++)
+	{
+		char	path[PGQMAXPATH];
+
+		snprintf(path, PGQMAXPATH, "%s/quarrel.%d.%d.pre", options.tmpdir,
+				 getpid(), i);
+		openOutputBuffer(&steps[i].pre, path);
+		snprintf(path, PGQMAXPATH, "%s/quarrel.%d.%d.post", options.tmpdir,
+				 getpid(), i);
+		openOutputBuffer(&steps[i].post, path);
+	}
+
+	/*
+	 * all connections use the same snapshot (c1 and c2 are already in a
+	 * repeatable read transaction)
+	 */
+	snapshot1 = isCatalogFile(c1) ? NULL : exportSnapshot(c1);
+	snapshot2 = isCatalogFile(c2) ? NULL : exportSnapshot(c2);
+
+	workers = (QuarrelWorker *) malloc(nworkers * sizeof(QuarrelWorker));
+	memset(workers, 0, nworkers * sizeof(QuarrelWorker));
+	for (i = 0; i < nworkers; i++)
+	{
+		workers[i].comments1 = curcomments1;
+		workers[i].comments2 = curcomments2;
+		workers[i].seclabels1 = curseclabels1;
+		workers[i].seclabels2 = curseclabels2;
+	}
+
+	/* first worker uses the connections that exported the snapshots */
+	workers[0].conn1 = c1;
+	workers[0].conn2 = c2;
+	for (i = 1; i < nworkers; i++)
+	{
+		/* catalog files are shared by all workers */
+		if (isCatalogFile(c1))
+			workers[i].conn1 = c1;
+		else
+		{
+			workers[i].conn1 = cloneConnection(c1);
+			beginSnapshotTransaction(workers[i].conn1, snapshot1);
+		}
+		if (isCatalogFile(c2))
+			workers[i].conn2 = c2;
+		else
+		{
+			workers[i].conn2 = cloneConnection(c2);
+			beginSnapshotTransaction(workers[i].conn2, snapshot2);
+		}
+	}
+
+	nextstep = 0;
+#if defined(_WINDOWS)
+	InitializeCriticalSection(&worklock);
+	threads = (HANDLE *) malloc(nworkers * sizeof(HANDLE));
+	for (i = 1; i < nworkers; i++)
+	{
+		threads[i] = (HANDLE) _beginthreadex(NULL, 0, workerThread, &workers[i], 0,
+											 NULL);
+		if (threads[i] == 0)
+		{
+			logError("could not create worker thread");
+			exit(EXIT_FAILURE);
+		}
+	}
+#else
+	threads = (pthread_t *) malloc(nworkers * sizeof(pthread_t));
+	for (i = 1; i < nworkers; i++)
+	{
+		if (pthread_create(&threads[i], NULL, workerThread, &workers[i]) != 0)
+		{
+			logError("could not create worker thread");
+			exit(EXIT_FAILURE);
+		}
+	}
+#endif
+
+	/* this thread is also a worker */
+	runWorker(&workers[0]);
+
+	for (i = 1; i < nworkers; i++)
+	{
+#if defined(_WINDOWS)
+		WaitForSingleObject(threads[i], INFINITE);
+		CloseHandle(threads[i]);
+#else
+		pthread_join(threads[i], NULL);
+#endif
+		if (workers[i].conn1 != c1)
+			PQfinish(workers[i].conn1);
+		if (workers[i].conn2 != c2)
+			PQfinish(workers[i].conn2);
+	}
+#if defined(_WINDOWS)
+	DeleteCriticalSection(&worklock);
+#endif
+
+	/* restore connections and statistics of this thread */
+	conn1 = c1;
+	conn2 = c2;
+	for (i = 0; i < nworkers; i++)
+	{
+		addStatistics(&qstat, &workers[i].qstat);
+		costexceeded += workers[i].costexceeded;
+	}
+
+	/* gather commands in the step order */
+	for (i = 0; i < nsteps; i++)
+	{
+		appendOutputBuffer(&steps[i].pre, bpre);
+		appendOutputBuffer(&steps[i].post, bpost);
+		closeOutputBuffer(&steps[i].pre);
+		closeOutputBuffer(&steps[i].post);
+	}
+
+	free(threads);
+	free(workers);
+	if (snapshot1)
+		free(snapshot1);
+	if (snapshot2)
+		free(snapshot2);
+}
+
+/*
+ * Run steps until there is no step left. Global variables used by the
+ * comparison steps (connections, output streams and statistics) are thread
+ * local; set them to this worker.
+ */
+static void
+runWorker(QuarrelWorker *w)
+{
+	FILE			*savepre = fpre;
+	FILE			*savepost = fpost;
+	PQLOutputBuffer	*savebpre = bpre;
+	PQLOutputBuffer	*savebpost = bpost;
+	PQLComments		*savecomments1 = curcomments1;
+	PQLComments		*savecomments2 = curcomments2;
+	PQLSecLabels	*saveseclabels1 = curseclabels1;
+	PQLSecLabels	*saveseclabels2 = curseclabels2;
+	PQLStatistic	saveqstat = qstat;
+	int				saveversion1 = pgversion1;
+	int				saveversion2 = pgversion2;
+	int				savecostexceeded = costexceeded;
+
+	conn1 = w->conn1;
+	conn2 = w->conn2;
+	curcomments1 = w->comments1;
+	curcomments2 = w->comments2;
+	curseclabels1 = w->seclabels1;
+	curseclabels2 = w->seclabels2;
+	pgversion1 = getServerVersion(conn1);
+	pgversion2 = getServerVersion(conn2);
+	memset(&qstat, 0, sizeof(PQLStatistic));
+	costexceeded = 0;
+
+	for (;;)
+	{
+		int		i;
+
+#if defined(_WINDOWS)
+		EnterCriticalSection(&worklock);
+		i = nextstep++;
+		LeaveCriticalSection(&worklock);
+#else
+		pthread_mutex_lock(&worklock);
+		i = nextstep++;
+		pthread_mutex_unlock(&worklock);
+#endif
+
+		if (i >= nsteps)
+			break;
+
+		logDebug("running step %d", i);
+
+		bpre = &steps[i].pre;
+		bpost = &steps[i].post;
+		fpre = bpre->fp;
+		fpost = bpost->fp;
+		steps[i].run();
+	}
+
+	w->qstat = qstat;
+	w->costexceeded = costexceeded;
+
+	curcomments1 = savecomments1;
+	curcomments2 = savecomments2;
+	curseclabels1 = saveseclabels1;
+	curseclabels2 = saveseclabels2;
+	fpre = savepre;
+	fpost = savepost;
+	bpre = savebpre;
+	bpost = savebpost;
+	qstat = saveqstat;
+	pgversion1 = saveversion1;
+	pgversion2 = saveversion2;
+	costexceeded = savecostexceeded;
+}
+
+#if defined(_WINDOWS)
+static unsigned __stdcall
+workerThread(void *arg)
+{
+	runWorker((QuarrelWorker *) arg);
+	freeArena(&arena1);
+	freeArena(&arena2);
+	freeNameTable(&nametable);
+
+	return 0;
+}
+#else
+static void *
+workerThread(void *arg)
+{
+	runWorker((QuarrelWorker *) arg);
+	freeArena(&arena1);
+	freeArena(&arena2);
+	freeNameTable(&nametable);
+
+	return NULL;
+}
+#endif
+
+/*
+ * Compare source with each fan-out target. Up to --jobs targets are compared
+ * at the same time; each worker takes the next target that was not compared
+ * yet and runs all steps for it. Source must be a catalog file so the source
+ * objects are loaded from memory and can be shared by all workers.
+ */
+static void
+runTargets(PGconn *source, QuarrelTargetOptions *t, int n)
+{
+	int				nworkers;
+	int				i;
+#if defined(_WINDOWS)
+	HANDLE			*threads;
+#else
+	pthread_t		*threads;
+#endif
+
+	targets = (QuarrelTarget *) malloc(n * sizeof(QuarrelTarget));
+	if (targets == NULL)
+	{
+		logError("could not allocate memory");
+		exit(EXIT_FAILURE);
+	}
+	memset(targets, 0, n * sizeof(QuarrelTarget));
+	for (i = 0; i < n; i++)
+		targets[i].opt = &t[i];
+	ntargets = n;
+	nexttarget = 0;
+	fanoutsource = source;
+
+	nworkers = (options.jobs < ntargets) ? options.jobs : ntargets;
+	if (nworkers > 1 && !PQisthreadsafe())
+	{
+		logWarning("ignoring jobs because libpq is not thread-safe");
+		nworkers = 1;
+	}
+
+	logDebug("comparing %d targets using %d workers", ntargets, nworkers);
+
+#if defined(_WINDOWS)
+	InitializeCriticalSection(&worklock);
+	threads = (HANDLE *) malloc(nworkers * sizeof(HANDLE));
+	for (i = 1; i < nworkers; i++)
+	{
+		threads[i] = (HANDLE) _beginthreadex(NULL, 0, targetThread, NULL, 0, NULL);
+		if (threads[i] == 0)
+		{
+			logError("could not create worker thread");
+			exit(EXIT_FAILURE);
+		}
+	}
+#else
+	threads = (pthread_t *) malloc(nworkers * sizeof(pthread_t));
+	for (i = 1; i < nworkers; i++)
+	{
+		if (pthread_create(&threads[i], NULL, targetThread, NULL) != 0)
+		{
+			logError("could not create worker thread");
+			exit(EXIT_FAILURE);
+		}
+	}
+#endif
+
+	/* this thread is also a worker */
+	runTargetWorker();
+
+	for (i = 1; i < nworkers; i++)
+	{
+#if defined(_WINDOWS)
+		WaitForSingleObject(threads[i], INFINITE);
+		CloseHandle(threads[i]);
+#else
+		pthread_join(threads[i], NULL);
+#endif
+	}
+#if defined(_WINDOWS)
+	DeleteCriticalSection(&worklock);
+#endif
+
+	for (i = 0; i < ntargets; i++)
+	{
+		if (targets[i].costexceeded > 0)
+			logError("target %s: %d commands exceed cost-threshold",
+					 targets[i].opt->name, targets[i].costexceeded);
+		costexceeded += targets[i].costexceeded;
+	}
+
+	if (options.summary)
+	{
+		PQLStatistic	saveqstat = qstat;
+
+		for (i = 0; i < ntargets; i++)
+		{
+			fprintf(stderr, "target %s:\n", targets[i].opt->name);
+			qstat = targets[i].qstat;
+			printSummary();
+		}
+		qstat = saveqstat;
+	}
+
+	free(threads);
+	free(targets);
+	targets = NULL;
+	ntargets = 0;
+}
+
+/*
+ * Compare targets until there is no target left. Like runWorker, save and
+ * restore the thread local variables of this thread.
+ */
+static void
+runTargetWorker(void)
+{
+	PGconn			*saveconn1 = conn1;
+	PGconn			*saveconn2 = conn2;
+	PQLComments		*savecomments1 = curcomments1;
+	PQLComments		*savecomments2 = curcomments2;
+	PQLSecLabels	*saveseclabels1 = curseclabels1;
+	PQLSecLabels	*saveseclabels2 = curseclabels2;
+	FILE			*savepre = fpre;
+	FILE			*savepost = fpost;
+	PQLOutputBuffer	*savebpre = bpre;
+	PQLOutputBuffer	*savebpost = bpost;
+	PQLStatistic	saveqstat = qstat;
+	int				saveversion1 = pgversion1;
+	int				saveversion2 = pgversion2;
+	int				savecostexceeded = costexceeded;
+
+	for (;;)
+	{
+		int		i;
+
+#if defined(_WINDOWS)
+		EnterCriticalSection(&worklock);
+		i = nexttarget++;
+		LeaveCriticalSection(&worklock);
+#else
+		pthread_mutex_lock(&worklock);
+		i = nexttarget++;
+		pthread_mutex_unlock(&worklock);
+#endif
+
+		if (i >= ntargets)
+			break;
+
+		compareTarget(i);
+	}
+
+	conn1 = saveconn1;
+	conn2 = saveconn2;
+	curcomments1 = savecomments1;
+	curcomments2 = savecomments2;
+	curseclabels1 = saveseclabels1;
+	curseclabels2 = saveseclabels2;
+	fpre = savepre;
+	fpost = savepost;
+	bpre = savebpre;
+	bpost = savebpost;
+	qstat = saveqstat;
+	pgversion1 = saveversion1;
+	pgversion2 = saveversion2;
+	costexceeded = savecostexceeded;
+}
+
+#if defined(_WINDOWS)
+static unsigned __stdcall
+targetThread(void *arg)
+{
+	runTargetWorker();
+	freeArena(&arena1);
+	freeArena(&arena2);
+	freeNameTable(&nametable);
+
+	return 0;
+}
+#else
+static void *
+targetThread(void *arg)
+{
+	runTargetWorker();
+	freeArena(&arena1);
+	freeArena(&arena2);
+	freeNameTable(&nametable);
+
+	return NULL;
+}
+#endif
+
+/*
+ * Run all steps comparing the source with target n. Commands are written into
+ * the output file of that target.
+ */
+static void
+compareTarget(int n)
+{
+	QuarrelTarget	*t = &targets[n];
+	FILE			*output;
+	PQLOutputBuffer	tpre;
+	PQLOutputBuffer	tpost;
+	PQLDependencies	tdepend = {NULL, 0, NULL, 0};
+	PQLComments		tcomments = {NULL, NULL, 0};
+	PQLSecLabels	tseclabels = {NULL, NULL, 0};
+	char			path[PGQMAXPATH];
+	char			*dir = NULL;
+	int				version;
+	int				i;
+
+	logDebug("comparing target %s", t->opt->name);
+
+	conn1 = connectDatabase(t->opt->db);
+	conn2 = fanoutsource;
+
+	version = getServerVersion(conn1);
+	if (version < PGQ_SUPPORTED)
+	{
+		const char *serverversion = getServerVersionString(conn1);
+		logError("target %s: postgresql version %s is not supported (requires %s)",
+				 t->opt->name, serverversion ? serverversion : "'unknown'",
+				 PGQ_SUPPORTED_STR);
+		closeConnection(conn1);
+		exit(EXIT_FAILURE);
+	}
+	if (!options.ignoreversion && compareMajorVersion(version, PG_VERSION_NUM) > 0)
+	{
+		logError("target %s: cannot connect to server whose version (%s) is greater than postgres version (%s) used to compile pgquarrel",
+				 t->opt->name, getServerVersionString(conn1), PG_VERSION);
+		closeConnection(conn1);
+		exit(EXIT_FAILURE);
+	}
+	if (getServerVersion(conn2) < version)
+		logWarning("target %s: unsupported syntax could be dumped while comparing server (%d) with server (%d)",
+				   t->opt->name, version, getServerVersion(conn2));
+
+	beginSnapshotTransaction(conn1, NULL);
+
+	pgversion1 = version;
+	pgversion2 = getServerVersion(conn2);
+
+	/* source comments and security labels were loaded by main */
+	if (options.comment)
+		getComments(conn1, &tcomments);
+	if (options.securitylabels)
+		getSecLabels(conn1, &tseclabels);
+	curcomments1 = &tcomments;
+	curcomments2 = &comments2;
+	curseclabels1 = &tseclabels;
+	curseclabels2 = &seclabels2;
+
+	snprintf(path, PGQMAXPATH, "%s/quarrel.%d.target%d.pre", options.tmpdir,
+			 getpid(), n);
+	openOutputBuffer(&tpre, path);
+	snprintf(path, PGQMAXPATH, "%s/quarrel.%d.target%d.post", options.tmpdir,
+			 getpid(), n);
+	openOutputBuffer(&tpost, path);
+	bpre = &tpre;
+	bpost = &tpost;
+	fpre = tpre.fp;
+	fpost = tpost.fp;
+	memset(&qstat, 0, sizeof(PQLStatistic));
+	costexceeded = 0;
+
+	for (i = 0; i < nsteps; i++)
+		steps[i].run();
+
+	/* source dependencies were loaded by main */
+	if (options.dependencyorder)
+		getDependencies(conn1, &tdepend);
+
+	output = fopen(t->opt->output, "w");
+	if (output == NULL)
+	{
+		logError("could not open output file \"%s\"", t->opt->output);
+		exit(EXIT_FAILURE);
+	}
+
+	/* waves of each target are written into a subdirectory */
+	if (options.paralleldir)
+		dir = psprintf("%s/%s", options.paralleldir, t->opt->name);
+
+	writeChanges(output, dir, &tpre, &tpost, &tdepend, &depend2);
+
+	if (dir)
+		pfree(dir);
+
+	if (fclose(output) != 0)
+	{
+		logError("could not close output file \"%s\": %s", t->opt->output,
+				 strerror(errno));
+		exit(EXIT_FAILURE);
+	}
+
+	closeOutputBuffer(&tpre);
+	closeOutputBuffer(&tpost);
+	freeDependencies(&tdepend);
+	freeComments(&tcomments);
+	freeSecLabels(&tseclabels);
+	closeConnection(conn1);
+
+	t->qstat = qstat;
+	t->costexceeded = costexceeded;
+
+	logDebug("target %s: changes written to \"%s\"", t->opt->name,
+			 t->opt->output);
+}
+
+/*
+ * Write the commands of pre and post into output. With dependency-order,
+ * commands are sorted using the dependencies of server 1 (d1) and server 2
+ * (d2); see sortOutputBuffer. If dir is not NULL, the commands are also
+ * written as waves into that directory (see writeOutputWaves).
+ */
+static void
+writeChanges(FILE *output, const char *dir, PQLOutputBuffer *pre,
+			 PQLOutputBuffer *post, PQLDependencies *d1, PQLDependencies *d2)
+{
+	bool	empty;
+	int		npre = 0;
+
+	/*
+	 * Print header iff there is at least one command. Check if one of the
+	 * buffers is not empty.
+	 */
+	empty = (isEmptyOutputBuffer(pre) && isEmptyOutputBuffer(post));
+	if (!empty)
+	{
+		fprintf(output, "--\n-- pgquarrel %s\n", PGQ_VERSION);
+		fprintf(output, "-- quarrel between %s and %s\n",
+				getServerVersionString(conn1), getServerVersionString(conn2));
+		fprintf(output, "--");
+	}
+
+	/* execute as a single transaction */
+	if (options.singletxn && !empty)
+		fprintf(output, "\n\nBEGIN;");
+
+	if (options.dependencyorder && !empty)
+	{
+		npre = sortOutputBuffer(pre, false, d1, d2);
+		sortOutputBuffer(post, true, d1, d2);
+	}
+
+	/* dump the quarrel in the right order */
+	writeOutputBuffers(pre, post, output);
+
+	/* close single transaction */
+	if (options.singletxn && !empty)
+		fprintf(output, "\n\nCOMMIT;");
+
+	if (dir)
+		writeOutputWaves(pre, npre, post, dir);
+}
+
+/*
+ * Add statistics b to a. PQLStatistic is a list of counters.
+ */
+static void
+addStatistics(PQLStatistic *a, PQLStatistic *b)
+{
+	int		*x = (int *) a;
+	int		*y = (int *) b;
+	int		i;
+
+	for (i = 0; i < (int) (sizeof(PQLStatistic) / sizeof(int)); i++)
+		x[i] += y[i];
+}
+
+/*
+ * Thread entry point: run the fetch routine for one server.
+ */
+#if defined(_WINDOWS)
+static unsigned __stdcall
+fetchThread(void *arg)
+{
+	QuarrelFetch	*f = (QuarrelFetch *) arg;
+
+	setCurrentArena(f->arena);
+	setCurrentNameTable(f->names);
+	setCurrentComments(f->comments);
+	setCurrentSecLabels(f->seclabels);
+	f->fetch(f);
+	setCurrentArena(NULL);
+	setCurrentNameTable(NULL);
+	setCurrentComments(NULL);
+	setCurrentSecLabels(NULL);
+
+	return 0;
+}
+#else
+static void *
+fetchThread(void *arg)
+{
+	QuarrelFetch	*f = (QuarrelFetch *) arg;
+
+	setCurrentArena(f->arena);
+	setCurrentNameTable(f->names);
+	setCurrentComments(f->comments);
+	setCurrentSecLabels(f->seclabels);
+	f->fetch(f);
+	setCurrentArena(NULL);
+	setCurrentNameTable(NULL);
+	setCurrentComments(NULL);
+	setCurrentSecLabels(NULL);
+
+	return NULL;
+}
+#endif
+
+/*
+ * Run fetch routine for both servers. Server2 objects are fetched by another
+ * thread while server1 objects are fetched by this one; it returns only when
+ * both are ready. Hence, the elapsed time is about the slowest server instead
+ * of the sum of both. If libpq is not thread-safe or a thread cannot be
+ * created, servers are fetched one after the other.
+ */
+static void
+fetchObjects(void (*fetch) (QuarrelFetch *f), QuarrelFetch *f1,
+			 QuarrelFetch *f2)
+{
+#if defined(_WINDOWS)
+	HANDLE		thread = 0;
+#else
+	pthread_t	thread;
+#endif
+	bool		concurrent = false;
+
+	initNameTable(&nametable);
+
+	f1->conn = conn1;
+	f1->arena = &arena1;
+	f1->names = &nametable;
+	f1->comments = curcomments1;
+	f1->seclabels = curseclabels1;
+	f1->fetch = fetch;
+	f2->conn = conn2;
+	f2->arena = &arena2;
+	f2->names = &nametable;
+	f2->comments = curcomments2;
+	f2->seclabels = curseclabels2;
+	f2->fetch = fetch;
+
+	/* both sides use the same connection while dumping a catalog */
+	if (PQisthreadsafe() && conn1 != conn2)
+	{
+#if defined(_WINDOWS)
+		thread = (HANDLE) _beginthreadex(NULL, 0, fetchThread, f2, 0, NULL);
+		concurrent = (thread != 0);
+#else
+		concurrent = (pthread_create(&thread, NULL, fetchThread, f2) == 0);
+#endif
+		if (!concurrent)
+			logWarning("could not create thread; fetching servers serially");
+	}
+
+	setCurrentArena(f1->arena);
+	setCurrentNameTable(&nametable);
+	setCurrentComments(f1->comments);
+	setCurrentSecLabels(f1->seclabels);
+	fetch(f1);
+
+	if (concurrent)
+	{
+#if defined(_WINDOWS)
+		WaitForSingleObject(thread, INFINITE);
+		CloseHandle(thread);
+#else
+		pthread_join(thread, NULL);
+#endif
+	}
+	else
+	{
+		setCurrentArena(f2->arena);
+		setCurrentComments(f2->comments);
+		setCurrentSecLabels(f2->seclabels);
+		fetch(f2);
+	}
+	setCurrentArena(NULL);
+	setCurrentNameTable(NULL);
+	setCurrentComments(NULL);
+	setCurrentSecLabels(NULL);
+
+	/* merge loops compare names by their ordinals */
+	sortNameTable(&nametable);
+}
+
+static void
+fetchAccessMethods(QuarrelFetch *f)
+{
+	f->objects = getAccessMethods(f->conn, &f->nobjects);
+}
+
 static void
 quarrelAccessMethods()
 {
@@ -843,9 +2162,13 @@ quarrelAccessMethods()
 	int			nams1 = 0;		/* # of ams */
 	int			nams2 = 0;
 	int			i, j;
+	QuarrelFetch	f1, f2;
 
-	ams1 = getAccessMethods(conn1, &nams1);
-	ams2 = getAccessMethods(conn2, &nams2);
+	fetchObjects(fetchAccessMethods, &f1, &f2);
+	ams1 = f1.objects;
+	nams1 = f1.nobjects;
+	ams2 = f2.objects;
+	nams2 = f2.nobjects;
 
 	for (i = 0; i < nams1; i++)
 		logNoise("server1: %s", ams1[i].amname);
@@ -867,6 +2190,7 @@ quarrelAccessMethods()
 		{
 			logDebug("am %s: server2", ams2[j].amname);
 
+			markOutputBuffer(bpre, 2, PGQ_CLASS_AM, ams2[j].oid);
 			dumpCreateAccessMethod(fpre, &ams2[j]);
 
 			j++;
@@ -877,6 +2201,7 @@ quarrelAccessMethods()
 		{
 			logDebug("am %s: server1", ams1[i].amname);
 
+			markOutputBuffer(bpost, 1, PGQ_CLASS_AM, ams1[i].oid);
 			dumpDropAccessMethod(fpost, &ams1[i]);
 
 			i++;
@@ -887,6 +2212,7 @@ quarrelAccessMethods()
 		{
 			logDebug("am %s: server1 server2", ams1[i].amname);
 
+			markOutputBuffer(bpre, 2, PGQ_CLASS_AM, ams2[j].oid);
 			dumpAlterAccessMethod(fpre, &ams1[i], &ams2[j]);
 
 			i++;
@@ -896,6 +2222,7 @@ quarrelAccessMethods()
 		{
 			logDebug("am %s: server1", ams1[i].amname);
 
+			markOutputBuffer(bpost, 1, PGQ_CLASS_AM, ams1[i].oid);
 			dumpDropAccessMethod(fpost, &ams1[i]);
 
 			i++;
@@ -905,6 +2232,7 @@ quarrelAccessMethods()
 		{
 			logDebug("am %s: server2", ams2[j].amname);
 
+			markOutputBuffer(bpre, 2, PGQ_CLASS_AM, ams2[j].oid);
 			dumpCreateAccessMethod(fpre, &ams2[j]);
 
 			j++;
@@ -912,8 +2240,20 @@ quarrelAccessMethods()
 		}
 	}
 
-	freeAccessMethods(ams1, nams1);
-	freeAccessMethods(ams2, nams2);
+	resetArena(&arena1);
+	resetArena(&arena2);
+}
+
+static void
+fetchAggregates(QuarrelFetch *f)
+{
+	PQLAggregate	*aggregates;
+
+	aggregates = getAggregates(f->conn, &f->nobjects);
+	if (options.securitylabels)
+		getAggregateSecurityLabels(f->conn, aggregates, f->nobjects);
+
+	f->objects = aggregates;
 }
 
 static void
@@ -924,9 +2264,13 @@ quarrelAggregates()
 	int				naggregates1 = 0;		/* # of aggregates */
 	int				naggregates2 = 0;
 	int				i, j;
+	QuarrelFetch	f1, f2;
 
-	aggregates1 = getAggregates(conn1, &naggregates1);
-	aggregates2 = getAggregates(conn2, &naggregates2);
+	fetchObjects(fetchAggregates, &f1, &f2);
+	aggregates1 = f1.objects;
+	naggregates1 = f1.nobjects;
+	aggregates2 = f2.objects;
+	naggregates2 = f2.nobjects;
 
 	for (i = 0; i < naggregates1; i++)
 		logNoise("server1: %s.%s(%s)", aggregates1[i].obj.schemaname,
@@ -951,9 +2295,7 @@ quarrelAggregates()
 			logDebug("aggregate %s.%s(%s): server2", aggregates2[j].obj.schemaname,
 					 aggregates2[j].obj.objectname, aggregates2[j].arguments);
 
-			if (options.securitylabels)
-				getAggregateSecurityLabels(conn2, &aggregates2[j]);
-
+			markOutputBuffer(bpre, 2, PGQ_CLASS_PROC, aggregates2[j].obj.oid);
 			dumpCreateAggregate(fpre, &aggregates2[j]);
 
 			j++;
@@ -965,6 +2307,7 @@ quarrelAggregates()
 			logDebug("aggregate %s.%s(%s): server1", aggregates1[i].obj.schemaname,
 					 aggregates1[i].obj.objectname, aggregates1[i].arguments);
 
+			markOutputBuffer(bpost, 1, PGQ_CLASS_PROC, aggregates1[i].obj.oid);
 			dumpDropAggregate(fpost, &aggregates1[i]);
 
 			i++;
@@ -973,14 +2316,9 @@ quarrelAggregates()
 		else if (compareAggregates(&aggregates1[i], &aggregates2[j]) == 0)
 		{
 			logDebug("aggregate %s.%s(%s): server1 server2", aggregates1[i].obj.schemaname,
-					 aggregates1[i].obj.objectname, aggregates1[i].arguments);
-
-			if (options.securitylabels)
-			{
-				getAggregateSecurityLabels(conn1, &aggregates1[i]);
-				getAggregateSecurityLabels(conn2, &aggregates2[j]);
-			}
+					 aggregates1[i].obj.objectname, aggregates1[i].arguments);
 
+			markOutputBuffer(bpre, 2, PGQ_CLASS_PROC, aggregates2[j].obj.oid);
 			dumpAlterAggregate(fpre, &aggregates1[i], &aggregates2[j]);
 
 			i++;
@@ -991,6 +2329,7 @@ quarrelAggregates()
 			logDebug("aggregate %s.%s(%s): server1", aggregates1[i].obj.schemaname,
 					 aggregates1[i].obj.objectname, aggregates1[i].arguments);
 
+			markOutputBuffer(bpost, 1, PGQ_CLASS_PROC, aggregates1[i].obj.oid);
 			dumpDropAggregate(fpost, &aggregates1[i]);
 
 			i++;
@@ -1001,9 +2340,7 @@ quarrelAggregates()
 			logDebug("aggregate %s.%s(%s): server2", aggregates2[j].obj.schemaname,
 					 aggregates2[j].obj.objectname, aggregates2[j].arguments);
 
-			if (options.securitylabels)
-				getAggregateSecurityLabels(conn2, &aggregates2[j]);
-
+			markOutputBuffer(bpre, 2, PGQ_CLASS_PROC, aggregates2[j].obj.oid);
 			dumpCreateAggregate(fpre, &aggregates2[j]);
 
 			j++;
@@ -1011,8 +2348,14 @@ quarrelAggregates()
 		}
 	}
 
-	freeAggregates(aggregates1, naggregates1);
-	freeAggregates(aggregates2, naggregates2);
+	resetArena(&arena1);
+	resetArena(&arena2);
+}
+
+static void
+fetchCasts(QuarrelFetch *f)
+{
+	f->objects = getCasts(f->conn, &f->nobjects);
 }
 
 static void
@@ -1023,10 +2366,14 @@ quarrelCasts()
 	int			ncasts1 = 0;		/* # of casts */
 	int			ncasts2 = 0;
 	int			i, j;
+	QuarrelFetch	f1, f2;
 
 	/* Casts */
-	casts1 = getCasts(conn1, &ncasts1);
-	casts2 = getCasts(conn2, &ncasts2);
+	fetchObjects(fetchCasts, &f1, &f2);
+	casts1 = f1.objects;
+	ncasts1 = f1.nobjects;
+	casts2 = f2.objects;
+	ncasts2 = f2.nobjects;
 
 	for (i = 0; i < ncasts1; i++)
 		logNoise("server1: cast %s AS %s", casts1[i].source, casts1[i].target);
@@ -1048,6 +2395,7 @@ quarrelCasts()
 		{
 			logDebug("cast %s AS %s: server2", casts2[j].source, casts2[j].target);
 
+			markOutputBuffer(bpre, 2, PGQ_CLASS_CAST, casts2[j].oid);
 			dumpCreateCast(fpre, &casts2[j]);
 
 			j++;
@@ -1058,6 +2406,7 @@ quarrelCasts()
 		{
 			logDebug("cast %s AS %s: server1", casts1[i].source, casts1[i].target);
 
+			markOutputBuffer(bpost, 1, PGQ_CLASS_CAST, casts1[i].oid);
 			dumpDropCast(fpost, &casts1[i]);
 
 			i++;
@@ -1067,6 +2416,7 @@ quarrelCasts()
 		{
 			logDebug("cast %s AS %s: server1 server2", casts1[i].source, casts1[i].target);
 
+			markOutputBuffer(bpre, 2, PGQ_CLASS_CAST, casts2[j].oid);
 			dumpAlterCast(fpre, &casts1[i], &casts2[j]);
 
 			i++;
@@ -1076,6 +2426,7 @@ quarrelCasts()
 		{
 			logDebug("cast %s AS %s: server1", casts1[i].source, casts1[i].target);
 
+			markOutputBuffer(bpost, 1, PGQ_CLASS_CAST, casts1[i].oid);
 			dumpDropCast(fpost, &casts1[i]);
 
 			i++;
@@ -1085,6 +2436,7 @@ quarrelCasts()
 		{
 			logDebug("cast %s AS %s: server2", casts2[j].source, casts2[j].target);
 
+			markOutputBuffer(bpre, 2, PGQ_CLASS_CAST, casts2[j].oid);
 			dumpCreateCast(fpre, &casts2[j]);
 
 			j++;
@@ -1092,8 +2444,14 @@ quarrelCasts()
 		}
 	}
 
-	freeCasts(casts1, ncasts1);
-	freeCasts(casts2, ncasts2);
+	resetArena(&arena1);
+	resetArena(&arena2);
+}
+
+static void
+fetchCollations(QuarrelFetch *f)
+{
+	f->objects = getCollations(f->conn, &f->nobjects);
 }
 
 static void
@@ -1104,10 +2462,14 @@ quarrelCollations()
 	int			ncollations1 = 0;			/* # of collations */
 	int			ncollations2 = 0;
 	int			i, j;
+	QuarrelFetch	f1, f2;
 
 	/* Collations */
-	collations1 = getCollations(conn1, &ncollations1);
-	collations2 = getCollations(conn2, &ncollations2);
+	fetchObjects(fetchCollations, &f1, &f2);
+	collations1 = f1.objects;
+	ncollations1 = f1.nobjects;
+	collations2 = f2.objects;
+	ncollations2 = f2.nobjects;
 
 	for (i = 0; i < ncollations1; i++)
 		logNoise("server1: %s.%s", collations1[i].obj.schemaname,
@@ -1132,6 +2494,7 @@ quarrelCollations()
 			logDebug("collation %s.%s: server2", collations2[j].obj.schemaname,
 					 collations2[j].obj.objectname);
 
+			markOutputBuffer(bpre, 2, PGQ_CLASS_COLLATION, collations2[j].obj.oid);
 			dumpCreateCollation(fpre, &collations2[j]);
 
 			j++;
@@ -1143,6 +2506,7 @@ quarrelCollations()
 			logDebug("collation %s.%s: server1", collations1[i].obj.schemaname,
 					 collations1[i].obj.objectname);
 
+			markOutputBuffer(bpost, 1, PGQ_CLASS_COLLATION, collations1[i].obj.oid);
 			dumpDropCollation(fpost, &collations1[i]);
 
 			i++;
@@ -1153,6 +2517,7 @@ quarrelCollations()
 			logDebug("collation %s.%s: server1 server2", collations1[i].obj.schemaname,
 					 collations1[i].obj.objectname);
 
+			markOutputBuffer(bpre, 2, PGQ_CLASS_COLLATION, collations2[j].obj.oid);
 			dumpAlterCollation(fpre, &collations1[i], &collations2[j]);
 
 			i++;
@@ -1163,6 +2528,7 @@ quarrelCollations()
 			logDebug("collation %s.%s: server1", collations1[i].obj.schemaname,
 					 collations1[i].obj.objectname);
 
+			markOutputBuffer(bpost, 1, PGQ_CLASS_COLLATION, collations1[i].obj.oid);
 			dumpDropCollation(fpost, &collations1[i]);
 
 			i++;
@@ -1173,6 +2539,7 @@ quarrelCollations()
 			logDebug("collation %s.%s: server2", collations2[j].obj.schemaname,
 					 collations2[j].obj.objectname);
 
+			markOutputBuffer(bpre, 2, PGQ_CLASS_COLLATION, collations2[j].obj.oid);
 			dumpCreateCollation(fpre, &collations2[j]);
 
 			j++;
@@ -1180,8 +2547,14 @@ quarrelCollations()
 		}
 	}
 
-	freeCollations(collations1, ncollations1);
-	freeCollations(collations2, ncollations2);
+	resetArena(&arena1);
+	resetArena(&arena2);
+}
+
+static void
+fetchConversions(QuarrelFetch *f)
+{
+	f->objects = getConversions(f->conn, &f->nobjects);
 }
 
 static void
@@ -1192,9 +2565,13 @@ quarrelConversions()
 	int				nconversions1 = 0;		/* # of conversions */
 	int				nconversions2 = 0;
 	int				i, j;
+	QuarrelFetch	f1, f2;
 
-	conversions1 = getConversions(conn1, &nconversions1);
-	conversions2 = getConversions(conn2, &nconversions2);
+	fetchObjects(fetchConversions, &f1, &f2);
+	conversions1 = f1.objects;
+	nconversions1 = f1.nobjects;
+	conversions2 = f2.objects;
+	nconversions2 = f2.nobjects;
 
 	for (i = 0; i < nconversions1; i++)
 		logNoise("server1: %s.%s %u", conversions1[i].obj.schemaname,
@@ -1219,6 +2596,7 @@ quarrelConversions()
 			logDebug("conversion %s.%s: server2", conversions2[j].obj.schemaname,
 					 conversions2[j].obj.objectname);
 
+			markOutputBuffer(bpre, 2, PGQ_CLASS_CONVERSION, conversions2[j].obj.oid);
 			dumpCreateConversion(fpre, &conversions2[j]);
 
 			j++;
@@ -1230,6 +2608,7 @@ quarrelConversions()
 			logDebug("conversion %s.%s: server1", conversions1[i].obj.schemaname,
 					 conversions1[i].obj.objectname);
 
+			markOutputBuffer(bpost, 1, PGQ_CLASS_CONVERSION, conversions1[i].obj.oid);
 			dumpDropConversion(fpost, &conversions1[i]);
 
 			i++;
@@ -1240,6 +2619,7 @@ quarrelConversions()
 			logDebug("conversion %s.%s: server1 server2", conversions1[i].obj.schemaname,
 					 conversions1[i].obj.objectname);
 
+			markOutputBuffer(bpre, 2, PGQ_CLASS_CONVERSION, conversions2[j].obj.oid);
 			dumpAlterConversion(fpre, &conversions1[i], &conversions2[j]);
 
 			i++;
@@ -1250,6 +2630,7 @@ quarrelConversions()
 			logDebug("conversion %s.%s: server1", conversions1[i].obj.schemaname,
 					 conversions1[i].obj.objectname);
 
+			markOutputBuffer(bpost, 1, PGQ_CLASS_CONVERSION, conversions1[i].obj.oid);
 			dumpDropConversion(fpost, &conversions1[i]);
 
 			i++;
@@ -1260,6 +2641,7 @@ quarrelConversions()
 			logDebug("conversion %s.%s: server2", conversions2[j].obj.schemaname,
 					 conversions2[j].obj.objectname);
 
+			markOutputBuffer(bpre, 2, PGQ_CLASS_CONVERSION, conversions2[j].obj.oid);
 			dumpCreateConversion(fpre, &conversions2[j]);
 
 			j++;
@@ -1267,8 +2649,21 @@ quarrelConversions()
 		}
 	}
 
-	freeConversions(conversions1, nconversions1);
-	freeConversions(conversions2, nconversions2);
+	resetArena(&arena1);
+	resetArena(&arena2);
+}
+
+static void
+fetchDomains(QuarrelFetch *f)
+{
+	PQLDomain	*domains;
+
+	domains = getDomains(f->conn, &f->nobjects);
+	getDomainConstraints(f->conn, domains, f->nobjects);
+	if (options.securitylabels)
+		getDomainSecurityLabels(f->conn, domains, f->nobjects);
+
+	f->objects = domains;
 }
 
 static void
@@ -1279,10 +2674,14 @@ quarrelDomains()
 	int			ndomains1 = 0;		/* # of domains */
 	int			ndomains2 = 0;
 	int			i, j;
+	QuarrelFetch	f1, f2;
 
 	/* Domains */
-	domains1 = getDomains(conn1, &ndomains1);
-	domains2 = getDomains(conn2, &ndomains2);
+	fetchObjects(fetchDomains, &f1, &f2);
+	domains1 = f1.objects;
+	ndomains1 = f1.nobjects;
+	domains2 = f2.objects;
+	ndomains2 = f2.nobjects;
 
 	for (i = 0; i < ndomains1; i++)
 		logNoise("server1: %s.%s", domains1[i].obj.schemaname,
@@ -1307,10 +2706,7 @@ quarrelDomains()
 			logDebug("domain %s.%s: server2", domains2[j].obj.schemaname,
 					 domains2[j].obj.objectname);
 
-			getDomainConstraints(conn2, &domains2[j]);
-			if (options.securitylabels)
-				getDomainSecurityLabels(conn2, &domains2[j]);
-
+			markOutputBuffer(bpre, 2, PGQ_CLASS_TYPE, domains2[j].obj.oid);
 			dumpCreateDomain(fpre, &domains2[j]);
 
 			j++;
@@ -1322,6 +2718,7 @@ quarrelDomains()
 			logDebug("domain %s.%s: server1", domains1[i].obj.schemaname,
 					 domains1[i].obj.objectname);
 
+			markOutputBuffer(bpost, 1, PGQ_CLASS_TYPE, domains1[i].obj.oid);
 			dumpDropDomain(fpost, &domains1[i]);
 
 			i++;
@@ -1332,14 +2729,7 @@ quarrelDomains()
 			logDebug("domain %s.%s: server1 server2", domains1[i].obj.schemaname,
 					 domains1[i].obj.objectname);
 
-			getDomainConstraints(conn1, &domains1[i]);
-			getDomainConstraints(conn2, &domains2[j]);
-			if (options.securitylabels)
-			{
-				getDomainSecurityLabels(conn1, &domains1[i]);
-				getDomainSecurityLabels(conn2, &domains2[j]);
-			}
-
+			markOutputBuffer(bpre, 2, PGQ_CLASS_TYPE, domains2[j].obj.oid);
 			dumpAlterDomain(fpre, &domains1[i], &domains2[j]);
 
 			i++;
@@ -1350,6 +2740,7 @@ quarrelDomains()
 			logDebug("domain %s.%s: server1", domains1[i].obj.schemaname,
 					 domains1[i].obj.objectname);
 
+			markOutputBuffer(bpost, 1, PGQ_CLASS_TYPE, domains1[i].obj.oid);
 			dumpDropDomain(fpost, &domains1[i]);
 
 			i++;
@@ -1360,10 +2751,7 @@ quarrelDomains()
 			logDebug("domain %s.%s: server2", domains2[j].obj.schemaname,
 					 domains2[j].obj.objectname);
 
-			getDomainConstraints(conn2, &domains2[j]);
-			if (options.securitylabels)
-				getDomainSecurityLabels(conn2, &domains2[j]);
-
+			markOutputBuffer(bpre, 2, PGQ_CLASS_TYPE, domains2[j].obj.oid);
 			dumpCreateDomain(fpre, &domains2[j]);
 
 			j++;
@@ -1371,8 +2759,20 @@ quarrelDomains()
 		}
 	}
 
-	freeDomains(domains1, ndomains1);
-	freeDomains(domains2, ndomains2);
+	resetArena(&arena1);
+	resetArena(&arena2);
+}
+
+static void
+fetchEventTriggers(QuarrelFetch *f)
+{
+	PQLEventTrigger	*evttrgs;
+
+	evttrgs = getEventTriggers(f->conn, &f->nobjects);
+	if (options.securitylabels)
+		getEventTriggerSecurityLabels(f->conn, evttrgs, f->nobjects);
+
+	f->objects = evttrgs;
 }
 
 static void
@@ -1383,9 +2783,13 @@ quarrelEventTriggers()
 	int			nevttrgs1 = 0;		/* # of evttrgs */
 	int			nevttrgs2 = 0;
 	int			i, j;
+	QuarrelFetch	f1, f2;
 
-	evttrgs1 = getEventTriggers(conn1, &nevttrgs1);
-	evttrgs2 = getEventTriggers(conn2, &nevttrgs2);
+	fetchObjects(fetchEventTriggers, &f1, &f2);
+	evttrgs1 = f1.objects;
+	nevttrgs1 = f1.nobjects;
+	evttrgs2 = f2.objects;
+	nevttrgs2 = f2.nobjects;
 
 	for (i = 0; i < nevttrgs1; i++)
 		logNoise("server1: %s", evttrgs1[i].trgname);
@@ -1407,9 +2811,7 @@ quarrelEventTriggers()
 		{
 			logDebug("event trigger %s: server2", evttrgs2[j].trgname);
 
-			if (options.securitylabels)
-				getEventTriggerSecurityLabels(conn2, &evttrgs2[j]);
-
+			markOutputBuffer(bpre, 2, PGQ_CLASS_EVENT_TRIGGER, evttrgs2[j].oid);
 			dumpCreateEventTrigger(fpre, &evttrgs2[j]);
 
 			j++;
@@ -1420,6 +2822,7 @@ quarrelEventTriggers()
 		{
 			logDebug("event trigger %s: server1", evttrgs1[i].trgname);
 
+			markOutputBuffer(bpost, 1, PGQ_CLASS_EVENT_TRIGGER, evttrgs1[i].oid);
 			dumpDropEventTrigger(fpost, &evttrgs1[i]);
 
 			i++;
@@ -1429,12 +2832,7 @@ quarrelEventTriggers()
 		{
 			logDebug("event trigger %s: server1 server2", evttrgs1[i].trgname);
 
-			if (options.securitylabels)
-			{
-				getEventTriggerSecurityLabels(conn1, &evttrgs1[i]);
-				getEventTriggerSecurityLabels(conn2, &evttrgs2[j]);
-			}
-
+			markOutputBuffer(bpre, 2, PGQ_CLASS_EVENT_TRIGGER, evttrgs2[j].oid);
 			dumpAlterEventTrigger(fpre, &evttrgs1[i], &evttrgs2[j]);
 
 			i++;
@@ -1444,6 +2842,7 @@ quarrelEventTriggers()
 		{
 			logDebug("event trigger %s: server1", evttrgs1[i].trgname);
 
+			markOutputBuffer(bpost, 1, PGQ_CLASS_EVENT_TRIGGER, evttrgs1[i].oid);
 			dumpDropEventTrigger(fpost, &evttrgs1[i]);
 
 			i++;
@@ -1453,9 +2852,7 @@ quarrelEventTriggers()
 		{
 			logDebug("event trigger %s: server2", evttrgs2[j].trgname);
 
-			if (options.securitylabels)
-				getEventTriggerSecurityLabels(conn2, &evttrgs2[j]);
-
+			markOutputBuffer(bpre, 2, PGQ_CLASS_EVENT_TRIGGER, evttrgs2[j].oid);
 			dumpCreateEventTrigger(fpre, &evttrgs2[j]);
 
 			j++;
@@ -1463,8 +2860,14 @@ quarrelEventTriggers()
 		}
 	}
 
-	freeEventTriggers(evttrgs1, nevttrgs1);
-	freeEventTriggers(evttrgs2, nevttrgs2);
+	resetArena(&arena1);
+	resetArena(&arena2);
+}
+
+static void
+fetchExtensions(QuarrelFetch *f)
+{
+	f->objects = getExtensions(f->conn, &f->nobjects);
 }
 
 static void
@@ -1475,9 +2878,13 @@ quarrelExtensions()
 	int			nextensions1 = 0;		/* # of extensions */
 	int			nextensions2 = 0;
 	int			i, j;
+	QuarrelFetch	f1, f2;
 
-	extensions1 = getExtensions(conn1, &nextensions1);
-	extensions2 = getExtensions(conn2, &nextensions2);
+	fetchObjects(fetchExtensions, &f1, &f2);
+	extensions1 = f1.objects;
+	nextensions1 = f1.nobjects;
+	extensions2 = f2.objects;
+	nextensions2 = f2.nobjects;
 
 	for (i = 0; i < nextensions1; i++)
 		logNoise("server1: %s", extensions1[i].extensionname);
@@ -1499,6 +2906,7 @@ quarrelExtensions()
 		{
 			logDebug("extension %s: server2", extensions2[j].extensionname);
 
+			markOutputBuffer(bpre, 2, PGQ_CLASS_EXTENSION, extensions2[j].oid);
 			dumpCreateExtension(fpre, &extensions2[j]);
 
 			j++;
@@ -1509,6 +2917,7 @@ quarrelExtensions()
 		{
 			logDebug("extension %s: server1", extensions1[i].extensionname);
 
+			markOutputBuffer(bpost, 1, PGQ_CLASS_EXTENSION, extensions1[i].oid);
 			dumpDropExtension(fpost, &extensions1[i]);
 
 			i++;
@@ -1519,6 +2928,7 @@ quarrelExtensions()
 		{
 			logDebug("extension %s: server1 server2", extensions1[i].extensionname);
 
+			markOutputBuffer(bpre, 2, PGQ_CLASS_EXTENSION, extensions2[j].oid);
 			dumpAlterExtension(fpre, &extensions1[i], &extensions2[j]);
 
 			i++;
@@ -1528,6 +2938,7 @@ quarrelExtensions()
 		{
 			logDebug("extension %s: server1", extensions1[i].extensionname);
 
+			markOutputBuffer(bpost, 1, PGQ_CLASS_EXTENSION, extensions1[i].oid);
 			dumpDropExtension(fpost, &extensions1[i]);
 
 			i++;
@@ -1537,6 +2948,7 @@ quarrelExtensions()
 		{
 			logDebug("extension %s: server2", extensions2[j].extensionname);
 
+			markOutputBuffer(bpre, 2, PGQ_CLASS_EXTENSION, extensions2[j].oid);
 			dumpCreateExtension(fpre, &extensions2[j]);
 
 			j++;
@@ -1544,8 +2956,14 @@ quarrelExtensions()
 		}
 	}
 
-	freeExtensions(extensions1, nextensions1);
-	freeExtensions(extensions2, nextensions2);
+	resetArena(&arena1);
+	resetArena(&arena2);
+}
+
+static void
+fetchForeignDataWrappers(QuarrelFetch *f)
+{
+	f->objects = getForeignDataWrappers(f->conn, &f->nobjects);
 }
 
 static void
@@ -1556,9 +2974,13 @@ quarrelForeignDataWrappers()
 	int			nfdws1 = 0;		/* # of fdws */
 	int			nfdws2 = 0;
 	int			i, j;
+	QuarrelFetch	f1, f2;
 
-	fdws1 = getForeignDataWrappers(conn1, &nfdws1);
-	fdws2 = getForeignDataWrappers(conn2, &nfdws2);
+	fetchObjects(fetchForeignDataWrappers, &f1, &f2);
+	fdws1 = f1.objects;
+	nfdws1 = f1.nobjects;
+	fdws2 = f2.objects;
+	nfdws2 = f2.nobjects;
 
 	for (i = 0; i < nfdws1; i++)
 		logNoise("server1: %s", fdws1[i].fdwname);
@@ -1580,6 +3002,7 @@ quarrelForeignDataWrappers()
 		{
 			logDebug("fdw %s: server2", fdws2[j].fdwname);
 
+			markOutputBuffer(bpre, 2, PGQ_CLASS_FOREIGN_DATA_WRAPPER, fdws2[j].oid);
 			dumpCreateForeignDataWrapper(fpre, &fdws2[j]);
 
 			j++;
@@ -1590,6 +3013,7 @@ quarrelForeignDataWrappers()
 		{
 			logDebug("fdw %s: server1", fdws1[i].fdwname);
 
+			markOutputBuffer(bpost, 1, PGQ_CLASS_FOREIGN_DATA_WRAPPER, fdws1[i].oid);
 			dumpDropForeignDataWrapper(fpost, &fdws1[i]);
 
 			i++;
@@ -1600,6 +3024,7 @@ quarrelForeignDataWrappers()
 		{
 			logDebug("fdw %s: server1 server2", fdws1[i].fdwname);
 
+			markOutputBuffer(bpre, 2, PGQ_CLASS_FOREIGN_DATA_WRAPPER, fdws2[j].oid);
 			dumpAlterForeignDataWrapper(fpre, &fdws1[i], &fdws2[j]);
 
 			i++;
@@ -1609,6 +3034,7 @@ quarrelForeignDataWrappers()
 		{
 			logDebug("fdw %s: server1", fdws1[i].fdwname);
 
+			markOutputBuffer(bpost, 1, PGQ_CLASS_FOREIGN_DATA_WRAPPER, fdws1[i].oid);
 			dumpDropForeignDataWrapper(fpost, &fdws1[i]);
 
 			i++;
@@ -1618,6 +3044,7 @@ quarrelForeignDataWrappers()
 		{
 			logDebug("fdw %s: server2", fdws2[j].fdwname);
 
+			markOutputBuffer(bpre, 2, PGQ_CLASS_FOREIGN_DATA_WRAPPER, fdws2[j].oid);
 			dumpCreateForeignDataWrapper(fpre, &fdws2[j]);
 
 			j++;
@@ -1625,8 +3052,14 @@ quarrelForeignDataWrappers()
 		}
 	}
 
-	freeForeignDataWrappers(fdws1, nfdws1);
-	freeForeignDataWrappers(fdws2, nfdws2);
+	resetArena(&arena1);
+	resetArena(&arena2);
+}
+
+static void
+fetchForeignServers(QuarrelFetch *f)
+{
+	f->objects = getForeignServers(f->conn, &f->nobjects);
 }
 
 static void
@@ -1637,9 +3070,13 @@ quarrelForeignServers()
 	int			nservers1 = 0;		/* # of servers */
 	int			nservers2 = 0;
 	int			i, j;
+	QuarrelFetch	f1, f2;
 
-	servers1 = getForeignServers(conn1, &nservers1);
-	servers2 = getForeignServers(conn2, &nservers2);
+	fetchObjects(fetchForeignServers, &f1, &f2);
+	servers1 = f1.objects;
+	nservers1 = f1.nobjects;
+	servers2 = f2.objects;
+	nservers2 = f2.nobjects;
 
 	for (i = 0; i < nservers1; i++)
 		logNoise("server1: %s", servers1[i].servername);
@@ -1661,6 +3098,7 @@ quarrelForeignServers()
 		{
 			logDebug("server %s: server2", servers2[j].servername);
 
+			markOutputBuffer(bpre, 2, PGQ_CLASS_FOREIGN_SERVER, servers2[j].oid);
 			dumpCreateForeignServer(fpre, &servers2[j]);
 
 			j++;
@@ -1671,6 +3109,7 @@ quarrelForeignServers()
 		{
 			logDebug("server %s: server1", servers1[i].servername);
 
+			markOutputBuffer(bpost, 1, PGQ_CLASS_FOREIGN_SERVER, servers1[i].oid);
 			dumpDropForeignServer(fpost, &servers1[i]);
 
 			i++;
@@ -1681,6 +3120,7 @@ quarrelForeignServers()
 		{
 			logDebug("server %s: server1 server2", servers1[i].servername);
 
+			markOutputBuffer(bpre, 2, PGQ_CLASS_FOREIGN_SERVER, servers2[j].oid);
 			dumpAlterForeignServer(fpre, &servers1[i], &servers2[j]);
 
 			i++;
@@ -1690,6 +3130,7 @@ quarrelForeignServers()
 		{
 			logDebug("server %s: server1", servers1[i].servername);
 
+			markOutputBuffer(bpost, 1, PGQ_CLASS_FOREIGN_SERVER, servers1[i].oid);
 			dumpDropForeignServer(fpost, &servers1[i]);
 
 			i++;
@@ -1699,6 +3140,7 @@ quarrelForeignServers()
 		{
 			logDebug("server %s: server2", servers2[j].servername);
 
+			markOutputBuffer(bpre, 2, PGQ_CLASS_FOREIGN_SERVER, servers2[j].oid);
 			dumpCreateForeignServer(fpre, &servers2[j]);
 
 			j++;
@@ -1706,8 +3148,20 @@ quarrelForeignServers()
 		}
 	}
 
-	freeForeignServers(servers1, nservers1);
-	freeForeignServers(servers2, nservers2);
+	resetArena(&arena1);
+	resetArena(&arena2);
+}
+
+static void
+fetchFunctions(QuarrelFetch *f)
+{
+	PQLFunction	*functions;
+
+	functions = getFunctions(f->conn, &f->nobjects);
+	if (options.securitylabels)
+		getFunctionSecurityLabels(f->conn, functions, f->nobjects);
+
+	f->objects = functions;
 }
 
 static void
@@ -1718,9 +3172,13 @@ quarrelFunctions()
 	int			nfunctions1 = 0;		/* # of functions */
 	int			nfunctions2 = 0;
 	int			i, j;
+	QuarrelFetch	f1, f2;
 
-	functions1 = getFunctions(conn1, &nfunctions1);
-	functions2 = getFunctions(conn2, &nfunctions2);
+	fetchObjects(fetchFunctions, &f1, &f2);
+	functions1 = f1.objects;
+	nfunctions1 = f1.nobjects;
+	functions2 = f2.objects;
+	nfunctions2 = f2.nobjects;
 
 	for (i = 0; i < nfunctions1; i++)
 		logNoise("server1: %s.%s(%s) %s", functions1[i].obj.schemaname,
@@ -1732,6 +3190,11 @@ quarrelFunctions()
 				 functions2[i].obj.objectname, functions2[i].arguments,
 				 functions2[i].returntype);
 
+	if (options.privileges && options.schemagrants)
+		findObjectSchemaGrants(PGQ_FUNCTION, functions1, nfunctions1,
+							   functions2, nfunctions2, sizeof(PQLFunction),
+							   offsetof(PQLFunction, acl), compareFunctionObjects);
+
 	/*
 	 * We have two sorted lists. Let's figure out which elements are not in the
 	 * other list.
@@ -1747,9 +3210,7 @@ quarrelFunctions()
 			logDebug("function %s.%s(%s): server2", functions2[j].obj.schemaname,
 					 functions2[j].obj.objectname, functions2[j].arguments);
 
-			if (options.securitylabels)
-				getFunctionSecurityLabels(conn2, &functions2[j]);
-
+			markOutputBuffer(bpre, 2, PGQ_CLASS_PROC, functions2[j].obj.oid);
 			dumpCreateFunction(fpre, &functions2[j], false);
 
 			j++;
@@ -1761,6 +3222,7 @@ quarrelFunctions()
 			logDebug("function %s.%s(%s): server1", functions1[i].obj.schemaname,
 					 functions1[i].obj.objectname, functions1[i].arguments);
 
+			markOutputBuffer(bpost, 1, PGQ_CLASS_PROC, functions1[i].obj.oid);
 			dumpDropFunction(fpost, &functions1[i]);
 
 			i++;
@@ -1771,16 +3233,11 @@ quarrelFunctions()
 			logDebug("function %s.%s(%s): server1 server2", functions1[i].obj.schemaname,
 					 functions1[i].obj.objectname, functions1[i].arguments);
 
-			if (options.securitylabels)
-			{
-				getFunctionSecurityLabels(conn1, &functions1[i]);
-				getFunctionSecurityLabels(conn2, &functions2[j]);
-			}
-
 			/*
 			 * When we change return type we have to recreate the function
 			 * because there is no ALTER FUNCTION command for it.
 			 */
+			markOutputBuffer(bpre, 2, PGQ_CLASS_PROC, functions2[j].obj.oid);
 			if (strcmp(functions1[i].returntype, functions2[j].returntype) == 0)
 				dumpAlterFunction(fpre, &functions1[i], &functions2[j]);
 			else
@@ -1797,6 +3254,7 @@ quarrelFunctions()
 			logDebug("function %s.%s(%s): server1", functions1[i].obj.schemaname,
 					 functions1[i].obj.objectname, functions1[i].arguments);
 
+			markOutputBuffer(bpost, 1, PGQ_CLASS_PROC, functions1[i].obj.oid);
 			dumpDropFunction(fpost, &functions1[i]);
 
 			i++;
@@ -1807,9 +3265,7 @@ quarrelFunctions()
 			logDebug("function %s.%s(%s): server2", functions2[j].obj.schemaname,
 					 functions2[j].obj.objectname, functions2[j].arguments);
 
-			if (options.securitylabels)
-				getFunctionSecurityLabels(conn2, &functions2[j]);
-
+			markOutputBuffer(bpre, 2, PGQ_CLASS_PROC, functions2[j].obj.oid);
 			dumpCreateFunction(fpre, &functions2[j], false);
 
 			j++;
@@ -1817,8 +3273,22 @@ quarrelFunctions()
 		}
 	}
 
-	freeFunctions(functions1, nfunctions1);
-	freeFunctions(functions2, nfunctions2);
+	/* after every function is created */
+	if (options.privileges && options.schemagrants)
+	{
+		markOutputBuffer(bpost, 0, InvalidOid, InvalidOid);
+		dumpSchemaGrants(fpost);
+		resetSchemaGrants();
+	}
+
+	resetArena(&arena1);
+	resetArena(&arena2);
+}
+
+static void
+fetchIndexes(QuarrelFetch *f)
+{
+	f->objects = getIndexes(f->conn, &f->nobjects);
 }
 
 static void
@@ -1829,9 +3299,13 @@ quarrelIndexes()
 	int			nindexes1 = 0;		/* # of indexes */
 	int			nindexes2 = 0;
 	int			i, j;
+	QuarrelFetch	f1, f2;
 
-	indexes1 = getIndexes(conn1, &nindexes1);
-	indexes2 = getIndexes(conn2, &nindexes2);
+	fetchObjects(fetchIndexes, &f1, &f2);
+	indexes1 = f1.objects;
+	nindexes1 = f1.nobjects;
+	indexes2 = f2.objects;
+	nindexes2 = f2.nobjects;
 
 	for (i = 0; i < nindexes1; i++)
 		logNoise("server1: %s.%s", indexes1[i].obj.schemaname,
@@ -1856,6 +3330,7 @@ quarrelIndexes()
 			logDebug("index %s.%s: server2", indexes2[j].obj.schemaname,
 					 indexes2[j].obj.objectname);
 
+			markOutputBuffer(bpre, 2, PGQ_CLASS_CLASS, indexes2[j].obj.oid);
 			dumpCreateIndex(fpre, &indexes2[j]);
 
 			j++;
@@ -1867,6 +3342,7 @@ quarrelIndexes()
 			logDebug("index %s.%s: server1", indexes1[i].obj.schemaname,
 					 indexes1[i].obj.objectname);
 
+			markOutputBuffer(bpost, 1, PGQ_CLASS_CLASS, indexes1[i].obj.oid);
 			dumpDropIndex(fpost, &indexes1[i]);
 
 			i++;
@@ -1877,6 +3353,7 @@ quarrelIndexes()
 			logDebug("index %s.%s: server1 server2", indexes1[i].obj.schemaname,
 					 indexes1[i].obj.objectname);
 
+			markOutputBuffer(bpre, 2, PGQ_CLASS_CLASS, indexes2[j].obj.oid);
 			dumpAlterIndex(fpre, &indexes1[i], &indexes2[j]);
 
 			i++;
@@ -1887,6 +3364,7 @@ quarrelIndexes()
 			logDebug("index %s.%s: server1", indexes1[i].obj.schemaname,
 					 indexes1[i].obj.objectname);
 
+			markOutputBuffer(bpost, 1, PGQ_CLASS_CLASS, indexes1[i].obj.oid);
 			dumpDropIndex(fpost, &indexes1[i]);
 
 			i++;
@@ -1897,6 +3375,7 @@ quarrelIndexes()
 			logDebug("index %s.%s: server2", indexes2[j].obj.schemaname,
 					 indexes2[j].obj.objectname);
 
+			markOutputBuffer(bpre, 2, PGQ_CLASS_CLASS, indexes2[j].obj.oid);
 			dumpCreateIndex(fpre, &indexes2[j]);
 
 			j++;
@@ -1904,8 +3383,20 @@ quarrelIndexes()
 		}
 	}
 
-	freeIndexes(indexes1, nindexes1);
-	freeIndexes(indexes2, nindexes2);
+	resetArena(&arena1);
+	resetArena(&arena2);
+}
+
+static void
+fetchLanguages(QuarrelFetch *f)
+{
+	PQLLanguage	*languages;
+
+	languages = getLanguages(f->conn, &f->nobjects);
+	if (options.securitylabels)
+		getLanguageSecurityLabels(f->conn, languages, f->nobjects);
+
+	f->objects = languages;
 }
 
 static void
@@ -1916,9 +3407,13 @@ quarrelLanguages()
 	int			nlanguages1 = 0;		/* # of languages */
 	int			nlanguages2 = 0;
 	int			i, j;
+	QuarrelFetch	f1, f2;
 
-	languages1 = getLanguages(conn1, &nlanguages1);
-	languages2 = getLanguages(conn2, &nlanguages2);
+	fetchObjects(fetchLanguages, &f1, &f2);
+	languages1 = f1.objects;
+	nlanguages1 = f1.nobjects;
+	languages2 = f2.objects;
+	nlanguages2 = f2.nobjects;
 
 	for (i = 0; i < nlanguages1; i++)
 		logNoise("server1: %s", languages1[i].languagename);
@@ -1940,9 +3435,7 @@ quarrelLanguages()
 		{
 			logDebug("language %s: server2", languages2[j].languagename);
 
-			if (options.securitylabels)
-				getLanguageSecurityLabels(conn2, &languages2[j]);
-
+			markOutputBuffer(bpre, 2, PGQ_CLASS_LANGUAGE, languages2[j].oid);
 			dumpCreateLanguage(fpre, &languages2[j]);
 
 			j++;
@@ -1953,6 +3446,7 @@ quarrelLanguages()
 		{
 			logDebug("language %s: server1", languages1[i].languagename);
 
+			markOutputBuffer(bpost, 1, PGQ_CLASS_LANGUAGE, languages1[i].oid);
 			dumpDropLanguage(fpost, &languages1[i]);
 
 			i++;
@@ -1962,12 +3456,7 @@ quarrelLanguages()
 		{
 			logDebug("language %s: server1 server2", languages1[i].languagename);
 
-			if (options.securitylabels)
-			{
-				getLanguageSecurityLabels(conn1, &languages1[i]);
-				getLanguageSecurityLabels(conn2, &languages2[j]);
-			}
-
+			markOutputBuffer(bpre, 2, PGQ_CLASS_LANGUAGE, languages2[j].oid);
 			dumpAlterLanguage(fpre, &languages1[i], &languages2[j]);
 
 			i++;
@@ -1977,6 +3466,7 @@ quarrelLanguages()
 		{
 			logDebug("language %s: server1", languages1[i].languagename);
 
+			markOutputBuffer(bpost, 1, PGQ_CLASS_LANGUAGE, languages1[i].oid);
 			dumpDropLanguage(fpost, &languages1[i]);
 
 			i++;
@@ -1986,9 +3476,7 @@ quarrelLanguages()
 		{
 			logDebug("language %s: server2", languages2[j].languagename);
 
-			if (options.securitylabels)
-				getLanguageSecurityLabels(conn2, &languages2[j]);
-
+			markOutputBuffer(bpre, 2, PGQ_CLASS_LANGUAGE, languages2[j].oid);
 			dumpCreateLanguage(fpre, &languages2[j]);
 
 			j++;
@@ -1996,8 +3484,21 @@ quarrelLanguages()
 		}
 	}
 
-	freeLanguages(languages1, nlanguages1);
-	freeLanguages(languages2, nlanguages2);
+	resetArena(&arena1);
+	resetArena(&arena2);
+}
+
+static void
+fetchMaterializedViews(QuarrelFetch *f)
+{
+	PQLMaterializedView	*matviews;
+
+	matviews = getMaterializedViews(f->conn, &f->nobjects);
+	getMaterializedViewAttributes(f->conn, matviews, f->nobjects);
+	if (options.securitylabels)
+		getMaterializedViewSecurityLabels(f->conn, matviews, f->nobjects);
+
+	f->objects = matviews;
 }
 
 static void
@@ -2008,9 +3509,13 @@ quarrelMaterializedViews()
 	int			nmatviews1 = 0;		/* # of matviews */
 	int			nmatviews2 = 0;
 	int			i, j;
+	QuarrelFetch	f1, f2;
 
-	matviews1 = getMaterializedViews(conn1, &nmatviews1);
-	matviews2 = getMaterializedViews(conn2, &nmatviews2);
+	fetchObjects(fetchMaterializedViews, &f1, &f2);
+	matviews1 = f1.objects;
+	nmatviews1 = f1.nobjects;
+	matviews2 = f2.objects;
+	nmatviews2 = f2.nobjects;
 
 	for (i = 0; i < nmatviews1; i++)
 		logNoise("server1: %s.%s", matviews1[i].obj.schemaname,
@@ -2035,10 +3540,7 @@ quarrelMaterializedViews()
 			logDebug("materialized view %s.%s: server2", matviews2[j].obj.schemaname,
 					 matviews2[j].obj.objectname);
 
-			getMaterializedViewAttributes(conn2, &matviews2[j]);
-			if (options.securitylabels)
-				getMaterializedViewSecurityLabels(conn2, &matviews2[j]);
-
+			markOutputBuffer(bpre, 2, PGQ_CLASS_CLASS, matviews2[j].obj.oid);
 			dumpCreateMaterializedView(fpre, &matviews2[j]);
 
 			j++;
@@ -2050,6 +3552,7 @@ quarrelMaterializedViews()
 			logDebug("materialized view %s.%s: server1", matviews1[i].obj.schemaname,
 					 matviews1[i].obj.objectname);
 
+			markOutputBuffer(bpost, 1, PGQ_CLASS_CLASS, matviews1[i].obj.oid);
 			dumpDropMaterializedView(fpost, &matviews1[i]);
 
 			i++;
@@ -2061,14 +3564,7 @@ quarrelMaterializedViews()
 					 matviews1[i].obj.schemaname,
 					 matviews1[i].obj.objectname);
 
-			getMaterializedViewAttributes(conn1, &matviews1[i]);
-			getMaterializedViewAttributes(conn2, &matviews2[j]);
-			if (options.securitylabels)
-			{
-				getMaterializedViewSecurityLabels(conn1, &matviews1[i]);
-				getMaterializedViewSecurityLabels(conn2, &matviews2[j]);
-			}
-
+			markOutputBuffer(bpre, 2, PGQ_CLASS_CLASS, matviews2[j].obj.oid);
 			dumpAlterMaterializedView(fpre, &matviews1[i], &matviews2[j]);
 
 			i++;
@@ -2079,6 +3575,7 @@ quarrelMaterializedViews()
 			logDebug("materialized view %s.%s: server1", matviews1[i].obj.schemaname,
 					 matviews1[i].obj.objectname);
 
+			markOutputBuffer(bpost, 1, PGQ_CLASS_CLASS, matviews1[i].obj.oid);
 			dumpDropMaterializedView(fpost, &matviews1[i]);
 
 			i++;
@@ -2089,10 +3586,7 @@ quarrelMaterializedViews()
 			logDebug("materialized view %s.%s: server2", matviews2[j].obj.schemaname,
 					 matviews2[j].obj.objectname);
 
-			getMaterializedViewAttributes(conn2, &matviews2[j]);
-			if (options.securitylabels)
-				getMaterializedViewSecurityLabels(conn2, &matviews2[j]);
-
+			markOutputBuffer(bpre, 2, PGQ_CLASS_CLASS, matviews2[j].obj.oid);
 			dumpCreateMaterializedView(fpre, &matviews2[j]);
 
 			j++;
@@ -2100,8 +3594,14 @@ quarrelMaterializedViews()
 		}
 	}
 
-	freeMaterializedViews(matviews1, nmatviews1);
-	freeMaterializedViews(matviews2, nmatviews2);
+	resetArena(&arena1);
+	resetArena(&arena2);
+}
+
+static void
+fetchOperators(QuarrelFetch *f)
+{
+	f->objects = getOperators(f->conn, &f->nobjects);
 }
 
 static void
@@ -2112,9 +3612,13 @@ quarrelOperators()
 	int			noperators1 = 0;		/* # of operators */
 	int			noperators2 = 0;
 	int			i, j;
+	QuarrelFetch	f1, f2;
 
-	operators1 = getOperators(conn1, &noperators1);
-	operators2 = getOperators(conn2, &noperators2);
+	fetchObjects(fetchOperators, &f1, &f2);
+	operators1 = f1.objects;
+	noperators1 = f1.nobjects;
+	operators2 = f2.objects;
+	noperators2 = f2.nobjects;
 
 	for (i = 0; i < noperators1; i++)
 		logNoise("server1: %s.%s", operators1[i].obj.schemaname,
@@ -2139,6 +3643,7 @@ quarrelOperators()
 			logDebug("operator %s.%s: server2", operators2[j].obj.schemaname,
 					 operators2[j].obj.objectname);
 
+			markOutputBuffer(bpre, 2, PGQ_CLASS_OPERATOR, operators2[j].obj.oid);
 			dumpCreateOperator(fpre, &operators2[j]);
 
 			j++;
@@ -2150,6 +3655,7 @@ quarrelOperators()
 			logDebug("operator %s.%s: server1", operators1[i].obj.schemaname,
 					 operators1[i].obj.objectname);
 
+			markOutputBuffer(bpost, 1, PGQ_CLASS_OPERATOR, operators1[i].obj.oid);
 			dumpDropOperator(fpost, &operators1[i]);
 
 			i++;
@@ -2160,6 +3666,7 @@ quarrelOperators()
 			logDebug("operator %s.%s: server1 server2", operators1[i].obj.schemaname,
 					 operators1[i].obj.objectname);
 
+			markOutputBuffer(bpre, 2, PGQ_CLASS_OPERATOR, operators2[j].obj.oid);
 			dumpAlterOperator(fpre, &operators1[i], &operators2[j]);
 
 			i++;
@@ -2170,6 +3677,7 @@ quarrelOperators()
 			logDebug("operator %s.%s: server1", operators1[i].obj.schemaname,
 					 operators1[i].obj.objectname);
 
+			markOutputBuffer(bpost, 1, PGQ_CLASS_OPERATOR, operators1[i].obj.oid);
 			dumpDropOperator(fpost, &operators1[i]);
 
 			i++;
@@ -2180,6 +3688,7 @@ quarrelOperators()
 			logDebug("operator %s.%s: server2", operators2[j].obj.schemaname,
 					 operators2[j].obj.objectname);
 
+			markOutputBuffer(bpre, 2, PGQ_CLASS_OPERATOR, operators2[j].obj.oid);
 			dumpCreateOperator(fpre, &operators2[j]);
 
 			j++;
@@ -2187,8 +3696,14 @@ quarrelOperators()
 		}
 	}
 
-	freeOperators(operators1, noperators1);
-	freeOperators(operators2, noperators2);
+	resetArena(&arena1);
+	resetArena(&arena2);
+}
+
+static void
+fetchOperatorFamilies(QuarrelFetch *f)
+{
+	f->objects = getOperatorFamilies(f->conn, &f->nobjects);
 }
 
 static void
@@ -2199,9 +3714,13 @@ quarrelOperatorFamilies()
 	int			nopfamilies1 = 0;					/* # of opfamilies */
 	int			nopfamilies2 = 0;
 	int			i, j;
+	QuarrelFetch	f1, f2;
 
-	opfamilies1 = getOperatorFamilies(conn1, &nopfamilies1);
-	opfamilies2 = getOperatorFamilies(conn2, &nopfamilies2);
+	fetchObjects(fetchOperatorFamilies, &f1, &f2);
+	opfamilies1 = f1.objects;
+	nopfamilies1 = f1.nobjects;
+	opfamilies2 = f2.objects;
+	nopfamilies2 = f2.nobjects;
 
 	for (i = 0; i < nopfamilies1; i++)
 		logNoise("server1: %s.%s", opfamilies1[i].obj.schemaname,
@@ -2226,6 +3745,7 @@ quarrelOperatorFamilies()
 			logDebug("operator family %s.%s: server2", opfamilies2[j].obj.schemaname,
 					 opfamilies2[j].obj.objectname);
 
+			markOutputBuffer(bpre, 2, PGQ_CLASS_OPFAMILY, opfamilies2[j].obj.oid);
 			dumpCreateOperatorFamily(fpre, &opfamilies2[j]);
 
 			j++;
@@ -2237,6 +3757,7 @@ quarrelOperatorFamilies()
 			logDebug("operator family %s.%s: server1", opfamilies1[i].obj.schemaname,
 					 opfamilies1[i].obj.objectname);
 
+			markOutputBuffer(bpost, 1, PGQ_CLASS_OPFAMILY, opfamilies1[i].obj.oid);
 			dumpDropOperatorFamily(fpost, &opfamilies1[i]);
 
 			i++;
@@ -2248,6 +3769,7 @@ quarrelOperatorFamilies()
 					 opfamilies1[i].obj.schemaname,
 					 opfamilies1[i].obj.objectname);
 
+			markOutputBuffer(bpre, 2, PGQ_CLASS_OPFAMILY, opfamilies2[j].obj.oid);
 			dumpAlterOperatorFamily(fpre, &opfamilies1[i], &opfamilies2[j]);
 
 			i++;
@@ -2258,6 +3780,7 @@ quarrelOperatorFamilies()
 			logDebug("operator family %s.%s: server1", opfamilies1[i].obj.schemaname,
 					 opfamilies1[i].obj.objectname);
 
+			markOutputBuffer(bpost, 1, PGQ_CLASS_OPFAMILY, opfamilies1[i].obj.oid);
 			dumpDropOperatorFamily(fpost, &opfamilies1[i]);
 
 			i++;
@@ -2268,6 +3791,7 @@ quarrelOperatorFamilies()
 			logDebug("operator family %s.%s: server2", opfamilies2[j].obj.schemaname,
 					 opfamilies2[j].obj.objectname);
 
+			markOutputBuffer(bpre, 2, PGQ_CLASS_OPFAMILY, opfamilies2[j].obj.oid);
 			dumpCreateOperatorFamily(fpre, &opfamilies2[j]);
 
 			j++;
@@ -2275,8 +3799,14 @@ quarrelOperatorFamilies()
 		}
 	}
 
-	freeOperatorFamilies(opfamilies1, nopfamilies1);
-	freeOperatorFamilies(opfamilies2, nopfamilies2);
+	resetArena(&arena1);
+	resetArena(&arena2);
+}
+
+static void
+fetchOperatorClasses(QuarrelFetch *f)
+{
+	f->objects = getOperatorClasses(f->conn, &f->nobjects);
 }
 
 static void
@@ -2287,9 +3817,13 @@ quarrelOperatorClasses()
 	int			nopclasses1 = 0;					/* # of opclasses */
 	int			nopclasses2 = 0;
 	int			i, j;
+	QuarrelFetch	f1, f2;
 
-	opclasses1 = getOperatorClasses(conn1, &nopclasses1);
-	opclasses2 = getOperatorClasses(conn2, &nopclasses2);
+	fetchObjects(fetchOperatorClasses, &f1, &f2);
+	opclasses1 = f1.objects;
+	nopclasses1 = f1.nobjects;
+	opclasses2 = f2.objects;
+	nopclasses2 = f2.nobjects;
 
 	for (i = 0; i < nopclasses1; i++)
 		logNoise("server1: %s.%s", opclasses1[i].obj.schemaname,
@@ -2314,6 +3848,7 @@ quarrelOperatorClasses()
 			logDebug("operator class %s.%s: server2", opclasses2[j].obj.schemaname,
 					 opclasses2[j].obj.objectname);
 
+			markOutputBuffer(bpre, 2, PGQ_CLASS_OPCLASS, opclasses2[j].obj.oid);
 			dumpCreateOperatorClass(fpre, &opclasses2[j]);
 
 			j++;
@@ -2325,6 +3860,7 @@ quarrelOperatorClasses()
 			logDebug("operator class %s.%s: server1", opclasses1[i].obj.schemaname,
 					 opclasses1[i].obj.objectname);
 
+			markOutputBuffer(bpost, 1, PGQ_CLASS_OPCLASS, opclasses1[i].obj.oid);
 			dumpDropOperatorClass(fpost, &opclasses1[i]);
 
 			i++;
@@ -2335,6 +3871,7 @@ quarrelOperatorClasses()
 			logDebug("operator class %s.%s: server1 server2", opclasses1[i].obj.schemaname,
 					 opclasses1[i].obj.objectname);
 
+			markOutputBuffer(bpre, 2, PGQ_CLASS_OPCLASS, opclasses2[j].obj.oid);
 			dumpAlterOperatorClass(fpre, &opclasses1[i], &opclasses2[j]);
 
 			i++;
@@ -2345,6 +3882,7 @@ quarrelOperatorClasses()
 			logDebug("operator class %s.%s: server1", opclasses1[i].obj.schemaname,
 					 opclasses1[i].obj.objectname);
 
+			markOutputBuffer(bpost, 1, PGQ_CLASS_OPCLASS, opclasses1[i].obj.oid);
 			dumpDropOperatorClass(fpost, &opclasses1[i]);
 
 			i++;
@@ -2355,6 +3893,7 @@ quarrelOperatorClasses()
 			logDebug("operator class %s.%s: server2", opclasses2[j].obj.schemaname,
 					 opclasses2[j].obj.objectname);
 
+			markOutputBuffer(bpre, 2, PGQ_CLASS_OPCLASS, opclasses2[j].obj.oid);
 			dumpCreateOperatorClass(fpre, &opclasses2[j]);
 
 			j++;
@@ -2362,8 +3901,20 @@ quarrelOperatorClasses()
 		}
 	}
 
-	freeOperatorClasses(opclasses1, nopclasses1);
-	freeOperatorClasses(opclasses2, nopclasses2);
+	resetArena(&arena1);
+	resetArena(&arena2);
+}
+
+static void
+fetchProcedures(QuarrelFetch *f)
+{
+	PQLFunction	*procedures;
+
+	procedures = getProcedures(f->conn, &f->nobjects);
+	if (options.securitylabels)
+		getProcedureSecurityLabels(f->conn, procedures, f->nobjects);
+
+	f->objects = procedures;
 }
 
 static void
@@ -2374,9 +3925,13 @@ quarrelProcedures()
 	int			nprocedures1 = 0;		/* # of procedures */
 	int			nprocedures2 = 0;
 	int			i, j;
+	QuarrelFetch	f1, f2;
 
-	procedures1 = getProcedures(conn1, &nprocedures1);
-	procedures2 = getProcedures(conn2, &nprocedures2);
+	fetchObjects(fetchProcedures, &f1, &f2);
+	procedures1 = f1.objects;
+	nprocedures1 = f1.nobjects;
+	procedures2 = f2.objects;
+	nprocedures2 = f2.nobjects;
 
 	for (i = 0; i < nprocedures1; i++)
 		logNoise("server1: %s.%s(%s) %s", procedures1[i].obj.schemaname,
@@ -2403,9 +3958,7 @@ quarrelProcedures()
 			logDebug("procedure %s.%s(%s): server2", procedures2[j].obj.schemaname,
 					 procedures2[j].obj.objectname, procedures2[j].arguments);
 
-			if (options.securitylabels)
-				getProcedureSecurityLabels(conn2, &procedures2[j]);
-
+			markOutputBuffer(bpre, 2, PGQ_CLASS_PROC, procedures2[j].obj.oid);
 			dumpCreateProcedure(fpre, &procedures2[j], false);
 
 			j++;
@@ -2417,6 +3970,7 @@ quarrelProcedures()
 			logDebug("procedure %s.%s(%s): server1", procedures1[i].obj.schemaname,
 					 procedures1[i].obj.objectname, procedures1[i].arguments);
 
+			markOutputBuffer(bpost, 1, PGQ_CLASS_PROC, procedures1[i].obj.oid);
 			dumpDropProcedure(fpost, &procedures1[i]);
 
 			i++;
@@ -2427,16 +3981,11 @@ quarrelProcedures()
 			logDebug("procedure %s.%s(%s): server1 server2", procedures1[i].obj.schemaname,
 					 procedures1[i].obj.objectname, procedures1[i].arguments);
 
-			if (options.securitylabels)
-			{
-				getProcedureSecurityLabels(conn1, &procedures1[i]);
-				getProcedureSecurityLabels(conn2, &procedures2[j]);
-			}
-
 			/*
 			 * When we change return type we have to recreate the procedure
 			 * because there is no ALTER FUNCTION command for it.
 			 */
+			markOutputBuffer(bpre, 2, PGQ_CLASS_PROC, procedures2[j].obj.oid);
 			if (strcmp(procedures1[i].returntype, procedures2[j].returntype) == 0)
 				dumpAlterProcedure(fpre, &procedures1[i], &procedures2[j]);
 			else
@@ -2453,6 +4002,7 @@ quarrelProcedures()
 			logDebug("procedure %s.%s(%s): server1", procedures1[i].obj.schemaname,
 					 procedures1[i].obj.objectname, procedures1[i].arguments);
 
+			markOutputBuffer(bpost, 1, PGQ_CLASS_PROC, procedures1[i].obj.oid);
 			dumpDropProcedure(fpost, &procedures1[i]);
 
 			i++;
@@ -2463,9 +4013,7 @@ quarrelProcedures()
 			logDebug("procedure %s.%s(%s): server2", procedures2[j].obj.schemaname,
 					 procedures2[j].obj.objectname, procedures2[j].arguments);
 
-			if (options.securitylabels)
-				getProcedureSecurityLabels(conn2, &procedures2[j]);
-
+			markOutputBuffer(bpre, 2, PGQ_CLASS_PROC, procedures2[j].obj.oid);
 			dumpCreateProcedure(fpre, &procedures2[j], false);
 
 			j++;
@@ -2473,8 +4021,21 @@ quarrelProcedures()
 		}
 	}
 
-	freeFunctions(procedures1, nprocedures1);
-	freeFunctions(procedures2, nprocedures2);
+	resetArena(&arena1);
+	resetArena(&arena2);
+}
+
+static void
+fetchPublications(QuarrelFetch *f)
+{
+	PQLPublication	*publications;
+
+	publications = getPublications(f->conn, &f->nobjects);
+	getPublicationTables(f->conn, publications, f->nobjects);
+	if (options.securitylabels)
+		getPublicationSecurityLabels(f->conn, publications, f->nobjects);
+
+	f->objects = publications;
 }
 
 static void
@@ -2485,9 +4046,13 @@ quarrelPublications()
 	int			npublications1 = 0;		/* # of publications */
 	int			npublications2 = 0;
 	int			i, j;
+	QuarrelFetch	f1, f2;
 
-	publications1 = getPublications(conn1, &npublications1);
-	publications2 = getPublications(conn2, &npublications2);
+	fetchObjects(fetchPublications, &f1, &f2);
+	publications1 = f1.objects;
+	npublications1 = f1.nobjects;
+	publications2 = f2.objects;
+	npublications2 = f2.nobjects;
 
 	for (i = 0; i < npublications1; i++)
 		logNoise("server1: %s", publications1[i].pubname);
@@ -2509,10 +4074,7 @@ quarrelPublications()
 		{
 			logDebug("publication %s: server2", publications2[j].pubname);
 
-			getPublicationTables(conn2, &publications2[j]);
-			if (options.securitylabels)
-				getPublicationSecurityLabels(conn2, &publications2[j]);
-
+			markOutputBuffer(bpre, 2, PGQ_CLASS_PUBLICATION, publications2[j].oid);
 			dumpCreatePublication(fpre, &publications2[j]);
 
 			j++;
@@ -2523,6 +4085,7 @@ quarrelPublications()
 		{
 			logDebug("publication %s: server1", publications1[i].pubname);
 
+			markOutputBuffer(bpost, 1, PGQ_CLASS_PUBLICATION, publications1[i].oid);
 			dumpDropPublication(fpost, &publications1[i]);
 
 			i++;
@@ -2532,14 +4095,7 @@ quarrelPublications()
 		{
 			logDebug("publication %s: server1 server2", publications1[i].pubname);
 
-			getPublicationTables(conn1, &publications1[i]);
-			getPublicationTables(conn2, &publications2[j]);
-			if (options.securitylabels)
-			{
-				getPublicationSecurityLabels(conn1, &publications1[i]);
-				getPublicationSecurityLabels(conn2, &publications2[j]);
-			}
-
+			markOutputBuffer(bpre, 2, PGQ_CLASS_PUBLICATION, publications2[j].oid);
 			dumpAlterPublication(fpre, &publications1[i], &publications2[j]);
 
 			i++;
@@ -2549,6 +4105,7 @@ quarrelPublications()
 		{
 			logDebug("publication %s: server1", publications1[i].pubname);
 
+			markOutputBuffer(bpost, 1, PGQ_CLASS_PUBLICATION, publications1[i].oid);
 			dumpDropPublication(fpost, &publications1[i]);
 
 			i++;
@@ -2558,10 +4115,7 @@ quarrelPublications()
 		{
 			logDebug("publication %s: server2", publications2[j].pubname);
 
-			getPublicationTables(conn2, &publications2[j]);
-			if (options.securitylabels)
-				getPublicationSecurityLabels(conn2, &publications2[j]);
-
+			markOutputBuffer(bpre, 2, PGQ_CLASS_PUBLICATION, publications2[j].oid);
 			dumpCreatePublication(fpre, &publications2[j]);
 
 			j++;
@@ -2569,8 +4123,14 @@ quarrelPublications()
 		}
 	}
 
-	freePublications(publications1, npublications1);
-	freePublications(publications2, npublications2);
+	resetArena(&arena1);
+	resetArena(&arena2);
+}
+
+static void
+fetchPolicies(QuarrelFetch *f)
+{
+	f->objects = getPolicies(f->conn, &f->nobjects);
 }
 
 static void
@@ -2581,9 +4141,13 @@ quarrelPolicies()
 	int			npolicies1 = 0;		/* # of policies */
 	int			npolicies2 = 0;
 	int			i, j;
+	QuarrelFetch	f1, f2;
 
-	policies1 = getPolicies(conn1, &npolicies1);
-	policies2 = getPolicies(conn2, &npolicies2);
+	fetchObjects(fetchPolicies, &f1, &f2);
+	policies1 = f1.objects;
+	npolicies1 = f1.nobjects;
+	policies2 = f2.objects;
+	npolicies2 = f2.nobjects;
 
 	for (i = 0; i < npolicies1; i++)
 		logNoise("server1: %s.%s", policies1[i].table.schemaname,
@@ -2608,6 +4172,7 @@ quarrelPolicies()
 			logDebug("policy %s.%s: server2", policies2[j].table.schemaname,
 					 policies2[j].table.objectname);
 
+			markOutputBuffer(bpre, 2, PGQ_CLASS_POLICY, policies2[j].oid);
 			dumpCreatePolicy(fpre, &policies2[j]);
 
 			j++;
@@ -2619,6 +4184,7 @@ quarrelPolicies()
 			logDebug("policy %s.%s: server1", policies1[i].table.schemaname,
 					 policies1[i].table.objectname);
 
+			markOutputBuffer(bpost, 1, PGQ_CLASS_POLICY, policies1[i].oid);
 			dumpDropPolicy(fpost, &policies1[i]);
 
 			i++;
@@ -2630,6 +4196,7 @@ quarrelPolicies()
 			logDebug("policy %s.%s: server1 server2", policies1[i].table.schemaname,
 					 policies1[i].table.objectname);
 
+			markOutputBuffer(bpre, 2, PGQ_CLASS_POLICY, policies2[j].oid);
 			dumpAlterPolicy(fpre, &policies1[i], &policies2[j]);
 
 			i++;
@@ -2641,6 +4208,7 @@ quarrelPolicies()
 			logDebug("policy %s.%s: server1", policies1[i].table.schemaname,
 					 policies1[i].table.objectname);
 
+			markOutputBuffer(bpost, 1, PGQ_CLASS_POLICY, policies1[i].oid);
 			dumpDropPolicy(fpost, &policies1[i]);
 
 			i++;
@@ -2652,6 +4220,7 @@ quarrelPolicies()
 			logDebug("policy %s.%s: server2", policies2[j].table.schemaname,
 					 policies2[j].table.objectname);
 
+			markOutputBuffer(bpre, 2, PGQ_CLASS_POLICY, policies2[j].oid);
 			dumpCreatePolicy(fpre, &policies2[j]);
 
 			j++;
@@ -2659,8 +4228,14 @@ quarrelPolicies()
 		}
 	}
 
-	freePolicies(policies1, npolicies1);
-	freePolicies(policies2, npolicies2);
+	resetArena(&arena1);
+	resetArena(&arena2);
+}
+
+static void
+fetchRules(QuarrelFetch *f)
+{
+	f->objects = getRules(f->conn, &f->nobjects);
 }
 
 static void
@@ -2671,9 +4246,13 @@ quarrelRules()
 	int			nrules1 = 0;		/* # of rules */
 	int			nrules2 = 0;
 	int			i, j;
+	QuarrelFetch	f1, f2;
 
-	rules1 = getRules(conn1, &nrules1);
-	rules2 = getRules(conn2, &nrules2);
+	fetchObjects(fetchRules, &f1, &f2);
+	rules1 = f1.objects;
+	nrules1 = f1.nobjects;
+	rules2 = f2.objects;
+	nrules2 = f2.nobjects;
 
 	for (i = 0; i < nrules1; i++)
 		logNoise("server1: %s.%s", rules1[i].table.schemaname,
@@ -2698,6 +4277,7 @@ quarrelRules()
 			logDebug("rule %s.%s: server2", rules2[j].table.schemaname,
 					 rules2[j].table.objectname);
 
+			markOutputBuffer(bpre, 2, PGQ_CLASS_REWRITE, rules2[j].oid);
 			dumpCreateRule(fpre, &rules2[j]);
 
 			j++;
@@ -2709,6 +4289,7 @@ quarrelRules()
 			logDebug("rule %s.%s: server1", rules1[i].table.schemaname,
 					 rules1[i].table.objectname);
 
+			markOutputBuffer(bpost, 1, PGQ_CLASS_REWRITE, rules1[i].oid);
 			dumpDropRule(fpost, &rules1[i]);
 
 			i++;
@@ -2720,6 +4301,7 @@ quarrelRules()
 			logDebug("rule %s.%s: server1 server2", rules1[i].table.schemaname,
 					 rules1[i].table.objectname);
 
+			markOutputBuffer(bpre, 2, PGQ_CLASS_REWRITE, rules2[j].oid);
 			dumpAlterRule(fpre, &rules1[i], &rules2[j]);
 
 			i++;
@@ -2731,6 +4313,7 @@ quarrelRules()
 			logDebug("rule %s.%s: server1", rules1[i].table.schemaname,
 					 rules1[i].table.objectname);
 
+			markOutputBuffer(bpost, 1, PGQ_CLASS_REWRITE, rules1[i].oid);
 			dumpDropRule(fpost, &rules1[i]);
 
 			i++;
@@ -2742,6 +4325,7 @@ quarrelRules()
 			logDebug("rule %s.%s: server2", rules2[j].table.schemaname,
 					 rules2[j].table.objectname);
 
+			markOutputBuffer(bpre, 2, PGQ_CLASS_REWRITE, rules2[j].oid);
 			dumpCreateRule(fpre, &rules2[j]);
 
 			j++;
@@ -2749,8 +4333,20 @@ quarrelRules()
 		}
 	}
 
-	freeRules(rules1, nrules1);
-	freeRules(rules2, nrules2);
+	resetArena(&arena1);
+	resetArena(&arena2);
+}
+
+static void
+fetchSchemas(QuarrelFetch *f)
+{
+	PQLSchema	*schemas;
+
+	schemas = getSchemas(f->conn, &f->nobjects);
+	if (options.securitylabels)
+		getSchemaSecurityLabels(f->conn, schemas, f->nobjects);
+
+	f->objects = schemas;
 }
 
 static void
@@ -2761,9 +4357,13 @@ quarrelSchemas()
 	int			nschemas1 = 0;		/* # of schemas */
 	int			nschemas2 = 0;
 	int			i, j;
+	QuarrelFetch	f1, f2;
 
-	schemas1 = getSchemas(conn1, &nschemas1);
-	schemas2 = getSchemas(conn2, &nschemas2);
+	fetchObjects(fetchSchemas, &f1, &f2);
+	schemas1 = f1.objects;
+	nschemas1 = f1.nobjects;
+	schemas2 = f2.objects;
+	nschemas2 = f2.nobjects;
 
 	for (i = 0; i < nschemas1; i++)
 		logNoise("server1: %s", schemas1[i].schemaname);
@@ -2785,9 +4385,7 @@ quarrelSchemas()
 		{
 			logDebug("schema %s: server2", schemas2[j].schemaname);
 
-			if (options.securitylabels)
-				getSchemaSecurityLabels(conn2, &schemas2[j]);
-
+			markOutputBuffer(bpre, 2, PGQ_CLASS_NAMESPACE, schemas2[j].oid);
 			dumpCreateSchema(fpre, &schemas2[j]);
 
 			j++;
@@ -2798,6 +4396,7 @@ quarrelSchemas()
 		{
 			logDebug("schema %s: server1", schemas1[i].schemaname);
 
+			markOutputBuffer(bpost, 1, PGQ_CLASS_NAMESPACE, schemas1[i].oid);
 			dumpDropSchema(fpost, &schemas1[i]);
 
 			i++;
@@ -2807,12 +4406,7 @@ quarrelSchemas()
 		{
 			logDebug("schema %s: server1 server2", schemas1[i].schemaname);
 
-			if (options.securitylabels)
-			{
-				getSchemaSecurityLabels(conn1, &schemas1[i]);
-				getSchemaSecurityLabels(conn2, &schemas2[j]);
-			}
-
+			markOutputBuffer(bpre, 2, PGQ_CLASS_NAMESPACE, schemas2[j].oid);
 			dumpAlterSchema(fpre, &schemas1[i], &schemas2[j]);
 
 			i++;
@@ -2822,6 +4416,7 @@ quarrelSchemas()
 		{
 			logDebug("schema %s: server1", schemas1[i].schemaname);
 
+			markOutputBuffer(bpost, 1, PGQ_CLASS_NAMESPACE, schemas1[i].oid);
 			dumpDropSchema(fpost, &schemas1[i]);
 
 			i++;
@@ -2831,9 +4426,7 @@ quarrelSchemas()
 		{
 			logDebug("schema %s: server2", schemas2[j].schemaname);
 
-			if (options.securitylabels)
-				getSchemaSecurityLabels(conn2, &schemas2[j]);
-
+			markOutputBuffer(bpre, 2, PGQ_CLASS_NAMESPACE, schemas2[j].oid);
 			dumpCreateSchema(fpre, &schemas2[j]);
 
 			j++;
@@ -2841,8 +4434,21 @@ quarrelSchemas()
 		}
 	}
 
-	freeSchemas(schemas1, nschemas1);
-	freeSchemas(schemas2, nschemas2);
+	resetArena(&arena1);
+	resetArena(&arena2);
+}
+
+static void
+fetchSequences(QuarrelFetch *f)
+{
+	PQLSequence	*sequences;
+
+	sequences = getSequences(f->conn, &f->nobjects);
+	getSequenceAttributes(f->conn, sequences, f->nobjects);
+	if (options.securitylabels)
+		getSequenceSecurityLabels(f->conn, sequences, f->nobjects);
+
+	f->objects = sequences;
 }
 
 static void
@@ -2853,9 +4459,13 @@ quarrelSequences()
 	int			nsequences1 = 0;	/* # of sequences */
 	int			nsequences2 = 0;
 	int			i, j;
+	QuarrelFetch	f1, f2;
 
-	sequences1 = getSequences(conn1, &nsequences1);
-	sequences2 = getSequences(conn2, &nsequences2);
+	fetchObjects(fetchSequences, &f1, &f2);
+	sequences1 = f1.objects;
+	nsequences1 = f1.nobjects;
+	sequences2 = f2.objects;
+	nsequences2 = f2.nobjects;
 
 	for (i = 0; i < nsequences1; i++)
 		logNoise("server1: %s.%s", sequences1[i].obj.schemaname,
@@ -2865,6 +4475,11 @@ quarrelSequences()
 		logNoise("server2: %s.%s", sequences2[i].obj.schemaname,
 				 sequences2[i].obj.objectname);
 
+	if (options.privileges && options.schemagrants)
+		findObjectSchemaGrants(PGQ_SEQUENCE, sequences1, nsequences1,
+							   sequences2, nsequences2, sizeof(PQLSequence),
+							   offsetof(PQLSequence, acl), compareRelationObjects);
+
 	/*
 	 * We have two sorted lists. Let's figure out which elements are not in the
 	 * other list.
@@ -2880,10 +4495,7 @@ quarrelSequences()
 			logDebug("sequence %s.%s: server2", sequences2[j].obj.schemaname,
 					 sequences2[j].obj.objectname);
 
-			getSequenceAttributes(conn2, &sequences2[j]);
-			if (options.securitylabels)
-				getSequenceSecurityLabels(conn2, &sequences2[j]);
-
+			markOutputBuffer(bpre, 2, PGQ_CLASS_CLASS, sequences2[j].obj.oid);
 			dumpCreateSequence(fpre, &sequences2[j]);
 
 			j++;
@@ -2895,6 +4507,7 @@ quarrelSequences()
 			logDebug("sequence %s.%s: server1", sequences1[i].obj.schemaname,
 					 sequences1[i].obj.objectname);
 
+			markOutputBuffer(bpost, 1, PGQ_CLASS_CLASS, sequences1[i].obj.oid);
 			dumpDropSequence(fpost, &sequences1[i]);
 
 			i++;
@@ -2905,14 +4518,7 @@ quarrelSequences()
 			logDebug("sequence %s.%s: server1 server2", sequences1[i].obj.schemaname,
 					 sequences1[i].obj.objectname);
 
-			getSequenceAttributes(conn1, &sequences1[i]);
-			getSequenceAttributes(conn2, &sequences2[j]);
-			if (options.securitylabels)
-			{
-				getSequenceSecurityLabels(conn1, &sequences1[i]);
-				getSequenceSecurityLabels(conn2, &sequences2[j]);
-			}
-
+			markOutputBuffer(bpre, 2, PGQ_CLASS_CLASS, sequences2[j].obj.oid);
 			dumpAlterSequence(fpre, &sequences1[i], &sequences2[j]);
 
 			i++;
@@ -2923,6 +4529,7 @@ quarrelSequences()
 			logDebug("sequence %s.%s: server1", sequences1[i].obj.schemaname,
 					 sequences1[i].obj.objectname);
 
+			markOutputBuffer(bpost, 1, PGQ_CLASS_CLASS, sequences1[i].obj.oid);
 			dumpDropSequence(fpost, &sequences1[i]);
 
 			i++;
@@ -2933,10 +4540,7 @@ quarrelSequences()
 			logDebug("sequence %s.%s: server2", sequences2[j].obj.schemaname,
 					 sequences2[j].obj.objectname);
 
-			getSequenceAttributes(conn2, &sequences2[j]);
-			if (options.securitylabels)
-				getSequenceSecurityLabels(conn2, &sequences2[j]);
-
+			markOutputBuffer(bpre, 2, PGQ_CLASS_CLASS, sequences2[j].obj.oid);
 			dumpCreateSequence(fpre, &sequences2[j]);
 
 			j++;
@@ -2944,8 +4548,22 @@ quarrelSequences()
 		}
 	}
 
-	freeSequences(sequences1, nsequences1);
-	freeSequences(sequences2, nsequences2);
+	/* after every sequence is created */
+	if (options.privileges && options.schemagrants)
+	{
+		markOutputBuffer(bpost, 0, InvalidOid, InvalidOid);
+		dumpSchemaGrants(fpost);
+		resetSchemaGrants();
+	}
+
+	resetArena(&arena1);
+	resetArena(&arena2);
+}
+
+static void
+fetchStatistics(QuarrelFetch *f)
+{
+	f->objects = getStatistics(f->conn, &f->nobjects);
 }
 
 static void
@@ -2956,9 +4574,13 @@ quarrelStatistics()
 	int				nstatistics1 = 0;		/* # of statistics */
 	int				nstatistics2 = 0;
 	int				i, j;
+	QuarrelFetch	f1, f2;
 
-	statistics1 = getStatistics(conn1, &nstatistics1);
-	statistics2 = getStatistics(conn2, &nstatistics2);
+	fetchObjects(fetchStatistics, &f1, &f2);
+	statistics1 = f1.objects;
+	nstatistics1 = f1.nobjects;
+	statistics2 = f2.objects;
+	nstatistics2 = f2.nobjects;
 
 	for (i = 0; i < nstatistics1; i++)
 		logNoise("server1: %s.%s", statistics1[i].obj.schemaname,
@@ -2983,6 +4605,7 @@ quarrelStatistics()
 			logDebug("statistics %s.%s: server2", statistics2[j].obj.schemaname,
 					 statistics2[j].obj.objectname);
 
+			markOutputBuffer(bpre, 2, PGQ_CLASS_STATISTIC_EXT, statistics2[j].obj.oid);
 			dumpCreateStatistics(fpre, &statistics2[j]);
 
 			j++;
@@ -2994,6 +4617,7 @@ quarrelStatistics()
 			logDebug("statistics %s.%s: server1", statistics1[i].obj.schemaname,
 					 statistics1[i].obj.objectname);
 
+			markOutputBuffer(bpost, 1, PGQ_CLASS_STATISTIC_EXT, statistics1[i].obj.oid);
 			dumpDropStatistics(fpost, &statistics1[i]);
 
 			i++;
@@ -3004,6 +4628,7 @@ quarrelStatistics()
 			logDebug("statistics %s.%s: server1 server2", statistics1[i].obj.schemaname,
 					 statistics1[i].obj.objectname);
 
+			markOutputBuffer(bpre, 2, PGQ_CLASS_STATISTIC_EXT, statistics2[j].obj.oid);
 			dumpAlterStatistics(fpre, &statistics1[i], &statistics2[j]);
 
 			i++;
@@ -3014,6 +4639,7 @@ quarrelStatistics()
 			logDebug("statistics %s.%s: server1", statistics1[i].obj.schemaname,
 					 statistics1[i].obj.objectname);
 
+			markOutputBuffer(bpost, 1, PGQ_CLASS_STATISTIC_EXT, statistics1[i].obj.oid);
 			dumpDropStatistics(fpost, &statistics1[i]);
 
 			i++;
@@ -3024,6 +4650,7 @@ quarrelStatistics()
 			logDebug("statistics %s.%s: server2", statistics2[j].obj.schemaname,
 					 statistics2[j].obj.objectname);
 
+			markOutputBuffer(bpre, 2, PGQ_CLASS_STATISTIC_EXT, statistics2[j].obj.oid);
 			dumpCreateStatistics(fpre, &statistics2[j]);
 
 			j++;
@@ -3031,8 +4658,21 @@ quarrelStatistics()
 		}
 	}
 
-	freeStatistics(statistics1, nstatistics1);
-	freeStatistics(statistics2, nstatistics2);
+	resetArena(&arena1);
+	resetArena(&arena2);
+}
+
+static void
+fetchSubscriptions(QuarrelFetch *f)
+{
+	PQLSubscription	*subscriptions;
+
+	subscriptions = getSubscriptions(f->conn, &f->nobjects);
+	getSubscriptionPublications(f->conn, subscriptions, f->nobjects);
+	if (options.securitylabels)
+		getSubscriptionSecurityLabels(f->conn, subscriptions, f->nobjects);
+
+	f->objects = subscriptions;
 }
 
 static void
@@ -3043,9 +4683,13 @@ quarrelSubscriptions()
 	int			nsubscriptions1 = 0;		/* # of subscriptions */
 	int			nsubscriptions2 = 0;
 	int			i, j;
+	QuarrelFetch	f1, f2;
 
-	subscriptions1 = getSubscriptions(conn1, &nsubscriptions1);
-	subscriptions2 = getSubscriptions(conn2, &nsubscriptions2);
+	fetchObjects(fetchSubscriptions, &f1, &f2);
+	subscriptions1 = f1.objects;
+	nsubscriptions1 = f1.nobjects;
+	subscriptions2 = f2.objects;
+	nsubscriptions2 = f2.nobjects;
 
 	for (i = 0; i < nsubscriptions1; i++)
 		logNoise("server1: %s", subscriptions1[i].subname);
@@ -3067,10 +4711,7 @@ quarrelSubscriptions()
 		{
 			logDebug("subscription %s: server2", subscriptions2[j].subname);
 
-			getSubscriptionPublications(conn2, &subscriptions2[j]);
-			if (options.securitylabels)
-				getSubscriptionSecurityLabels(conn2, &subscriptions2[j]);
-
+			markOutputBuffer(bpre, 2, PGQ_CLASS_SUBSCRIPTION, subscriptions2[j].oid);
 			dumpCreateSubscription(fpre, &subscriptions2[j]);
 
 			j++;
@@ -3081,6 +4722,7 @@ quarrelSubscriptions()
 		{
 			logDebug("subscription %s: server1", subscriptions1[i].subname);
 
+			markOutputBuffer(bpost, 1, PGQ_CLASS_SUBSCRIPTION, subscriptions1[i].oid);
 			dumpDropSubscription(fpost, &subscriptions1[i]);
 
 			i++;
@@ -3090,14 +4732,7 @@ quarrelSubscriptions()
 		{
 			logDebug("subscription %s: server1 server2", subscriptions1[i].subname);
 
-			getSubscriptionPublications(conn1, &subscriptions1[i]);
-			getSubscriptionPublications(conn2, &subscriptions2[j]);
-			if (options.securitylabels)
-			{
-				getSubscriptionSecurityLabels(conn1, &subscriptions1[i]);
-				getSubscriptionSecurityLabels(conn2, &subscriptions2[j]);
-			}
-
+			markOutputBuffer(bpre, 2, PGQ_CLASS_SUBSCRIPTION, subscriptions2[j].oid);
 			dumpAlterSubscription(fpre, &subscriptions1[i], &subscriptions2[j]);
 
 			i++;
@@ -3107,6 +4742,7 @@ quarrelSubscriptions()
 		{
 			logDebug("subscription %s: server1", subscriptions1[i].subname);
 
+			markOutputBuffer(bpost, 1, PGQ_CLASS_SUBSCRIPTION, subscriptions1[i].oid);
 			dumpDropSubscription(fpost, &subscriptions1[i]);
 
 			i++;
@@ -3116,10 +4752,7 @@ quarrelSubscriptions()
 		{
 			logDebug("subscription %s: server2", subscriptions2[j].subname);
 
-			getSubscriptionPublications(conn2, &subscriptions2[j]);
-			if (options.securitylabels)
-				getSubscriptionSecurityLabels(conn2, &subscriptions2[j]);
-
+			markOutputBuffer(bpre, 2, PGQ_CLASS_SUBSCRIPTION, subscriptions2[j].oid);
 			dumpCreateSubscription(fpre, &subscriptions2[j]);
 
 			j++;
@@ -3127,8 +4760,169 @@ quarrelSubscriptions()
 		}
 	}
 
-	freeSubscriptions(subscriptions1, nsubscriptions1);
-	freeSubscriptions(subscriptions2, nsubscriptions2);
+	resetArena(&arena1);
+	resetArena(&arena2);
+}
+
+/*
+ * Attributes are not loaded for tables that will be dropped. Walk both sorted
+ * lists (the same way quarrelTables does) to collect tables that will be
+ * created or altered. Properties of those tables are loaded using a few
+ * queries per server instead of a few queries per table.
+ *
+ * If alla (or allb) is true, every table of that list is collected. A catalog
+ * file (or cache) has the properties of all tables because it does not know
+ * which tables it will be compared with.
+ */
+static void
+collectTables(PQLTable *a, int na, bool alla, PQLTable *b, int nb, bool allb,
+			  PQLTable ***ca, int *nca, PQLTable ***cb, int *ncb)
+{
+	int		i, j;
+
+	*ca = (PQLTable **) malloc((na > 0 ? na : 1) * sizeof(PQLTable *));
+	*cb = (PQLTable **) malloc((nb > 0 ? nb : 1) * sizeof(PQLTable *));
+	if (*ca == NULL || *cb == NULL)
+	{
+		logError("could not allocate memory");
+		exit(EXIT_FAILURE);
+	}
+	*nca = *ncb = 0;
+
+	i = j = 0;
+	while (i < na || j < nb)
+	{
+		int		c;
+
+		/* end of 'a' list; remaining tables will be created */
+		if (i == na)
+		{
+			(*cb)[(*ncb)++] = &b[j++];
+			continue;
+		}
+		/* end of 'b' list; remaining tables will be dropped */
+		if (j == nb)
+		{
+			i++;
+			continue;
+		}
+
+		c = compareRelations(&a[i].obj, &b[j].obj);
+		if (c == 0)
+		{
+			(*ca)[(*nca)++] = &a[i++];
+			(*cb)[(*ncb)++] = &b[j++];
+		}
+		else if (c < 0)
+			i++;
+		else
+			(*cb)[(*ncb)++] = &b[j++];
+	}
+
+	if (alla)
+	{
+		for (i = 0; i < na; i++)
+			(*ca)[i] = &a[i];
+		*nca = na;
+	}
+	if (allb)
+	{
+		for (j = 0; j < nb; j++)
+			(*cb)[j] = &b[j];
+		*ncb = nb;
+	}
+}
+
+static int
+compareRelationObjects(void *a, void *b)
+{
+	return compareRelations((PQLObject *) a, (PQLObject *) b);
+}
+
+static int
+compareFunctionObjects(void *a, void *b)
+{
+	return compareFunctions((PQLFunction *) a, (PQLFunction *) b);
+}
+
+/*
+ * Pair the objects of both sorted lists (the same way the merge loops do) and
+ * find the privileges that can be changed by a schema-wide command (see
+ * findSchemaGrants). Objects are 'size' bytes long, start with PQLObject and
+ * have their ACL at 'acloffset'.
+ */
+static void
+findObjectSchemaGrants(int objecttype, void *a, int na, void *b, int nb,
+					   size_t size, size_t acloffset,
+					   int (*compare) (void *a, void *b))
+{
+	PQLPrivilegeObject	*pa;
+	PQLPrivilegeObject	*pb;
+	int					i, j;
+	int					n = 0;
+
+	pa = (PQLPrivilegeObject *) malloc((na + nb + 1) * sizeof(PQLPrivilegeObject));
+	pb = (PQLPrivilegeObject *) malloc((na + nb + 1) * sizeof(PQLPrivilegeObject));
+	if (pa == NULL || pb == NULL)
+	{
+		logError("could not allocate memory");
+		exit(EXIT_FAILURE);
+	}
+
+	i = j = 0;
+	while (i < na || j < nb)
+	{
+		char	*x = (i < na) ? (char *) a + i * size : NULL;
+		char	*y = (j < nb) ? (char *) b + j * size : NULL;
+		int		c;
+
+		if (x == NULL)
+			c = 1;
+		else if (y == NULL)
+			c = -1;
+		else
+			c = compare(x, y);
+
+		pa[n].obj = (c <= 0) ? (PQLObject *) x : NULL;
+		pa[n].acl = (c <= 0) ? *(char **) (x + acloffset) : NULL;
+		pb[n].obj = (c >= 0) ? (PQLObject *) y : NULL;
+		pb[n].acl = (c >= 0) ? *(char **) (y + acloffset) : NULL;
+		n++;
+
+		if (c <= 0)
+			i++;
+		if (c >= 0)
+			j++;
+	}
+
+	findSchemaGrants(conn1, conn2, objecttype, pa, pb, n);
+
+	free(pa);
+	free(pb);
+}
+
+static void
+fetchForeignTables(QuarrelFetch *f)
+{
+	PQLTable	*tables;
+
+	tables = getForeignTables(f->conn, &f->nobjects);
+	getForeignTableProperties(f->conn, tables, f->nobjects);
+	getCheckConstraints(f->conn, tables, f->nobjects);
+
+	f->objects = tables;
+}
+
+/*
+ * Load attributes and security labels from a list of foreign tables (see
+ * collectTables).
+ */
+static void
+fetchForeignTableDetails(QuarrelFetch *f)
+{
+	getTableAttributes(f->conn, f->objects, f->nobjects);
+	if (options.securitylabels)
+		getTableSecurityLabels(f->conn, f->objects, f->nobjects);
 }
 
 static void
@@ -3139,14 +4933,31 @@ quarrelForeignTables()
 	int			ntables1 = 0;		/* # of tables */
 	int			ntables2 = 0;
 	int			i, j;
-
-	tables1 = getForeignTables(conn1, &ntables1);
-	getForeignTableProperties(conn1, tables1, ntables1);
-	getCheckConstraints(conn1, tables1, ntables1);
-
-	tables2 = getForeignTables(conn2, &ntables2);
-	getForeignTableProperties(conn2, tables2, ntables2);
-	getCheckConstraints(conn2, tables2, ntables2);
+	PQLTable	**ctables1;		/* tables that need attributes */
+	PQLTable	**ctables2;
+	int			nctables1;
+	int			nctables2;
+	QuarrelFetch	f1, f2;
+
+	fetchObjects(fetchForeignTables, &f1, &f2);
+	tables1 = f1.objects;
+	ntables1 = f1.nobjects;
+	tables2 = f2.objects;
+	ntables2 = f2.nobjects;
+
+	collectTables(tables1, ntables1,
+				  isCatalogFile(conn1) || isCatalogDump(conn1), tables2, ntables2,
+				  isCatalogFile(conn2) || isCatalogDump(conn2), &ctables1,
+				  &nctables1, &ctables2, &nctables2);
+
+	f1.objects = ctables1;
+	f1.nobjects = nctables1;
+	f2.objects = ctables2;
+	f2.nobjects = nctables2;
+	fetchObjects(fetchForeignTableDetails, &f1, &f2);
+
+	free(ctables1);
+	free(ctables2);
 
 	for (i = 0; i < ntables1; i++)
 		logNoise("server1: %s.%s %u", tables1[i].obj.schemaname,
@@ -3171,10 +4982,8 @@ quarrelForeignTables()
 			logDebug("foreign table %s.%s: server2", tables2[j].obj.schemaname,
 					 tables2[j].obj.objectname);
 
-			getTableAttributes(conn2, &tables2[j]);
-			if (options.securitylabels)
-				getTableSecurityLabels(conn2, &tables2[j]);
-
+			markOutputBuffer(bpre, 2, PGQ_CLASS_CLASS, tables2[j].obj.oid);
+			markOutputBuffer(bpost, 2, PGQ_CLASS_CLASS, tables2[j].obj.oid);
 			dumpCreateTable(fpre, fpost, &tables2[j]);
 
 			j++;
@@ -3186,6 +4995,7 @@ quarrelForeignTables()
 			logDebug("foreign table %s.%s: server1", tables1[i].obj.schemaname,
 					 tables1[i].obj.objectname);
 
+			markOutputBuffer(bpost, 1, PGQ_CLASS_CLASS, tables1[i].obj.oid);
 			dumpDropTable(fpost, &tables1[i]);
 
 			i++;
@@ -3196,14 +5006,7 @@ quarrelForeignTables()
 			logDebug("foreign table %s.%s: server1 server2", tables1[i].obj.schemaname,
 					 tables1[i].obj.objectname);
 
-			getTableAttributes(conn1, &tables1[i]);
-			getTableAttributes(conn2, &tables2[j]);
-			if (options.securitylabels)
-			{
-				getTableSecurityLabels(conn1, &tables1[i]);
-				getTableSecurityLabels(conn2, &tables2[j]);
-			}
-
+			markOutputBuffer(bpre, 2, PGQ_CLASS_CLASS, tables2[j].obj.oid);
 			dumpAlterTable(fpre, &tables1[i], &tables2[j]);
 
 			i++;
@@ -3214,6 +5017,7 @@ quarrelForeignTables()
 			logDebug("foreign table %s.%s: server1", tables1[i].obj.schemaname,
 					 tables1[i].obj.objectname);
 
+			markOutputBuffer(bpost, 1, PGQ_CLASS_CLASS, tables1[i].obj.oid);
 			dumpDropTable(fpost, &tables1[i]);
 
 			i++;
@@ -3224,10 +5028,8 @@ quarrelForeignTables()
 			logDebug("foreign table %s.%s: server2", tables2[j].obj.schemaname,
 					 tables2[j].obj.objectname);
 
-			getTableAttributes(conn2, &tables2[j]);
-			if (options.securitylabels)
-				getTableSecurityLabels(conn2, &tables2[j]);
-
+			markOutputBuffer(bpre, 2, PGQ_CLASS_CLASS, tables2[j].obj.oid);
+			markOutputBuffer(bpost, 2, PGQ_CLASS_CLASS, tables2[j].obj.oid);
 			dumpCreateTable(fpre, fpost, &tables2[j]);
 
 			j++;
@@ -3235,8 +5037,34 @@ quarrelForeignTables()
 		}
 	}
 
-	freeTables(tables1, ntables1);
-	freeTables(tables2, ntables2);
+	resetArena(&arena1);
+	resetArena(&arena2);
+}
+
+static void
+fetchTables(QuarrelFetch *f)
+{
+	PQLTable	*tables;
+
+	tables = getRegularTables(f->conn, &f->nobjects);
+	getCheckConstraints(f->conn, tables, f->nobjects);
+	getFKConstraints(f->conn, tables, f->nobjects);
+	getPKConstraints(f->conn, tables, f->nobjects);
+
+	f->objects = tables;
+}
+
+/*
+ * Load attributes, owned sequences and security labels from a list of tables
+ * (see collectTables).
+ */
+static void
+fetchTableDetails(QuarrelFetch *f)
+{
+	getTableAttributes(f->conn, f->objects, f->nobjects);
+	getOwnedBySequences(f->conn, f->objects, f->nobjects);
+	if (options.securitylabels)
+		getTableSecurityLabels(f->conn, f->objects, f->nobjects);
 }
 
 static void
@@ -3247,16 +5075,35 @@ quarrelTables()
 	int			ntables1 = 0;		/* # of tables */
 	int			ntables2 = 0;
 	int			i, j;
-
-	tables1 = getRegularTables(conn1, &ntables1);
-	getCheckConstraints(conn1, tables1, ntables1);
-	getFKConstraints(conn1, tables1, ntables1);
-	getPKConstraints(conn1, tables1, ntables1);
-
-	tables2 = getRegularTables(conn2, &ntables2);
-	getCheckConstraints(conn2, tables2, ntables2);
-	getFKConstraints(conn2, tables2, ntables2);
-	getPKConstraints(conn2, tables2, ntables2);
+	PQLTable	**ctables1;		/* tables that need attributes */
+	PQLTable	**ctables2;
+	int			nctables1;
+	int			nctables2;
+	QuarrelFetch	f1, f2;
+
+	fetchObjects(fetchTables, &f1, &f2);
+	tables1 = f1.objects;
+	ntables1 = f1.nobjects;
+	tables2 = f2.objects;
+	ntables2 = f2.nobjects;
+
+	collectTables(tables1, ntables1,
+				  isCatalogFile(conn1) || isCatalogDump(conn1), tables2, ntables2,
+				  isCatalogFile(conn2) || isCatalogDump(conn2), &ctables1,
+				  &nctables1, &ctables2, &nctables2);
+
+	f1.objects = ctables1;
+	f1.nobjects = nctables1;
+	f2.objects = ctables2;
+	f2.nobjects = nctables2;
+	fetchObjects(fetchTableDetails, &f1, &f2);
+
+	/* only tables of the target are altered */
+	if (options.annotatecost || options.costthreshold > 0)
+		getTableSizes(conn1, ctables1, nctables1);
+
+	free(ctables1);
+	free(ctables2);
 
 	for (i = 0; i < ntables1; i++)
 		logNoise("server1: %s.%s %u", tables1[i].obj.schemaname,
@@ -3266,6 +5113,11 @@ quarrelTables()
 		logNoise("server2: %s.%s %u", tables2[i].obj.schemaname,
 				 tables2[i].obj.objectname, tables2[i].obj.oid);
 
+	if (options.privileges && options.schemagrants)
+		findObjectSchemaGrants(PGQ_TABLE, tables1, ntables1, tables2, ntables2,
+							   sizeof(PQLTable), offsetof(PQLTable, acl),
+							   compareRelationObjects);
+
 	/*
 	 * We have two sorted lists. Let's figure out which elements are not in the
 	 * other list.
@@ -3281,11 +5133,8 @@ quarrelTables()
 			logDebug("table %s.%s: server2", tables2[j].obj.schemaname,
 					 tables2[j].obj.objectname);
 
-			getTableAttributes(conn2, &tables2[j]);
-			getOwnedBySequences(conn2, &tables2[j]);
-			if (options.securitylabels)
-				getTableSecurityLabels(conn2, &tables2[j]);
-
+			markOutputBuffer(bpre, 2, PGQ_CLASS_CLASS, tables2[j].obj.oid);
+			markOutputBuffer(bpost, 2, PGQ_CLASS_CLASS, tables2[j].obj.oid);
 			dumpCreateTable(fpre, fpost, &tables2[j]);
 
 			j++;
@@ -3297,6 +5146,7 @@ quarrelTables()
 			logDebug("table %s.%s: server1", tables1[i].obj.schemaname,
 					 tables1[i].obj.objectname);
 
+			markOutputBuffer(bpost, 1, PGQ_CLASS_CLASS, tables1[i].obj.oid);
 			dumpDropTable(fpost, &tables1[i]);
 
 			i++;
@@ -3307,16 +5157,7 @@ quarrelTables()
 			logDebug("table %s.%s: server1 server2", tables1[i].obj.schemaname,
 					 tables1[i].obj.objectname);
 
-			getTableAttributes(conn1, &tables1[i]);
-			getTableAttributes(conn2, &tables2[j]);
-			getOwnedBySequences(conn1, &tables1[i]);
-			getOwnedBySequences(conn2, &tables2[j]);
-			if (options.securitylabels)
-			{
-				getTableSecurityLabels(conn1, &tables1[i]);
-				getTableSecurityLabels(conn2, &tables2[j]);
-			}
-
+			markOutputBuffer(bpre, 2, PGQ_CLASS_CLASS, tables2[j].obj.oid);
 			dumpAlterTable(fpre, &tables1[i], &tables2[j]);
 
 			i++;
@@ -3327,6 +5168,7 @@ quarrelTables()
 			logDebug("table %s.%s: server1", tables1[i].obj.schemaname,
 					 tables1[i].obj.objectname);
 
+			markOutputBuffer(bpost, 1, PGQ_CLASS_CLASS, tables1[i].obj.oid);
 			dumpDropTable(fpost, &tables1[i]);
 
 			i++;
@@ -3337,11 +5179,8 @@ quarrelTables()
 			logDebug("table %s.%s: server2", tables2[j].obj.schemaname,
 					 tables2[j].obj.objectname);
 
-			getTableAttributes(conn2, &tables2[j]);
-			getOwnedBySequences(conn2, &tables2[j]);
-			if (options.securitylabels)
-				getTableSecurityLabels(conn2, &tables2[j]);
-
+			markOutputBuffer(bpre, 2, PGQ_CLASS_CLASS, tables2[j].obj.oid);
+			markOutputBuffer(bpost, 2, PGQ_CLASS_CLASS, tables2[j].obj.oid);
 			dumpCreateTable(fpre, fpost, &tables2[j]);
 
 			j++;
@@ -3349,8 +5188,22 @@ quarrelTables()
 		}
 	}
 
-	freeTables(tables1, ntables1);
-	freeTables(tables2, ntables2);
+	/* after every table is created */
+	if (options.privileges && options.schemagrants)
+	{
+		markOutputBuffer(bpost, 0, InvalidOid, InvalidOid);
+		dumpSchemaGrants(fpost);
+		resetSchemaGrants();
+	}
+
+	resetArena(&arena1);
+	resetArena(&arena2);
+}
+
+static void
+fetchTextSearchConfigs(QuarrelFetch *f)
+{
+	f->objects = getTextSearchConfigs(f->conn, &f->nobjects);
 }
 
 static void
@@ -3361,10 +5214,14 @@ quarrelTextSearchConfigs()
 	int			ntsconfigs1 = 0;			/* # of text search configuration */
 	int			ntsconfigs2 = 0;
 	int			i, j;
+	QuarrelFetch	f1, f2;
 
 	/* TextSearchConfigs */
-	tsconfigs1 = getTextSearchConfigs(conn1, &ntsconfigs1);
-	tsconfigs2 = getTextSearchConfigs(conn2, &ntsconfigs2);
+	fetchObjects(fetchTextSearchConfigs, &f1, &f2);
+	tsconfigs1 = f1.objects;
+	ntsconfigs1 = f1.nobjects;
+	tsconfigs2 = f2.objects;
+	ntsconfigs2 = f2.nobjects;
 
 	for (i = 0; i < ntsconfigs1; i++)
 		logNoise("server1: %s.%s", tsconfigs1[i].obj.schemaname,
@@ -3389,6 +5246,7 @@ quarrelTextSearchConfigs()
 			logDebug("text search config %s.%s: server2", tsconfigs2[j].obj.schemaname,
 					 tsconfigs2[j].obj.objectname);
 
+			markOutputBuffer(bpre, 2, PGQ_CLASS_TS_CONFIG, tsconfigs2[j].obj.oid);
 			dumpCreateTextSearchConfig(fpre, &tsconfigs2[j]);
 
 			j++;
@@ -3400,6 +5258,7 @@ quarrelTextSearchConfigs()
 			logDebug("text search config %s.%s: server1", tsconfigs1[i].obj.schemaname,
 					 tsconfigs1[i].obj.objectname);
 
+			markOutputBuffer(bpost, 1, PGQ_CLASS_TS_CONFIG, tsconfigs1[i].obj.oid);
 			dumpDropTextSearchConfig(fpost, &tsconfigs1[i]);
 
 			i++;
@@ -3411,6 +5270,7 @@ quarrelTextSearchConfigs()
 					 tsconfigs1[i].obj.schemaname,
 					 tsconfigs1[i].obj.objectname);
 
+			markOutputBuffer(bpre, 2, PGQ_CLASS_TS_CONFIG, tsconfigs2[j].obj.oid);
 			dumpAlterTextSearchConfig(fpre, &tsconfigs1[i], &tsconfigs2[j]);
 
 			i++;
@@ -3421,6 +5281,7 @@ quarrelTextSearchConfigs()
 			logDebug("text search config %s.%s: server1", tsconfigs1[i].obj.schemaname,
 					 tsconfigs1[i].obj.objectname);
 
+			markOutputBuffer(bpost, 1, PGQ_CLASS_TS_CONFIG, tsconfigs1[i].obj.oid);
 			dumpDropTextSearchConfig(fpost, &tsconfigs1[i]);
 
 			i++;
@@ -3431,6 +5292,7 @@ quarrelTextSearchConfigs()
 			logDebug("text search config %s.%s: server2", tsconfigs2[j].obj.schemaname,
 					 tsconfigs2[j].obj.objectname);
 
+			markOutputBuffer(bpre, 2, PGQ_CLASS_TS_CONFIG, tsconfigs2[j].obj.oid);
 			dumpCreateTextSearchConfig(fpre, &tsconfigs2[j]);
 
 			j++;
@@ -3438,8 +5300,14 @@ quarrelTextSearchConfigs()
 		}
 	}
 
-	freeTextSearchConfigs(tsconfigs1, ntsconfigs1);
-	freeTextSearchConfigs(tsconfigs2, ntsconfigs2);
+	resetArena(&arena1);
+	resetArena(&arena2);
+}
+
+static void
+fetchTextSearchDicts(QuarrelFetch *f)
+{
+	f->objects = getTextSearchDicts(f->conn, &f->nobjects);
 }
 
 static void
@@ -3450,10 +5318,14 @@ quarrelTextSearchDicts()
 	int			ntsdicts1 = 0;				/* # of text search dictionary */
 	int			ntsdicts2 = 0;
 	int			i, j;
+	QuarrelFetch	f1, f2;
 
 	/* TextSearchDicts */
-	tsdicts1 = getTextSearchDicts(conn1, &ntsdicts1);
-	tsdicts2 = getTextSearchDicts(conn2, &ntsdicts2);
+	fetchObjects(fetchTextSearchDicts, &f1, &f2);
+	tsdicts1 = f1.objects;
+	ntsdicts1 = f1.nobjects;
+	tsdicts2 = f2.objects;
+	ntsdicts2 = f2.nobjects;
 
 	for (i = 0; i < ntsdicts1; i++)
 		logNoise("server1: %s.%s", tsdicts1[i].obj.schemaname,
@@ -3478,6 +5350,7 @@ quarrelTextSearchDicts()
 			logDebug("text search dictionary %s.%s: server2", tsdicts2[j].obj.schemaname,
 					 tsdicts2[j].obj.objectname);
 
+			markOutputBuffer(bpre, 2, PGQ_CLASS_TS_DICT, tsdicts2[j].obj.oid);
 			dumpCreateTextSearchDict(fpre, &tsdicts2[j]);
 
 			j++;
@@ -3489,6 +5362,7 @@ quarrelTextSearchDicts()
 			logDebug("text search dictionary %s.%s: server1", tsdicts1[i].obj.schemaname,
 					 tsdicts1[i].obj.objectname);
 
+			markOutputBuffer(bpost, 1, PGQ_CLASS_TS_DICT, tsdicts1[i].obj.oid);
 			dumpDropTextSearchDict(fpost, &tsdicts1[i]);
 
 			i++;
@@ -3500,6 +5374,7 @@ quarrelTextSearchDicts()
 					 tsdicts1[i].obj.schemaname,
 					 tsdicts1[i].obj.objectname);
 
+			markOutputBuffer(bpre, 2, PGQ_CLASS_TS_DICT, tsdicts2[j].obj.oid);
 			dumpAlterTextSearchDict(fpre, &tsdicts1[i], &tsdicts2[j]);
 
 			i++;
@@ -3510,6 +5385,7 @@ quarrelTextSearchDicts()
 			logDebug("text search dictionary %s.%s: server1", tsdicts1[i].obj.schemaname,
 					 tsdicts1[i].obj.objectname);
 
+			markOutputBuffer(bpost, 1, PGQ_CLASS_TS_DICT, tsdicts1[i].obj.oid);
 			dumpDropTextSearchDict(fpost, &tsdicts1[i]);
 
 			i++;
@@ -3520,6 +5396,7 @@ quarrelTextSearchDicts()
 			logDebug("text search dictionary %s.%s: server2", tsdicts2[j].obj.schemaname,
 					 tsdicts2[j].obj.objectname);
 
+			markOutputBuffer(bpre, 2, PGQ_CLASS_TS_DICT, tsdicts2[j].obj.oid);
 			dumpCreateTextSearchDict(fpre, &tsdicts2[j]);
 
 			j++;
@@ -3527,8 +5404,14 @@ quarrelTextSearchDicts()
 		}
 	}
 
-	freeTextSearchDicts(tsdicts1, ntsdicts1);
-	freeTextSearchDicts(tsdicts2, ntsdicts2);
+	resetArena(&arena1);
+	resetArena(&arena2);
+}
+
+static void
+fetchTextSearchParsers(QuarrelFetch *f)
+{
+	f->objects = getTextSearchParsers(f->conn, &f->nobjects);
 }
 
 static void
@@ -3539,10 +5422,14 @@ quarrelTextSearchParsers()
 	int			ntsparsers1 = 0;			/* # of text search parser */
 	int			ntsparsers2 = 0;
 	int			i, j;
+	QuarrelFetch	f1, f2;
 
 	/* TextSearchParsers */
-	tsparsers1 = getTextSearchParsers(conn1, &ntsparsers1);
-	tsparsers2 = getTextSearchParsers(conn2, &ntsparsers2);
+	fetchObjects(fetchTextSearchParsers, &f1, &f2);
+	tsparsers1 = f1.objects;
+	ntsparsers1 = f1.nobjects;
+	tsparsers2 = f2.objects;
+	ntsparsers2 = f2.nobjects;
 
 	for (i = 0; i < ntsparsers1; i++)
 		logNoise("server1: %s.%s", tsparsers1[i].obj.schemaname,
@@ -3567,6 +5454,7 @@ quarrelTextSearchParsers()
 			logDebug("text search parser %s.%s: server2", tsparsers2[j].obj.schemaname,
 					 tsparsers2[j].obj.objectname);
 
+			markOutputBuffer(bpre, 2, PGQ_CLASS_TS_PARSER, tsparsers2[j].obj.oid);
 			dumpCreateTextSearchParser(fpre, &tsparsers2[j]);
 
 			j++;
@@ -3578,6 +5466,7 @@ quarrelTextSearchParsers()
 			logDebug("text search parser %s.%s: server1", tsparsers1[i].obj.schemaname,
 					 tsparsers1[i].obj.objectname);
 
+			markOutputBuffer(bpost, 1, PGQ_CLASS_TS_PARSER, tsparsers1[i].obj.oid);
 			dumpDropTextSearchParser(fpost, &tsparsers1[i]);
 
 			i++;
@@ -3589,6 +5478,7 @@ quarrelTextSearchParsers()
 					 tsparsers1[i].obj.schemaname,
 					 tsparsers1[i].obj.objectname);
 
+			markOutputBuffer(bpre, 2, PGQ_CLASS_TS_PARSER, tsparsers2[j].obj.oid);
 			dumpAlterTextSearchParser(fpre, &tsparsers1[i], &tsparsers2[j]);
 
 			i++;
@@ -3599,6 +5489,7 @@ quarrelTextSearchParsers()
 			logDebug("text search parser %s.%s: server1", tsparsers1[i].obj.schemaname,
 					 tsparsers1[i].obj.objectname);
 
+			markOutputBuffer(bpost, 1, PGQ_CLASS_TS_PARSER, tsparsers1[i].obj.oid);
 			dumpDropTextSearchParser(fpost, &tsparsers1[i]);
 
 			i++;
@@ -3609,6 +5500,7 @@ quarrelTextSearchParsers()
 			logDebug("text search parser %s.%s: server2", tsparsers2[j].obj.schemaname,
 					 tsparsers2[j].obj.objectname);
 
+			markOutputBuffer(bpre, 2, PGQ_CLASS_TS_PARSER, tsparsers2[j].obj.oid);
 			dumpCreateTextSearchParser(fpre, &tsparsers2[j]);
 
 			j++;
@@ -3616,8 +5508,14 @@ quarrelTextSearchParsers()
 		}
 	}
 
-	freeTextSearchParsers(tsparsers1, ntsparsers1);
-	freeTextSearchParsers(tsparsers2, ntsparsers2);
+	resetArena(&arena1);
+	resetArena(&arena2);
+}
+
+static void
+fetchTextSearchTemplates(QuarrelFetch *f)
+{
+	f->objects = getTextSearchTemplates(f->conn, &f->nobjects);
 }
 
 static void
@@ -3628,10 +5526,14 @@ quarrelTextSearchTemplates()
 	int			ntstemplates1 = 0;					/* # of text search template */
 	int			ntstemplates2 = 0;
 	int			i, j;
+	QuarrelFetch	f1, f2;
 
 	/* TextSearchTemplates */
-	tstemplates1 = getTextSearchTemplates(conn1, &ntstemplates1);
-	tstemplates2 = getTextSearchTemplates(conn2, &ntstemplates2);
+	fetchObjects(fetchTextSearchTemplates, &f1, &f2);
+	tstemplates1 = f1.objects;
+	ntstemplates1 = f1.nobjects;
+	tstemplates2 = f2.objects;
+	ntstemplates2 = f2.nobjects;
 
 	for (i = 0; i < ntstemplates1; i++)
 		logNoise("server1: %s.%s", tstemplates1[i].obj.schemaname,
@@ -3656,6 +5558,7 @@ quarrelTextSearchTemplates()
 			logDebug("text search template %s.%s: server2", tstemplates2[j].obj.schemaname,
 					 tstemplates2[j].obj.objectname);
 
+			markOutputBuffer(bpre, 2, PGQ_CLASS_TS_TEMPLATE, tstemplates2[j].obj.oid);
 			dumpCreateTextSearchTemplate(fpre, &tstemplates2[j]);
 
 			j++;
@@ -3667,6 +5570,7 @@ quarrelTextSearchTemplates()
 			logDebug("text search template %s.%s: server1", tstemplates1[i].obj.schemaname,
 					 tstemplates1[i].obj.objectname);
 
+			markOutputBuffer(bpost, 1, PGQ_CLASS_TS_TEMPLATE, tstemplates1[i].obj.oid);
 			dumpDropTextSearchTemplate(fpost, &tstemplates1[i]);
 
 			i++;
@@ -3678,6 +5582,7 @@ quarrelTextSearchTemplates()
 					 tstemplates1[i].obj.schemaname,
 					 tstemplates1[i].obj.objectname);
 
+			markOutputBuffer(bpre, 2, PGQ_CLASS_TS_TEMPLATE, tstemplates2[j].obj.oid);
 			dumpAlterTextSearchTemplate(fpre, &tstemplates1[i], &tstemplates2[j]);
 
 			i++;
@@ -3688,6 +5593,7 @@ quarrelTextSearchTemplates()
 			logDebug("text search template %s.%s: server1", tstemplates1[i].obj.schemaname,
 					 tstemplates1[i].obj.objectname);
 
+			markOutputBuffer(bpost, 1, PGQ_CLASS_TS_TEMPLATE, tstemplates1[i].obj.oid);
 			dumpDropTextSearchTemplate(fpost, &tstemplates1[i]);
 
 			i++;
@@ -3698,6 +5604,7 @@ quarrelTextSearchTemplates()
 			logDebug("text search template %s.%s: server2", tstemplates2[j].obj.schemaname,
 					 tstemplates2[j].obj.objectname);
 
+			markOutputBuffer(bpre, 2, PGQ_CLASS_TS_TEMPLATE, tstemplates2[j].obj.oid);
 			dumpCreateTextSearchTemplate(fpre, &tstemplates2[j]);
 
 			j++;
@@ -3705,8 +5612,14 @@ quarrelTextSearchTemplates()
 		}
 	}
 
-	freeTextSearchTemplates(tstemplates1, ntstemplates1);
-	freeTextSearchTemplates(tstemplates2, ntstemplates2);
+	resetArena(&arena1);
+	resetArena(&arena2);
+}
+
+static void
+fetchTransforms(QuarrelFetch *f)
+{
+	f->objects = getTransforms(f->conn, &f->nobjects);
 }
 
 static void
@@ -3717,9 +5630,13 @@ quarrelTransforms()
 	int				ntransforms1 = 0;		/* # of transforms */
 	int				ntransforms2 = 0;
 	int				i, j;
+	QuarrelFetch	f1, f2;
 
-	transforms1 = getTransforms(conn1, &ntransforms1);
-	transforms2 = getTransforms(conn2, &ntransforms2);
+	fetchObjects(fetchTransforms, &f1, &f2);
+	transforms1 = f1.objects;
+	ntransforms1 = f1.nobjects;
+	transforms2 = f2.objects;
+	ntransforms2 = f2.nobjects;
 
 	for (i = 0; i < ntransforms1; i++)
 		logNoise("server1: transform for %s.%s language %s",
@@ -3747,6 +5664,7 @@ quarrelTransforms()
 					 transforms2[i].trftype.schemaname, transforms2[i].trftype.objectname,
 					 transforms2[i].languagename);
 
+			markOutputBuffer(bpre, 2, PGQ_CLASS_TRANSFORM, transforms2[j].trftype.oid);
 			dumpCreateTransform(fpre, &transforms2[j]);
 
 			j++;
@@ -3759,6 +5677,7 @@ quarrelTransforms()
 					 transforms1[i].trftype.schemaname, transforms1[i].trftype.objectname,
 					 transforms1[i].languagename);
 
+			markOutputBuffer(bpost, 1, PGQ_CLASS_TRANSFORM, transforms1[i].trftype.oid);
 			dumpDropTransform(fpost, &transforms1[i]);
 
 			i++;
@@ -3772,6 +5691,7 @@ quarrelTransforms()
 					 transforms1[i].trftype.schemaname, transforms1[i].trftype.objectname,
 					 transforms1[i].languagename);
 
+			markOutputBuffer(bpre, 2, PGQ_CLASS_TRANSFORM, transforms2[j].trftype.oid);
 			dumpAlterTransform(fpre, &transforms1[i], &transforms2[j]);
 
 			i++;
@@ -3785,6 +5705,7 @@ quarrelTransforms()
 					 transforms1[i].trftype.schemaname, transforms1[i].trftype.objectname,
 					 transforms1[i].languagename);
 
+			markOutputBuffer(bpost, 1, PGQ_CLASS_TRANSFORM, transforms1[i].trftype.oid);
 			dumpDropTransform(fpost, &transforms1[i]);
 
 			i++;
@@ -3798,6 +5719,7 @@ quarrelTransforms()
 					 transforms2[i].trftype.schemaname, transforms2[i].trftype.objectname,
 					 transforms2[i].languagename);
 
+			markOutputBuffer(bpre, 2, PGQ_CLASS_TRANSFORM, transforms2[j].trftype.oid);
 			dumpCreateTransform(fpre, &transforms2[j]);
 
 			j++;
@@ -3805,8 +5727,14 @@ quarrelTransforms()
 		}
 	}
 
-	freeTransforms(transforms1, ntransforms1);
-	freeTransforms(transforms2, ntransforms2);
+	resetArena(&arena1);
+	resetArena(&arena2);
+}
+
+static void
+fetchTriggers(QuarrelFetch *f)
+{
+	f->objects = getTriggers(f->conn, &f->nobjects);
 }
 
 static void
@@ -3817,9 +5745,13 @@ quarrelTriggers()
 	int			ntriggers1 = 0;		/* # of triggers */
 	int			ntriggers2 = 0;
 	int			i, j;
+	QuarrelFetch	f1, f2;
 
-	triggers1 = getTriggers(conn1, &ntriggers1);
-	triggers2 = getTriggers(conn2, &ntriggers2);
+	fetchObjects(fetchTriggers, &f1, &f2);
+	triggers1 = f1.objects;
+	ntriggers1 = f1.nobjects;
+	triggers2 = f2.objects;
+	ntriggers2 = f2.nobjects;
 
 	for (i = 0; i < ntriggers1; i++)
 		logNoise("server1: %s.%s", triggers1[i].table.schemaname,
@@ -3844,6 +5776,7 @@ quarrelTriggers()
 			logDebug("trigger %s.%s: server2", triggers2[j].table.schemaname,
 					 triggers2[j].table.objectname);
 
+			markOutputBuffer(bpre, 2, PGQ_CLASS_TRIGGER, triggers2[j].oid);
 			dumpCreateTrigger(fpre, &triggers2[j]);
 
 			j++;
@@ -3855,6 +5788,7 @@ quarrelTriggers()
 			logDebug("trigger %s.%s: server1", triggers1[i].table.schemaname,
 					 triggers1[i].table.objectname);
 
+			markOutputBuffer(bpost, 1, PGQ_CLASS_TRIGGER, triggers1[i].oid);
 			dumpDropTrigger(fpost, &triggers1[i]);
 
 			i++;
@@ -3866,6 +5800,7 @@ quarrelTriggers()
 			logDebug("trigger %s.%s: server1 server2", triggers1[i].table.schemaname,
 					 triggers1[i].table.objectname);
 
+			markOutputBuffer(bpre, 2, PGQ_CLASS_TRIGGER, triggers2[j].oid);
 			dumpAlterTrigger(fpre, &triggers1[i], &triggers2[j]);
 
 			i++;
@@ -3877,6 +5812,7 @@ quarrelTriggers()
 			logDebug("trigger %s.%s: server1", triggers1[i].table.schemaname,
 					 triggers1[i].table.objectname);
 
+			markOutputBuffer(bpost, 1, PGQ_CLASS_TRIGGER, triggers1[i].oid);
 			dumpDropTrigger(fpost, &triggers1[i]);
 
 			i++;
@@ -3888,6 +5824,7 @@ quarrelTriggers()
 			logDebug("trigger %s.%s: server2", triggers2[j].table.schemaname,
 					 triggers2[j].table.objectname);
 
+			markOutputBuffer(bpre, 2, PGQ_CLASS_TRIGGER, triggers2[j].oid);
 			dumpCreateTrigger(fpre, &triggers2[j]);
 
 			j++;
@@ -3895,8 +5832,20 @@ quarrelTriggers()
 		}
 	}
 
-	freeTriggers(triggers1, ntriggers1);
-	freeTriggers(triggers2, ntriggers2);
+	resetArena(&arena1);
+	resetArena(&arena2);
+}
+
+static void
+fetchBaseTypes(QuarrelFetch *f)
+{
+	PQLBaseType	*types;
+
+	types = getBaseTypes(f->conn, &f->nobjects);
+	if (options.securitylabels)
+		getBaseTypeSecurityLabels(f->conn, types, f->nobjects);
+
+	f->objects = types;
 }
 
 static void
@@ -3907,9 +5856,13 @@ quarrelBaseTypes()
 	int			ntypes1 = 0;		/* # of types */
 	int			ntypes2 = 0;
 	int			i, j;
+	QuarrelFetch	f1, f2;
 
-	types1 = getBaseTypes(conn1, &ntypes1);
-	types2 = getBaseTypes(conn2, &ntypes2);
+	fetchObjects(fetchBaseTypes, &f1, &f2);
+	types1 = f1.objects;
+	ntypes1 = f1.nobjects;
+	types2 = f2.objects;
+	ntypes2 = f2.nobjects;
 
 	for (i = 0; i < ntypes1; i++)
 		logNoise("server1: %s.%s", types1[i].obj.schemaname,
@@ -3934,9 +5887,7 @@ quarrelBaseTypes()
 			logDebug("type %s.%s: server2", types2[j].obj.schemaname,
 					 types2[j].obj.objectname);
 
-			if (options.securitylabels)
-				getBaseTypeSecurityLabels(conn2, &types2[j]);
-
+			markOutputBuffer(bpre, 2, PGQ_CLASS_TYPE, types2[j].obj.oid);
 			dumpCreateBaseType(fpre, &types2[j]);
 
 			j++;
@@ -3948,6 +5899,7 @@ quarrelBaseTypes()
 			logDebug("type %s.%s: server1", types1[i].obj.schemaname,
 					 types1[i].obj.objectname);
 
+			markOutputBuffer(bpost, 1, PGQ_CLASS_TYPE, types1[i].obj.oid);
 			dumpDropBaseType(fpost, &types1[i]);
 
 			i++;
@@ -3958,12 +5910,7 @@ quarrelBaseTypes()
 			logDebug("type %s.%s: server1 server2", types1[i].obj.schemaname,
 					 types1[i].obj.objectname);
 
-			if (options.securitylabels)
-			{
-				getBaseTypeSecurityLabels(conn1, &types1[i]);
-				getBaseTypeSecurityLabels(conn2, &types2[j]);
-			}
-
+			markOutputBuffer(bpre, 2, PGQ_CLASS_TYPE, types2[j].obj.oid);
 			dumpAlterBaseType(fpre, &types1[i], &types2[j]);
 
 			i++;
@@ -3974,6 +5921,7 @@ quarrelBaseTypes()
 			logDebug("type %s.%s: server1", types1[i].obj.schemaname,
 					 types1[i].obj.objectname);
 
+			markOutputBuffer(bpost, 1, PGQ_CLASS_TYPE, types1[i].obj.oid);
 			dumpDropBaseType(fpost, &types1[i]);
 
 			i++;
@@ -3984,9 +5932,7 @@ quarrelBaseTypes()
 			logDebug("type %s.%s: server2", types2[j].obj.schemaname,
 					 types2[j].obj.objectname);
 
-			if (options.securitylabels)
-				getBaseTypeSecurityLabels(conn2, &types2[j]);
-
+			markOutputBuffer(bpre, 2, PGQ_CLASS_TYPE, types2[j].obj.oid);
 			dumpCreateBaseType(fpre, &types2[j]);
 
 			j++;
@@ -3994,8 +5940,20 @@ quarrelBaseTypes()
 		}
 	}
 
-	freeBaseTypes(types1, ntypes1);
-	freeBaseTypes(types2, ntypes2);
+	resetArena(&arena1);
+	resetArena(&arena2);
+}
+
+static void
+fetchCompositeTypes(QuarrelFetch *f)
+{
+	PQLCompositeType	*types;
+
+	types = getCompositeTypes(f->conn, &f->nobjects);
+	if (options.securitylabels)
+		getCompositeTypeSecurityLabels(f->conn, types, f->nobjects);
+
+	f->objects = types;
 }
 
 static void
@@ -4006,9 +5964,13 @@ quarrelCompositeTypes()
 	int			ntypes1 = 0;		/* # of types */
 	int			ntypes2 = 0;
 	int			i, j;
+	QuarrelFetch	f1, f2;
 
-	types1 = getCompositeTypes(conn1, &ntypes1);
-	types2 = getCompositeTypes(conn2, &ntypes2);
+	fetchObjects(fetchCompositeTypes, &f1, &f2);
+	types1 = f1.objects;
+	ntypes1 = f1.nobjects;
+	types2 = f2.objects;
+	ntypes2 = f2.nobjects;
 
 	for (i = 0; i < ntypes1; i++)
 		logNoise("server1: %s.%s", types1[i].obj.schemaname,
@@ -4033,9 +5995,7 @@ quarrelCompositeTypes()
 			logDebug("type %s.%s: server2", types2[j].obj.schemaname,
 					 types2[j].obj.objectname);
 
-			if (options.securitylabels)
-				getCompositeTypeSecurityLabels(conn2, &types2[j]);
-
+			markOutputBuffer(bpre, 2, PGQ_CLASS_TYPE, types2[j].obj.oid);
 			dumpCreateCompositeType(fpre, &types2[j]);
 
 			j++;
@@ -4047,6 +6007,7 @@ quarrelCompositeTypes()
 			logDebug("type %s.%s: server1", types1[i].obj.schemaname,
 					 types1[i].obj.objectname);
 
+			markOutputBuffer(bpost, 1, PGQ_CLASS_TYPE, types1[i].obj.oid);
 			dumpDropCompositeType(fpost, &types1[i]);
 
 			i++;
@@ -4057,12 +6018,7 @@ quarrelCompositeTypes()
 			logDebug("type %s.%s: server1 server2", types1[i].obj.schemaname,
 					 types1[i].obj.objectname);
 
-			if (options.securitylabels)
-			{
-				getCompositeTypeSecurityLabels(conn1, &types1[i]);
-				getCompositeTypeSecurityLabels(conn2, &types2[j]);
-			}
-
+			markOutputBuffer(bpre, 2, PGQ_CLASS_TYPE, types2[j].obj.oid);
 			dumpAlterCompositeType(fpre, &types1[i], &types2[j]);
 
 			i++;
@@ -4073,6 +6029,7 @@ quarrelCompositeTypes()
 			logDebug("type %s.%s: server1", types1[i].obj.schemaname,
 					 types1[i].obj.objectname);
 
+			markOutputBuffer(bpost, 1, PGQ_CLASS_TYPE, types1[i].obj.oid);
 			dumpDropCompositeType(fpost, &types1[i]);
 
 			i++;
@@ -4083,9 +6040,7 @@ quarrelCompositeTypes()
 			logDebug("type %s.%s: server2", types2[j].obj.schemaname,
 					 types2[j].obj.objectname);
 
-			if (options.securitylabels)
-				getCompositeTypeSecurityLabels(conn2, &types2[j]);
-
+			markOutputBuffer(bpre, 2, PGQ_CLASS_TYPE, types2[j].obj.oid);
 			dumpCreateCompositeType(fpre, &types2[j]);
 
 			j++;
@@ -4093,8 +6048,20 @@ quarrelCompositeTypes()
 		}
 	}
 
-	freeCompositeTypes(types1, ntypes1);
-	freeCompositeTypes(types2, ntypes2);
+	resetArena(&arena1);
+	resetArena(&arena2);
+}
+
+static void
+fetchEnumTypes(QuarrelFetch *f)
+{
+	PQLEnumType	*types;
+
+	types = getEnumTypes(f->conn, &f->nobjects);
+	if (options.securitylabels)
+		getEnumTypeSecurityLabels(f->conn, types, f->nobjects);
+
+	f->objects = types;
 }
 
 static void
@@ -4105,9 +6072,13 @@ quarrelEnumTypes()
 	int			ntypes1 = 0;		/* # of types */
 	int			ntypes2 = 0;
 	int			i, j;
+	QuarrelFetch	f1, f2;
 
-	types1 = getEnumTypes(conn1, &ntypes1);
-	types2 = getEnumTypes(conn2, &ntypes2);
+	fetchObjects(fetchEnumTypes, &f1, &f2);
+	types1 = f1.objects;
+	ntypes1 = f1.nobjects;
+	types2 = f2.objects;
+	ntypes2 = f2.nobjects;
 
 	for (i = 0; i < ntypes1; i++)
 		logNoise("server1: %s.%s", types1[i].obj.schemaname,
@@ -4132,9 +6103,7 @@ quarrelEnumTypes()
 			logDebug("type %s.%s: server2", types2[j].obj.schemaname,
 					 types2[j].obj.objectname);
 
-			if (options.securitylabels)
-				getEnumTypeSecurityLabels(conn2, &types2[j]);
-
+			markOutputBuffer(bpre, 2, PGQ_CLASS_TYPE, types2[j].obj.oid);
 			dumpCreateEnumType(fpre, &types2[j]);
 
 			j++;
@@ -4146,6 +6115,7 @@ quarrelEnumTypes()
 			logDebug("type %s.%s: server1", types1[i].obj.schemaname,
 					 types1[i].obj.objectname);
 
+			markOutputBuffer(bpost, 1, PGQ_CLASS_TYPE, types1[i].obj.oid);
 			dumpDropEnumType(fpost, &types1[i]);
 
 			i++;
@@ -4156,12 +6126,7 @@ quarrelEnumTypes()
 			logDebug("type %s.%s: server1 server2", types1[i].obj.schemaname,
 					 types1[i].obj.objectname);
 
-			if (options.securitylabels)
-			{
-				getEnumTypeSecurityLabels(conn1, &types1[i]);
-				getEnumTypeSecurityLabels(conn2, &types2[j]);
-			}
-
+			markOutputBuffer(bpre, 2, PGQ_CLASS_TYPE, types2[j].obj.oid);
 			dumpAlterEnumType(fpre, &types1[i], &types2[j]);
 
 			i++;
@@ -4172,6 +6137,7 @@ quarrelEnumTypes()
 			logDebug("type %s.%s: server1", types1[i].obj.schemaname,
 					 types1[i].obj.objectname);
 
+			markOutputBuffer(bpost, 1, PGQ_CLASS_TYPE, types1[i].obj.oid);
 			dumpDropEnumType(fpost, &types1[i]);
 
 			i++;
@@ -4182,9 +6148,7 @@ quarrelEnumTypes()
 			logDebug("type %s.%s: server2", types2[j].obj.schemaname,
 					 types2[j].obj.objectname);
 
-			if (options.securitylabels)
-				getEnumTypeSecurityLabels(conn2, &types2[j]);
-
+			markOutputBuffer(bpre, 2, PGQ_CLASS_TYPE, types2[j].obj.oid);
 			dumpCreateEnumType(fpre, &types2[j]);
 
 			j++;
@@ -4192,8 +6156,20 @@ quarrelEnumTypes()
 		}
 	}
 
-	freeEnumTypes(types1, ntypes1);
-	freeEnumTypes(types2, ntypes2);
+	resetArena(&arena1);
+	resetArena(&arena2);
+}
+
+static void
+fetchRangeTypes(QuarrelFetch *f)
+{
+	PQLRangeType	*types;
+
+	types = getRangeTypes(f->conn, &f->nobjects);
+	if (options.securitylabels)
+		getRangeTypeSecurityLabels(f->conn, types, f->nobjects);
+
+	f->objects = types;
 }
 
 static void
@@ -4204,9 +6180,13 @@ quarrelRangeTypes()
 	int			ntypes1 = 0;		/* # of types */
 	int			ntypes2 = 0;
 	int			i, j;
+	QuarrelFetch	f1, f2;
 
-	types1 = getRangeTypes(conn1, &ntypes1);
-	types2 = getRangeTypes(conn2, &ntypes2);
+	fetchObjects(fetchRangeTypes, &f1, &f2);
+	types1 = f1.objects;
+	ntypes1 = f1.nobjects;
+	types2 = f2.objects;
+	ntypes2 = f2.nobjects;
 
 	for (i = 0; i < ntypes1; i++)
 		logNoise("server1: %s.%s", types1[i].obj.schemaname,
@@ -4231,9 +6211,7 @@ quarrelRangeTypes()
 			logDebug("type %s.%s: server2", types2[j].obj.schemaname,
 					 types2[j].obj.objectname);
 
-			if (options.securitylabels)
-				getRangeTypeSecurityLabels(conn2, &types2[j]);
-
+			markOutputBuffer(bpre, 2, PGQ_CLASS_TYPE, types2[j].obj.oid);
 			dumpCreateRangeType(fpre, &types2[j]);
 
 			j++;
@@ -4245,6 +6223,7 @@ quarrelRangeTypes()
 			logDebug("type %s.%s: server1", types1[i].obj.schemaname,
 					 types1[i].obj.objectname);
 
+			markOutputBuffer(bpost, 1, PGQ_CLASS_TYPE, types1[i].obj.oid);
 			dumpDropRangeType(fpost, &types1[i]);
 
 			i++;
@@ -4255,12 +6234,7 @@ quarrelRangeTypes()
 			logDebug("type %s.%s: server1 server2", types1[i].obj.schemaname,
 					 types1[i].obj.objectname);
 
-			if (options.securitylabels)
-			{
-				getRangeTypeSecurityLabels(conn1, &types1[i]);
-				getRangeTypeSecurityLabels(conn2, &types2[j]);
-			}
-
+			markOutputBuffer(bpre, 2, PGQ_CLASS_TYPE, types2[j].obj.oid);
 			dumpAlterRangeType(fpre, &types1[i], &types2[j]);
 
 			i++;
@@ -4271,6 +6245,7 @@ quarrelRangeTypes()
 			logDebug("type %s.%s: server1", types1[i].obj.schemaname,
 					 types1[i].obj.objectname);
 
+			markOutputBuffer(bpost, 1, PGQ_CLASS_TYPE, types1[i].obj.oid);
 			dumpDropRangeType(fpost, &types1[i]);
 
 			i++;
@@ -4281,9 +6256,7 @@ quarrelRangeTypes()
 			logDebug("type %s.%s: server2", types2[j].obj.schemaname,
 					 types2[j].obj.objectname);
 
-			if (options.securitylabels)
-				getRangeTypeSecurityLabels(conn2, &types2[j]);
-
+			markOutputBuffer(bpre, 2, PGQ_CLASS_TYPE, types2[j].obj.oid);
 			dumpCreateRangeType(fpre, &types2[j]);
 
 			j++;
@@ -4291,8 +6264,8 @@ quarrelRangeTypes()
 		}
 	}
 
-	freeRangeTypes(types1, ntypes1);
-	freeRangeTypes(types2, ntypes2);
+	resetArena(&arena1);
+	resetArena(&arena2);
 }
 
 static void
@@ -4304,6 +6277,12 @@ quarrelTypes()
 	quarrelRangeTypes();
 }
 
+static void
+fetchUserMappings(QuarrelFetch *f)
+{
+	f->objects = getUserMappings(f->conn, &f->nobjects);
+}
+
 static void
 quarrelUserMappings()
 {
@@ -4312,9 +6291,13 @@ quarrelUserMappings()
 	int			nusermappings1 = 0;		/* # of user mappings */
 	int			nusermappings2 = 0;
 	int			i, j;
+	QuarrelFetch	f1, f2;
 
-	usermappings1 = getUserMappings(conn1, &nusermappings1);
-	usermappings2 = getUserMappings(conn2, &nusermappings2);
+	fetchObjects(fetchUserMappings, &f1, &f2);
+	usermappings1 = f1.objects;
+	nusermappings1 = f1.nobjects;
+	usermappings2 = f2.objects;
+	nusermappings2 = f2.nobjects;
 
 	for (i = 0; i < nusermappings1; i++)
 		logNoise("server1: user(%s) server(%s)", usermappings1[i].user,
@@ -4339,6 +6322,7 @@ quarrelUserMappings()
 			logDebug("user mapping user(%s) server(%s): server2", usermappings2[j].user,
 					 usermappings2[j].server);
 
+			markOutputBuffer(bpre, 2, PGQ_CLASS_USER_MAPPING, usermappings2[j].oid);
 			dumpCreateUserMapping(fpre, &usermappings2[j]);
 
 			j++;
@@ -4350,6 +6334,7 @@ quarrelUserMappings()
 			logDebug("user mapping user(%s) server(%s): server1", usermappings1[i].user,
 					 usermappings1[i].server);
 
+			markOutputBuffer(bpost, 1, PGQ_CLASS_USER_MAPPING, usermappings1[i].oid);
 			dumpDropUserMapping(fpost, &usermappings1[i]);
 
 			i++;
@@ -4360,6 +6345,7 @@ quarrelUserMappings()
 			logDebug("user mapping user(%s) server(%s): server1 server2",
 					 usermappings1[i].user, usermappings1[i].server);
 
+			markOutputBuffer(bpre, 2, PGQ_CLASS_USER_MAPPING, usermappings2[j].oid);
 			dumpAlterUserMapping(fpre, &usermappings1[i], &usermappings2[j]);
 
 			i++;
@@ -4370,6 +6356,7 @@ quarrelUserMappings()
 			logDebug("user mapping user(%s) server(%s): server1", usermappings1[i].user,
 					 usermappings1[i].server);
 
+			markOutputBuffer(bpost, 1, PGQ_CLASS_USER_MAPPING, usermappings1[i].oid);
 			dumpDropUserMapping(fpost, &usermappings1[i]);
 
 			i++;
@@ -4380,6 +6367,7 @@ quarrelUserMappings()
 			logDebug("user mapping user(%s) server(%s): server2", usermappings2[j].user,
 					 usermappings2[j].server);
 
+			markOutputBuffer(bpre, 2, PGQ_CLASS_USER_MAPPING, usermappings2[j].oid);
 			dumpCreateUserMapping(fpre, &usermappings2[j]);
 
 			j++;
@@ -4387,8 +6375,20 @@ quarrelUserMappings()
 		}
 	}
 
-	freeUserMappings(usermappings1, nusermappings1);
-	freeUserMappings(usermappings2, nusermappings2);
+	resetArena(&arena1);
+	resetArena(&arena2);
+}
+
+static void
+fetchViews(QuarrelFetch *f)
+{
+	PQLView	*views;
+
+	views = getViews(f->conn, &f->nobjects);
+	if (options.securitylabels)
+		getViewSecurityLabels(f->conn, views, f->nobjects);
+
+	f->objects = views;
 }
 
 static void
@@ -4399,9 +6399,13 @@ quarrelViews()
 	int			nviews1 = 0;		/* # of views */
 	int			nviews2 = 0;
 	int			i, j;
+	QuarrelFetch	f1, f2;
 
-	views1 = getViews(conn1, &nviews1);
-	views2 = getViews(conn2, &nviews2);
+	fetchObjects(fetchViews, &f1, &f2);
+	views1 = f1.objects;
+	nviews1 = f1.nobjects;
+	views2 = f2.objects;
+	nviews2 = f2.nobjects;
 
 	for (i = 0; i < nviews1; i++)
 		logNoise("server1: %s.%s", views1[i].obj.schemaname,
@@ -4426,9 +6430,7 @@ quarrelViews()
 			logDebug("view %s.%s: server2", views2[j].obj.schemaname,
 					 views2[j].obj.objectname);
 
-			if (options.securitylabels)
-				getViewSecurityLabels(conn2, &views2[j]);
-
+			markOutputBuffer(bpre, 2, PGQ_CLASS_CLASS, views2[j].obj.oid);
 			dumpCreateView(fpre, &views2[j]);
 
 			j++;
@@ -4440,6 +6442,7 @@ quarrelViews()
 			logDebug("view %s.%s: server1", views1[i].obj.schemaname,
 					 views1[i].obj.objectname);
 
+			markOutputBuffer(bpost, 1, PGQ_CLASS_CLASS, views1[i].obj.oid);
 			dumpDropView(fpost, &views1[i]);
 
 			i++;
@@ -4450,12 +6453,7 @@ quarrelViews()
 			logDebug("view %s.%s: server1 server2", views1[i].obj.schemaname,
 					 views1[i].obj.objectname);
 
-			if (options.securitylabels)
-			{
-				getViewSecurityLabels(conn1, &views1[i]);
-				getViewSecurityLabels(conn2, &views2[j]);
-			}
-
+			markOutputBuffer(bpre, 2, PGQ_CLASS_CLASS, views2[j].obj.oid);
 			dumpAlterView(fpre, &views1[i], &views2[j]);
 
 			i++;
@@ -4466,6 +6464,7 @@ quarrelViews()
 			logDebug("view %s.%s: server1", views1[i].obj.schemaname,
 					 views1[i].obj.objectname);
 
+			markOutputBuffer(bpost, 1, PGQ_CLASS_CLASS, views1[i].obj.oid);
 			dumpDropView(fpost, &views1[i]);
 
 			i++;
@@ -4476,9 +6475,7 @@ quarrelViews()
 			logDebug("view %s.%s: server2", views2[j].obj.schemaname,
 					 views2[j].obj.objectname);
 
-			if (options.securitylabels)
-				getViewSecurityLabels(conn2, &views2[j]);
-
+			markOutputBuffer(bpre, 2, PGQ_CLASS_CLASS, views2[j].obj.oid);
 			dumpCreateView(fpre, &views2[j]);
 
 			j++;
@@ -4486,127 +6483,8 @@ quarrelViews()
 		}
 	}
 
-	freeViews(views1, nviews1);
-	freeViews(views2, nviews2);
-}
-
-static void
-mergeTempFiles(FILE *pre, FILE *post, FILE *output)
-{
-	char	buf[4096];
-
-	if (pre == NULL)
-	{
-		logError("file descriptor \"pre\" is invalid");
-		exit(EXIT_FAILURE);
-	}
-
-	if (post == NULL)
-	{
-		logError("file descriptor \"post\" is invalid");
-		exit(EXIT_FAILURE);
-	}
-
-	/* paranoia? */
-	fflush(pre);
-	fflush(post);
-
-	/* start from the beginning */
-	rewind(pre);
-	rewind(post);
-
-	while (fgets(buf, sizeof(buf), pre) != NULL)
-	{
-		if (fputs(buf, output) == EOF)
-		{
-			logError("could not write to temporary file \"%s\": %s", prepath,
-					 strerror(errno));
-			exit(EXIT_FAILURE);
-		}
-	}
-
-	/* EOF is expected to be reached. Check feof()? */
-	if (ferror(pre) != 0)
-	{
-		logError("error while reading temporary file \"%s\": %s", prepath,
-				 strerror(errno));
-		exit(EXIT_FAILURE);
-	}
-
-	while (fgets(buf, sizeof(buf), post) != NULL)
-	{
-		if (fputs(buf, output) == EOF)
-		{
-			logError("could not write to temporary file \"%s\": %s", postpath,
-					 strerror(errno));
-			exit(EXIT_FAILURE);
-		}
-	}
-
-	/* EOF is expected to be reached. Check feof()? */
-	if (ferror(post) != 0)
-	{
-		logError("error while reading temporary file \"%s\": %s", postpath,
-				 strerror(errno));
-		exit(EXIT_FAILURE);
-	}
-}
-
-/*
- * Statements will be written temporarily in two files until the end of the
- * diff operation. At the end, files will be combined in the right order on the
- * output file and temporary files will be removed.
- */
-static FILE *
-openTempFile(char *p)
-{
-	FILE	*fp;
-
-	fp = fopen(p, "w+");
-	if (!fp)
-	{
-		logError("could not open temporary file \"%s\": %s", p, strerror(errno));
-		exit(EXIT_FAILURE);
-	}
-
-	return fp;
-}
-
-/*
- * Close and remove the temporary file
- */
-static void
-closeTempFile(FILE *fp, char *p)
-{
-	fclose(fp);
-
-	if (unlink(p))
-	{
-		logError("could not remove temporary file \"%s\": %s", p, strerror(errno));
-		exit(EXIT_FAILURE);
-	}
-}
-
-static bool
-isEmptyFile(char *p)
-{
-	struct stat		buf;
-	bool			r;
-
-	if (stat(p, &buf) < 0)
-	{
-		logError("could not stat temporary file \"%s\": %s", p, strerror(errno));
-		exit(EXIT_FAILURE);
-	}
-
-	logDebug("%s temporary file size: %d", p, buf.st_size);
-
-	if (buf.st_size > 0)
-		r = false;
-	else
-		r = true;
-
-	return r;
+	resetArena(&arena1);
+	resetArena(&arena2);
 }
 
 static void
@@ -4629,6 +6507,7 @@ int main(int argc, char *argv[])
 		{"file", required_argument, NULL, 'f'},
 		{"summary", no_argument, NULL, 's'},
 		{"single-transaction", no_argument, NULL, 't'},
+		{"jobs", required_argument, NULL, 'j'},
 		{"verbose", no_argument, NULL, 'v'},
 		/* the following options does not have an equivalent short letter */
 		{"source-dbname", required_argument, NULL, 2},
@@ -4676,16 +6555,37 @@ int main(int argc, char *argv[])
 		{"temp-directory", required_argument, NULL, 37},
 		{"include-schema", required_argument, NULL, 45},
 		{"exclude-schema", required_argument, NULL, 46},
+		{"pipeline", required_argument, NULL, 47},
+		{"source-catalog", required_argument, NULL, 50},
+		{"target-catalog", required_argument, NULL, 51},
+		{"dump-catalog", required_argument, NULL, 52},
+		{"cache-directory", required_argument, NULL, 53},
+		{"log-format", required_argument, NULL, 54},
+		{"output-buffer-size", required_argument, NULL, 55},
+		{"dependency-order", required_argument, NULL, 56},
+		{"parallel-directory", required_argument, NULL, 57},
+		{"online", no_argument, NULL, 58},
+		{"annotate-cost", required_argument, NULL, 59},
+		{"cost-threshold", required_argument, NULL, 60},
+		{"schema-grants", required_argument, NULL, 61},
+		{"statement-timeout", required_argument, NULL, 48},
+		{"lock-timeout", required_argument, NULL, 49},
 		{NULL, 0, NULL, 0}
 	};
 
 	int			optindex;
 	int			c;
+	int			i;
 
 	char		*configfile = NULL;
+	bool		fanout;
+	char		*cachepath1 = NULL;
+	char		*cachepath2 = NULL;
+	char		path[PGQMAXPATH];
 
 	bool		output_given = false;
 	bool		tmpdir_given = false;
+	bool		logformat_given = false;
 	bool		source_prompt_given = false;
 	bool		target_prompt_given = false;
 	bool		include_schema_given = false;
@@ -4725,7 +6625,7 @@ int main(int argc, char *argv[])
 	opts.target.istarget = true;
 
 	/* process command-line options */
-	while ((c = getopt_long(argc, argv, "c:f:stv", long_options, &optindex)) != -1)
+	while ((c = getopt_long(argc, argv, "c:f:j:stv", long_options, &optindex)) != -1)
 	{
 		switch (c)
 		{
@@ -4744,6 +6644,10 @@ int main(int argc, char *argv[])
 				gopts.singletxn = true;
 				gopts_given.singletxn = true;
 				break;
+			case 'j':
+				gopts.jobs = parseInteger("jobs", optarg, 1, PGQ_MAX_JOBS);
+				gopts_given.jobs = true;
+				break;
 			case 'v':
 				if (loglevel == PGQ_ERROR)
 					loglevel = PGQ_WARNING;
@@ -4927,6 +6831,63 @@ int main(int argc, char *argv[])
 				gopts.exclude_schema = strdup(optarg);
 				exclude_schema_given = true;
 				break;
+			case 47:
+				gopts.pipeline = parseBoolean("pipeline", optarg);
+				gopts_given.pipeline = true;
+				break;
+			case 48:
+				gopts.statementtimeout = parseInteger("statement-timeout", optarg, 0,
+													  INT_MAX);
+				gopts_given.statementtimeout = true;
+				break;
+			case 49:
+				gopts.locktimeout = parseInteger("lock-timeout", optarg, 0, INT_MAX);
+				gopts_given.locktimeout = true;
+				break;
+			case 50:
+				sopts.catalog = strdup(optarg);		/* source.catalog */
+				break;
+			case 51:
+				topts.catalog = strdup(optarg);		/* target.catalog */
+				break;
+			case 52:
+				gopts.dumpcatalog = strdup(optarg);
+				break;
+			case 53:
+				gopts.cachedir = strdup(optarg);
+				break;
+			case 54:
+				gopts.logformat = parseLogFormat("log-format", optarg);
+				logformat_given = true;
+				break;
+			case 55:
+				gopts.outputbuffersize = parseInteger("output-buffer-size", optarg, 0,
+													  INT_MAX / 1024);
+				gopts_given.outputbuffersize = true;
+				break;
+			case 56:
+				gopts.dependencyorder = parseBoolean("dependency-order", optarg);
+				gopts_given.dependencyorder = true;
+				break;
+			case 57:
+				gopts.paralleldir = strdup(optarg);
+				break;
+			case 58:
+				gopts.online = true;
+				gopts_given.online = true;
+				break;
+			case 59:
+				gopts.annotatecost = parseBoolean("annotate-cost", optarg);
+				gopts_given.annotatecost = true;
+				break;
+			case 60:
+				gopts.costthreshold = parseInteger("cost-threshold", optarg, 0, INT_MAX);
+				gopts_given.costthreshold = true;
+				break;
+			case 61:
+				gopts.schemagrants = parseBoolean("schema-grants", optarg);
+				gopts_given.schemagrants = true;
+				break;
 			default:
 				fprintf(stderr, "Try \"%s --help\" for more information.\n", PGQ_NAME);
 				exit(EXIT_FAILURE);
@@ -4950,6 +6911,9 @@ int main(int argc, char *argv[])
 		options.output = gopts.output;
 	if (tmpdir_given)
 		options.tmpdir = gopts.tmpdir;
+	if (logformat_given)
+		options.logformat = gopts.logformat;
+	logformat = options.logformat;
 
 	if (options.verbose && loglevel == PGQ_ERROR)
 		loglevel = PGQ_DEBUG;
@@ -4959,6 +6923,26 @@ int main(int argc, char *argv[])
 		options.summary = gopts.summary;
 	if (gopts_given.singletxn)
 		options.singletxn = gopts.singletxn;
+	if (gopts_given.pipeline)
+		options.pipeline = gopts.pipeline;
+	if (gopts_given.jobs)
+		options.jobs = gopts.jobs;
+	if (gopts_given.statementtimeout)
+		options.statementtimeout = gopts.statementtimeout;
+	if (gopts_given.locktimeout)
+		options.locktimeout = gopts.locktimeout;
+	if (gopts_given.outputbuffersize)
+		options.outputbuffersize = gopts.outputbuffersize;
+	if (gopts_given.dependencyorder)
+		options.dependencyorder = gopts.dependencyorder;
+	if (gopts_given.online)
+		options.online = gopts.online;
+	if (gopts_given.annotatecost)
+		options.annotatecost = gopts.annotatecost;
+	if (gopts_given.costthreshold)
+		options.costthreshold = gopts.costthreshold;
+	if (gopts_given.schemagrants)
+		options.schemagrants = gopts.schemagrants;
 
 	if (gopts_given.aggregate)
 		options.aggregate = gopts.aggregate;
@@ -5027,6 +7011,12 @@ int main(int argc, char *argv[])
 		options.include_schema = gopts.include_schema;
 	if (exclude_schema_given)
 		options.exclude_schema = gopts.exclude_schema;
+	if (gopts.dumpcatalog)
+		options.dumpcatalog = gopts.dumpcatalog;
+	if (gopts.cachedir)
+		options.cachedir = gopts.cachedir;
+	if (gopts.paralleldir)
+		options.paralleldir = gopts.paralleldir;
 
 	if (sopts.dbname)
 		opts.source.dbname = sopts.dbname;
@@ -5038,6 +7028,8 @@ int main(int argc, char *argv[])
 		opts.source.username = sopts.username;
 	if (source_prompt_given)
 		opts.source.promptpassword = sopts.promptpassword;
+	if (sopts.catalog)
+		opts.source.catalog = sopts.catalog;
 
 	if (topts.dbname)
 		opts.target.dbname = topts.dbname;
@@ -5049,41 +7041,104 @@ int main(int argc, char *argv[])
 		opts.target.username = topts.username;
 	if (target_prompt_given)
 		opts.target.promptpassword = topts.promptpassword;
+	if (topts.catalog)
+		opts.target.catalog = topts.catalog;
+
+	/*
+	 * --dump-catalog compares the source with itself. The result of every
+	 * catalog query is recorded; there are no changes to output.
+	 */
+	if (options.dumpcatalog)
+	{
+		if (opts.source.catalog)
+		{
+			logError("cannot dump a catalog from a catalog file");
+			exit(EXIT_FAILURE);
+		}
+		options.jobs = 1;
+	}
+
+	/* CREATE INDEX CONCURRENTLY cannot run inside a transaction block */
+	if (options.online && options.singletxn)
+	{
+		logError("online cannot be used with single-transaction");
+		exit(EXIT_FAILURE);
+	}
+
+	/* waves are computed by the dependency sort */
+	if (options.paralleldir && !options.dependencyorder)
+	{
+		logError("parallel-directory requires dependency-order");
+		exit(EXIT_FAILURE);
+	}
+
+	/*
+	 * Compare source with each [target.NAME] section. Options that are not
+	 * informed in that section are inherited from target options. Targets
+	 * are connected by worker threads so password is never prompted.
+	 */
+	fanout = (opts.ntargets > 0 && options.dumpcatalog == NULL);
+	for (i = 0; i < opts.ntargets; i++)
+	{
+		QuarrelTargetOptions	*t = &opts.targets[i];
+
+		if (t->db.host == NULL)
+			t->db.host = opts.target.host;
+		if (t->db.port == NULL)
+			t->db.port = opts.target.port;
+		if (t->db.username == NULL)
+			t->db.username = opts.target.username;
+		if (t->db.password == NULL)
+			t->db.password = opts.target.password;
+		if (t->db.dbname == NULL)
+			t->db.dbname = opts.target.dbname;
+		t->db.promptpassword = false;
+	}
 
 	/* connecting to server1 ... */
-	conn1 = connectDatabase(opts.target);
+	if (options.dumpcatalog || fanout)
+		conn1 = connectDatabase(opts.source);
+	else
+		conn1 = connectDatabase(opts.target);
 	logDebug("connected to server1");
 
 	/* is it a supported postgresql version? */
-	pgversion1 = PQserverVersion(conn1);
+	pgversion1 = getServerVersion(conn1);
 	if (pgversion1 < PGQ_SUPPORTED)
 	{
-		const char *serverversion = PQparameterStatus(conn1, "server_version");
+		const char *serverversion = getServerVersionString(conn1);
 		logError("postgresql version %s is not supported (requires %s)",
 				 serverversion ? serverversion : "'unknown'", PGQ_SUPPORTED_STR);
-		PQfinish(conn1);
+		closeConnection(conn1);
 		exit(EXIT_FAILURE);
 	}
 
-	logDebug("server1 version: %s", PQparameterStatus(conn1, "server_version"));
+	logDebug("server1 version: %s", getServerVersionString(conn1));
 
 	/* connecting to server2 ... */
-	conn2 = connectDatabase(opts.source);
+	if (options.dumpcatalog || fanout)
+	{
+		conn2 = conn1;
+		if (!isCatalogFile(conn2))
+			startCatalogDump(conn2);
+	}
+	else
+		conn2 = connectDatabase(opts.source);
 	logDebug("connected to server2");
 
 	/* is it a supported postgresql version? */
-	pgversion2 = PQserverVersion(conn2);
+	pgversion2 = getServerVersion(conn2);
 	if (pgversion2 < PGQ_SUPPORTED)
 	{
-		const char *serverversion = PQparameterStatus(conn2, "server_version");
+		const char *serverversion = getServerVersionString(conn2);
 		logError("postgresql version %s is not supported (requires %s)",
 				 serverversion ? serverversion : "'unknown'", PGQ_SUPPORTED_STR);
-		PQfinish(conn2);
-		PQfinish(conn1);
+		closeConnection(conn2);
+		closeConnection(conn1);
 		exit(EXIT_FAILURE);
 	}
 
-	logDebug("server2 version: %s", PQparameterStatus(conn2, "server_version"));
+	logDebug("server2 version: %s", getServerVersionString(conn2));
 
 	/*
 	 * pgquarrel is using the reserved keywords provided by the postgres
@@ -5098,10 +7153,11 @@ int main(int argc, char *argv[])
 			 (compareMajorVersion(pgversion2, PG_VERSION_NUM) > 0)))
 	{
 		logError("cannot connect to server whose version (%s) is greater than postgres version (%s) used to compile pgquarrel",
-				 (pgversion1 > pgversion2) ? PQparameterStatus(conn1,
-						 "server_version") : PQparameterStatus(conn2, "server_version"), PG_VERSION);
-		PQfinish(conn2);
-		PQfinish(conn1);
+				 (pgversion1 > pgversion2) ? getServerVersionString(conn1) :
+				 getServerVersionString(conn2), PG_VERSION);
+		closeConnection(conn2);
+		if (conn1 != conn2)
+			closeConnection(conn1);
 		exit(EXIT_FAILURE);
 	}
 
@@ -5114,6 +7170,32 @@ int main(int argc, char *argv[])
 		logWarning("unsupported syntax could be dumped while comparing server (%d) with server (%d)",
 				   pgversion1, pgversion2);
 
+	/*
+	 * All catalog queries of each server are executed inside a single
+	 * transaction. Hence, objects are fetched from a consistent view of the
+	 * catalog even if there is a concurrent DDL.
+	 */
+	beginSnapshotTransaction(conn1, NULL);
+	if (conn2 != conn1)
+		beginSnapshotTransaction(conn2, NULL);
+
+	/*
+	 * Use the catalog cache of a server whose catalog did not change since
+	 * the last run. The cache must be read (and written) inside the
+	 * transaction that fetches the objects.
+	 */
+	if (options.cachedir && !options.dumpcatalog)
+	{
+		PGconn	*live1 = conn1;
+
+		if (!isCatalogFile(conn1))
+			conn1 = openCatalogCache(conn1, options.cachedir, &cachepath1);
+		if (conn2 == live1)
+			conn2 = conn1;
+		else if (!isCatalogFile(conn2))
+			conn2 = openCatalogCache(conn2, options.cachedir, &cachepath2);
+	}
+
 	/* open output file */
 	if (options.output != NULL && strcmp(options.output, "-") != 0)
 	{
@@ -5127,11 +7209,15 @@ int main(int argc, char *argv[])
 	else
 		fout = stdout;
 
-	/* temporary files are used to put commands in the right dependency order */
-	snprintf(prepath, PGQMAXPATH, "%s/quarrel.%d.pre", options.tmpdir, getpid());
-	snprintf(postpath, PGQMAXPATH, "%s/quarrel.%d.post", options.tmpdir, getpid());
-	fpre = openTempFile(prepath);
-	fpost = openTempFile(postpath);
+	/* output buffers are used to put commands in the right dependency order */
+	snprintf(path, PGQMAXPATH, "%s/quarrel.%d.pre", options.tmpdir, getpid());
+	openOutputBuffer(&outpre, path);
+	snprintf(path, PGQMAXPATH, "%s/quarrel.%d.post", options.tmpdir, getpid());
+	openOutputBuffer(&outpost, path);
+	bpre = &outpre;
+	bpost = &outpost;
+	fpre = outpre.fp;
+	fpost = outpost.fp;
 
 	/*
 	 * Let's start the party ...
@@ -5166,120 +7252,205 @@ int main(int argc, char *argv[])
 	 * problems with the dependencies. Generally, CREATE commands will be output
 	 * at the beginning (in a pre-defined order) and DROP commands at the end
 	 * (in a reverse order -- to solve dependency problems).
-	 * Only selected objects will be compared.
+	 * Only selected objects will be compared. Steps are added in the
+	 * dependency order (see runSteps).
 	 */
 
 	if (options.fdw)
 	{
-		quarrelForeignDataWrappers();
-		quarrelForeignServers();
-		quarrelUserMappings();
+		addStep(quarrelForeignDataWrappers);
+		addStep(quarrelForeignServers);
+		addStep(quarrelUserMappings);
 	}
 
 	if (options.language)
-		quarrelLanguages();
+		addStep(quarrelLanguages);
 	if (options.schema)
-		quarrelSchemas();
+		addStep(quarrelSchemas);
 	if (options.extension)
-		quarrelExtensions();
+		addStep(quarrelExtensions);
 	if (options.accessmethod)
-		quarrelAccessMethods();
+		addStep(quarrelAccessMethods);
 
 	if (options.cast)
-		quarrelCasts();
+		addStep(quarrelCasts);
 	if (options.collation)
-		quarrelCollations();
+		addStep(quarrelCollations);
 	if (options.conversion)
-		quarrelConversions();
+		addStep(quarrelConversions);
 	if (options.domain)
-		quarrelDomains();
+		addStep(quarrelDomains);
 	if (options.type)
-		quarrelTypes();
+		addStep(quarrelTypes);
 	if (options.operator)
 	{
-		quarrelOperators();
-		quarrelOperatorFamilies();
-		quarrelOperatorClasses();
+		addStep(quarrelOperators);
+		addStep(quarrelOperatorFamilies);
+		addStep(quarrelOperatorClasses);
 	}
 	if (options.sequence)
-		quarrelSequences();
+		addStep(quarrelSequences);
 	if (options.table)
-		quarrelTables();
+		addStep(quarrelTables);
 	if (options.index)
-		quarrelIndexes();
+		addStep(quarrelIndexes);
 	if (options.function)
-		quarrelFunctions();
+		addStep(quarrelFunctions);
 	if (options.procedure)
-		quarrelProcedures();
+		addStep(quarrelProcedures);
 	if (options.foreigntable)
-		quarrelForeignTables();
+		addStep(quarrelForeignTables);
 	if (options.aggregate)
-		quarrelAggregates();
+		addStep(quarrelAggregates);
 	if (options.view)
-		quarrelViews();
+		addStep(quarrelViews);
 	if (options.matview)
-		quarrelMaterializedViews();
+		addStep(quarrelMaterializedViews);
 	if (options.trigger)
-		quarrelTriggers();
+		addStep(quarrelTriggers);
 	if (options.rule)
-		quarrelRules();
+		addStep(quarrelRules);
 	if (options.publication)
-		quarrelPublications();
+		addStep(quarrelPublications);
 	if (options.subscription)
-		quarrelSubscriptions();
+		addStep(quarrelSubscriptions);
 	if (options.policy)
-		quarrelPolicies();
+		addStep(quarrelPolicies);
 	if (options.eventtrigger)
-		quarrelEventTriggers();
+		addStep(quarrelEventTriggers);
 	if (options.textsearch)
 	{
-		quarrelTextSearchParsers();
-		quarrelTextSearchTemplates();
-		quarrelTextSearchDicts();
-		quarrelTextSearchConfigs();
+		addStep(quarrelTextSearchParsers);
+		addStep(quarrelTextSearchTemplates);
+		addStep(quarrelTextSearchDicts);
+		addStep(quarrelTextSearchConfigs);
 	}
 	if (options.transform)
-		quarrelTransforms();
+		addStep(quarrelTransforms);
 	if (options.statistics)
-		quarrelStatistics();
+		addStep(quarrelStatistics);
 
-	/*
-	 * Print header iff there is at least one command. Check if one of the
-	 * files is not empty.
-	 */
-	fflush(fpre);
-	fflush(fpost);
-	if (!isEmptyFile(prepath) || !isEmptyFile(postpath))
+	if (fanout)
+	{
+		PGconn	*source = conn2;
+		char	catpath[PGQMAXPATH];
+
+		/* recorded into the catalog dump too */
+		if (options.comment)
+			getComments(source, &comments2);
+		if (options.securitylabels)
+			getSecLabels(source, &seclabels2);
+		curcomments1 = &comments2;
+		curcomments2 = &comments2;
+		curseclabels1 = &seclabels2;
+		curseclabels2 = &seclabels2;
+
+		/*
+		 * Source objects are loaded only once. Targets read them from a
+		 * catalog file that is kept in memory.
+		 */
+		if (!isCatalogFile(source))
+		{
+			runSteps(conn1, conn2);
+
+			/* recorded into the catalog dump below */
+			if (options.dependencyorder)
+				getDependencies(conn2, &depend2);
+
+			snprintf(catpath, PGQMAXPATH, "%s/quarrel.%d.catalog", options.tmpdir,
+					 getpid());
+			writeCatalogDump(conn2, catpath);
+			source = openCatalogFile(catpath);
+			if (unlink(catpath))
+			{
+				logError("could not remove temporary file \"%s\": %s", catpath,
+						 strerror(errno));
+				exit(EXIT_FAILURE);
+			}
+		}
+		else if (options.dependencyorder)
+			getDependencies(source, &depend2);
+
+		if (options.paralleldir)
+			createOutputDirectory(options.paralleldir);
+
+		runTargets(source, opts.targets, opts.ntargets);
+
+		if (source != conn2)
+			closeCatalogFile(source);
+	}
+	else
 	{
-		fprintf(fout, "--\n-- pgquarrel %s\n", PGQ_VERSION);
-		fprintf(fout, "-- quarrel between %s and %s\n", PQparameterStatus(conn1,
-				"server_version"), PQparameterStatus(conn2, "server_version"));
-		fprintf(fout, "--");
+		/*
+		 * comments and security labels are loaded once per server (see
+		 * getComment and getObjectSecurityLabels)
+		 */
+		if (options.comment)
+		{
+			getComments(conn1, &comments1);
+			if (conn2 != conn1)
+				getComments(conn2, &comments2);
+		}
+		if (options.securitylabels)
+		{
+			getSecLabels(conn1, &seclabels1);
+			if (conn2 != conn1)
+				getSecLabels(conn2, &seclabels2);
+		}
+		curcomments1 = &comments1;
+		curcomments2 = (conn2 != conn1) ? &comments2 : &comments1;
+		curseclabels1 = &seclabels1;
+		curseclabels2 = (conn2 != conn1) ? &seclabels2 : &seclabels1;
+
+		runSteps(conn1, conn2);
+
+		if (options.dependencyorder)
+		{
+			getDependencies(conn1, &depend1);
+			if (conn2 != conn1)
+				getDependencies(conn2, &depend2);
+		}
 	}
 
-	/* execute as a single transaction */
-	if (options.singletxn && (!isEmptyFile(prepath) || !isEmptyFile(postpath)))
-		fprintf(fout, "\n\nBEGIN;");
+	if (options.dumpcatalog)
+		writeCatalogDump(conn2, options.dumpcatalog);
 
-	/* dump the quarrel in the right order */
-	mergeTempFiles(fpre, fpost, fout);
+	/* refresh catalog caches */
+	if (cachepath1 && isCatalogDump(conn1))
+		writeCatalogDump(conn1, cachepath1);
+	if (cachepath2 && isCatalogDump(conn2))
+		writeCatalogDump(conn2, cachepath2);
 
-	/* close single transaction */
-	if (options.singletxn && (!isEmptyFile(prepath) || !isEmptyFile(postpath)))
-		fprintf(fout, "\n\nCOMMIT;");
+	writeChanges(fout, fanout ? NULL : options.paralleldir, &outpre, &outpost,
+				 &depend1, (conn2 != conn1) ? &depend2 : &depend1);
 
-	/* close and remove temporary files */
-	closeTempFile(fpre, prepath);
-	closeTempFile(fpost, postpath);
+	closeOutputBuffer(&outpre);
+	closeOutputBuffer(&outpost);
+	freeDependencies(&depend1);
+	freeDependencies(&depend2);
 
 	/* closing connections ... */
-	PQfinish(conn1);
-	PQfinish(conn2);
+	closeConnection(conn1);
+	if (conn2 != conn1)
+		closeConnection(conn2);
 
 	logDebug("server1 connection is closed");
 	logDebug("server2 connection is closed");
 
-	if (options.summary)
+	freeArena(&arena1);
+	freeArena(&arena2);
+	freeNameTable(&nametable);
+	freeComments(&comments1);
+	freeComments(&comments2);
+	freeSecLabels(&seclabels1);
+	freeSecLabels(&seclabels2);
+
+	if (cachepath1)
+		pfree(cachepath1);
+	if (cachepath2)
+		pfree(cachepath2);
+
+	if (options.summary && !fanout)
 		printSummary();
 
 	/* flush and close the output file */
@@ -5289,5 +7460,13 @@ int main(int argc, char *argv[])
 	else
 		fprintf(fout, "\n");	/* new line for stdout */
 
+	/* each command was already reported (see formatCommandCost) */
+	if (costexceeded > 0)
+	{
+		logError("%d commands exceed cost-threshold of %d MB", costexceeded,
+				 options.costthreshold);
+		exit(EXIT_FAILURE);
+	}
+
 	return 0;
 }
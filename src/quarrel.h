@@ -9,9 +9,14 @@
 #ifndef PG_QUARREL_H
 #define PG_QUARREL_H
 
+#include "comment.h"
 #include "common.h"
+#include "depend.h"
+#include "output.h"
+#include "seclabel.h"
 
 #include <errno.h>
+#include <limits.h>
 #include "getopt_long.h"
 #include <sys/types.h>
 #include <sys/stat.h>
@@ -25,10 +30,19 @@
 #include <port.h>				/* simple_prompt */
 #endif
 
+#if defined(_WINDOWS)
+#include <windows.h>
+#include <process.h>			/* _beginthreadex */
+#else
+#include <pthread.h>
+#endif
+
 #define PGQ_NAME			"pgquarrel"
 #define PGQ_VERSION			"0.7.0"
 #define PGQ_SUPPORTED		90000	/* first supported version */
 #define PGQ_SUPPORTED_STR	"9.0.0"
+#define PGQ_MAX_JOBS		64		/* maximum connections per server */
+#define PGQ_TARGET_PREFIX	"target."	/* fan-out target section */
 
 
 typedef struct PQLStatistic
@@ -107,4 +121,57 @@ typedef struct PQLStatistic
 	int		viewremoved;
 } PQLStatistic;
 
+/*
+ * Objects of one kind loaded from one server. A fetch routine receives the
+ * connection and stores the objects it loads; routines that load details of
+ * objects that were already fetched receive them in objects/nobjects.
+ */
+typedef struct QuarrelFetch
+{
+	PGconn	*conn;
+	PQLArena	*arena;		/* owns the objects */
+	PQLNameTable	*names;	/* shared by both servers */
+	PQLComments	*comments;	/* see getComment */
+	PQLSecLabels	*seclabels;	/* see getObjectSecurityLabels */
+	void	*objects;
+	int		nobjects;
+	void	(*fetch) (struct QuarrelFetch *f);
+} QuarrelFetch;
+
+/*
+ * A comparison step (quarrel* function) and the temporary files that receive
+ * its commands while running with --jobs.
+ */
+typedef struct QuarrelStep
+{
+	void			(*run) (void);
+	PQLOutputBuffer	pre;
+	PQLOutputBuffer	post;
+} QuarrelStep;
+
+/*
+ * Worker connections and its statistics (see runSteps).
+ */
+typedef struct QuarrelWorker
+{
+	PGconn			*conn1;
+	PGconn			*conn2;
+	PQLComments		*comments1;
+	PQLComments		*comments2;
+	PQLSecLabels	*seclabels1;
+	PQLSecLabels	*seclabels2;
+	PQLStatistic	qstat;
+	int				costexceeded;
+} QuarrelWorker;
+
+/*
+ * Target of a fan-out comparison and its statistics (see runTargets).
+ */
+typedef struct QuarrelTarget
+{
+	QuarrelTargetOptions	*opt;
+	PQLStatistic			qstat;
+	int						costexceeded;
+} QuarrelTarget;
+
 #endif	/* PG_QUARREL_H */
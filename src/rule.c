@@ -27,11 +27,11 @@ getRules(PGconn *c, int *n)
 	PGresult	*res;
 	int			i;
 
-	logNoise("rule: server version: %d", PQserverVersion(c));
+	logNoise("rule: server version: %d", getServerVersion(c));
 
-	query = psprintf("SELECT r.oid, n.nspname AS schemaname, c.relname AS tablename, r.rulename, pg_get_ruledef(r.oid) AS definition, obj_description(r.oid, 'pg_rewrite') AS description FROM pg_rewrite r INNER JOIN pg_class c ON (c.oid = r.ev_class) INNER JOIN pg_namespace n ON (n.oid = c.relnamespace) WHERE r.rulename <> '_RETURN'::name AND n.nspname !~ '^pg_' AND n.nspname <> 'information_schema' %s%s ORDER BY n.nspname, c.relname, r.rulename", include_schema_str, exclude_schema_str);
+	query = psprintf("SELECT r.oid, n.nspname AS schemaname, c.relname AS tablename, r.rulename, pg_get_ruledef(r.oid) AS definition FROM pg_rewrite r INNER JOIN pg_class c ON (c.oid = r.ev_class) INNER JOIN pg_namespace n ON (n.oid = c.relnamespace) WHERE r.rulename <> '_RETURN'::name AND n.nspname !~ '^pg_' AND n.nspname <> 'information_schema' %s%s ORDER BY n.nspname, c.relname, r.rulename", include_schema_str, exclude_schema_str);
 
-	res = PQexec(c, query);
+	res = execQuery(c, query);
 
 	pfree(query);
 
@@ -46,7 +46,7 @@ getRules(PGconn *c, int *n)
 
 	*n = PQntuples(res);
 	if (*n > 0)
-		r = (PQLRule *) malloc(*n * sizeof(PQLRule));
+		r = (PQLRule *) arenaAlloc(*n * sizeof(PQLRule));
 	else
 		r = NULL;
 
@@ -54,29 +54,13 @@ getRules(PGconn *c, int *n)
 
 	for (i = 0; i < *n; i++)
 	{
-		char	*withoutescape;
-
 		r[i].oid = strtoul(PQgetvalue(res, i, PQfnumber(res, "oid")), NULL, 10);
-		r[i].table.schemaname = strdup(PQgetvalue(res, i, PQfnumber(res,
+		r[i].table.schemaname = internName(PQgetvalue(res, i, PQfnumber(res,
 									   "schemaname")));
-		r[i].table.objectname = strdup(PQgetvalue(res, i, PQfnumber(res, "tablename")));
-		r[i].rulename = strdup(PQgetvalue(res, i, PQfnumber(res, "rulename")));
-		r[i].ruledef = strdup(PQgetvalue(res, i, PQfnumber(res, "definition")));
-		if (PQgetisnull(res, i, PQfnumber(res, "description")))
-			r[i].comment = NULL;
-		else
-		{
-			withoutescape = PQgetvalue(res, i, PQfnumber(res, "description"));
-			r[i].comment = PQescapeLiteral(c, withoutescape, strlen(withoutescape));
-			if (r[i].comment == NULL)
-			{
-				logError("escaping comment failed: %s", PQerrorMessage(c));
-				PQclear(res);
-				PQfinish(c);
-				/* XXX leak another connection? */
-				exit(EXIT_FAILURE);
-			}
-		}
+		r[i].table.objectname = internName(PQgetvalue(res, i, PQfnumber(res, "tablename")));
+		r[i].rulename = arenaStrdup(PQgetvalue(res, i, PQfnumber(res, "rulename")));
+		r[i].ruledef = arenaStrdup(PQgetvalue(res, i, PQfnumber(res, "definition")));
+		r[i].comment = getComment(PGQ_CLASS_REWRITE, r[i].oid, 0);
 
 		logDebug("rule \"%s\" on \"%s\".\"%s\"", r[i].rulename, r[i].table.schemaname,
 				 r[i].table.objectname);
@@ -87,47 +71,24 @@ getRules(PGconn *c, int *n)
 	return r;
 }
 
-void
-freeRules(PQLRule *r, int n)
-{
-	if (n > 0)
-	{
-		int	i;
-
-		for (i = 0; i < n; i++)
-		{
-			free(r[i].table.schemaname);
-			free(r[i].table.objectname);
-			free(r[i].rulename);
-			free(r[i].ruledef);
-			if (r[i].comment)
-				PQfreemem(r[i].comment);
-		}
-
-		free(r);
-	}
-}
-
 void
 dumpDropRule(FILE *output, PQLRule *r)
 {
-	char	*schema = formatObjectIdentifier(r->table.schemaname);
-	char	*objname = formatObjectIdentifier(r->table.objectname);
+	char	*schema = quotedName(r->table.schemaname);
+	char	*objname = quotedName(r->table.objectname);
 	char	*rulename = formatObjectIdentifier(r->rulename);
 
 	fprintf(output, "\n\n");
 	fprintf(output, "DROP RULE %s ON %s.%s;", rulename, schema, objname);
 
-	free(schema);
-	free(objname);
 	free(rulename);
 }
 
 void
 dumpCreateRule(FILE *output, PQLRule *r)
 {
-	char	*schema = formatObjectIdentifier(r->table.schemaname);
-	char	*objname = formatObjectIdentifier(r->table.objectname);
+	char	*schema = quotedName(r->table.schemaname);
+	char	*objname = quotedName(r->table.objectname);
 	char	*rulename = formatObjectIdentifier(r->rulename);
 
 	fprintf(output, "\n\n");
@@ -137,20 +98,20 @@ dumpCreateRule(FILE *output, PQLRule *r)
 	if (options.comment && r->comment != NULL)
 	{
 		fprintf(output, "\n\n");
-		fprintf(output, "COMMENT ON RULE %s ON %s.%s IS %s;", rulename, schema,
-				objname, r->comment);
+		fprintf(output, "COMMENT ON RULE %s ON %s.%s IS ", rulename, schema,
+				objname);
+		printComment(output, r->comment);
+		fprintf(output, ";");
 	}
 
-	free(schema);
-	free(objname);
 	free(rulename);
 }
 
 void
 dumpAlterRule(FILE *output, PQLRule *a, PQLRule *b)
 {
-	char	*schema = formatObjectIdentifier(b->table.schemaname);
-	char	*objname = formatObjectIdentifier(b->table.objectname);
+	char	*schema = quotedName(b->table.schemaname);
+	char	*objname = quotedName(b->table.objectname);
 	char	*rulename1 = formatObjectIdentifier(a->rulename);
 	char	*rulename2 = formatObjectIdentifier(b->rulename);
 
@@ -169,8 +130,10 @@ dumpAlterRule(FILE *output, PQLRule *a, PQLRule *b)
 				 strcmp(a->comment, b->comment) != 0))
 		{
 			fprintf(output, "\n\n");
-			fprintf(output, "COMMENT ON RULE %s ON %s.%s IS %s;", rulename2, schema,
-					objname, b->comment);
+			fprintf(output, "COMMENT ON RULE %s ON %s.%s IS ", rulename2, schema,
+					objname);
+			printComment(output, b->comment);
+			fprintf(output, ";");
 		}
 		else if (a->comment != NULL && b->comment == NULL)
 		{
@@ -180,8 +143,6 @@ dumpAlterRule(FILE *output, PQLRule *a, PQLRule *b)
 		}
 	}
 
-	free(schema);
-	free(objname);
 	free(rulename1);
 	free(rulename2);
 }
@@ -9,6 +9,7 @@
 #ifndef RULE_H
 #define RULE_H
 
+#include "comment.h"
 #include "common.h"
 
 typedef struct PQLRule
@@ -25,6 +26,5 @@ void dumpDropRule(FILE *output, PQLRule *r);
 void dumpCreateRule(FILE *output, PQLRule *r);
 void dumpAlterRule(FILE *output, PQLRule *a, PQLRule *b);
 
-void freeRules(PQLRule *r, int n);
 
 #endif	/* RULE_H */
@@ -31,18 +31,18 @@ getSchemas(PGconn *c, int *n)
 	PGresult	*res;
 	int			i;
 
-	logNoise("schema: server version: %d", PQserverVersion(c));
+	logNoise("schema: server version: %d", getServerVersion(c));
 
-	if (PQserverVersion(c) >= 90100)	/* extension support */
+	if (getServerVersion(c) >= 90100)	/* extension support */
 	{
-		query = psprintf("SELECT n.oid, nspname, obj_description(n.oid, 'pg_namespace') AS description, pg_get_userbyid(nspowner) AS nspowner, nspacl FROM pg_namespace n WHERE nspname !~ '^pg_' AND nspname <> 'information_schema' %s%s AND NOT EXISTS(SELECT 1 FROM pg_depend d WHERE n.oid = d.objid AND d.deptype = 'e') ORDER BY nspname", include_schema_str, exclude_schema_str);
+		query = psprintf("SELECT n.oid, nspname, pg_get_userbyid(nspowner) AS nspowner, nspacl FROM pg_namespace n WHERE nspname !~ '^pg_' AND nspname <> 'information_schema' %s%s AND NOT EXISTS(SELECT 1 FROM pg_depend d WHERE n.oid = d.objid AND d.deptype = 'e') ORDER BY nspname", include_schema_str, exclude_schema_str);
 	}
 	else
 	{
-		query = psprintf("SELECT n.oid, nspname, obj_description(n.oid, 'pg_namespace') AS description, pg_get_userbyid(nspowner) AS nspowner, nspacl FROM pg_namespace n WHERE nspname !~ '^pg_' AND nspname <> 'information_schema' %s%s ORDER BY nspname", include_schema_str, exclude_schema_str);
+		query = psprintf("SELECT n.oid, nspname, pg_get_userbyid(nspowner) AS nspowner, nspacl FROM pg_namespace n WHERE nspname !~ '^pg_' AND nspname <> 'information_schema' %s%s ORDER BY nspname", include_schema_str, exclude_schema_str);
 	}
 
-	res = PQexec(c, query);
+	res = execQuery(c, query);
 
 	pfree(query);
 
@@ -57,7 +57,7 @@ getSchemas(PGconn *c, int *n)
 
 	*n = PQntuples(res);
 	if (*n > 0)
-		s = (PQLSchema *) malloc(*n * sizeof(PQLSchema));
+		s = (PQLSchema *) arenaAlloc(*n * sizeof(PQLSchema));
 	else
 		s = NULL;
 
@@ -65,36 +65,20 @@ getSchemas(PGconn *c, int *n)
 
 	for (i = 0; i < *n; i++)
 	{
-		char	*withoutescape;
-
 		s[i].oid = strtoul(PQgetvalue(res, i, PQfnumber(res, "oid")), NULL, 10);
-		s[i].schemaname = strdup(PQgetvalue(res, i, PQfnumber(res, "nspname")));
-		if (PQgetisnull(res, i, PQfnumber(res, "description")))
-			s[i].comment = NULL;
-		else
-		{
-			withoutescape = PQgetvalue(res, i, PQfnumber(res, "description"));
-			s[i].comment = PQescapeLiteral(c, withoutescape, strlen(withoutescape));
-			if (s[i].comment == NULL)
-			{
-				logError("escaping comment failed: %s", PQerrorMessage(c));
-				PQclear(res);
-				PQfinish(c);
-				/* XXX leak another connection? */
-				exit(EXIT_FAILURE);
-			}
-		}
+		s[i].schemaname = internName(PQgetvalue(res, i, PQfnumber(res, "nspname")));
+		s[i].comment = getComment(PGQ_CLASS_NAMESPACE, s[i].oid, 0);
 
-		s[i].owner = strdup(PQgetvalue(res, i, PQfnumber(res, "nspowner")));
+		s[i].owner = internName(PQgetvalue(res, i, PQfnumber(res, "nspowner")));
 		if (PQgetisnull(res, i, PQfnumber(res, "nspacl")))
 			s[i].acl = NULL;
 		else
-			s[i].acl = strdup(PQgetvalue(res, i, PQfnumber(res, "nspacl")));
+			s[i].acl = arenaStrdup(PQgetvalue(res, i, PQfnumber(res, "nspacl")));
 
 		/*
 		 * Security labels are not assigned here (see getSchemaSecurityLabels),
 		 * but default values are essential to avoid having trouble in
-		 * freeSchemas.
+		 * the dump routines.
 		 */
 		s[i].nseclabels = 0;
 		s[i].seclabels = NULL;
@@ -108,106 +92,36 @@ getSchemas(PGconn *c, int *n)
 }
 
 void
-getSchemaSecurityLabels(PGconn *c, PQLSchema *s)
+getSchemaSecurityLabels(PGconn *c, PQLSchema *s, int n)
 {
-	char		*query;
-	PGresult	*res;
 	int			i;
 
-	if (PQserverVersion(c) < 90100)
-	{
-		logWarning("ignoring security labels because server does not support it");
+	if (n == 0)
 		return;
-	}
-
-	query = psprintf("SELECT provider, label FROM pg_seclabel s INNER JOIN pg_class c ON (s.classoid = c.oid) WHERE c.relname = 'pg_namespace' AND s.objoid = %u ORDER BY provider", s->oid);
-
-	res = PQexec(c, query);
 
-	pfree(query);
-
-	if (PQresultStatus(res) != PGRES_TUPLES_OK)
+	if (getServerVersion(c) < 90100)
 	{
-		logError("query failed: %s", PQresultErrorMessage(res));
-		PQclear(res);
-		PQfinish(c);
-		/* XXX leak another connection? */
-		exit(EXIT_FAILURE);
-	}
-
-	s->nseclabels = PQntuples(res);
-	if (s->nseclabels > 0)
-		s->seclabels = (PQLSecLabel *) malloc(s->nseclabels * sizeof(PQLSecLabel));
-	else
-		s->seclabels = NULL;
-
-	logDebug("number of security labels in schema \"%s\": %d", s->schemaname,
-			 s->nseclabels);
-
-	for (i = 0; i < s->nseclabels; i++)
-	{
-		char	*withoutescape;
-
-		s->seclabels[i].provider = strdup(PQgetvalue(res, i, PQfnumber(res,
-										  "provider")));
-		withoutescape = PQgetvalue(res, i, PQfnumber(res, "label"));
-		s->seclabels[i].label = PQescapeLiteral(c, withoutescape,
-												strlen(withoutescape));
-		if (s->seclabels[i].label == NULL)
-		{
-			logError("escaping label failed: %s", PQerrorMessage(c));
-			PQclear(res);
-			PQfinish(c);
-			/* XXX leak another connection? */
-			exit(EXIT_FAILURE);
-		}
+		logWarning("ignoring security labels because server does not support it");
+		return;
 	}
 
-	PQclear(res);
-}
-
-void
-freeSchemas(PQLSchema *s, int n)
-{
-	if (n > 0)
+	for (i = 0; i < n; i++)
 	{
-		int	i;
-
-		for (i = 0; i < n; i++)
-		{
-			int	j;
+		s[i].nseclabels = getObjectSecurityLabels(c, PGQ_CLASS_NAMESPACE,
+							  s[i].oid, 0, &s[i].seclabels);
 
-			free(s[i].schemaname);
-			if (s[i].comment)
-				PQfreemem(s[i].comment);
-			if (s[i].acl)
-				free(s[i].acl);
-			free(s[i].owner);
-
-			/* security labels */
-			for (j = 0; j < s[i].nseclabels; j++)
-			{
-				free(s[i].seclabels[j].provider);
-				PQfreemem(s[i].seclabels[j].label);
-			}
-
-			if (s[i].seclabels)
-				free(s[i].seclabels);
-		}
-
-		free(s);
+		logDebug("number of security labels in schema \"%s\": %d", s[i].schemaname,
+				 s[i].nseclabels);
 	}
 }
 
 void
 dumpDropSchema(FILE *output, PQLSchema *s)
 {
-	char	*schemaname = formatObjectIdentifier(s->schemaname);
+	char	*schemaname = quotedName(s->schemaname);
 
 	fprintf(output, "\n\n");
 	fprintf(output, "DROP SCHEMA %s;", schemaname);
-
-	free(schemaname);
 }
 
 void
@@ -222,7 +136,9 @@ dumpCreateSchema(FILE *output, PQLSchema *s)
 	if (options.comment && s->comment != NULL)
 	{
 		fprintf(output, "\n\n");
-		fprintf(output, "COMMENT ON SCHEMA %s IS %s;", schemaname, s->comment);
+		fprintf(output, "COMMENT ON SCHEMA %s IS ", schemaname);
+		printComment(output, s->comment);
+		fprintf(output, ";");
 	}
 
 	/* security labels */
@@ -243,12 +159,10 @@ dumpCreateSchema(FILE *output, PQLSchema *s)
 	/* owner */
 	if (options.owner)
 	{
-		char	*owner = formatObjectIdentifier(s->owner);
+		char	*owner = quotedName(s->owner);
 
 		fprintf(output, "\n\n");
 		fprintf(output, "ALTER SCHEMA %s OWNER TO %s;", schemaname, owner);
-
-		free(owner);
 	}
 
 	/* privileges */
@@ -273,8 +187,8 @@ dumpCreateSchema(FILE *output, PQLSchema *s)
 void
 dumpAlterSchema(FILE *output, PQLSchema *a, PQLSchema *b)
 {
-	char	*schemaname1 = formatObjectIdentifier(a->schemaname);
-	char	*schemaname2 = formatObjectIdentifier(b->schemaname);
+	char	*schemaname1 = quotedName(a->schemaname);
+	char	*schemaname2 = quotedName(b->schemaname);
 
 	if (strcmp(a->schemaname, b->schemaname) != 0)
 	{
@@ -290,7 +204,9 @@ dumpAlterSchema(FILE *output, PQLSchema *a, PQLSchema *b)
 				 strcmp(a->comment, b->comment) != 0))
 		{
 			fprintf(output, "\n\n");
-			fprintf(output, "COMMENT ON SCHEMA %s IS %s;", schemaname2, b->comment);
+			fprintf(output, "COMMENT ON SCHEMA %s IS ", schemaname2);
+			printComment(output, b->comment);
+			fprintf(output, ";");
 		}
 		else if (a->comment != NULL && b->comment == NULL)
 		{
@@ -390,12 +306,10 @@ dumpAlterSchema(FILE *output, PQLSchema *a, PQLSchema *b)
 	{
 		if (strcmp(a->owner, b->owner) != 0)
 		{
-			char	*owner = formatObjectIdentifier(b->owner);
+			char	*owner = quotedName(b->owner);
 
 			fprintf(output, "\n\n");
 			fprintf(output, "ALTER SCHEMA %s OWNER TO %s;", schemaname2, owner);
-
-			free(owner);
 		}
 	}
 
@@ -417,7 +331,4 @@ dumpAlterSchema(FILE *output, PQLSchema *a, PQLSchema *b)
 			dumpGrantAndRevoke(output, PGQ_SCHEMA, &tmpa, &tmpb, a->acl, b->acl, NULL,
 							   NULL);
 	}
-
-	free(schemaname1);
-	free(schemaname2);
 }
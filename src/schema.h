@@ -9,8 +9,10 @@
 #ifndef SCHEMA_H
 #define SCHEMA_H
 
+#include "comment.h"
 #include "common.h"
 #include "privileges.h"
+#include "seclabel.h"
 
 typedef struct PQLSchema
 {
@@ -26,12 +28,11 @@ typedef struct PQLSchema
 } PQLSchema;
 
 PQLSchema *getSchemas(PGconn *c, int *n);
-void getSchemaSecurityLabels(PGconn *c, PQLSchema *s);
+void getSchemaSecurityLabels(PGconn *c, PQLSchema *s, int n);
 
 void dumpDropSchema(FILE *output, PQLSchema *s);
 void dumpCreateSchema(FILE *output, PQLSchema *s);
 void dumpAlterSchema(FILE *output, PQLSchema *a, PQLSchema *b);
 
-void freeSchemas(PQLSchema *s, int n);
 
 #endif	/* SCHEMA_H */
@@ -0,0 +1,206 @@
+/*----------------------------------------------------------------------
+ *
+ * pgquarrel -- comparing database schemas
+ *
+ * seclabel.c
+ *     Load security labels of all objects
+ *
+ * pg_seclabel and pg_shseclabel are loaded once per server instead of
+ * running one query for each object. The security label routines of each
+ * kind look up the labels of an object in the labels of the server that
+ * they are loading (see setCurrentSecLabels).
+ *
+ * Copyright (c) 2015-2020, Euler Taveira
+ *
+ * ---------------------------------------------------------------------
+ */
+#include "seclabel.h"
+
+
+static int compareSecLabels(const void *a, const void *b);
+static int compareSecLabelObjects(const PQLSecLabelEntry *x,
+								  const PQLSecLabelEntry *y);
+
+/* security labels of the server that this thread is loading */
+static PGQ_THREAD_LOCAL PQLSecLabels *currentseclabels = NULL;
+
+static int
+compareSecLabelObjects(const PQLSecLabelEntry *x, const PQLSecLabelEntry *y)
+{
+	if (x->classoid != y->classoid)
+		return (x->classoid < y->classoid) ? -1 : 1;
+	if (x->objoid != y->objoid)
+		return (x->objoid < y->objoid) ? -1 : 1;
+	if (x->objsubid != y->objsubid)
+		return (x->objsubid < y->objsubid) ? -1 : 1;
+
+	return 0;
+}
+
+static int
+compareSecLabels(const void *a, const void *b)
+{
+	const PQLSecLabelEntry	*x = (const PQLSecLabelEntry *) a;
+	const PQLSecLabelEntry	*y = (const PQLSecLabelEntry *) b;
+	int						c;
+
+	c = compareSecLabelObjects(x, y);
+	if (c == 0)
+		c = strcmp(x->provider, y->provider);
+
+	return c;
+}
+
+/*
+ * Load all security labels of a server. Shared objects (subscriptions) have
+ * their labels in pg_shseclabel (9.2 or later). Security labels are new in
+ * 9.1; older servers do not have any.
+ */
+void
+getSecLabels(PGconn *c, PQLSecLabels *d)
+{
+	char		*query;
+	PGresult	*res;
+	int			i;
+
+	d->res = NULL;
+	d->items = NULL;
+	d->nitems = 0;
+
+	if (getServerVersion(c) < 90100)
+		return;
+
+	if (getServerVersion(c) >= 90200)
+		query = psprintf("SELECT classoid, objoid, objsubid, provider, label FROM pg_seclabel UNION ALL SELECT classoid, objoid, 0 AS objsubid, provider, label FROM pg_shseclabel ORDER BY 1, 2, 3, 4");
+	else
+		query = psprintf("SELECT classoid, objoid, objsubid, provider, label FROM pg_seclabel ORDER BY 1, 2, 3, 4");
+
+	res = execQuery(c, query);
+
+	pfree(query);
+
+	if (PQresultStatus(res) != PGRES_TUPLES_OK)
+	{
+		logError("query failed: %s", PQresultErrorMessage(res));
+		PQclear(res);
+		PQfinish(c);
+		/* XXX leak another connection? */
+		exit(EXIT_FAILURE);
+	}
+
+	d->res = res;
+	d->nitems = PQntuples(res);
+	if (d->nitems > 0)
+	{
+		d->items = (PQLSecLabelEntry *) malloc(d->nitems * sizeof(PQLSecLabelEntry));
+		if (d->items == NULL)
+		{
+			logError("could not allocate memory");
+			exit(EXIT_FAILURE);
+		}
+	}
+
+	for (i = 0; i < d->nitems; i++)
+	{
+		PQLSecLabelEntry	*x = &d->items[i];
+
+		x->classoid = strtoul(PQgetvalue(res, i, PQfnumber(res, "classoid")), NULL, 10);
+		x->objoid = strtoul(PQgetvalue(res, i, PQfnumber(res, "objoid")), NULL, 10);
+		x->objsubid = atoi(PQgetvalue(res, i, PQfnumber(res, "objsubid")));
+		x->provider = PQgetvalue(res, i, PQfnumber(res, "provider"));
+		x->label = PQgetvalue(res, i, PQfnumber(res, "label"));
+	}
+
+	/* ORDER BY uses the same order but do not rely on it */
+	qsort(d->items, d->nitems, sizeof(PQLSecLabelEntry), compareSecLabels);
+
+	logDebug("number of security labels in server: %d", d->nitems);
+}
+
+void
+freeSecLabels(PQLSecLabels *d)
+{
+	if (d->items)
+		free(d->items);
+	if (d->res)
+		PQclear(d->res);
+	d->items = NULL;
+	d->res = NULL;
+	d->nitems = 0;
+}
+
+/*
+ * Objects loaded by this thread use security labels 'd' until other labels
+ * are set. NULL means that security labels are not compared.
+ */
+void
+setCurrentSecLabels(PQLSecLabels *d)
+{
+	currentseclabels = d;
+}
+
+/*
+ * Assign the security labels of an object to 'sl' and return how many there
+ * are. A column is (pg_class, table, column number); other objects use
+ * objsubid 0. Labels are ordered by provider.
+ */
+int
+getObjectSecurityLabels(PGconn *c, Oid classoid, Oid objoid, int objsubid,
+						PQLSecLabel **sl)
+{
+	PQLSecLabelEntry	key;
+	int					lo, hi;
+	int					first;
+	int					n;
+	int					i;
+
+	*sl = NULL;
+
+	if (currentseclabels == NULL || currentseclabels->nitems == 0)
+		return 0;
+
+	key.classoid = classoid;
+	key.objoid = objoid;
+	key.objsubid = objsubid;
+
+	/* first label of this object */
+	lo = 0;
+	hi = currentseclabels->nitems;
+	while (lo < hi)
+	{
+		int		mid = lo + (hi - lo) / 2;
+
+		if (compareSecLabelObjects(&currentseclabels->items[mid], &key) < 0)
+			lo = mid + 1;
+		else
+			hi = mid;
+	}
+	first = lo;
+
+	for (n = 0; first + n < currentseclabels->nitems; n++)
+	{
+		if (compareSecLabelObjects(&currentseclabels->items[first + n], &key) != 0)
+			break;
+	}
+
+	if (n == 0)
+		return 0;
+
+	*sl = (PQLSecLabel *) arenaAlloc(n * sizeof(PQLSecLabel));
+	for (i = 0; i < n; i++)
+	{
+		PQLSecLabelEntry	*x = &currentseclabels->items[first + i];
+
+		(*sl)[i].provider = arenaStrdup(x->provider);
+		(*sl)[i].label = escapeLiteral(c, x->label, strlen(x->label));
+		if ((*sl)[i].label == NULL)
+		{
+			logError("escaping label failed: %s", PQerrorMessage(c));
+			PQfinish(c);
+			/* XXX leak another connection? */
+			exit(EXIT_FAILURE);
+		}
+	}
+
+	return n;
+}
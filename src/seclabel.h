@@ -0,0 +1,39 @@
+/*----------------------------------------------------------------------
+ *
+ * pgquarrel -- comparing database schemas
+ *
+ * Copyright (c) 2015-2020, Euler Taveira
+ *
+ * ---------------------------------------------------------------------
+ */
+#ifndef SECLABEL_H
+#define SECLABEL_H
+
+#include "common.h"
+#include "depend.h"
+
+/* security label of object (classoid, objoid, objsubid) */
+typedef struct PQLSecLabelEntry
+{
+	Oid		classoid;
+	Oid		objoid;
+	int		objsubid;		/* column number or 0 */
+	char	*provider;		/* points into res */
+	char	*label;			/* not escaped; points into res */
+} PQLSecLabelEntry;
+
+/* security labels of one server sorted by object and provider */
+typedef struct PQLSecLabels
+{
+	PGresult			*res;
+	PQLSecLabelEntry	*items;
+	int					nitems;
+} PQLSecLabels;
+
+void getSecLabels(PGconn *c, PQLSecLabels *d);
+void freeSecLabels(PQLSecLabels *d);
+void setCurrentSecLabels(PQLSecLabels *d);
+int getObjectSecurityLabels(PGconn *c, Oid classoid, Oid objoid, int objsubid,
+							PQLSecLabel **sl);
+
+#endif	/* SECLABEL_H */
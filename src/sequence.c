@@ -34,18 +34,18 @@ getSequences(PGconn *c, int *n)
 	PGresult		*res;
 	int				i;
 
-	logNoise("sequence: server version: %d", PQserverVersion(c));
+	logNoise("sequence: server version: %d", getServerVersion(c));
 
-	if (PQserverVersion(c) >= 90100)	/* extension support */
+	if (getServerVersion(c) >= 90100)	/* extension support */
 	{
-		query = psprintf("SELECT c.oid, n.nspname, c.relname, obj_description(c.oid, 'pg_class') AS description, pg_get_userbyid(c.relowner) AS relowner, relacl FROM pg_class c INNER JOIN pg_namespace n ON (c.relnamespace = n.oid) WHERE relkind = 'S' AND nspname !~ '^pg_' AND nspname <> 'information_schema' %s%s AND NOT EXISTS(SELECT 1 FROM pg_depend d WHERE c.oid = d.objid AND d.deptype = 'e') ORDER BY nspname, relname", include_schema_str, exclude_schema_str);
+		query = psprintf("SELECT c.oid, n.nspname, c.relname, pg_get_userbyid(c.relowner) AS relowner, relacl FROM pg_class c INNER JOIN pg_namespace n ON (c.relnamespace = n.oid) WHERE relkind = 'S' AND nspname !~ '^pg_' AND nspname <> 'information_schema' %s%s AND NOT EXISTS(SELECT 1 FROM pg_depend d WHERE c.oid = d.objid AND d.deptype = 'e') ORDER BY nspname, relname", include_schema_str, exclude_schema_str);
 	}
 	else
 	{
-		query = psprintf("SELECT c.oid, n.nspname, c.relname, obj_description(c.oid, 'pg_class') AS description, pg_get_userbyid(c.relowner) AS relowner, relacl FROM pg_class c INNER JOIN pg_namespace n ON (c.relnamespace = n.oid) WHERE relkind = 'S' AND nspname !~ '^pg_' AND nspname <> 'information_schema' %s%s ORDER BY nspname, relname", include_schema_str, exclude_schema_str);
+		query = psprintf("SELECT c.oid, n.nspname, c.relname, pg_get_userbyid(c.relowner) AS relowner, relacl FROM pg_class c INNER JOIN pg_namespace n ON (c.relnamespace = n.oid) WHERE relkind = 'S' AND nspname !~ '^pg_' AND nspname <> 'information_schema' %s%s ORDER BY nspname, relname", include_schema_str, exclude_schema_str);
 	}
 
-	res = PQexec(c, query);
+	res = execQuery(c, query);
 
 	pfree(query);
 
@@ -60,7 +60,7 @@ getSequences(PGconn *c, int *n)
 
 	*n = PQntuples(res);
 	if (*n > 0)
-		s = (PQLSequence *) malloc(*n * sizeof(PQLSequence));
+		s = (PQLSequence *) arenaAlloc(*n * sizeof(PQLSequence));
 	else
 		s = NULL;
 
@@ -68,37 +68,21 @@ getSequences(PGconn *c, int *n)
 
 	for (i = 0; i < *n; i++)
 	{
-		char	*withoutescape;
-
 		s[i].obj.oid = strtoul(PQgetvalue(res, i, PQfnumber(res, "oid")), NULL, 10);
-		s[i].obj.schemaname = strdup(PQgetvalue(res, i, PQfnumber(res, "nspname")));
-		s[i].obj.objectname = strdup(PQgetvalue(res, i, PQfnumber(res, "relname")));
-		if (PQgetisnull(res, i, PQfnumber(res, "description")))
-			s[i].comment = NULL;
-		else
-		{
-			withoutescape = PQgetvalue(res, i, PQfnumber(res, "description"));
-			s[i].comment = PQescapeLiteral(c, withoutescape, strlen(withoutescape));
-			if (s[i].comment == NULL)
-			{
-				logError("escaping comment failed: %s", PQerrorMessage(c));
-				PQclear(res);
-				PQfinish(c);
-				/* XXX leak another connection? */
-				exit(EXIT_FAILURE);
-			}
-		}
+		s[i].obj.schemaname = internName(PQgetvalue(res, i, PQfnumber(res, "nspname")));
+		s[i].obj.objectname = internName(PQgetvalue(res, i, PQfnumber(res, "relname")));
+		s[i].comment = getComment(PGQ_CLASS_CLASS, s[i].obj.oid, 0);
 
-		s[i].owner = strdup(PQgetvalue(res, i, PQfnumber(res, "relowner")));
+		s[i].owner = internName(PQgetvalue(res, i, PQfnumber(res, "relowner")));
 		if (PQgetisnull(res, i, PQfnumber(res, "relacl")))
 			s[i].acl = NULL;
 		else
-			s[i].acl = strdup(PQgetvalue(res, i, PQfnumber(res, "relacl")));
+			s[i].acl = arenaStrdup(PQgetvalue(res, i, PQfnumber(res, "relacl")));
 
 		/*
 		 * These values are not assigned here (see getSequenceAttributes), but
 		 * default values are essential to avoid having trouble in
-		 * freeSequences.
+		 * the dump routines.
 		 */
 		s[i].startvalue = NULL;
 		s[i].incvalue = NULL;
@@ -110,7 +94,7 @@ getSequences(PGconn *c, int *n)
 		/*
 		 * Security labels are not assigned here (see
 		 * getSequenceSecurityLabels), but default values are essential to
-		 * avoid having trouble in freeSequences.
+		 * avoid having trouble in the dump routines.
 		 */
 		s[i].nseclabels = 0;
 		s[i].seclabels = NULL;
@@ -124,181 +108,103 @@ getSequences(PGconn *c, int *n)
 }
 
 void
-getSequenceAttributes(PGconn *c, PQLSequence *s)
+getSequenceAttributes(PGconn *c, PQLSequence *s, int n)
 {
-	char		*query;
-	PGresult	*res;
+	char		**queries;
+	PGresult	**res;
+	int			i;
 
-	/* pg_sequence catalog is new in 10 */
-	if (PQserverVersion(c) >= 100000)
-	{
-		query = psprintf("SELECT seqincrement, seqstart, seqmax, seqmin, seqcache, seqcycle, format_type(seqtypid, NULL) AS typname FROM pg_sequence WHERE seqrelid = %u", s->obj.oid);
-	}
-	else
+	if (n == 0)
+		return;
+
+	queries = (char **) malloc(n * sizeof(char *));
+	for (i = 0; i < n; i++)
 	{
-		char *schema = formatObjectIdentifier(s->obj.schemaname);
-		char *seqname = formatObjectIdentifier(s->obj.objectname);
+		/* pg_sequence catalog is new in 10 */
+		if (getServerVersion(c) >= 100000)
+		{
+			queries[i] = psprintf("SELECT seqincrement, seqstart, seqmax, seqmin, seqcache, seqcycle, format_type(seqtypid, NULL) AS typname FROM pg_sequence WHERE seqrelid = %u", s[i].obj.oid);
+		}
+		else
+		{
+			char *schema = quotedName(s[i].obj.schemaname);
+			char *seqname = quotedName(s[i].obj.objectname);
 
-		query = psprintf("SELECT increment_by AS seqincrement, start_value AS seqstart, max_value AS seqmax, min_value AS seqmin, cache_value AS seqcache, is_cycled AS seqcycle FROM %s.%s", schema, seqname);
-		free(schema);
-		free(seqname);
+			queries[i] = psprintf("SELECT increment_by AS seqincrement, start_value AS seqstart, max_value AS seqmax, min_value AS seqmin, cache_value AS seqcache, is_cycled AS seqcycle FROM %s.%s", schema, seqname);
+		}
 	}
 
-	res = PQexec(c, query);
-
-	pfree(query);
+	/*
+	 * Before 10, ALTER SEQUENCE does not change the catalog; it is not
+	 * covered by the catalog cache.
+	 */
+	if (getServerVersion(c) >= 100000)
+		res = execQueries(c, queries, n);
+	else
+		res = execServerQueries(c, queries, n);
 
-	if (PQresultStatus(res) != PGRES_TUPLES_OK)
+	for (i = 0; i < n; i++)
 	{
-		logError("query failed: %s", PQresultErrorMessage(res));
-		PQclear(res);
-		PQfinish(c);
-		/* XXX leak another connection? */
-		exit(EXIT_FAILURE);
-	}
+		if (PQntuples(res[i]) != 1)
+			logError("query to get sequence information returns %d row(s) (expected 1)",
+					 PQntuples(res[i]));
+		else
+		{
+			s[i].incvalue = arenaStrdup(PQgetvalue(res[i], 0, PQfnumber(res[i], "seqincrement")));
+			s[i].startvalue = arenaStrdup(PQgetvalue(res[i], 0, PQfnumber(res[i], "seqstart")));
+			s[i].maxvalue = arenaStrdup(PQgetvalue(res[i], 0, PQfnumber(res[i], "seqmax")));
+			s[i].minvalue = arenaStrdup(PQgetvalue(res[i], 0, PQfnumber(res[i], "seqmin")));
+			s[i].cache = arenaStrdup(PQgetvalue(res[i], 0, PQfnumber(res[i], "seqcache")));
+			s[i].cycle = (PQgetvalue(res[i], 0, PQfnumber(res[i], "seqcycle"))[0] == 't');
+			if (getServerVersion(c) >= 100000)
+				s[i].typname = arenaStrdup(PQgetvalue(res[i], 0, PQfnumber(res[i], "typname")));
+		}
 
-	if (PQntuples(res) != 1)
-		logError("query to get sequence information returns %d row(s) (expected 1)",
-				 PQntuples(res));
-	else
-	{
-		s->incvalue = strdup(PQgetvalue(res, 0, PQfnumber(res, "seqincrement")));
-		s->startvalue = strdup(PQgetvalue(res, 0, PQfnumber(res, "seqstart")));
-		s->maxvalue = strdup(PQgetvalue(res, 0, PQfnumber(res, "seqmax")));
-		s->minvalue = strdup(PQgetvalue(res, 0, PQfnumber(res, "seqmin")));
-		s->cache = strdup(PQgetvalue(res, 0, PQfnumber(res, "seqcache")));
-		s->cycle = (PQgetvalue(res, 0, PQfnumber(res, "seqcycle"))[0] == 't');
-		if (PQserverVersion(c) >= 100000)
-			s->typname = strdup(PQgetvalue(res, 0, PQfnumber(res, "typname")));
+		PQclear(res[i]);
 	}
 
-	PQclear(res);
+	free(res);
 }
 
 void
-getSequenceSecurityLabels(PGconn *c, PQLSequence *s)
+getSequenceSecurityLabels(PGconn *c, PQLSequence *s, int n)
 {
-	char		*query;
-	PGresult	*res;
 	int			i;
 
-	if (PQserverVersion(c) < 90100)
-	{
-		logWarning("ignoring security labels because server does not support it");
+	if (n == 0)
 		return;
-	}
 
-	query = psprintf("SELECT provider, label FROM pg_seclabel s INNER JOIN pg_class c ON (s.classoid = c.oid) WHERE c.relname = 'pg_class' AND s.objoid = %u ORDER BY provider", s->obj.oid);
-
-	res = PQexec(c, query);
-
-	pfree(query);
-
-	if (PQresultStatus(res) != PGRES_TUPLES_OK)
+	if (getServerVersion(c) < 90100)
 	{
-		logError("query failed: %s", PQresultErrorMessage(res));
-		PQclear(res);
-		PQfinish(c);
-		/* XXX leak another connection? */
-		exit(EXIT_FAILURE);
-	}
-
-	s->nseclabels = PQntuples(res);
-	if (s->nseclabels > 0)
-		s->seclabels = (PQLSecLabel *) malloc(s->nseclabels * sizeof(PQLSecLabel));
-	else
-		s->seclabels = NULL;
-
-	logDebug("number of security labels in sequence \"%s\".\"%s\": %d",
-			 s->obj.schemaname, s->obj.objectname, s->nseclabels);
-
-	for (i = 0; i < s->nseclabels; i++)
-	{
-		char	*withoutescape;
-
-		s->seclabels[i].provider = strdup(PQgetvalue(res, i, PQfnumber(res,
-										  "provider")));
-		withoutescape = PQgetvalue(res, i, PQfnumber(res, "label"));
-		s->seclabels[i].label = PQescapeLiteral(c, withoutescape,
-												strlen(withoutescape));
-		if (s->seclabels[i].label == NULL)
-		{
-			logError("escaping label failed: %s", PQerrorMessage(c));
-			PQclear(res);
-			PQfinish(c);
-			/* XXX leak another connection? */
-			exit(EXIT_FAILURE);
-		}
+		logWarning("ignoring security labels because server does not support it");
+		return;
 	}
 
-	PQclear(res);
-}
-
-void
-freeSequences(PQLSequence *s, int n)
-{
-	if (n > 0)
+	for (i = 0; i < n; i++)
 	{
-		int	i;
+		s[i].nseclabels = getObjectSecurityLabels(c, PGQ_CLASS_CLASS,
+							  s[i].obj.oid, 0, &s[i].seclabels);
 
-		for (i = 0; i < n; i++)
-		{
-			int	j;
-
-			free(s[i].obj.schemaname);
-			free(s[i].obj.objectname);
-			if (s[i].comment)
-				PQfreemem(s[i].comment);
-			free(s[i].owner);
-			if (s[i].acl)
-				free(s[i].acl);
-
-			if (s[i].incvalue)
-				free(s[i].incvalue);
-			if (s[i].startvalue)
-				free(s[i].startvalue);
-			if (s[i].maxvalue)
-				free(s[i].maxvalue);
-			if (s[i].minvalue)
-				free(s[i].minvalue);
-			if (s[i].cache)
-				free(s[i].cache);
-			if (s[i].typname)
-				free(s[i].typname);
-
-			/* security labels */
-			for (j = 0; j < s[i].nseclabels; j++)
-			{
-				free(s[i].seclabels[j].provider);
-				PQfreemem(s[i].seclabels[j].label);
-			}
-
-			if (s[i].seclabels)
-				free(s[i].seclabels);
-		}
-
-		free(s);
+		logDebug("number of security labels in sequence \"%s\".\"%s\": %d",
+				 s[i].obj.schemaname, s[i].obj.objectname, s[i].nseclabels);
 	}
 }
 
 void
 dumpDropSequence(FILE *output, PQLSequence *s)
 {
-	char	*schema = formatObjectIdentifier(s->obj.schemaname);
-	char	*seqname = formatObjectIdentifier(s->obj.objectname);
+	char	*schema = quotedName(s->obj.schemaname);
+	char	*seqname = quotedName(s->obj.objectname);
 
 	fprintf(output, "\n\n");
 	fprintf(output, "DROP SEQUENCE %s.%s;", schema, seqname);
-
-	free(schema);
-	free(seqname);
 }
 
 void
 dumpCreateSequence(FILE *output, PQLSequence *s)
 {
-	char	*schema = formatObjectIdentifier(s->obj.schemaname);
-	char	*seqname = formatObjectIdentifier(s->obj.objectname);
+	char	*schema = quotedName(s->obj.schemaname);
+	char	*seqname = quotedName(s->obj.objectname);
 
 	bool	is_ascending;
 	char	*minv;
@@ -390,8 +296,9 @@ dumpCreateSequence(FILE *output, PQLSequence *s)
 	if (options.comment && s->comment != NULL)
 	{
 		fprintf(output, "\n\n");
-		fprintf(output, "COMMENT ON SEQUENCE %s.%s IS %s;", schema, seqname,
-				s->comment);
+		fprintf(output, "COMMENT ON SEQUENCE %s.%s IS ", schema, seqname);
+		printComment(output, s->comment);
+		fprintf(output, ";");
 	}
 
 	/* security labels */
@@ -413,12 +320,10 @@ dumpCreateSequence(FILE *output, PQLSequence *s)
 	/* owner */
 	if (options.owner)
 	{
-		char	*owner = formatObjectIdentifier(s->owner);
+		char	*owner = quotedName(s->owner);
 
 		fprintf(output, "\n\n");
 		fprintf(output, "ALTER SEQUENCE %s.%s OWNER TO %s;", schema, seqname, owner);
-
-		free(owner);
 	}
 
 	/* privileges */
@@ -426,18 +331,15 @@ dumpCreateSequence(FILE *output, PQLSequence *s)
 	if (options.privileges)
 		dumpGrantAndRevoke(output, PGQ_SEQUENCE, &s->obj, &s->obj, NULL, s->acl, NULL,
 						   NULL);
-
-	free(schema);
-	free(seqname);
 }
 
 void
 dumpAlterSequence(FILE *output, PQLSequence *a, PQLSequence *b)
 {
-	char	*schema1 = formatObjectIdentifier(a->obj.schemaname);
-	char	*seqname1 = formatObjectIdentifier(a->obj.objectname);
-	char	*schema2 = formatObjectIdentifier(b->obj.schemaname);
-	char	*seqname2 = formatObjectIdentifier(b->obj.objectname);
+	char	*schema1 = quotedName(a->obj.schemaname);
+	char	*seqname1 = quotedName(a->obj.objectname);
+	char	*schema2 = quotedName(b->obj.schemaname);
+	char	*seqname2 = quotedName(b->obj.objectname);
 
 	bool	printalter = true;
 
@@ -539,8 +441,9 @@ dumpAlterSequence(FILE *output, PQLSequence *a, PQLSequence *b)
 				 strcmp(a->comment, b->comment) != 0))
 		{
 			fprintf(output, "\n\n");
-			fprintf(output, "COMMENT ON SEQUENCE %s.%s IS %s;", schema2, seqname2,
-					b->comment);
+			fprintf(output, "COMMENT ON SEQUENCE %s.%s IS ", schema2, seqname2);
+			printComment(output, b->comment);
+			fprintf(output, ";");
 		}
 		else if (a->comment != NULL && b->comment == NULL)
 		{
@@ -647,13 +550,11 @@ dumpAlterSequence(FILE *output, PQLSequence *a, PQLSequence *b)
 	{
 		if (strcmp(a->owner, b->owner) != 0)
 		{
-			char	*owner = formatObjectIdentifier(b->owner);
+			char	*owner = quotedName(b->owner);
 
 			fprintf(output, "\n\n");
 			fprintf(output, "ALTER SEQUENCE %s.%s OWNER TO %s;", schema2, seqname2,
 					owner);
-
-			free(owner);
 		}
 	}
 
@@ -664,9 +565,4 @@ dumpAlterSequence(FILE *output, PQLSequence *a, PQLSequence *b)
 			dumpGrantAndRevoke(output, PGQ_SEQUENCE, &a->obj, &b->obj, a->acl, b->acl, NULL,
 							   NULL);
 	}
-
-	free(schema1);
-	free(seqname1);
-	free(schema2);
-	free(seqname2);
 }
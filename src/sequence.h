@@ -9,8 +9,10 @@
 #ifndef SEQUENCE_H
 #define SEQUENCE_H
 
+#include "comment.h"
 #include "common.h"
 #include "privileges.h"
+#include "seclabel.h"
 
 /*
  * Since commit 62e2a8dc2c7f6b1351a0385491933af969ed4265, postgres started to
@@ -50,13 +52,12 @@ typedef struct PQLSequence
 
 
 PQLSequence *getSequences(PGconn *c, int *n);
-void getSequenceAttributes(PGconn *c, PQLSequence *s);
-void getSequenceSecurityLabels(PGconn *c, PQLSequence *s);
+void getSequenceAttributes(PGconn *c, PQLSequence *s, int n);
+void getSequenceSecurityLabels(PGconn *c, PQLSequence *s, int n);
 
 void dumpDropSequence(FILE *output, PQLSequence *s);
 void dumpCreateSequence(FILE *output, PQLSequence *s);
 void dumpAlterSequence(FILE *output, PQLSequence *a, PQLSequence *b);
 
-void freeSequences(PQLSequence *s, int n);
 
 #endif	/* SEQUENCE_H */
@@ -26,14 +26,14 @@ getForeignServers(PGconn *c, int *n)
 	PGresult			*res;
 	int					i;
 
-	logNoise("foreign server: server version: %d", PQserverVersion(c));
+	logNoise("foreign server: server version: %d", getServerVersion(c));
 
-	if (PQserverVersion(c) >= 90100)	/* extension support */
-		res = PQexec(c,
-					 "SELECT s.oid, s.srvname AS servername, s.srvowner AS owner, f.fdwname AS serverfdw, s.srvtype AS servertype, s.srvversion AS serverversion, array_to_string(s.srvoptions, ', ') AS options, obj_description(s.oid, 'pg_foreign_server') AS description, pg_get_userbyid(s.srvowner) AS serverowner, s.srvacl AS acl FROM pg_foreign_server s INNER JOIN pg_foreign_data_wrapper f ON (s.srvfdw = f.oid) WHERE NOT EXISTS(SELECT 1 FROM pg_depend d WHERE s.oid = d.objid AND d.deptype = 'e') ORDER BY srvname");
+	if (getServerVersion(c) >= 90100)	/* extension support */
+		res = execQuery(c,
+					 "SELECT s.oid, s.srvname AS servername, s.srvowner AS owner, f.fdwname AS serverfdw, s.srvtype AS servertype, s.srvversion AS serverversion, array_to_string(s.srvoptions, ', ') AS options, pg_get_userbyid(s.srvowner) AS serverowner, s.srvacl AS acl FROM pg_foreign_server s INNER JOIN pg_foreign_data_wrapper f ON (s.srvfdw = f.oid) WHERE NOT EXISTS(SELECT 1 FROM pg_depend d WHERE s.oid = d.objid AND d.deptype = 'e') ORDER BY srvname");
 	else
-		res = PQexec(c,
-					 "SELECT s.oid, s.srvname AS servername, s.srvowner AS owner, f.fdwname AS serverfdw, s.srvtype AS servertype, s.srvversion AS serverversion, array_to_string(s.srvoptions, ', ') AS options, obj_description(s.oid, 'pg_foreign_server') AS description, pg_get_userbyid(s.srvowner) AS serverowner, s.srvacl AS acl FROM pg_foreign_server s INNER JOIN pg_foreign_data_wrapper f ON (s.srvfdw = f.oid) ORDER BY srvname");
+		res = execQuery(c,
+					 "SELECT s.oid, s.srvname AS servername, s.srvowner AS owner, f.fdwname AS serverfdw, s.srvtype AS servertype, s.srvversion AS serverversion, array_to_string(s.srvoptions, ', ') AS options, pg_get_userbyid(s.srvowner) AS serverowner, s.srvacl AS acl FROM pg_foreign_server s INNER JOIN pg_foreign_data_wrapper f ON (s.srvfdw = f.oid) ORDER BY srvname");
 
 	if (PQresultStatus(res) != PGRES_TUPLES_OK)
 	{
@@ -46,7 +46,7 @@ getForeignServers(PGconn *c, int *n)
 
 	*n = PQntuples(res);
 	if (*n > 0)
-		s = (PQLForeignServer *) malloc(*n * sizeof(PQLForeignServer));
+		s = (PQLForeignServer *) arenaAlloc(*n * sizeof(PQLForeignServer));
 	else
 		s = NULL;
 
@@ -54,52 +54,36 @@ getForeignServers(PGconn *c, int *n)
 
 	for (i = 0; i < *n; i++)
 	{
-		char	*withoutescape;
-
 		s[i].oid = strtoul(PQgetvalue(res, i, PQfnumber(res, "oid")), NULL, 10);
-		s[i].servername = strdup(PQgetvalue(res, i, PQfnumber(res, "servername")));
-		s[i].serverfdw = strdup(PQgetvalue(res, i, PQfnumber(res, "serverfdw")));
+		s[i].servername = arenaStrdup(PQgetvalue(res, i, PQfnumber(res, "servername")));
+		s[i].serverfdw = arenaStrdup(PQgetvalue(res, i, PQfnumber(res, "serverfdw")));
 
 		/* type (optional) */
 		if (PQgetisnull(res, i, PQfnumber(res, "servertype")))
 			s[i].servertype = NULL;
 		else
-			s[i].servertype = strdup(PQgetvalue(res, i, PQfnumber(res, "servertype")));
+			s[i].servertype = arenaStrdup(PQgetvalue(res, i, PQfnumber(res, "servertype")));
 
 		/* version (optional) */
 		if (PQgetisnull(res, i, PQfnumber(res, "serverversion")))
 			s[i].serverversion = NULL;
 		else
-			s[i].serverversion = strdup(PQgetvalue(res, i, PQfnumber(res,
+			s[i].serverversion = arenaStrdup(PQgetvalue(res, i, PQfnumber(res,
 												   "serverversion")));
 
 		/* options (optional) */
 		if (PQgetisnull(res, i, PQfnumber(res, "options")))
 			s[i].options = NULL;
 		else
-			s[i].options = strdup(PQgetvalue(res, i, PQfnumber(res, "options")));
+			s[i].options = arenaStrdup(PQgetvalue(res, i, PQfnumber(res, "options")));
 
-		s[i].owner = strdup(PQgetvalue(res, i, PQfnumber(res, "serverowner")));
+		s[i].owner = internName(PQgetvalue(res, i, PQfnumber(res, "serverowner")));
 		if (PQgetisnull(res, i, PQfnumber(res, "acl")))
 			s[i].acl = NULL;
 		else
-			s[i].acl = strdup(PQgetvalue(res, i, PQfnumber(res, "acl")));
+			s[i].acl = arenaStrdup(PQgetvalue(res, i, PQfnumber(res, "acl")));
 
-		if (PQgetisnull(res, i, PQfnumber(res, "description")))
-			s[i].comment = NULL;
-		else
-		{
-			withoutescape = PQgetvalue(res, i, PQfnumber(res, "description"));
-			s[i].comment = PQescapeLiteral(c, withoutescape, strlen(withoutescape));
-			if (s[i].comment == NULL)
-			{
-				logError("escaping comment failed: %s", PQerrorMessage(c));
-				PQclear(res);
-				PQfinish(c);
-				/* XXX leak another connection? */
-				exit(EXIT_FAILURE);
-			}
-		}
+		s[i].comment = getComment(PGQ_CLASS_FOREIGN_SERVER, s[i].oid, 0);
 
 		logDebug("foreign server \"%s\"", s[i].servername);
 	}
@@ -109,34 +93,6 @@ getForeignServers(PGconn *c, int *n)
 	return s;
 }
 
-void
-freeForeignServers(PQLForeignServer *s, int n)
-{
-	if (n > 0)
-	{
-		int	i;
-
-		for (i = 0; i < n; i++)
-		{
-			free(s[i].servername);
-			free(s[i].serverfdw);
-			free(s[i].owner);
-			if (s[i].servertype)
-				free(s[i].servertype);
-			if (s[i].serverversion)
-				free(s[i].serverversion);
-			if (s[i].options)
-				free(s[i].options);
-			if (s[i].acl)
-				free(s[i].acl);
-			if (s[i].comment)
-				PQfreemem(s[i].comment);
-		}
-
-		free(s);
-	}
-}
-
 void
 dumpDropForeignServer(FILE *output, PQLForeignServer *s)
 {
@@ -170,30 +126,27 @@ dumpCreateForeignServer(FILE *output, PQLForeignServer *s)
 	/* options (optional) */
 	if (s->options)
 	{
-		stringList		*sl;
-		stringListCell	*cell;
+		PQLOptionSet	*sl;
+		int				k;
 		bool			first = true;
 
-		sl = buildStringList(s->options);
+		sl = buildOptionSet(s->options);
 		fprintf(output, " OPTIONS(");
-		for (cell = sl->head; cell; cell = cell->next)
+		for (k = 0; k < sl->nitems; k++)
 		{
-			char	*str;
-
-			str = strchr(cell->value, '=');
-			*str++ = '\0';
+			PQLOption	*opt = &sl->items[k];
 
 			if (first)
 			{
-				fprintf(output, "%s '%s'", cell->value, str);
+				fprintf(output, "%s '%s'", opt->key, opt->value);
 				first = false;
 			}
 			else
-				fprintf(output, ", %s '%s'", cell->value, str);
+				fprintf(output, ", %s '%s'", opt->key, opt->value);
 		}
 		fprintf(output, ")");
 
-		freeStringList(sl);
+		freeOptionSet(sl);
 	}
 
 	fprintf(output, ";");
@@ -202,18 +155,18 @@ dumpCreateForeignServer(FILE *output, PQLForeignServer *s)
 	if (options.comment && s->comment != NULL)
 	{
 		fprintf(output, "\n\n");
-		fprintf(output, "COMMENT ON SERVER %s IS %s;", srvname, s->comment);
+		fprintf(output, "COMMENT ON SERVER %s IS ", srvname);
+		printComment(output, s->comment);
+		fprintf(output, ";");
 	}
 
 	/* owner */
 	if (options.owner)
 	{
-		char	*owner = formatObjectIdentifier(s->owner);
+		char	*owner = quotedName(s->owner);
 
 		fprintf(output, "\n\n");
 		fprintf(output, "ALTER SERVER %s OWNER TO %s;", srvname, owner);
-
-		free(owner);
 	}
 
 	/* privileges */
@@ -259,88 +212,82 @@ dumpAlterForeignServer(FILE *output, PQLForeignServer *a, PQLForeignServer *b)
 	/* options */
 	if (a->options == NULL && b->options != NULL)
 	{
-		stringList		*sl;
-		stringListCell	*cell;
+		PQLOptionSet	*sl;
+		int				k;
 		bool			first = true;
 
-		sl = buildStringList(b->options);
+		sl = buildOptionSet(b->options);
 		fprintf(output, "\n\n");
 		fprintf(output, "ALTER SERVER %s OPTIONS (", srvname2);
-		for (cell = sl->head; cell; cell = cell->next)
+		for (k = 0; k < sl->nitems; k++)
 		{
-			char	*str;
-
-			str = strchr(cell->value, '=');
-			*str++ = '\0';
+			PQLOption	*opt = &sl->items[k];
 
 			if (first)
 			{
-				fprintf(output, "ADD %s '%s'", cell->value, str);
+				fprintf(output, "ADD %s '%s'", opt->key, opt->value);
 				first = false;
 			}
 			else
-				fprintf(output, ", ADD %s '%s'", cell->value, str);
+				fprintf(output, ", ADD %s '%s'", opt->key, opt->value);
 		}
 		fprintf(output, ");");
 
-		freeStringList(sl);
+		freeOptionSet(sl);
 	}
 	else if (a->options != NULL && b->options == NULL)
 	{
-		stringList		*sl;
-		stringListCell	*cell;
+		PQLOptionSet	*sl;
+		int				k;
 		bool			first = true;
 
-		sl = buildStringList(a->options);
+		sl = buildOptionSet(a->options);
 		fprintf(output, "\n\n");
 		fprintf(output, "ALTER SERVER %s OPTIONS (", srvname1);
-		for (cell = sl->head; cell; cell = cell->next)
+		for (k = 0; k < sl->nitems; k++)
 		{
-			char	*str;
-
-			str = strchr(cell->value, '=');
-			*str = '\0';
+			PQLOption	*opt = &sl->items[k];
 
 			if (first)
 			{
-				fprintf(output, "DROP %s", cell->value);
+				fprintf(output, "DROP %s", opt->key);
 				first = false;
 			}
 			else
-				fprintf(output, ", DROP %s", cell->value);
+				fprintf(output, ", DROP %s", opt->key);
 		}
 		fprintf(output, ");");
 
-		freeStringList(sl);
+		freeOptionSet(sl);
 	}
 	else if (a->options != NULL && b->options != NULL &&
 			 strcmp(a->options, b->options) != 0)
 	{
-		stringList	*rlist, *ilist, *slist;
+		PQLOptionSet	*rlist, *ilist, *slist;
 
 		/* reset options that are only presented in the first set */
 		rlist = setOperationOptions(a->options, b->options, PGQ_SETDIFFERENCE, false,
 									true);
 		if (rlist)
 		{
-			stringListCell	*cell;
+			int				k;
 			bool			first = true;
 
 			fprintf(output, "\n\n");
 			fprintf(output, "ALTER SERVER %s OPTIONS (", srvname2);
-			for (cell = rlist->head; cell; cell = cell->next)
+			for (k = 0; k < rlist->nitems; k++)
 			{
 				if (first)
 				{
-					fprintf(output, "DROP %s", cell->value);
+					fprintf(output, "DROP %s", rlist->items[k].key);
 					first = false;
 				}
 				else
-					fprintf(output, ", DROP %s", cell->value);
+					fprintf(output, ", DROP %s", rlist->items[k].key);
 			}
 			fprintf(output, ");");
 
-			freeStringList(rlist);
+			freeOptionSet(rlist);
 		}
 
 		/*
@@ -350,29 +297,26 @@ dumpAlterForeignServer(FILE *output, PQLForeignServer *a, PQLForeignServer *b)
 		ilist = setOperationOptions(a->options, b->options, PGQ_INTERSECT, true, true);
 		if (ilist)
 		{
-			stringListCell	*cell;
+			int				k;
 			bool			first = true;
 
 			fprintf(output, "\n\n");
 			fprintf(output, "ALTER SERVER %s OPTIONS (", srvname2);
-			for (cell = ilist->head; cell; cell = cell->next)
+			for (k = 0; k < ilist->nitems; k++)
 			{
-				char	*str;
-
-				str = strchr(cell->value, '=');
-				*str++ = '\0';
+				PQLOption	*opt = &ilist->items[k];
 
 				if (first)
 				{
-					fprintf(output, "SET %s '%s'", cell->value, str);
+					fprintf(output, "SET %s '%s'", opt->key, opt->value);
 					first = false;
 				}
 				else
-					fprintf(output, ", SET %s '%s'", cell->value, str);
+					fprintf(output, ", SET %s '%s'", opt->key, opt->value);
 			}
 			fprintf(output, ");");
 
-			freeStringList(ilist);
+			freeOptionSet(ilist);
 		}
 
 		/*
@@ -382,29 +326,26 @@ dumpAlterForeignServer(FILE *output, PQLForeignServer *a, PQLForeignServer *b)
 									true);
 		if (slist)
 		{
-			stringListCell	*cell;
+			int				k;
 			bool			first = true;
 
 			fprintf(output, "\n\n");
 			fprintf(output, "ALTER SERVER %s OPTIONS (", srvname2);
-			for (cell = slist->head; cell; cell = cell->next)
+			for (k = 0; k < slist->nitems; k++)
 			{
-				char	*str;
-
-				str = strchr(cell->value, '=');
-				*str++ = '\0';
+				PQLOption	*opt = &slist->items[k];
 
 				if (first)
 				{
-					fprintf(output, "ADD %s '%s'", cell->value, str);
+					fprintf(output, "ADD %s '%s'", opt->key, opt->value);
 					first = false;
 				}
 				else
-					fprintf(output, ", ADD %s '%s'", cell->value, str);
+					fprintf(output, ", ADD %s '%s'", opt->key, opt->value);
 			}
 			fprintf(output, ");");
 
-			freeStringList(slist);
+			freeOptionSet(slist);
 		}
 	}
 
@@ -416,7 +357,9 @@ dumpAlterForeignServer(FILE *output, PQLForeignServer *a, PQLForeignServer *b)
 				 strcmp(a->comment, b->comment) != 0))
 		{
 			fprintf(output, "\n\n");
-			fprintf(output, "COMMENT ON SERVER %s IS %s;", srvname2, b->comment);
+			fprintf(output, "COMMENT ON SERVER %s IS ", srvname2);
+			printComment(output, b->comment);
+			fprintf(output, ";");
 		}
 		else if (a->comment != NULL && b->comment == NULL)
 		{
@@ -430,12 +373,10 @@ dumpAlterForeignServer(FILE *output, PQLForeignServer *a, PQLForeignServer *b)
 	{
 		if (strcmp(a->owner, b->owner) != 0)
 		{
-			char	*owner = formatObjectIdentifier(b->owner);
+			char	*owner = quotedName(b->owner);
 
 			fprintf(output, "\n\n");
 			fprintf(output, "ALTER SERVER %s OWNER TO %s;", srvname2, owner);
-
-			free(owner);
 		}
 	}
 
@@ -9,6 +9,7 @@
 #ifndef SERVER_H
 #define SERVER_H
 
+#include "comment.h"
 #include "common.h"
 #include "privileges.h"
 
@@ -33,6 +34,5 @@ void dumpCreateForeignServer(FILE *output, PQLForeignServer *s);
 void dumpAlterForeignServer(FILE *output, PQLForeignServer *a,
 							PQLForeignServer *b);
 
-void freeForeignServers(PQLForeignServer *s, int n);
 
 #endif	/* SERVER_H */
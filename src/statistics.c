@@ -32,21 +32,21 @@ getStatistics(PGconn *c, int *n)
 	PGresult		*res;
 	int				i;
 
-	logNoise("statistics: server version: %d", PQserverVersion(c));
+	logNoise("statistics: server version: %d", getServerVersion(c));
 
 	/* bail out if we do not support it */
-	if (PQserverVersion(c) < 100000)
+	if (getServerVersion(c) < 100000)
 	{
 		logWarning("ignoring statistics because server does not support it");
 		return NULL;
 	}
 
-	if (PQserverVersion(c) >= 130000)
-		query = psprintf("SELECT s.oid, n.nspname AS nspname, s.stxname AS stxname, pg_get_statisticsobjdef(s.oid) AS stxdef, s.stxstattarget AS stxstattarget, obj_description(s.oid, 'pg_statistic_ext') AS description, pg_get_userbyid(s.stxowner) AS stxowner FROM pg_statistic_ext s INNER JOIN pg_namespace n ON (s.stxnamespace = n.oid) WHERE TRUE %s%s ORDER BY n.nspname, s.stxname", include_schema_str, exclude_schema_str);
+	if (getServerVersion(c) >= 130000)
+		query = psprintf("SELECT s.oid, n.nspname AS nspname, s.stxname AS stxname, pg_get_statisticsobjdef(s.oid) AS stxdef, s.stxstattarget AS stxstattarget, pg_get_userbyid(s.stxowner) AS stxowner FROM pg_statistic_ext s INNER JOIN pg_namespace n ON (s.stxnamespace = n.oid) WHERE TRUE %s%s ORDER BY n.nspname, s.stxname", include_schema_str, exclude_schema_str);
 	else
-		query = psprintf("SELECT s.oid, n.nspname AS nspname, s.stxname AS stxname, pg_get_statisticsobjdef(s.oid) AS stxdef, NULL AS stxstattarget, obj_description(s.oid, 'pg_statistic_ext') AS description, pg_get_userbyid(s.stxowner) AS stxowner FROM pg_statistic_ext s INNER JOIN pg_namespace n ON (s.stxnamespace = n.oid) WHERE TRUE %s%s ORDER BY n.nspname, s.stxname", include_schema_str, exclude_schema_str);
+		query = psprintf("SELECT s.oid, n.nspname AS nspname, s.stxname AS stxname, pg_get_statisticsobjdef(s.oid) AS stxdef, NULL AS stxstattarget, pg_get_userbyid(s.stxowner) AS stxowner FROM pg_statistic_ext s INNER JOIN pg_namespace n ON (s.stxnamespace = n.oid) WHERE TRUE %s%s ORDER BY n.nspname, s.stxname", include_schema_str, exclude_schema_str);
 
-	res = PQexec(c, query);
+	res = execQuery(c, query);
 
 	pfree(query);
 
@@ -61,7 +61,7 @@ getStatistics(PGconn *c, int *n)
 
 	*n = PQntuples(res);
 	if (*n > 0)
-		s = (PQLStatistics *) malloc(*n * sizeof(PQLStatistics));
+		s = (PQLStatistics *) arenaAlloc(*n * sizeof(PQLStatistics));
 	else
 		s = NULL;
 
@@ -69,33 +69,17 @@ getStatistics(PGconn *c, int *n)
 
 	for (i = 0; i < *n; i++)
 	{
-		char	*withoutescape;
-
 		s[i].obj.oid = strtoul(PQgetvalue(res, i, PQfnumber(res, "oid")), NULL, 10);
-		s[i].obj.schemaname = strdup(PQgetvalue(res, i, PQfnumber(res, "nspname")));
-		s[i].obj.objectname = strdup(PQgetvalue(res, i, PQfnumber(res, "stxname")));
-		s[i].stxdef = strdup(PQgetvalue(res, i, PQfnumber(res, "stxdef")));
+		s[i].obj.schemaname = internName(PQgetvalue(res, i, PQfnumber(res, "nspname")));
+		s[i].obj.objectname = internName(PQgetvalue(res, i, PQfnumber(res, "stxname")));
+		s[i].stxdef = arenaStrdup(PQgetvalue(res, i, PQfnumber(res, "stxdef")));
 		if (PQgetisnull(res, i, PQfnumber(res, "stxstattarget")))
 			s[i].stxtarget = NULL;
 		else
-			s[i].stxtarget = strdup(PQgetvalue(res, i, PQfnumber(res, "stxstattarget")));
-		if (PQgetisnull(res, i, PQfnumber(res, "description")))
-			s[i].comment = NULL;
-		else
-		{
-			withoutescape = PQgetvalue(res, i, PQfnumber(res, "description"));
-			s[i].comment = PQescapeLiteral(c, withoutescape, strlen(withoutescape));
-			if (s[i].comment == NULL)
-			{
-				logError("escaping comment failed: %s", PQerrorMessage(c));
-				PQclear(res);
-				PQfinish(c);
-				/* XXX leak another connection? */
-				exit(EXIT_FAILURE);
-			}
-		}
+			s[i].stxtarget = arenaStrdup(PQgetvalue(res, i, PQfnumber(res, "stxstattarget")));
+		s[i].comment = getComment(PGQ_CLASS_STATISTIC_EXT, s[i].obj.oid, 0);
 
-		s[i].owner = strdup(PQgetvalue(res, i, PQfnumber(res, "stxowner")));
+		s[i].owner = internName(PQgetvalue(res, i, PQfnumber(res, "stxowner")));
 
 		logDebug("statistics \"%s\".\"%s\"", s[i].obj.schemaname, s[i].obj.objectname);
 	}
@@ -105,34 +89,11 @@ getStatistics(PGconn *c, int *n)
 	return s;
 }
 
-void
-freeStatistics(PQLStatistics *s, int n)
-{
-	if (n > 0)
-	{
-		int	i;
-
-		for (i = 0; i < n; i++)
-		{
-			free(s[i].obj.schemaname);
-			free(s[i].obj.objectname);
-			free(s[i].stxdef);
-			free(s[i].owner);
-			if (s[i].stxtarget)
-				free(s[i].stxtarget);
-			if (s[i].comment)
-				PQfreemem(s[i].comment);
-		}
-
-		free(s);
-	}
-}
-
 void
 dumpCreateStatistics(FILE *output, PQLStatistics *s)
 {
-	char	*schema = formatObjectIdentifier(s->obj.schemaname);
-	char	*stxname = formatObjectIdentifier(s->obj.objectname);
+	char	*schema = quotedName(s->obj.schemaname);
+	char	*stxname = quotedName(s->obj.objectname);
 
 	fprintf(output, "\n\n");
 	fprintf(output, "%s;", s->stxdef);
@@ -141,46 +102,38 @@ dumpCreateStatistics(FILE *output, PQLStatistics *s)
 	if (options.comment && s->comment != NULL)
 	{
 		fprintf(output, "\n\n");
-		fprintf(output, "COMMENT ON STATISTICS %s.%s IS %s;", schema, stxname,
-				s->comment);
+		fprintf(output, "COMMENT ON STATISTICS %s.%s IS ", schema, stxname);
+		printComment(output, s->comment);
+		fprintf(output, ";");
 	}
 
 	/* owner */
 	if (options.owner)
 	{
-		char	*owner = formatObjectIdentifier(s->owner);
+		char	*owner = quotedName(s->owner);
 
 		fprintf(output, "\n\n");
 		fprintf(output, "ALTER STATISTICS %s.%s OWNER TO %s;", schema, stxname,
 				owner);
-
-		free(owner);
 	}
 
-	free(schema);
-	free(stxname);
 }
 
 void
 dumpDropStatistics(FILE *output, PQLStatistics *s)
 {
-	char	*schema = formatObjectIdentifier(s->obj.schemaname);
-	char	*stxname = formatObjectIdentifier(s->obj.objectname);
+	char	*schema = quotedName(s->obj.schemaname);
+	char	*stxname = quotedName(s->obj.objectname);
 
 	fprintf(output, "\n\n");
 	fprintf(output, "DROP STATISTICS %s.%s;", schema, stxname);
-
-	free(schema);
-	free(stxname);
 }
 
 void
 dumpAlterStatistics(FILE *output, PQLStatistics *a, PQLStatistics *b)
 {
-	char	*schema1 = formatObjectIdentifier(a->obj.schemaname);
-	char	*stxname1 = formatObjectIdentifier(a->obj.objectname);
-	char	*schema2 = formatObjectIdentifier(b->obj.schemaname);
-	char	*stxname2 = formatObjectIdentifier(b->obj.objectname);
+	char	*schema2 = quotedName(b->obj.schemaname);
+	char	*stxname2 = quotedName(b->obj.objectname);
 
 	/* statistics target */
 	if (a->stxtarget != NULL && b->stxtarget != NULL &&
@@ -199,8 +152,9 @@ dumpAlterStatistics(FILE *output, PQLStatistics *a, PQLStatistics *b)
 				 strcmp(a->comment, b->comment) != 0))
 		{
 			fprintf(output, "\n\n");
-			fprintf(output, "COMMENT ON STATISTICS %s.%s IS %s;", schema2, stxname2,
-					b->comment);
+			fprintf(output, "COMMENT ON STATISTICS %s.%s IS ", schema2, stxname2);
+			printComment(output, b->comment);
+			fprintf(output, ";");
 		}
 		else if (a->comment != NULL && b->comment == NULL)
 		{
@@ -214,18 +168,11 @@ dumpAlterStatistics(FILE *output, PQLStatistics *a, PQLStatistics *b)
 	{
 		if (strcmp(a->owner, b->owner) != 0)
 		{
-			char	*owner = formatObjectIdentifier(b->owner);
+			char	*owner = quotedName(b->owner);
 
 			fprintf(output, "\n\n");
 			fprintf(output, "ALTER STATISTICS %s.%s OWNER TO %s;", schema2, stxname2,
 					owner);
-
-			free(owner);
 		}
 	}
-
-	free(schema1);
-	free(stxname1);
-	free(schema2);
-	free(stxname2);
 }
@@ -9,6 +9,7 @@
 #ifndef STATISTICS_H
 #define STATISTICS_H
 
+#include "comment.h"
 #include "common.h"
 
 typedef struct PQLStatistics
@@ -26,6 +27,5 @@ void dumpDropStatistics(FILE *output, PQLStatistics *s);
 void dumpCreateStatistics(FILE *output, PQLStatistics *s);
 void dumpAlterStatistics(FILE *output, PQLStatistics *a, PQLStatistics *b);
 
-void freeStatistics(PQLStatistics *s, int n);
 
 #endif	/* STATISTICS_H */
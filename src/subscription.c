@@ -35,17 +35,18 @@ getSubscriptions(PGconn *c, int *n)
 	PGresult		*res;
 	int				i;
 
-	logNoise("subscription: server version: %d", PQserverVersion(c));
+	logNoise("subscription: server version: %d", getServerVersion(c));
 
 	/* bail out if we do not support it */
-	if (PQserverVersion(c) < 100000)
+	if (getServerVersion(c) < 100000)
 	{
 		logWarning("ignoring subscriptions because server does not support it");
 		return NULL;
 	}
 
-	res = PQexec(c,
-				 "SELECT s.oid, subname, subenabled, subconninfo, subslotname, subsynccommit, obj_description(s.oid, 'pg_subscription') AS description, pg_get_userbyid(subowner) AS subowner FROM pg_subscription s ORDER BY subname");
+	/* subscriptions are not covered by the catalog cache */
+	res = execServerQuery(c,
+				 "SELECT s.oid, subname, subenabled, subconninfo, subslotname, subsynccommit, pg_get_userbyid(subowner) AS subowner FROM pg_subscription s ORDER BY subname");
 
 	if (PQresultStatus(res) != PGRES_TUPLES_OK)
 	{
@@ -58,7 +59,7 @@ getSubscriptions(PGconn *c, int *n)
 
 	*n = PQntuples(res);
 	if (*n > 0)
-		s = (PQLSubscription *) malloc(*n * sizeof(PQLSubscription));
+		s = (PQLSubscription *) arenaAlloc(*n * sizeof(PQLSubscription));
 	else
 		s = NULL;
 
@@ -66,39 +67,23 @@ getSubscriptions(PGconn *c, int *n)
 
 	for (i = 0; i < *n; i++)
 	{
-		char	*withoutescape;
-
 		s[i].oid = strtoul(PQgetvalue(res, i, PQfnumber(res, "oid")), NULL, 10);
-		s[i].subname = strdup(PQgetvalue(res, i, PQfnumber(res, "subname")));
-		s[i].conninfo = strdup(PQgetvalue(res, i, PQfnumber(res, "subconninfo")));
+		s[i].subname = arenaStrdup(PQgetvalue(res, i, PQfnumber(res, "subname")));
+		s[i].conninfo = arenaStrdup(PQgetvalue(res, i, PQfnumber(res, "subconninfo")));
 		if (PQgetisnull(res, i, PQfnumber(res, "subslotname")))
 			s[i].slotname = NULL;
 		else
-			s[i].slotname = strdup(PQgetvalue(res, i, PQfnumber(res, "subslotname")));
-		s[i].synccommit = strdup(PQgetvalue(res, i, PQfnumber(res, "subsynccommit")));
+			s[i].slotname = arenaStrdup(PQgetvalue(res, i, PQfnumber(res, "subslotname")));
+		s[i].synccommit = arenaStrdup(PQgetvalue(res, i, PQfnumber(res, "subsynccommit")));
 		s[i].enabled = (PQgetvalue(res, i, PQfnumber(res, "subenabled"))[0] == 't');
-		if (PQgetisnull(res, i, PQfnumber(res, "description")))
-			s[i].comment = NULL;
-		else
-		{
-			withoutescape = PQgetvalue(res, i, PQfnumber(res, "description"));
-			s[i].comment = PQescapeLiteral(c, withoutescape, strlen(withoutescape));
-			if (s[i].comment == NULL)
-			{
-				logError("escaping comment failed: %s", PQerrorMessage(c));
-				PQclear(res);
-				PQfinish(c);
-				/* XXX leak another connection? */
-				exit(EXIT_FAILURE);
-			}
-		}
+		s[i].comment = getComment(PGQ_CLASS_SUBSCRIPTION, s[i].oid, 0);
 
-		s[i].owner = strdup(PQgetvalue(res, i, PQfnumber(res, "subowner")));
+		s[i].owner = internName(PQgetvalue(res, i, PQfnumber(res, "subowner")));
 
 		/*
 		 * These values are not assigned here (see getSubscriptionPublications), but
 		 * defaults values are essential to avoid having trouble in
-		 * freeSubscriptions.
+		 * the dump routines.
 		 */
 		s[i].npublications = 0;
 		s[i].publications = NULL;
@@ -106,7 +91,7 @@ getSubscriptions(PGconn *c, int *n)
 		/*
 		 * Security labels are not assigned here (see getSubscriptionSecurityLabels),
 		 * but default values are essential to avoid having trouble in
-		 * freeSubscriptions.
+		 * the dump routines.
 		 */
 		s[i].nseclabels = 0;
 		s[i].seclabels = NULL;
@@ -120,141 +105,69 @@ getSubscriptions(PGconn *c, int *n)
 }
 
 void
-getSubscriptionPublications(PGconn *c, PQLSubscription *s)
+getSubscriptionPublications(PGconn *c, PQLSubscription *s, int n)
 {
-	char		*query;
-	PGresult	*res;
-	int			i;
+	char		**queries;
+	PGresult	**res;
+	int			i, j;
 
-	query = psprintf("SELECT unnest(subpublications) FROM pg_subscription s WHERE s.oid = %u ORDER BY 1", s->oid);
+	if (n == 0)
+		return;
 
-	res = PQexec(c, query);
+	queries = (char **) malloc(n * sizeof(char *));
+	for (i = 0; i < n; i++)
+		queries[i] = psprintf("SELECT unnest(subpublications) FROM pg_subscription s WHERE s.oid = %u ORDER BY 1", s[i].oid);
 
-	pfree(query);
+	res = execServerQueries(c, queries, n);
 
-	if (PQresultStatus(res) != PGRES_TUPLES_OK)
+	for (i = 0; i < n; i++)
 	{
-		logError("query failed: %s", PQresultErrorMessage(res));
-		PQclear(res);
-		PQfinish(c);
-		/* XXX leak another connection? */
-		exit(EXIT_FAILURE);
-	}
+		s[i].npublications = PQntuples(res[i]);
+		if (s[i].npublications > 0)
+			s[i].publications = (PQLSubPublication *) arenaAlloc(s[i].npublications * sizeof(
+								  PQLSubPublication));
+		else
+			s[i].publications = NULL;
 
-	s->npublications = PQntuples(res);
-	if (s->npublications > 0)
-		s->publications = (PQLSubPublication *) malloc(s->npublications * sizeof(
-							  PQLSubPublication));
-	else
-		s->publications = NULL;
+		logDebug("number of publications in subscription \"%s\": %d", s[i].subname,
+				 s[i].npublications);
 
-	logDebug("number of publications in subscription \"%s\": %d", s->subname,
-			 s->npublications);
+		for (j = 0; j < s[i].npublications; j++)
+		{
+			s[i].publications[j].pubname = arenaStrdup(PQgetvalue(res[i], j, PQfnumber(res[i],
+												"pubname")));
 
-	for (i = 0; i < s->npublications; i++)
-	{
-		s->publications[i].pubname = strdup(PQgetvalue(res, i, PQfnumber(res,
-											"pubname")));
+			logDebug("publication \"%s\" in subscription \"%s\"",
+					 s[i].publications[j].pubname, s[i].subname);
+		}
 
-		logDebug("publication \"%s\" in subscription \"%s\"",
-				 s->publications[i].pubname, s->subname);
+		PQclear(res[i]);
 	}
 
-	PQclear(res);
+	free(res);
 }
 
 void
-getSubscriptionSecurityLabels(PGconn *c, PQLSubscription *s)
+getSubscriptionSecurityLabels(PGconn *c, PQLSubscription *s, int n)
 {
-	char		*query;
-	PGresult	*res;
 	int			i;
 
-	query = psprintf("SELECT provider, label FROM pg_seclabel s INNER JOIN pg_class c ON (s.classoid = c.oid) WHERE c.relname = 'pg_subscription' AND s.objoid = %u ORDER BY provider", s->oid);
-
-	res = PQexec(c, query);
-
-	pfree(query);
-
-	if (PQresultStatus(res) != PGRES_TUPLES_OK)
-	{
-		logError("query failed: %s", PQresultErrorMessage(res));
-		PQclear(res);
-		PQfinish(c);
-		/* XXX leak another connection? */
-		exit(EXIT_FAILURE);
-	}
-
-	s->nseclabels = PQntuples(res);
-	if (s->nseclabels > 0)
-		s->seclabels = (PQLSecLabel *) malloc(s->nseclabels * sizeof(PQLSecLabel));
-	else
-		s->seclabels = NULL;
-
-	logDebug("number of security labels in subscription \"%s\": %d", s->subname,
-			 s->nseclabels);
+	if (n == 0)
+		return;
 
-	for (i = 0; i < s->nseclabels; i++)
+	if (getServerVersion(c) < 90100)
 	{
-		char	*withoutescape;
-
-		s->seclabels[i].provider = strdup(PQgetvalue(res, i, PQfnumber(res,
-										  "provider")));
-		withoutescape = PQgetvalue(res, i, PQfnumber(res, "label"));
-		s->seclabels[i].label = PQescapeLiteral(c, withoutescape,
-												strlen(withoutescape));
-		if (s->seclabels[i].label == NULL)
-		{
-			logError("escaping label failed: %s", PQerrorMessage(c));
-			PQclear(res);
-			PQfinish(c);
-			/* XXX leak another connection? */
-			exit(EXIT_FAILURE);
-		}
+		logWarning("ignoring security labels because server does not support it");
+		return;
 	}
 
-	PQclear(res);
-}
-
-void
-freeSubscriptions(PQLSubscription *s, int n)
-{
-	if (n > 0)
+	for (i = 0; i < n; i++)
 	{
-		int	i;
-
-		for (i = 0; i < n; i++)
-		{
-			int	j;
-
-			free(s[i].subname);
-			free(s[i].conninfo);
-			if (s[i].slotname)
-				free(s[i].slotname);
-			free(s[i].synccommit);
-			if (s[i].comment)
-				PQfreemem(s[i].comment);
-			free(s[i].owner);
-
-			/* publications */
-			for (j = 0; j < s[i].npublications; j++)
-				free(s[i].publications[j].pubname);
-
-			if (s[i].publications)
-				free(s[i].publications);
-
-			/* security labels */
-			for (j = 0; j < s[i].nseclabels; j++)
-			{
-				free(s[i].seclabels[j].provider);
-				PQfreemem(s[i].seclabels[j].label);
-			}
-
-			if (s[i].seclabels)
-				free(s[i].seclabels);
-		}
+		s[i].nseclabels = getObjectSecurityLabels(c, PGQ_CLASS_SUBSCRIPTION,
+							  s[i].oid, 0, &s[i].seclabels);
 
-		free(s);
+		logDebug("number of security labels in subscription \"%s\": %d", s[i].subname,
+				 s[i].nseclabels);
 	}
 }
 
@@ -303,8 +216,9 @@ dumpCreateSubscription(FILE *output, PQLSubscription *s)
 	if (options.comment && s->comment != NULL)
 	{
 		fprintf(output, "\n\n");
-		fprintf(output, "COMMENT ON SUBSCRIPTION %s IS %s;", subscriptionname,
-				s->comment);
+		fprintf(output, "COMMENT ON SUBSCRIPTION %s IS ", subscriptionname);
+		printComment(output, s->comment);
+		fprintf(output, ";");
 	}
 
 	/* security labels */
@@ -323,12 +237,10 @@ dumpCreateSubscription(FILE *output, PQLSubscription *s)
 	/* owner */
 	if (options.owner)
 	{
-		char	*owner = formatObjectIdentifier(s->owner);
+		char	*owner = quotedName(s->owner);
 
 		fprintf(output, "\n\n");
 		fprintf(output, "ALTER SUBSCRIPTION %s OWNER TO %s;", subscriptionname, owner);
-
-		free(owner);
 	}
 
 	free(subscriptionname);
@@ -418,8 +330,9 @@ dumpAlterSubscription(FILE *output, PQLSubscription *a, PQLSubscription *b)
 				 strcmp(a->comment, b->comment) != 0))
 		{
 			fprintf(output, "\n\n");
-			fprintf(output, "COMMENT ON SUBSCRIPTION %s IS %s;", subscriptionname2,
-					b->comment);
+			fprintf(output, "COMMENT ON SUBSCRIPTION %s IS ", subscriptionname2);
+			printComment(output, b->comment);
+			fprintf(output, ";");
 		}
 		else if (a->comment != NULL && b->comment == NULL)
 		{
@@ -519,12 +432,10 @@ dumpAlterSubscription(FILE *output, PQLSubscription *a, PQLSubscription *b)
 	{
 		if (strcmp(a->owner, b->owner) != 0)
 		{
-			char	*owner = formatObjectIdentifier(b->owner);
+			char	*owner = quotedName(b->owner);
 
 			fprintf(output, "\n\n");
 			fprintf(output, "ALTER SUBSCRIPTION %s OWNER TO %s;", subscriptionname2, owner);
-
-			free(owner);
 		}
 	}
 
@@ -9,7 +9,9 @@
 #ifndef SUBSCRIPTION_H
 #define SUBSCRIPTION_H
 
+#include "comment.h"
 #include "common.h"
+#include "seclabel.h"
 
 typedef struct PQLSubPublication
 {
@@ -35,15 +37,14 @@ typedef struct PQLSubscription
 } PQLSubscription;
 
 PQLSubscription *getSubscriptions(PGconn *c, int *n);
-void getSubscriptionPublications(PGconn *c, PQLSubscription *p);
-void getSubscriptionSecurityLabels(PGconn *c, PQLSubscription *s);
+void getSubscriptionPublications(PGconn *c, PQLSubscription *p, int n);
+void getSubscriptionSecurityLabels(PGconn *c, PQLSubscription *s, int n);
 
 void dumpDropSubscription(FILE *output, PQLSubscription *s);
 void dumpCreateSubscription(FILE *output, PQLSubscription *s);
 void dumpAlterSubscription(FILE *output, PQLSubscription *a,
 						   PQLSubscription *b);
 
-void freeSubscriptions(PQLSubscription *s, int n);
 
 #endif	/* SUBSCRIPTION_H */
 
@@ -61,6 +61,7 @@
  * ---------------------------------------------------------------------
  */
 #include "table.h"
+#include "catalog.h"
 
 
 #define	PGQ_IS_REGULAR_TABLE(ptr) (ptr == 'r')
@@ -69,24 +70,57 @@
 #define	PGQ_IS_REGULAR_OR_PARTITIONED_TABLE(ptr) \
 	(PGQ_IS_REGULAR_TABLE(ptr) || PGQ_IS_PARTITIONED_TABLE(ptr))
 
+/* what a command does to the data of a table (see formatCommandCost) */
+#define	PGQ_COST_METADATA	0		/* catalog only */
+#define	PGQ_COST_SCAN		1		/* reads the table */
+#define	PGQ_COST_REWRITE	2		/* writes a new copy of the table */
+
+/*
+ * Changes of one table that dumpAlterTable prints as a single ALTER TABLE
+ * statement, so the table is locked (and rewritten) at most once. Commands
+ * that cannot be subcommands (e.g. COMMENT ON CONSTRAINT or VALIDATE
+ * CONSTRAINT in online mode) are kept in 'after'. Comments, security labels
+ * and privileges of the columns in 'columns' are printed after them.
+ * 'cost' is the most expensive subcommand of the ALTER TABLE statement.
+ */
+typedef struct PQLAlterTableCmds
+{
+	PQLTable	*target;	/* table of server 1; see formatCommandCost */
+	stringList	cmds;
+	int			cost;
+	stringList	after;
+	int			*columns;	/* pairs of attributes (a, b); a is -1 if added */
+	int			ncolumns;
+} PQLAlterTableCmds;
+
 
 static PQLTable *getTables(PGconn *c, int *n, char k);
 static void getParentTables(PGconn *c, PQLTable *t);
-static void dumpAddColumn(FILE *output, PQLTable *t, int i);
-static void dumpRemoveColumn(FILE *output, PQLTable *t, int i);
-static void dumpAlterColumn(FILE *output, PQLTable *a, int i, PQLTable *b,
-							int j);
-static void dumpAlterColumnSetStatistics(FILE *output, PQLTable *a, int i,
-		bool force);
-static void dumpAlterColumnSetStorage(FILE *output, PQLTable *a, int i,
-									  bool force);
-static void dumpAlterColumnSetOptions(FILE *output, PQLTable *a, int i,
+static char *formatCommandCost(PQLTable *t, int cost);
+static void appendAlterTableCmd(stringList *sl, const char *fmt, ...);
+static void appendAlterTableStmt(PQLAlterTableCmds *at, int cost,
+								 const char *fmt, ...);
+static void addAlterTableColumn(PQLAlterTableCmds *at, int i, int j);
+static void dumpAlterTableCmds(FILE *output, PQLTable *a, PQLTable *b,
+							   PQLAlterTableCmds *at);
+static void dumpAddColumn(PQLAlterTableCmds *at, PQLTable *t, int i);
+static void dumpAddColumnProperties(FILE *output, PQLTable *t, int i);
+static void dumpRemoveColumn(PQLAlterTableCmds *at, PQLTable *t, int i);
+static void dumpAlterColumn(PQLAlterTableCmds *at, PQLTable *a, int i,
+							PQLTable *b, int j);
+static void dumpAlterColumnProperties(FILE *output, PQLTable *a, int i,
 									  PQLTable *b, int j);
-static void dumpAddPK(FILE *output, PQLTable *t);
-static void dumpRemovePK(FILE *output, PQLTable *t);
-static void dumpAddFK(FILE *output, PQLTable *t, int i);
-static void dumpRemoveFK(FILE *output, PQLTable *t, int i);
-static void dumpAttachPartition(FILE *output, PQLTable *a);
+static void dumpAlterColumnSetStatistics(FILE *output, PQLAlterTableCmds *at,
+		PQLTable *a, int i, bool force);
+static void dumpAlterColumnSetStorage(FILE *output, PQLAlterTableCmds *at,
+									  PQLTable *a, int i, bool force);
+static void dumpAlterColumnSetOptions(PQLAlterTableCmds *at, PQLTable *a,
+									  int i, PQLTable *b, int j);
+static void dumpAddPK(PQLAlterTableCmds *at, PQLTable *t);
+static void dumpRemovePK(PQLAlterTableCmds *at, PQLTable *t);
+static void dumpAddFK(PQLAlterTableCmds *at, PQLTable *t, int i);
+static void dumpRemoveFK(PQLAlterTableCmds *at, PQLTable *t, int i);
+static void dumpAttachPartition(FILE *output, PQLTable *a, PQLTable *target);
 static void dumpDetachPartition(FILE *output, PQLTable *a);
 
 PQLTable *
@@ -108,21 +142,21 @@ getTables(PGconn *c, int *n, char k)
 		exit(EXIT_FAILURE);
 	}
 
-	logNoise("%s: server version: %d", kind, PQserverVersion(c));
+	logNoise("%s: server version: %d", kind, getServerVersion(c));
 
 	/* FIXME relpersistence (9.1)? */
 	/*
 	 * XXX Using 'v' (void) to represent unsupported replica identity
 	 */
-	if (PQserverVersion(c) >= 100000)
+	if (getServerVersion(c) >= 100000)
 	{
 		if (PGQ_IS_REGULAR_OR_PARTITIONED_TABLE(k))
 		{
-			query = psprintf("SELECT c.oid, n.nspname, c.relname, c.relkind, t.spcname AS tablespacename, c.relpersistence, array_to_string(c.reloptions, ', ') AS reloptions, obj_description(c.oid, 'pg_class') AS description, pg_get_userbyid(c.relowner) AS relowner, relacl, relreplident, reloftype, o.nspname AS typnspname, y.typname, c.relispartition, pg_get_partkeydef(c.oid) AS partitionkeydef, pg_get_expr(c.relpartbound, c.oid) AS partitionbound, c.relhassubclass FROM pg_class c INNER JOIN pg_namespace n ON (c.relnamespace = n.oid) LEFT JOIN pg_tablespace t ON (c.reltablespace = t.oid) LEFT JOIN (pg_type y INNER JOIN pg_namespace o ON (y.typnamespace = o.oid)) ON (c.reloftype = y.oid) WHERE relkind IN ('r', 'p') AND n.nspname !~ '^pg_' AND n.nspname <> 'information_schema' %s%s AND NOT EXISTS(SELECT 1 FROM pg_depend d WHERE t.oid = d.objid AND d.deptype = 'e') ORDER BY n.nspname, relname", include_schema_str, exclude_schema_str);
+			query = psprintf("SELECT c.oid, n.nspname, c.relname, c.relkind, t.spcname AS tablespacename, c.relpersistence, array_to_string(c.reloptions, ', ') AS reloptions, pg_get_userbyid(c.relowner) AS relowner, relacl, relreplident, reloftype, o.nspname AS typnspname, y.typname, c.relispartition, pg_get_partkeydef(c.oid) AS partitionkeydef, pg_get_expr(c.relpartbound, c.oid) AS partitionbound, c.relhassubclass FROM pg_class c INNER JOIN pg_namespace n ON (c.relnamespace = n.oid) LEFT JOIN pg_tablespace t ON (c.reltablespace = t.oid) LEFT JOIN (pg_type y INNER JOIN pg_namespace o ON (y.typnamespace = o.oid)) ON (c.reloftype = y.oid) WHERE relkind IN ('r', 'p') AND n.nspname !~ '^pg_' AND n.nspname <> 'information_schema' %s%s AND NOT EXISTS(SELECT 1 FROM pg_depend d WHERE t.oid = d.objid AND d.deptype = 'e') ORDER BY n.nspname, relname", include_schema_str, exclude_schema_str);
 		}
 		else if (PGQ_IS_FOREIGN_TABLE(k))
 		{
-			query = psprintf("SELECT c.oid, n.nspname, c.relname, c.relkind, t.spcname AS tablespacename, c.relpersistence, array_to_string(c.reloptions, ', ') AS reloptions, obj_description(c.oid, 'pg_class') AS description, pg_get_userbyid(c.relowner) AS relowner, relacl, relreplident, reloftype, o.nspname AS typnspname, y.typname, c.relispartition, pg_get_partkeydef(c.oid) AS partitionkeydef, pg_get_expr(c.relpartbound, c.oid) AS partitionbound, c.relhassubclass FROM pg_class c INNER JOIN pg_namespace n ON (c.relnamespace = n.oid) LEFT JOIN pg_tablespace t ON (c.reltablespace = t.oid) LEFT JOIN (pg_type y INNER JOIN pg_namespace o ON (y.typnamespace = o.oid)) ON (c.reloftype = y.oid) WHERE relkind = 'f' AND n.nspname !~ '^pg_' AND n.nspname <> 'information_schema' %s%s AND NOT EXISTS(SELECT 1 FROM pg_depend d WHERE t.oid = d.objid AND d.deptype = 'e') ORDER BY n.nspname, relname", include_schema_str, exclude_schema_str);
+			query = psprintf("SELECT c.oid, n.nspname, c.relname, c.relkind, t.spcname AS tablespacename, c.relpersistence, array_to_string(c.reloptions, ', ') AS reloptions, pg_get_userbyid(c.relowner) AS relowner, relacl, relreplident, reloftype, o.nspname AS typnspname, y.typname, c.relispartition, pg_get_partkeydef(c.oid) AS partitionkeydef, pg_get_expr(c.relpartbound, c.oid) AS partitionbound, c.relhassubclass FROM pg_class c INNER JOIN pg_namespace n ON (c.relnamespace = n.oid) LEFT JOIN pg_tablespace t ON (c.reltablespace = t.oid) LEFT JOIN (pg_type y INNER JOIN pg_namespace o ON (y.typnamespace = o.oid)) ON (c.reloftype = y.oid) WHERE relkind = 'f' AND n.nspname !~ '^pg_' AND n.nspname <> 'information_schema' %s%s AND NOT EXISTS(SELECT 1 FROM pg_depend d WHERE t.oid = d.objid AND d.deptype = 'e') ORDER BY n.nspname, relname", include_schema_str, exclude_schema_str);
 		}
 		else
 		{
@@ -130,15 +164,15 @@ getTables(PGconn *c, int *n, char k)
 			exit(EXIT_FAILURE);
 		}
 	}
-	else if (PQserverVersion(c) >= 90400)
+	else if (getServerVersion(c) >= 90400)
 	{
 		if (PGQ_IS_REGULAR_TABLE(k))
 		{
-			query = psprintf("SELECT c.oid, n.nspname, c.relname, c.relkind, t.spcname AS tablespacename, c.relpersistence, array_to_string(c.reloptions, ', ') AS reloptions, obj_description(c.oid, 'pg_class') AS description, pg_get_userbyid(c.relowner) AS relowner, relacl, relreplident, reloftype, o.nspname AS typnspname, y.typname, false AS relispartition, NULL AS partitionkeydef, NULL AS partitionbound, c.relhassubclass FROM pg_class c INNER JOIN pg_namespace n ON (c.relnamespace = n.oid) LEFT JOIN pg_tablespace t ON (c.reltablespace = t.oid) LEFT JOIN (pg_type y INNER JOIN pg_namespace o ON (y.typnamespace = o.oid)) ON (c.reloftype = y.oid) WHERE relkind = 'r' AND n.nspname !~ '^pg_' AND n.nspname <> 'information_schema' %s%s AND NOT EXISTS(SELECT 1 FROM pg_depend d WHERE t.oid = d.objid AND d.deptype = 'e') ORDER BY n.nspname, relname", include_schema_str, exclude_schema_str);
+			query = psprintf("SELECT c.oid, n.nspname, c.relname, c.relkind, t.spcname AS tablespacename, c.relpersistence, array_to_string(c.reloptions, ', ') AS reloptions, pg_get_userbyid(c.relowner) AS relowner, relacl, relreplident, reloftype, o.nspname AS typnspname, y.typname, false AS relispartition, NULL AS partitionkeydef, NULL AS partitionbound, c.relhassubclass FROM pg_class c INNER JOIN pg_namespace n ON (c.relnamespace = n.oid) LEFT JOIN pg_tablespace t ON (c.reltablespace = t.oid) LEFT JOIN (pg_type y INNER JOIN pg_namespace o ON (y.typnamespace = o.oid)) ON (c.reloftype = y.oid) WHERE relkind = 'r' AND n.nspname !~ '^pg_' AND n.nspname <> 'information_schema' %s%s AND NOT EXISTS(SELECT 1 FROM pg_depend d WHERE t.oid = d.objid AND d.deptype = 'e') ORDER BY n.nspname, relname", include_schema_str, exclude_schema_str);
 		}
 		else if (PGQ_IS_FOREIGN_TABLE(k))
 		{
-			query = psprintf("SELECT c.oid, n.nspname, c.relname, c.relkind, t.spcname AS tablespacename, c.relpersistence, array_to_string(c.reloptions, ', ') AS reloptions, obj_description(c.oid, 'pg_class') AS description, pg_get_userbyid(c.relowner) AS relowner, relacl, relreplident, reloftype, o.nspname AS typnspname, y.typname, false AS relispartition, NULL AS partitionkeydef, NULL AS partitionbound, c.relhassubclass FROM pg_class c INNER JOIN pg_namespace n ON (c.relnamespace = n.oid) LEFT JOIN pg_tablespace t ON (c.reltablespace = t.oid) LEFT JOIN (pg_type y INNER JOIN pg_namespace o ON (y.typnamespace = o.oid)) ON (c.reloftype = y.oid) WHERE relkind = 'f' AND n.nspname !~ '^pg_' AND n.nspname <> 'information_schema' %s%s AND NOT EXISTS(SELECT 1 FROM pg_depend d WHERE t.oid = d.objid AND d.deptype = 'e') ORDER BY n.nspname, relname", include_schema_str, exclude_schema_str);
+			query = psprintf("SELECT c.oid, n.nspname, c.relname, c.relkind, t.spcname AS tablespacename, c.relpersistence, array_to_string(c.reloptions, ', ') AS reloptions, pg_get_userbyid(c.relowner) AS relowner, relacl, relreplident, reloftype, o.nspname AS typnspname, y.typname, false AS relispartition, NULL AS partitionkeydef, NULL AS partitionbound, c.relhassubclass FROM pg_class c INNER JOIN pg_namespace n ON (c.relnamespace = n.oid) LEFT JOIN pg_tablespace t ON (c.reltablespace = t.oid) LEFT JOIN (pg_type y INNER JOIN pg_namespace o ON (y.typnamespace = o.oid)) ON (c.reloftype = y.oid) WHERE relkind = 'f' AND n.nspname !~ '^pg_' AND n.nspname <> 'information_schema' %s%s AND NOT EXISTS(SELECT 1 FROM pg_depend d WHERE t.oid = d.objid AND d.deptype = 'e') ORDER BY n.nspname, relname", include_schema_str, exclude_schema_str);
 		}
 		else
 		{
@@ -146,15 +180,15 @@ getTables(PGconn *c, int *n, char k)
 			exit(EXIT_FAILURE);
 		}
 	}
-	else if (PQserverVersion(c) >= 90100)	/* extension support */
+	else if (getServerVersion(c) >= 90100)	/* extension support */
 	{
 		if (PGQ_IS_REGULAR_TABLE(k))
 		{
-			query = psprintf("SELECT c.oid, n.nspname, c.relname, c.relkind, t.spcname AS tablespacename, c.relpersistence, array_to_string(c.reloptions, ', ') AS reloptions, obj_description(c.oid, 'pg_class') AS description, pg_get_userbyid(c.relowner) AS relowner, relacl, 'v' AS relreplident, reloftype, o.nspname AS typnspname, y.typname, false AS relispartition, NULL AS partitionkeydef, NULL AS partitionbound, c.relhassubclass FROM pg_class c INNER JOIN pg_namespace n ON (c.relnamespace = n.oid) LEFT JOIN pg_tablespace t ON (c.reltablespace = t.oid) LEFT JOIN (pg_type y INNER JOIN pg_namespace o ON (y.typnamespace = o.oid)) ON (c.reloftype = y.oid) WHERE relkind = 'r' AND n.nspname !~ '^pg_' AND n.nspname <> 'information_schema' %s%s AND NOT EXISTS(SELECT 1 FROM pg_depend d WHERE t.oid = d.objid AND d.deptype = 'e') ORDER BY n.nspname, relname", include_schema_str, exclude_schema_str);
+			query = psprintf("SELECT c.oid, n.nspname, c.relname, c.relkind, t.spcname AS tablespacename, c.relpersistence, array_to_string(c.reloptions, ', ') AS reloptions, pg_get_userbyid(c.relowner) AS relowner, relacl, 'v' AS relreplident, reloftype, o.nspname AS typnspname, y.typname, false AS relispartition, NULL AS partitionkeydef, NULL AS partitionbound, c.relhassubclass FROM pg_class c INNER JOIN pg_namespace n ON (c.relnamespace = n.oid) LEFT JOIN pg_tablespace t ON (c.reltablespace = t.oid) LEFT JOIN (pg_type y INNER JOIN pg_namespace o ON (y.typnamespace = o.oid)) ON (c.reloftype = y.oid) WHERE relkind = 'r' AND n.nspname !~ '^pg_' AND n.nspname <> 'information_schema' %s%s AND NOT EXISTS(SELECT 1 FROM pg_depend d WHERE t.oid = d.objid AND d.deptype = 'e') ORDER BY n.nspname, relname", include_schema_str, exclude_schema_str);
 		}
 		else if (PGQ_IS_FOREIGN_TABLE(k))
 		{
-			query = psprintf("SELECT c.oid, n.nspname, c.relname, c.relkind, t.spcname AS tablespacename, c.relpersistence, array_to_string(c.reloptions, ', ') AS reloptions, obj_description(c.oid, 'pg_class') AS description, pg_get_userbyid(c.relowner) AS relowner, relacl, 'v' AS relreplident, reloftype, o.nspname AS typnspname, y.typname, false AS relispartition, NULL AS partitionkeydef, NULL AS partitionbound, c.relhassubclass FROM pg_class c INNER JOIN pg_namespace n ON (c.relnamespace = n.oid) LEFT JOIN pg_tablespace t ON (c.reltablespace = t.oid) LEFT JOIN (pg_type y INNER JOIN pg_namespace o ON (y.typnamespace = o.oid)) ON (c.reloftype = y.oid) WHERE relkind = 'f' AND n.nspname !~ '^pg_' AND n.nspname <> 'information_schema' %s%s AND NOT EXISTS(SELECT 1 FROM pg_depend d WHERE t.oid = d.objid AND d.deptype = 'e') ORDER BY n.nspname, relname", include_schema_str, exclude_schema_str);
+			query = psprintf("SELECT c.oid, n.nspname, c.relname, c.relkind, t.spcname AS tablespacename, c.relpersistence, array_to_string(c.reloptions, ', ') AS reloptions, pg_get_userbyid(c.relowner) AS relowner, relacl, 'v' AS relreplident, reloftype, o.nspname AS typnspname, y.typname, false AS relispartition, NULL AS partitionkeydef, NULL AS partitionbound, c.relhassubclass FROM pg_class c INNER JOIN pg_namespace n ON (c.relnamespace = n.oid) LEFT JOIN pg_tablespace t ON (c.reltablespace = t.oid) LEFT JOIN (pg_type y INNER JOIN pg_namespace o ON (y.typnamespace = o.oid)) ON (c.reloftype = y.oid) WHERE relkind = 'f' AND n.nspname !~ '^pg_' AND n.nspname <> 'information_schema' %s%s AND NOT EXISTS(SELECT 1 FROM pg_depend d WHERE t.oid = d.objid AND d.deptype = 'e') ORDER BY n.nspname, relname", include_schema_str, exclude_schema_str);
 		}
 		else
 		{
@@ -166,7 +200,7 @@ getTables(PGconn *c, int *n, char k)
 	{
 		if (PGQ_IS_REGULAR_TABLE(k))
 		{
-			query = psprintf("SELECT c.oid, n.nspname, c.relname, c.relkind, t.spcname AS tablespacename, 'p' AS relpersistence, array_to_string(c.reloptions, ', ') AS reloptions, obj_description(c.oid, 'pg_class') AS description, pg_get_userbyid(c.relowner) AS relowner, relacl, 'v' AS relreplident, 0 AS reloftype, NULL AS typnspname, NULL AS typname, false AS relispartition, NULL AS partitionkeydef, NULL AS partitionbound, c.relhassubclass FROM pg_class c INNER JOIN pg_namespace n ON (c.relnamespace = n.oid) LEFT JOIN pg_tablespace t ON (c.reltablespace = t.oid) WHERE relkind = 'r' AND n.nspname !~ '^pg_' AND n.nspname <> 'information_schema' %s%s ORDER BY n.nspname, relname", include_schema_str, exclude_schema_str);
+			query = psprintf("SELECT c.oid, n.nspname, c.relname, c.relkind, t.spcname AS tablespacename, 'p' AS relpersistence, array_to_string(c.reloptions, ', ') AS reloptions, pg_get_userbyid(c.relowner) AS relowner, relacl, 'v' AS relreplident, 0 AS reloftype, NULL AS typnspname, NULL AS typname, false AS relispartition, NULL AS partitionkeydef, NULL AS partitionbound, c.relhassubclass FROM pg_class c INNER JOIN pg_namespace n ON (c.relnamespace = n.oid) LEFT JOIN pg_tablespace t ON (c.reltablespace = t.oid) WHERE relkind = 'r' AND n.nspname !~ '^pg_' AND n.nspname <> 'information_schema' %s%s ORDER BY n.nspname, relname", include_schema_str, exclude_schema_str);
 		}
 		else
 		{
@@ -175,7 +209,7 @@ getTables(PGconn *c, int *n, char k)
 		}
 	}
 
-	res = PQexec(c, query);
+	res = execQuery(c, query);
 
 	pfree(query);
 
@@ -190,7 +224,7 @@ getTables(PGconn *c, int *n, char k)
 
 	*n = PQntuples(res);
 	if (*n > 0)
-		t = (PQLTable *) malloc(*n * sizeof(PQLTable));
+		t = (PQLTable *) arenaAlloc(*n * sizeof(PQLTable));
 	else
 		t = NULL;
 
@@ -198,22 +232,21 @@ getTables(PGconn *c, int *n, char k)
 
 	for (i = 0; i < *n; i++)
 	{
-		char	*withoutescape;
-
 		t[i].obj.oid = strtoul(PQgetvalue(res, i, PQfnumber(res, "oid")), NULL, 10);
-		t[i].obj.schemaname = strdup(PQgetvalue(res, i, PQfnumber(res, "nspname")));
-		t[i].obj.objectname = strdup(PQgetvalue(res, i, PQfnumber(res, "relname")));
+		t[i].obj.schemaname = internName(PQgetvalue(res, i, PQfnumber(res, "nspname")));
+		t[i].obj.objectname = internName(PQgetvalue(res, i, PQfnumber(res, "relname")));
 		t[i].kind = PQgetvalue(res, i, PQfnumber(res, "relkind"))[0];
 		if (PQgetisnull(res, i, PQfnumber(res, "tablespacename")))
 			t[i].tbspcname = NULL;
 		else
-			t[i].tbspcname = strdup(PQgetvalue(res, i, PQfnumber(res, "tablespacename")));
+			t[i].tbspcname = arenaStrdup(PQgetvalue(res, i, PQfnumber(res, "tablespacename")));
 		t[i].unlogged = (PQgetvalue(res, i, PQfnumber(res,
 									"relpersistence"))[0] == 'u');
 
 		/*
 		 * These values are not assigned here (see getTableAttributes), but
-		 * default values are essential to avoid having trouble in freeTables.
+		 * default values are essential to avoid having trouble in the dump
+		 * routines.
 		 */
 		t[i].nattributes = 0;
 		t[i].attributes = NULL;
@@ -231,32 +264,20 @@ getTables(PGconn *c, int *n, char k)
 		if (PQgetisnull(res, i, PQfnumber(res, "reloptions")))
 			t[i].reloptions = NULL;
 		else
-			t[i].reloptions = strdup(PQgetvalue(res, i, PQfnumber(res, "reloptions")));
-		if (PQgetisnull(res, i, PQfnumber(res, "description")))
-			t[i].comment = NULL;
-		else
-		{
-			withoutescape = PQgetvalue(res, i, PQfnumber(res, "description"));
-			t[i].comment = PQescapeLiteral(c, withoutescape, strlen(withoutescape));
-			if (t[i].comment == NULL)
-			{
-				logError("escaping comment failed: %s", PQerrorMessage(c));
-				PQclear(res);
-				PQfinish(c);
-				/* XXX leak another connection? */
-				exit(EXIT_FAILURE);
-			}
-		}
+			t[i].reloptions = arenaStrdup(PQgetvalue(res, i, PQfnumber(res, "reloptions")));
+		t[i].comment = getComment(PGQ_CLASS_CLASS, t[i].obj.oid, 0);
 
-		t[i].owner = strdup(PQgetvalue(res, i, PQfnumber(res, "relowner")));
+		t[i].owner = internName(PQgetvalue(res, i, PQfnumber(res, "relowner")));
 		if (PQgetisnull(res, i, PQfnumber(res, "relacl")))
 			t[i].acl = NULL;
 		else
-			t[i].acl = strdup(PQgetvalue(res, i, PQfnumber(res, "relacl")));
+			t[i].acl = arenaStrdup(PQgetvalue(res, i, PQfnumber(res, "relacl")));
 
 		t[i].relreplident = *(PQgetvalue(res, i, PQfnumber(res, "relreplident")));
 		/* assigned iif REPLICA IDENTITY USING INDEX; see getTableAttributes() */
 		t[i].relreplidentidx = NULL;
+		/* see getTableSizes() */
+		t[i].relsize = -1;
 
 		if (PQgetisnull(res, i, PQfnumber(res, "typname")))
 		{
@@ -268,14 +289,14 @@ getTables(PGconn *c, int *n, char k)
 		{
 			t[i].reloftype.oid = strtoul(PQgetvalue(res, i, PQfnumber(res, "reloftype")),
 										 NULL, 10);
-			t[i].reloftype.schemaname = strdup(PQgetvalue(res, i, PQfnumber(res,
+			t[i].reloftype.schemaname = internName(PQgetvalue(res, i, PQfnumber(res,
 											   "typnspname")));
-			t[i].reloftype.objectname = strdup(PQgetvalue(res, i, PQfnumber(res,
+			t[i].reloftype.objectname = internName(PQgetvalue(res, i, PQfnumber(res,
 											   "typname")));
 		}
 
 		if (PGQ_IS_PARTITIONED_TABLE(t[i].kind))
-			t[i].partitionkey = strdup(PQgetvalue(res, i, PQfnumber(res,
+			t[i].partitionkey = arenaStrdup(PQgetvalue(res, i, PQfnumber(res,
 												  "partitionkeydef")));
 		else
 			t[i].partitionkey = NULL;
@@ -284,7 +305,7 @@ getTables(PGconn *c, int *n, char k)
 									 "relispartition"))[0] == 't');
 		if (t[i].partition)
 		{
-			t[i].partitionbound = strdup(PQgetvalue(res, i, PQfnumber(res,
+			t[i].partitionbound = arenaStrdup(PQgetvalue(res, i, PQfnumber(res,
 													"partitionbound")));
 			getParentTables(c, &t[i]);
 		}
@@ -298,7 +319,7 @@ getTables(PGconn *c, int *n, char k)
 		/*
 		 * Foreign table properties are not assigned here (see
 		 * getForeignTableProperties), but default values are essential to
-		 * avoid having trouble in freeTables.
+		 * avoid having trouble in the dump routines.
 		 */
 		t[i].servername = NULL;
 		t[i].ftoptions = NULL;
@@ -306,7 +327,7 @@ getTables(PGconn *c, int *n, char k)
 		/*
 		 * Security labels are not assigned here (see getTableSecurityLabels),
 		 * but default values are essential to avoid having trouble in
-		 * freeTables.
+		 * the dump routines.
 		 */
 		t[i].nseclabels = 0;
 		t[i].seclabels = NULL;
@@ -341,7 +362,7 @@ getParentTables(PGconn *c, PQLTable *t)
 
 	query = psprintf("SELECT c.oid, n.nspname, c.relname FROM pg_inherits i INNER JOIN pg_class c ON (c.oid = i.inhparent) INNER JOIN pg_namespace n ON (c.relnamespace = n.oid) WHERE inhrelid = %u ORDER BY nspname, relname", t->obj.oid);
 
-	res = PQexec(c, query);
+	res = execQuery(c, query);
 
 	pfree(query);
 
@@ -356,7 +377,7 @@ getParentTables(PGconn *c, PQLTable *t)
 
 	t->nparent = PQntuples(res);
 	if (t->nparent > 0)
-		t->parent = (PQLObject *) malloc(t->nparent * sizeof(PQLObject));
+		t->parent = (PQLObject *) arenaAlloc(t->nparent * sizeof(PQLObject));
 	else
 		t->parent = NULL;
 
@@ -374,8 +395,8 @@ getParentTables(PGconn *c, PQLTable *t)
 	for (j = 0; j < t->nparent; j++)
 	{
 		t->parent[j].oid = strtoul(PQgetvalue(res, j, PQfnumber(res, "oid")), NULL, 10);
-		t->parent[j].schemaname = strdup(PQgetvalue(res, j, PQfnumber(res, "nspname")));
-		t->parent[j].objectname = strdup(PQgetvalue(res, j, PQfnumber(res, "relname")));
+		t->parent[j].schemaname = internName(PQgetvalue(res, j, PQfnumber(res, "nspname")));
+		t->parent[j].objectname = internName(PQgetvalue(res, j, PQfnumber(res, "relname")));
 	}
 
 	PQclear(res);
@@ -392,7 +413,7 @@ getForeignTableProperties(PGconn *c, PQLTable *t, int n)
 	{
 		query = psprintf("SELECT s.srvname, array_to_string(f.ftoptions, ', ') AS ftoptions FROM pg_foreign_table f INNER JOIN pg_foreign_server s ON (f.ftserver = s.oid) WHERE f.ftrelid = %u", t[i].obj.oid);
 
-		res = PQexec(c, query);
+		res = execQuery(c, query);
 
 		pfree(query);
 
@@ -407,11 +428,11 @@ getForeignTableProperties(PGconn *c, PQLTable *t, int n)
 
 		if (PQntuples(res) == 1)
 		{
-			t[i].servername = strdup(PQgetvalue(res, 0, PQfnumber(res, "srvname")));
+			t[i].servername = arenaStrdup(PQgetvalue(res, 0, PQfnumber(res, "srvname")));
 			if (PQgetisnull(res, 0, PQfnumber(res, "ftoptions")))
 				t->ftoptions = NULL;
 			else
-				t[i].ftoptions = strdup(PQgetvalue(res, 0, PQfnumber(res, "ftoptions")));
+				t[i].ftoptions = arenaStrdup(PQgetvalue(res, 0, PQfnumber(res, "ftoptions")));
 		}
 		else
 		{
@@ -427,237 +448,339 @@ getForeignTableProperties(PGconn *c, PQLTable *t, int n)
 	}
 }
 
-void
-getCheckConstraints(PGconn *c, PQLTable *t, int n)
+/*
+ * qsort comparator for an array of table pointers. Tables are ordered by oid.
+ */
+static int
+compareTableOids(const void *a, const void *b)
 {
-	char		*query;
-	PGresult	*res;
-	int			i, j;
-	char		*kind;
+	Oid		oa = (*(PQLTable **) a)->obj.oid;
+	Oid		ob = (*(PQLTable **) b)->obj.oid;
+
+	if (oa < ob)
+		return -1;
+	else if (oa > ob)
+		return 1;
+	else
+		return 0;
+}
+
+/*
+ * Return an array of pointers to tables ordered by oid. It is used to spread
+ * rows (ordered by table oid) from a single query across the table array.
+ */
+static PQLTable **
+sortTablesByOid(PQLTable *t, int n)
+{
+	PQLTable	**sorted;
+	int			i;
+
+	sorted = (PQLTable **) malloc(n * sizeof(PQLTable *));
+	if (sorted == NULL)
+	{
+		logError("could not allocate memory");
+		exit(EXIT_FAILURE);
+	}
 
 	for (i = 0; i < n; i++)
+		sorted[i] = &t[i];
+
+	qsort(sorted, n, sizeof(PQLTable *), compareTableOids);
+
+	return sorted;
+}
+
+/*
+ * Same as sortTablesByOid but for a list of table pointers.
+ */
+static PQLTable **
+sortTablePointersByOid(PQLTable **t, int n)
+{
+	PQLTable	**sorted;
+
+	sorted = (PQLTable **) malloc(n * sizeof(PQLTable *));
+	if (sorted == NULL)
 	{
-		if (PGQ_IS_REGULAR_OR_PARTITIONED_TABLE(t[i].kind))
-			kind = strdup("table");
-		else if (PGQ_IS_FOREIGN_TABLE(t[i].kind))
-			kind = strdup("foreign table");
-		else
-		{
-			logError("kind is not a regular, partitioned or foreign table");
-			exit(EXIT_FAILURE);
-		}
+		logError("could not allocate memory");
+		exit(EXIT_FAILURE);
+	}
 
-		/* FIXME conislocal (8.4)? convalidated (9.2)? */
-		/* XXX contype = 'c' needed? */
-		query = psprintf("SELECT conname, pg_get_constraintdef(c.oid) AS condef, obj_description(c.oid, 'pg_constraint') AS description FROM pg_constraint c WHERE conrelid = %u AND contype = 'c' ORDER BY conname", t[i].obj.oid);
+	memcpy(sorted, t, n * sizeof(PQLTable *));
+	qsort(sorted, n, sizeof(PQLTable *), compareTableOids);
 
-		res = PQexec(c, query);
+	return sorted;
+}
 
-		pfree(query);
+/*
+ * Build an oid array literal from a list of table pointers. Returns an
+ * allocated string.
+ */
+static char *
+buildTableOidArray(PQLTable **t, int n)
+{
+	char	*ret;
+	Oid		*o;
+	int		i;
 
-		if (PQresultStatus(res) != PGRES_TUPLES_OK)
-		{
-			logError("query failed: %s", PQresultErrorMessage(res));
-			PQclear(res);
-			PQfinish(c);
-			/* XXX leak another connection? */
-			exit(EXIT_FAILURE);
-		}
+	o = (Oid *) malloc(n * sizeof(Oid));
+	if (o == NULL)
+	{
+		logError("could not allocate memory");
+		exit(EXIT_FAILURE);
+	}
 
-		t[i].ncheck = PQntuples(res);
-		if (t[i].ncheck > 0)
-			t[i].check = (PQLConstraint *) malloc(t[i].ncheck * sizeof(PQLConstraint));
-		else
-			t[i].check = NULL;
+	for (i = 0; i < n; i++)
+		o[i] = t[i]->obj.oid;
 
-		logDebug("number of check constraints in %s \"%s\".\"%s\": %d",
-				 kind, t[i].obj.schemaname, t[i].obj.objectname, t[i].ncheck);
+	ret = buildOidArray(o, n);
 
-		for (j = 0; j < t[i].ncheck; j++)
-		{
-			char	*withoutescape;
+	free(o);
 
-			t[i].check[j].conname = strdup(PQgetvalue(res, j, PQfnumber(res, "conname")));
-			t[i].check[j].condef = strdup(PQgetvalue(res, j, PQfnumber(res, "condef")));
-			if (PQgetisnull(res, j, PQfnumber(res, "description")))
-				t[i].check[j].comment = NULL;
-			else
-			{
-				withoutescape = PQgetvalue(res, j, PQfnumber(res, "description"));
-				t[i].check[j].comment = PQescapeLiteral(c, withoutescape,
-														strlen(withoutescape));
-				if (t[i].check[j].comment == NULL)
-				{
-					logError("escaping comment failed: %s", PQerrorMessage(c));
-					PQclear(res);
-					PQfinish(c);
-					/* XXX leak another connection? */
-					exit(EXIT_FAILURE);
-				}
-			}
-		}
+	return ret;
+}
+
+/*
+ * Return the number of consecutive rows (starting at *row) whose column
+ * 'field' is oid 'o'. Rows are ordered by that column. *row is advanced to the
+ * first row that belongs to the next oid.
+ */
+static int
+countRowsByOid(PGresult *res, int field, int *row, Oid o)
+{
+	int		nrows = PQntuples(res);
+	int		first;
+
+	/* skip rows that do not belong to any table (cannot happen) */
+	while (*row < nrows &&
+			strtoul(PQgetvalue(res, *row, field), NULL, 10) < o)
+		(*row)++;
 
-		free(kind);
+	first = *row;
+	while (*row < nrows &&
+			strtoul(PQgetvalue(res, *row, field), NULL, 10) == o)
+		(*row)++;
 
+	return *row - first;
+}
+
+/*
+ * Fetch constraints of type 'contype' for all tables using a single query.
+ * Rows are ordered by table oid so they can be distributed to tables (see
+ * sortTablesByOid) in one pass.
+ */
+static PGresult *
+getConstraints(PGconn *c, PQLTable **t, int n, char contype)
+{
+	char		*query;
+	char		*oids;
+	PGresult	*res;
+
+	oids = buildTableOidArray(t, n);
+
+	/* FIXME conislocal (8.4)? */
+	query = psprintf("SELECT c.oid, conrelid, conname, pg_get_constraintdef(c.oid) AS condef, %s AS convalidated FROM pg_constraint c WHERE conrelid = ANY(%s) AND contype = '%c' ORDER BY conrelid, conname",
+					 (getServerVersion(c) >= 90100) ? "convalidated" : "true",
+					 oids, contype);
+
+	res = execQuery(c, query);
+
+	pfree(query);
+	free(oids);
+
+	if (PQresultStatus(res) != PGRES_TUPLES_OK)
+	{
+		logError("query failed: %s", PQresultErrorMessage(res));
 		PQclear(res);
+		PQfinish(c);
+		/* XXX leak another connection? */
+		exit(EXIT_FAILURE);
 	}
+
+	return res;
+}
+
+/*
+ * Assign constraint (row 'i') properties to 'con'.
+ */
+static void
+setConstraint(PGconn *c, PGresult *res, int i, PQLConstraint *con)
+{
+	con->conname = arenaStrdup(PQgetvalue(res, i, PQfnumber(res, "conname")));
+	con->condef = arenaStrdup(PQgetvalue(res, i, PQfnumber(res, "condef")));
+	con->convalidated = (PQgetvalue(res, i, PQfnumber(res, "convalidated"))[0] == 't');
+	con->comment = getComment(PGQ_CLASS_CONSTRAINT,
+							  strtoul(PQgetvalue(res, i, PQfnumber(res, "oid")), NULL, 10), 0);
 }
 
 void
-getFKConstraints(PGconn *c, PQLTable *t, int n)
+getCheckConstraints(PGconn *c, PQLTable *t, int n)
 {
-	char		*query;
+	PQLTable	**sorted;
 	PGresult	*res;
 	int			i, j;
+	int			row = 0;
+
+	if (n == 0)
+		return;
+
+	sorted = sortTablesByOid(t, n);
+
+	/* XXX contype = 'c' needed? */
+	res = getConstraints(c, sorted, n, 'c');
+
+	logDebug("number of check constraints in server: %d", PQntuples(res));
 
 	for (i = 0; i < n; i++)
 	{
-		query = psprintf("SELECT conname, pg_get_constraintdef(c.oid) AS condef, obj_description(c.oid, 'pg_constraint') AS description FROM pg_constraint c WHERE conrelid = %u AND contype = 'f' ORDER BY conname", t[i].obj.oid);
+		PQLTable	*tab = sorted[i];
+		int			first;
 
-		res = PQexec(c, query);
+		tab->ncheck = countRowsByOid(res, PQfnumber(res, "conrelid"), &row,
+									 tab->obj.oid);
+		first = row - tab->ncheck;
 
-		pfree(query);
+		if (tab->ncheck > 0)
+			tab->check = (PQLConstraint *) arenaAlloc(tab->ncheck * sizeof(PQLConstraint));
+		else
+			tab->check = NULL;
 
-		if (PQresultStatus(res) != PGRES_TUPLES_OK)
-		{
-			logError("query failed: %s", PQresultErrorMessage(res));
-			PQclear(res);
-			PQfinish(c);
-			/* XXX leak another connection? */
-			exit(EXIT_FAILURE);
-		}
+		logDebug("number of check constraints in %s \"%s\".\"%s\": %d",
+				 PGQ_IS_FOREIGN_TABLE(tab->kind) ? "foreign table" : "table",
+				 tab->obj.schemaname, tab->obj.objectname, tab->ncheck);
+
+		for (j = 0; j < tab->ncheck; j++)
+			setConstraint(c, res, first + j, &tab->check[j]);
+	}
+
+	PQclear(res);
+	free(sorted);
+}
+
+void
+getFKConstraints(PGconn *c, PQLTable *t, int n)
+{
+	PQLTable	**sorted;
+	PGresult	*res;
+	int			i, j;
+	int			row = 0;
+
+	if (n == 0)
+		return;
+
+	sorted = sortTablesByOid(t, n);
+
+	res = getConstraints(c, sorted, n, 'f');
+
+	logDebug("number of FK constraints in server: %d", PQntuples(res));
+
+	for (i = 0; i < n; i++)
+	{
+		PQLTable	*tab = sorted[i];
+		int			first;
+
+		tab->nfk = countRowsByOid(res, PQfnumber(res, "conrelid"), &row,
+								  tab->obj.oid);
+		first = row - tab->nfk;
 
-		t[i].nfk = PQntuples(res);
-		if (t[i].nfk > 0)
-			t[i].fk = (PQLConstraint *) malloc(t[i].nfk * sizeof(PQLConstraint));
+		if (tab->nfk > 0)
+			tab->fk = (PQLConstraint *) arenaAlloc(tab->nfk * sizeof(PQLConstraint));
 		else
-			t[i].fk = NULL;
+			tab->fk = NULL;
 
 		logDebug("number of FK constraints in table \"%s\".\"%s\": %d",
-				 t[i].obj.schemaname, t[i].obj.objectname, t[i].nfk);
-		for (j = 0; j < t[i].nfk; j++)
-		{
-			char	*withoutescape;
-
-			t[i].fk[j].conname = strdup(PQgetvalue(res, j, PQfnumber(res, "conname")));
-			t[i].fk[j].condef = strdup(PQgetvalue(res, j, PQfnumber(res, "condef")));
-			if (PQgetisnull(res, j, PQfnumber(res, "description")))
-				t[i].fk[j].comment = NULL;
-			else
-			{
-				withoutescape = PQgetvalue(res, j, PQfnumber(res, "description"));
-				t[i].fk[j].comment = PQescapeLiteral(c, withoutescape, strlen(withoutescape));
-				if (t[i].fk[j].comment == NULL)
-				{
-					logError("escaping comment failed: %s", PQerrorMessage(c));
-					PQclear(res);
-					PQfinish(c);
-					/* XXX leak another connection? */
-					exit(EXIT_FAILURE);
-				}
-			}
-		}
+				 tab->obj.schemaname, tab->obj.objectname, tab->nfk);
 
-		PQclear(res);
+		for (j = 0; j < tab->nfk; j++)
+			setConstraint(c, res, first + j, &tab->fk[j]);
 	}
+
+	PQclear(res);
+	free(sorted);
 }
 
 void
 getPKConstraints(PGconn *c, PQLTable *t, int n)
 {
-	char		*query;
+	PQLTable	**sorted;
 	PGresult	*res;
 	int			i;
+	int			row = 0;
 
-	for (i = 0; i < n; i++)
-	{
-		/* XXX only 9.0+ */
-		query = psprintf("SELECT conname, pg_get_constraintdef(c.oid) AS condef, obj_description(c.oid, 'pg_constraint') AS description FROM pg_constraint c WHERE conrelid = %u AND contype = 'p' ORDER BY conname", t[i].obj.oid);
+	if (n == 0)
+		return;
 
-		res = PQexec(c, query);
+	sorted = sortTablesByOid(t, n);
 
-		pfree(query);
+	/* XXX only 9.0+ */
+	res = getConstraints(c, sorted, n, 'p');
 
-		if (PQresultStatus(res) != PGRES_TUPLES_OK)
-		{
-			logError("query failed: %s", PQresultErrorMessage(res));
-			PQclear(res);
-			PQfinish(c);
-			/* XXX leak another connection? */
-			exit(EXIT_FAILURE);
-		}
+	logDebug("number of primary keys in server: %d", PQntuples(res));
 
-		if (PQntuples(res) == 1)
-		{
-			char	*withoutescape;
+	for (i = 0; i < n; i++)
+	{
+		PQLTable	*tab = sorted[i];
+		int			npk;
 
-			t[i].pk.conname = strdup(PQgetvalue(res, 0, PQfnumber(res, "conname")));
-			t[i].pk.condef = strdup(PQgetvalue(res, 0, PQfnumber(res, "condef")));
-			if (PQgetisnull(res, 0, PQfnumber(res, "description")))
-				t[i].pk.comment = NULL;
-			else
-			{
-				withoutescape = PQgetvalue(res, 0, PQfnumber(res, "description"));
-				t[i].pk.comment = PQescapeLiteral(c, withoutescape, strlen(withoutescape));
-				if (t[i].pk.comment == NULL)
-				{
-					logError("escaping comment failed: %s", PQerrorMessage(c));
-					PQclear(res);
-					PQfinish(c);
-					/* XXX leak another connection? */
-					exit(EXIT_FAILURE);
-				}
-			}
-		}
+		npk = countRowsByOid(res, PQfnumber(res, "conrelid"), &row, tab->obj.oid);
+
+		if (npk == 1)
+			setConstraint(c, res, row - 1, &tab->pk);
 		/* XXX cannot happen */
-		else if (PQntuples(res) > 1)
+		else if (npk > 1)
 			logWarning("could not have more than one primary key");
-
-		PQclear(res);
 	}
+
+	PQclear(res);
+	free(sorted);
 }
 
+/*
+ * Load attributes from a list of tables. Attributes are not loaded by
+ * getTables because dropped tables do not need them. Hence, callers collect
+ * the tables that will be created or altered and attributes for all of them
+ * are loaded using a single query.
+ */
 void
-getTableAttributes(PGconn *c, PQLTable *t)
+getTableAttributes(PGconn *c, PQLTable **t, int n)
 {
+	PQLTable	**sorted;
 	char		*query;
+	char		*oids;
 	PGresult	*res;
-	int			i;
-	char		*kind = NULL;
+	int			i, j;
+	int			row = 0;
+	int			nreplident = 0;
 
-	if (PGQ_IS_REGULAR_OR_PARTITIONED_TABLE(t->kind))
-		kind = strdup("table");
-	else if (PGQ_IS_FOREIGN_TABLE(t->kind))
-		kind = strdup("foreign table");
-	else
-	{
-		logError("kind is not a regular, partitioned or foreign table");
-		exit(EXIT_FAILURE);
-	}
+	if (n == 0)
+		return;
 
-	if (PQserverVersion(c) >=
+	sorted = sortTablePointersByOid(t, n);
+	oids = buildTableOidArray(sorted, n);
+
+	if (getServerVersion(c) >=
 			90200)	/* support for foreign table attribute options */
 	{
 		query = psprintf(
-						  "SELECT a.attnum, a.attname, a.attnotnull, pg_catalog.format_type(t.oid, a.atttypmod) as atttypname, pg_get_expr(d.adbin, a.attrelid) as attdefexpr, CASE WHEN a.attcollation <> t.typcollation THEN c.collname ELSE NULL END AS attcollation, col_description(a.attrelid, a.attnum) AS description, a.attstattarget, a.attstorage, CASE WHEN t.typstorage <> a.attstorage THEN FALSE ELSE TRUE END AS defstorage, array_to_string(attoptions, ', ') AS attoptions, array_to_string(attfdwoptions, ', ') AS attfdwoptions, attacl FROM pg_attribute a LEFT JOIN pg_type t ON (a.atttypid = t.oid) LEFT JOIN pg_attrdef d ON (a.attrelid = d.adrelid AND a.attnum = d.adnum) LEFT JOIN pg_collation c ON (a.attcollation = c.oid) WHERE a.attrelid = %u AND a.attnum > 0 AND attisdropped IS FALSE ORDER BY a.attname",
-						  t->obj.oid);
+						  "SELECT a.attrelid, a.attnum, a.attname, a.attnotnull, pg_catalog.format_type(t.oid, a.atttypmod) as atttypname, pg_get_expr(d.adbin, a.attrelid) as attdefexpr, CASE WHEN a.attcollation <> t.typcollation THEN c.collname ELSE NULL END AS attcollation, a.attstattarget, a.attstorage, CASE WHEN t.typstorage <> a.attstorage THEN FALSE ELSE TRUE END AS defstorage, array_to_string(attoptions, ', ') AS attoptions, array_to_string(attfdwoptions, ', ') AS attfdwoptions, EXISTS(SELECT 1 FROM regexp_matches(d.adbin::text, ':(funcid|opno) ([0-9]+)', 'g') AS m LEFT JOIN pg_operator o ON (m[1] = 'opno' AND o.oid = m[2]::oid) JOIN pg_proc p ON (p.oid = CASE WHEN m[1] = 'opno' THEN o.oprcode::oid ELSE m[2]::oid END) WHERE p.provolatile = 'v') AS attdefvolatile, attacl FROM pg_attribute a LEFT JOIN pg_type t ON (a.atttypid = t.oid) LEFT JOIN pg_attrdef d ON (a.attrelid = d.adrelid AND a.attnum = d.adnum) LEFT JOIN pg_collation c ON (a.attcollation = c.oid) WHERE a.attrelid = ANY(%s) AND a.attnum > 0 AND attisdropped IS FALSE ORDER BY a.attrelid, a.attname",
+						  oids);
 	}
-	else if (PQserverVersion(c) >= 90100)	/* support for collation */
+	else if (getServerVersion(c) >= 90100)	/* support for collation */
 	{
 		query = psprintf(
-						  "SELECT a.attnum, a.attname, a.attnotnull, pg_catalog.format_type(t.oid, a.atttypmod) as atttypname, pg_get_expr(d.adbin, a.attrelid) as attdefexpr, CASE WHEN a.attcollation <> t.typcollation THEN c.collname ELSE NULL END AS attcollation, col_description(a.attrelid, a.attnum) AS description, a.attstattarget, a.attstorage, CASE WHEN t.typstorage <> a.attstorage THEN FALSE ELSE TRUE END AS defstorage, array_to_string(attoptions, ', ') AS attoptions, NULL AS attfdwoptions, attacl FROM pg_attribute a LEFT JOIN pg_type t ON (a.atttypid = t.oid) LEFT JOIN pg_attrdef d ON (a.attrelid = d.adrelid AND a.attnum = d.adnum) LEFT JOIN pg_collation c ON (a.attcollation = c.oid) WHERE a.attrelid = %u AND a.attnum > 0 AND attisdropped IS FALSE ORDER BY a.attname",
-						  t->obj.oid);
+						  "SELECT a.attrelid, a.attnum, a.attname, a.attnotnull, pg_catalog.format_type(t.oid, a.atttypmod) as atttypname, pg_get_expr(d.adbin, a.attrelid) as attdefexpr, CASE WHEN a.attcollation <> t.typcollation THEN c.collname ELSE NULL END AS attcollation, a.attstattarget, a.attstorage, CASE WHEN t.typstorage <> a.attstorage THEN FALSE ELSE TRUE END AS defstorage, array_to_string(attoptions, ', ') AS attoptions, NULL AS attfdwoptions, EXISTS(SELECT 1 FROM regexp_matches(d.adbin::text, ':(funcid|opno) ([0-9]+)', 'g') AS m LEFT JOIN pg_operator o ON (m[1] = 'opno' AND o.oid = m[2]::oid) JOIN pg_proc p ON (p.oid = CASE WHEN m[1] = 'opno' THEN o.oprcode::oid ELSE m[2]::oid END) WHERE p.provolatile = 'v') AS attdefvolatile, attacl FROM pg_attribute a LEFT JOIN pg_type t ON (a.atttypid = t.oid) LEFT JOIN pg_attrdef d ON (a.attrelid = d.adrelid AND a.attnum = d.adnum) LEFT JOIN pg_collation c ON (a.attcollation = c.oid) WHERE a.attrelid = ANY(%s) AND a.attnum > 0 AND attisdropped IS FALSE ORDER BY a.attrelid, a.attname",
+						  oids);
 	}
 	else
 	{
 		query = psprintf(
-						  "SELECT a.attnum, a.attname, a.attnotnull, pg_catalog.format_type(t.oid, a.atttypmod) as atttypname, pg_get_expr(d.adbin, a.attrelid) as attdefexpr, NULL AS attcollation, col_description(a.attrelid, a.attnum) AS description, a.attstattarget, a.attstorage, CASE WHEN t.typstorage <> a.attstorage THEN FALSE ELSE TRUE END AS defstorage, array_to_string(attoptions, ', ') AS attoptions, NULL AS attfdwoptions, attacl FROM pg_attribute a LEFT JOIN pg_type t ON (a.atttypid = t.oid) LEFT JOIN pg_attrdef d ON (a.attrelid = d.adrelid AND a.attnum = d.adnum) WHERE a.attrelid = %u AND a.attnum > 0 AND attisdropped IS FALSE ORDER BY a.attname",
-						  t->obj.oid);
+						  "SELECT a.attrelid, a.attnum, a.attname, a.attnotnull, pg_catalog.format_type(t.oid, a.atttypmod) as atttypname, pg_get_expr(d.adbin, a.attrelid) as attdefexpr, NULL AS attcollation, a.attstattarget, a.attstorage, CASE WHEN t.typstorage <> a.attstorage THEN FALSE ELSE TRUE END AS defstorage, array_to_string(attoptions, ', ') AS attoptions, NULL AS attfdwoptions, EXISTS(SELECT 1 FROM regexp_matches(d.adbin::text, ':(funcid|opno) ([0-9]+)', 'g') AS m LEFT JOIN pg_operator o ON (m[1] = 'opno' AND o.oid = m[2]::oid) JOIN pg_proc p ON (p.oid = CASE WHEN m[1] = 'opno' THEN o.oprcode::oid ELSE m[2]::oid END) WHERE p.provolatile = 'v') AS attdefvolatile, attacl FROM pg_attribute a LEFT JOIN pg_type t ON (a.atttypid = t.oid) LEFT JOIN pg_attrdef d ON (a.attrelid = d.adrelid AND a.attnum = d.adnum) WHERE a.attrelid = ANY(%s) AND a.attnum > 0 AND attisdropped IS FALSE ORDER BY a.attrelid, a.attname",
+						  oids);
 	}
 
-	res = PQexec(c, query);
+	res = execQuery(c, query);
 
 	pfree(query);
+	free(oids);
 
 	if (PQresultStatus(res) != PGRES_TUPLES_OK)
 	{
@@ -668,154 +791,152 @@ getTableAttributes(PGconn *c, PQLTable *t)
 		exit(EXIT_FAILURE);
 	}
 
-	t->nattributes = PQntuples(res);
-	if (t->nattributes > 0)
-		t->attributes = (PQLAttribute *) malloc(t->nattributes * sizeof(PQLAttribute));
-	else
-		t->attributes = NULL;
-
-	if (PGQ_IS_REGULAR_OR_PARTITIONED_TABLE(t->kind))
-	{
-		logDebug("number of attributes in table \"%s\".\"%s\": %d", t->obj.schemaname,
-				 t->obj.objectname, t->nattributes);
-
-		/* reloptions is only available for regular tables */
-		if (t->reloptions)
-			logDebug("table \"%s\".\"%s\": reloptions: %s", t->obj.schemaname,
-					 t->obj.objectname, t->reloptions);
-		else
-			logDebug("table \"%s\".\"%s\": no reloptions", t->obj.schemaname,
-					 t->obj.objectname);
-	}
-	else if (PGQ_IS_FOREIGN_TABLE(t->kind))
-	{
-		logDebug("number of attributes in foreign table \"%s\".\"%s\": %d",
-				 t->obj.schemaname,
-				 t->obj.objectname, t->nattributes);
-	}
+	logDebug("number of attributes in server: %d", PQntuples(res));
 
-	for (i = 0; i < t->nattributes; i++)
+	for (i = 0; i < n; i++)
 	{
-		char	storage;
-		char	*withoutescape;
-
-		t->attributes[i].attnum = strtoul(PQgetvalue(res, i, PQfnumber(res, "attnum")),
-										  NULL, 10);
-		t->attributes[i].attname = strdup(PQgetvalue(res, i, PQfnumber(res,
-										  "attname")));
-		t->attributes[i].attnotnull = (PQgetvalue(res, i, PQfnumber(res,
-									   "attnotnull"))[0] == 't');
-		t->attributes[i].atttypname = strdup(PQgetvalue(res, i, PQfnumber(res,
-											 "atttypname")));
-		/* default expression */
-		if (PQgetisnull(res, i, PQfnumber(res, "attdefexpr")))
-			t->attributes[i].attdefexpr = NULL;
-		else
-			t->attributes[i].attdefexpr = strdup(PQgetvalue(res, i, PQfnumber(res,
-												 "attdefexpr")));
-		/* statistics target */
-		t->attributes[i].attstattarget = atoi(PQgetvalue(res, i, PQfnumber(res,
-											  "attstattarget")));
-
-		/* storage */
-		storage = PQgetvalue(res, i, PQfnumber(res, "attstorage"))[0];
-		switch (storage)
-		{
-			case 'p':
-				t->attributes[i].attstorage = strdup("PLAIN");
-				break;
-			case 'e':
-				t->attributes[i].attstorage = strdup("EXTERNAL");
-				break;
-			case 'm':
-				t->attributes[i].attstorage = strdup("MAIN");
-				break;
-			case 'x':
-				t->attributes[i].attstorage = strdup("EXTENDED");
-				break;
-			default:
-				t->attributes[i].attstorage = NULL;
-				break;
-		}
-		t->attributes[i].defstorage = (PQgetvalue(res, i, PQfnumber(res,
-									   "defstorage"))[0] == 't');
+		PQLTable	*tab = sorted[i];
+		int			first;
 
-		/* collation */
-		if (PQgetisnull(res, i, PQfnumber(res, "attcollation")))
-			t->attributes[i].attcollation = NULL;
-		else
-			t->attributes[i].attcollation = strdup(PQgetvalue(res, i, PQfnumber(res,
-												   "attcollation")));
+		tab->nattributes = countRowsByOid(res, PQfnumber(res, "attrelid"), &row,
+										  tab->obj.oid);
+		first = row - tab->nattributes;
 
-		/* attribute options */
-		if (PQgetisnull(res, i, PQfnumber(res, "attoptions")))
-			t->attributes[i].attoptions = NULL;
+		if (tab->nattributes > 0)
+			tab->attributes = (PQLAttribute *) arenaAlloc(tab->nattributes * sizeof(
+								  PQLAttribute));
 		else
-			t->attributes[i].attoptions = strdup(PQgetvalue(res, i, PQfnumber(res,
-												 "attoptions")));
+			tab->attributes = NULL;
 
-		/* attribute FDW options */
-		if (PQgetisnull(res, i, PQfnumber(res, "attfdwoptions")))
-			t->attributes[i].attfdwoptions = NULL;
-		else
-			t->attributes[i].attfdwoptions = strdup(PQgetvalue(res, i, PQfnumber(res,
-													"attfdwoptions")));
+		if (PGQ_IS_REGULAR_OR_PARTITIONED_TABLE(tab->kind))
+		{
+			logDebug("number of attributes in table \"%s\".\"%s\": %d",
+					 tab->obj.schemaname, tab->obj.objectname, tab->nattributes);
 
-		/* attribute ACL */
-		if (PQgetisnull(res, i, PQfnumber(res, "attacl")))
-			t->attributes[i].acl = NULL;
-		else
-			t->attributes[i].acl = strdup(PQgetvalue(res, i, PQfnumber(res,
-										  "attacl")));
+			/* reloptions is only available for regular tables */
+			if (tab->reloptions)
+				logDebug("table \"%s\".\"%s\": reloptions: %s", tab->obj.schemaname,
+						 tab->obj.objectname, tab->reloptions);
+			else
+				logDebug("table \"%s\".\"%s\": no reloptions", tab->obj.schemaname,
+						 tab->obj.objectname);
+		}
+		else if (PGQ_IS_FOREIGN_TABLE(tab->kind))
+		{
+			logDebug("number of attributes in foreign table \"%s\".\"%s\": %d",
+					 tab->obj.schemaname,
+					 tab->obj.objectname, tab->nattributes);
+		}
 
-		/* comment */
-		if (PQgetisnull(res, i, PQfnumber(res, "description")))
-			t->attributes[i].comment = NULL;
-		else
+		for (j = 0; j < tab->nattributes; j++)
 		{
-			withoutescape = PQgetvalue(res, i, PQfnumber(res, "description"));
-			t->attributes[i].comment = PQescapeLiteral(c, withoutescape,
-									   strlen(withoutescape));
-			if (t->attributes[i].comment == NULL)
+			PQLAttribute	*a = &tab->attributes[j];
+			int				r = first + j;
+			char			storage;
+
+			a->attnum = strtoul(PQgetvalue(res, r, PQfnumber(res, "attnum")), NULL, 10);
+			a->attname = arenaStrdup(PQgetvalue(res, r, PQfnumber(res, "attname")));
+			a->attnotnull = (PQgetvalue(res, r, PQfnumber(res, "attnotnull"))[0] == 't');
+			a->atttypname = arenaStrdup(PQgetvalue(res, r, PQfnumber(res, "atttypname")));
+			/* default expression */
+			if (PQgetisnull(res, r, PQfnumber(res, "attdefexpr")))
+				a->attdefexpr = NULL;
+			else
+				a->attdefexpr = arenaStrdup(PQgetvalue(res, r, PQfnumber(res, "attdefexpr")));
+			a->attdefvolatile = (PQgetvalue(res, r, PQfnumber(res,
+									 "attdefvolatile"))[0] == 't');
+			/* statistics target */
+			a->attstattarget = atoi(PQgetvalue(res, r, PQfnumber(res, "attstattarget")));
+
+			/* storage */
+			storage = PQgetvalue(res, r, PQfnumber(res, "attstorage"))[0];
+			switch (storage)
 			{
-				logError("escaping comment failed: %s", PQerrorMessage(c));
-				PQclear(res);
-				PQfinish(c);
-				/* XXX leak another connection? */
-				exit(EXIT_FAILURE);
+				case 'p':
+					a->attstorage = arenaStrdup("PLAIN");
+					break;
+				case 'e':
+					a->attstorage = arenaStrdup("EXTERNAL");
+					break;
+				case 'm':
+					a->attstorage = arenaStrdup("MAIN");
+					break;
+				case 'x':
+					a->attstorage = arenaStrdup("EXTENDED");
+					break;
+				default:
+					a->attstorage = NULL;
+					break;
 			}
-		}
+			a->defstorage = (PQgetvalue(res, r, PQfnumber(res, "defstorage"))[0] == 't');
 
-		/*
-		 * Security labels are not assigned here (see getTableSecurityLabels),
-		 * but default values are essential to avoid having trouble in
-		 * freeTables.
-		 */
-		t->attributes[i].nseclabels = 0;
-		t->attributes[i].seclabels = NULL;
+			/* collation */
+			if (PQgetisnull(res, r, PQfnumber(res, "attcollation")))
+				a->attcollation = NULL;
+			else
+				a->attcollation = arenaStrdup(PQgetvalue(res, r, PQfnumber(res, "attcollation")));
 
-		if (t->attributes[i].attdefexpr != NULL)
-			logDebug("table: \"%s\".\"%s\" ; attribute \"%s\"; type: %s ; default: %s ; storage: %s",
-					 t->obj.schemaname, t->obj.objectname, t->attributes[i].attname,
-					 t->attributes[i].atttypname, t->attributes[i].attdefexpr,
-					 t->attributes[i].attstorage);
-		else
-			logDebug("table: \"%s\".\"%s\" ; attribute \"%s\"; type: %s ; storage: %s",
-					 t->obj.schemaname, t->obj.objectname, t->attributes[i].attname,
-					 t->attributes[i].atttypname,
-					 t->attributes[i].attstorage);
+			/* attribute options */
+			if (PQgetisnull(res, r, PQfnumber(res, "attoptions")))
+				a->attoptions = NULL;
+			else
+				a->attoptions = arenaStrdup(PQgetvalue(res, r, PQfnumber(res, "attoptions")));
+
+			/* attribute FDW options */
+			if (PQgetisnull(res, r, PQfnumber(res, "attfdwoptions")))
+				a->attfdwoptions = NULL;
+			else
+				a->attfdwoptions = arenaStrdup(PQgetvalue(res, r, PQfnumber(res,
+												  "attfdwoptions")));
+
+			/* attribute ACL */
+			if (PQgetisnull(res, r, PQfnumber(res, "attacl")))
+				a->acl = NULL;
+			else
+				a->acl = arenaStrdup(PQgetvalue(res, r, PQfnumber(res, "attacl")));
+
+			/* comment */
+			a->comment = getComment(PGQ_CLASS_CLASS, tab->obj.oid, a->attnum);
+
+			/*
+			 * Security labels are not assigned here (see
+			 * getTableSecurityLabels), but default values are essential to
+			 * avoid having trouble in the dump routines.
+			 */
+			a->nseclabels = 0;
+			a->seclabels = NULL;
+
+			if (a->attdefexpr != NULL)
+				logDebug("table: \"%s\".\"%s\" ; attribute \"%s\"; type: %s ; default: %s ; storage: %s",
+						 tab->obj.schemaname, tab->obj.objectname, a->attname,
+						 a->atttypname, a->attdefexpr, a->attstorage);
+			else
+				logDebug("table: \"%s\".\"%s\" ; attribute \"%s\"; type: %s ; storage: %s",
+						 tab->obj.schemaname, tab->obj.objectname, a->attname,
+						 a->atttypname, a->attstorage);
+		}
+
+		/* tables whose replica identity is an index; see below */
+		if (tab->relreplident == 'i')
+			sorted[nreplident++] = tab;
 	}
 
 	PQclear(res);
 
-	/* replica identity using index */
-	if (t->relreplident == 'i')
+	/*
+	 * Replica identity using index. Tables were moved to the beginning of
+	 * 'sorted' and they are still ordered by oid.
+	 */
+	if (nreplident > 0)
 	{
-		query = psprintf("SELECT c.relname AS idxname FROM pg_index i INNER JOIN pg_class c ON (i.indexrelid = c.oid) WHERE indrelid = %u AND indisreplident", t->obj.oid);
+		oids = buildTableOidArray(sorted, nreplident);
+
+		query = psprintf("SELECT i.indrelid, c.relname AS idxname FROM pg_index i INNER JOIN pg_class c ON (i.indexrelid = c.oid) WHERE indrelid = ANY(%s) AND indisreplident ORDER BY indrelid", oids);
 
-		res = PQexec(c, query);
+		res = execQuery(c, query);
 
 		pfree(query);
+		free(oids);
 
 		if (PQresultStatus(res) != PGRES_TUPLES_OK)
 		{
@@ -826,54 +947,66 @@ getTableAttributes(PGconn *c, PQLTable *t)
 			exit(EXIT_FAILURE);
 		}
 
-		i  = PQntuples(res);
-		if (i == 1)
+		row = 0;
+		for (i = 0; i < nreplident; i++)
 		{
-			t->relreplidentidx = strdup(PQgetvalue(res, 0, PQfnumber(res,
-												   "idxname")));
+			PQLTable	*tab = sorted[i];
+
+			j = countRowsByOid(res, PQfnumber(res, "indrelid"), &row, tab->obj.oid);
+			if (j == 1)
+			{
+				tab->relreplidentidx = arenaStrdup(PQgetvalue(res, row - 1, PQfnumber(res,
+											  "idxname")));
+			}
+			else
+				logWarning("table \"%s\".\"%s\" should contain one replica identity index (returned %d)",
+						   tab->obj.schemaname, tab->obj.objectname, j);
 		}
-		else
-			logWarning("table \"%s\".\"%s\" should contain one replica identity index (returned %d)",
-					   t->obj.schemaname, t->obj.objectname, i);
 
 		PQclear(res);
 	}
 
-	if (kind)
-		free(kind);
+	free(sorted);
 }
 
+/*
+ * Load the size (in bytes, including TOAST) of a list of tables using a
+ * single query. It is estimated from relpages (as of the last VACUUM or
+ * ANALYZE) because pg_relation_size would wait for locks on busy tables.
+ * Sizes are not covered by the catalog cache so they are always read from the
+ * server. A catalog file without a server does not know the current sizes;
+ * they are unknown.
+ */
 void
-getTableSecurityLabels(PGconn *c, PQLTable *t)
+getTableSizes(PGconn *c, PQLTable **t, int n)
 {
+	PQLTable	**sorted;
 	char		*query;
+	char		*oids;
 	PGresult	*res;
 	int			i;
-	char		*kind = NULL;
+	int			row = 0;
 
-	if (PGQ_IS_REGULAR_OR_PARTITIONED_TABLE(t->kind))
-		kind = strdup("table");
-	else if (PGQ_IS_FOREIGN_TABLE(t->kind))
-		kind = strdup("foreign table");
-	else
-	{
-		logError("kind is not a regular, partitioned or foreign table");
-		exit(EXIT_FAILURE);
-	}
+	if (n == 0)
+		return;
 
-	if (PQserverVersion(c) < 90100)
+	if (isCatalogFile(c) && !isCatalogCache(c))
 	{
-		logWarning("ignoring security labels because server does not support it");
-		if (kind)
-			free(kind);
+		if (options.costthreshold > 0)
+			logWarning("ignoring cost-threshold because table sizes are unknown in a catalog file");
 		return;
 	}
 
-	query = psprintf("SELECT provider, label FROM pg_seclabel s INNER JOIN pg_class c ON (s.classoid = c.oid) WHERE c.relname = 'pg_class' AND s.objoid = %u ORDER BY provider", t->obj.oid);
+	sorted = sortTablePointersByOid(t, n);
+	oids = buildTableOidArray(sorted, n);
 
-	res = PQexec(c, query);
+	query = psprintf("SELECT c.oid, (c.relpages::bigint + coalesce(t.relpages, 0)) * current_setting('block_size')::bigint AS relsize FROM pg_class c LEFT JOIN pg_class t ON (c.reltoastrelid = t.oid) WHERE c.oid = ANY(%s) ORDER BY c.oid",
+					 oids);
+
+	res = execServerQuery(c, query);
 
 	pfree(query);
+	free(oids);
 
 	if (PQresultStatus(res) != PGRES_TUPLES_OK)
 	{
@@ -884,286 +1017,126 @@ getTableSecurityLabels(PGconn *c, PQLTable *t)
 		exit(EXIT_FAILURE);
 	}
 
-	t->nseclabels = PQntuples(res);
-	if (t->nseclabels > 0)
-		t->seclabels = (PQLSecLabel *) malloc(t->nseclabels * sizeof(PQLSecLabel));
-	else
-		t->seclabels = NULL;
-
-	logDebug("number of security labels in %s \"%s\".\"%s\": %d",
-			 kind, t->obj.schemaname, t->obj.objectname, t->nseclabels);
-
-	for (i = 0; i < t->nseclabels; i++)
-	{
-		char	*withoutescape;
-
-		t->seclabels[i].provider = strdup(PQgetvalue(res, i, PQfnumber(res,
-										  "provider")));
-		withoutescape = PQgetvalue(res, i, PQfnumber(res, "label"));
-		t->seclabels[i].label = PQescapeLiteral(c, withoutescape,
-												strlen(withoutescape));
-		if (t->seclabels[i].label == NULL)
-		{
-			logError("escaping label failed: %s", PQerrorMessage(c));
-			PQclear(res);
-			PQfinish(c);
-			/* XXX leak another connection? */
-			exit(EXIT_FAILURE);
-		}
-	}
-
-	PQclear(res);
-
-	/* attributes */
-	for (i = 0; i < t->nattributes; i++)
+	for (i = 0; i < n; i++)
 	{
-		int		j;
-
-		query = psprintf("SELECT provider, label FROM pg_seclabel s INNER JOIN pg_class c ON (s.classoid = c.oid) WHERE c.relname = 'pg_attribute' AND s.objoid = %u AND s.objsubid = %u ORDER BY provider", t->obj.oid, t->attributes[i].attnum);
-
-		res = PQexec(c, query);
-
-		pfree(query);
-
-		if (PQresultStatus(res) != PGRES_TUPLES_OK)
-		{
-			logError("query failed: %s", PQresultErrorMessage(res));
-			PQclear(res);
-			PQfinish(c);
-			/* XXX leak another connection? */
-			exit(EXIT_FAILURE);
-		}
-
-		t->attributes[i].nseclabels = PQntuples(res);
-		if (t->attributes[i].nseclabels > 0)
-			t->attributes[i].seclabels = (PQLSecLabel *) malloc(t->attributes[i].nseclabels
-										 * sizeof(PQLSecLabel));
-		else
-			t->attributes[i].seclabels = NULL;
-
-		logDebug("number of security labels in %s \"%s\".\"%s\" attribute \"%s\": %d",
-				 kind, t->obj.schemaname, t->obj.objectname,
-				 t->attributes[i].attname, t->attributes[i].nseclabels);
+		PQLTable	*tab = sorted[i];
 
-		for (j = 0; j < t->attributes[i].nseclabels; j++)
+		if (countRowsByOid(res, PQfnumber(res, "oid"), &row, tab->obj.oid) == 1)
 		{
-			char	*withoutescape;
+			tab->relsize = strtoll(PQgetvalue(res, row - 1, PQfnumber(res, "relsize")),
+								   NULL, 10);
 
-			t->attributes[i].seclabels[j].provider = strdup(PQgetvalue(res, j,
-					PQfnumber(res, "provider")));
-			withoutescape = PQgetvalue(res, j, PQfnumber(res, "label"));
-			t->attributes[i].seclabels[j].label = PQescapeLiteral(c, withoutescape,
-												  strlen(withoutescape));
-			if (t->attributes[i].seclabels[j].label == NULL)
-			{
-				logError("escaping label failed: %s", PQerrorMessage(c));
-				PQclear(res);
-				PQfinish(c);
-				/* XXX leak another connection? */
-				exit(EXIT_FAILURE);
-			}
+			logDebug("table \"%s\".\"%s\": about " INT64_FORMAT " bytes",
+					 tab->obj.schemaname, tab->obj.objectname, tab->relsize);
 		}
-
-		PQclear(res);
 	}
 
-	free(kind);
+	PQclear(res);
+	free(sorted);
 }
 
+/*
+ * Assign security labels to a list of tables and their attributes (see
+ * getTableAttributes).
+ */
 void
-freeTables(PQLTable *t, int n)
+getTableSecurityLabels(PGconn *c, PQLTable **t, int n)
 {
-	if (n > 0)
-	{
-		int	i;
-
-		for (i = 0; i < n; i++)
-		{
-			int	j;
-
-			free(t[i].obj.schemaname);
-			free(t[i].obj.objectname);
-			free(t[i].owner);
-			if (t[i].tbspcname)
-				free(t[i].tbspcname);
-			if (t[i].reloptions)
-				free(t[i].reloptions);
-			if (t[i].relreplidentidx)
-				free(t[i].relreplidentidx);
-			if (t[i].reloftype.schemaname)
-				free(t[i].reloftype.schemaname);
-			if (t[i].reloftype.objectname)
-				free(t[i].reloftype.objectname);
-			if (t[i].partitionkey)
-				free(t[i].partitionkey);
-			if (t[i].partitionbound)
-				free(t[i].partitionbound);
-			if (t[i].servername)
-				free(t[i].servername);
-			if (t[i].ftoptions)
-				free(t[i].ftoptions);
-			if (t[i].comment)
-				PQfreemem(t[i].comment);
-			if (t[i].acl)
-				free(t[i].acl);
-
-			/* security labels */
-			for (j = 0; j < t[i].nseclabels; j++)
-			{
-				free(t[i].seclabels[j].provider);
-				PQfreemem(t[i].seclabels[j].label);
-			}
-
-			if (t[i].seclabels)
-				free(t[i].seclabels);
-
-			/* attributes */
-			for (j = 0; j < t[i].nattributes; j++)
-			{
-				int	k;
-
-				free(t[i].attributes[j].attname);
-				free(t[i].attributes[j].atttypname);
-				if (t[i].attributes[j].attdefexpr)
-					free(t[i].attributes[j].attdefexpr);
-				if (t[i].attributes[j].attcollation)
-					free(t[i].attributes[j].attcollation);
-				if (t[i].attributes[j].attstorage)
-					free(t[i].attributes[j].attstorage);
-				if (t[i].attributes[j].attoptions)
-					free(t[i].attributes[j].attoptions);
-				if (t[i].attributes[j].acl)
-					free(t[i].attributes[j].acl);
-				if (t[i].attributes[j].comment)
-					PQfreemem(t[i].attributes[j].comment);
-
-				/* security labels */
-				for (k = 0; k < t[i].attributes[j].nseclabels; k++)
-				{
-					free(t[i].attributes[j].seclabels[k].provider);
-					PQfreemem(t[i].attributes[j].seclabels[k].label);
-				}
+	int		i, j;
 
-				if (t[i].attributes[j].seclabels)
-					free(t[i].attributes[j].seclabels);
-			}
+	if (getServerVersion(c) < 90100)
+	{
+		logWarning("ignoring security labels because server does not support it");
+		return;
+	}
 
-			/* parent tables */
-			for (j = 0; j < t[i].nparent; j++)
-			{
-				free(t[i].parent[j].schemaname);
-				free(t[i].parent[j].objectname);
-			}
+	for (i = 0; i < n; i++)
+	{
+		PQLTable	*tab = t[i];
 
-			/* check constraints */
-			for (j = 0; j < t[i].ncheck; j++)
-			{
-				free(t[i].check[j].conname);
-				free(t[i].check[j].condef);
-				if (t[i].check[j].comment)
-					PQfreemem(t[i].check[j].comment);
-			}
+		tab->nseclabels = getObjectSecurityLabels(c, PGQ_CLASS_CLASS, tab->obj.oid,
+												  0, &tab->seclabels);
 
-			/* foreign keys */
-			for (j = 0; j < t[i].nfk; j++)
-			{
-				free(t[i].fk[j].conname);
-				free(t[i].fk[j].condef);
-				if (t[i].fk[j].comment)
-					PQfreemem(t[i].fk[j].comment);
-			}
+		logDebug("number of security labels in %s \"%s\".\"%s\": %d",
+				 PGQ_IS_FOREIGN_TABLE(tab->kind) ? "foreign table" : "table",
+				 tab->obj.schemaname, tab->obj.objectname, tab->nseclabels);
 
-			/* primary key */
-			if (t[i].pk.conname)
-				free(t[i].pk.conname);
-			if (t[i].pk.condef)
-				free(t[i].pk.condef);
-			if (t[i].pk.comment)
-				PQfreemem(t[i].pk.comment);
+		for (j = 0; j < tab->nattributes; j++)
+		{
+			PQLAttribute	*a = &tab->attributes[j];
 
-			/* ownedby sequences */
-			for (j = 0; j < t[i].nownedby; j++)
-			{
-				free(t[i].seqownedby[j].schemaname);
-				free(t[i].seqownedby[j].objectname);
-				free(t[i].attownedby[j]);
-			}
+			a->nseclabels = getObjectSecurityLabels(c, PGQ_CLASS_CLASS,
+													tab->obj.oid, a->attnum,
+													&a->seclabels);
+			if (a->nseclabels == 0)
+				continue;
 
-			if (t[i].attributes)
-				free(t[i].attributes);
-			if (t[i].parent)
-				free(t[i].parent);
-			if (t[i].check)
-				free(t[i].check);
-			if (t[i].fk)
-				free(t[i].fk);
-			if (t[i].seqownedby)
-				free(t[i].seqownedby);
-			if (t[i].attownedby)
-				free(t[i].attownedby);
+			logDebug("number of security labels in %s \"%s\".\"%s\" attribute \"%s\": %d",
+					 PGQ_IS_FOREIGN_TABLE(tab->kind) ? "foreign table" : "table",
+					 tab->obj.schemaname, tab->obj.objectname, a->attname, a->nseclabels);
 		}
-
-		free(t);
 	}
 }
 
 void
-getOwnedBySequences(PGconn *c, PQLTable *t)
+getOwnedBySequences(PGconn *c, PQLTable **t, int n)
 {
-	char		*query;
-	PGresult	*res;
-	int			i;
+	char		**queries;
+	PGresult	**res;
+	int			i, j;
 
-	query = psprintf("SELECT n.nspname, c.relname, a.attname FROM pg_depend d INNER JOIN pg_class c ON (c.oid = d.objid) INNER JOIN pg_namespace n ON (n.oid = c.relnamespace) INNER JOIN pg_attribute a ON (d.refobjid = a.attrelid AND d.refobjsubid = a.attnum) WHERE d.classid = 'pg_class'::regclass AND d.objsubid = 0 AND d.refobjid = %u AND d.refobjsubid != 0 AND d.deptype = 'a' AND c.relkind = 'S'", t->obj.oid);
+	if (n == 0)
+		return;
 
-	res = PQexec(c, query);
+	queries = (char **) malloc(n * sizeof(char *));
+	for (i = 0; i < n; i++)
+		queries[i] = psprintf("SELECT n.nspname, c.relname, a.attname FROM pg_depend d INNER JOIN pg_class c ON (c.oid = d.objid) INNER JOIN pg_namespace n ON (n.oid = c.relnamespace) INNER JOIN pg_attribute a ON (d.refobjid = a.attrelid AND d.refobjsubid = a.attnum) WHERE d.classid = 'pg_class'::regclass AND d.objsubid = 0 AND d.refobjid = %u AND d.refobjsubid != 0 AND d.deptype = 'a' AND c.relkind = 'S'", t[i]->obj.oid);
 
-	pfree(query);
+	res = execQueries(c, queries, n);
 
-	if (PQresultStatus(res) != PGRES_TUPLES_OK)
+	for (i = 0; i < n; i++)
 	{
-		logError("query failed: %s", PQresultErrorMessage(res));
-		PQclear(res);
-		PQfinish(c);
-		/* XXX leak another connection? */
-		exit(EXIT_FAILURE);
-	}
+		PQLTable	*tab = t[i];
 
-	t->nownedby = PQntuples(res);
-	if (t->nownedby > 0)
-	{
-		t->seqownedby = (PQLObject *) malloc(t->nownedby * sizeof(PQLObject));
-		t->attownedby = (char **) malloc(t->nownedby * sizeof(char *));
-	}
-	else
-	{
-		t->seqownedby = NULL;
-		t->attownedby = NULL;
-	}
+		tab->nownedby = PQntuples(res[i]);
+		if (tab->nownedby > 0)
+		{
+			tab->seqownedby = (PQLObject *) arenaAlloc(tab->nownedby * sizeof(PQLObject));
+			tab->attownedby = (char **) arenaAlloc(tab->nownedby * sizeof(char *));
+		}
+		else
+		{
+			tab->seqownedby = NULL;
+			tab->attownedby = NULL;
+		}
 
-	logDebug("number of sequences owned by the table \"%s\".\"%s\": %d",
-			 t->obj.schemaname, t->obj.objectname, t->nownedby);
-	for (i = 0; i < t->nownedby; i++)
-	{
-		t->seqownedby[i].schemaname = strdup(PQgetvalue(res, i, PQfnumber(res,
-											 "nspname")));
-		t->seqownedby[i].objectname = strdup(PQgetvalue(res, i, PQfnumber(res,
-											 "relname")));
-		t->attownedby[i] = strdup(PQgetvalue(res, i, PQfnumber(res, "attname")));
+		logDebug("number of sequences owned by the table \"%s\".\"%s\": %d",
+				 tab->obj.schemaname, tab->obj.objectname, tab->nownedby);
+		for (j = 0; j < tab->nownedby; j++)
+		{
+			tab->seqownedby[j].schemaname = internName(PQgetvalue(res[i], j,
+												   PQfnumber(res[i], "nspname")));
+			tab->seqownedby[j].objectname = internName(PQgetvalue(res[i], j,
+												   PQfnumber(res[i], "relname")));
+			tab->attownedby[j] = arenaStrdup(PQgetvalue(res[i], j, PQfnumber(res[i],
+												   "attname")));
+
+			logDebug("sequence \"%s\".\"%s\" owned by table \"%s\".\"%s\" attribute \"%s\"",
+					 tab->seqownedby[j].schemaname, tab->seqownedby[j].objectname,
+					 tab->obj.schemaname, tab->obj.objectname, tab->attownedby[j]);
+		}
 
-		logDebug("sequence \"%s\".\"%s\" owned by table \"%s\".\"%s\" attribute \"%s\"",
-				 t->seqownedby[i].schemaname, t->seqownedby[i].objectname,
-				 t->obj.schemaname, t->obj.objectname, t->attownedby[i]);
+		PQclear(res[i]);
 	}
 
-	PQclear(res);
+	free(res);
 }
 
 void
 dumpDropTable(FILE *output, PQLTable *t)
 {
-	char	*schema = formatObjectIdentifier(t->obj.schemaname);
-	char	*tabname = formatObjectIdentifier(t->obj.objectname);
+	char	*schema = quotedName(t->obj.schemaname);
+	char	*tabname = quotedName(t->obj.objectname);
 	char	*kind;
 
 	if (PGQ_IS_REGULAR_OR_PARTITIONED_TABLE(t->kind))
@@ -1180,15 +1153,13 @@ dumpDropTable(FILE *output, PQLTable *t)
 	fprintf(output, "DROP %s %s.%s;", kind, schema, tabname);
 
 	free(kind);
-	free(schema);
-	free(tabname);
 }
 
 void
 dumpCreateTable(FILE *output, FILE *output2, PQLTable *t)
 {
-	char	*schema = formatObjectIdentifier(t->obj.schemaname);
-	char	*tabname = formatObjectIdentifier(t->obj.objectname);
+	char	*schema = quotedName(t->obj.schemaname);
+	char	*tabname = quotedName(t->obj.objectname);
 	char	*kind;
 
 	char	*typeschema;
@@ -1215,13 +1186,10 @@ dumpCreateTable(FILE *output, FILE *output2, PQLTable *t)
 	/* typed table */
 	if (t->reloftype.oid != InvalidOid)
 	{
-		typeschema = formatObjectIdentifier(t->reloftype.schemaname);
-		typename = formatObjectIdentifier(t->reloftype.objectname);
+		typeschema = quotedName(t->reloftype.schemaname);
+		typename = quotedName(t->reloftype.objectname);
 
 		fprintf(output, "OF %s.%s", typeschema, typename);
-
-		free(typeschema);
-		free(typename);
 	}
 
 	/* print attributes */
@@ -1296,7 +1264,7 @@ dumpCreateTable(FILE *output, FILE *output2, PQLTable *t)
 
 	/* partition */
 	if (t->partition)
-		dumpAttachPartition(output2, t);
+		dumpAttachPartition(output2, t, NULL);
 
 	/* replica identity */
 	if (PGQ_IS_REGULAR_OR_PARTITIONED_TABLE(t->kind) &&
@@ -1335,8 +1303,8 @@ dumpCreateTable(FILE *output, FILE *output2, PQLTable *t)
 	/* statistics target */
 	for (i = 0; i < t->nattributes; i++)
 	{
-		dumpAlterColumnSetStatistics(output, t, i, false);
-		dumpAlterColumnSetStorage(output, t, i, false);
+		dumpAlterColumnSetStatistics(output, NULL, t, i, false);
+		dumpAlterColumnSetStorage(output, NULL, t, i, false);
 	}
 
 	/* print primary key */
@@ -1361,16 +1329,14 @@ dumpCreateTable(FILE *output, FILE *output2, PQLTable *t)
 	/* print owned by sequences */
 	for (i = 0; i < t->nownedby; i++)
 	{
-		char	*seqschema = formatObjectIdentifier(t->seqownedby[i].schemaname);
-		char	*seqname = formatObjectIdentifier(t->seqownedby[i].objectname);
+		char	*seqschema = quotedName(t->seqownedby[i].schemaname);
+		char	*seqname = quotedName(t->seqownedby[i].objectname);
 		char	*attname = formatObjectIdentifier(t->attownedby[i]);
 
 		fprintf(output, "\n\n");
 		fprintf(output, "ALTER SEQUENCE %s.%s OWNED BY %s.%s.%s;", seqschema, seqname,
 				schema, tabname, attname);
 
-		free(seqschema);
-		free(seqname);
 		free(attname);
 	}
 
@@ -1380,8 +1346,9 @@ dumpCreateTable(FILE *output, FILE *output2, PQLTable *t)
 		if (t->comment != NULL)
 		{
 			fprintf(output, "\n\n");
-			fprintf(output, "COMMENT ON %s %s.%s IS %s;", kind, schema, tabname,
-					t->comment);
+			fprintf(output, "COMMENT ON %s %s.%s IS ", kind, schema, tabname);
+			printComment(output, t->comment);
+			fprintf(output, ";");
 		}
 
 		/* columns */
@@ -1392,8 +1359,9 @@ dumpCreateTable(FILE *output, FILE *output2, PQLTable *t)
 				char	*attname = formatObjectIdentifier(t->attributes[i].attname);
 
 				fprintf(output, "\n\n");
-				fprintf(output, "COMMENT ON COLUMN %s.%s.%s IS %s;", schema, tabname, attname,
-						t->attributes[i].comment);
+				fprintf(output, "COMMENT ON COLUMN %s.%s.%s IS ", schema, tabname, attname);
+				printComment(output, t->attributes[i].comment);
+				fprintf(output, ";");
 
 				free(attname);
 			}
@@ -1405,8 +1373,10 @@ dumpCreateTable(FILE *output, FILE *output2, PQLTable *t)
 			char	*pkname = formatObjectIdentifier(t->pk.conname);
 
 			fprintf(output, "\n\n");
-			fprintf(output, "COMMENT ON CONSTRAINT %s ON %s.%s IS %s;", pkname, schema,
-					tabname, t->pk.comment);
+			fprintf(output, "COMMENT ON CONSTRAINT %s ON %s.%s IS ", pkname, schema,
+					tabname);
+			printComment(output, t->pk.comment);
+			fprintf(output, ";");
 
 			free(pkname);
 		}
@@ -1419,8 +1389,10 @@ dumpCreateTable(FILE *output, FILE *output2, PQLTable *t)
 				char	*fkname = formatObjectIdentifier(t->fk[i].conname);
 
 				fprintf(output, "\n\n");
-				fprintf(output, "COMMENT ON CONSTRAINT %s ON %s.%s IS %s;", fkname, schema,
-						tabname, t->fk[i].comment);
+				fprintf(output, "COMMENT ON CONSTRAINT %s ON %s.%s IS ", fkname, schema,
+						tabname);
+				printComment(output, t->fk[i].comment);
+				fprintf(output, ";");
 
 				free(fkname);
 			}
@@ -1434,8 +1406,10 @@ dumpCreateTable(FILE *output, FILE *output2, PQLTable *t)
 				char	*ckname = formatObjectIdentifier(t->check[i].conname);
 
 				fprintf(output, "\n\n");
-				fprintf(output, "COMMENT ON CONSTRAINT %s ON %s.%s IS %s;", ckname, schema,
-						tabname, t->check[i].comment);
+				fprintf(output, "COMMENT ON CONSTRAINT %s ON %s.%s IS ", ckname, schema,
+						tabname);
+				printComment(output, t->check[i].comment);
+				fprintf(output, ";");
 
 				free(ckname);
 			}
@@ -1498,12 +1472,10 @@ dumpCreateTable(FILE *output, FILE *output2, PQLTable *t)
 	/* owner */
 	if (options.owner)
 	{
-		char	*owner = formatObjectIdentifier(t->owner);
+		char	*owner = quotedName(t->owner);
 
 		fprintf(output, "\n\n");
 		fprintf(output, "ALTER %s %s.%s OWNER TO %s;", kind, schema, tabname, owner);
-
-		free(owner);
 	}
 
 	/* privileges */
@@ -1529,40 +1501,206 @@ dumpCreateTable(FILE *output, FILE *output2, PQLTable *t)
 	}
 
 	free(kind);
-	free(schema);
-	free(tabname);
 }
 
-static void
-dumpAddColumn(FILE *output, PQLTable *t, int i)
+/*
+ * Return a comment with the estimated cost of a command on table t (server 1)
+ * if annotate-cost is set or an empty string otherwise. A scan reads the
+ * whole table and a rewrite also writes a new copy of it. A command that
+ * touches more than cost-threshold is reported and counted; pgquarrel fails
+ * after all changes are written.
+ */
+static char *
+formatCommandCost(PQLTable *t, int cost)
 {
-	char	*schema = formatObjectIdentifier(t->obj.schemaname);
-	char	*tabname = formatObjectIdentifier(t->obj.objectname);
-	char	*attname = formatObjectIdentifier(t->attributes[i].attname);
-	char	*kind;
+	static const char *const costnames[] = {"metadata only", "scan", "rewrite"};
+	int64	bytes;
 
-	if (PGQ_IS_REGULAR_OR_PARTITIONED_TABLE(t->kind))
-		kind = strdup("TABLE");
-	else if (PGQ_IS_FOREIGN_TABLE(t->kind))
-		kind = strdup("FOREIGN TABLE");
+	/* data of a foreign table is not stored locally */
+	if (PGQ_IS_FOREIGN_TABLE(t->kind))
+		cost = PGQ_COST_METADATA;
+
+	if (cost == PGQ_COST_METADATA || t->relsize < 0)
+		bytes = 0;
+	else if (cost == PGQ_COST_SCAN)
+		bytes = t->relsize;
 	else
+		bytes = 2 * t->relsize;
+
+	if (options.costthreshold > 0 &&
+			bytes > (int64) options.costthreshold * 1024 * 1024)
 	{
-		logError("table is not regular, partitioned or foreign");
+		logError("%s of table \"%s\".\"%s\" touches about " INT64_FORMAT " bytes; cost-threshold is %d MB",
+				 costnames[cost], t->obj.schemaname, t->obj.objectname, bytes,
+				 options.costthreshold);
+		costexceeded++;
+	}
+
+	if (!options.annotatecost)
+		return psprintf("%s", "");
+	if (cost == PGQ_COST_METADATA)
+		return psprintf("-- cost: %s\n", costnames[cost]);
+	if (t->relsize < 0)
+		return psprintf("-- cost: %s, size unknown\n", costnames[cost]);
+
+	return psprintf("-- cost: %s, about " INT64_FORMAT " bytes\n", costnames[cost],
+					bytes);
+}
+
+/*
+ * Add a formatted subcommand or command to sl.
+ */
+static void
+appendAlterTableCmd(stringList *sl, const char *fmt, ...)
+{
+	va_list	args;
+	char	*cmd;
+	int		len;
+
+	va_start(args, fmt);
+	len = vsnprintf(NULL, 0, fmt, args);
+	va_end(args);
+
+	cmd = (char *) malloc(len + 1);
+	if (cmd == NULL)
+	{
+		logError("could not allocate memory");
 		exit(EXIT_FAILURE);
 	}
 
-	fprintf(output, "\n\n");
-	fprintf(output, "ALTER %s ONLY %s.%s ADD COLUMN %s %s", kind, schema, tabname,
-			attname, t->attributes[i].atttypname);
+	va_start(args, fmt);
+	vsnprintf(cmd, len + 1, fmt, args);
+	va_end(args);
+
+	appendStringList(sl, cmd);
+
+	free(cmd);
+}
+
+/*
+ * Add a formatted ALTER TABLE statement to at->after. It is preceded by its
+ * cost (see formatCommandCost).
+ */
+static void
+appendAlterTableStmt(PQLAlterTableCmds *at, int cost, const char *fmt, ...)
+{
+	va_list	args;
+	char	*cmd;
+	char	*comment;
+	int		len;
+
+	va_start(args, fmt);
+	len = vsnprintf(NULL, 0, fmt, args);
+	va_end(args);
+
+	cmd = (char *) malloc(len + 1);
+	if (cmd == NULL)
+	{
+		logError("could not allocate memory");
+		exit(EXIT_FAILURE);
+	}
+
+	va_start(args, fmt);
+	vsnprintf(cmd, len + 1, fmt, args);
+	va_end(args);
+
+	comment = formatCommandCost(at->target, cost);
+	appendAlterTableCmd(&at->after, "%s%s", comment, cmd);
+
+	pfree(comment);
+	free(cmd);
+}
+
+/*
+ * Print properties of attribute j of the second table (and attribute i of
+ * the first table unless i is -1) after the ALTER TABLE statement.
+ */
+static void
+addAlterTableColumn(PQLAlterTableCmds *at, int i, int j)
+{
+	at->columns[2 * at->ncolumns] = i;
+	at->columns[2 * at->ncolumns + 1] = j;
+	at->ncolumns++;
+}
+
+/*
+ * Print the ALTER TABLE statement of table b followed by the commands that
+ * depend on it.
+ */
+static void
+dumpAlterTableCmds(FILE *output, PQLTable *a, PQLTable *b,
+				   PQLAlterTableCmds *at)
+{
+	const char		*schema = quotedName(b->obj.schemaname);
+	const char		*tabname = quotedName(b->obj.objectname);
+	stringListCell	*cell;
+	int				k;
+
+	if (at->cmds.head != NULL)
+	{
+		char	*cost = formatCommandCost(at->target, at->cost);
+
+		fprintf(output, "\n\n");
+		fprintf(output, "%s", cost);
+		fprintf(output, "ALTER %s ONLY %s.%s",
+				PGQ_IS_FOREIGN_TABLE(b->kind) ? "FOREIGN TABLE" : "TABLE",
+				schema, tabname);
+		for (cell = at->cmds.head; cell; cell = cell->next)
+			fprintf(output, "\n\t%s%s", cell->value, (cell->next) ? "," : ";");
+
+		pfree(cost);
+	}
+
+	for (cell = at->after.head; cell; cell = cell->next)
+	{
+		fprintf(output, "\n\n");
+		fprintf(output, "%s", cell->value);
+	}
+
+	for (k = 0; k < at->ncolumns; k++)
+	{
+		int		i = at->columns[2 * k];
+		int		j = at->columns[2 * k + 1];
+
+		if (i < 0)
+			dumpAddColumnProperties(output, b, j);
+		else
+			dumpAlterColumnProperties(output, a, i, b, j);
+	}
+}
+
+static void
+dumpAddColumn(PQLAlterTableCmds *at, PQLTable *t, int i)
+{
+	char	*attname = formatObjectIdentifier(t->attributes[i].attname);
+	char	*cmd;
+	char	*tmp;
+
+	cmd = psprintf("ADD COLUMN %s %s", attname, t->attributes[i].atttypname);
 
 	/* collate */
 	/* XXX schema-qualified? */
 	if (t->attributes[i].attcollation != NULL)
-		fprintf(output, " COLLATE \"%s\"", t->attributes[i].attcollation);
+	{
+		tmp = psprintf("%s COLLATE \"%s\"", cmd, t->attributes[i].attcollation);
+		pfree(cmd);
+		cmd = tmp;
+	}
 
 	/* default value? */
 	if (t->attributes[i].attdefexpr != NULL)
-		fprintf(output, " DEFAULT %s", t->attributes[i].attdefexpr);
+	{
+		tmp = psprintf("%s DEFAULT %s", cmd, t->attributes[i].attdefexpr);
+		pfree(cmd);
+		cmd = tmp;
+
+		/*
+		 * 11 or later stores a non-volatile default in the catalog. A default
+		 * that calls a volatile function is evaluated for each row.
+		 */
+		if (pgversion1 < 110000 || t->attributes[i].attdefvolatile)
+			at->cost = Max(at->cost, PGQ_COST_REWRITE);
+	}
 
 	/* not null? */
 	/*
@@ -1572,20 +1710,42 @@ dumpAddColumn(FILE *output, PQLTable *t, int i)
 	 * XXX null in a table that already contains data.
 	 */
 	if (t->attributes[i].attnotnull)
-		fprintf(output, " NOT NULL");
+	{
+		tmp = psprintf("%s NOT NULL", cmd);
+		pfree(cmd);
+		cmd = tmp;
 
-	/* attribute options */
+		at->cost = Max(at->cost, PGQ_COST_SCAN);
+	}
+
+	appendStringList(&at->cmds, cmd);
+	pfree(cmd);
+
+	/* attribute options are not part of the column definition */
 	if (t->attributes[i].attoptions)
-		fprintf(output, " SET (%s)", t->attributes[i].attoptions);
+		appendAlterTableCmd(&at->cmds, "ALTER COLUMN %s SET (%s)", attname,
+							t->attributes[i].attoptions);
 
-	fprintf(output, ";");
+	free(attname);
+}
+
+/*
+ * Comment, security labels and privileges of a new attribute.
+ */
+static void
+dumpAddColumnProperties(FILE *output, PQLTable *t, int i)
+{
+	char	*schema = quotedName(t->obj.schemaname);
+	char	*tabname = quotedName(t->obj.objectname);
+	char	*attname = formatObjectIdentifier(t->attributes[i].attname);
 
 	/* comment */
 	if (options.comment && t->attributes[i].comment != NULL)
 	{
 		fprintf(output, "\n\n");
-		fprintf(output, "COMMENT ON COLUMN %s.%s.%s IS %s;", schema, tabname, attname,
-				t->attributes[i].comment);
+		fprintf(output, "COMMENT ON COLUMN %s.%s.%s IS ", schema, tabname, attname);
+		printComment(output, t->attributes[i].comment);
+		fprintf(output, ";");
 	}
 
 	/* security labels */
@@ -1610,60 +1770,25 @@ dumpAddColumn(FILE *output, PQLTable *t, int i)
 		dumpGrantAndRevoke(output, PGQ_TABLE, &t->obj, &t->obj, NULL,
 						   t->attributes[i].acl, NULL, attname);
 
-	free(kind);
-	free(schema);
-	free(tabname);
 	free(attname);
 }
 
 static void
-dumpRemoveColumn(FILE *output, PQLTable *t, int i)
+dumpRemoveColumn(PQLAlterTableCmds *at, PQLTable *t, int i)
 {
-	char	*schema = formatObjectIdentifier(t->obj.schemaname);
-	char	*tabname = formatObjectIdentifier(t->obj.objectname);
 	char	*attname = formatObjectIdentifier(t->attributes[i].attname);
-	char	*kind;
-
-	if (PGQ_IS_REGULAR_OR_PARTITIONED_TABLE(t->kind))
-		kind = strdup("TABLE");
-	else if (PGQ_IS_FOREIGN_TABLE(t->kind))
-		kind = strdup("FOREIGN TABLE");
-	else
-	{
-		logError("table is not regular, partitioned or foreign");
-		exit(EXIT_FAILURE);
-	}
 
-	fprintf(output, "\n\n");
-	fprintf(output, "ALTER %s ONLY %s.%s DROP COLUMN %s;", kind, schema, tabname,
-			attname);
+	appendAlterTableCmd(&at->cmds, "DROP COLUMN %s", attname);
 
-	free(kind);
-	free(schema);
-	free(tabname);
 	free(attname);
 }
 
 static void
-dumpAlterColumn(FILE *output, PQLTable *a, int i, PQLTable *b, int j)
+dumpAlterColumn(PQLAlterTableCmds *at, PQLTable *a, int i, PQLTable *b, int j)
 {
-	char	*schema1 = formatObjectIdentifier(a->obj.schemaname);
-	char	*tabname1 = formatObjectIdentifier(a->obj.objectname);
-	char	*attname1 = formatObjectIdentifier(a->attributes[i].attname);
-	char	*schema2 = formatObjectIdentifier(b->obj.schemaname);
-	char	*tabname2 = formatObjectIdentifier(b->obj.objectname);
+	char	*schema2 = quotedName(b->obj.schemaname);
+	char	*tabname2 = quotedName(b->obj.objectname);
 	char	*attname2 = formatObjectIdentifier(b->attributes[j].attname);
-	char	*kind;
-
-	if (PGQ_IS_REGULAR_OR_PARTITIONED_TABLE(b->kind))
-		kind = strdup("TABLE");
-	else if (PGQ_IS_FOREIGN_TABLE(b->kind))
-		kind = strdup("FOREIGN TABLE");
-	else
-	{
-		logError("table is not regular, partitioned or foreign");
-		exit(EXIT_FAILURE);
-	}
 
 	/*
 	 * Although we emit a command to change the type of the column of a table,
@@ -1678,48 +1803,87 @@ dumpAlterColumn(FILE *output, PQLTable *a, int i, PQLTable *b, int j)
 	 */
 	if (strcmp(a->attributes[i].atttypname, b->attributes[j].atttypname) != 0)
 	{
-		fprintf(output, "\n\n");
-		fprintf(output, "ALTER %s ONLY %s.%s ALTER COLUMN %s SET DATA TYPE %s",
-				kind, schema2, tabname2, attname2, b->attributes[j].atttypname);
-
 		/* collate */
 		/* XXX schema-qualified? */
 		if (b->attributes[j].attcollation != NULL)
-			fprintf(output, " COLLATE \"%s\"", b->attributes[j].attcollation);
+			appendAlterTableCmd(&at->cmds, "ALTER COLUMN %s SET DATA TYPE %s COLLATE \"%s\"",
+								attname2, b->attributes[j].atttypname,
+								b->attributes[j].attcollation);
+		else
+			appendAlterTableCmd(&at->cmds, "ALTER COLUMN %s SET DATA TYPE %s",
+								attname2, b->attributes[j].atttypname);
 
-		fprintf(output, ";");
+		/* binary coercible types (e.g. varchar(n) to text) are not detected */
+		at->cost = Max(at->cost, PGQ_COST_REWRITE);
 	}
 
 	/* default value? */
 	if (a->attributes[i].attdefexpr == NULL && b->attributes[j].attdefexpr != NULL)
-	{
-		fprintf(output, "\n\n");
-		fprintf(output, "ALTER %s ONLY %s.%s ALTER COLUMN %s SET DEFAULT %s;",
-				kind, schema2, tabname2, attname2, b->attributes[j].attdefexpr);
-	}
+		appendAlterTableCmd(&at->cmds, "ALTER COLUMN %s SET DEFAULT %s", attname2,
+							b->attributes[j].attdefexpr);
 	else if (a->attributes[i].attdefexpr != NULL &&
 			 b->attributes[j].attdefexpr == NULL)
-	{
-		fprintf(output, "\n\n");
-		fprintf(output, "ALTER %s ONLY %s.%s ALTER COLUMN %s DROP DEFAULT;", kind,
-				schema2,
-				tabname2, attname2);
-	}
+		appendAlterTableCmd(&at->cmds, "ALTER COLUMN %s DROP DEFAULT", attname2);
 
 	/* not null? */
-	if (!a->attributes[i].attnotnull && b->attributes[j].attnotnull)
+	if (!a->attributes[i].attnotnull && b->attributes[j].attnotnull &&
+			options.online && pgversion1 >= 120000 && PGQ_IS_REGULAR_TABLE(b->kind))
 	{
-		fprintf(output, "\n\n");
-		fprintf(output, "ALTER %s ONLY %s.%s ALTER COLUMN %s SET NOT NULL;", kind,
-				schema2,
-				tabname2, attname2);
+		char	*conname;
+
+		/*
+		 * The helper constraint is named after the table oid and column
+		 * number; it is shorter than NAMEDATALEN and does not clash with
+		 * another constraint of the table.
+		 */
+		conname = psprintf("pgquarrel_not_null_%u_%d", a->obj.oid,
+						   a->attributes[i].attnum);
+
+		/*
+		 * SET NOT NULL scans the table while holding an ACCESS EXCLUSIVE
+		 * lock unless a valid CHECK constraint proves it (12 or later).
+		 * VALIDATE CONSTRAINT only takes a SHARE UPDATE EXCLUSIVE lock so
+		 * these commands are not merged into the ALTER TABLE statement.
+		 */
+		appendAlterTableStmt(at, PGQ_COST_METADATA, "ALTER TABLE ONLY %s.%s ADD CONSTRAINT %s CHECK (%s IS NOT NULL) NOT VALID;",
+							 schema2, tabname2, conname, attname2);
+		appendAlterTableStmt(at, PGQ_COST_SCAN, "ALTER TABLE ONLY %s.%s VALIDATE CONSTRAINT %s;",
+							 schema2, tabname2, conname);
+		appendAlterTableStmt(at, PGQ_COST_METADATA, "ALTER TABLE ONLY %s.%s ALTER COLUMN %s SET NOT NULL;",
+							 schema2, tabname2, attname2);
+		appendAlterTableStmt(at, PGQ_COST_METADATA, "ALTER TABLE ONLY %s.%s DROP CONSTRAINT %s;",
+							 schema2, tabname2, conname);
+
+		pfree(conname);
 	}
-	else if (a->attributes[i].attnotnull && !b->attributes[j].attnotnull)
+	else if (!a->attributes[i].attnotnull && b->attributes[j].attnotnull)
 	{
-		fprintf(output, "\n\n");
-		fprintf(output, "ALTER %s ONLY %s.%s ALTER COLUMN %s DROP NOT NULL;",
-				kind, schema2, tabname2, attname2);
+		if (options.online)
+			logWarning("table \"%s\".\"%s\": SET NOT NULL of column \"%s\" is not online; it locks the table while scanning it (requires a regular table and server 12 or later)",
+					   b->obj.schemaname, b->obj.objectname, b->attributes[j].attname);
+
+		appendAlterTableCmd(&at->cmds, "ALTER COLUMN %s SET NOT NULL", attname2);
+		at->cost = Max(at->cost, PGQ_COST_SCAN);
 	}
+	else if (a->attributes[i].attnotnull && !b->attributes[j].attnotnull)
+		appendAlterTableCmd(&at->cmds, "ALTER COLUMN %s DROP NOT NULL", attname2);
+
+	free(attname2);
+}
+
+/*
+ * Comment, security labels and privileges of an attribute that exists in
+ * both tables.
+ */
+static void
+dumpAlterColumnProperties(FILE *output, PQLTable *a, int i, PQLTable *b, int j)
+{
+	char	*schema1 = quotedName(a->obj.schemaname);
+	char	*tabname1 = quotedName(a->obj.objectname);
+	char	*attname1 = formatObjectIdentifier(a->attributes[i].attname);
+	char	*schema2 = quotedName(b->obj.schemaname);
+	char	*tabname2 = quotedName(b->obj.objectname);
+	char	*attname2 = formatObjectIdentifier(b->attributes[j].attname);
 
 	/* comment */
 	if (options.comment)
@@ -1729,8 +1893,10 @@ dumpAlterColumn(FILE *output, PQLTable *a, int i, PQLTable *b, int j)
 				 strcmp(a->attributes[i].comment, b->attributes[j].comment) != 0))
 		{
 			fprintf(output, "\n\n");
-			fprintf(output, "COMMENT ON COLUMN %s.%s.%s IS %s;", schema2, tabname2,
-					attname2, b->attributes[j].comment);
+			fprintf(output, "COMMENT ON COLUMN %s.%s.%s IS ", schema2, tabname2,
+					attname2);
+			printComment(output, b->attributes[j].comment);
+			fprintf(output, ";");
 		}
 		else if (a->attributes[i].comment != NULL && b->attributes[j].comment == NULL)
 		{
@@ -1851,20 +2017,20 @@ dumpAlterColumn(FILE *output, PQLTable *a, int i, PQLTable *b, int j)
 		dumpGrantAndRevoke(output, PGQ_TABLE, &a->obj, &b->obj, a->attributes[i].acl,
 						   b->attributes[j].acl, NULL, attname1);
 
-	free(kind);
-	free(schema1);
-	free(tabname1);
 	free(attname1);
-	free(schema2);
-	free(tabname2);
 	free(attname2);
 }
 
+/*
+ * Add the subcommand to at or, if at is NULL, print it as an ALTER TABLE
+ * command (see dumpCreateTable).
+ */
 static void
-dumpAlterColumnSetStatistics(FILE *output, PQLTable *t, int i, bool force)
+dumpAlterColumnSetStatistics(FILE *output, PQLAlterTableCmds *at, PQLTable *t,
+							 int i, bool force)
 {
-	char	*schema = formatObjectIdentifier(t->obj.schemaname);
-	char	*tabname = formatObjectIdentifier(t->obj.objectname);
+	char	*schema = quotedName(t->obj.schemaname);
+	char	*tabname = quotedName(t->obj.objectname);
 	char	*attname = formatObjectIdentifier(t->attributes[i].attname);
 	char	*kind;
 
@@ -1880,22 +2046,27 @@ dumpAlterColumnSetStatistics(FILE *output, PQLTable *t, int i, bool force)
 
 	if (t->attributes[i].attstattarget != -1 || force)
 	{
-		fprintf(output, "\n\n");
-		fprintf(output, "ALTER %s ONLY %s.%s ALTER COLUMN %s SET STATISTICS %d;",
-				kind, schema, tabname, attname, t->attributes[i].attstattarget);
+		if (at != NULL)
+			appendAlterTableCmd(&at->cmds, "ALTER COLUMN %s SET STATISTICS %d", attname,
+								t->attributes[i].attstattarget);
+		else
+		{
+			fprintf(output, "\n\n");
+			fprintf(output, "ALTER %s ONLY %s.%s ALTER COLUMN %s SET STATISTICS %d;",
+					kind, schema, tabname, attname, t->attributes[i].attstattarget);
+		}
 	}
 
 	free(kind);
-	free(schema);
-	free(tabname);
 	free(attname);
 }
 
 static void
-dumpAlterColumnSetStorage(FILE *output, PQLTable *t, int i, bool force)
+dumpAlterColumnSetStorage(FILE *output, PQLAlterTableCmds *at, PQLTable *t,
+						  int i, bool force)
 {
-	char	*schema = formatObjectIdentifier(t->obj.schemaname);
-	char	*tabname = formatObjectIdentifier(t->obj.objectname);
+	char	*schema = quotedName(t->obj.schemaname);
+	char	*tabname = quotedName(t->obj.objectname);
 	char	*attname = formatObjectIdentifier(t->attributes[i].attname);
 	char	*kind;
 
@@ -1911,14 +2082,18 @@ dumpAlterColumnSetStorage(FILE *output, PQLTable *t, int i, bool force)
 
 	if (!t->attributes[i].defstorage || force)
 	{
-		fprintf(output, "\n\n");
-		fprintf(output, "ALTER %s ONLY %s.%s ALTER COLUMN %s SET STORAGE %s;",
-				kind, schema, tabname, attname, t->attributes[i].attstorage);
+		if (at != NULL)
+			appendAlterTableCmd(&at->cmds, "ALTER COLUMN %s SET STORAGE %s", attname,
+								t->attributes[i].attstorage);
+		else
+		{
+			fprintf(output, "\n\n");
+			fprintf(output, "ALTER %s ONLY %s.%s ALTER COLUMN %s SET STORAGE %s;",
+					kind, schema, tabname, attname, t->attributes[i].attstorage);
+		}
 	}
 
 	free(kind);
-	free(schema);
-	free(tabname);
 	free(attname);
 }
 
@@ -1926,33 +2101,18 @@ dumpAlterColumnSetStorage(FILE *output, PQLTable *t, int i, bool force)
  * Set attribute options if needed
  */
 static void
-dumpAlterColumnSetOptions(FILE *output, PQLTable *a, int i, PQLTable *b, int j)
+dumpAlterColumnSetOptions(PQLAlterTableCmds *at, PQLTable *a, int i, PQLTable *b,
+						  int j)
 {
-	char	*schema2 = formatObjectIdentifier(b->obj.schemaname);
-	char	*tabname2 = formatObjectIdentifier(b->obj.objectname);
 	char	*attname2 = formatObjectIdentifier(b->attributes[j].attname);
-	char	*kind;
-
-	if (PGQ_IS_REGULAR_OR_PARTITIONED_TABLE(b->kind))
-		kind = strdup("TABLE");
-	else if (PGQ_IS_FOREIGN_TABLE(b->kind))
-		kind = strdup("FOREIGN TABLE");
-	else
-	{
-		logError("table is not regular, partitioned or foreign");
-		exit(EXIT_FAILURE);
-	}
 
 	if (a->attributes[i].attoptions == NULL && b->attributes[j].attoptions != NULL)
-	{
-		fprintf(output, "\n\n");
-		fprintf(output, "ALTER %s ONLY %s.%s ALTER COLUMN %s SET (%s);", kind,
-				schema2, tabname2, attname2, b->attributes[j].attoptions);
-	}
+		appendAlterTableCmd(&at->cmds, "ALTER COLUMN %s SET (%s)", attname2,
+							b->attributes[j].attoptions);
 	else if (a->attributes[i].attoptions != NULL &&
 			 b->attributes[j].attoptions == NULL)
 	{
-		stringList	*rlist;
+		PQLOptionSet	*rlist;
 
 		/* reset all options */
 		rlist = setOperationOptions(a->attributes[i].attoptions,
@@ -1963,19 +2123,18 @@ dumpAlterColumnSetOptions(FILE *output, PQLTable *a, int i, PQLTable *b, int j)
 			char	*resetlist;
 
 			resetlist = printOptions(rlist);
-			fprintf(output, "\n\n");
-			fprintf(output, "ALTER %s ONLY %s.%s ALTER COLUMN %s RESET (%s);", kind,
-					schema2, tabname2, attname2, resetlist);
+			appendAlterTableCmd(&at->cmds, "ALTER COLUMN %s RESET (%s)", attname2,
+								resetlist);
 
 			free(resetlist);
-			freeStringList(rlist);
+			freeOptionSet(rlist);
 		}
 	}
 	else if (a->attributes[i].attoptions != NULL &&
 			 b->attributes[j].attoptions != NULL &&
 			 strcmp(a->attributes[i].attoptions, b->attributes[j].attoptions) != 0)
 	{
-		stringList	*rlist, *ilist, *slist;
+		PQLOptionSet	*rlist, *ilist, *slist;
 
 		/* reset options that are only presented in the first set */
 		rlist = setOperationOptions(a->attributes[i].attoptions,
@@ -1986,12 +2145,11 @@ dumpAlterColumnSetOptions(FILE *output, PQLTable *a, int i, PQLTable *b, int j)
 			char	*resetlist;
 
 			resetlist = printOptions(rlist);
-			fprintf(output, "\n\n");
-			fprintf(output, "ALTER %s ONLY %s.%s ALTER COLUMN %s RESET (%s);", kind,
-					schema2, tabname2, attname2, resetlist);
+			appendAlterTableCmd(&at->cmds, "ALTER COLUMN %s RESET (%s)", attname2,
+								resetlist);
 
 			free(resetlist);
-			freeStringList(rlist);
+			freeOptionSet(rlist);
 		}
 
 		/*
@@ -2005,12 +2163,11 @@ dumpAlterColumnSetOptions(FILE *output, PQLTable *a, int i, PQLTable *b, int j)
 			char	*setlist;
 
 			setlist = printOptions(ilist);
-			fprintf(output, "\n\n");
-			fprintf(output, "ALTER %s ONLY %s.%s ALTER COLUMN %s SET (%s);", kind,
-					schema2, tabname2, attname2, setlist);
+			appendAlterTableCmd(&at->cmds, "ALTER COLUMN %s SET (%s)", attname2,
+								setlist);
 
 			free(setlist);
-			freeStringList(ilist);
+			freeOptionSet(ilist);
 		}
 
 		/*
@@ -2023,153 +2180,145 @@ dumpAlterColumnSetOptions(FILE *output, PQLTable *a, int i, PQLTable *b, int j)
 			char	*setlist;
 
 			setlist = printOptions(slist);
-			fprintf(output, "\n\n");
-			fprintf(output, "ALTER %s ONLY %s.%s ALTER COLUMN %s SET (%s);", kind,
-					schema2, tabname2, attname2, setlist);
+			appendAlterTableCmd(&at->cmds, "ALTER COLUMN %s SET (%s)", attname2,
+								setlist);
 
 			free(setlist);
-			freeStringList(slist);
+			freeOptionSet(slist);
 		}
 	}
 
-	free(kind);
-	free(schema2);
-	free(tabname2);
 	free(attname2);
 }
 
 static void
-dumpAddPK(FILE *output, PQLTable *t)
+dumpAddPK(PQLAlterTableCmds *at, PQLTable *t)
 {
-	char	*schema = formatObjectIdentifier(t->obj.schemaname);
-	char	*tabname = formatObjectIdentifier(t->obj.objectname);
+	char	*schema = quotedName(t->obj.schemaname);
+	char	*tabname = quotedName(t->obj.objectname);
 
-	fprintf(output, "\n\n");
-	fprintf(output, "ALTER TABLE ONLY %s.%s\n", schema, tabname);
-	fprintf(output, "\tADD CONSTRAINT %s %s", t->pk.conname, t->pk.condef);
-	fprintf(output, ";");
+	appendAlterTableCmd(&at->cmds, "ADD CONSTRAINT %s %s", t->pk.conname,
+						t->pk.condef);
+	/* index build */
+	at->cost = Max(at->cost, PGQ_COST_SCAN);
 
 	if (options.comment)
 	{
 		if (t->pk.comment != NULL)
 		{
 			char	*pkname = formatObjectIdentifier(t->pk.conname);
+			char	*comment = formatComment(t->pk.comment);
 
-			fprintf(output, "\n\n");
-			fprintf(output, "COMMENT ON CONSTRAINT %s ON %s.%s IS %s;", pkname, schema,
-					tabname, t->pk.comment);
+			appendAlterTableCmd(&at->after, "COMMENT ON CONSTRAINT %s ON %s.%s IS %s;",
+								pkname, schema, tabname, comment);
 
 			free(pkname);
+			free(comment);
 		}
 	}
-
-	free(schema);
-	free(tabname);
 }
 
 static void
-dumpRemovePK(FILE *output, PQLTable *t)
+dumpRemovePK(PQLAlterTableCmds *at, PQLTable *t)
 {
-	char	*schema = formatObjectIdentifier(t->obj.schemaname);
-	char	*tabname = formatObjectIdentifier(t->obj.objectname);
-
-	fprintf(output, "\n\n");
-	fprintf(output, "ALTER TABLE ONLY %s.%s\n", schema, tabname);
-	fprintf(output, "\tDROP CONSTRAINT %s", t->pk.conname);
-	fprintf(output, ";");
-
-	free(schema);
-	free(tabname);
+	appendAlterTableCmd(&at->cmds, "DROP CONSTRAINT %s", t->pk.conname);
 }
 
 static void
-dumpAddFK(FILE *output, PQLTable *t, int i)
+dumpAddFK(PQLAlterTableCmds *at, PQLTable *t, int i)
 {
-	char	*schema = formatObjectIdentifier(t->obj.schemaname);
-	char	*tabname = formatObjectIdentifier(t->obj.objectname);
+	char	*schema = quotedName(t->obj.schemaname);
+	char	*tabname = quotedName(t->obj.objectname);
 
-	fprintf(output, "\n\n");
-	fprintf(output, "ALTER TABLE ONLY %s.%s\n", schema, tabname);
-	fprintf(output, "\tADD CONSTRAINT %s %s", t->fk[i].conname, t->fk[i].condef);
-	fprintf(output, ";");
+	/*
+	 * online: a NOT VALID constraint is added without scanning the table and
+	 * VALIDATE CONSTRAINT does not block writes. Partitioned tables do not
+	 * accept NOT VALID foreign keys.
+	 */
+	if (options.online && t->fk[i].convalidated &&
+			!PGQ_IS_PARTITIONED_TABLE(t->kind))
+	{
+		appendAlterTableCmd(&at->cmds, "ADD CONSTRAINT %s %s NOT VALID",
+							t->fk[i].conname, t->fk[i].condef);
+		appendAlterTableStmt(at, PGQ_COST_SCAN, "ALTER TABLE ONLY %s.%s VALIDATE CONSTRAINT %s;",
+							 schema, tabname, t->fk[i].conname);
+	}
+	else
+	{
+		appendAlterTableCmd(&at->cmds, "ADD CONSTRAINT %s %s", t->fk[i].conname,
+							t->fk[i].condef);
+		at->cost = Max(at->cost, PGQ_COST_SCAN);
+	}
 
 	if (options.comment)
 	{
 		if (t->fk[i].comment != NULL)
 		{
 			char	*fkname = formatObjectIdentifier(t->fk[i].conname);
+			char	*comment = formatComment(t->fk[i].comment);
 
-			fprintf(output, "\n\n");
-			fprintf(output, "COMMENT ON CONSTRAINT %s ON %s.%s IS %s;", fkname, schema,
-					tabname, t->fk[i].comment);
+			appendAlterTableCmd(&at->after, "COMMENT ON CONSTRAINT %s ON %s.%s IS %s;",
+								fkname, schema, tabname, comment);
 
 			free(fkname);
+			free(comment);
 		}
 	}
-
-	free(schema);
-	free(tabname);
 }
 
 static void
-dumpRemoveFK(FILE *output, PQLTable *t, int i)
+dumpRemoveFK(PQLAlterTableCmds *at, PQLTable *t, int i)
 {
-	char	*schema = formatObjectIdentifier(t->obj.schemaname);
-	char	*tabname = formatObjectIdentifier(t->obj.objectname);
-
-	fprintf(output, "\n\n");
-	fprintf(output, "ALTER TABLE ONLY %s.%s\n", schema, tabname);
-	fprintf(output, "\tDROP CONSTRAINT %s", t->fk[i].conname);
-	fprintf(output, ";");
-
-	free(schema);
-	free(tabname);
+	appendAlterTableCmd(&at->cmds, "DROP CONSTRAINT %s", t->fk[i].conname);
 }
 
+/*
+ * The partition is scanned to check the partition bound. If the table is
+ * not new, target is the same table in server 1.
+ */
 static void
-dumpAttachPartition(FILE *output, PQLTable *a)
+dumpAttachPartition(FILE *output, PQLTable *a, PQLTable *target)
 {
-	char	*schema = formatObjectIdentifier(a->obj.schemaname);
-	char	*tabname = formatObjectIdentifier(a->obj.objectname);
-	char	*parentschema = formatObjectIdentifier(a->parent[0].schemaname);
-	char	*parentname = formatObjectIdentifier(a->parent[0].objectname);
+	char	*schema = quotedName(a->obj.schemaname);
+	char	*tabname = quotedName(a->obj.objectname);
+	char	*parentschema = quotedName(a->parent[0].schemaname);
+	char	*parentname = quotedName(a->parent[0].objectname);
 
 	fprintf(output, "\n\n");
+	if (target != NULL)
+	{
+		char	*cost = formatCommandCost(target, PGQ_COST_SCAN);
+
+		fprintf(output, "%s", cost);
+		pfree(cost);
+	}
 	fprintf(output, "ALTER TABLE %s.%s ATTACH PARTITION %s.%s %s;", parentschema,
 			parentname, schema, tabname, a->partitionbound);
-
-	free(schema);
-	free(tabname);
-	free(parentschema);
-	free(parentname);
 }
 
 static void
 dumpDetachPartition(FILE *output, PQLTable *a)
 {
-	char	*schema = formatObjectIdentifier(a->obj.schemaname);
-	char	*tabname = formatObjectIdentifier(a->obj.objectname);
-	char	*parentschema = formatObjectIdentifier(a->parent[0].schemaname);
-	char	*parentname = formatObjectIdentifier(a->parent[0].objectname);
+	char	*schema = quotedName(a->obj.schemaname);
+	char	*tabname = quotedName(a->obj.objectname);
+	char	*parentschema = quotedName(a->parent[0].schemaname);
+	char	*parentname = quotedName(a->parent[0].objectname);
 
 	fprintf(output, "\n\n");
 	fprintf(output, "ALTER TABLE %s.%s DETACH PARTITION %s.%s;", parentschema,
 			parentname, schema, tabname);
-
-	free(schema);
-	free(tabname);
-	free(parentschema);
-	free(parentname);
 }
 
 void
 dumpAlterTable(FILE *output, PQLTable *a, PQLTable *b)
 {
-	char	*schema1 = formatObjectIdentifier(a->obj.schemaname);
-	char	*tabname1 = formatObjectIdentifier(a->obj.objectname);
-	char	*schema2 = formatObjectIdentifier(b->obj.schemaname);
-	char	*tabname2 = formatObjectIdentifier(b->obj.objectname);
+	char	*schema1 = quotedName(a->obj.schemaname);
+	char	*tabname1 = quotedName(a->obj.objectname);
+	char	*schema2 = quotedName(b->obj.schemaname);
+	char	*tabname2 = quotedName(b->obj.objectname);
 	char	*kind, *kindl;
+	PQLAlterTableCmds	at;
+	stringListCell		*cell, *next;
 	int		i, j;
 
 	if (PGQ_IS_REGULAR_OR_PARTITIONED_TABLE(b->kind))
@@ -2188,6 +2337,16 @@ dumpAlterTable(FILE *output, PQLTable *a, PQLTable *b)
 		exit(EXIT_FAILURE);
 	}
 
+	memset(&at, 0, sizeof(PQLAlterTableCmds));
+	at.target = a;
+	at.cost = PGQ_COST_METADATA;
+	at.columns = (int *) malloc(2 * (b->nattributes + 1) * sizeof(int));
+	if (at.columns == NULL)
+	{
+		logError("could not allocate memory");
+		exit(EXIT_FAILURE);
+	}
+
 	/* regular or foreign table */
 	if (a->reloftype.oid == InvalidOid && b->reloftype.oid == InvalidOid)
 	{
@@ -2205,10 +2364,11 @@ dumpAlterTable(FILE *output, PQLTable *a, PQLTable *b)
 						 kindl, b->obj.schemaname, b->obj.objectname,
 						 b->attributes[j].attname, b->attributes[j].atttypname);
 
-				dumpAddColumn(output, b, j);
+				dumpAddColumn(&at, b, j);
+				addAlterTableColumn(&at, -1, j);
 
-				dumpAlterColumnSetStatistics(output, b, j, false);	/* statistics target */
-				dumpAlterColumnSetStorage(output, b, j, false);		/* storage */
+				dumpAlterColumnSetStatistics(output, &at, b, j, false);	/* statistics target */
+				dumpAlterColumnSetStorage(output, &at, b, j, false);		/* storage */
 
 				j++;
 			}
@@ -2222,7 +2382,7 @@ dumpAlterTable(FILE *output, PQLTable *a, PQLTable *b)
 						 a->obj.schemaname,
 						 a->obj.objectname, a->attributes[i].attname, a->attributes[i].atttypname);
 
-				dumpRemoveColumn(output, a, i);
+				dumpRemoveColumn(&at, a, i);
 				i++;
 			}
 			else if (strcmp(a->attributes[i].attname, b->attributes[j].attname) == 0)
@@ -2236,37 +2396,21 @@ dumpAlterTable(FILE *output, PQLTable *a, PQLTable *b)
 				 *   - security labels
 				 *   - privileges
 				 */
-				dumpAlterColumn(output, a, i, b, j);
+				dumpAlterColumn(&at, a, i, b, j);
 
 				/* do attribute options change? */
-				dumpAlterColumnSetOptions(output, a, i, b, j);
+				dumpAlterColumnSetOptions(&at, a, i, b, j);
 
 				/* column statistics changed */
 				if (a->attributes[i].attstattarget != b->attributes[j].attstattarget)
-					dumpAlterColumnSetStatistics(output, b, j, true);
+					dumpAlterColumnSetStatistics(output, &at, b, j, true);
 
 				/* storage changed */
 				if (a->attributes[i].defstorage != b->attributes[j].defstorage)
-					dumpAlterColumnSetStorage(output, b, j, true);
+					dumpAlterColumnSetStorage(output, &at, b, j, true);
 
-				/* attribute ACL changed */
-				if (options.privileges)
-				{
-					char *attname = formatObjectIdentifier(a->attributes[i].attname);
-
-					if (a->attributes[i].acl != NULL && b->attributes[j].acl == NULL)
-						dumpGrantAndRevoke(output, PGQ_TABLE, &a->obj, &b->obj, a->attributes[i].acl,
-										   NULL, NULL, attname);
-					else if (a->attributes[i].acl == NULL && b->attributes[j].acl != NULL)
-						dumpGrantAndRevoke(output, PGQ_TABLE, &a->obj, &b->obj, NULL,
-										   b->attributes[j].acl, NULL, attname);
-					else if (a->attributes[i].acl != NULL && b->attributes[j].acl != NULL &&
-							 strcmp(a->attributes[i].acl, b->attributes[j].acl) != 0)
-						dumpGrantAndRevoke(output, PGQ_TABLE, &a->obj, &b->obj, a->attributes[i].acl,
-										   b->attributes[j].acl, NULL, attname);
-
-					free(attname);
-				}
+				/* comment, security labels and privileges (including ACL) */
+				addAlterTableColumn(&at, i, j);
 
 				i++;
 				j++;
@@ -2277,7 +2421,7 @@ dumpAlterTable(FILE *output, PQLTable *a, PQLTable *b)
 						 kindl, a->obj.schemaname, a->obj.objectname,
 						 a->attributes[i].attname, a->attributes[i].atttypname);
 
-				dumpRemoveColumn(output, a, i);
+				dumpRemoveColumn(&at, a, i);
 				i++;
 			}
 			else if (strcmp(a->attributes[i].attname, b->attributes[j].attname) > 0)
@@ -2286,10 +2430,11 @@ dumpAlterTable(FILE *output, PQLTable *a, PQLTable *b)
 						 kindl, b->obj.schemaname, b->obj.objectname,
 						 b->attributes[j].attname, b->attributes[j].atttypname);
 
-				dumpAddColumn(output, b, j);
+				dumpAddColumn(&at, b, j);
+				addAlterTableColumn(&at, -1, j);
 
-				dumpAlterColumnSetStatistics(output, b, j, false);	/* statistics target */
-				dumpAlterColumnSetStorage(output, b, j, false);		/* storage */
+				dumpAlterColumnSetStatistics(output, &at, b, j, false);	/* statistics target */
+				dumpAlterColumnSetStorage(output, &at, b, j, false);		/* storage */
 
 				j++;
 			}
@@ -2309,7 +2454,7 @@ dumpAlterTable(FILE *output, PQLTable *a, PQLTable *b)
 						 kindl, b->obj.schemaname, b->obj.objectname,
 						 b->fk[j].conname);
 
-				dumpAddFK(output, b, j);
+				dumpAddFK(&at, b, j);
 
 				j++;
 			}
@@ -2322,7 +2467,7 @@ dumpAlterTable(FILE *output, PQLTable *a, PQLTable *b)
 				logDebug("%s \"%s\".\"%s\" FK \"%s\" removed", kindl, a->obj.schemaname,
 						 a->obj.objectname, a->fk[i].conname);
 
-				dumpRemoveFK(output, a, i);
+				dumpRemoveFK(&at, a, i);
 				i++;
 			}
 			else if (strcmp(a->fk[i].conname, b->fk[j].conname) == 0)
@@ -2334,8 +2479,8 @@ dumpAlterTable(FILE *output, PQLTable *a, PQLTable *b)
 							 kindl, b->obj.schemaname, b->obj.objectname,
 							 b->fk[j].conname);
 
-					dumpRemoveFK(output, a, i);
-					dumpAddFK(output, b, j);
+					dumpRemoveFK(&at, a, i);
+					dumpAddFK(&at, b, j);
 				}
 
 				i++;
@@ -2347,7 +2492,7 @@ dumpAlterTable(FILE *output, PQLTable *a, PQLTable *b)
 						 kindl, a->obj.schemaname, a->obj.objectname,
 						 a->fk[i].conname);
 
-				dumpRemoveFK(output, a, i);
+				dumpRemoveFK(&at, a, i);
 				i++;
 			}
 			else if (strcmp(a->fk[i].conname, b->fk[j].conname) > 0)
@@ -2356,7 +2501,7 @@ dumpAlterTable(FILE *output, PQLTable *a, PQLTable *b)
 						 kindl, b->obj.schemaname, b->obj.objectname,
 						 b->fk[j].conname);
 
-				dumpAddFK(output, b, j);
+				dumpAddFK(&at, b, j);
 
 				j++;
 			}
@@ -2369,7 +2514,7 @@ dumpAlterTable(FILE *output, PQLTable *a, PQLTable *b)
 					 kindl, b->obj.schemaname, b->obj.objectname,
 					 b->pk.conname);
 
-			dumpAddPK(output, b);
+			dumpAddPK(&at, b);
 		}
 		else if (a->pk.conname != NULL && b->pk.conname == NULL)
 		{
@@ -2377,7 +2522,7 @@ dumpAlterTable(FILE *output, PQLTable *a, PQLTable *b)
 					 kindl, a->obj.schemaname, a->obj.objectname,
 					 a->pk.conname);
 
-			dumpRemovePK(output, a);
+			dumpRemovePK(&at, a);
 		}
 		else if (a->pk.conname != NULL && b->pk.conname != NULL &&
 				 strcmp(a->pk.condef, b->pk.condef) != 0)
@@ -2386,8 +2531,8 @@ dumpAlterTable(FILE *output, PQLTable *a, PQLTable *b)
 					 kindl, b->obj.schemaname, b->obj.objectname,
 					 b->pk.conname);
 
-			dumpRemovePK(output, a);
-			dumpAddPK(output, b);
+			dumpRemovePK(&at, a);
+			dumpAddPK(&at, b);
 		}
 	}
 	else
@@ -2395,21 +2540,13 @@ dumpAlterTable(FILE *output, PQLTable *a, PQLTable *b)
 		/* typed table */
 		if (a->reloftype.oid == InvalidOid && b->reloftype.oid != InvalidOid)
 		{
-			char	*typeschema = formatObjectIdentifier(b->reloftype.schemaname);
-			char	*typename = formatObjectIdentifier(b->reloftype.objectname);
+			char	*typeschema = quotedName(b->reloftype.schemaname);
+			char	*typename = quotedName(b->reloftype.objectname);
 
-			fprintf(output, "\n\n");
-			fprintf(output, "ALTER TABLE ONLY %s.%s OF %s.%s;", schema2, tabname2,
-					typeschema, typename);
-
-			free(typeschema);
-			free(typename);
+			appendAlterTableCmd(&at.cmds, "OF %s.%s", typeschema, typename);
 		}
 		else if (a->reloftype.oid != InvalidOid && b->reloftype.oid == InvalidOid)
-		{
-			fprintf(output, "\n\n");
-			fprintf(output, "ALTER TABLE ONLY %s.%s NOT OF;", schema2, tabname2);
-		}
+			appendAlterTableCmd(&at.cmds, "NOT OF");
 		else
 		{
 			/* TODO check if it is safe to change the type of a typed table */
@@ -2425,22 +2562,12 @@ dumpAlterTable(FILE *output, PQLTable *a, PQLTable *b)
 		logWarning("partitioned table %s.%s cannot be converted to regular table",
 				   schema1, tabname1);
 
-	/* partition */
-	if (!a->partition && b->partition)
-		dumpAttachPartition(output, b);
-	else if (a->partition && !b->partition)
-		dumpDetachPartition(output, a);
-
 	/* reloptions */
 	if (a->reloptions == NULL && b->reloptions != NULL)
-	{
-		fprintf(output, "\n\n");
-		fprintf(output, "ALTER %s %s.%s SET (%s);", kind, schema2, tabname2,
-				b->reloptions);
-	}
+		appendAlterTableCmd(&at.cmds, "SET (%s)", b->reloptions);
 	else if (a->reloptions != NULL && b->reloptions == NULL)
 	{
-		stringList	*rlist;
+		PQLOptionSet	*rlist;
 
 		rlist = setOperationOptions(a->reloptions, b->reloptions, PGQ_SETDIFFERENCE,
 									false, true);
@@ -2449,18 +2576,16 @@ dumpAlterTable(FILE *output, PQLTable *a, PQLTable *b)
 			char	*resetlist;
 
 			resetlist = printOptions(rlist);
-			fprintf(output, "\n\n");
-			fprintf(output, "ALTER %s %s.%s RESET (%s);", kind, schema2, tabname2,
-					resetlist);
+			appendAlterTableCmd(&at.cmds, "RESET (%s)", resetlist);
 
 			free(resetlist);
-			freeStringList(rlist);
+			freeOptionSet(rlist);
 		}
 	}
 	else if (a->reloptions != NULL && b->reloptions != NULL &&
 			 strcmp(a->reloptions, b->reloptions) != 0)
 	{
-		stringList	*rlist, *ilist, *slist;
+		PQLOptionSet	*rlist, *ilist, *slist;
 
 		rlist = setOperationOptions(a->reloptions, b->reloptions, PGQ_SETDIFFERENCE,
 									false, true);
@@ -2469,12 +2594,10 @@ dumpAlterTable(FILE *output, PQLTable *a, PQLTable *b)
 			char	*resetlist;
 
 			resetlist = printOptions(rlist);
-			fprintf(output, "\n\n");
-			fprintf(output, "ALTER %s %s.%s RESET (%s);", kind, schema2, tabname2,
-					resetlist);
+			appendAlterTableCmd(&at.cmds, "RESET (%s)", resetlist);
 
 			free(resetlist);
-			freeStringList(rlist);
+			freeOptionSet(rlist);
 		}
 
 		/*
@@ -2488,11 +2611,10 @@ dumpAlterTable(FILE *output, PQLTable *a, PQLTable *b)
 			char	*setlist;
 
 			setlist = printOptions(ilist);
-			fprintf(output, "\n\n");
-			fprintf(output, "ALTER %s %s.%s SET (%s);", kind, schema2, tabname2, setlist);
+			appendAlterTableCmd(&at.cmds, "SET (%s)", setlist);
 
 			free(setlist);
-			freeStringList(ilist);
+			freeOptionSet(ilist);
 		}
 
 		/*
@@ -2505,11 +2627,10 @@ dumpAlterTable(FILE *output, PQLTable *a, PQLTable *b)
 			char	*setlist;
 
 			setlist = printOptions(slist);
-			fprintf(output, "\n\n");
-			fprintf(output, "ALTER %s %s.%s SET (%s);", kind, schema2, tabname2, setlist);
+			appendAlterTableCmd(&at.cmds, "SET (%s)", setlist);
 
 			free(setlist);
-			freeStringList(slist);
+			freeOptionSet(slist);
 		}
 	}
 
@@ -2527,25 +2648,18 @@ dumpAlterTable(FILE *output, PQLTable *a, PQLTable *b)
 			{
 					char	*replident;
 				case 'n':
-					fprintf(output, "\n\n");
-					fprintf(output, "ALTER TABLE ONLY %s.%s REPLICA IDENTITY NOTHING;", schema2,
-							tabname2);
+					appendAlterTableCmd(&at.cmds, "REPLICA IDENTITY NOTHING");
 					break;
 				case 'd':
-					fprintf(output, "\n\n");
-					fprintf(output, "ALTER TABLE ONLY %s.%s REPLICA IDENTITY DEFAULT;", schema2,
-							tabname2);
+					appendAlterTableCmd(&at.cmds, "REPLICA IDENTITY DEFAULT");
 					break;
 				case 'f':
-					fprintf(output, "\n\n");
-					fprintf(output, "ALTER TABLE ONLY %s.%s REPLICA IDENTITY FULL;", schema2,
-							tabname2);
+					appendAlterTableCmd(&at.cmds, "REPLICA IDENTITY FULL");
 					break;
 				case 'i':
 					replident = formatObjectIdentifier(b->relreplidentidx);
-					fprintf(output, "\n\n");
-					fprintf(output, "ALTER TABLE ONLY %s.%s REPLICA IDENTITY USING INDEX %s;",
-							schema2, tabname2, replident);
+					appendAlterTableCmd(&at.cmds, "REPLICA IDENTITY USING INDEX %s",
+										replident);
 					free(replident);
 					break;
 				default:
@@ -2561,6 +2675,29 @@ dumpAlterTable(FILE *output, PQLTable *a, PQLTable *b)
 	else
 		logWarning("ignoring replica identity because some server does not support it");
 
+	/* all subcommands above in a single statement */
+	dumpAlterTableCmds(output, a, b, &at);
+
+	for (cell = at.cmds.head; cell; cell = next)
+	{
+		next = cell->next;
+		free(cell->value);
+		free(cell);
+	}
+	for (cell = at.after.head; cell; cell = next)
+	{
+		next = cell->next;
+		free(cell->value);
+		free(cell);
+	}
+	free(at.columns);
+
+	/* ATTACH and DETACH PARTITION cannot be combined with other subcommands */
+	if (!a->partition && b->partition)
+		dumpAttachPartition(output, b, a);
+	else if (a->partition && !b->partition)
+		dumpDetachPartition(output, a);
+
 	/* comment */
 	if (options.comment)
 	{
@@ -2569,8 +2706,9 @@ dumpAlterTable(FILE *output, PQLTable *a, PQLTable *b)
 				 strcmp(a->comment, b->comment) != 0))
 		{
 			fprintf(output, "\n\n");
-			fprintf(output, "COMMENT ON %s %s.%s IS %s;", kind, schema2, tabname2,
-					b->comment);
+			fprintf(output, "COMMENT ON %s %s.%s IS ", kind, schema2, tabname2);
+			printComment(output, b->comment);
+			fprintf(output, ";");
 		}
 		else if (a->comment != NULL && b->comment == NULL)
 		{
@@ -2678,12 +2816,10 @@ dumpAlterTable(FILE *output, PQLTable *a, PQLTable *b)
 	{
 		if (strcmp(a->owner, b->owner) != 0)
 		{
-			char	*owner = formatObjectIdentifier(b->owner);
+			char	*owner = quotedName(b->owner);
 
 			fprintf(output, "\n\n");
 			fprintf(output, "ALTER %s %s.%s OWNER TO %s;", kind, schema2, tabname2, owner);
-
-			free(owner);
 		}
 	}
 
@@ -2697,8 +2833,4 @@ dumpAlterTable(FILE *output, PQLTable *a, PQLTable *b)
 
 	free(kind);
 	free(kindl);
-	free(schema1);
-	free(tabname1);
-	free(schema2);
-	free(tabname2);
 }
@@ -9,8 +9,10 @@
 #ifndef TABLE_H
 #define TABLE_H
 
+#include "comment.h"
 #include "common.h"
 #include "privileges.h"
+#include "seclabel.h"
 
 typedef struct PQLTable
 {
@@ -37,6 +39,7 @@ typedef struct PQLTable
 	int				nownedby;
 
 	char			*reloptions;
+	int64			relsize;	/* bytes or -1 (see getTableSizes) */
 	char			relreplident;
 	char			*relreplidentidx;
 
@@ -69,17 +72,17 @@ PQLTable *getRegularTables(PGconn *c, int *n);
 PQLTable *getForeignTables(PGconn *c, int *n);
 
 void getForeignTableProperties(PGconn *c, PQLTable *t, int n);
-void getTableAttributes(PGconn *c, PQLTable *t);
-void getOwnedBySequences(PGconn *c, PQLTable *t);
+void getTableAttributes(PGconn *c, PQLTable **t, int n);
+void getOwnedBySequences(PGconn *c, PQLTable **t, int n);
+void getTableSizes(PGconn *c, PQLTable **t, int n);
 void getCheckConstraints(PGconn *c, PQLTable *t, int n);
 void getFKConstraints(PGconn *c, PQLTable *t, int n);
 void getPKConstraints(PGconn *c, PQLTable *t, int n);
-void getTableSecurityLabels(PGconn *c, PQLTable *t);
+void getTableSecurityLabels(PGconn *c, PQLTable **t, int n);
 
 void dumpDropTable(FILE *output, PQLTable *t);
 void dumpCreateTable(FILE *output, FILE *output2, PQLTable *t);
 void dumpAlterTable(FILE *output, PQLTable *a, PQLTable *b);
 
-void freeTables(PQLTable *t, int n);
 
 #endif	/* TABLE_H */
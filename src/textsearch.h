@@ -9,6 +9,7 @@
 #ifndef TEXTSEARCH_H
 #define TEXTSEARCH_H
 
+#include "comment.h"
 #include "common.h"
 
 typedef struct PQLTextSearchConfig
@@ -73,9 +74,5 @@ void dumpAlterTextSearchParser(FILE *output, PQLTextSearchParser *a,
 void dumpAlterTextSearchTemplate(FILE *output, PQLTextSearchTemplate *a,
 								 PQLTextSearchTemplate *b);
 
-void freeTextSearchConfigs(PQLTextSearchConfig *t, int n);
-void freeTextSearchDicts(PQLTextSearchDict *t, int n);
-void freeTextSearchParsers(PQLTextSearchParser *t, int n);
-void freeTextSearchTemplates(PQLTextSearchTemplate *t, int n);
 
 #endif
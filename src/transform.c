@@ -25,17 +25,17 @@ getTransforms(PGconn *c, int *n)
 	PGresult		*res;
 	int				i;
 
-	logNoise("transform: server version: %d", PQserverVersion(c));
+	logNoise("transform: server version: %d", getServerVersion(c));
 
 	/* bail out if we do not support it */
-	if (PQserverVersion(c) < 90500)
+	if (getServerVersion(c) < 90500)
 	{
 		logWarning("ignoring transforms because server does not support it");
 		return NULL;
 	}
 
-	res = PQexec(c,
-				 "SELECT t.oid, n.nspname AS typschema, y.typname AS typname, (SELECT lanname FROM pg_language WHERE oid = t.trflang) AS lanname, p.oid AS fromsqloid, x.nspname AS fromsqlschema, p.proname AS fromsqlname, pg_get_function_arguments(t.trffromsql) AS fromsqlargs, q.oid AS tosqloid, z.nspname AS tosqlschema, q.proname AS tosqlname, pg_get_function_arguments(t.trftosql) AS tosqlargs, obj_description(t.oid, 'pg_transform') AS description FROM pg_transform t INNER JOIN pg_type y ON (t.trftype = y.oid) INNER JOIN pg_namespace n ON (n.oid = y.typnamespace) LEFT JOIN pg_proc p ON (t.trffromsql = p.oid) LEFT JOIN pg_namespace x ON (x.oid = p.pronamespace) LEFT JOIN pg_proc q ON (t.trftosql = q.oid) LEFT JOIN pg_namespace z ON (z.oid = q.pronamespace) ORDER BY typschema, typname, lanname");
+	res = execQuery(c,
+				 "SELECT t.oid, n.nspname AS typschema, y.typname AS typname, (SELECT lanname FROM pg_language WHERE oid = t.trflang) AS lanname, p.oid AS fromsqloid, x.nspname AS fromsqlschema, p.proname AS fromsqlname, pg_get_function_arguments(t.trffromsql) AS fromsqlargs, q.oid AS tosqloid, z.nspname AS tosqlschema, q.proname AS tosqlname, pg_get_function_arguments(t.trftosql) AS tosqlargs FROM pg_transform t INNER JOIN pg_type y ON (t.trftype = y.oid) INNER JOIN pg_namespace n ON (n.oid = y.typnamespace) LEFT JOIN pg_proc p ON (t.trffromsql = p.oid) LEFT JOIN pg_namespace x ON (x.oid = p.pronamespace) LEFT JOIN pg_proc q ON (t.trftosql = q.oid) LEFT JOIN pg_namespace z ON (z.oid = q.pronamespace) ORDER BY typschema, typname, lanname");
 
 	if (PQresultStatus(res) != PGRES_TUPLES_OK)
 	{
@@ -48,7 +48,7 @@ getTransforms(PGconn *c, int *n)
 
 	*n = PQntuples(res);
 	if (*n > 0)
-		t = (PQLTransform *) malloc(*n * sizeof(PQLTransform));
+		t = (PQLTransform *) arenaAlloc(*n * sizeof(PQLTransform));
 	else
 		t = NULL;
 
@@ -56,13 +56,11 @@ getTransforms(PGconn *c, int *n)
 
 	for (i = 0; i < *n; i++)
 	{
-		char	*withoutescape;
-
 		t[i].trftype.oid = strtoul(PQgetvalue(res, i, PQfnumber(res, "oid")), NULL, 10);
-		t[i].trftype.schemaname = strdup(PQgetvalue(res, i, PQfnumber(res,
+		t[i].trftype.schemaname = internName(PQgetvalue(res, i, PQfnumber(res,
 										 "typschema")));
-		t[i].trftype.objectname = strdup(PQgetvalue(res, i, PQfnumber(res, "typname")));
-		t[i].languagename = strdup(PQgetvalue(res, i, PQfnumber(res, "lanname")));
+		t[i].trftype.objectname = internName(PQgetvalue(res, i, PQfnumber(res, "typname")));
+		t[i].languagename = arenaStrdup(PQgetvalue(res, i, PQfnumber(res, "lanname")));
 
 		if (PQgetisnull(res, i, PQfnumber(res, "fromsqlname")))
 		{
@@ -74,11 +72,11 @@ getTransforms(PGconn *c, int *n)
 		{
 			t[i].fromsql.oid = strtoul(PQgetvalue(res, i, PQfnumber(res, "fromsqloid")),
 									   NULL, 10);
-			t[i].fromsql.schemaname = strdup(PQgetvalue(res, i, PQfnumber(res,
+			t[i].fromsql.schemaname = internName(PQgetvalue(res, i, PQfnumber(res,
 											 "fromsqlschema")));
-			t[i].fromsql.objectname = strdup(PQgetvalue(res, i, PQfnumber(res,
+			t[i].fromsql.objectname = internName(PQgetvalue(res, i, PQfnumber(res,
 											 "fromsqlname")));
-			t[i].fromsqlargs = strdup(PQgetvalue(res, i, PQfnumber(res, "fromsqlargs")));
+			t[i].fromsqlargs = arenaStrdup(PQgetvalue(res, i, PQfnumber(res, "fromsqlargs")));
 		}
 
 		if (PQgetisnull(res, i, PQfnumber(res, "tosqlname")))
@@ -91,27 +89,13 @@ getTransforms(PGconn *c, int *n)
 		{
 			t[i].tosql.oid = strtoul(PQgetvalue(res, i, PQfnumber(res, "tosqloid")), NULL,
 									 10);
-			t[i].tosql.schemaname = strdup(PQgetvalue(res, i, PQfnumber(res,
+			t[i].tosql.schemaname = internName(PQgetvalue(res, i, PQfnumber(res,
 										   "tosqlschema")));
-			t[i].tosql.objectname = strdup(PQgetvalue(res, i, PQfnumber(res, "tosqlname")));
-			t[i].tosqlargs = strdup(PQgetvalue(res, i, PQfnumber(res, "tosqlargs")));
+			t[i].tosql.objectname = internName(PQgetvalue(res, i, PQfnumber(res, "tosqlname")));
+			t[i].tosqlargs = arenaStrdup(PQgetvalue(res, i, PQfnumber(res, "tosqlargs")));
 		}
 
-		if (PQgetisnull(res, i, PQfnumber(res, "description")))
-			t[i].comment = NULL;
-		else
-		{
-			withoutescape = PQgetvalue(res, i, PQfnumber(res, "description"));
-			t[i].comment = PQescapeLiteral(c, withoutescape, strlen(withoutescape));
-			if (t[i].comment == NULL)
-			{
-				logError("escaping comment failed: %s", PQerrorMessage(c));
-				PQclear(res);
-				PQfinish(c);
-				/* XXX leak another connection? */
-				exit(EXIT_FAILURE);
-			}
-		}
+		t[i].comment = getComment(PGQ_CLASS_TRANSFORM, t[i].trftype.oid, 0);
 
 		logDebug("transform for type \"%s\".\"%s\" language \"%s\"",
 				 t[i].trftype.schemaname, t[i].trftype.objectname, t[i].languagename);
@@ -122,59 +106,25 @@ getTransforms(PGconn *c, int *n)
 	return t;
 }
 
-void
-freeTransforms(PQLTransform *t, int n)
-{
-	if (n > 0)
-	{
-		int i;
-
-		for (i = 0; i < n; i++)
-		{
-			free(t[i].trftype.schemaname);
-			free(t[i].trftype.objectname);
-			free(t[i].languagename);
-			if (t[i].fromsql.schemaname)
-				free(t[i].fromsql.schemaname);
-			if (t[i].fromsql.objectname)
-				free(t[i].fromsql.objectname);
-			if (t[i].fromsqlargs)
-				free(t[i].fromsqlargs);
-			if (t[i].tosql.schemaname)
-				free(t[i].tosql.schemaname);
-			if (t[i].tosql.objectname)
-				free(t[i].tosql.objectname);
-			if (t[i].tosqlargs)
-				free(t[i].tosqlargs);
-			if (t[i].comment)
-				PQfreemem(t[i].comment);
-		}
-
-		free(t);
-	}
-}
-
 void
 dumpDropTransform(FILE *output, PQLTransform *t)
 {
-	char	*typeschema = formatObjectIdentifier(t->trftype.schemaname);
-	char	*typename = formatObjectIdentifier(t->trftype.objectname);
+	char	*typeschema = quotedName(t->trftype.schemaname);
+	char	*typename = quotedName(t->trftype.objectname);
 	char	*langname = formatObjectIdentifier(t->languagename);
 
 	fprintf(output, "\n\n");
 	fprintf(output, "DROP TRANSFORM FOR %s.%s LANGUAGE %s;", typeschema, typename,
 			langname);
 
-	free(typeschema);
-	free(typename);
 	free(langname);
 }
 
 void
 dumpCreateTransform(FILE *output, PQLTransform *t)
 {
-	char	*typeschema = formatObjectIdentifier(t->trftype.schemaname);
-	char	*typename = formatObjectIdentifier(t->trftype.objectname);
+	char	*typeschema = quotedName(t->trftype.schemaname);
+	char	*typename = quotedName(t->trftype.objectname);
 	char	*langname = formatObjectIdentifier(t->languagename);
 	char	*fromsqlschema = NULL;
 	char	*fromsqlname = NULL;
@@ -203,12 +153,12 @@ dumpCreateTransform(FILE *output, PQLTransform *t)
 	if (options.comment && t->comment != NULL)
 	{
 		fprintf(output, "\n\n");
-		fprintf(output, "COMMENT ON TRANSFORM FOR %s.%s LANGUAGE %s IS %s;", typeschema,
-				typename, langname, t->comment);
+		fprintf(output, "COMMENT ON TRANSFORM FOR %s.%s LANGUAGE %s IS ", typeschema,
+				typename, langname);
+		printComment(output, t->comment);
+		fprintf(output, ";");
 	}
 
-	free(typeschema);
-	free(typename);
 	free(langname);
 	if (fromsqlschema)
 		free(fromsqlschema);
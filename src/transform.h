@@ -9,6 +9,7 @@
 #ifndef TRANSFORM_H
 #define TRANSFORM_H
 
+#include "comment.h"
 #include "common.h"
 
 typedef struct PQLTransform
@@ -28,6 +29,5 @@ void dumpDropTransform(FILE *output, PQLTransform *t);
 void dumpCreateTransform(FILE *output, PQLTransform *t);
 void dumpAlterTransform(FILE *output, PQLTransform *a, PQLTransform *b);
 
-void freeTransforms(PQLTransform *t, int n);
 
 #endif	/* TRANSFORM_H */
@@ -27,11 +27,11 @@ getTriggers(PGconn *c, int *n)
 	PGresult	*res;
 	int			i;
 
-	logNoise("trigger: server version: %d", PQserverVersion(c));
+	logNoise("trigger: server version: %d", getServerVersion(c));
 
-	query = psprintf("SELECT t.oid, t.tgname AS trgname, n.nspname AS nspname, c.relname AS relname, pg_get_triggerdef(t.oid, false) AS trgdef, obj_description(t.oid, 'pg_rewrite') AS description FROM pg_trigger t INNER JOIN pg_class c ON (t.tgrelid = c.oid) INNER JOIN pg_namespace n ON (c.relnamespace = n.oid) WHERE NOT tgisinternal %s%s ORDER BY nspname, relname, trgname", include_schema_str, exclude_schema_str);
+	query = psprintf("SELECT t.oid, t.tgname AS trgname, n.nspname AS nspname, c.relname AS relname, pg_get_triggerdef(t.oid, false) AS trgdef FROM pg_trigger t INNER JOIN pg_class c ON (t.tgrelid = c.oid) INNER JOIN pg_namespace n ON (c.relnamespace = n.oid) WHERE NOT tgisinternal %s%s ORDER BY nspname, relname, trgname", include_schema_str, exclude_schema_str);
 
-	res = PQexec(c, query);
+	res = execQuery(c, query);
 
 	pfree(query);
 
@@ -46,7 +46,7 @@ getTriggers(PGconn *c, int *n)
 
 	*n = PQntuples(res);
 	if (*n > 0)
-		t = (PQLTrigger *) malloc(*n * sizeof(PQLTrigger));
+		t = (PQLTrigger *) arenaAlloc(*n * sizeof(PQLTrigger));
 	else
 		t = NULL;
 
@@ -54,28 +54,12 @@ getTriggers(PGconn *c, int *n)
 
 	for (i = 0; i < *n; i++)
 	{
-		char	*withoutescape;
-
 		t[i].oid = strtoul(PQgetvalue(res, i, PQfnumber(res, "oid")), NULL, 10);
-		t[i].trgname = strdup(PQgetvalue(res, i, PQfnumber(res, "trgname")));
-		t[i].table.schemaname = strdup(PQgetvalue(res, i, PQfnumber(res, "nspname")));
-		t[i].table.objectname = strdup(PQgetvalue(res, i, PQfnumber(res, "relname")));
-		t[i].trgdef = strdup(PQgetvalue(res, i, PQfnumber(res, "trgdef")));
-		if (PQgetisnull(res, i, PQfnumber(res, "description")))
-			t[i].comment = NULL;
-		else
-		{
-			withoutescape = PQgetvalue(res, i, PQfnumber(res, "description"));
-			t[i].comment = PQescapeLiteral(c, withoutescape, strlen(withoutescape));
-			if (t[i].comment == NULL)
-			{
-				logError("escaping comment failed: %s", PQerrorMessage(c));
-				PQclear(res);
-				PQfinish(c);
-				/* XXX leak another connection? */
-				exit(EXIT_FAILURE);
-			}
-		}
+		t[i].trgname = arenaStrdup(PQgetvalue(res, i, PQfnumber(res, "trgname")));
+		t[i].table.schemaname = internName(PQgetvalue(res, i, PQfnumber(res, "nspname")));
+		t[i].table.objectname = internName(PQgetvalue(res, i, PQfnumber(res, "relname")));
+		t[i].trgdef = arenaStrdup(PQgetvalue(res, i, PQfnumber(res, "trgdef")));
+		t[i].comment = getComment(PGQ_CLASS_TRIGGER, t[i].oid, 0);
 
 		logDebug("trigger \"%s\" on \"%s\".\"%s\"", t[i].trgname, t[i].table.schemaname,
 				 t[i].table.objectname);
@@ -86,33 +70,12 @@ getTriggers(PGconn *c, int *n)
 	return t;
 }
 
-void
-freeTriggers(PQLTrigger *t, int n)
-{
-	if (n > 0)
-	{
-		int	i;
-
-		for (i = 0; i < n; i++)
-		{
-			free(t[i].trgname);
-			free(t[i].table.schemaname);
-			free(t[i].table.objectname);
-			free(t[i].trgdef);
-			if (t[i].comment)
-				PQfreemem(t[i].comment);
-		}
-
-		free(t);
-	}
-}
-
 void
 dumpCreateTrigger(FILE *output, PQLTrigger *t)
 {
 	char	*trgname = formatObjectIdentifier(t->trgname);
-	char	*schema = formatObjectIdentifier(t->table.schemaname);
-	char	*tabname = formatObjectIdentifier(t->table.objectname);
+	char	*schema = quotedName(t->table.schemaname);
+	char	*tabname = quotedName(t->table.objectname);
 
 	fprintf(output, "\n\n");
 	fprintf(output, "%s;", t->trgdef);
@@ -121,28 +84,26 @@ dumpCreateTrigger(FILE *output, PQLTrigger *t)
 	if (options.comment && t->comment != NULL)
 	{
 		fprintf(output, "\n\n");
-		fprintf(output, "COMMENT ON TRIGGER %s ON %s.%s IS %s;", trgname, schema,
-				tabname, t->comment);
+		fprintf(output, "COMMENT ON TRIGGER %s ON %s.%s IS ", trgname, schema,
+				tabname);
+		printComment(output, t->comment);
+		fprintf(output, ";");
 	}
 
 	free(trgname);
-	free(schema);
-	free(tabname);
 }
 
 void
 dumpDropTrigger(FILE *output, PQLTrigger *t)
 {
 	char	*trgname = formatObjectIdentifier(t->trgname);
-	char	*schema = formatObjectIdentifier(t->table.schemaname);
-	char	*tabname = formatObjectIdentifier(t->table.objectname);
+	char	*schema = quotedName(t->table.schemaname);
+	char	*tabname = quotedName(t->table.objectname);
 
 	fprintf(output, "\n\n");
 	fprintf(output, "DROP TRIGGER %s ON %s.%s;", trgname, schema, tabname);
 
 	free(trgname);
-	free(schema);
-	free(tabname);
 }
 
 void
@@ -150,8 +111,8 @@ dumpAlterTrigger(FILE *output, PQLTrigger *a, PQLTrigger *b)
 {
 	char	*trgname1 = formatObjectIdentifier(a->trgname);
 	char	*trgname2 = formatObjectIdentifier(b->trgname);
-	char	*schema2 = formatObjectIdentifier(b->table.schemaname);
-	char	*tabname2 = formatObjectIdentifier(b->table.objectname);
+	char	*schema2 = quotedName(b->table.schemaname);
+	char	*tabname2 = quotedName(b->table.objectname);
 
 	/* comment */
 	if (options.comment)
@@ -161,8 +122,10 @@ dumpAlterTrigger(FILE *output, PQLTrigger *a, PQLTrigger *b)
 				 strcmp(a->comment, b->comment) != 0))
 		{
 			fprintf(output, "\n\n");
-			fprintf(output, "COMMENT ON TRIGGER %s ON %s.%s IS %s;", trgname2, schema2,
-					tabname2, b->comment);
+			fprintf(output, "COMMENT ON TRIGGER %s ON %s.%s IS ", trgname2, schema2,
+					tabname2);
+			printComment(output, b->comment);
+			fprintf(output, ";");
 		}
 		else if (a->comment != NULL && b->comment == NULL)
 		{
@@ -174,6 +137,4 @@ dumpAlterTrigger(FILE *output, PQLTrigger *a, PQLTrigger *b)
 
 	free(trgname1);
 	free(trgname2);
-	free(schema2);
-	free(tabname2);
 }
@@ -9,6 +9,7 @@
 #ifndef TRIGGER_H
 #define TRIGGER_H
 
+#include "comment.h"
 #include "common.h"
 
 typedef struct PQLTrigger
@@ -26,6 +27,5 @@ void dumpDropTrigger(FILE *output, PQLTrigger *t);
 void dumpCreateTrigger(FILE *output, PQLTrigger *t);
 void dumpAlterTrigger(FILE *output, PQLTrigger *a, PQLTrigger *b);
 
-void freeTriggers(PQLTrigger *t, int n);
 
 #endif	/* TRIGGER_H */
@@ -27,8 +27,8 @@
 #include "type.h"
 
 
-static void getCompositeTypeAttributes(PGconn *c, PQLCompositeType *t);
-static void getEnumTypeLabels(PGconn *c, PQLEnumType *t);
+static void getCompositeTypeAttributes(PGconn *c, PQLCompositeType *t, int n);
+static void getEnumTypeLabels(PGconn *c, PQLEnumType *t, int n);
 
 
 PQLBaseType *
@@ -39,27 +39,27 @@ getBaseTypes(PGconn *c, int *n)
 	PGresult		*res;
 	int				i;
 
-	logNoise("base type: server version: %d", PQserverVersion(c));
+	logNoise("base type: server version: %d", getServerVersion(c));
 
-	if (PQserverVersion(c) >= 140000)
+	if (getServerVersion(c) >= 140000)
 	{
-		query = psprintf("SELECT t.oid, n.nspname, t.typname, typlen AS length, typinput AS input, typoutput AS output, typreceive AS receive, typsend AS send, typmodin AS modin, typmodout AS modout, typanalyze AS analyze, typsubscript AS subscript, (typcollation <> 0) as collatable, typdefault, typcategory AS category, typispreferred AS preferred, typdelim AS delimiter, typalign AS align, typstorage AS storage, typbyval AS byvalue, obj_description(t.oid, 'pg_type') AS description, pg_get_userbyid(t.typowner) AS typowner, typacl FROM pg_type t INNER JOIN pg_namespace n ON (t.typnamespace = n.oid) WHERE t.typtype = 'b' AND (t.typrelid = 0 OR (SELECT c.relkind = 'c' FROM pg_catalog.pg_class c WHERE c.oid = t.typrelid)) AND NOT EXISTS(SELECT 1 FROM pg_catalog.pg_type el WHERE el.oid = t.typelem AND el.typarray = t.oid) AND n.nspname !~ '^pg_' AND n.nspname <> 'information_schema' %s%s AND NOT EXISTS(SELECT 1 FROM pg_depend d WHERE t.oid = d.objid AND d.deptype = 'e') ORDER BY n.nspname, t.typname", include_schema_str, exclude_schema_str);
+		query = psprintf("SELECT t.oid, n.nspname, t.typname, typlen AS length, typinput AS input, typoutput AS output, typreceive AS receive, typsend AS send, typmodin AS modin, typmodout AS modout, typanalyze AS analyze, typsubscript AS subscript, (typcollation <> 0) as collatable, typdefault, typcategory AS category, typispreferred AS preferred, typdelim AS delimiter, typalign AS align, typstorage AS storage, typbyval AS byvalue, pg_get_userbyid(t.typowner) AS typowner, typacl FROM pg_type t INNER JOIN pg_namespace n ON (t.typnamespace = n.oid) WHERE t.typtype = 'b' AND (t.typrelid = 0 OR (SELECT c.relkind = 'c' FROM pg_catalog.pg_class c WHERE c.oid = t.typrelid)) AND NOT EXISTS(SELECT 1 FROM pg_catalog.pg_type el WHERE el.oid = t.typelem AND el.typarray = t.oid) AND n.nspname !~ '^pg_' AND n.nspname <> 'information_schema' %s%s AND NOT EXISTS(SELECT 1 FROM pg_depend d WHERE t.oid = d.objid AND d.deptype = 'e') ORDER BY n.nspname, t.typname", include_schema_str, exclude_schema_str);
 	}
-	else if (PQserverVersion(c) >= 90200)		/* support for privileges on data types */
+	else if (getServerVersion(c) >= 90200)		/* support for privileges on data types */
 	{
-		query = psprintf("SELECT t.oid, n.nspname, t.typname, typlen AS length, typinput AS input, typoutput AS output, typreceive AS receive, typsend AS send, typmodin AS modin, typmodout AS modout, typanalyze AS analyze, '-' AS subscript, (typcollation <> 0) as collatable, typdefault, typcategory AS category, typispreferred AS preferred, typdelim AS delimiter, typalign AS align, typstorage AS storage, typbyval AS byvalue, obj_description(t.oid, 'pg_type') AS description, pg_get_userbyid(t.typowner) AS typowner, typacl FROM pg_type t INNER JOIN pg_namespace n ON (t.typnamespace = n.oid) WHERE t.typtype = 'b' AND (t.typrelid = 0 OR (SELECT c.relkind = 'c' FROM pg_catalog.pg_class c WHERE c.oid = t.typrelid)) AND NOT EXISTS(SELECT 1 FROM pg_catalog.pg_type el WHERE el.oid = t.typelem AND el.typarray = t.oid) AND n.nspname !~ '^pg_' AND n.nspname <> 'information_schema' %s%s AND NOT EXISTS(SELECT 1 FROM pg_depend d WHERE t.oid = d.objid AND d.deptype = 'e') ORDER BY n.nspname, t.typname", include_schema_str, exclude_schema_str);
+		query = psprintf("SELECT t.oid, n.nspname, t.typname, typlen AS length, typinput AS input, typoutput AS output, typreceive AS receive, typsend AS send, typmodin AS modin, typmodout AS modout, typanalyze AS analyze, '-' AS subscript, (typcollation <> 0) as collatable, typdefault, typcategory AS category, typispreferred AS preferred, typdelim AS delimiter, typalign AS align, typstorage AS storage, typbyval AS byvalue, pg_get_userbyid(t.typowner) AS typowner, typacl FROM pg_type t INNER JOIN pg_namespace n ON (t.typnamespace = n.oid) WHERE t.typtype = 'b' AND (t.typrelid = 0 OR (SELECT c.relkind = 'c' FROM pg_catalog.pg_class c WHERE c.oid = t.typrelid)) AND NOT EXISTS(SELECT 1 FROM pg_catalog.pg_type el WHERE el.oid = t.typelem AND el.typarray = t.oid) AND n.nspname !~ '^pg_' AND n.nspname <> 'information_schema' %s%s AND NOT EXISTS(SELECT 1 FROM pg_depend d WHERE t.oid = d.objid AND d.deptype = 'e') ORDER BY n.nspname, t.typname", include_schema_str, exclude_schema_str);
 	}
-	else if (PQserverVersion(c) >= 90100)	/* extension support */
+	else if (getServerVersion(c) >= 90100)	/* extension support */
 	{
 		/* typcollation is new in 9.1 */
-		query = psprintf("SELECT t.oid, n.nspname, t.typname, typlen AS length, typinput AS input, typoutput AS output, typreceive AS receive, typsend AS send, typmodin AS modin, typmodout AS modout, typanalyze AS analyze, '-' AS subscript, (typcollation <> 0) as collatable, typdefault, typcategory AS category, typispreferred AS preferred, typdelim AS delimiter, typalign AS align, typstorage AS storage, typbyval AS byvalue, obj_description(t.oid, 'pg_type') AS description, pg_get_userbyid(t.typowner) AS typowner, NULL AS typacl FROM pg_type t INNER JOIN pg_namespace n ON (t.typnamespace = n.oid) WHERE t.typtype = 'b' AND (t.typrelid = 0 OR (SELECT c.relkind = 'c' FROM pg_catalog.pg_class c WHERE c.oid = t.typrelid)) AND NOT EXISTS(SELECT 1 FROM pg_catalog.pg_type el WHERE el.oid = t.typelem AND el.typarray = t.oid) AND n.nspname !~ '^pg_' AND n.nspname <> 'information_schema' %s%s AND NOT EXISTS(SELECT 1 FROM pg_depend d WHERE t.oid = d.objid AND d.deptype = 'e') ORDER BY n.nspname, t.typname", include_schema_str, exclude_schema_str);
+		query = psprintf("SELECT t.oid, n.nspname, t.typname, typlen AS length, typinput AS input, typoutput AS output, typreceive AS receive, typsend AS send, typmodin AS modin, typmodout AS modout, typanalyze AS analyze, '-' AS subscript, (typcollation <> 0) as collatable, typdefault, typcategory AS category, typispreferred AS preferred, typdelim AS delimiter, typalign AS align, typstorage AS storage, typbyval AS byvalue, pg_get_userbyid(t.typowner) AS typowner, NULL AS typacl FROM pg_type t INNER JOIN pg_namespace n ON (t.typnamespace = n.oid) WHERE t.typtype = 'b' AND (t.typrelid = 0 OR (SELECT c.relkind = 'c' FROM pg_catalog.pg_class c WHERE c.oid = t.typrelid)) AND NOT EXISTS(SELECT 1 FROM pg_catalog.pg_type el WHERE el.oid = t.typelem AND el.typarray = t.oid) AND n.nspname !~ '^pg_' AND n.nspname <> 'information_schema' %s%s AND NOT EXISTS(SELECT 1 FROM pg_depend d WHERE t.oid = d.objid AND d.deptype = 'e') ORDER BY n.nspname, t.typname", include_schema_str, exclude_schema_str);
 	}
 	else
 	{
-		query = psprintf("SELECT t.oid, n.nspname, t.typname, typlen AS length, typinput AS input, typoutput AS output, typreceive AS receive, typsend AS send, typmodin AS modin, typmodout AS modout, typanalyze AS analyze, '-' AS subscript, false AS collatable, typdefault, typcategory AS category, typispreferred AS preferred, typdelim AS delimiter, typalign AS align, typstorage AS storage, typbyval AS byvalue, obj_description(t.oid, 'pg_type') AS description, pg_get_userbyid(t.typowner) AS typowner, NULL AS typacl FROM pg_type t INNER JOIN pg_namespace n ON (t.typnamespace = n.oid) WHERE t.typtype = 'b' AND (t.typrelid = 0 OR (SELECT c.relkind = 'c' FROM pg_catalog.pg_class c WHERE c.oid = t.typrelid)) AND NOT EXISTS(SELECT 1 FROM pg_catalog.pg_type el WHERE el.oid = t.typelem AND el.typarray = t.oid) AND n.nspname !~ '^pg_' AND n.nspname <> 'information_schema' %s%s ORDER BY n.nspname, t.typname", include_schema_str, exclude_schema_str);
+		query = psprintf("SELECT t.oid, n.nspname, t.typname, typlen AS length, typinput AS input, typoutput AS output, typreceive AS receive, typsend AS send, typmodin AS modin, typmodout AS modout, typanalyze AS analyze, '-' AS subscript, false AS collatable, typdefault, typcategory AS category, typispreferred AS preferred, typdelim AS delimiter, typalign AS align, typstorage AS storage, typbyval AS byvalue, pg_get_userbyid(t.typowner) AS typowner, NULL AS typacl FROM pg_type t INNER JOIN pg_namespace n ON (t.typnamespace = n.oid) WHERE t.typtype = 'b' AND (t.typrelid = 0 OR (SELECT c.relkind = 'c' FROM pg_catalog.pg_class c WHERE c.oid = t.typrelid)) AND NOT EXISTS(SELECT 1 FROM pg_catalog.pg_type el WHERE el.oid = t.typelem AND el.typarray = t.oid) AND n.nspname !~ '^pg_' AND n.nspname <> 'information_schema' %s%s ORDER BY n.nspname, t.typname", include_schema_str, exclude_schema_str);
 	}
 
-	res = PQexec(c, query);
+	res = execQuery(c, query);
 
 	pfree(query);
 
@@ -74,7 +74,7 @@ getBaseTypes(PGconn *c, int *n)
 
 	*n = PQntuples(res);
 	if (*n > 0)
-		t = (PQLBaseType *) malloc(*n * sizeof(PQLBaseType));
+		t = (PQLBaseType *) arenaAlloc(*n * sizeof(PQLBaseType));
 	else
 		t = NULL;
 
@@ -82,58 +82,42 @@ getBaseTypes(PGconn *c, int *n)
 
 	for (i = 0; i < *n; i++)
 	{
-		char	*withoutescape;
-
 		t[i].obj.oid = strtoul(PQgetvalue(res, i, PQfnumber(res, "oid")), NULL, 10);
-		t[i].obj.schemaname = strdup(PQgetvalue(res, i, PQfnumber(res, "nspname")));
-		t[i].obj.objectname = strdup(PQgetvalue(res, i, PQfnumber(res, "typname")));
+		t[i].obj.schemaname = internName(PQgetvalue(res, i, PQfnumber(res, "nspname")));
+		t[i].obj.objectname = internName(PQgetvalue(res, i, PQfnumber(res, "typname")));
 		t[i].length = atoi(PQgetvalue(res, i, PQfnumber(res, "length")));
-		t[i].input = strdup(PQgetvalue(res, i, PQfnumber(res, "input")));
-		t[i].output = strdup(PQgetvalue(res, i, PQfnumber(res, "output")));
-		t[i].receive = strdup(PQgetvalue(res, i, PQfnumber(res, "receive")));
-		t[i].send = strdup(PQgetvalue(res, i, PQfnumber(res, "send")));
-		t[i].modin = strdup(PQgetvalue(res, i, PQfnumber(res, "modin")));
-		t[i].modout = strdup(PQgetvalue(res, i, PQfnumber(res, "modout")));
-		t[i].analyze = strdup(PQgetvalue(res, i, PQfnumber(res, "analyze")));
-		t[i].subscript = strdup(PQgetvalue(res, i, PQfnumber(res, "subscript")));
+		t[i].input = arenaStrdup(PQgetvalue(res, i, PQfnumber(res, "input")));
+		t[i].output = arenaStrdup(PQgetvalue(res, i, PQfnumber(res, "output")));
+		t[i].receive = arenaStrdup(PQgetvalue(res, i, PQfnumber(res, "receive")));
+		t[i].send = arenaStrdup(PQgetvalue(res, i, PQfnumber(res, "send")));
+		t[i].modin = arenaStrdup(PQgetvalue(res, i, PQfnumber(res, "modin")));
+		t[i].modout = arenaStrdup(PQgetvalue(res, i, PQfnumber(res, "modout")));
+		t[i].analyze = arenaStrdup(PQgetvalue(res, i, PQfnumber(res, "analyze")));
+		t[i].subscript = arenaStrdup(PQgetvalue(res, i, PQfnumber(res, "subscript")));
 		t[i].collatable = (PQgetvalue(res, i, PQfnumber(res, "collatable"))[0] == 't');
 		if (PQgetisnull(res, i, PQfnumber(res, "typdefault")))
 			t[i].typdefault = NULL;
 		else
-			t[i].typdefault = strdup(PQgetvalue(res, i, PQfnumber(res, "typdefault")));
-		t[i].category = strdup(PQgetvalue(res, i, PQfnumber(res, "category")));
+			t[i].typdefault = arenaStrdup(PQgetvalue(res, i, PQfnumber(res, "typdefault")));
+		t[i].category = arenaStrdup(PQgetvalue(res, i, PQfnumber(res, "category")));
 		t[i].preferred = (PQgetvalue(res, i, PQfnumber(res, "preferred"))[0] == 't');
-		t[i].delimiter = strdup(PQgetvalue(res, i, PQfnumber(res, "delimiter")));
-		t[i].align = strdup(PQgetvalue(res, i, PQfnumber(res, "align")));
-		t[i].storage = strdup(PQgetvalue(res, i, PQfnumber(res, "storage")));
+		t[i].delimiter = arenaStrdup(PQgetvalue(res, i, PQfnumber(res, "delimiter")));
+		t[i].align = arenaStrdup(PQgetvalue(res, i, PQfnumber(res, "align")));
+		t[i].storage = arenaStrdup(PQgetvalue(res, i, PQfnumber(res, "storage")));
 		t[i].byvalue = (PQgetvalue(res, i, PQfnumber(res, "byvalue"))[0] == 't');
 
-		if (PQgetisnull(res, i, PQfnumber(res, "description")))
-			t[i].comment = NULL;
-		else
-		{
-			withoutescape = PQgetvalue(res, i, PQfnumber(res, "description"));
-			t[i].comment = PQescapeLiteral(c, withoutescape, strlen(withoutescape));
-			if (t[i].comment == NULL)
-			{
-				logError("escaping comment failed: %s", PQerrorMessage(c));
-				PQclear(res);
-				PQfinish(c);
-				/* XXX leak another connection? */
-				exit(EXIT_FAILURE);
-			}
-		}
+		t[i].comment = getComment(PGQ_CLASS_TYPE, t[i].obj.oid, 0);
 
-		t[i].owner = strdup(PQgetvalue(res, i, PQfnumber(res, "typowner")));
+		t[i].owner = internName(PQgetvalue(res, i, PQfnumber(res, "typowner")));
 		if (PQgetisnull(res, i, PQfnumber(res, "typacl")))
 			t[i].acl = NULL;
 		else
-			t[i].acl = strdup(PQgetvalue(res, i, PQfnumber(res, "typacl")));
+			t[i].acl = arenaStrdup(PQgetvalue(res, i, PQfnumber(res, "typacl")));
 
 		/*
 		 * Security labels are not assigned here (see getBaseTypeSecurityLabels),
 		 * but default values are essential to avoid having trouble in
-		 * freeBaseTypes.
+		 * the dump routines.
 		 */
 		t[i].nseclabels = 0;
 		t[i].seclabels = NULL;
@@ -147,129 +131,91 @@ getBaseTypes(PGconn *c, int *n)
 }
 
 void
-getBaseTypeSecurityLabels(PGconn *c, PQLBaseType *t)
+getBaseTypeSecurityLabels(PGconn *c, PQLBaseType *t, int n)
 {
-	char		*query;
-	PGresult	*res;
 	int			i;
 
-	if (PQserverVersion(c) < 90100)
+	if (n == 0)
+		return;
+
+	if (getServerVersion(c) < 90100)
 	{
 		logWarning("ignoring security labels because server does not support it");
 		return;
 	}
 
-	/*
-	 * Don't bother to check the kind of type because can't be duplicated oids
-	 * in the same catalog.
-	 */
-	query = psprintf("SELECT provider, label FROM pg_seclabel s INNER JOIN pg_class c ON (s.classoid = c.oid) WHERE c.relname = 'pg_type' AND s.objoid = %u ORDER BY provider", t->obj.oid);
-
-	res = PQexec(c, query);
-
-	pfree(query);
-
-	if (PQresultStatus(res) != PGRES_TUPLES_OK)
+	for (i = 0; i < n; i++)
 	{
-		logError("query failed: %s", PQresultErrorMessage(res));
-		PQclear(res);
-		PQfinish(c);
-		/* XXX leak another connection? */
-		exit(EXIT_FAILURE);
-	}
-
-	t->nseclabels = PQntuples(res);
-	if (t->nseclabels > 0)
-		t->seclabels = (PQLSecLabel *) malloc(t->nseclabels * sizeof(PQLSecLabel));
-	else
-		t->seclabels = NULL;
-
-	logDebug("number of security labels in base type \"%s\".\"%s\": %d",
-			 t->obj.schemaname, t->obj.objectname, t->nseclabels);
+		t[i].nseclabels = getObjectSecurityLabels(c, PGQ_CLASS_TYPE,
+							  t[i].obj.oid, 0, &t[i].seclabels);
 
-	for (i = 0; i < t->nseclabels; i++)
-	{
-		char	*withoutescape;
-
-		t->seclabels[i].provider = strdup(PQgetvalue(res, i, PQfnumber(res,
-										  "provider")));
-		withoutescape = PQgetvalue(res, i, PQfnumber(res, "label"));
-		t->seclabels[i].label = PQescapeLiteral(c, withoutescape,
-												strlen(withoutescape));
-		if (t->seclabels[i].label == NULL)
-		{
-			logError("escaping label failed: %s", PQerrorMessage(c));
-			PQclear(res);
-			PQfinish(c);
-			/* XXX leak another connection? */
-			exit(EXIT_FAILURE);
-		}
+		logDebug("number of security labels in base type \"%s\".\"%s\": %d",
+				 t[i].obj.schemaname, t[i].obj.objectname, t[i].nseclabels);
 	}
-
-	PQclear(res);
 }
 
 /* TODO composite type column comments */
 static void
-getCompositeTypeAttributes(PGconn *c, PQLCompositeType *t)
+getCompositeTypeAttributes(PGconn *c, PQLCompositeType *t, int n)
 {
-	char		*query;
-	PGresult	*res;
-	int			i;
+	char		**queries;
+	PGresult	**res;
+	int			i, j;
 
-	/* typcollation is new in 9.1 */
-	if (PQserverVersion(c) >= 90100)	/* extension support */
-	{
-		query = psprintf("SELECT a.attname, format_type(a.atttypid, a.atttypmod) AS attdefinition, p.nspname AS collschemaname, CASE WHEN a.attcollation <> u.typcollation THEN l.collname ELSE NULL END AS collname FROM pg_type t INNER JOIN pg_attribute a ON (a.attrelid = t.typrelid) LEFT JOIN pg_type u ON (u.oid = a.atttypid) LEFT JOIN (pg_collation l LEFT JOIN pg_namespace p ON (l.collnamespace = p.oid)) ON (a.attcollation = l.oid) WHERE t.oid = %u AND NOT EXISTS(SELECT 1 FROM pg_depend d WHERE t.oid = d.objid AND d.deptype = 'e') ORDER BY a.attnum", t->obj.oid);
-	}
-	else
+	if (n == 0)
+		return;
+
+	queries = (char **) malloc(n * sizeof(char *));
+	for (i = 0; i < n; i++)
 	{
-		query = psprintf("SELECT a.attname, format_type(a.atttypid, a.atttypmod) AS attdefinition, NULL AS collschemaname, NULL AS collname FROM pg_type t INNER JOIN pg_attribute a ON (a.attrelid = t.typrelid) WHERE t.oid = %u ORDER BY a.attnum", t->obj.oid);
+		/* typcollation is new in 9.1 */
+		if (getServerVersion(c) >= 90100)	/* extension support */
+		{
+			queries[i] = psprintf("SELECT a.attname, format_type(a.atttypid, a.atttypmod) AS attdefinition, p.nspname AS collschemaname, CASE WHEN a.attcollation <> u.typcollation THEN l.collname ELSE NULL END AS collname FROM pg_type t INNER JOIN pg_attribute a ON (a.attrelid = t.typrelid) LEFT JOIN pg_type u ON (u.oid = a.atttypid) LEFT JOIN (pg_collation l LEFT JOIN pg_namespace p ON (l.collnamespace = p.oid)) ON (a.attcollation = l.oid) WHERE t.oid = %u AND NOT EXISTS(SELECT 1 FROM pg_depend d WHERE t.oid = d.objid AND d.deptype = 'e') ORDER BY a.attnum", t[i].obj.oid);
+		}
+		else
+		{
+			queries[i] = psprintf("SELECT a.attname, format_type(a.atttypid, a.atttypmod) AS attdefinition, NULL AS collschemaname, NULL AS collname FROM pg_type t INNER JOIN pg_attribute a ON (a.attrelid = t.typrelid) WHERE t.oid = %u ORDER BY a.attnum", t[i].obj.oid);
+		}
 	}
 
-	res = PQexec(c, query);
+	res = execQueries(c, queries, n);
 
-	pfree(query);
-
-	if (PQresultStatus(res) != PGRES_TUPLES_OK)
+	for (i = 0; i < n; i++)
 	{
-		logError("query failed: %s", PQresultErrorMessage(res));
-		PQclear(res);
-		PQfinish(c);
-		/* XXX leak another connection? */
-		exit(EXIT_FAILURE);
-	}
+		t[i].nattributes = PQntuples(res[i]);
+		if (t[i].nattributes > 0)
+			t[i].attributes = (PQLAttrCompositeType *) arenaAlloc(t[i].nattributes * sizeof(
+								PQLAttrCompositeType));
+		else
+			t[i].attributes = NULL;
 
-	t->nattributes = PQntuples(res);
-	if (t->nattributes > 0)
-		t->attributes = (PQLAttrCompositeType *) malloc(t->nattributes * sizeof(
-							PQLAttrCompositeType));
-	else
-		t->attributes = NULL;
+		logDebug("number of attributes on composite type \"%s\".\"%s\": %d",
+				 t[i].obj.schemaname, t[i].obj.objectname, t[i].nattributes);
 
-	logDebug("number of attributes on composite type \"%s\".\"%s\": %d",
-			 t->obj.schemaname, t->obj.objectname, t->nattributes);
+		for (j = 0; j < t[i].nattributes; j++)
+		{
+			t[i].attributes[j].attname = arenaStrdup(PQgetvalue(res[i], j, PQfnumber(res[i],
+											  "attname")));
+			t[i].attributes[j].typname = arenaStrdup(PQgetvalue(res[i], j, PQfnumber(res[i],
+											  "attdefinition")));
+			/* collation can be NULL in 9.0 or earlier */
+			if (PQgetisnull(res[i], j, PQfnumber(res[i], "collschemaname")))
+				t[i].attributes[j].collschemaname = NULL;
+			else
+				t[i].attributes[j].collschemaname = internName(PQgetvalue(res[i], j, PQfnumber(res[i],
+												  "collschemaname")));
+			if (PQgetisnull(res[i], j, PQfnumber(res[i], "collname")))
+				t[i].attributes[j].collname = NULL;
+			else
+				t[i].attributes[j].collname = arenaStrdup(PQgetvalue(res[i], j, PQfnumber(res[i],
+												   "collname")));
+		}
 
-	for (i = 0; i < t->nattributes; i++)
-	{
-		t->attributes[i].attname = strdup(PQgetvalue(res, i, PQfnumber(res,
-										  "attname")));
-		t->attributes[i].typname = strdup(PQgetvalue(res, i, PQfnumber(res,
-										  "attdefinition")));
-		/* collation can be NULL in 9.0 or earlier */
-		if (PQgetisnull(res, i, PQfnumber(res, "collschemaname")))
-			t->attributes[i].collschemaname = NULL;
-		else
-			t->attributes[i].collschemaname = strdup(PQgetvalue(res, i, PQfnumber(res,
-											  "collschemaname")));
-		if (PQgetisnull(res, i, PQfnumber(res, "collname")))
-			t->attributes[i].collname = NULL;
-		else
-			t->attributes[i].collname = strdup(PQgetvalue(res, i, PQfnumber(res,
-											   "collname")));
+		PQclear(res[i]);
 	}
 
-	PQclear(res);
+	free(res);
 }
 
 PQLCompositeType *
@@ -280,22 +226,22 @@ getCompositeTypes(PGconn *c, int *n)
 	PGresult			*res;
 	int					i;
 
-	logNoise("composite type: server version: %d", PQserverVersion(c));
+	logNoise("composite type: server version: %d", getServerVersion(c));
 
-	if (PQserverVersion(c) >= 90200)	/* support for privileges on data types */
+	if (getServerVersion(c) >= 90200)	/* support for privileges on data types */
 	{
-		query = psprintf("SELECT t.oid, n.nspname, t.typname, obj_description(t.oid, 'pg_type') AS description, pg_get_userbyid(t.typowner) AS typowner, typacl FROM pg_type t INNER JOIN pg_namespace n ON (t.typnamespace = n.oid) WHERE t.typtype = 'c' AND (t.typrelid = 0 OR (SELECT c.relkind = 'c' FROM pg_catalog.pg_class c WHERE c.oid = t.typrelid)) AND NOT EXISTS(SELECT 1 FROM pg_catalog.pg_type el WHERE el.oid = t.typelem AND el.typarray = t.oid) AND n.nspname !~ '^pg_' AND n.nspname <> 'information_schema' %s%s AND NOT EXISTS(SELECT 1 FROM pg_depend d WHERE t.oid = d.objid AND d.deptype = 'e') ORDER BY n.nspname, t.typname", include_schema_str, exclude_schema_str);
+		query = psprintf("SELECT t.oid, n.nspname, t.typname, pg_get_userbyid(t.typowner) AS typowner, typacl FROM pg_type t INNER JOIN pg_namespace n ON (t.typnamespace = n.oid) WHERE t.typtype = 'c' AND (t.typrelid = 0 OR (SELECT c.relkind = 'c' FROM pg_catalog.pg_class c WHERE c.oid = t.typrelid)) AND NOT EXISTS(SELECT 1 FROM pg_catalog.pg_type el WHERE el.oid = t.typelem AND el.typarray = t.oid) AND n.nspname !~ '^pg_' AND n.nspname <> 'information_schema' %s%s AND NOT EXISTS(SELECT 1 FROM pg_depend d WHERE t.oid = d.objid AND d.deptype = 'e') ORDER BY n.nspname, t.typname", include_schema_str, exclude_schema_str);
 	}
-	else if (PQserverVersion(c) >= 90100)	/* extension support */
+	else if (getServerVersion(c) >= 90100)	/* extension support */
 	{
-		query = psprintf("SELECT t.oid, n.nspname, t.typname, obj_description(t.oid, 'pg_type') AS description, pg_get_userbyid(t.typowner) AS typowner, NULL AS typacl FROM pg_type t INNER JOIN pg_namespace n ON (t.typnamespace = n.oid) WHERE t.typtype = 'c' AND (t.typrelid = 0 OR (SELECT c.relkind = 'c' FROM pg_catalog.pg_class c WHERE c.oid = t.typrelid)) AND NOT EXISTS(SELECT 1 FROM pg_catalog.pg_type el WHERE el.oid = t.typelem AND el.typarray = t.oid) AND n.nspname !~ '^pg_' AND n.nspname <> 'information_schema' %s%s AND NOT EXISTS(SELECT 1 FROM pg_depend d WHERE t.oid = d.objid AND d.deptype = 'e') ORDER BY n.nspname, t.typname", include_schema_str, exclude_schema_str);
+		query = psprintf("SELECT t.oid, n.nspname, t.typname, pg_get_userbyid(t.typowner) AS typowner, NULL AS typacl FROM pg_type t INNER JOIN pg_namespace n ON (t.typnamespace = n.oid) WHERE t.typtype = 'c' AND (t.typrelid = 0 OR (SELECT c.relkind = 'c' FROM pg_catalog.pg_class c WHERE c.oid = t.typrelid)) AND NOT EXISTS(SELECT 1 FROM pg_catalog.pg_type el WHERE el.oid = t.typelem AND el.typarray = t.oid) AND n.nspname !~ '^pg_' AND n.nspname <> 'information_schema' %s%s AND NOT EXISTS(SELECT 1 FROM pg_depend d WHERE t.oid = d.objid AND d.deptype = 'e') ORDER BY n.nspname, t.typname", include_schema_str, exclude_schema_str);
 	}
 	else
 	{
-		query = psprintf("SELECT t.oid, n.nspname, t.typname, obj_description(t.oid, 'pg_type') AS description, pg_get_userbyid(t.typowner) AS typowner, NULL AS typacl FROM pg_type t INNER JOIN pg_namespace n ON (t.typnamespace = n.oid) WHERE t.typtype = 'c' AND (t.typrelid = 0 OR (SELECT c.relkind = 'c' FROM pg_catalog.pg_class c WHERE c.oid = t.typrelid)) AND NOT EXISTS(SELECT 1 FROM pg_catalog.pg_type el WHERE el.oid = t.typelem AND el.typarray = t.oid) AND n.nspname !~ '^pg_' AND n.nspname <> 'information_schema' %s%s ORDER BY n.nspname, t.typname", include_schema_str, exclude_schema_str);
+		query = psprintf("SELECT t.oid, n.nspname, t.typname, pg_get_userbyid(t.typowner) AS typowner, NULL AS typacl FROM pg_type t INNER JOIN pg_namespace n ON (t.typnamespace = n.oid) WHERE t.typtype = 'c' AND (t.typrelid = 0 OR (SELECT c.relkind = 'c' FROM pg_catalog.pg_class c WHERE c.oid = t.typrelid)) AND NOT EXISTS(SELECT 1 FROM pg_catalog.pg_type el WHERE el.oid = t.typelem AND el.typarray = t.oid) AND n.nspname !~ '^pg_' AND n.nspname <> 'information_schema' %s%s ORDER BY n.nspname, t.typname", include_schema_str, exclude_schema_str);
 	}
 
-	res = PQexec(c, query);
+	res = execQuery(c, query);
 
 	pfree(query);
 
@@ -310,7 +256,7 @@ getCompositeTypes(PGconn *c, int *n)
 
 	*n = PQntuples(res);
 	if (*n > 0)
-		t = (PQLCompositeType *) malloc(*n * sizeof(PQLCompositeType));
+		t = (PQLCompositeType *) arenaAlloc(*n * sizeof(PQLCompositeType));
 	else
 		t = NULL;
 
@@ -318,156 +264,102 @@ getCompositeTypes(PGconn *c, int *n)
 
 	for (i = 0; i < *n; i++)
 	{
-		char	*withoutescape;
-
 		t[i].obj.oid = strtoul(PQgetvalue(res, i, PQfnumber(res, "oid")), NULL, 10);
-		t[i].obj.schemaname = strdup(PQgetvalue(res, i, PQfnumber(res, "nspname")));
-		t[i].obj.objectname = strdup(PQgetvalue(res, i, PQfnumber(res, "typname")));
+		t[i].obj.schemaname = internName(PQgetvalue(res, i, PQfnumber(res, "nspname")));
+		t[i].obj.objectname = internName(PQgetvalue(res, i, PQfnumber(res, "typname")));
 
-		if (PQgetisnull(res, i, PQfnumber(res, "description")))
-			t[i].comment = NULL;
-		else
-		{
-			withoutescape = PQgetvalue(res, i, PQfnumber(res, "description"));
-			t[i].comment = PQescapeLiteral(c, withoutescape, strlen(withoutescape));
-			if (t[i].comment == NULL)
-			{
-				logError("escaping comment failed: %s", PQerrorMessage(c));
-				PQclear(res);
-				PQfinish(c);
-				/* XXX leak another connection? */
-				exit(EXIT_FAILURE);
-			}
-		}
+		t[i].comment = getComment(PGQ_CLASS_TYPE, t[i].obj.oid, 0);
 
-		t[i].owner = strdup(PQgetvalue(res, i, PQfnumber(res, "typowner")));
+		t[i].owner = internName(PQgetvalue(res, i, PQfnumber(res, "typowner")));
 		if (PQgetisnull(res, i, PQfnumber(res, "typacl")))
 			t[i].acl = NULL;
 		else
-			t[i].acl = strdup(PQgetvalue(res, i, PQfnumber(res, "typacl")));
+			t[i].acl = arenaStrdup(PQgetvalue(res, i, PQfnumber(res, "typacl")));
 
 		/*
 		 * Security labels are not assigned here (see getCompositeTypeSecurityLabels),
 		 * but default values are essential to avoid having trouble in
-		 * freeCompositeTypes.
+		 * the dump routines.
 		 */
 		t[i].nseclabels = 0;
 		t[i].seclabels = NULL;
 
-		/* fill composite type attributes */
-		getCompositeTypeAttributes(c, &t[i]);
-
 		logDebug("composite type \"%s\".\"%s\"", t[i].obj.schemaname,
 				 t[i].obj.objectname);
 	}
 
 	PQclear(res);
 
+	/* fill composite type attributes */
+	getCompositeTypeAttributes(c, t, *n);
+
 	return t;
 }
 
 void
-getCompositeTypeSecurityLabels(PGconn *c, PQLCompositeType *t)
+getCompositeTypeSecurityLabels(PGconn *c, PQLCompositeType *t, int n)
 {
-	char		*query;
-	PGresult	*res;
 	int			i;
 
-	if (PQserverVersion(c) < 90100)
+	if (n == 0)
+		return;
+
+	if (getServerVersion(c) < 90100)
 	{
 		logWarning("ignoring security labels because server does not support it");
 		return;
 	}
 
-	/*
-	 * Don't bother to check the kind of type because can't be duplicated oids
-	 * in the same catalog.
-	 */
-	query = psprintf("SELECT provider, label FROM pg_seclabel s INNER JOIN pg_class c ON (s.classoid = c.oid) WHERE c.relname = 'pg_type' AND s.objoid = %u ORDER BY provider", t->obj.oid);
-
-	res = PQexec(c, query);
-
-	pfree(query);
-
-	if (PQresultStatus(res) != PGRES_TUPLES_OK)
+	for (i = 0; i < n; i++)
 	{
-		logError("query failed: %s", PQresultErrorMessage(res));
-		PQclear(res);
-		PQfinish(c);
-		/* XXX leak another connection? */
-		exit(EXIT_FAILURE);
-	}
-
-	t->nseclabels = PQntuples(res);
-	if (t->nseclabels > 0)
-		t->seclabels = (PQLSecLabel *) malloc(t->nseclabels * sizeof(PQLSecLabel));
-	else
-		t->seclabels = NULL;
+		t[i].nseclabels = getObjectSecurityLabels(c, PGQ_CLASS_TYPE,
+							  t[i].obj.oid, 0, &t[i].seclabels);
 
-	logDebug("number of security labels in composite type \"%s\".\"%s\": %d",
-			 t->obj.schemaname, t->obj.objectname, t->nseclabels);
-
-	for (i = 0; i < t->nseclabels; i++)
-	{
-		char	*withoutescape;
-
-		t->seclabels[i].provider = strdup(PQgetvalue(res, i, PQfnumber(res,
-										  "provider")));
-		withoutescape = PQgetvalue(res, i, PQfnumber(res, "label"));
-		t->seclabels[i].label = PQescapeLiteral(c, withoutescape,
-												strlen(withoutescape));
-		if (t->seclabels[i].label == NULL)
-		{
-			logError("escaping label failed: %s", PQerrorMessage(c));
-			PQclear(res);
-			PQfinish(c);
-			/* XXX leak another connection? */
-			exit(EXIT_FAILURE);
-		}
+		logDebug("number of security labels in composite type \"%s\".\"%s\": %d",
+				 t[i].obj.schemaname, t[i].obj.objectname, t[i].nseclabels);
 	}
-
-	PQclear(res);
 }
 
 static void
-getEnumTypeLabels(PGconn *c, PQLEnumType *t)
+getEnumTypeLabels(PGconn *c, PQLEnumType *t, int n)
 {
-	char		*query;
-	PGresult	*res;
-	int			i;
+	char		**queries;
+	PGresult	**res;
+	int			i, j;
 
-	/* enumsortorder is new in 9.1 */
-	if (PQserverVersion(c) >= 90100)
-		query = psprintf("SELECT enumlabel FROM pg_enum WHERE enumtypid = %u ORDER BY enumsortorder", t->obj.oid);
-	else
-		query = psprintf("SELECT enumlabel FROM pg_enum WHERE enumtypid = %u ORDER BY oid", t->obj.oid);
+	if (n == 0)
+		return;
 
-	res = PQexec(c, query);
+	queries = (char **) malloc(n * sizeof(char *));
+	for (i = 0; i < n; i++)
+	{
+		/* enumsortorder is new in 9.1 */
+		if (getServerVersion(c) >= 90100)
+			queries[i] = psprintf("SELECT enumlabel FROM pg_enum WHERE enumtypid = %u ORDER BY enumsortorder", t[i].obj.oid);
+		else
+			queries[i] = psprintf("SELECT enumlabel FROM pg_enum WHERE enumtypid = %u ORDER BY oid", t[i].obj.oid);
+	}
 
-	pfree(query);
+	res = execQueries(c, queries, n);
 
-	if (PQresultStatus(res) != PGRES_TUPLES_OK)
+	for (i = 0; i < n; i++)
 	{
-		logError("query failed: %s", PQresultErrorMessage(res));
-		PQclear(res);
-		PQfinish(c);
-		/* XXX leak another connection? */
-		exit(EXIT_FAILURE);
-	}
+		t[i].nlabels = PQntuples(res[i]);
+		if (t[i].nlabels > 0)
+			t[i].labels = (char **) arenaAlloc(t[i].nlabels * sizeof(char *));
+		else
+			t[i].labels = NULL;
 
-	t->nlabels = PQntuples(res);
-	if (t->nlabels > 0)
-		t->labels = (char **) malloc(t->nlabels * sizeof(char *));
-	else
-		t->labels = NULL;
+		logDebug("number of labels on enum type \"%s\".\"%s\": %d", t[i].obj.schemaname,
+				 t[i].obj.objectname, t[i].nlabels);
 
-	logDebug("number of labels on enum type \"%s\".\"%s\": %d", t->obj.schemaname,
-			 t->obj.objectname, t->nlabels);
+		for (j = 0; j < t[i].nlabels; j++)
+			t[i].labels[j] = arenaStrdup(PQgetvalue(res[i], j, PQfnumber(res[i], "enumlabel")));
 
-	for (i = 0; i < t->nlabels; i++)
-		t->labels[i] = strdup(PQgetvalue(res, i, PQfnumber(res, "enumlabel")));
+		PQclear(res[i]);
+	}
 
-	PQclear(res);
+	free(res);
 }
 
 PQLEnumType *
@@ -478,22 +370,22 @@ getEnumTypes(PGconn *c, int *n)
 	PGresult		*res;
 	int				i;
 
-	logNoise("enum type: server version: %d", PQserverVersion(c));
+	logNoise("enum type: server version: %d", getServerVersion(c));
 
-	if (PQserverVersion(c) >= 90200)		/* support for privileges on data types */
+	if (getServerVersion(c) >= 90200)		/* support for privileges on data types */
 	{
-		query = psprintf("SELECT t.oid, n.nspname, t.typname, obj_description(t.oid, 'pg_type') AS description, pg_get_userbyid(t.typowner) AS typowner, typacl FROM pg_type t INNER JOIN pg_namespace n ON (t.typnamespace = n.oid) WHERE t.typtype = 'e' AND n.nspname !~ '^pg_' AND n.nspname <> 'information_schema' %s%s AND NOT EXISTS(SELECT 1 FROM pg_depend d WHERE t.oid = d.objid AND d.deptype = 'e') ORDER BY n.nspname, t.typname", include_schema_str, exclude_schema_str);
+		query = psprintf("SELECT t.oid, n.nspname, t.typname, pg_get_userbyid(t.typowner) AS typowner, typacl FROM pg_type t INNER JOIN pg_namespace n ON (t.typnamespace = n.oid) WHERE t.typtype = 'e' AND n.nspname !~ '^pg_' AND n.nspname <> 'information_schema' %s%s AND NOT EXISTS(SELECT 1 FROM pg_depend d WHERE t.oid = d.objid AND d.deptype = 'e') ORDER BY n.nspname, t.typname", include_schema_str, exclude_schema_str);
 	}
-	else if (PQserverVersion(c) >= 90100)	/* extension support */
+	else if (getServerVersion(c) >= 90100)	/* extension support */
 	{
-		query = psprintf("SELECT t.oid, n.nspname, t.typname, obj_description(t.oid, 'pg_type') AS description, pg_get_userbyid(t.typowner) AS typowner, NULL AS typacl FROM pg_type t INNER JOIN pg_namespace n ON (t.typnamespace = n.oid) WHERE t.typtype = 'e' AND n.nspname !~ '^pg_' AND n.nspname <> 'information_schema' %s%s AND NOT EXISTS(SELECT 1 FROM pg_depend d WHERE t.oid = d.objid AND d.deptype = 'e') ORDER BY n.nspname, t.typname", include_schema_str, exclude_schema_str);
+		query = psprintf("SELECT t.oid, n.nspname, t.typname, pg_get_userbyid(t.typowner) AS typowner, NULL AS typacl FROM pg_type t INNER JOIN pg_namespace n ON (t.typnamespace = n.oid) WHERE t.typtype = 'e' AND n.nspname !~ '^pg_' AND n.nspname <> 'information_schema' %s%s AND NOT EXISTS(SELECT 1 FROM pg_depend d WHERE t.oid = d.objid AND d.deptype = 'e') ORDER BY n.nspname, t.typname", include_schema_str, exclude_schema_str);
 	}
 	else
 	{
-		query = psprintf("SELECT t.oid, n.nspname, t.typname, obj_description(t.oid, 'pg_type') AS description, pg_get_userbyid(t.typowner) AS typowner, NULL AS typacl FROM pg_type t INNER JOIN pg_namespace n ON (t.typnamespace = n.oid) WHERE t.typtype = 'e' AND n.nspname !~ '^pg_' AND n.nspname <> 'information_schema' %s%s ORDER BY n.nspname, t.typname", include_schema_str, exclude_schema_str);
+		query = psprintf("SELECT t.oid, n.nspname, t.typname, pg_get_userbyid(t.typowner) AS typowner, NULL AS typacl FROM pg_type t INNER JOIN pg_namespace n ON (t.typnamespace = n.oid) WHERE t.typtype = 'e' AND n.nspname !~ '^pg_' AND n.nspname <> 'information_schema' %s%s ORDER BY n.nspname, t.typname", include_schema_str, exclude_schema_str);
 	}
 
-	res = PQexec(c, query);
+	res = execQuery(c, query);
 
 	pfree(query);
 
@@ -508,7 +400,7 @@ getEnumTypes(PGconn *c, int *n)
 
 	*n = PQntuples(res);
 	if (*n > 0)
-		t = (PQLEnumType *) malloc(*n * sizeof(PQLEnumType));
+		t = (PQLEnumType *) arenaAlloc(*n * sizeof(PQLEnumType));
 	else
 		t = NULL;
 
@@ -516,114 +408,59 @@ getEnumTypes(PGconn *c, int *n)
 
 	for (i = 0; i < *n; i++)
 	{
-		char	*withoutescape;
-
 		t[i].obj.oid = strtoul(PQgetvalue(res, i, PQfnumber(res, "oid")), NULL, 10);
-		t[i].obj.schemaname = strdup(PQgetvalue(res, i, PQfnumber(res, "nspname")));
-		t[i].obj.objectname = strdup(PQgetvalue(res, i, PQfnumber(res, "typname")));
+		t[i].obj.schemaname = internName(PQgetvalue(res, i, PQfnumber(res, "nspname")));
+		t[i].obj.objectname = internName(PQgetvalue(res, i, PQfnumber(res, "typname")));
 
-		if (PQgetisnull(res, i, PQfnumber(res, "description")))
-			t[i].comment = NULL;
-		else
-		{
-			withoutescape = PQgetvalue(res, i, PQfnumber(res, "description"));
-			t[i].comment = PQescapeLiteral(c, withoutescape, strlen(withoutescape));
-			if (t[i].comment == NULL)
-			{
-				logError("escaping comment failed: %s", PQerrorMessage(c));
-				PQclear(res);
-				PQfinish(c);
-				/* XXX leak another connection? */
-				exit(EXIT_FAILURE);
-			}
-		}
+		t[i].comment = getComment(PGQ_CLASS_TYPE, t[i].obj.oid, 0);
 
-		t[i].owner = strdup(PQgetvalue(res, i, PQfnumber(res, "typowner")));
+		t[i].owner = internName(PQgetvalue(res, i, PQfnumber(res, "typowner")));
 		if (PQgetisnull(res, i, PQfnumber(res, "typacl")))
 			t[i].acl = NULL;
 		else
-			t[i].acl = strdup(PQgetvalue(res, i, PQfnumber(res, "typacl")));
+			t[i].acl = arenaStrdup(PQgetvalue(res, i, PQfnumber(res, "typacl")));
 
 		/*
 		 * Security labels are not assigned here (see getEnumTypeSecurityLabels),
 		 * but default values are essential to avoid having trouble in
-		 * freeEnumTypes.
+		 * the dump routines.
 		 */
 		t[i].nseclabels = 0;
 		t[i].seclabels = NULL;
 
-		/* fill enum type labels */
-		getEnumTypeLabels(c, &t[i]);
-
 		logDebug("enum type \"%s\".\"%s\"", t[i].obj.schemaname, t[i].obj.objectname);
 	}
 
 	PQclear(res);
 
+	/* fill enum type labels */
+	getEnumTypeLabels(c, t, *n);
+
 	return t;
 }
 
 void
-getEnumTypeSecurityLabels(PGconn *c, PQLEnumType *t)
+getEnumTypeSecurityLabels(PGconn *c, PQLEnumType *t, int n)
 {
-	char		*query;
-	PGresult	*res;
 	int			i;
 
-	if (PQserverVersion(c) < 90100)
+	if (n == 0)
+		return;
+
+	if (getServerVersion(c) < 90100)
 	{
 		logWarning("ignoring security labels because server does not support it");
 		return;
 	}
 
-	/*
-	 * Don't bother to check the kind of type because can't be duplicated oids
-	 * in the same catalog.
-	 */
-	query = psprintf("SELECT provider, label FROM pg_seclabel s INNER JOIN pg_class c ON (s.classoid = c.oid) WHERE c.relname = 'pg_type' AND s.objoid = %u ORDER BY provider", t->obj.oid);
-
-	res = PQexec(c, query);
-
-	pfree(query);
-
-	if (PQresultStatus(res) != PGRES_TUPLES_OK)
+	for (i = 0; i < n; i++)
 	{
-		logError("query failed: %s", PQresultErrorMessage(res));
-		PQclear(res);
-		PQfinish(c);
-		/* XXX leak another connection? */
-		exit(EXIT_FAILURE);
-	}
-
-	t->nseclabels = PQntuples(res);
-	if (t->nseclabels > 0)
-		t->seclabels = (PQLSecLabel *) malloc(t->nseclabels * sizeof(PQLSecLabel));
-	else
-		t->seclabels = NULL;
-
-	logDebug("number of security labels in enum type \"%s\".\"%s\": %d",
-			 t->obj.schemaname, t->obj.objectname, t->nseclabels);
+		t[i].nseclabels = getObjectSecurityLabels(c, PGQ_CLASS_TYPE,
+							  t[i].obj.oid, 0, &t[i].seclabels);
 
-	for (i = 0; i < t->nseclabels; i++)
-	{
-		char	*withoutescape;
-
-		t->seclabels[i].provider = strdup(PQgetvalue(res, i, PQfnumber(res,
-										  "provider")));
-		withoutescape = PQgetvalue(res, i, PQfnumber(res, "label"));
-		t->seclabels[i].label = PQescapeLiteral(c, withoutescape,
-												strlen(withoutescape));
-		if (t->seclabels[i].label == NULL)
-		{
-			logError("escaping label failed: %s", PQerrorMessage(c));
-			PQclear(res);
-			PQfinish(c);
-			/* XXX leak another connection? */
-			exit(EXIT_FAILURE);
-		}
+		logDebug("number of security labels in enum type \"%s\".\"%s\": %d",
+				 t[i].obj.schemaname, t[i].obj.objectname, t[i].nseclabels);
 	}
-
-	PQclear(res);
 }
 
 PQLRangeType *
@@ -634,21 +471,21 @@ getRangeTypes(PGconn *c, int *n)
 	PGresult		*res;
 	int				i;
 
-	logNoise("range type: server version: %d", PQserverVersion(c));
+	logNoise("range type: server version: %d", getServerVersion(c));
 
 	/* bail out if we do not support it */
-	if (PQserverVersion(c) < 90200)
+	if (getServerVersion(c) < 90200)
 	{
 		logWarning("ignoring range types because server does not support it");
 		return NULL;
 	}
 
-	if (PQserverVersion(c) >= 140000)
-		query = psprintf("SELECT t.oid, n.nspname, t.typname, obj_description(t.oid, 'pg_type') AS description, format_type(rngsubtype, NULL) AS subtype, rngmultitypid AS multirange, m.nspname AS opcnspname, o.opcname, o.opcdefault, x.nspname AS collschemaname, CASE WHEN rngcollation = t.typcollation THEN NULL ELSE rngcollation END AS collname, rngcanonical, rngsubdiff, pg_get_userbyid(t.typowner) AS typowner, typacl FROM pg_type t INNER JOIN pg_namespace n ON (t.typnamespace = n.oid) INNER JOIN pg_range r ON (r.rngsubtype = t.oid) INNER JOIN pg_opclass o ON (r.rngsubopc = o.oid) INNER JOIN pg_namespace m ON (o.opcnamespace = m.oid) LEFT JOIN (pg_collation l INNER JOIN pg_namespace x ON (l.collnamespace = x.oid)) ON (r.rngcollation = l.oid) WHERE t.typtype = 'r' AND n.nspname !~ '^pg_' AND n.nspname <> 'information_schema' %s%s AND NOT EXISTS(SELECT 1 FROM pg_depend d WHERE t.oid = d.objid AND d.deptype = 'e') ORDER BY n.nspname, t.typname", include_schema_str, exclude_schema_str);
+	if (getServerVersion(c) >= 140000)
+		query = psprintf("SELECT t.oid, n.nspname, t.typname, format_type(rngsubtype, NULL) AS subtype, rngmultitypid AS multirange, m.nspname AS opcnspname, o.opcname, o.opcdefault, x.nspname AS collschemaname, CASE WHEN rngcollation = t.typcollation THEN NULL ELSE rngcollation END AS collname, rngcanonical, rngsubdiff, pg_get_userbyid(t.typowner) AS typowner, typacl FROM pg_type t INNER JOIN pg_namespace n ON (t.typnamespace = n.oid) INNER JOIN pg_range r ON (r.rngsubtype = t.oid) INNER JOIN pg_opclass o ON (r.rngsubopc = o.oid) INNER JOIN pg_namespace m ON (o.opcnamespace = m.oid) LEFT JOIN (pg_collation l INNER JOIN pg_namespace x ON (l.collnamespace = x.oid)) ON (r.rngcollation = l.oid) WHERE t.typtype = 'r' AND n.nspname !~ '^pg_' AND n.nspname <> 'information_schema' %s%s AND NOT EXISTS(SELECT 1 FROM pg_depend d WHERE t.oid = d.objid AND d.deptype = 'e') ORDER BY n.nspname, t.typname", include_schema_str, exclude_schema_str);
 	else
-		query = psprintf("SELECT t.oid, n.nspname, t.typname, obj_description(t.oid, 'pg_type') AS description, format_type(rngsubtype, NULL) AS subtype, '-' AS multirange, m.nspname AS opcnspname, o.opcname, o.opcdefault, x.nspname AS collschemaname, CASE WHEN rngcollation = t.typcollation THEN NULL ELSE rngcollation END AS collname, rngcanonical, rngsubdiff, pg_get_userbyid(t.typowner) AS typowner, typacl FROM pg_type t INNER JOIN pg_namespace n ON (t.typnamespace = n.oid) INNER JOIN pg_range r ON (r.rngsubtype = t.oid) INNER JOIN pg_opclass o ON (r.rngsubopc = o.oid) INNER JOIN pg_namespace m ON (o.opcnamespace = m.oid) LEFT JOIN (pg_collation l INNER JOIN pg_namespace x ON (l.collnamespace = x.oid)) ON (r.rngcollation = l.oid) WHERE t.typtype = 'r' AND n.nspname !~ '^pg_' AND n.nspname <> 'information_schema' %s%s AND NOT EXISTS(SELECT 1 FROM pg_depend d WHERE t.oid = d.objid AND d.deptype = 'e') ORDER BY n.nspname, t.typname", include_schema_str, exclude_schema_str);
+		query = psprintf("SELECT t.oid, n.nspname, t.typname, format_type(rngsubtype, NULL) AS subtype, '-' AS multirange, m.nspname AS opcnspname, o.opcname, o.opcdefault, x.nspname AS collschemaname, CASE WHEN rngcollation = t.typcollation THEN NULL ELSE rngcollation END AS collname, rngcanonical, rngsubdiff, pg_get_userbyid(t.typowner) AS typowner, typacl FROM pg_type t INNER JOIN pg_namespace n ON (t.typnamespace = n.oid) INNER JOIN pg_range r ON (r.rngsubtype = t.oid) INNER JOIN pg_opclass o ON (r.rngsubopc = o.oid) INNER JOIN pg_namespace m ON (o.opcnamespace = m.oid) LEFT JOIN (pg_collation l INNER JOIN pg_namespace x ON (l.collnamespace = x.oid)) ON (r.rngcollation = l.oid) WHERE t.typtype = 'r' AND n.nspname !~ '^pg_' AND n.nspname <> 'information_schema' %s%s AND NOT EXISTS(SELECT 1 FROM pg_depend d WHERE t.oid = d.objid AND d.deptype = 'e') ORDER BY n.nspname, t.typname", include_schema_str, exclude_schema_str);
 
-	res = PQexec(c, query);
+	res = execQuery(c, query);
 
 	pfree(query);
 
@@ -663,7 +500,7 @@ getRangeTypes(PGconn *c, int *n)
 
 	*n = PQntuples(res);
 	if (*n > 0)
-		t = (PQLRangeType *) malloc(*n * sizeof(PQLRangeType));
+		t = (PQLRangeType *) arenaAlloc(*n * sizeof(PQLRangeType));
 	else
 		t = NULL;
 
@@ -671,15 +508,13 @@ getRangeTypes(PGconn *c, int *n)
 
 	for (i = 0; i < *n; i++)
 	{
-		char	*withoutescape;
-
 		t[i].obj.oid = strtoul(PQgetvalue(res, i, PQfnumber(res, "oid")), NULL, 10);
-		t[i].obj.schemaname = strdup(PQgetvalue(res, i, PQfnumber(res, "nspname")));
-		t[i].obj.objectname = strdup(PQgetvalue(res, i, PQfnumber(res, "typname")));
-		t[i].subtype = strdup(PQgetvalue(res, i, PQfnumber(res, "subtype")));
-		t[i].multirange = strdup(PQgetvalue(res, i, PQfnumber(res, "multirange")));
-		t[i].opcschemaname = strdup(PQgetvalue(res, i, PQfnumber(res, "opcnspname")));
-		t[i].opcname = strdup(PQgetvalue(res, i, PQfnumber(res, "opcname")));
+		t[i].obj.schemaname = internName(PQgetvalue(res, i, PQfnumber(res, "nspname")));
+		t[i].obj.objectname = internName(PQgetvalue(res, i, PQfnumber(res, "typname")));
+		t[i].subtype = arenaStrdup(PQgetvalue(res, i, PQfnumber(res, "subtype")));
+		t[i].multirange = arenaStrdup(PQgetvalue(res, i, PQfnumber(res, "multirange")));
+		t[i].opcschemaname = internName(PQgetvalue(res, i, PQfnumber(res, "opcnspname")));
+		t[i].opcname = arenaStrdup(PQgetvalue(res, i, PQfnumber(res, "opcname")));
 		t[i].opcdefault = (PQgetvalue(res, i, PQfnumber(res, "opcdefault"))[0] == 't');
 		if (PQgetisnull(res, i, PQfnumber(res, "collname")))
 		{
@@ -688,39 +523,25 @@ getRangeTypes(PGconn *c, int *n)
 		}
 		else
 		{
-			t[i].collschemaname = strdup(PQgetvalue(res, i, PQfnumber(res,
+			t[i].collschemaname = internName(PQgetvalue(res, i, PQfnumber(res,
 													"collschemaname")));
-			t[i].collname = strdup(PQgetvalue(res, i, PQfnumber(res, "collname")));
+			t[i].collname = arenaStrdup(PQgetvalue(res, i, PQfnumber(res, "collname")));
 		}
-		t[i].canonical = strdup(PQgetvalue(res, i, PQfnumber(res, "rngcanonical")));
-		t[i].diff = strdup(PQgetvalue(res, i, PQfnumber(res, "rngsubdiff")));
+		t[i].canonical = arenaStrdup(PQgetvalue(res, i, PQfnumber(res, "rngcanonical")));
+		t[i].diff = arenaStrdup(PQgetvalue(res, i, PQfnumber(res, "rngsubdiff")));
 
-		if (PQgetisnull(res, i, PQfnumber(res, "description")))
-			t[i].comment = NULL;
-		else
-		{
-			withoutescape = PQgetvalue(res, i, PQfnumber(res, "description"));
-			t[i].comment = PQescapeLiteral(c, withoutescape, strlen(withoutescape));
-			if (t[i].comment == NULL)
-			{
-				logError("escaping comment failed: %s", PQerrorMessage(c));
-				PQclear(res);
-				PQfinish(c);
-				/* XXX leak another connection? */
-				exit(EXIT_FAILURE);
-			}
-		}
+		t[i].comment = getComment(PGQ_CLASS_TYPE, t[i].obj.oid, 0);
 
-		t[i].owner = strdup(PQgetvalue(res, i, PQfnumber(res, "typowner")));
+		t[i].owner = internName(PQgetvalue(res, i, PQfnumber(res, "typowner")));
 		if (PQgetisnull(res, i, PQfnumber(res, "typacl")))
 			t[i].acl = NULL;
 		else
-			t[i].acl = strdup(PQgetvalue(res, i, PQfnumber(res, "typacl")));
+			t[i].acl = arenaStrdup(PQgetvalue(res, i, PQfnumber(res, "typacl")));
 
 		/*
 		 * Security labels are not assigned here (see getRangeTypeSecurityLabels),
 		 * but default values are essential to avoid having trouble in
-		 * freeRangeTypes.
+		 * the dump routines.
 		 */
 		t[i].nseclabels = 0;
 		t[i].seclabels = NULL;
@@ -734,253 +555,34 @@ getRangeTypes(PGconn *c, int *n)
 }
 
 void
-getRangeTypeSecurityLabels(PGconn *c, PQLRangeType *t)
+getRangeTypeSecurityLabels(PGconn *c, PQLRangeType *t, int n)
 {
-	char		*query;
-	PGresult	*res;
 	int			i;
 
-	if (PQserverVersion(c) < 90100)
-	{
-		logWarning("ignoring security labels because server does not support it");
+	if (n == 0)
 		return;
-	}
-
-	/*
-	 * Don't bother to check the kind of type because can't be duplicated oids
-	 * in the same catalog.
-	 */
-	query = psprintf("SELECT provider, label FROM pg_seclabel s INNER JOIN pg_class c ON (s.classoid = c.oid) WHERE c.relname = 'pg_type' AND s.objoid = %u ORDER BY provider", t->obj.oid);
-
-	res = PQexec(c, query);
-
-	pfree(query);
-
-	if (PQresultStatus(res) != PGRES_TUPLES_OK)
-	{
-		logError("query failed: %s", PQresultErrorMessage(res));
-		PQclear(res);
-		PQfinish(c);
-		/* XXX leak another connection? */
-		exit(EXIT_FAILURE);
-	}
-
-	t->nseclabels = PQntuples(res);
-	if (t->nseclabels > 0)
-		t->seclabels = (PQLSecLabel *) malloc(t->nseclabels * sizeof(PQLSecLabel));
-	else
-		t->seclabels = NULL;
-
-	logDebug("number of security labels in range type \"%s\".\"%s\": %d",
-			 t->obj.schemaname, t->obj.objectname, t->nseclabels);
-
-	for (i = 0; i < t->nseclabels; i++)
-	{
-		char	*withoutescape;
-
-		t->seclabels[i].provider = strdup(PQgetvalue(res, i, PQfnumber(res,
-										  "provider")));
-		withoutescape = PQgetvalue(res, i, PQfnumber(res, "label"));
-		t->seclabels[i].label = PQescapeLiteral(c, withoutescape,
-												strlen(withoutescape));
-		if (t->seclabels[i].label == NULL)
-		{
-			logError("escaping label failed: %s", PQerrorMessage(c));
-			PQclear(res);
-			PQfinish(c);
-			/* XXX leak another connection? */
-			exit(EXIT_FAILURE);
-		}
-	}
-
-	PQclear(res);
-}
-
-void
-freeBaseTypes(PQLBaseType *t, int n)
-{
-	if (n > 0)
-	{
-		int	i;
-
-		for (i = 0; i < n; i++)
-		{
-			int	j;
-
-			free(t[i].obj.schemaname);
-			free(t[i].obj.objectname);
-			free(t[i].input);
-			free(t[i].output);
-			free(t[i].receive);
-			free(t[i].send);
-			free(t[i].modin);
-			free(t[i].modout);
-			free(t[i].analyze);
-			if (t[i].subscript)
-				free(t[i].subscript);
-			if (t[i].typdefault)
-				free(t[i].typdefault);
-			free(t[i].category);
-			free(t[i].delimiter);
-			free(t[i].align);
-			free(t[i].storage);
-			free(t[i].owner);
-			if (t[i].acl)
-				free(t[i].acl);
-			if (t[i].comment)
-				PQfreemem(t[i].comment);
-
-			/* security labels */
-			for (j = 0; j < t[i].nseclabels; j++)
-			{
-				free(t[i].seclabels[j].provider);
-				free(t[i].seclabels[j].label);
-			}
-
-			if (t[i].seclabels)
-				free(t[i].seclabels);
-		}
-
-		free(t);
-	}
-}
-
-void
-freeCompositeTypes(PQLCompositeType *t, int n)
-{
-	if (n > 0)
-	{
-		int	i;
-
-		for (i = 0; i < n; i++)
-		{
-			int	j;
-
-			free(t[i].obj.schemaname);
-			free(t[i].obj.objectname);
-			free(t[i].owner);
-			if (t[i].acl)
-				free(t[i].acl);
-			if (t[i].comment)
-				PQfreemem(t[i].comment);
-
-			/* security labels */
-			for (j = 0; j < t[i].nseclabels; j++)
-			{
-				free(t[i].seclabels[j].provider);
-				free(t[i].seclabels[j].label);
-			}
 
-			if (t[i].seclabels)
-				free(t[i].seclabels);
-
-			for (j = 0; j < t[i].nattributes; j++)
-			{
-				free(t[i].attributes[j].attname);
-				free(t[i].attributes[j].typname);
-				if (t[i].attributes[j].collschemaname)
-					free(t[i].attributes[j].collschemaname);
-				if (t[i].attributes[j].collname)
-					free(t[i].attributes[j].collname);
-			}
-
-			if (t[i].attributes)
-				free(t[i].attributes);
-		}
-
-		free(t);
-	}
-}
-
-void
-freeEnumTypes(PQLEnumType *t, int n)
-{
-	if (n > 0)
+	if (getServerVersion(c) < 90100)
 	{
-		int	i;
-
-		for (i = 0; i < n; i++)
-		{
-			int	j;
-
-			free(t[i].obj.schemaname);
-			free(t[i].obj.objectname);
-			free(t[i].owner);
-			if (t[i].acl)
-				free(t[i].acl);
-			if (t[i].comment)
-				PQfreemem(t[i].comment);
-
-			/* security labels */
-			for (j = 0; j < t[i].nseclabels; j++)
-			{
-				free(t[i].seclabels[j].provider);
-				free(t[i].seclabels[j].label);
-			}
-
-			if (t[i].seclabels)
-				free(t[i].seclabels);
-
-			/* labels */
-			for (j = 0; j < t[i].nlabels; j++)
-				free(t[i].labels[j]);
-
-			free(t[i].labels);
-		}
-
-		free(t);
+		logWarning("ignoring security labels because server does not support it");
+		return;
 	}
-}
 
-void
-freeRangeTypes(PQLRangeType *t, int n)
-{
-	if (n > 0)
+	for (i = 0; i < n; i++)
 	{
-		int	i;
-
-		for (i = 0; i < n; i++)
-		{
-			int	j;
-
-			free(t[i].obj.schemaname);
-			free(t[i].obj.objectname);
-			free(t[i].subtype);
-			free(t[i].multirange);
-			free(t[i].opcschemaname);
-			free(t[i].opcname);
-			if (t[i].collschemaname)
-				free(t[i].collschemaname);
-			if (t[i].collname)
-				free(t[i].collname);
-			free(t[i].canonical);
-			free(t[i].diff);
-			free(t[i].owner);
-			if (t[i].acl)
-				free(t[i].acl);
-			if (t[i].comment)
-				PQfreemem(t[i].comment);
-
-			/* security labels */
-			for (j = 0; j < t[i].nseclabels; j++)
-			{
-				free(t[i].seclabels[j].provider);
-				free(t[i].seclabels[j].label);
-			}
+		t[i].nseclabels = getObjectSecurityLabels(c, PGQ_CLASS_TYPE,
+							  t[i].obj.oid, 0, &t[i].seclabels);
 
-			if (t[i].seclabels)
-				free(t[i].seclabels);
-		}
-
-		free(t);
+		logDebug("number of security labels in range type \"%s\".\"%s\": %d",
+				 t[i].obj.schemaname, t[i].obj.objectname, t[i].nseclabels);
 	}
 }
 
 void
 dumpCreateBaseType(FILE *output, PQLBaseType *t)
 {
-	char	*schema = formatObjectIdentifier(t->obj.schemaname);
-	char	*typname = formatObjectIdentifier(t->obj.objectname);
+	char	*schema = quotedName(t->obj.schemaname);
+	char	*typname = quotedName(t->obj.objectname);
 
 	fprintf(output, "\n\n");
 	fprintf(output, "CREATE TYPE %s.%s (", schema, typname);
@@ -1050,7 +652,9 @@ dumpCreateBaseType(FILE *output, PQLBaseType *t)
 	if (options.comment && t->comment != NULL)
 	{
 		fprintf(output, "\n\n");
-		fprintf(output, "COMMENT ON TYPE %s.%s IS %s;", schema, typname, t->comment);
+		fprintf(output, "COMMENT ON TYPE %s.%s IS ", schema, typname);
+		printComment(output, t->comment);
+		fprintf(output, ";");
 	}
 
 	/* security labels */
@@ -1072,12 +676,10 @@ dumpCreateBaseType(FILE *output, PQLBaseType *t)
 	/* owner */
 	if (options.owner)
 	{
-		char	*owner = formatObjectIdentifier(t->owner);
+		char	*owner = quotedName(t->owner);
 
 		fprintf(output, "\n\n");
 		fprintf(output, "ALTER TYPE %s.%s OWNER TO %s;", schema, typname, owner);
-
-		free(owner);
 	}
 
 	/* privileges */
@@ -1085,16 +687,13 @@ dumpCreateBaseType(FILE *output, PQLBaseType *t)
 	if (options.privileges)
 		dumpGrantAndRevoke(output, PGQ_TYPE, &t->obj, &t->obj, NULL, t->acl, NULL,
 						   NULL);
-
-	free(schema);
-	free(typname);
 }
 
 void
 dumpCreateCompositeType(FILE *output, PQLCompositeType *t)
 {
-	char	*schema = formatObjectIdentifier(t->obj.schemaname);
-	char	*typname = formatObjectIdentifier(t->obj.objectname);
+	char	*schema = quotedName(t->obj.schemaname);
+	char	*typname = quotedName(t->obj.objectname);
 
 	int		i;
 
@@ -1126,7 +725,9 @@ dumpCreateCompositeType(FILE *output, PQLCompositeType *t)
 	if (options.comment && t->comment != NULL)
 	{
 		fprintf(output, "\n\n");
-		fprintf(output, "COMMENT ON TYPE %s.%s IS %s;", schema, typname, t->comment);
+		fprintf(output, "COMMENT ON TYPE %s.%s IS ", schema, typname);
+		printComment(output, t->comment);
+		fprintf(output, ";");
 	}
 
 	/* security labels */
@@ -1146,12 +747,10 @@ dumpCreateCompositeType(FILE *output, PQLCompositeType *t)
 	/* owner */
 	if (options.owner)
 	{
-		char	*owner = formatObjectIdentifier(t->owner);
+		char	*owner = quotedName(t->owner);
 
 		fprintf(output, "\n\n");
 		fprintf(output, "ALTER TYPE %s.%s OWNER TO %s;", schema, typname, owner);
-
-		free(owner);
 	}
 
 	/* privileges */
@@ -1159,16 +758,13 @@ dumpCreateCompositeType(FILE *output, PQLCompositeType *t)
 	if (options.privileges)
 		dumpGrantAndRevoke(output, PGQ_TYPE, &t->obj, &t->obj, NULL, t->acl, NULL,
 						   NULL);
-
-	free(schema);
-	free(typname);
 }
 
 void
 dumpCreateEnumType(FILE *output, PQLEnumType *t)
 {
-	char	*schema = formatObjectIdentifier(t->obj.schemaname);
-	char	*typname = formatObjectIdentifier(t->obj.objectname);
+	char	*schema = quotedName(t->obj.schemaname);
+	char	*typname = quotedName(t->obj.objectname);
 
 	int		i;
 
@@ -1188,7 +784,9 @@ dumpCreateEnumType(FILE *output, PQLEnumType *t)
 	if (options.comment && t->comment != NULL)
 	{
 		fprintf(output, "\n\n");
-		fprintf(output, "COMMENT ON TYPE %s.%s IS %s;", schema, typname, t->comment);
+		fprintf(output, "COMMENT ON TYPE %s.%s IS ", schema, typname);
+		printComment(output, t->comment);
+		fprintf(output, ";");
 	}
 
 	/* security labels */
@@ -1208,12 +806,10 @@ dumpCreateEnumType(FILE *output, PQLEnumType *t)
 	/* owner */
 	if (options.owner)
 	{
-		char	*owner = formatObjectIdentifier(t->owner);
+		char	*owner = quotedName(t->owner);
 
 		fprintf(output, "\n\n");
 		fprintf(output, "ALTER TYPE %s.%s OWNER TO %s;", schema, typname, owner);
-
-		free(owner);
 	}
 
 	/* privileges */
@@ -1221,16 +817,13 @@ dumpCreateEnumType(FILE *output, PQLEnumType *t)
 	if (options.privileges)
 		dumpGrantAndRevoke(output, PGQ_TYPE, &t->obj, &t->obj, NULL, t->acl, NULL,
 						   NULL);
-
-	free(schema);
-	free(typname);
 }
 
 void
 dumpCreateRangeType(FILE *output, PQLRangeType *t)
 {
-	char	*schema = formatObjectIdentifier(t->obj.schemaname);
-	char	*typname = formatObjectIdentifier(t->obj.objectname);
+	char	*schema = quotedName(t->obj.schemaname);
+	char	*typname = quotedName(t->obj.objectname);
 
 	fprintf(output, "\n\n");
 	fprintf(output, "CREATE TYPE %s.%s AS RANGE (", schema, typname);
@@ -1275,7 +868,9 @@ dumpCreateRangeType(FILE *output, PQLRangeType *t)
 	if (options.comment && t->comment != NULL)
 	{
 		fprintf(output, "\n\n");
-		fprintf(output, "COMMENT ON TYPE %s.%s IS %s;", schema, typname, t->comment);
+		fprintf(output, "COMMENT ON TYPE %s.%s IS ", schema, typname);
+		printComment(output, t->comment);
+		fprintf(output, ";");
 	}
 
 	/* security labels */
@@ -1297,12 +892,10 @@ dumpCreateRangeType(FILE *output, PQLRangeType *t)
 	/* owner */
 	if (options.owner)
 	{
-		char	*owner = formatObjectIdentifier(t->owner);
+		char	*owner = quotedName(t->owner);
 
 		fprintf(output, "\n\n");
 		fprintf(output, "ALTER TYPE %s.%s OWNER TO %s;", schema, typname, owner);
-
-		free(owner);
 	}
 
 	/* privileges */
@@ -1310,70 +903,55 @@ dumpCreateRangeType(FILE *output, PQLRangeType *t)
 	if (options.privileges)
 		dumpGrantAndRevoke(output, PGQ_TYPE, &t->obj, &t->obj, NULL, t->acl, NULL,
 						   NULL);
-
-	free(schema);
-	free(typname);
 }
 
 void
 dumpDropBaseType(FILE *output, PQLBaseType *t)
 {
-	char	*schema = formatObjectIdentifier(t->obj.schemaname);
-	char	*typname = formatObjectIdentifier(t->obj.objectname);
+	char	*schema = quotedName(t->obj.schemaname);
+	char	*typname = quotedName(t->obj.objectname);
 
 	fprintf(output, "\n\n");
 	fprintf(output, "DROP TYPE %s.%s;", schema, typname);
-
-	free(schema);
-	free(typname);
 }
 
 void
 dumpDropCompositeType(FILE *output, PQLCompositeType *t)
 {
-	char	*schema = formatObjectIdentifier(t->obj.schemaname);
-	char	*typname = formatObjectIdentifier(t->obj.objectname);
+	char	*schema = quotedName(t->obj.schemaname);
+	char	*typname = quotedName(t->obj.objectname);
 
 	fprintf(output, "\n\n");
 	fprintf(output, "DROP TYPE %s.%s;", schema, typname);
-
-	free(schema);
-	free(typname);
 }
 
 void
 dumpDropEnumType(FILE *output, PQLEnumType *t)
 {
-	char	*schema = formatObjectIdentifier(t->obj.schemaname);
-	char	*typname = formatObjectIdentifier(t->obj.objectname);
+	char	*schema = quotedName(t->obj.schemaname);
+	char	*typname = quotedName(t->obj.objectname);
 
 	fprintf(output, "\n\n");
 	fprintf(output, "DROP TYPE %s.%s;", schema, typname);
-
-	free(schema);
-	free(typname);
 }
 
 void
 dumpDropRangeType(FILE *output, PQLRangeType *t)
 {
-	char	*schema = formatObjectIdentifier(t->obj.schemaname);
-	char	*typname = formatObjectIdentifier(t->obj.objectname);
+	char	*schema = quotedName(t->obj.schemaname);
+	char	*typname = quotedName(t->obj.objectname);
 
 	fprintf(output, "\n\n");
 	fprintf(output, "DROP TYPE %s.%s;", schema, typname);
-
-	free(schema);
-	free(typname);
 }
 
 void
 dumpAlterBaseType(FILE *output, PQLBaseType *a, PQLBaseType *b)
 {
-	char	*schema1 = formatObjectIdentifier(a->obj.schemaname);
-	char	*typname1 = formatObjectIdentifier(a->obj.objectname);
-	char	*schema2 = formatObjectIdentifier(b->obj.schemaname);
-	char	*typname2 = formatObjectIdentifier(b->obj.objectname);
+	char	*schema1 = quotedName(a->obj.schemaname);
+	char	*typname1 = quotedName(a->obj.objectname);
+	char	*schema2 = quotedName(b->obj.schemaname);
+	char	*typname2 = quotedName(b->obj.objectname);
 
 	/* comment */
 	if (options.comment)
@@ -1383,8 +961,9 @@ dumpAlterBaseType(FILE *output, PQLBaseType *a, PQLBaseType *b)
 				 strcmp(a->comment, b->comment) != 0))
 		{
 			fprintf(output, "\n\n");
-			fprintf(output, "COMMENT ON TYPE %s.%s IS %s;", schema2, typname2,
-					b->comment);
+			fprintf(output, "COMMENT ON TYPE %s.%s IS ", schema2, typname2);
+			printComment(output, b->comment);
+			fprintf(output, ";");
 		}
 		else if (a->comment != NULL && b->comment == NULL)
 		{
@@ -1491,12 +1070,10 @@ dumpAlterBaseType(FILE *output, PQLBaseType *a, PQLBaseType *b)
 	{
 		if (strcmp(a->owner, b->owner) != 0)
 		{
-			char	*owner = formatObjectIdentifier(b->owner);
+			char	*owner = quotedName(b->owner);
 
 			fprintf(output, "\n\n");
 			fprintf(output, "ALTER TYPE %s.%s OWNER TO %s;", schema2, typname2, owner);
-
-			free(owner);
 		}
 	}
 
@@ -1507,20 +1084,15 @@ dumpAlterBaseType(FILE *output, PQLBaseType *a, PQLBaseType *b)
 			dumpGrantAndRevoke(output, PGQ_TYPE, &a->obj, &b->obj, a->acl, b->acl, NULL,
 							   NULL);
 	}
-
-	free(schema1);
-	free(typname1);
-	free(schema2);
-	free(typname2);
 }
 
 void
 dumpAlterCompositeType(FILE *output, PQLCompositeType *a, PQLCompositeType *b)
 {
-	char	*schema1 = formatObjectIdentifier(a->obj.schemaname);
-	char	*typname1 = formatObjectIdentifier(a->obj.objectname);
-	char	*schema2 = formatObjectIdentifier(b->obj.schemaname);
-	char	*typname2 = formatObjectIdentifier(b->obj.objectname);
+	char	*schema1 = quotedName(a->obj.schemaname);
+	char	*typname1 = quotedName(a->obj.objectname);
+	char	*schema2 = quotedName(b->obj.schemaname);
+	char	*typname2 = quotedName(b->obj.objectname);
 
 	/* comment */
 	if (options.comment)
@@ -1530,8 +1102,9 @@ dumpAlterCompositeType(FILE *output, PQLCompositeType *a, PQLCompositeType *b)
 				 strcmp(a->comment, b->comment) != 0))
 		{
 			fprintf(output, "\n\n");
-			fprintf(output, "COMMENT ON TYPE %s.%s IS %s;", schema2, typname2,
-					b->comment);
+			fprintf(output, "COMMENT ON TYPE %s.%s IS ", schema2, typname2);
+			printComment(output, b->comment);
+			fprintf(output, ";");
 		}
 		else if (a->comment != NULL && b->comment == NULL)
 		{
@@ -1638,12 +1211,10 @@ dumpAlterCompositeType(FILE *output, PQLCompositeType *a, PQLCompositeType *b)
 	{
 		if (strcmp(a->owner, b->owner) != 0)
 		{
-			char	*owner = formatObjectIdentifier(b->owner);
+			char	*owner = quotedName(b->owner);
 
 			fprintf(output, "\n\n");
 			fprintf(output, "ALTER TYPE %s.%s OWNER TO %s;", schema2, typname2, owner);
-
-			free(owner);
 		}
 	}
 
@@ -1654,20 +1225,15 @@ dumpAlterCompositeType(FILE *output, PQLCompositeType *a, PQLCompositeType *b)
 			dumpGrantAndRevoke(output, PGQ_TYPE, &a->obj, &b->obj, a->acl, b->acl, NULL,
 							   NULL);
 	}
-
-	free(schema1);
-	free(typname1);
-	free(schema2);
-	free(typname2);
 }
 
 void
 dumpAlterEnumType(FILE *output, PQLEnumType *a, PQLEnumType *b)
 {
-	char	*schema1 = formatObjectIdentifier(a->obj.schemaname);
-	char	*typname1 = formatObjectIdentifier(a->obj.objectname);
-	char	*schema2 = formatObjectIdentifier(b->obj.schemaname);
-	char	*typname2 = formatObjectIdentifier(b->obj.objectname);
+	char	*schema1 = quotedName(a->obj.schemaname);
+	char	*typname1 = quotedName(a->obj.objectname);
+	char	*schema2 = quotedName(b->obj.schemaname);
+	char	*typname2 = quotedName(b->obj.objectname);
 
 	/* comment */
 	if (options.comment)
@@ -1677,8 +1243,9 @@ dumpAlterEnumType(FILE *output, PQLEnumType *a, PQLEnumType *b)
 				 strcmp(a->comment, b->comment) != 0))
 		{
 			fprintf(output, "\n\n");
-			fprintf(output, "COMMENT ON TYPE %s.%s IS %s;", schema2, typname2,
-					b->comment);
+			fprintf(output, "COMMENT ON TYPE %s.%s IS ", schema2, typname2);
+			printComment(output, b->comment);
+			fprintf(output, ";");
 		}
 		else if (a->comment != NULL && b->comment == NULL)
 		{
@@ -1785,12 +1352,10 @@ dumpAlterEnumType(FILE *output, PQLEnumType *a, PQLEnumType *b)
 	{
 		if (strcmp(a->owner, b->owner) != 0)
 		{
-			char	*owner = formatObjectIdentifier(b->owner);
+			char	*owner = quotedName(b->owner);
 
 			fprintf(output, "\n\n");
 			fprintf(output, "ALTER TYPE %s.%s OWNER TO %s;", schema2, typname2, owner);
-
-			free(owner);
 		}
 	}
 
@@ -1801,20 +1366,15 @@ dumpAlterEnumType(FILE *output, PQLEnumType *a, PQLEnumType *b)
 			dumpGrantAndRevoke(output, PGQ_TYPE, &a->obj, &b->obj, a->acl, b->acl, NULL,
 							   NULL);
 	}
-
-	free(schema1);
-	free(typname1);
-	free(schema2);
-	free(typname2);
 }
 
 void
 dumpAlterRangeType(FILE *output, PQLRangeType *a, PQLRangeType *b)
 {
-	char	*schema1 = formatObjectIdentifier(a->obj.schemaname);
-	char	*typname1 = formatObjectIdentifier(a->obj.objectname);
-	char	*schema2 = formatObjectIdentifier(b->obj.schemaname);
-	char	*typname2 = formatObjectIdentifier(b->obj.objectname);
+	char	*schema1 = quotedName(a->obj.schemaname);
+	char	*typname1 = quotedName(a->obj.objectname);
+	char	*schema2 = quotedName(b->obj.schemaname);
+	char	*typname2 = quotedName(b->obj.objectname);
 
 	/* comment */
 	if (options.comment)
@@ -1824,8 +1384,9 @@ dumpAlterRangeType(FILE *output, PQLRangeType *a, PQLRangeType *b)
 				 strcmp(a->comment, b->comment) != 0))
 		{
 			fprintf(output, "\n\n");
-			fprintf(output, "COMMENT ON TYPE %s.%s IS %s;", schema2, typname2,
-					b->comment);
+			fprintf(output, "COMMENT ON TYPE %s.%s IS ", schema2, typname2);
+			printComment(output, b->comment);
+			fprintf(output, ";");
 		}
 		else if (a->comment != NULL && b->comment == NULL)
 		{
@@ -1932,12 +1493,10 @@ dumpAlterRangeType(FILE *output, PQLRangeType *a, PQLRangeType *b)
 	{
 		if (strcmp(a->owner, b->owner) != 0)
 		{
-			char	*owner = formatObjectIdentifier(b->owner);
+			char	*owner = quotedName(b->owner);
 
 			fprintf(output, "\n\n");
 			fprintf(output, "ALTER TYPE %s.%s OWNER TO %s;", schema2, typname2, owner);
-
-			free(owner);
 		}
 	}
 
@@ -1948,9 +1507,4 @@ dumpAlterRangeType(FILE *output, PQLRangeType *a, PQLRangeType *b)
 			dumpGrantAndRevoke(output, PGQ_TYPE, &a->obj, &b->obj, a->acl, b->acl, NULL,
 							   NULL);
 	}
-
-	free(schema1);
-	free(typname1);
-	free(schema2);
-	free(typname2);
 }
@@ -9,8 +9,10 @@
 #ifndef TYPE_H
 #define TYPE_H
 
+#include "comment.h"
 #include "common.h"
 #include "privileges.h"
+#include "seclabel.h"
 
 typedef struct PQLBaseType
 {
@@ -104,10 +106,10 @@ PQLCompositeType *getCompositeTypes(PGconn *c, int *n);
 PQLEnumType *getEnumTypes(PGconn *c, int *n);
 PQLRangeType *getRangeTypes(PGconn *c, int *n);
 
-void getBaseTypeSecurityLabels(PGconn *c, PQLBaseType *t);
-void getCompositeTypeSecurityLabels(PGconn *c, PQLCompositeType *t);
-void getEnumTypeSecurityLabels(PGconn *c, PQLEnumType *t);
-void getRangeTypeSecurityLabels(PGconn *c, PQLRangeType *t);
+void getBaseTypeSecurityLabels(PGconn *c, PQLBaseType *t, int n);
+void getCompositeTypeSecurityLabels(PGconn *c, PQLCompositeType *t, int n);
+void getEnumTypeSecurityLabels(PGconn *c, PQLEnumType *t, int n);
+void getRangeTypeSecurityLabels(PGconn *c, PQLRangeType *t, int n);
 
 void dumpDropBaseType(FILE *output, PQLBaseType *t);
 void dumpDropCompositeType(FILE *output, PQLCompositeType *t);
@@ -125,9 +127,5 @@ void dumpAlterCompositeType(FILE *output, PQLCompositeType *a,
 void dumpAlterEnumType(FILE *output, PQLEnumType *a, PQLEnumType *b);
 void dumpAlterRangeType(FILE *output, PQLRangeType *a, PQLRangeType *b);
 
-void freeBaseTypes(PQLBaseType *t, int n);
-void freeCompositeTypes(PQLCompositeType *t, int n);
-void freeEnumTypes(PQLEnumType *t, int n);
-void freeRangeTypes(PQLRangeType *t, int n);
 
 #endif	/* TYPE_H */
@@ -39,9 +39,9 @@ getUserMappings(PGconn *c, int *n)
 	PGresult		*res;
 	int				i;
 
-	logNoise("user mapping: server version: %d", PQserverVersion(c));
+	logNoise("user mapping: server version: %d", getServerVersion(c));
 
-	res = PQexec(c,
+	res = execQuery(c,
 				 "SELECT u.oid, u.umuser AS useroid, CASE WHEN umuser = 0 THEN 'PUBLIC' ELSE pg_get_userbyid(u.umuser) END AS username, s.srvname AS servername, array_to_string(u.umoptions, ', ') AS options FROM pg_user_mapping u INNER JOIN pg_foreign_server s ON (u.umserver = s.oid) ORDER BY username, servername");
 
 	if (PQresultStatus(res) != PGRES_TUPLES_OK)
@@ -55,7 +55,7 @@ getUserMappings(PGconn *c, int *n)
 
 	*n = PQntuples(res);
 	if (*n > 0)
-		u = (PQLUserMapping *) malloc(*n * sizeof(PQLUserMapping));
+		u = (PQLUserMapping *) arenaAlloc(*n * sizeof(PQLUserMapping));
 	else
 		u = NULL;
 
@@ -65,14 +65,14 @@ getUserMappings(PGconn *c, int *n)
 	{
 		u[i].oid = strtoul(PQgetvalue(res, i, PQfnumber(res, "oid")), NULL, 10);
 		u[i].useroid = strtoul(PQgetvalue(res, i, PQfnumber(res, "useroid")), NULL, 10);
-		u[i].user = strdup(PQgetvalue(res, i, PQfnumber(res, "username")));
-		u[i].server = strdup(PQgetvalue(res, i, PQfnumber(res, "servername")));
+		u[i].user = arenaStrdup(PQgetvalue(res, i, PQfnumber(res, "username")));
+		u[i].server = arenaStrdup(PQgetvalue(res, i, PQfnumber(res, "servername")));
 
 		/* options (optional) */
 		if (PQgetisnull(res, i, PQfnumber(res, "options")))
 			u[i].options = NULL;
 		else
-			u[i].options = strdup(PQgetvalue(res, i, PQfnumber(res, "options")));
+			u[i].options = arenaStrdup(PQgetvalue(res, i, PQfnumber(res, "options")));
 
 		logDebug("user mapping for user %s server %s", u[i].user, u[i].server);
 	}
@@ -82,25 +82,6 @@ getUserMappings(PGconn *c, int *n)
 	return u;
 }
 
-void
-freeUserMappings(PQLUserMapping *u, int n)
-{
-	if (n > 0)
-	{
-		int	i;
-
-		for (i = 0; i < n; i++)
-		{
-			free(u[i].user);
-			free(u[i].server);
-			if (u[i].options)
-				free(u[i].options);
-		}
-
-		free(u);
-	}
-}
-
 void
 dumpDropUserMapping(FILE *output, PQLUserMapping *u)
 {
@@ -117,30 +98,27 @@ dumpCreateUserMapping(FILE *output, PQLUserMapping *u)
 	/* options (optional) */
 	if (u->options)
 	{
-		stringList		*sl;
-		stringListCell	*cell;
+		PQLOptionSet	*sl;
+		int				k;
 		bool			first = true;
 
-		sl = buildStringList(u->options);
+		sl = buildOptionSet(u->options);
 		fprintf(output, " OPTIONS (");
-		for (cell = sl->head; cell; cell = cell->next)
+		for (k = 0; k < sl->nitems; k++)
 		{
-			char	*str;
-
-			str = strchr(cell->value, '=');
-			*str++ = '\0';
+			PQLOption	*opt = &sl->items[k];
 
 			if (first)
 			{
-				fprintf(output, "%s '%s'", cell->value, str);
+				fprintf(output, "%s '%s'", opt->key, opt->value);
 				first = false;
 			}
 			else
-				fprintf(output, ", %s '%s'", cell->value, str);
+				fprintf(output, ", %s '%s'", opt->key, opt->value);
 		}
 		fprintf(output, ")");
 
-		freeStringList(sl);
+		freeOptionSet(sl);
 	}
 
 	fprintf(output, ";");
@@ -152,66 +130,60 @@ dumpAlterUserMapping(FILE *output, PQLUserMapping *a, PQLUserMapping *b)
 	/* options */
 	if (a->options == NULL && b->options != NULL)
 	{
-		stringList		*sl;
-		stringListCell	*cell;
+		PQLOptionSet	*sl;
+		int				k;
 		bool			first = true;
 
-		sl = buildStringList(b->options);
+		sl = buildOptionSet(b->options);
 		fprintf(output, "\n\n");
 		fprintf(output, "ALTER USER MAPPING FOR %s SERVER %s OPTIONS (", b->user,
 				b->server);
-		for (cell = sl->head; cell; cell = cell->next)
+		for (k = 0; k < sl->nitems; k++)
 		{
-			char	*str;
-
-			str = strchr(cell->value, '=');
-			*str++ = '\0';
+			PQLOption	*opt = &sl->items[k];
 
 			if (first)
 			{
-				fprintf(output, "ADD %s '%s'", cell->value, str);
+				fprintf(output, "ADD %s '%s'", opt->key, opt->value);
 				first = false;
 			}
 			else
-				fprintf(output, ", ADD %s '%s'", cell->value, str);
+				fprintf(output, ", ADD %s '%s'", opt->key, opt->value);
 		}
 		fprintf(output, ");");
 
-		freeStringList(sl);
+		freeOptionSet(sl);
 	}
 	else if (a->options != NULL && b->options == NULL)
 	{
-		stringList		*sl;
-		stringListCell	*cell;
+		PQLOptionSet	*sl;
+		int				k;
 		bool			first = true;
 
-		sl = buildStringList(a->options);
+		sl = buildOptionSet(a->options);
 		fprintf(output, "\n\n");
 		fprintf(output, "ALTER USER MAPPING FOR %s SERVER %s OPTIONS (", a->user,
 				a->server);
-		for (cell = sl->head; cell; cell = cell->next)
+		for (k = 0; k < sl->nitems; k++)
 		{
-			char	*str;
-
-			str = strchr(cell->value, '=');
-			*str = '\0';
+			PQLOption	*opt = &sl->items[k];
 
 			if (first)
 			{
-				fprintf(output, "DROP %s", cell->value);
+				fprintf(output, "DROP %s", opt->key);
 				first = false;
 			}
 			else
-				fprintf(output, ", DROP %s", cell->value);
+				fprintf(output, ", DROP %s", opt->key);
 		}
 		fprintf(output, ");");
 
-		freeStringList(sl);
+		freeOptionSet(sl);
 	}
 	else if (a->options != NULL && b->options != NULL &&
 			 strcmp(a->options, b->options) != 0)
 	{
-		stringList	*rlist, *ilist, *slist;
+		PQLOptionSet	*rlist, *ilist, *slist;
 		bool		first = true;
 
 		/* reset options that are only presented in the first set */
@@ -219,24 +191,24 @@ dumpAlterUserMapping(FILE *output, PQLUserMapping *a, PQLUserMapping *b)
 									true);
 		if (rlist)
 		{
-			stringListCell	*cell;
+			int				k;
 
 			fprintf(output, "\n\n");
 			fprintf(output, "ALTER USER MAPPING FOR %s SERVER %s OPTIONS (", a->user,
 					a->server);
-			for (cell = rlist->head; cell; cell = cell->next)
+			for (k = 0; k < rlist->nitems; k++)
 			{
 				if (first)
 				{
-					fprintf(output, " DROP %s", cell->value);
+					fprintf(output, " DROP %s", rlist->items[k].key);
 					first = false;
 				}
 				else
-					fprintf(output, ", DROP %s", cell->value);
+					fprintf(output, ", DROP %s", rlist->items[k].key);
 			}
 			fprintf(output, ");");
 
-			freeStringList(rlist);
+			freeOptionSet(rlist);
 		}
 
 		/*
@@ -246,29 +218,26 @@ dumpAlterUserMapping(FILE *output, PQLUserMapping *a, PQLUserMapping *b)
 		ilist = setOperationOptions(a->options, b->options, PGQ_INTERSECT, true, true);
 		if (ilist)
 		{
-			stringListCell	*cell;
+			int				k;
 
 			fprintf(output, "\n\n");
 			fprintf(output, "ALTER USER MAPPING FOR %s SERVER %s OPTIONS (", a->user,
 					a->server);
-			for (cell = ilist->head; cell; cell = cell->next)
+			for (k = 0; k < ilist->nitems; k++)
 			{
-				char	*str;
-
-				str = strchr(cell->value, '=');
-				*str++ = '\0';
+				PQLOption	*opt = &ilist->items[k];
 
 				if (first)
 				{
-					fprintf(output, " SET %s '%s'", cell->value, str);
+					fprintf(output, " SET %s '%s'", opt->key, opt->value);
 					first = false;
 				}
 				else
-					fprintf(output, ", SET %s '%s'", cell->value, str);
+					fprintf(output, ", SET %s '%s'", opt->key, opt->value);
 			}
 			fprintf(output, ");");
 
-			freeStringList(ilist);
+			freeOptionSet(ilist);
 		}
 
 		/*
@@ -278,30 +247,27 @@ dumpAlterUserMapping(FILE *output, PQLUserMapping *a, PQLUserMapping *b)
 									true);
 		if (slist)
 		{
-			stringListCell	*cell;
+			int				k;
 			bool			first = true;
 
 			fprintf(output, "\n\n");
 			fprintf(output, "ALTER USER MAPPING FOR %s SERVER %s OPTIONS (", a->user,
 					a->server);
-			for (cell = slist->head; cell; cell = cell->next)
+			for (k = 0; k < slist->nitems; k++)
 			{
-				char	*str;
-
-				str = strchr(cell->value, '=');
-				*str++ = '\0';
+				PQLOption	*opt = &slist->items[k];
 
 				if (first)
 				{
-					fprintf(output, "ADD %s '%s'", cell->value, str);
+					fprintf(output, "ADD %s '%s'", opt->key, opt->value);
 					first = false;
 				}
 				else
-					fprintf(output, ", ADD %s '%s'", cell->value, str);
+					fprintf(output, ", ADD %s '%s'", opt->key, opt->value);
 			}
 			fprintf(output, ");");
 
-			freeStringList(slist);
+			freeOptionSet(slist);
 		}
 	}
 }
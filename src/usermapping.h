@@ -28,6 +28,5 @@ void dumpAlterUserMapping(FILE *output, PQLUserMapping *a,
 						  PQLUserMapping *b);
 
 int compareUserMappings(PQLUserMapping *a, PQLUserMapping *b);
-void freeUserMappings(PQLUserMapping *u, int n);
 
 #endif	/* USER_MAPPING_H */
@@ -34,27 +34,27 @@ getViews(PGconn *c, int *n)
 	PGresult	*res;
 	int			i;
 
-	logNoise("view: server version: %d", PQserverVersion(c));
+	logNoise("view: server version: %d", getServerVersion(c));
 
 	/*
 	 * FIXME exclude check_option from reloptions.
 	 * check_option is new in 9.4
 	 * array_remove() is new in 9.3
 	 */
-	if (PQserverVersion(c) >= 90300)
+	if (getServerVersion(c) >= 90300)
 	{
-		query = psprintf("SELECT c.oid, n.nspname, c.relname, pg_get_viewdef(c.oid) AS viewdef, array_to_string(array_remove(array_remove(c.reloptions,'check_option=local'),'check_option=cascaded'), ', ') AS reloptions, CASE WHEN 'check_option=local' = ANY(c.reloptions) THEN 'LOCAL'::text WHEN 'check_option=cascaded' = ANY(c.reloptions) THEN 'CASCADED'::text ELSE NULL END AS checkoption, obj_description(c.oid, 'pg_class') AS description, pg_get_userbyid(c.relowner) AS relowner FROM pg_class c INNER JOIN pg_namespace n ON (c.relnamespace = n.oid) WHERE relkind = 'v' AND nspname !~ '^pg_' AND nspname <> 'information_schema' %s%s AND NOT EXISTS(SELECT 1 FROM pg_depend d WHERE c.oid = d.objid AND d.deptype = 'e') ORDER BY nspname, relname", include_schema_str, exclude_schema_str);
+		query = psprintf("SELECT c.oid, n.nspname, c.relname, pg_get_viewdef(c.oid) AS viewdef, array_to_string(array_remove(array_remove(c.reloptions,'check_option=local'),'check_option=cascaded'), ', ') AS reloptions, CASE WHEN 'check_option=local' = ANY(c.reloptions) THEN 'LOCAL'::text WHEN 'check_option=cascaded' = ANY(c.reloptions) THEN 'CASCADED'::text ELSE NULL END AS checkoption, pg_get_userbyid(c.relowner) AS relowner FROM pg_class c INNER JOIN pg_namespace n ON (c.relnamespace = n.oid) WHERE relkind = 'v' AND nspname !~ '^pg_' AND nspname <> 'information_schema' %s%s AND NOT EXISTS(SELECT 1 FROM pg_depend d WHERE c.oid = d.objid AND d.deptype = 'e') ORDER BY nspname, relname", include_schema_str, exclude_schema_str);
 	}
-	else if (PQserverVersion(c) >= 90100)	/* extension support */
+	else if (getServerVersion(c) >= 90100)	/* extension support */
 	{
-		query = psprintf("SELECT c.oid, n.nspname, c.relname, pg_get_viewdef(c.oid) AS viewdef, array_to_string(c.reloptions, ', ') AS reloptions, CASE WHEN 'check_option=local' = ANY(c.reloptions) THEN 'LOCAL'::text WHEN 'check_option=cascaded' = ANY(c.reloptions) THEN 'CASCADED'::text ELSE NULL END AS checkoption, obj_description(c.oid, 'pg_class') AS description, pg_get_userbyid(c.relowner) AS relowner FROM pg_class c INNER JOIN pg_namespace n ON (c.relnamespace = n.oid) WHERE relkind = 'v' AND nspname !~ '^pg_' AND nspname <> 'information_schema' %s%s AND NOT EXISTS(SELECT 1 FROM pg_depend d WHERE c.oid = d.objid AND d.deptype = 'e') ORDER BY nspname, relname", include_schema_str, exclude_schema_str);
+		query = psprintf("SELECT c.oid, n.nspname, c.relname, pg_get_viewdef(c.oid) AS viewdef, array_to_string(c.reloptions, ', ') AS reloptions, CASE WHEN 'check_option=local' = ANY(c.reloptions) THEN 'LOCAL'::text WHEN 'check_option=cascaded' = ANY(c.reloptions) THEN 'CASCADED'::text ELSE NULL END AS checkoption, pg_get_userbyid(c.relowner) AS relowner FROM pg_class c INNER JOIN pg_namespace n ON (c.relnamespace = n.oid) WHERE relkind = 'v' AND nspname !~ '^pg_' AND nspname <> 'information_schema' %s%s AND NOT EXISTS(SELECT 1 FROM pg_depend d WHERE c.oid = d.objid AND d.deptype = 'e') ORDER BY nspname, relname", include_schema_str, exclude_schema_str);
 	}
 	else
 	{
-		query = psprintf("SELECT c.oid, n.nspname, c.relname, pg_get_viewdef(c.oid) AS viewdef, array_to_string(c.reloptions, ', ') AS reloptions, CASE WHEN 'check_option=local' = ANY(c.reloptions) THEN 'LOCAL'::text WHEN 'check_option=cascaded' = ANY(c.reloptions) THEN 'CASCADED'::text ELSE NULL END AS checkoption, obj_description(c.oid, 'pg_class') AS description, pg_get_userbyid(c.relowner) AS relowner FROM pg_class c INNER JOIN pg_namespace n ON (c.relnamespace = n.oid) WHERE relkind = 'v' AND nspname !~ '^pg_' AND nspname <> 'information_schema' %s%s ORDER BY nspname, relname", include_schema_str, exclude_schema_str);
+		query = psprintf("SELECT c.oid, n.nspname, c.relname, pg_get_viewdef(c.oid) AS viewdef, array_to_string(c.reloptions, ', ') AS reloptions, CASE WHEN 'check_option=local' = ANY(c.reloptions) THEN 'LOCAL'::text WHEN 'check_option=cascaded' = ANY(c.reloptions) THEN 'CASCADED'::text ELSE NULL END AS checkoption, pg_get_userbyid(c.relowner) AS relowner FROM pg_class c INNER JOIN pg_namespace n ON (c.relnamespace = n.oid) WHERE relkind = 'v' AND nspname !~ '^pg_' AND nspname <> 'information_schema' %s%s ORDER BY nspname, relname", include_schema_str, exclude_schema_str);
 	}
 
-	res = PQexec(c, query);
+	res = execQuery(c, query);
 
 	pfree(query);
 
@@ -69,7 +69,7 @@ getViews(PGconn *c, int *n)
 
 	*n = PQntuples(res);
 	if (*n > 0)
-		v = (PQLView *) malloc(*n * sizeof(PQLView));
+		v = (PQLView *) arenaAlloc(*n * sizeof(PQLView));
 	else
 		v = NULL;
 
@@ -77,43 +77,27 @@ getViews(PGconn *c, int *n)
 
 	for (i = 0; i < *n; i++)
 	{
-		char	*withoutescape;
-
 		v[i].obj.oid = strtoul(PQgetvalue(res, i, PQfnumber(res, "oid")), NULL, 10);
-		v[i].obj.schemaname = strdup(PQgetvalue(res, i, PQfnumber(res, "nspname")));
-		v[i].obj.objectname = strdup(PQgetvalue(res, i, PQfnumber(res, "relname")));
+		v[i].obj.schemaname = internName(PQgetvalue(res, i, PQfnumber(res, "nspname")));
+		v[i].obj.objectname = internName(PQgetvalue(res, i, PQfnumber(res, "relname")));
 		/* FIXME don't load it only iff view will be DROPped */
-		v[i].viewdef = strdup(PQgetvalue(res, i, PQfnumber(res, "viewdef")));
+		v[i].viewdef = arenaStrdup(PQgetvalue(res, i, PQfnumber(res, "viewdef")));
 		if (PQgetisnull(res, i, PQfnumber(res, "reloptions")))
 			v[i].reloptions = NULL;
 		else
-			v[i].reloptions = strdup(PQgetvalue(res, i, PQfnumber(res, "reloptions")));
+			v[i].reloptions = arenaStrdup(PQgetvalue(res, i, PQfnumber(res, "reloptions")));
 		if (PQgetisnull(res, i, PQfnumber(res, "checkoption")))
 			v[i].checkoption = NULL;
 		else
-			v[i].checkoption = strdup(PQgetvalue(res, i, PQfnumber(res, "checkoption")));
-		if (PQgetisnull(res, i, PQfnumber(res, "description")))
-			v[i].comment = NULL;
-		else
-		{
-			withoutescape = PQgetvalue(res, i, PQfnumber(res, "description"));
-			v[i].comment = PQescapeLiteral(c, withoutescape, strlen(withoutescape));
-			if (v[i].comment == NULL)
-			{
-				logError("escaping comment failed: %s", PQerrorMessage(c));
-				PQclear(res);
-				PQfinish(c);
-				/* XXX leak another connection? */
-				exit(EXIT_FAILURE);
-			}
-		}
+			v[i].checkoption = arenaStrdup(PQgetvalue(res, i, PQfnumber(res, "checkoption")));
+		v[i].comment = getComment(PGQ_CLASS_CLASS, v[i].obj.oid, 0);
 
-		v[i].owner = strdup(PQgetvalue(res, i, PQfnumber(res, "relowner")));
+		v[i].owner = internName(PQgetvalue(res, i, PQfnumber(res, "relowner")));
 
 		/*
 		 * Security labels are not assigned here (see getViewSecurityLabels),
 		 * but default values are essential to avoid having trouble in
-		 * freeViews.
+		 * the dump routines.
 		 */
 		v[i].nseclabels = 0;
 		v[i].seclabels = NULL;
@@ -127,119 +111,44 @@ getViews(PGconn *c, int *n)
 }
 
 void
-getViewSecurityLabels(PGconn *c, PQLView *v)
+getViewSecurityLabels(PGconn *c, PQLView *v, int n)
 {
-	char		*query;
-	PGresult	*res;
 	int			i;
 
-	if (PQserverVersion(c) < 90100)
-	{
-		logWarning("ignoring security labels because server does not support it");
+	if (n == 0)
 		return;
-	}
-
-	query = psprintf("SELECT provider, label FROM pg_seclabel s INNER JOIN pg_class c ON (s.classoid = c.oid) WHERE c.relname = 'pg_class' AND s.objoid = %u ORDER BY provider", v->obj.oid);
 
-	res = PQexec(c, query);
-
-	pfree(query);
-
-	if (PQresultStatus(res) != PGRES_TUPLES_OK)
+	if (getServerVersion(c) < 90100)
 	{
-		logError("query failed: %s", PQresultErrorMessage(res));
-		PQclear(res);
-		PQfinish(c);
-		/* XXX leak another connection? */
-		exit(EXIT_FAILURE);
-	}
-
-	v->nseclabels = PQntuples(res);
-	if (v->nseclabels > 0)
-		v->seclabels = (PQLSecLabel *) malloc(v->nseclabels * sizeof(PQLSecLabel));
-	else
-		v->seclabels = NULL;
-
-	logDebug("number of security labels in view \"%s\".\"%s\": %d",
-			 v->obj.schemaname, v->obj.objectname, v->nseclabels);
-
-	for (i = 0; i < v->nseclabels; i++)
-	{
-		char	*withoutescape;
-
-		v->seclabels[i].provider = strdup(PQgetvalue(res, i, PQfnumber(res,
-										  "provider")));
-		withoutescape = PQgetvalue(res, i, PQfnumber(res, "label"));
-		v->seclabels[i].label = PQescapeLiteral(c, withoutescape,
-												strlen(withoutescape));
-		if (v->seclabels[i].label == NULL)
-		{
-			logError("escaping comment failed: %s", PQerrorMessage(c));
-			PQclear(res);
-			PQfinish(c);
-			/* XXX leak another connection? */
-			exit(EXIT_FAILURE);
-		}
+		logWarning("ignoring security labels because server does not support it");
+		return;
 	}
 
-	PQclear(res);
-}
-
-void
-freeViews(PQLView *v, int n)
-{
-	if (n > 0)
+	for (i = 0; i < n; i++)
 	{
-		int	i;
-
-		for (i = 0; i < n; i++)
-		{
-			int	j;
-
-			free(v[i].obj.schemaname);
-			free(v[i].obj.objectname);
-			free(v[i].viewdef);
-			if (v[i].reloptions)
-				free(v[i].reloptions);
-			if (v[i].checkoption)
-				free(v[i].checkoption);
-			if (v[i].comment)
-				PQfreemem(v[i].comment);
-			free(v[i].owner);
-
-			/* security labels */
-			for (j = 0; j < v[i].nseclabels; j++)
-			{
-				free(v[i].seclabels[j].provider);
-				PQfreemem(v[i].seclabels[j].label);
-			}
+		v[i].nseclabels = getObjectSecurityLabels(c, PGQ_CLASS_CLASS,
+							  v[i].obj.oid, 0, &v[i].seclabels);
 
-			if (v[i].seclabels)
-				free(v[i].seclabels);
-		}
-
-		free(v);
+		logDebug("number of security labels in view \"%s\".\"%s\": %d",
+				 v[i].obj.schemaname, v[i].obj.objectname, v[i].nseclabels);
 	}
 }
 
 void
 dumpDropView(FILE *output, PQLView *v)
 {
-	char	*schema = formatObjectIdentifier(v->obj.schemaname);
-	char	*viewname = formatObjectIdentifier(v->obj.objectname);
+	char	*schema = quotedName(v->obj.schemaname);
+	char	*viewname = quotedName(v->obj.objectname);
 
 	fprintf(output, "\n\n");
 	fprintf(output, "DROP VIEW %s.%s;", schema, viewname);
-
-	free(schema);
-	free(viewname);
 }
 
 void
 dumpCreateView(FILE *output, PQLView *v)
 {
-	char	*schema = formatObjectIdentifier(v->obj.schemaname);
-	char	*viewname = formatObjectIdentifier(v->obj.objectname);
+	char	*schema = quotedName(v->obj.schemaname);
+	char	*viewname = quotedName(v->obj.objectname);
 
 	fprintf(output, "\n\n");
 	fprintf(output, "CREATE VIEW %s.%s", schema, viewname);
@@ -259,7 +168,9 @@ dumpCreateView(FILE *output, PQLView *v)
 	if (options.comment && v->comment != NULL)
 	{
 		fprintf(output, "\n\n");
-		fprintf(output, "COMMENT ON VIEW %s.%s IS %s;", schema, viewname, v->comment);
+		fprintf(output, "COMMENT ON VIEW %s.%s IS ", schema, viewname);
+		printComment(output, v->comment);
+		fprintf(output, ";");
 	}
 
 	/* security labels */
@@ -281,25 +192,21 @@ dumpCreateView(FILE *output, PQLView *v)
 	/* owner */
 	if (options.owner)
 	{
-		char	*owner = formatObjectIdentifier(v->owner);
+		char	*owner = quotedName(v->owner);
 
 		fprintf(output, "\n\n");
 		fprintf(output, "ALTER VIEW %s.%s OWNER TO %s;", schema, viewname, owner);
-
-		free(owner);
 	}
 
-	free(schema);
-	free(viewname);
 }
 
 void
 dumpAlterView(FILE *output, PQLView *a, PQLView *b)
 {
-	char	*schema1 = formatObjectIdentifier(a->obj.schemaname);
-	char	*viewname1 = formatObjectIdentifier(a->obj.objectname);
-	char	*schema2 = formatObjectIdentifier(b->obj.schemaname);
-	char	*viewname2 = formatObjectIdentifier(b->obj.objectname);
+	char	*schema1 = quotedName(a->obj.schemaname);
+	char	*viewname1 = quotedName(a->obj.objectname);
+	char	*schema2 = quotedName(b->obj.schemaname);
+	char	*viewname2 = quotedName(b->obj.objectname);
 
 	/* check option */
 	if (a->checkoption == NULL && b->checkoption != NULL)
@@ -330,7 +237,7 @@ dumpAlterView(FILE *output, PQLView *a, PQLView *b)
 	}
 	else if (a->reloptions != NULL && b->reloptions == NULL)
 	{
-		stringList	*rlist;
+		PQLOptionSet	*rlist;
 
 		rlist = setOperationOptions(a->reloptions, b->reloptions, PGQ_SETDIFFERENCE,
 									false, true);
@@ -343,13 +250,13 @@ dumpAlterView(FILE *output, PQLView *a, PQLView *b)
 			fprintf(output, "ALTER VIEW %s.%s RESET (%s);", schema2, viewname2, resetlist);
 
 			free(resetlist);
-			freeStringList(rlist);
+			freeOptionSet(rlist);
 		}
 	}
 	else if (a->reloptions != NULL && b->reloptions != NULL &&
 			 strcmp(a->reloptions, b->reloptions) != 0)
 	{
-		stringList	*rlist, *ilist, *slist;
+		PQLOptionSet	*rlist, *ilist, *slist;
 
 		rlist = setOperationOptions(a->reloptions, b->reloptions, PGQ_SETDIFFERENCE,
 									false, true);
@@ -362,7 +269,7 @@ dumpAlterView(FILE *output, PQLView *a, PQLView *b)
 			fprintf(output, "ALTER VIEW %s.%s RESET (%s);", schema2, viewname2, resetlist);
 
 			free(resetlist);
-			freeStringList(rlist);
+			freeOptionSet(rlist);
 		}
 
 		/*
@@ -380,7 +287,7 @@ dumpAlterView(FILE *output, PQLView *a, PQLView *b)
 			fprintf(output, "ALTER VIEW %s.%s SET (%s);", schema2, viewname2, setlist);
 
 			free(setlist);
-			freeStringList(ilist);
+			freeOptionSet(ilist);
 		}
 
 		/*
@@ -397,7 +304,7 @@ dumpAlterView(FILE *output, PQLView *a, PQLView *b)
 			fprintf(output, "ALTER VIEW %s.%s SET (%s);", schema2, viewname2, setlist);
 
 			free(setlist);
-			freeStringList(slist);
+			freeOptionSet(slist);
 		}
 	}
 
@@ -409,8 +316,9 @@ dumpAlterView(FILE *output, PQLView *a, PQLView *b)
 				 strcmp(a->comment, b->comment) != 0))
 		{
 			fprintf(output, "\n\n");
-			fprintf(output, "COMMENT ON VIEW %s.%s IS %s;", schema2, viewname2,
-					b->comment);
+			fprintf(output, "COMMENT ON VIEW %s.%s IS ", schema2, viewname2);
+			printComment(output, b->comment);
+			fprintf(output, ";");
 		}
 		else if (a->comment != NULL && b->comment == NULL)
 		{
@@ -517,17 +425,10 @@ dumpAlterView(FILE *output, PQLView *a, PQLView *b)
 	{
 		if (strcmp(a->owner, b->owner) != 0)
 		{
-			char	*owner = formatObjectIdentifier(b->owner);
+			char	*owner = quotedName(b->owner);
 
 			fprintf(output, "\n\n");
 			fprintf(output, "ALTER VIEW %s.%s OWNER TO %s;", schema2, viewname2, owner);
-
-			free(owner);
 		}
 	}
-
-	free(schema1);
-	free(viewname1);
-	free(schema2);
-	free(viewname2);
 }
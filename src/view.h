@@ -9,7 +9,9 @@
 #ifndef VIEW_H
 #define VIEW_H
 
+#include "comment.h"
 #include "common.h"
+#include "seclabel.h"
 
 typedef struct PQLView
 {
@@ -28,12 +30,11 @@ typedef struct PQLView
 } PQLView;
 
 PQLView *getViews(PGconn *c, int *n);
-void getViewSecurityLabels(PGconn *c, PQLView *v);
+void getViewSecurityLabels(PGconn *c, PQLView *v, int n);
 
 void dumpDropView(FILE *output, PQLView *v);
 void dumpCreateView(FILE *output, PQLView *v);
 void dumpAlterView(FILE *output, PQLView *a, PQLView *b);
 
-void freeViews(PQLView *v, int n);
 
 #endif	/* VIEW_H */
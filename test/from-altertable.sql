@@ -0,0 +1,23 @@
+--
+-- ALTER TABLE subcommands of one table are merged into one statement
+--
+CREATE TABLE same_alter_table_1 (
+	a integer not null,
+	b varchar(20),
+	c text,
+	d integer,
+	PRIMARY KEY(a)
+);
+
+CREATE TABLE same_alter_table_2 (
+	a integer not null,
+	b integer,
+	PRIMARY KEY(a)
+);
+
+CREATE TABLE same_alter_table_3 (
+	a integer not null,
+	b text not null,
+	c date DEFAULT '2020-01-01',
+	PRIMARY KEY(a)
+);
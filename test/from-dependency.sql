@@ -0,0 +1,5 @@
+--
+-- objects that depend on each other (see dependency-order)
+--
+CREATE TABLE from_dependency_1 (a integer PRIMARY KEY, b integer);
+CREATE VIEW from_dependency_view_1 AS SELECT a, b FROM from_dependency_1;
@@ -0,0 +1,24 @@
+--
+-- grant options and privileges granted by more than one role
+--
+CREATE TABLE same_privileges_1 (a integer, b text);
+CREATE TABLE same_privileges_2 (a integer, b text);
+CREATE TABLE same_privileges_3 (a integer, b text);
+CREATE SEQUENCE same_privileges_seq_1;
+CREATE FUNCTION same_privileges_function_1(integer) RETURNS integer AS $$ SELECT $1 $$ LANGUAGE sql;
+
+GRANT SELECT, INSERT ON TABLE same_privileges_1 TO same_role_1;
+GRANT SELECT, INSERT ON TABLE same_privileges_2 TO same_role_1 WITH GRANT OPTION;
+GRANT UPDATE (b) ON TABLE same_privileges_2 TO same_role_2 WITH GRANT OPTION;
+GRANT USAGE ON SEQUENCE same_privileges_seq_1 TO same_role_2 WITH GRANT OPTION;
+GRANT EXECUTE ON FUNCTION same_privileges_function_1(integer) TO same_role_2;
+
+-- same_role_3 is granted by same_role_1 and same_role_2; no change is expected
+GRANT SELECT, UPDATE ON TABLE same_privileges_3 TO same_role_1 WITH GRANT OPTION;
+GRANT SELECT ON TABLE same_privileges_3 TO same_role_2 WITH GRANT OPTION;
+SET ROLE same_role_1;
+GRANT SELECT, UPDATE ON TABLE same_privileges_3 TO same_role_3;
+RESET ROLE;
+SET ROLE same_role_2;
+GRANT SELECT ON TABLE same_privileges_3 TO same_role_3;
+RESET ROLE;
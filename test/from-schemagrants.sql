@@ -0,0 +1,22 @@
+--
+-- schema-grants: a privilege that changes in every object of a schema is
+-- changed by a single GRANT / REVOKE ... ON ALL ... IN SCHEMA
+--
+CREATE SCHEMA same_schemagrants_1;
+CREATE TABLE same_schemagrants_1.same_table_1 (a integer, b text);
+CREATE TABLE same_schemagrants_1.same_table_2 (a integer, b text);
+CREATE TABLE same_schemagrants_1.same_table_3 (a integer);
+CREATE SEQUENCE same_schemagrants_1.same_sequence_1;
+CREATE SEQUENCE same_schemagrants_1.same_sequence_2;
+CREATE FUNCTION same_schemagrants_1.same_function_1(integer) RETURNS integer AS $$ SELECT $1 $$ LANGUAGE sql;
+CREATE FUNCTION same_schemagrants_1.same_function_2(integer) RETURNS integer AS $$ SELECT $1 + 1 $$ LANGUAGE sql;
+
+GRANT SELECT ON ALL TABLES IN SCHEMA same_schemagrants_1 TO same_role_2;
+
+-- a view is not compared with tables; each table is changed
+CREATE SCHEMA same_schemagrants_2;
+CREATE TABLE same_schemagrants_2.same_table_1 (a integer, b text);
+CREATE TABLE same_schemagrants_2.same_table_2 (a integer, b text);
+CREATE VIEW same_schemagrants_2.same_view_1 AS SELECT a, b FROM same_schemagrants_2.same_table_1;
+
+GRANT SELECT ON ALL TABLES IN SCHEMA same_schemagrants_2 TO same_role_2;
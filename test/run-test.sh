@@ -158,6 +158,53 @@ fi
 
 sleep 2
 
+FAILED=0
+
+# reload quarrel1 so each run starts from the same target
+reset_target() {
+	$PGPATH1/psql -U $PGUSER1 -p $PGPORT1 -X -q -f test-server1.sql postgres > /dev/null 2>&1
+}
+
+apply_target() {
+	$PGPATH1/psql -U $PGUSER1 -p $PGPORT1 -X -f $1 quarrel1 > /dev/null
+}
+
+# evaluate the expression (second argument) and count it if it fails
+check() {
+	if eval "$2"; then
+		echo "ok: $1"
+	else
+		echo "FAILED: $1"
+		FAILED=$((FAILED + 1))
+	fi
+}
+
+# line number of the first line of the file (second argument) that contains
+# the text (first argument)
+line_of() {
+	grep -n -m 1 -F "$1" $2 | cut -d: -f1
+}
+
+# wave of the first file of the parallel directory (second argument) that
+# contains the text (first argument)
+wave_of() {
+	local f=$(grep -l -F "$1" $2/*.sql | head -1)
+	awk -F'\t' -v f=$(basename $f) '$2 == f { print $1 }' $2/manifest
+}
+
+compare_dumps() {
+	echo "comparing dumps..."
+	if [ $PGV1 -ge $PGV2 ]; then
+		$PGPATH1/pg_dump -s -U $PGUSER1 -p $PGPORT1 -f /tmp/q1.sql quarrel1 2> /dev/null
+		$PGPATH1/pg_dump -s -U $PGUSER2 -p $PGPORT2 -f /tmp/q2.sql quarrel2 2> /dev/null
+	else
+		$PGPATH2/pg_dump -s -U $PGUSER1 -p $PGPORT1 -f /tmp/q1.sql quarrel1 2> /dev/null
+		$PGPATH2/pg_dump -s -U $PGUSER2 -p $PGPORT2 -f /tmp/q2.sql quarrel2 2> /dev/null
+	fi
+	#diff -u /tmp/q1.sql /tmp/q2.sql
+	check "$1: dumps are equal" 'diff -u <(sort /tmp/q1.sql) <(sort /tmp/q2.sql)'
+}
+
 echo "loading quarrel1..."
 $PGPATH1/psql -U $PGUSER1 -p $PGPORT1 -X -f test-server1.sql postgres > /dev/null
 echo "loading quarrel2..."
@@ -182,20 +229,125 @@ $PGPATH1/psql -U $PGUSER1 -p $PGPORT1 -X -f /tmp/test.sql quarrel1 > /dev/null
 echo "test again..."
 $PGQUARREL -c test2.ini
 
-echo "comparing dumps..."
-if [ $PGV1 -ge $PGV2 ]; then
-	$PGPATH1/pg_dump -s -U $PGUSER1 -p $PGPORT1 -f /tmp/q1.sql quarrel1 2> /dev/null
-	$PGPATH1/pg_dump -s -U $PGUSER2 -p $PGPORT2 -f /tmp/q2.sql quarrel2 2> /dev/null
+compare_dumps "default"
+
+# schema-grants is off by default
+check "default: privileges are changed per object" '! grep -q "IN SCHEMA same_schemagrants_" /tmp/test.sql'
+
+echo "quarrel (schema-grants)..."
+reset_target
+$PGQUARREL -c test.ini --schema-grants=true -f /tmp/test-schemagrants.sql 2> /dev/null
+check "schema-grants: grant" 'grep -q "ON ALL TABLES IN SCHEMA same_schemagrants_1 TO same_role_1;" /tmp/test-schemagrants.sql'
+check "schema-grants: grant option" 'grep -q "GRANT USAGE ON ALL SEQUENCES IN SCHEMA same_schemagrants_1 TO same_role_1 WITH GRANT OPTION;" /tmp/test-schemagrants.sql'
+check "schema-grants: revoke" 'grep -q "REVOKE SELECT ON ALL TABLES IN SCHEMA same_schemagrants_1 FROM same_role_2;" /tmp/test-schemagrants.sql'
+check "schema-grants: schema with a view" '! grep -q "IN SCHEMA same_schemagrants_2" /tmp/test-schemagrants.sql'
+apply_target /tmp/test-schemagrants.sql
+compare_dumps "schema-grants"
+
+# changes of a live run are the reference for the following runs
+reset_target
+$PGQUARREL -c test.ini -f /tmp/test-live.sql 2> /dev/null
+
+echo "quarrel (catalog files)..."
+$PGQUARREL -c test.ini --dump-catalog=/tmp/quarrel2.catalog 2> /dev/null
+$PGQUARREL -c test.ini --source-port=$PGPORT1 --source-dbname=quarrel1 --dump-catalog=/tmp/quarrel1.catalog 2> /dev/null
+$PGQUARREL -c test.ini --source-catalog=/tmp/quarrel2.catalog -f /tmp/test-catalog.sql 2> /dev/null
+check "source-catalog: same changes" 'diff -u /tmp/test-live.sql /tmp/test-catalog.sql'
+$PGQUARREL -c test.ini --source-catalog=/tmp/quarrel2.catalog --target-catalog=/tmp/quarrel1.catalog -f /tmp/test-catalog.sql 2> /dev/null
+check "source-catalog and target-catalog: same changes" 'diff -u /tmp/test-live.sql /tmp/test-catalog.sql'
+
+echo "quarrel (fan-out)..."
+$PGQUARREL -c test-fanout.ini 2> /dev/null
+check "fan-out: first target" 'diff -u /tmp/test-live.sql /tmp/test-fanout-first.sql'
+check "fan-out: second target" 'diff -u /tmp/test-live.sql /tmp/test-fanout-second.sql'
+check "fan-out: catalog target" 'diff -u /tmp/test-live.sql /tmp/test-fanout-catalog.sql'
+
+echo "quarrel (catalog cache)..."
+rm -rf /tmp/quarrel-cache
+mkdir -p /tmp/quarrel-cache
+$PGQUARREL -c test.ini --cache-directory=/tmp/quarrel-cache -f /tmp/test-cache.sql 2> /dev/null
+check "cache: first run" 'diff -u /tmp/test-live.sql /tmp/test-cache.sql'
+check "cache: caches are written" '[ $(ls /tmp/quarrel-cache | wc -l) -eq 2 ]'
+$PGQUARREL -c test.ini --cache-directory=/tmp/quarrel-cache -f /tmp/test-cache.sql 2> /dev/null
+check "cache: cached run" 'diff -u /tmp/test-live.sql /tmp/test-cache.sql'
+# the target changes after the cache was written
+$PGPATH1/psql -U $PGUSER1 -p $PGPORT1 -X -q -c "ALTER SEQUENCE same_sequence_1 INCREMENT BY 7" -c "ALTER TABLE same_alter_table_3 ADD COLUMN cache_column integer" quarrel1
+$PGQUARREL -c test.ini --cache-directory=/tmp/quarrel-cache -f /tmp/test-cache.sql 2> /dev/null
+check "cache: changed sequence" 'grep -q "same_sequence_1 INCREMENT BY 1" /tmp/test-cache.sql'
+check "cache: changed table" 'grep -q "DROP COLUMN cache_column" /tmp/test-cache.sql'
+
+echo "quarrel (dependency-order)..."
+reset_target
+$PGQUARREL -c test.ini --dependency-order=true -f /tmp/test-depend.sql 2> /dev/null
+check "dependency-order: view is dropped before its table" '[ "$(line_of "DROP VIEW public.from_dependency_view_1" /tmp/test-depend.sql)" -lt "$(line_of "DROP TABLE public.from_dependency_1" /tmp/test-depend.sql)" ]'
+check "dependency-order: view is created after its tables" '[ "$(line_of "CREATE TABLE public.to_dependency_2" /tmp/test-depend.sql)" -lt "$(line_of "CREATE VIEW public.to_dependency_view_1" /tmp/test-depend.sql)" ]'
+apply_target /tmp/test-depend.sql
+compare_dumps "dependency-order"
+
+echo "quarrel (parallel-directory)..."
+reset_target
+rm -rf /tmp/quarrel-waves
+$PGQUARREL -c test.ini --dependency-order=true --parallel-directory=/tmp/quarrel-waves -f /tmp/test-waves.sql 2> /dev/null
+check "parallel-directory: manifest lists every file" '[ $(ls /tmp/quarrel-waves/*.sql | wc -l) -eq $(wc -l < /tmp/quarrel-waves/manifest) ]'
+check "parallel-directory: more than one wave" '[ $(cut -f1 /tmp/quarrel-waves/manifest | uniq | wc -l) -gt 1 ]'
+check "parallel-directory: circular foreign key 1" '[ "$(wave_of "CREATE TABLE public.to_dependency_2" /tmp/quarrel-waves)" -lt "$(wave_of "to_dependency_1_b_fkey" /tmp/quarrel-waves)" ]'
+check "parallel-directory: circular foreign key 2" '[ "$(wave_of "CREATE TABLE public.to_dependency_1" /tmp/quarrel-waves)" -lt "$(wave_of "to_dependency_2_b_fkey" /tmp/quarrel-waves)" ]'
+check "parallel-directory: view after its tables" '[ "$(wave_of "CREATE TABLE public.to_dependency_1" /tmp/quarrel-waves)" -lt "$(wave_of "CREATE VIEW public.to_dependency_view_1" /tmp/quarrel-waves)" ]'
+# files of the same wave are applied at the same time
+for w in $(cut -f1 /tmp/quarrel-waves/manifest | uniq); do
+	for f in $(awk -F'\t' -v w=$w '$1 == w { print $2 }' /tmp/quarrel-waves/manifest); do
+		$PGPATH1/psql -U $PGUSER1 -p $PGPORT1 -X -q -1 -f /tmp/quarrel-waves/$f quarrel1 > /dev/null &
+	done
+	wait
+done
+compare_dumps "parallel-directory"
+
+# SET NOT NULL uses a validated CHECK constraint since 12
+if [ $PGV1 -ge 12 ]; then
+	echo "quarrel (online)..."
+	reset_target
+	$PGQUARREL -c test.ini --online -f /tmp/test-online.sql 2> /dev/null
+	check "online: create index" 'grep -q "CREATE INDEX CONCURRENTLY to_index_2" /tmp/test-online.sql'
+	check "online: drop index" 'grep -q "DROP INDEX CONCURRENTLY public.from_index_1;" /tmp/test-online.sql'
+	check "online: foreign key is not valid" 'grep -q "ADD CONSTRAINT same_alter_table_2_c_fkey FOREIGN KEY .* NOT VALID;" /tmp/test-online.sql'
+	check "online: foreign key is validated" '[ "$(line_of "ADD CONSTRAINT same_alter_table_2_c_fkey" /tmp/test-online.sql)" -lt "$(line_of "VALIDATE CONSTRAINT same_alter_table_2_c_fkey;" /tmp/test-online.sql)" ]'
+	check "online: set not null" '[ "$(line_of "CHECK (b IS NOT NULL) NOT VALID;" /tmp/test-online.sql)" -lt "$(line_of "VALIDATE CONSTRAINT pgquarrel_not_null_" /tmp/test-online.sql)" ] && [ "$(line_of "VALIDATE CONSTRAINT pgquarrel_not_null_" /tmp/test-online.sql)" -lt "$(line_of "public.same_alter_table_1 ALTER COLUMN b SET NOT NULL;" /tmp/test-online.sql)" ] && [ "$(line_of "public.same_alter_table_1 ALTER COLUMN b SET NOT NULL;" /tmp/test-online.sql)" -lt "$(line_of "DROP CONSTRAINT pgquarrel_not_null_" /tmp/test-online.sql)" ]'
+	apply_target /tmp/test-online.sql
+	compare_dumps "online"
 else
-	$PGPATH2/pg_dump -s -U $PGUSER1 -p $PGPORT1 -f /tmp/q1.sql quarrel1 2> /dev/null
-	$PGPATH2/pg_dump -s -U $PGUSER2 -p $PGPORT2 -f /tmp/q2.sql quarrel2 2> /dev/null
+	echo "skipping online run (requires server 12 or later)"
 fi
-#diff -u /tmp/q1.sql /tmp/q2.sql
-diff -u <(sort /tmp/q1.sql) <(sort /tmp/q2.sql)
+
+echo "quarrel (annotate-cost and cost-threshold)..."
+reset_target
+# sizes are estimated from relpages
+$PGPATH1/psql -U $PGUSER1 -p $PGPORT1 -X -q -c "INSERT INTO same_alter_table_1 (a, b, c, d) SELECT i, 'b', repeat('c', 100), i FROM generate_series(1, 50000) i" -c "VACUUM ANALYZE same_alter_table_1" quarrel1
+$PGQUARREL -c test.ini --annotate-cost=true -f /tmp/test-cost.sql 2> /dev/null
+check "annotate-cost: rewrite" 'grep -q "^-- cost: rewrite, about [0-9]* bytes" /tmp/test-cost.sql'
+check "annotate-cost: scan" 'grep -q "^-- cost: scan" /tmp/test-cost.sql'
+$PGQUARREL -c test.ini --cost-threshold=1 -f /tmp/test-cost.sql 2> /tmp/test-cost.log
+status=$?
+check "cost-threshold: fails" '[ $status -ne 0 ]'
+check "cost-threshold: table is reported" 'grep -q "of table \"public\".\"same_alter_table_1\" touches about" /tmp/test-cost.log'
+check "cost-threshold: changes are written" 'grep -q "ALTER TABLE" /tmp/test-cost.sql'
 
 if [ $CLEANUP -eq 1 ]; then
 	rm -f /tmp/test.sql
 	rm -f /tmp/test2.sql
+	rm -f /tmp/test-schemagrants.sql
+	rm -f /tmp/test-live.sql
+	rm -f /tmp/test-catalog.sql
+	rm -f /tmp/test-fanout-*.sql
+	rm -f /tmp/test-cache.sql
+	rm -rf /tmp/quarrel-cache
+	rm -f /tmp/test-depend.sql
+	rm -f /tmp/test-waves.sql
+	rm -rf /tmp/quarrel-waves
+	rm -f /tmp/test-online.sql
+	rm -f /tmp/test-cost.sql
+	rm -f /tmp/test-cost.log
+	rm -f /tmp/quarrel1.catalog
+	rm -f /tmp/quarrel2.catalog
 	rm -f /tmp/q1.sql
 	rm -f /tmp/q2.sql
 fi
@@ -227,4 +379,9 @@ fi
 
 echo "E N D"
 
+if [ $FAILED -gt 0 ]; then
+	echo "$FAILED check(s) failed"
+	exit 1
+fi
+
 exit 0
@@ -26,6 +26,8 @@ CREATE EXTENSION file_fdw;
 
 \i from-table.sql
 
+\i from-altertable.sql
+
 \i from-index.sql
 
 \i from-sequence.sql
@@ -57,3 +59,9 @@ CREATE EXTENSION file_fdw;
 --\i from-user-mapping.sql
 
 \i from-publication.sql
+
+\i from-privileges.sql
+
+\i from-schemagrants.sql
+
+\i from-dependency.sql
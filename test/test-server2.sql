@@ -26,6 +26,8 @@ CREATE EXTENSION file_fdw;
 
 \i to-table.sql
 
+\i to-altertable.sql
+
 \i to-index.sql
 
 \i to-sequence.sql
@@ -57,3 +59,9 @@ CREATE EXTENSION file_fdw;
 --\i to-user-mapping.sql
 
 \i to-publication.sql
+
+\i to-privileges.sql
+
+\i to-schemagrants.sql
+
+\i to-dependency.sql
@@ -0,0 +1,32 @@
+--
+-- ALTER TABLE subcommands of one table are merged into one statement
+--
+CREATE TABLE same_alter_table_1 (
+	a integer not null,
+	b varchar(40) not null,
+	c text DEFAULT 'foo',
+	e integer DEFAULT 0,
+	f timestamp DEFAULT now(),
+	g double precision DEFAULT random(),
+	PRIMARY KEY(a)
+);
+COMMENT ON COLUMN same_alter_table_1.e IS 'this is comment for column same_alter_table_1.e';
+
+CREATE TABLE same_alter_table_2 (
+	a integer not null,
+	b bigint,
+	c integer,
+	PRIMARY KEY(a),
+	FOREIGN KEY(c) REFERENCES same_alter_table_1(a)
+);
+ALTER TABLE same_alter_table_2 ALTER COLUMN b SET STATISTICS 50;
+
+CREATE TABLE same_alter_table_3 (
+	a integer not null,
+	b text,
+	c date,
+	d text COLLATE "C",
+	PRIMARY KEY(a),
+	CHECK(c > '2010-01-01')
+);
+ALTER TABLE same_alter_table_3 ALTER COLUMN b SET STORAGE EXTERNAL;
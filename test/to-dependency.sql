@@ -0,0 +1,9 @@
+--
+-- objects that depend on each other (see dependency-order)
+--
+CREATE TABLE to_dependency_1 (a integer PRIMARY KEY, b integer);
+CREATE TABLE to_dependency_2 (a integer PRIMARY KEY, b integer REFERENCES to_dependency_1 (a));
+-- circular foreign keys
+ALTER TABLE to_dependency_1 ADD FOREIGN KEY (b) REFERENCES to_dependency_2 (a);
+CREATE VIEW to_dependency_view_1 AS SELECT x.a, y.b FROM to_dependency_1 x INNER JOIN to_dependency_2 y ON (x.a = y.b);
+GRANT SELECT ON to_dependency_view_1 TO same_role_1;
@@ -0,0 +1,29 @@
+--
+-- grant options and privileges granted by more than one role
+--
+CREATE TABLE same_privileges_1 (a integer, b text);
+CREATE TABLE same_privileges_2 (a integer, b text);
+CREATE TABLE same_privileges_3 (a integer, b text);
+CREATE SEQUENCE same_privileges_seq_1;
+CREATE FUNCTION same_privileges_function_1(integer) RETURNS integer AS $$ SELECT $1 $$ LANGUAGE sql;
+
+-- grant option is added
+GRANT SELECT, INSERT ON TABLE same_privileges_1 TO same_role_1 WITH GRANT OPTION;
+GRANT EXECUTE ON FUNCTION same_privileges_function_1(integer) TO same_role_2 WITH GRANT OPTION;
+-- grant option is revoked but privilege is kept
+GRANT SELECT ON TABLE same_privileges_2 TO same_role_1 WITH GRANT OPTION;
+GRANT INSERT ON TABLE same_privileges_2 TO same_role_1;
+GRANT UPDATE (b) ON TABLE same_privileges_2 TO same_role_2;
+GRANT USAGE ON SEQUENCE same_privileges_seq_1 TO same_role_2;
+
+-- same_role_3 is granted by same_role_1 and same_role_2; no change is expected
+GRANT SELECT, UPDATE ON TABLE same_privileges_3 TO same_role_1 WITH GRANT OPTION;
+GRANT SELECT ON TABLE same_privileges_3 TO same_role_2 WITH GRANT OPTION;
+SET ROLE same_role_1;
+GRANT SELECT, UPDATE ON TABLE same_privileges_3 TO same_role_3;
+RESET ROLE;
+SET ROLE same_role_2;
+GRANT SELECT ON TABLE same_privileges_3 TO same_role_3;
+RESET ROLE;
+-- privileges of another grantee change
+GRANT INSERT ON TABLE same_privileges_3 TO "PGQ_same_role_4";